@@ -2,6 +2,8 @@
 #define AUTOMATIC_MODE_H
 
 #include "esp_err.h"
+#include "coast_model.h"
+#include "status_text.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -11,8 +13,10 @@
 // 
 // SINGLE RESPONSIBILITY: Autonomous cycling mode implementation
 // - automatic_mode_start() / automatic_mode_stop() / automatic_mode_interrupt()
-// - 5 m/s acceleration profiles
-// - Coasting distance calculation and implementation
+// - Jerk-limited run profiles up to 5 m/s (motion_planner.h), replanned
+//   online from the state estimate
+// - Coasting distance calculation and implementation; the per-direction
+//   coast model is refit from the speed trace of every coasting phase
 // - Cycle management and counting
 // - Auto-arm/disarm ESC
 // 
@@ -30,6 +34,21 @@
 #define AUTO_MODE_ACCEL_RATE_MS2        0.5f      // Acceleration rate (m/s²)
 #define AUTO_MODE_DECEL_RATE_MS2        0.3f      // Deceleration rate (m/s²)
 #define AUTO_MODE_SPEED_INCREMENT       0.1f      // Speed increment steps
+#define AUTO_MODE_JERK_LIMIT_MS3        1.0f      // Jerk limit of planned speed changes (m/s³)
+#define AUTO_MODE_DECEL_STEP_MS         100       // Safety check interval during ramps and runs
+
+// Motion planning (planned runs between wire ends)
+#define AUTO_PLANNER_END_MARGIN_M       0.5f      // Planned roll-out point short of the wire end
+#define AUTO_PLANNER_REPLAN_POSITION_M  0.25f     // Position drift from the plan that triggers a replan
+#define AUTO_PLANNER_REPLAN_SPEED_MS    0.3f      // Speed drift from the plan that triggers a replan
+#define AUTO_PLANNER_REPLAN_INTERVAL_MS 250       // Minimum time between replans
+#define AUTO_PLANNER_MIN_COAST_DECEL_MS2 0.05f    // Measured coast deceleration below this is not trusted
+#define AUTO_PLANNER_ARRIVAL_SPEED_MS   0.7f      // Planned speed at the wire end once the direction is fit
+
+// Wire map (per-position slow zones and feed-forward, see wire_map.h)
+#define AUTO_MAP_LOOKAHEAD_MARGIN_M     2.0f      // Slow-zone preview beyond the braking distance
+#define AUTO_MAP_MAX_PENDING_ZONES      4         // Slow zones ahead tracked at once
+#define AUTO_MAP_BIAS_STEP_DUTY         1.0f      // Feed-forward bias change worth re-sending
 
 // Coasting parameters
 #define AUTO_COASTING_CALIBRATION_SPEED 5.0f      // Speed for coasting calibration
@@ -45,8 +64,12 @@
 
 // Safety parameters
 #define AUTO_MODE_WIRE_END_APPROACH_MS  1.0f      // Speed when approaching wire end
+#define AUTO_MODE_APPROACH_TIME_MS      500       // Final approach time before stopping
+#define AUTO_MODE_SEEK_MARGIN_S         5.0f      // Seek time beyond the wire length at approach speed
+#define AUTO_MODE_SEEK_STALL_MS         1500      // No Hall edge this long while seeking: at the end
 #define AUTO_MODE_EMERGENCY_DECEL_MS2   2.0f      // Emergency deceleration rate
-#define AUTO_MODE_MAX_IMPACT_G          0.5f      // Maximum allowed impact
+#define AUTO_MODE_IMPACT_SPEED_MS       1.25f     // Wire end arrival faster than this is an incident
+#define AUTO_MODE_ARRIVAL_HOLD_MS       200       // Speed peak held for the arrival (the impact tick reads slower)
 
 // ═══════════════════════════════════════════════════════════════════════════════
 // AUTOMATIC MODE STATE AND DATA STRUCTURES
@@ -84,6 +107,8 @@ typedef struct {
     float coast_start_distance_m;       // Distance from wire end to start coasting
     uint32_t calibration_rotations;     // Rotations during coasting
     bool calibration_successful;        // Calibration completed successfully
+    coast_model_t model_forward;        // Learned a + b·v² model, forward coasts
+    coast_model_t model_reverse;        // Learned a + b·v² model, reverse coasts
 } coasting_calibration_t;
 
 /**
@@ -131,9 +156,19 @@ typedef struct {
     float current_position_m;
     float distance_to_wire_end_m;
     
+    // Motion plan of the current run
+    float planned_peak_speed_ms;
+    float planned_run_time_s;           // Run start to roll-out, as last planned
+    uint32_t replan_count;              // Replans this run (estimate drifted from plan)
+    
+    // Wire map of the current run
+    bool map_anchored;                  // Map coordinate known (a wire end was reached)
+    float map_speed_cap_ms;             // Slow-zone cap on the planned speed (0 = none)
+    float map_bias_duty;                // Map feed-forward bias sent to the speed controller
+    
     // Status and error tracking
-    char status_message[128];
-    char error_message[128];
+    status_text_t status_text;
+    status_text_t error_text;
     uint32_t error_count;
 } automatic_mode_progress_t;
 
@@ -149,7 +184,7 @@ typedef struct {
     float max_speed_achieved_ms;        // Maximum speed reached
     coasting_calibration_t coasting_data; // Final coasting calibration
     bool interrupted_by_user;           // Whether stopped by user intervention
-    char completion_reason[64];         // Reason for stopping
+    status_text_t completion_text;      // Reason for stopping
 } automatic_mode_results_t;
 
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -198,6 +233,12 @@ bool automatic_mode_is_active(void);
  */
 bool automatic_mode_is_running(void);
 
+/**
+ * @brief Get current automatic mode state (no progress struct copy)
+ * @return Current automatic_mode_state_t
+ */
+automatic_mode_state_t automatic_mode_get_state(void);
+
 /**
  * @brief Get current automatic mode progress
  * @return Current progress data structure
@@ -238,6 +279,8 @@ coasting_calibration_t automatic_mode_get_coasting_data(void);
  * @param wire_length Total wire length in meters
  * @param direction_forward Current movement direction
  * @return Distance from current position to start coasting
+ * @note Uses the direction's coast model, derived from the other direction
+ *       and the grade until it has been fit itself
  */
 float automatic_mode_calculate_coasting_distance(float current_position, 
                                                 float wire_length, 
@@ -263,12 +306,18 @@ esp_err_t automatic_mode_update_coasting_calibration(float speed, float position
 esp_err_t automatic_mode_accelerate_to_speed(float target_speed);
 
 /**
- * @brief Execute controlled deceleration
+ * @brief Start controlled deceleration (ramp is stepped by automatic_mode_update)
  * @param target_speed Target speed in m/s (can be 0 for stop)
  * @return ESP_OK on success, error code on failure
  */
 esp_err_t automatic_mode_decelerate_to_speed(float target_speed);
 
+/**
+ * @brief Check if a deceleration ramp is in progress
+ * @return true while decelerating, false otherwise
+ */
+bool automatic_mode_is_decelerating(void);
+
 /**
  * @brief Maintain current cruise speed
  * @return ESP_OK on success, error code on failure
@@ -353,8 +402,11 @@ float automatic_mode_get_distance_to_wire_end(float current_position, bool direc
 bool automatic_mode_is_at_wire_end(void);
 
 /**
- * @brief Handle wire end detection
+ * @brief Handle wire end detection: count the run, then turn around or finish
  * @return ESP_OK on success
+ *
+ * A cycle is one run in each direction. A graceful stop, or
+ * AUTO_MODE_MAX_CYCLES, completes the mode here.
  */
 esp_err_t automatic_mode_handle_wire_end_reached(void);
 
@@ -382,10 +434,10 @@ bool automatic_mode_is_operation_safe(void);
 
 /**
  * @brief Handle emergency situation during automatic mode
- * @param error_message Description of emergency
+ * @param error Description of emergency
  * @return ESP_OK on success
  */
-esp_err_t automatic_mode_handle_emergency(const char* error_message);
+esp_err_t automatic_mode_handle_emergency(status_text_t error);
 
 /**
  * @brief Check sensor health during operation
@@ -0,0 +1,135 @@
+// components/automatic_mode/include/motion_planner.h
+#ifndef MOTION_PLANNER_H
+#define MOTION_PLANNER_H
+
+#include "esp_err.h"
+#include "coast_model.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MOTION_PLANNER.H - JERK-LIMITED RUN PROFILES BETWEEN WIRE ENDS
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Turn a distance and limits into a speed reference
+// - Run profile: S-curve speed change (jerk- and accel-limited), cruise,
+//   then motor-off coast predicted by the learned coast model (coast_model.h)
+//   so the trolley rolls out end_margin_m short of the wire end
+// - Peak speed is the highest one that still coasts out in time, which
+//   makes the run time-optimal for the given limits
+// - Ramp profile: S-curve speed change, then hold (open-ended)
+// - A plan is a handful of floats; sampling is closed-form, no allocation,
+//   cheap enough to evaluate every control tick
+//
+// Positions are distances travelled since the plan start (always >= 0).
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Planner configuration
+#define MOTION_PLANNER_SPEED_TOLERANCE_MS   0.001f  // Speeds closer than this are equal
+#define MOTION_PLANNER_SEARCH_ITERATIONS    24      // Peak-speed bisection steps (~0.3 mm/s at 5 m/s)
+
+// Motion limits
+typedef struct {
+    float max_speed_ms;                // Cruise speed cap
+    float max_accel_ms2;               // Acceleration limit of the speed change
+    float max_jerk_ms3;                // Jerk limit of the speed change
+    coast_model_t coast;               // Coasting model of the run direction (run plans only)
+    float end_margin_m;                // Roll-out point short of the planned distance (< 0: beyond, arrive moving)
+} motion_limits_t;
+
+// Profile segment
+typedef enum {
+    MOTION_PHASE_SPEED_CHANGE = 0,      // S-curve from start speed to peak speed
+    MOTION_PHASE_CRUISE,                // Constant peak speed
+    MOTION_PHASE_COAST,                 // Motor off, coast model deceleration
+    MOTION_PHASE_DONE                   // Plan finished (stopped, or holding the ramp target)
+} motion_phase_t;
+
+// Planned profile
+typedef struct {
+    bool valid;
+    bool coast_to_stop;                // Run plan (coast segment) vs ramp plan (hold)
+    bool overrun;                      // Cannot coast out before the roll-out point
+    motion_limits_t limits;
+    float start_speed_ms;
+    float peak_speed_ms;
+    float distance_m;                  // Planned roll-out distance (run plans)
+
+    // S-curve speed change
+    float jerk_time_s;                 // Each jerk segment
+    float const_accel_time_s;          // Constant-acceleration segment
+    float change_peak_accel_ms2;       // Acceleration reached (signed)
+    float change_time_s;
+    float change_distance_m;
+
+    // Cruise and coast
+    float cruise_time_s;
+    float cruise_distance_m;
+    float coast_time_s;
+    float coast_distance_m;
+
+    float total_time_s;                // Run plans: until rolled out; ramps: end of change
+} motion_plan_t;
+
+// Reference at one instant
+typedef struct {
+    motion_phase_t phase;
+    float position_m;                  // Distance since plan start
+    float speed_ms;
+    float accel_ms2;
+} motion_sample_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PLANNING API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Plan a run that coasts out end_margin_m short of distance_m
+ * @param limits Motion limits (valid coast model required)
+ * @param distance_m Distance to the wire end
+ * @param start_speed_ms Current speed (replanning starts from motion)
+ * @param plan Output plan (plan->overrun set if even coasting now overshoots)
+ * @return ESP_OK, ESP_ERR_INVALID_ARG on bad limits
+ */
+esp_err_t motion_planner_plan_run(const motion_limits_t* limits, float distance_m,
+                                  float start_speed_ms, motion_plan_t* plan);
+
+/**
+ * @brief Plan an S-curve speed change that then holds the target speed
+ * @param limits Motion limits (coast fields unused)
+ * @param start_speed_ms Current speed
+ * @param target_speed_ms Speed to reach (capped at max_speed_ms)
+ * @param plan Output plan
+ * @return ESP_OK, ESP_ERR_INVALID_ARG on bad limits
+ */
+esp_err_t motion_planner_plan_ramp(const motion_limits_t* limits, float start_speed_ms,
+                                   float target_speed_ms, motion_plan_t* plan);
+
+/**
+ * @brief Evaluate a plan
+ * @param plan Plan
+ * @param time_s Time since plan start
+ * @param sample Output reference
+ */
+void motion_planner_sample(const motion_plan_t* plan, float time_s, motion_sample_t* sample);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// UTILITY API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Distance needed to coast to a stop from a speed
+ * @param limits Motion limits
+ * @param speed_ms Speed at motor cut-off
+ * @return Coasting distance in meters
+ */
+float motion_planner_coast_distance(const motion_limits_t* limits, float speed_ms);
+
+/**
+ * @brief Get phase name
+ * @param phase Phase
+ * @return String name
+ */
+const char* motion_planner_phase_to_string(motion_phase_t phase);
+
+#endif // MOTION_PLANNER_H
@@ -5,14 +5,23 @@
 
 #include "automatic_mode.h"
 #include "hardware_control.h"
+#include "hal_clock.h"
 #include "sensor_health.h"
+#include "state_estimator.h"
+#include "imu_acquisition.h"
 #include "mode_coordinator.h"
+#include "wire_learning_mode.h"
+#include "flight_recorder.h"
+#include "motion_planner.h"
+#include "wire_map.h"
+#include "wire_end_detector.h"
+#include "deferred_log.h"
 #include "esp_log.h"
-#include "esp_timer.h"
 #include "nvs_flash.h"
 #include "nvs.h"
 #include <cmath>
 #include <cstring>
+#include <cstdio>
 
 static const char* TAG = "AUTOMATIC_MODE";
 
@@ -20,6 +29,11 @@ static const char* TAG = "AUTOMATIC_MODE";
 #define COAST_DETECTION_SPEED_MS    0.1f      // Speed threshold for coast detection
 #define AUTO_MODE_MIN_WIRE_LENGTH_M 2.0f      // Minimum wire length for automatic mode
 
+static_assert(AUTO_PLANNER_ARRIVAL_SPEED_MS <= AUTO_MODE_WIRE_END_APPROACH_MS,
+              "A planned arrival must not hit the wire end harder than a seek");
+static_assert(AUTO_MODE_WIRE_END_APPROACH_MS < AUTO_MODE_IMPACT_SPEED_MS,
+              "A seek at approach speed must not count as an incident");
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // GLOBAL AUTOMATIC MODE STATE
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -31,18 +45,24 @@ static automatic_mode_progress_t g_auto_progress = {
     .current_target_speed = 0.0f,
     .acceleration_rate = AUTO_MODE_ACCEL_RATE_MS2,
     .esc_auto_armed = false,
-    .coasting = {0},
+    .coasting = {},
     .coasting_active = false,
     .coasting_start_time = 0,
     .coasting_start_rotations = 0,
-    .cycle_data = {0},
+    .cycle_data = {},
     .user_interrupted = false,
     .finishing_current_run = false,
     .wire_length_m = 0.0f,
     .current_position_m = 0.0f,
     .distance_to_wire_end_m = 0.0f,
-    .status_message = {0},
-    .error_message = {0},
+    .planned_peak_speed_ms = 0.0f,
+    .planned_run_time_s = 0.0f,
+    .replan_count = 0,
+    .map_anchored = false,
+    .map_speed_cap_ms = 0.0f,
+    .map_bias_duty = 0.0f,
+    .status_text = STATUS_TEXT_NONE,
+    .error_text = STATUS_TEXT_NONE,
     .error_count = 0
 };
 
@@ -53,17 +73,45 @@ static automatic_mode_results_t g_auto_results = {
     .total_distance_traveled_m = 0.0f,
     .average_cycle_time_ms = 0.0f,
     .max_speed_achieved_ms = 0.0f,
-    .coasting_data = {0},
+    .coasting_data = {},
     .interrupted_by_user = false,
-    .completion_reason = {0}
+    .completion_text = STATUS_TEXT_NONE
 };
 
 static bool g_auto_initialized = false;
 
 // Speed control state
 static float g_current_acceleration_target = 0.0f;
-static uint64_t g_acceleration_start_time = 0;
-static uint32_t g_acceleration_start_rotations = 0;
+
+// Speed ramp (accelerate/decelerate_to_speed): jerk-limited plan sampled every update
+static bool g_ramp_active = false;
+static motion_plan_t g_ramp_plan;
+static uint64_t g_ramp_start_time = 0;
+
+// Planned run between wire ends: speed change → cruise → coast-out
+static bool g_run_active = false;
+static motion_plan_t g_run_plan;
+static uint64_t g_run_plan_start_time = 0;
+static float g_run_plan_origin_m = 0.0f;       // Run distance when the current plan started
+static float g_run_start_position_m = 0.0f;    // Estimator position at run start
+static float g_run_slope_ms2 = 0.0f;           // Accelerometer bias at run start (wire slope, + forward uphill)
+static uint64_t g_last_replan_time = 0;
+
+// Ramps and runs: periodic safety check, speed command only on change
+static uint64_t g_next_safety_check_time = 0;
+static uint32_t g_last_commanded_mm_s = UINT32_MAX;
+
+// Wire end approach: seek deadline, then settle deadline (0 = no approach in progress)
+static uint64_t g_approach_deadline = 0;
+static bool g_seek_active = false;               // Driving toward the wire end at approach speed
+static float g_arrival_speed_ms = 0.0f;          // Speed peak of the last AUTO_MODE_ARRIVAL_HOLD_MS
+static uint64_t g_arrival_speed_time = 0;
+static uint64_t g_seek_start_time = 0;
+static uint32_t g_seek_rotations = 0;            // Rotation count at the last Hall edge seen
+static uint64_t g_seek_edge_time = 0;
+
+// Turnaround pause at a wire end (0 = no direction change in progress)
+static uint64_t g_direction_change_deadline = 0;
 
 // Coasting state
 static bool g_coasting_in_progress = false;
@@ -71,66 +119,154 @@ static uint64_t g_coasting_start_time = 0;
 static uint32_t g_coasting_start_rotations = 0;
 static float g_coasting_start_speed = 0.0f;
 
+// Speed trace of the coasting phase in progress (refits the coast model)
+static coast_fit_t g_coast_fit = {};
+
+// Runs measured end to end (first wire end reached since start)
+static bool g_run_from_wire_end = false;
+
+// Planned runs until the first natural coast-out calibrate the coasting data
+static bool g_calibration_run = false;
+
 // User interruption tracking
 static bool g_user_interruption_requested = false;
 static uint64_t g_interruption_request_time = 0;
 
+// Wire map: coordinate = estimator position - origin, anchored at every wire end
+static bool g_map_anchored = false;
+static float g_map_origin_m = 0.0f;
+static imu_reader_t g_map_reader = {};
+static float g_map_bias_duty = 0.0f;             // Feed-forward bias last sent
+static bool g_map_capped = false;                 // Run speed held below the plan by a zone
+static bool g_map_ahead_slow = false;             // Lookahead probe inside a slow zone last tick
+
+// Slow zones seen by the lookahead probe, not yet reached
+typedef struct {
+    float position_m;                             // Map coordinate of the zone start
+    float limit_ms;
+} map_zone_t;
+static map_zone_t g_map_zones[AUTO_MAP_MAX_PENDING_ZONES];
+static uint32_t g_map_zone_count = 0;
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // COASTING CALIBRATION AND MANAGEMENT
 // ═══════════════════════════════════════════════════════════════════════════════
 
+static coast_model_t* direction_coast_model(bool forward) {
+    return forward ? &g_auto_progress.coasting.model_forward : &g_auto_progress.coasting.model_reverse;
+}
+
+/**
+ * @brief Coast model for a direction
+ *
+ * Until the direction has been fit, the other direction's model with the
+ * grade turned around: the slope the accelerometer learned at rest decelerates
+ * one way and pushes the other, so the two differ by twice its share. Only a
+ * downhill share is applied: the at-rest bias is noisy, and a coast predicted
+ * too long stops short where one predicted too short hits the end. Falls back
+ * to the single calibrated deceleration, then to the longest expected coast,
+ * when neither direction has a model.
+ */
+static coast_model_t direction_prediction_model(bool forward) {
+    const coast_model_t* learned = direction_coast_model(forward);
+    if (learned->valid) {
+        return *learned;
+    }
+    const coast_model_t* other = direction_coast_model(!forward);
+    if (other->valid) {
+        coast_model_t model = *other;
+        float grade_ms2 = forward ? g_run_slope_ms2 : -g_run_slope_ms2;
+        model.base_decel_ms2 += 2.0f * fminf(grade_ms2, 0.0f);
+        if (model.base_decel_ms2 < AUTO_PLANNER_MIN_COAST_DECEL_MS2) {
+            model.base_decel_ms2 = AUTO_PLANNER_MIN_COAST_DECEL_MS2;
+        }
+        return model;
+    }
+    if (g_auto_progress.coasting.calibrated &&
+        g_auto_progress.coasting.deceleration_rate_ms2 >= AUTO_PLANNER_MIN_COAST_DECEL_MS2) {
+        return coast_model_constant(g_auto_progress.coasting.deceleration_rate_ms2);
+    }
+    return coast_model_constant((AUTO_COASTING_CALIBRATION_SPEED * AUTO_COASTING_CALIBRATION_SPEED) /
+                                (2.0f * AUTO_COASTING_MAX_DISTANCE_M));
+}
+
+static coast_model_t run_coast_model(void) {
+    return direction_prediction_model(g_auto_progress.cycle_data.current_direction_forward);
+}
+
+static void publish_coasting_data(void) {
+    coasting_data_t coasting_data = {
+        .calibrated = true,
+        .coasting_distance_m = g_auto_progress.coasting.coasting_distance_m,
+        .coast_start_distance_m = g_auto_progress.coasting.coast_start_distance_m,
+        .coast_time_ms = g_auto_progress.coasting.coasting_time_ms,
+        .decel_rate_ms2 = g_auto_progress.coasting.deceleration_rate_ms2,
+        .model_forward = g_auto_progress.coasting.model_forward,
+        .model_reverse = g_auto_progress.coasting.model_reverse
+    };
+    
+    // Coordinator persists it with the site profile once the mode is idle
+    mode_coordinator_set_coasting_data(&coasting_data);
+}
+
+/**
+ * @brief Fold the finished coasting phase into the direction's model
+ */
+static void finish_coast_fit(void) {
+    bool forward = g_auto_progress.cycle_data.current_direction_forward;
+    coast_model_t* model = direction_coast_model(forward);
+    
+    esp_err_t result = coast_fit_finish(&g_coast_fit, model);
+    if (result != ESP_OK) {
+        deferred_log(DLOG_MSG_AUTO_COAST_TRACE_UNUSED, esp_err_to_name(result));
+        return;
+    }
+    
+    deferred_log(DLOG_MSG_AUTO_COAST_MODEL, forward ? "forward" : "reverse", model->base_decel_ms2,
+                 model->drag_per_m, (unsigned)model->fits, model->residual_ms2);
+    if (g_auto_progress.coasting.calibrated) {
+        publish_coasting_data();
+    }
+}
+
+static esp_err_t start_planned_run(void);
+
+/**
+ * @brief Start the calibration run
+ *
+ * A planned run like any other: the profile generator caps the peak speed
+ * so the run coasts out on the learned wire length under the conservative
+ * default coast model (run_coast_model()), short wires included. The coast
+ * phase is the measurement.
+ */
 esp_err_t automatic_mode_start_coasting_calibration(void) {
     if (g_auto_progress.coasting.calibrated) {
-        ESP_LOGI(TAG, "Coasting already calibrated - skipping");
+        deferred_log(DLOG_MSG_AUTO_COAST_CAL_SKIPPED);
         return ESP_OK;
     }
     
-    ESP_LOGI(TAG, "Starting coasting calibration at %.1f m/s", AUTO_COASTING_CALIBRATION_SPEED);
-    
-    g_auto_progress.state = AUTO_MODE_COASTING_CALIBRATION;
-    g_auto_progress.state_start_time = esp_timer_get_time();
-    
-    // Accelerate to calibration speed
-    esp_err_t result = automatic_mode_accelerate_to_speed(AUTO_COASTING_CALIBRATION_SPEED);
+    esp_err_t result = start_planned_run();
     if (result != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to start acceleration for coasting calibration");
+        deferred_log(DLOG_MSG_AUTO_COAST_CAL_FAILED);
         return result;
     }
     
-    strcpy(g_auto_progress.status_message, "Coasting calibration - accelerating to 5.0 m/s");
+    deferred_log(DLOG_MSG_AUTO_COAST_CAL_START, g_run_plan.peak_speed_ms);
     return ESP_OK;
 }
 
+/**
+ * @brief Turn the calibration run's coast into the coasting calibration
+ *
+ * Called once the coast started by the plan has rolled to a stop.
+ */
 esp_err_t automatic_mode_update_coasting_calibration(float speed, float position) {
-    static bool calibration_motor_stopped = false;
-    
-    // Wait until we reach calibration speed
-    if (speed < AUTO_COASTING_CALIBRATION_SPEED - 0.2f) {
-        return ESP_OK; // Still accelerating
-    }
-    
-    // Stop motor and start measuring coasting
-    if (!calibration_motor_stopped) {
-        ESP_LOGI(TAG, "Reached %.1f m/s - stopping motor for coasting measurement", speed);
-        
-        hardware_set_motor_speed(0.0f, g_auto_progress.cycle_data.current_direction_forward);
-        
-        g_coasting_start_time = esp_timer_get_time();
-        g_coasting_start_rotations = hardware_get_rotation_count();
-        g_coasting_start_speed = speed;
-        calibration_motor_stopped = true;
-        
-        strcpy(g_auto_progress.status_message, "Measuring coasting distance...");
-        return ESP_OK;
-    }
-    
-    // Monitor coasting until stopped
     if (speed > COAST_DETECTION_SPEED_MS) {
         return ESP_OK; // Still coasting
     }
     
     // Coasting complete - calculate results
-    uint64_t coast_end_time = esp_timer_get_time();
+    uint64_t coast_end_time = hal_clock_now_us();
     uint32_t coast_end_rotations = hardware_get_rotation_count();
     
     g_auto_progress.coasting.calibrated = true;
@@ -145,35 +281,28 @@ esp_err_t automatic_mode_update_coasting_calibration(float speed, float position
     g_auto_progress.coasting.calibration_rotations = coast_end_rotations - g_coasting_start_rotations;
     g_auto_progress.coasting.calibration_successful = true;
     
+    // Seed this direction's model from the trace, or from the average deceleration
+    coast_model_t* model = direction_coast_model(g_auto_progress.cycle_data.current_direction_forward);
+    if (coast_fit_finish(&g_coast_fit, model) != ESP_OK && !model->valid) {
+        *model = coast_model_constant(g_auto_progress.coasting.deceleration_rate_ms2);
+    }
+    
     // Validate coasting data
     if (g_auto_progress.coasting.coasting_distance_m < AUTO_COASTING_MIN_DISTANCE_M ||
         g_auto_progress.coasting.coasting_distance_m > AUTO_COASTING_MAX_DISTANCE_M) {
-        ESP_LOGW(TAG, "Coasting distance out of expected range: %.2f m", 
-                g_auto_progress.coasting.coasting_distance_m);
+        deferred_log(DLOG_MSG_AUTO_COAST_OUT_OF_RANGE, g_auto_progress.coasting.coasting_distance_m);
         g_auto_progress.coasting.calibration_successful = false;
         return ESP_ERR_INVALID_SIZE;
     }
     
     // Save coasting data
-    coasting_data_t coasting_data = {
-        .calibrated = true,
-        .coasting_distance_m = g_auto_progress.coasting.coasting_distance_m,
-        .coast_start_distance_m = g_auto_progress.coasting.coast_start_distance_m,
-        .coast_time_ms = g_auto_progress.coasting.coasting_time_ms,
-        .decel_rate_ms2 = g_auto_progress.coasting.deceleration_rate_ms2
-    };
+    publish_coasting_data();
     
-    mode_coordinator_set_coasting_data(&coasting_data);
-    
-    ESP_LOGI(TAG, "=== COASTING CALIBRATION COMPLETE ===");
-    ESP_LOGI(TAG, "Coasting Distance: %.2f m", g_auto_progress.coasting.coasting_distance_m);
-    ESP_LOGI(TAG, "Coasting Time: %lu ms", g_auto_progress.coasting.coasting_time_ms);
-    ESP_LOGI(TAG, "Deceleration Rate: %.2f m/s²", g_auto_progress.coasting.deceleration_rate_ms2);
-    ESP_LOGI(TAG, "Coast Start Distance: %.2f m from wire end", g_auto_progress.coasting.coast_start_distance_m);
+    deferred_log(DLOG_MSG_AUTO_COAST_CAL_COMPLETE, g_auto_progress.coasting.coasting_distance_m,
+                 g_auto_progress.coasting.coasting_time_ms, g_auto_progress.coasting.deceleration_rate_ms2,
+                 g_auto_progress.coasting.coast_start_distance_m);
     
-    // Reset for normal operation
-    calibration_motor_stopped = false;
-    strcpy(g_auto_progress.status_message, "Coasting calibration complete");
+    g_auto_progress.status_text = STATUS_TEXT_AUTO_COAST_CAL_COMPLETE;
     
     return ESP_OK;
 }
@@ -200,34 +329,434 @@ float automatic_mode_calculate_coasting_distance(float current_position,
         distance_to_wire_end = current_position;
     }
     
+    // Learned model: coast distance from the current speed, planner roll-out margin
+    coast_model_t model = direction_prediction_model(direction_forward);
+    if (model.valid) {
+        return distance_to_wire_end - coast_model_stop_distance(&model, state_estimator_get_speed()) -
+               AUTO_PLANNER_END_MARGIN_M;
+    }
+    
     return distance_to_wire_end - g_auto_progress.coasting.coast_start_distance_m;
 }
 
+// ═══════════════════════════════════════════════════════════════════════════════
+// WIRE MAP
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void reset_map_zones(void) {
+    g_map_zone_count = 0;
+    g_map_ahead_slow = false;
+    g_map_capped = false;
+    g_auto_progress.map_speed_cap_ms = 0.0f;
+}
+
+/**
+ * @brief Anchor the map coordinate at a reached wire end
+ * @param forward Direction of the run that ended there
+ *
+ * The forward end is the mapped wire length, the reverse end 0. Anchoring
+ * again at every end keeps Hall slip from accumulating across runs.
+ */
+static void anchor_wire_map(bool forward) {
+    float position = state_estimator_get_position();
+    g_map_origin_m = forward ? position - wire_map_get_length() : position;
+    g_map_anchored = wire_map_is_valid();
+    g_auto_progress.map_anchored = g_map_anchored;
+    reset_map_zones();
+}
+
+static bool map_coordinate(float estimator_position_m, float* map_m) {
+    if (!g_map_anchored || !wire_map_is_valid()) return false;
+    *map_m = estimator_position_m - g_map_origin_m;
+    return true;
+}
+
+/**
+ * @brief Send the map feed-forward bias, only when it changed noticeably
+ */
+static void send_map_bias(float bias_duty) {
+    if (bias_duty == g_map_bias_duty) return;
+    if (bias_duty != 0.0f && fabsf(bias_duty - g_map_bias_duty) < AUTO_MAP_BIAS_STEP_DUTY) return;
+    if (hardware_set_feed_forward_bias(bias_duty) == ESP_OK) {
+        g_map_bias_duty = bias_duty;
+        g_auto_progress.map_bias_duty = bias_duty;
+    }
+}
+
+/**
+ * @brief Speed cap from slow zones at and ahead of the trolley
+ * @param map_m Map coordinate
+ * @param forward Travel direction
+ * @param speed_ms Current speed
+ * @param here_limit_ms Zone limit at the trolley
+ * @return Cap in m/s (WIRE_MAP_NO_LIMIT_MS if none)
+ *
+ * The lookahead probe runs one braking distance plus margin ahead, so it
+ * sweeps every bin before the trolley gets there. Each zone it enters
+ * becomes a braking curve down to the zone limit at the zone start; inside
+ * the zone the lookup at the trolley takes over.
+ */
+static float map_speed_cap(float map_m, bool forward, float speed_ms, float here_limit_ms) {
+    float sign = forward ? 1.0f : -1.0f;
+    float lookahead_m = speed_ms * speed_ms / (2.0f * AUTO_MODE_DECEL_RATE_MS2) + AUTO_MAP_LOOKAHEAD_MARGIN_M;
+    float probe_m = map_m + sign * lookahead_m;
+    
+    wire_map_point_t ahead;
+    bool ahead_slow = wire_map_lookup(probe_m, forward, &ahead) && ahead.slow_zone;
+    if (ahead_slow && !g_map_ahead_slow) {
+        if (g_map_zone_count < AUTO_MAP_MAX_PENDING_ZONES) {
+            g_map_zones[g_map_zone_count].position_m = probe_m;
+            g_map_zones[g_map_zone_count].limit_ms = ahead.speed_limit_ms;
+            g_map_zone_count++;
+        } else {
+            deferred_log(DLOG_MSG_AUTO_SLOW_ZONE_UNTRACKED, probe_m, AUTO_MAP_MAX_PENDING_ZONES);
+        }
+    }
+    g_map_ahead_slow = ahead_slow;
+    
+    float cap = here_limit_ms;
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < g_map_zone_count; i++) {
+        float remaining_m = sign * (g_map_zones[i].position_m - map_m);
+        if (remaining_m <= 0.0f) continue;   // Reached: the lookup at the trolley holds the limit
+        float limit = g_map_zones[i].limit_ms;
+        float braking_cap = sqrtf(limit * limit + 2.0f * AUTO_MODE_DECEL_RATE_MS2 * remaining_m);
+        if (braking_cap < cap) cap = braking_cap;
+        g_map_zones[kept++] = g_map_zones[i];
+    }
+    g_map_zone_count = kept;
+    return cap;
+}
+
+/**
+ * @brief Feed the wire map from the run in progress
+ *
+ * Closed loop: the duty the trolley needs beyond the LUT is the bias sent
+ * plus the PI correction, when the controller is tracking at steady speed.
+ */
+static void record_wire_map(float map_m, bool forward, const state_estimate_t* estimate, bool motor_on) {
+    float peak_g = imu_acquisition_read_peak_g(&g_map_reader);
+    float impact_g = (peak_g > 1.0f) ? peak_g - 1.0f : 0.0f;
+    
+    speed_controller_status_t controller = hardware_get_speed_controller_status();
+    bool steady = motor_on && controller.closed_loop && !controller.saturated &&
+                  estimate->speed_ms >= WIRE_MAP_MIN_SPEED_MS &&
+                  fabsf(estimate->acceleration_ms2) < WIRE_MAP_STEADY_ACCEL_MS2;
+    
+    wire_map_record(map_m, forward, controller.bias_duty + controller.correction_duty, steady, impact_g);
+}
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // SPEED CONTROL IMPLEMENTATION
 // ═══════════════════════════════════════════════════════════════════════════════
 
+static motion_limits_t planner_limits(float max_speed_ms, float max_accel_ms2) {
+    motion_limits_t limits = {
+        .max_speed_ms = max_speed_ms,
+        .max_accel_ms2 = max_accel_ms2,
+        .max_jerk_ms3 = AUTO_MODE_JERK_LIMIT_MS3,
+        .coast = run_coast_model(),
+        .end_margin_m = AUTO_PLANNER_END_MARGIN_M
+    };
+    return limits;
+}
+
+static float cruise_speed_limit(void) {
+    float limit = AUTO_MODE_MAX_SPEED_MS;
+    
+    // Stored profile not yet confirmed by a run: stay at the speed learning proved safe
+    const wire_learning_results_t* wire_data = mode_coordinator_get_wire_learning_results();
+    if (mode_coordinator_get_calibration_state() == CALIBRATION_PROFILE_UNVERIFIED &&
+        wire_data != NULL && wire_data->optimal_learning_speed_ms > 0.0f &&
+        wire_data->optimal_learning_speed_ms < limit) {
+        limit = wire_data->optimal_learning_speed_ms;
+    }
+    return limit;
+}
+
+/**
+ * @brief Send a planned speed to the hardware speed controller
+ *
+ * Called every tick by ramps and runs; the command is only re-issued when
+ * it changes at the controller's mm/s resolution.
+ */
+static void command_planned_speed(float speed_ms) {
+    uint32_t speed_mm_s = (uint32_t)(speed_ms * 1000.0f + 0.5f);
+    if (speed_mm_s == g_last_commanded_mm_s) {
+        return;
+    }
+    if (hardware_set_speed_closed_loop(speed_ms, g_auto_progress.cycle_data.current_direction_forward) == ESP_OK) {
+        g_last_commanded_mm_s = speed_mm_s;
+    }
+}
+
+static bool planned_motion_safe(uint64_t now) {
+    if (now < g_next_safety_check_time) {
+        return true;
+    }
+    g_next_safety_check_time = now + AUTO_MODE_DECEL_STEP_MS * 1000ULL;
+    
+    if (!automatic_mode_is_operation_safe()) {
+        deferred_log(DLOG_MSG_AUTO_SAFETY_FAILED);
+        g_ramp_active = false;
+        g_run_active = false;
+        automatic_mode_handle_emergency(STATUS_TEXT_AUTO_SAFETY_FAILURE);
+        return false;
+    }
+    return true;
+}
+
+static void start_ramp(float target_speed, float max_accel_ms2) {
+    uint64_t now = hal_clock_now_us();
+    motion_limits_t limits = planner_limits(AUTO_MODE_MAX_SPEED_MS, max_accel_ms2);
+    motion_planner_plan_ramp(&limits, state_estimator_get_speed(), target_speed, &g_ramp_plan);
+    
+    // A ramp replaces any planned run (and its map feed-forward)
+    g_run_active = false;
+    send_map_bias(0.0f);
+    g_ramp_start_time = now;
+    g_next_safety_check_time = now;
+    g_last_commanded_mm_s = UINT32_MAX;
+    g_ramp_active = true;
+}
+
+static esp_err_t step_ramp(uint64_t now) {
+    if (!planned_motion_safe(now)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    motion_sample_t ref;
+    motion_planner_sample(&g_ramp_plan, (now - g_ramp_start_time) / 1000000.0f, &ref);
+    
+    // Speeding up from rest: the speed controller needs a minimum target to move
+    float speed = ref.speed_ms;
+    if (g_ramp_plan.peak_speed_ms > g_ramp_plan.start_speed_ms && speed < AUTO_MODE_START_SPEED_MS) {
+        speed = AUTO_MODE_START_SPEED_MS;
+    }
+    command_planned_speed(speed);
+    g_auto_progress.current_target_speed = speed;
+    
+    if (ref.phase == MOTION_PHASE_DONE) {
+        g_ramp_active = false;
+        deferred_log(DLOG_MSG_AUTO_RAMP_COMPLETE, g_ramp_plan.peak_speed_ms);
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief (Re)plan the rest of the current run from the measured state
+ * @param now Plan start time
+ * @param travelled_m Distance already covered this run
+ * @param speed_ms Current speed
+ */
+static esp_err_t plan_run_from(uint64_t now, float travelled_m, float speed_ms) {
+    float max_speed_ms = cruise_speed_limit();
+    if (g_calibration_run) {
+        max_speed_ms = fminf(max_speed_ms, AUTO_COASTING_CALIBRATION_SPEED);
+    }
+    motion_limits_t limits = planner_limits(max_speed_ms, AUTO_MODE_ACCEL_RATE_MS2);
+    
+    // A fit direction rolls onto the wire end below approach speed instead of
+    // stopping short and seeking; a calibration coast has to stop on its own
+    if (!g_calibration_run && direction_coast_model(g_auto_progress.cycle_data.current_direction_forward)->valid) {
+        limits.end_margin_m = -coast_model_stop_distance(&limits.coast, AUTO_PLANNER_ARRIVAL_SPEED_MS);
+    }
+    esp_err_t result = motion_planner_plan_run(&limits, g_auto_progress.wire_length_m - travelled_m,
+                                               speed_ms, &g_run_plan);
+    if (result != ESP_OK) {
+        return result;
+    }
+    
+    g_run_plan_start_time = now;
+    g_run_plan_origin_m = travelled_m;
+    g_last_replan_time = now;
+    g_last_commanded_mm_s = UINT32_MAX;
+    g_run_active = true;
+    
+    g_auto_progress.planned_peak_speed_ms = g_run_plan.peak_speed_ms;
+    g_auto_progress.planned_run_time_s = (now - g_auto_progress.cycle_data.run_start_time) / 1000000.0f +
+                                         g_run_plan.total_time_s;
+    if (g_run_plan.overrun) {
+        deferred_log(DLOG_MSG_AUTO_RUN_OVERRUN, g_auto_progress.wire_length_m - travelled_m, speed_ms);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t start_planned_run(void) {
+    uint64_t now = hal_clock_now_us();
+    
+    g_ramp_active = false;
+    g_run_start_position_m = state_estimator_get_position();
+    g_run_slope_ms2 = state_estimator_get_state().accel_bias_ms2;
+    g_auto_progress.cycle_data.run_start_time = now;
+    g_auto_progress.replan_count = 0;
+    g_next_safety_check_time = now;
+    reset_map_zones();
+    imu_acquisition_reader_init(&g_map_reader);
+    wire_end_detector_arm(g_auto_progress.cycle_data.current_direction_forward);
+    hardware_set_feed_forward_bias(0.0f);
+    g_map_bias_duty = 0.0f;
+    g_auto_progress.map_bias_duty = 0.0f;
+    g_calibration_run = !g_auto_progress.coasting.calibrated;
+    
+    esp_err_t result = plan_run_from(now, 0.0f, state_estimator_get_speed());
+    if (result != ESP_OK) {
+        deferred_log(DLOG_MSG_AUTO_RUN_PLAN_FAILED);
+        return result;
+    }
+    
+    g_current_acceleration_target = g_run_plan.peak_speed_ms;
+    g_auto_progress.state = g_calibration_run ? AUTO_MODE_COASTING_CALIBRATION : AUTO_MODE_ACCELERATING;
+    g_auto_progress.state_start_time = now;
+    g_auto_progress.status_text = g_calibration_run ? STATUS_TEXT_AUTO_COAST_CAL_ACCELERATING
+                                                    : STATUS_TEXT_AUTO_RUN_PLANNED;
+    deferred_log(DLOG_MSG_AUTO_RUN_PLANNED, g_auto_progress.wire_length_m, g_run_plan.peak_speed_ms,
+                 g_run_plan.total_time_s);
+    return ESP_OK;
+}
+
+static void set_run_state(automatic_mode_state_t state, uint64_t now) {
+    // A calibration run keeps its own state until the measured coast
+    if (g_calibration_run && state != AUTO_MODE_COASTING) {
+        state = AUTO_MODE_COASTING_CALIBRATION;
+    }
+    if (g_auto_progress.state == state) {
+        return;
+    }
+    g_auto_progress.state = state;
+    g_auto_progress.state_start_time = now;
+    
+    switch (state) {
+        case AUTO_MODE_COASTING_CALIBRATION:
+            g_auto_progress.status_text = STATUS_TEXT_AUTO_COAST_CAL_ACCELERATING;
+            g_coasting_in_progress = false;
+            coast_fit_abort(&g_coast_fit);
+            break;
+        case AUTO_MODE_ACCELERATING:
+            g_auto_progress.status_text = STATUS_TEXT_AUTO_RUN_CHANGING_SPEED;
+            g_coasting_in_progress = false;
+            coast_fit_abort(&g_coast_fit);
+            break;
+        case AUTO_MODE_CRUISING:
+            g_auto_progress.status_text = STATUS_TEXT_AUTO_RUN_CRUISING;
+            g_coasting_in_progress = false;
+            coast_fit_abort(&g_coast_fit);
+            break;
+        default:
+            g_auto_progress.status_text = STATUS_TEXT_AUTO_RUN_COASTING;
+            g_coasting_in_progress = true;
+            coast_fit_begin(&g_coast_fit, state_estimator_get_speed(), now);
+            if (g_calibration_run) {
+                g_coasting_start_time = now;
+                g_coasting_start_rotations = hardware_get_rotation_count();
+                g_coasting_start_speed = state_estimator_get_speed();
+                g_auto_progress.status_text = STATUS_TEXT_AUTO_COAST_CAL_MEASURING;
+                deferred_log(DLOG_MSG_AUTO_COAST_CAL_STOP, g_coasting_start_speed);
+            }
+            break;
+    }
+}
+
+/**
+ * @brief Follow the run plan; replan when the estimate drifts from it
+ */
+static esp_err_t step_run(uint64_t now) {
+    if (!planned_motion_safe(now)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    motion_sample_t ref;
+    motion_planner_sample(&g_run_plan, (now - g_run_plan_start_time) / 1000000.0f, &ref);
+    
+    state_estimate_t estimate = state_estimator_get_state();
+    float travelled_m = fabsf(estimate.position_m - g_run_start_position_m);
+    float position_error_m = travelled_m - (g_run_plan_origin_m + ref.position_m);
+    float speed_error_ms = estimate.speed_ms - ref.speed_ms;
+    bool forward = g_auto_progress.cycle_data.current_direction_forward;
+    bool motor_on = (ref.phase == MOTION_PHASE_SPEED_CHANGE || ref.phase == MOTION_PHASE_CRUISE);
+    
+    // Wire map: slow zones cap the plan, grade/friction is fed forward
+    float map_m = 0.0f;
+    wire_map_point_t here = {};
+    bool mapped = map_coordinate(estimate.position_m, &map_m) && wire_map_lookup(map_m, forward, &here);
+    float map_cap = WIRE_MAP_NO_LIMIT_MS;
+    if (mapped && motor_on) {
+        map_cap = map_speed_cap(map_m, forward, estimate.speed_ms, here.speed_limit_ms);
+    }
+    bool capped = map_cap < ref.speed_ms;
+    
+    // Held below the plan by design: replan once the zone releases, not while in it
+    bool zone_released = g_map_capped && !capped;
+    g_map_capped = capped;
+    g_auto_progress.map_speed_cap_ms = capped ? map_cap : 0.0f;
+    
+    // The calibration coast is the measurement: it runs out untouched
+    bool measuring = g_calibration_run && g_coasting_in_progress;
+    
+    if (ref.phase != MOTION_PHASE_DONE && !capped && !measuring &&
+        (zone_released ||
+         ((now - g_last_replan_time) >= AUTO_PLANNER_REPLAN_INTERVAL_MS * 1000ULL &&
+          (fabsf(position_error_m) > AUTO_PLANNER_REPLAN_POSITION_M ||
+           fabsf(speed_error_ms) > AUTO_PLANNER_REPLAN_SPEED_MS)))) {
+        deferred_log(DLOG_MSG_AUTO_REPLANNING, position_error_m, speed_error_ms,
+                     zone_released ? " (slow zone passed)" : "");
+        if (plan_run_from(now, travelled_m, estimate.speed_ms) == ESP_OK) {
+            g_auto_progress.replan_count++;
+            motion_planner_sample(&g_run_plan, 0.0f, &ref);
+        }
+    }
+    
+    switch (ref.phase) {
+        case MOTION_PHASE_SPEED_CHANGE:
+        case MOTION_PHASE_CRUISE:
+            {
+                float speed = fminf(ref.speed_ms, map_cap);
+                if (g_run_plan.peak_speed_ms > g_run_plan.start_speed_ms && speed < AUTO_MODE_START_SPEED_MS) {
+                    speed = AUTO_MODE_START_SPEED_MS;
+                }
+                send_map_bias(mapped && here.known ? here.residual_duty : 0.0f);
+                command_planned_speed(speed);
+                g_auto_progress.current_target_speed = speed;
+                set_run_state(ref.phase == MOTION_PHASE_CRUISE ? AUTO_MODE_CRUISING : AUTO_MODE_ACCELERATING, now);
+            }
+            break;
+            
+        default:
+            // Motor off: handle_coasting_state() finds the stop or the wire end
+            send_map_bias(0.0f);
+            command_planned_speed(0.0f);
+            g_auto_progress.current_target_speed = 0.0f;
+            set_run_state(AUTO_MODE_COASTING, now);
+            break;
+    }
+    
+    if (mapped) {
+        record_wire_map(map_m, forward, &estimate, motor_on);
+    }
+    
+    g_auto_progress.distance_to_wire_end_m = g_auto_progress.wire_length_m - travelled_m;
+    return ESP_OK;
+}
+
 esp_err_t automatic_mode_accelerate_to_speed(float target_speed) {
     if (target_speed > AUTO_MODE_MAX_SPEED_MS) {
-        ESP_LOGW(TAG, "Target speed %.1f m/s exceeds maximum %.1f m/s", 
-                target_speed, AUTO_MODE_MAX_SPEED_MS);
+        deferred_log(DLOG_MSG_AUTO_SPEED_CLAMPED, target_speed, AUTO_MODE_MAX_SPEED_MS);
         target_speed = AUTO_MODE_MAX_SPEED_MS;
     }
     
-    ESP_LOGI(TAG, "Starting gradual acceleration to %.1f m/s", target_speed);
+    deferred_log(DLOG_MSG_AUTO_ACCELERATING, target_speed);
     
     g_current_acceleration_target = target_speed;
-    g_acceleration_start_time = esp_timer_get_time();
-    g_acceleration_start_rotations = hardware_get_rotation_count();
     
-    // Start with minimum speed
-    esp_err_t result = hardware_set_motor_speed(AUTO_MODE_START_SPEED_MS, 
-                                               g_auto_progress.cycle_data.current_direction_forward);
+    // Start with minimum speed; the ramp takes over from the next update
+    esp_err_t result = hardware_set_speed_closed_loop(AUTO_MODE_START_SPEED_MS,
+                                                      g_auto_progress.cycle_data.current_direction_forward);
     if (result != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to start acceleration");
+        deferred_log(DLOG_MSG_AUTO_ACCEL_FAILED);
         return result;
     }
     
+    start_ramp(target_speed, AUTO_MODE_ACCEL_RATE_MS2);
     g_auto_progress.current_target_speed = AUTO_MODE_START_SPEED_MS;
     g_auto_progress.acceleration_rate = AUTO_MODE_ACCEL_RATE_MS2;
     
@@ -235,51 +764,32 @@ esp_err_t automatic_mode_accelerate_to_speed(float target_speed) {
 }
 
 esp_err_t automatic_mode_decelerate_to_speed(float target_speed) {
-    ESP_LOGI(TAG, "Starting deceleration to %.1f m/s", target_speed);
+    deferred_log(DLOG_MSG_AUTO_DECELERATING, target_speed);
     
-    float current_speed = hardware_get_current_speed();
+    float current_speed = state_estimator_get_speed();
     if (current_speed <= target_speed) {
-        ESP_LOGW(TAG, "Already at or below target speed");
+        deferred_log(DLOG_MSG_AUTO_DECEL_NOT_NEEDED);
         return ESP_OK;
     }
     
-    // Calculate deceleration time
-    float speed_difference = current_speed - target_speed;
-    float decel_time_s = speed_difference / AUTO_MODE_DECEL_RATE_MS2;
-    
-    // Gradual deceleration
-    uint32_t steps = (uint32_t)(decel_time_s * 10); // 10 steps per second
-    float speed_step = speed_difference / steps;
-    
-    for (uint32_t i = 0; i < steps; i++) {
-        float new_speed = current_speed - (speed_step * (i + 1));
-        hardware_set_motor_speed(new_speed, g_auto_progress.cycle_data.current_direction_forward);
-        vTaskDelay(pdMS_TO_TICKS(100)); // 10 Hz update rate
-        
-        // Check for safety conditions
-        if (!automatic_mode_is_operation_safe()) {
-            ESP_LOGW(TAG, "Safety check failed during deceleration");
-            automatic_mode_handle_emergency("Safety failure during deceleration");
-            return ESP_ERR_INVALID_STATE;
-        }
-    }
-    
-    // Set final target speed
-    hardware_set_motor_speed(target_speed, g_auto_progress.cycle_data.current_direction_forward);
-    g_auto_progress.current_target_speed = target_speed;
+    // Ramp is stepped from automatic_mode_update()
+    start_ramp(target_speed, AUTO_MODE_DECEL_RATE_MS2);
+    g_auto_progress.acceleration_rate = -AUTO_MODE_DECEL_RATE_MS2;
     
-    ESP_LOGI(TAG, "Deceleration to %.1f m/s complete", target_speed);
     return ESP_OK;
 }
 
+bool automatic_mode_is_decelerating(void) {
+    return g_ramp_active && g_ramp_plan.peak_speed_ms < g_ramp_plan.start_speed_ms;
+}
+
 esp_err_t automatic_mode_maintain_cruise_speed(void) {
-    float current_speed = hardware_get_current_speed();
-    float target_speed = AUTO_MODE_MAX_SPEED_MS;
+    float target_speed = cruise_speed_limit();
     
-    // Simple speed maintenance with tolerance
-    if (fabs(current_speed - target_speed) > 0.5f) {
-        ESP_LOGD(TAG, "Adjusting cruise speed: %.1f → %.1f m/s", current_speed, target_speed);
-        hardware_set_motor_speed(target_speed, g_auto_progress.cycle_data.current_direction_forward);
+    // Hardware speed controller holds the target, only re-issue a changed command
+    if (fabs(hardware_get_status().target_speed_ms - target_speed) > 0.01f) {
+        deferred_log(DLOG_MSG_AUTO_CRUISE_TARGET, target_speed);
+        hardware_set_speed_closed_loop(target_speed, g_auto_progress.cycle_data.current_direction_forward);
     }
     
     g_auto_progress.current_target_speed = target_speed;
@@ -291,7 +801,7 @@ float automatic_mode_get_current_target_speed(void) {
 }
 
 bool automatic_mode_is_at_target_speed(float tolerance) {
-    float current_speed = hardware_get_current_speed();
+    float current_speed = state_estimator_get_speed();
     return fabs(current_speed - g_current_acceleration_target) <= tolerance;
 }
 
@@ -300,60 +810,199 @@ bool automatic_mode_is_at_target_speed(float tolerance) {
 // ═══════════════════════════════════════════════════════════════════════════════
 
 bool automatic_mode_is_at_wire_end(void) {
-    // Check multiple detection methods
-    sensor_health_t sensor_status = sensor_health_get_status();
-    
-    // Impact detection
-    if (sensor_status.total_accel_g > AUTO_MODE_MAX_IMPACT_G) {
-        ESP_LOGI(TAG, "Wire end detected by impact: %.2f g", sensor_status.total_accel_g);
-        return true;
-    }
-    
-    // Hall sensor timeout
-    if (hardware_get_time_since_last_hall_pulse() > 2000000ULL) { // 2 seconds
-        ESP_LOGI(TAG, "Wire end detected by Hall timeout");
-        return true;
+    // Impact, Hall timing and command tracking are fused by the shared detector
+    wire_end_event_t event;
+    if (!wire_end_detector_poll(&event)) {
+        uint64_t now = hal_clock_now_us();
+        float speed = state_estimator_get_speed();
+        if (speed >= g_arrival_speed_ms || (now - g_arrival_speed_time) > AUTO_MODE_ARRIVAL_HOLD_MS * 1000ULL) {
+            g_arrival_speed_ms = speed;
+            g_arrival_speed_time = now;
+        }
+        return false;
     }
     
-    // Speed drop detection
-    float current_speed = hardware_get_current_speed();
-    if (g_auto_progress.current_target_speed > 0.5f && current_speed < 0.2f) {
-        ESP_LOGI(TAG, "Wire end detected by speed drop: %.1f m/s", current_speed);
-        return true;
+    // Every arrival is an impact (hard stops clip the IMU even at a crawl): an
+    // incident is an arrival faster than a seek, so the envelope is the speed
+    if (g_arrival_speed_ms > AUTO_MODE_IMPACT_SPEED_MS) {
+        flight_recorder_trigger(FLIGHT_TRIGGER_IMPACT);
     }
-    
-    return false;
+    g_arrival_speed_ms = 0.0f;
+    deferred_log(DLOG_MSG_AUTO_WIRE_END, wire_end_detector_source_to_string(event.sources),
+                 event.confidence, event.peak_impact_g);
+    return true;
+}
+
+/**
+ * @brief Stop at the wire end; handle_wire_end_approach_state() turns around
+ */
+static void settle_at_wire_end(uint64_t now) {
+    hardware_set_speed_closed_loop(0.0f, g_auto_progress.cycle_data.current_direction_forward);
+    g_auto_progress.current_target_speed = 0.0f;
+    g_seek_active = false;
+    wire_end_detector_disarm();
+    
+    g_auto_progress.state = AUTO_MODE_WIRE_END_APPROACH;
+    g_auto_progress.state_start_time = now;
+    g_auto_progress.status_text = STATUS_TEXT_AUTO_FINAL_APPROACH;
+    g_approach_deadline = now + AUTO_MODE_APPROACH_TIME_MS * 1000ULL;
+}
+
+/**
+ * @brief Drive to the wire end at approach speed
+ *
+ * Used from an unknown position (mode start) and after a coast that stopped
+ * short. The detector stays armed; pushed against the end, the trolley shows
+ * no Hall edge and counts as there before the Hall timeout would trip.
+ */
+static void start_wire_end_seek(uint64_t now) {
+    bool forward = g_auto_progress.cycle_data.current_direction_forward;
+    
+    g_ramp_active = false;
+    g_run_active = false;
+    send_map_bias(0.0f);
+    wire_end_detector_arm(forward);
+    hardware_set_speed_closed_loop(AUTO_MODE_WIRE_END_APPROACH_MS, forward);
+    g_auto_progress.current_target_speed = AUTO_MODE_WIRE_END_APPROACH_MS;
+    
+    g_seek_active = true;
+    g_seek_start_time = now;
+    g_seek_rotations = hardware_get_rotation_count();
+    g_seek_edge_time = now;
+    g_next_safety_check_time = now;
+    float seek_s = g_auto_progress.wire_length_m / AUTO_MODE_WIRE_END_APPROACH_MS + AUTO_MODE_SEEK_MARGIN_S;
+    g_approach_deadline = now + (uint64_t)(seek_s * 1000000.0f);
+    
+    g_auto_progress.state = AUTO_MODE_WIRE_END_APPROACH;
+    g_auto_progress.state_start_time = now;
+    g_auto_progress.status_text = STATUS_TEXT_AUTO_SEEKING_WIRE_END;
+    deferred_log(DLOG_MSG_AUTO_SEEKING, AUTO_MODE_WIRE_END_APPROACH_MS);
+}
+
+/**
+ * @brief The wire end came before the planned coast-out (motor still on)
+ */
+static void end_run_at_wire_end(uint64_t now) {
+    g_run_active = false;
+    g_coasting_in_progress = false;
+    coast_fit_abort(&g_coast_fit);
+    send_map_bias(0.0f);
+    
+    // A calibration run cut short measures nothing: the next run calibrates again
+    g_calibration_run = false;
+    settle_at_wire_end(now);
 }
 
 // ═══════════════════════════════════════════════════════════════════════════════
 // MAIN STATE MACHINE IMPLEMENTATION
 // ═══════════════════════════════════════════════════════════════════════════════
 
-static esp_err_t handle_coasting_state(void) {
-    float current_speed = hardware_get_current_speed();
+static esp_err_t handle_coasting_state(uint64_t now) {
+    float current_speed = state_estimator_get_speed();
     
-    // Check if wire end reached
-    if (automatic_mode_is_at_wire_end() || current_speed < COAST_DETECTION_SPEED_MS) {
-        ESP_LOGI(TAG, "Wire end reached via coasting - speed: %.2f m/s", current_speed);
+    // Check if wire end reached (that tick carries the impact, not the coast)
+    bool at_wire_end = automatic_mode_is_at_wire_end();
+    if (!at_wire_end) {
+        coast_fit_sample(&g_coast_fit, current_speed, now);
+    }
+    if (at_wire_end || current_speed < COAST_DETECTION_SPEED_MS) {
+        deferred_log(DLOG_MSG_AUTO_COAST_WIRE_END, current_speed);
         
         g_coasting_in_progress = false;
-        g_auto_progress.state = AUTO_MODE_WIRE_END_APPROACH;
-        
-        // Final approach at low speed
-        hardware_set_motor_speed(AUTO_MODE_WIRE_END_APPROACH_MS, 
-                                g_auto_progress.cycle_data.current_direction_forward);
-        strcpy(g_auto_progress.status_message, "Final approach to wire end");
-        
-        // Brief approach time
-        vTaskDelay(pdMS_TO_TICKS(500));
+        g_run_active = false;
+        if (!g_calibration_run) {
+            finish_coast_fit();
+        } else if (!at_wire_end) {
+            automatic_mode_update_coasting_calibration(current_speed, g_auto_progress.current_position_m);
+        } else {
+            // Cut short by the wire end: the next run calibrates again
+            coast_fit_abort(&g_coast_fit);
+        }
+        g_calibration_run = false;
         
-        // Handle wire end reached
-        automatic_mode_handle_wire_end_reached();
+        // Stopped short: final approach at low speed until the detector sees the end
+        if (at_wire_end) {
+            settle_at_wire_end(now);
+        } else {
+            start_wire_end_seek(now);
+        }
+    }
+    
+    return ESP_OK;
+}
+
+static esp_err_t handle_arming_state(void) {
+    esc_arm_state_t arm_state = hardware_esc_get_arm_state();
+    if (arm_state == ESC_ARM_DISARMED) {
+        // Sequence cancelled (disarm or emergency stop elsewhere)
+        g_auto_progress.error_text = STATUS_TEXT_ARM_CANCELLED;
+        g_auto_progress.state = AUTO_MODE_ERROR;
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (arm_state != ESC_ARM_ARMED) {
+        return ESP_OK;
     }
     
+    g_auto_progress.esc_auto_armed = true;
+    deferred_log(DLOG_MSG_AUTO_ESC_ARMED);
+    
+    // Position unknown: the first planned run starts from a wire end
+    start_wire_end_seek(hal_clock_now_us());
     return ESP_OK;
 }
 
+static esp_err_t handle_wire_end_approach_state(uint64_t now) {
+    if (g_seek_active) {
+        if (!planned_motion_safe(now)) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        if (automatic_mode_is_at_wire_end()) {
+            settle_at_wire_end(now);
+            return ESP_OK;
+        }
+        uint32_t rotations = hardware_get_rotation_count();
+        if (rotations != g_seek_rotations) {
+            g_seek_rotations = rotations;
+            g_seek_edge_time = now;
+        } else if ((now - g_seek_edge_time) >= AUTO_MODE_SEEK_STALL_MS * 1000ULL) {
+            deferred_log(DLOG_MSG_AUTO_SEEK_STALLED);
+            settle_at_wire_end(now);
+            return ESP_OK;
+        }
+        if (now >= g_approach_deadline) {
+            deferred_log(DLOG_MSG_AUTO_SEEK_TIMEOUT, (now - g_seek_start_time) / 1000000.0f);
+            automatic_mode_handle_emergency(STATUS_TEXT_AUTO_WIRE_END_NOT_FOUND);
+            return ESP_ERR_TIMEOUT;
+        }
+        return ESP_OK;
+    }
+    
+    if (g_approach_deadline == 0 || now < g_approach_deadline) {
+        return ESP_OK;
+    }
+    
+    g_approach_deadline = 0;
+    
+    // Handle wire end reached
+    return automatic_mode_handle_wire_end_reached();
+}
+
+static esp_err_t handle_direction_change_state(uint64_t now) {
+    if (g_direction_change_deadline == 0 || now < g_direction_change_deadline) {
+        return ESP_OK;
+    }
+    
+    g_direction_change_deadline = 0;
+    
+    esp_err_t result = g_auto_progress.coasting.calibrated ? start_planned_run()
+                                                           : automatic_mode_start_coasting_calibration();
+    if (result != ESP_OK) {
+        g_auto_progress.state = AUTO_MODE_ERROR;
+        automatic_mode_auto_disarm_esc();
+    }
+    return result;
+}
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // PUBLIC API IMPLEMENTATION (Core Functions Only)
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -366,8 +1015,8 @@ esp_err_t automatic_mode_init(void) {
     memset(&g_auto_results, 0, sizeof(g_auto_results));
     
     g_auto_progress.state = AUTO_MODE_IDLE;
-    strcpy(g_auto_progress.status_message, "Automatic mode ready");
-    strcpy(g_auto_progress.error_message, "");
+    g_auto_progress.status_text = STATUS_TEXT_AUTO_READY;
+    g_auto_progress.error_text = STATUS_TEXT_NONE;
     
     g_auto_initialized = true;
     
@@ -392,26 +1041,54 @@ esp_err_t automatic_mode_start(void) {
     const wire_learning_results_t* wire_data = mode_coordinator_get_wire_learning_results();
     if (wire_data == NULL || !wire_data->complete) {
         ESP_LOGE(TAG, "Wire learning data not available");
-        strcpy(g_auto_progress.error_message, "Wire learning required before automatic mode");
+        g_auto_progress.error_text = STATUS_TEXT_AUTO_LEARNING_REQUIRED;
         return ESP_ERR_INVALID_STATE;
     }
     
     // Initialize automatic mode state
     g_auto_progress.state = AUTO_MODE_INITIALIZING;
-    g_auto_progress.mode_start_time = esp_timer_get_time();
+    g_auto_progress.mode_start_time = hal_clock_now_us();
     g_auto_progress.wire_length_m = wire_data->wire_length_m;
     g_auto_progress.user_interrupted = false;
     g_auto_progress.finishing_current_run = false;
     g_user_interruption_requested = false;
+    g_ramp_active = false;
+    g_run_active = false;
+    g_approach_deadline = 0;
+    g_seek_active = false;
+    g_direction_change_deadline = 0;
+    g_run_from_wire_end = false;
+    g_auto_progress.cycle_data.run_start_rotations = hardware_get_rotation_count();
+    
+    // Position on the wire unknown until the first wire end
+    g_map_anchored = false;
+    g_auto_progress.map_anchored = false;
+    reset_map_zones();
+    
+    // Warm start: reuse stored coasting calibration instead of measuring again
+    const coasting_data_t* stored_coasting = mode_coordinator_get_coasting_data();
+    if (!g_auto_progress.coasting.calibrated && stored_coasting != NULL) {
+        g_auto_progress.coasting.calibrated = true;
+        g_auto_progress.coasting.calibration_speed_ms = AUTO_COASTING_CALIBRATION_SPEED;
+        g_auto_progress.coasting.coasting_distance_m = stored_coasting->coasting_distance_m;
+        g_auto_progress.coasting.coasting_time_ms = stored_coasting->coast_time_ms;
+        g_auto_progress.coasting.deceleration_rate_ms2 = stored_coasting->decel_rate_ms2;
+        g_auto_progress.coasting.coast_start_distance_m = stored_coasting->coast_start_distance_m;
+        g_auto_progress.coasting.calibration_successful = true;
+        g_auto_progress.coasting.model_forward = stored_coasting->model_forward;
+        g_auto_progress.coasting.model_reverse = stored_coasting->model_reverse;
+        ESP_LOGI(TAG, "Using stored coasting calibration: %.2f m", stored_coasting->coasting_distance_m);
+    }
     
     // Auto-arm ESC
     g_auto_progress.state = AUTO_MODE_ARMING_ESC;
-    strcpy(g_auto_progress.status_message, "Auto-arming ESC...");
+    g_auto_progress.status_text = STATUS_TEXT_AUTO_ARMING;
     
     result = automatic_mode_auto_arm_esc();
     if (result != ESP_OK) {
-        strcpy(g_auto_progress.error_message, "Failed to auto-arm ESC");
+        g_auto_progress.error_text = STATUS_TEXT_AUTO_ARM_FAILED;
         g_auto_progress.state = AUTO_MODE_ERROR;
+        flight_recorder_trigger(FLIGHT_TRIGGER_MODE_ERROR);
         return result;
     }
     
@@ -420,22 +1097,29 @@ esp_err_t automatic_mode_start(void) {
 }
 
 esp_err_t automatic_mode_stop_graceful(void) {
-    ESP_LOGI(TAG, "Graceful stop requested - will finish current run");
+    deferred_log(DLOG_MSG_AUTO_STOP_GRACEFUL);
     
     g_user_interruption_requested = true;
-    g_interruption_request_time = esp_timer_get_time();
+    g_interruption_request_time = hal_clock_now_us();
     g_auto_progress.finishing_current_run = true;
     
-    strcpy(g_auto_progress.status_message, "Stopping gracefully - finishing current run");
+    g_auto_progress.status_text = STATUS_TEXT_AUTO_STOPPING_GRACEFULLY;
     
     return ESP_OK;
 }
 
 esp_err_t automatic_mode_interrupt(void) {
-    ESP_LOGI(TAG, "Immediate interruption requested");
+    deferred_log(DLOG_MSG_AUTO_INTERRUPTED);
     
     // Stop motor immediately
     hardware_emergency_stop();
+    g_ramp_active = false;
+    g_run_active = false;
+    coast_fit_abort(&g_coast_fit);
+    wire_end_detector_disarm();
+    g_approach_deadline = 0;
+    g_seek_active = false;
+    g_direction_change_deadline = 0;
     
     // Update state
     g_auto_progress.state = AUTO_MODE_STOPPING_INTERRUPTED;
@@ -443,7 +1127,7 @@ esp_err_t automatic_mode_interrupt(void) {
     g_auto_progress.finishing_current_run = false;
     g_user_interruption_requested = true;
     
-    strcpy(g_auto_progress.status_message, "Interrupted by user - stopping immediately");
+    g_auto_progress.status_text = STATUS_TEXT_AUTO_INTERRUPTED;
     
     // Auto-disarm ESC
     automatic_mode_auto_disarm_esc();
@@ -456,19 +1140,42 @@ esp_err_t automatic_mode_update(void) {
         return ESP_OK;
     }
     
+    // Every step below returns immediately; waits are deadline checks
+    uint64_t now = hal_clock_now_us();
+    if (g_ramp_active) {
+        step_ramp(now);
+    }
+    if (g_run_active) {
+        step_run(now);
+    }
+    
     // Main state machine (simplified)
     switch (g_auto_progress.state) {
-        case AUTO_MODE_COASTING:
-            handle_coasting_state();
+        case AUTO_MODE_ARMING_ESC:
+            handle_arming_state();
             break;
             
+        case AUTO_MODE_ACCELERATING:
+        case AUTO_MODE_CRUISING:
         case AUTO_MODE_COASTING_CALIBRATION:
-            {
-                float current_speed = hardware_get_current_speed();
-                automatic_mode_update_coasting_calibration(current_speed, g_auto_progress.current_position_m);
+            // Stepped by step_run() / step_ramp() above; the end can come before the coast
+            if (g_run_active && automatic_mode_is_at_wire_end()) {
+                end_run_at_wire_end(now);
             }
             break;
             
+        case AUTO_MODE_COASTING:
+            handle_coasting_state(now);
+            break;
+            
+        case AUTO_MODE_WIRE_END_APPROACH:
+            handle_wire_end_approach_state(now);
+            break;
+            
+        case AUTO_MODE_DIRECTION_CHANGE:
+            handle_direction_change_state(now);
+            break;
+            
         default:
             // Other states handled elsewhere
             break;
@@ -482,6 +1189,10 @@ bool automatic_mode_is_active(void) {
            g_auto_progress.state < AUTO_MODE_COMPLETE;
 }
 
+automatic_mode_state_t automatic_mode_get_state(void) {
+    return g_auto_progress.state;
+}
+
 automatic_mode_progress_t automatic_mode_get_progress(void) {
     return g_auto_progress;
 }
@@ -527,17 +1238,25 @@ bool automatic_mode_is_operation_safe(void) {
     return true;
 }
 
-esp_err_t automatic_mode_handle_emergency(const char* error_message) {
-    ESP_LOGE(TAG, "EMERGENCY: %s", error_message);
+esp_err_t automatic_mode_handle_emergency(status_text_t error) {
+    deferred_log(DLOG_MSG_AUTO_EMERGENCY, status_text_to_string(error));
     
     // Stop motor immediately
     hardware_emergency_stop();
+    flight_recorder_trigger(FLIGHT_TRIGGER_EMERGENCY);
+    g_ramp_active = false;
+    g_run_active = false;
+    coast_fit_abort(&g_coast_fit);
+    wire_end_detector_disarm();
+    g_approach_deadline = 0;
+    g_seek_active = false;
+    g_direction_change_deadline = 0;
     
     // Update state
     g_auto_progress.state = AUTO_MODE_ERROR;
-    strncpy(g_auto_progress.error_message, error_message, sizeof(g_auto_progress.error_message) - 1);
+    g_auto_progress.error_text = error;
     
-    strcpy(g_auto_progress.status_message, "EMERGENCY STOP - Automatic mode halted");
+    g_auto_progress.status_text = STATUS_TEXT_AUTO_EMERGENCY;
     
     return ESP_OK;
 }
@@ -551,11 +1270,9 @@ esp_err_t automatic_mode_auto_arm_esc(void) {
     
     ESP_LOGI(TAG, "Auto-arming ESC for automatic mode");
     
+    // Non-blocking: handle_arming_state() continues once the ESC is armed
     esp_err_t result = hardware_esc_arm();
-    if (result == ESP_OK) {
-        g_auto_progress.esc_auto_armed = true;
-        ESP_LOGI(TAG, "ESC auto-armed successfully");
-    } else {
+    if (result != ESP_OK) {
         ESP_LOGE(TAG, "Failed to auto-arm ESC");
     }
     
@@ -563,7 +1280,7 @@ esp_err_t automatic_mode_auto_arm_esc(void) {
 }
 
 esp_err_t automatic_mode_auto_disarm_esc(void) {
-    ESP_LOGI(TAG, "Auto-disarming ESC");
+    deferred_log(DLOG_MSG_AUTO_DISARMING);
     
     esp_err_t result = hardware_esc_disarm();
     g_auto_progress.esc_auto_armed = false;
@@ -571,11 +1288,90 @@ esp_err_t automatic_mode_auto_disarm_esc(void) {
     return result;
 }
 
+/**
+ * @brief Count a full end-to-end run; a cycle is one run in each direction
+ * @return true if the run completed a cycle
+ */
+static bool count_completed_run(bool forward, float run_length_m, uint64_t now) {
+    cycle_data_t* cycle = &g_auto_progress.cycle_data;
+    if (forward) {
+        cycle->forward_runs++;
+    } else {
+        cycle->reverse_runs++;
+    }
+    g_auto_results.total_runs_completed++;
+    g_auto_results.total_distance_traveled_m += run_length_m;
+    cycle->total_distance_m = (uint32_t)g_auto_results.total_distance_traveled_m;
+    deferred_log(DLOG_MSG_AUTO_RUN_COMPLETE, forward ? "Forward" : "Reverse",
+                 (unsigned long)g_auto_results.total_runs_completed, run_length_m);
+    
+    uint32_t pairs = (cycle->forward_runs < cycle->reverse_runs) ? cycle->forward_runs : cycle->reverse_runs;
+    if (pairs <= g_auto_results.total_cycles_completed) {
+        return false;
+    }
+    
+    g_auto_results.total_cycles_completed++;
+    float cycle_time_ms = (now - cycle->cycle_start_time) / 1000.0f;
+    g_auto_results.average_cycle_time_ms +=
+        (cycle_time_ms - g_auto_results.average_cycle_time_ms) / g_auto_results.total_cycles_completed;
+    deferred_log(DLOG_MSG_AUTO_CYCLE_COMPLETE, (unsigned long)g_auto_results.total_cycles_completed,
+                 cycle_time_ms / 1000.0f);
+    
+    cycle->cycle_number = g_auto_results.total_cycles_completed;
+    cycle->cycle_start_time = now;
+    mode_coordinator_update_cycle_count(g_auto_results.total_cycles_completed);
+    return true;
+}
+
 esp_err_t automatic_mode_handle_wire_end_reached(void) {
-    ESP_LOGI(TAG, "Wire end reached - completing current run");
+    deferred_log(DLOG_MSG_AUTO_WIRE_END_REACHED);
     
     // Stop motor immediately
-    hardware_set_motor_speed(0.0f, g_auto_progress.cycle_data.current_direction_forward);
+    bool forward = g_auto_progress.cycle_data.current_direction_forward;
+    hardware_set_speed_closed_loop(0.0f, forward);
+    
+    uint64_t now = hal_clock_now_us();
+    uint32_t now_rotations = hardware_get_rotation_count();
+    bool cycle_complete = false;
+    if (g_run_from_wire_end) {
+        // The first full end-to-end run checks a stored profile against the wire
+        float run_length_m = hardware_rotations_to_distance(
+            now_rotations - g_auto_progress.cycle_data.run_start_rotations);
+        if (mode_coordinator_verify_calibration(run_length_m) != ESP_OK) {
+            g_auto_progress.error_text = STATUS_TEXT_AUTO_CALIBRATION_MISMATCH;
+            g_auto_progress.state = AUTO_MODE_ERROR;
+            automatic_mode_auto_disarm_esc();
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        cycle_complete = count_completed_run(forward, run_length_m, now);
+    } else {
+        // Reached from an unknown position: cycles are timed from here
+        g_auto_progress.cycle_data.cycle_start_time = now;
+    }
+    g_run_from_wire_end = true;
+    g_auto_progress.cycle_data.run_start_rotations = now_rotations;
+    anchor_wire_map(forward);
+    g_auto_results.total_operating_time_ms = (uint32_t)((now - g_auto_progress.mode_start_time) / 1000);
+    
+    // Graceful stop finishes here, at a wire end
+    if (g_auto_progress.finishing_current_run ||
+        g_auto_results.total_cycles_completed >= AUTO_MODE_MAX_CYCLES) {
+        deferred_log(DLOG_MSG_AUTO_FINISHED, (unsigned long)g_auto_results.total_cycles_completed);
+        g_auto_results.interrupted_by_user = g_auto_progress.finishing_current_run;
+        g_auto_results.completion_text = STATUS_TEXT_AUTO_COMPLETE;
+        g_auto_progress.state = AUTO_MODE_COMPLETE;
+        g_auto_progress.status_text = STATUS_TEXT_AUTO_COMPLETE;
+        automatic_mode_auto_disarm_esc();
+        return ESP_OK;
+    }
+    
+    // Turn around; handle_direction_change_state() plans the next run
+    g_auto_progress.cycle_data.current_direction_forward = !forward;
+    uint32_t pause_ms = cycle_complete ? AUTO_MODE_CYCLE_PAUSE_MS : AUTO_MODE_DIRECTION_PAUSE_MS;
+    g_direction_change_deadline = now + pause_ms * 1000ULL;
+    g_auto_progress.state = AUTO_MODE_DIRECTION_CHANGE;
+    g_auto_progress.state_start_time = now;
+    g_auto_progress.status_text = STATUS_TEXT_AUTO_DIRECTION_CHANGE;
     
     return ESP_OK;
 }
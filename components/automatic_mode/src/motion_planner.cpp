@@ -0,0 +1,237 @@
+// components/automatic_mode/src/motion_planner.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// MOTION_PLANNER.CPP - S-CURVE SPEED CHANGES, CRUISE AND COAST-OUT
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "motion_planner.h"
+#include <cmath>
+#include <cstring>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SEGMENT MATH
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static bool limits_valid(const motion_limits_t* limits, bool need_coast) {
+    if (limits == NULL) return false;
+    if (!(limits->max_speed_ms > 0.0f) || !(limits->max_accel_ms2 > 0.0f) ||
+        !(limits->max_jerk_ms3 > 0.0f)) {
+        return false;
+    }
+    return !need_coast || (limits->coast.valid && limits->coast.base_decel_ms2 > 0.0f);
+}
+
+/**
+ * @brief Fill the S-curve speed change v0 → v1 of a plan
+ *
+ * Jerk ramps of jerk_time_s around an optional constant-acceleration
+ * segment. The profile is point-symmetric, so its distance is the mean
+ * speed times its duration.
+ */
+static void plan_speed_change(motion_plan_t* plan, float v0, float v1) {
+    const motion_limits_t* limits = &plan->limits;
+    float dv = fabsf(v1 - v0);
+
+    plan->start_speed_ms = v0;
+    plan->peak_speed_ms = v1;
+    if (dv < MOTION_PLANNER_SPEED_TOLERANCE_MS) {
+        plan->peak_speed_ms = v0;
+        plan->jerk_time_s = 0.0f;
+        plan->const_accel_time_s = 0.0f;
+        plan->change_peak_accel_ms2 = 0.0f;
+        plan->change_time_s = 0.0f;
+        plan->change_distance_m = 0.0f;
+        return;
+    }
+
+    float peak_accel;
+    if (dv * limits->max_jerk_ms3 >= limits->max_accel_ms2 * limits->max_accel_ms2) {
+        peak_accel = limits->max_accel_ms2;
+        plan->jerk_time_s = peak_accel / limits->max_jerk_ms3;
+        plan->const_accel_time_s = dv / peak_accel - plan->jerk_time_s;
+    } else {
+        // Too small a change to reach the acceleration limit
+        plan->jerk_time_s = sqrtf(dv / limits->max_jerk_ms3);
+        plan->const_accel_time_s = 0.0f;
+        peak_accel = limits->max_jerk_ms3 * plan->jerk_time_s;
+    }
+
+    plan->change_peak_accel_ms2 = (v1 >= v0) ? peak_accel : -peak_accel;
+    plan->change_time_s = 2.0f * plan->jerk_time_s + plan->const_accel_time_s;
+    plan->change_distance_m = 0.5f * (v0 + v1) * plan->change_time_s;
+}
+
+static void sample_speed_change(const motion_plan_t* plan, float t, motion_sample_t* sample) {
+    float v0 = plan->start_speed_ms;
+    float v1 = plan->peak_speed_ms;
+    float tj = plan->jerk_time_s;
+    float ta = plan->const_accel_time_s;
+    float ap = plan->change_peak_accel_ms2;
+    float j = (tj > 0.0f) ? ap / tj : 0.0f;    // Signed jerk
+
+    if (t < tj) {
+        sample->accel_ms2 = j * t;
+        sample->speed_ms = v0 + 0.5f * j * t * t;
+        sample->position_m = v0 * t + j * t * t * t / 6.0f;
+    } else if (t < tj + ta) {
+        float dt = t - tj;
+        float v_a = v0 + 0.5f * j * tj * tj;
+        float x_a = v0 * tj + j * tj * tj * tj / 6.0f;
+        sample->accel_ms2 = ap;
+        sample->speed_ms = v_a + ap * dt;
+        sample->position_m = x_a + v_a * dt + 0.5f * ap * dt * dt;
+    } else {
+        // Mirror of the first jerk ramp, measured back from the end
+        float r = plan->change_time_s - t;
+        sample->accel_ms2 = j * r;
+        sample->speed_ms = v1 - 0.5f * j * r * r;
+        sample->position_m = plan->change_distance_m - (v1 * r - j * r * r * r / 6.0f);
+    }
+}
+
+// Coast: motor cut-off to rest, as predicted by the direction's coast model
+static float coast_time(const motion_limits_t* limits, float speed_ms) {
+    return coast_model_stop_time(&limits->coast, speed_ms);
+}
+
+float motion_planner_coast_distance(const motion_limits_t* limits, float speed_ms) {
+    if (limits == NULL) return 0.0f;
+    return coast_model_stop_distance(&limits->coast, speed_ms);
+}
+
+static void sample_coast(const motion_plan_t* plan, float t, motion_sample_t* sample) {
+    coast_model_sample(&plan->limits.coast, plan->peak_speed_ms, t, &sample->position_m, &sample->speed_ms);
+    sample->accel_ms2 = -coast_model_decel(&plan->limits.coast, sample->speed_ms);
+}
+
+// Distance used by a run peaking at peak_speed_ms, without cruise
+static float run_distance(motion_plan_t* plan, float start_speed_ms, float peak_speed_ms) {
+    plan_speed_change(plan, start_speed_ms, peak_speed_ms);
+    return plan->change_distance_m + motion_planner_coast_distance(&plan->limits, peak_speed_ms);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PLANNING API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t motion_planner_plan_run(const motion_limits_t* limits, float distance_m,
+                                  float start_speed_ms, motion_plan_t* plan) {
+    if (plan == NULL || !limits_valid(limits, true)) return ESP_ERR_INVALID_ARG;
+
+    memset(plan, 0, sizeof(*plan));
+    plan->limits = *limits;
+    plan->coast_to_stop = true;
+
+    float v0 = fmaxf(start_speed_ms, 0.0f);
+    float rollout_m = fmaxf(distance_m - limits->end_margin_m, 0.0f);
+    plan->distance_m = rollout_m;
+
+    // Highest peak that still rolls out in time: run distance grows with the peak
+    float low = fminf(v0, limits->max_speed_ms);
+    float high = limits->max_speed_ms;
+    float peak;
+    if (run_distance(plan, v0, high) <= rollout_m) {
+        peak = high;
+    } else if (run_distance(plan, v0, low) > rollout_m) {
+        // Too close or too fast: cut the motor now, the coast itself overshoots
+        plan->overrun = true;
+        peak = v0;
+    } else {
+        for (int i = 0; i < MOTION_PLANNER_SEARCH_ITERATIONS; i++) {
+            float mid = 0.5f * (low + high);
+            if (run_distance(plan, v0, mid) <= rollout_m) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        peak = low;
+    }
+
+    plan_speed_change(plan, v0, peak);
+    plan->coast_distance_m = motion_planner_coast_distance(limits, plan->peak_speed_ms);
+    plan->coast_time_s = coast_time(limits, plan->peak_speed_ms);
+
+    float cruise_m = rollout_m - plan->change_distance_m - plan->coast_distance_m;
+    if (!plan->overrun && cruise_m > 0.0f && plan->peak_speed_ms > MOTION_PLANNER_SPEED_TOLERANCE_MS) {
+        plan->cruise_distance_m = cruise_m;
+        plan->cruise_time_s = cruise_m / plan->peak_speed_ms;
+    }
+
+    plan->total_time_s = plan->change_time_s + plan->cruise_time_s + plan->coast_time_s;
+    plan->valid = true;
+    return ESP_OK;
+}
+
+esp_err_t motion_planner_plan_ramp(const motion_limits_t* limits, float start_speed_ms,
+                                   float target_speed_ms, motion_plan_t* plan) {
+    if (plan == NULL || !limits_valid(limits, false)) return ESP_ERR_INVALID_ARG;
+
+    memset(plan, 0, sizeof(*plan));
+    plan->limits = *limits;
+    plan->coast_to_stop = false;
+
+    float target = fminf(fmaxf(target_speed_ms, 0.0f), limits->max_speed_ms);
+    plan_speed_change(plan, fmaxf(start_speed_ms, 0.0f), target);
+    plan->total_time_s = plan->change_time_s;
+    plan->valid = true;
+    return ESP_OK;
+}
+
+void motion_planner_sample(const motion_plan_t* plan, float time_s, motion_sample_t* sample) {
+    if (sample == NULL) return;
+    memset(sample, 0, sizeof(*sample));
+    if (plan == NULL || !plan->valid) {
+        sample->phase = MOTION_PHASE_DONE;
+        return;
+    }
+
+    float t = fmaxf(time_s, 0.0f);
+
+    if (t < plan->change_time_s) {
+        sample->phase = MOTION_PHASE_SPEED_CHANGE;
+        sample_speed_change(plan, t, sample);
+        return;
+    }
+    t -= plan->change_time_s;
+
+    if (t < plan->cruise_time_s) {
+        sample->phase = MOTION_PHASE_CRUISE;
+        sample->speed_ms = plan->peak_speed_ms;
+        sample->position_m = plan->change_distance_m + plan->peak_speed_ms * t;
+        return;
+    }
+    t -= plan->cruise_time_s;
+
+    if (!plan->coast_to_stop) {
+        // Ramp: hold the target speed indefinitely
+        sample->phase = MOTION_PHASE_DONE;
+        sample->speed_ms = plan->peak_speed_ms;
+        sample->position_m = plan->change_distance_m + plan->peak_speed_ms * t;
+        return;
+    }
+
+    float before_coast_m = plan->change_distance_m + plan->cruise_distance_m;
+    if (t < plan->coast_time_s) {
+        sample->phase = MOTION_PHASE_COAST;
+        sample_coast(plan, t, sample);
+        sample->position_m += before_coast_m;
+        return;
+    }
+
+    sample->phase = MOTION_PHASE_DONE;
+    sample->position_m = before_coast_m + plan->coast_distance_m;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// UTILITY API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+const char* motion_planner_phase_to_string(motion_phase_t phase) {
+    switch (phase) {
+        case MOTION_PHASE_SPEED_CHANGE: return "Speed Change";
+        case MOTION_PHASE_CRUISE:       return "Cruise";
+        case MOTION_PHASE_COAST:        return "Coast";
+        case MOTION_PHASE_DONE:         return "Done";
+        default:                        return "Unknown";
+    }
+}
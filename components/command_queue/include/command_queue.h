@@ -0,0 +1,208 @@
+// components/command_queue/include/command_queue.h
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include "esp_err.h"
+#include "manual_mode.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// COMMAND_QUEUE.H - OPERATOR COMMANDS INTO THE CONTROL LOOP
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Hand operator commands from any task to the control loop
+// - Producers (httpd, WebSocket, serial) submit a manual_command_t or a mode
+//   start/stop request and get a command ID back at once; nothing motor- or
+//   mode-related runs on their task
+// - Normal lane: bounded lock-free MPSC ring, drained in order every tick
+// - Emergency lane: one atomic slot checked before the ring; an emergency
+//   stop supersedes everything still queued behind it
+// - Consecutive speed adjustments (+/-) coalesce into one target, applied at
+//   most every COMMAND_QUEUE_SPEED_INTERVAL_MS so a burst lands inside
+//   manual_mode_check_command_rate_limit() instead of being rejected by it
+// - Outcomes are kept for the last COMMAND_QUEUE_RESULT_SLOTS IDs for
+//   polling (/api/command?id=N) and WebSocket push
+//
+// Only command_queue_drain() touches manual mode and starts or stops modes:
+// call it from the control loop task, before the mode updates.
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Called on the submitting task for every emergency stop request
+ */
+typedef void (*command_queue_emergency_hook_t)(void);
+
+// Queue configuration
+#define COMMAND_QUEUE_DEPTH             16          // Normal lane entries (power of 2)
+#define COMMAND_QUEUE_RESULT_SLOTS      16          // Outcomes kept for polling (power of 2)
+#define COMMAND_QUEUE_SPEED_INTERVAL_MS (1000 / MANUAL_MAX_COMMANDS_PER_SEC)  // Coalesced target spacing
+
+/**
+ * @brief Where a command is in its life
+ */
+typedef enum {
+    COMMAND_STATUS_UNKNOWN = 0,         // Never issued, or outcome already recycled
+    COMMAND_STATUS_QUEUED,              // Waiting for the control loop
+    COMMAND_STATUS_DONE,                // Executed, result holds the outcome
+    COMMAND_STATUS_COALESCED,           // Speed step merged into a later command's target
+    COMMAND_STATUS_SUPERSEDED           // Discarded by an emergency stop before running
+} command_status_t;
+
+/**
+ * @brief Mode start/stop requests, run in order with the manual commands
+ */
+typedef enum {
+    MODE_CMD_NONE = 0,                  // Not a mode command (manual command)
+    MODE_CMD_ACTIVATE_WIRE_LEARNING,    // mode_coordinator_activate_wire_learning()
+    MODE_CMD_ACTIVATE_AUTOMATIC,        // mode_coordinator_activate_automatic()
+    MODE_CMD_ACTIVATE_MANUAL,           // mode_coordinator_activate_manual()
+    MODE_CMD_STOP,                      // Graceful stop of the current mode
+    MODE_CMD_INTERRUPT,                 // Automatic: stop at the next wire end, others: immediate stop
+    MODE_CMD_RESET_SYSTEM,              // mode_coordinator_reset_system()
+    MODE_CMD_CLEAR_CALIBRATION,         // mode_coordinator_clear_calibration(), no mode active only
+    MODE_CMD_SELECT_SITE,               // mode_coordinator_select_site(), carries the site ID
+    MODE_CMD_EMERGENCY_STOP             // Routed to the emergency lane at submit
+} mode_command_type_t;
+
+/**
+ * @brief Outcome of one command
+ */
+typedef struct {
+    uint32_t id;                        // Command ID from submit
+    command_status_t status;
+    manual_command_type_t type;         // As submitted (SET_SPEED for a coalesced target, NONE for a mode command)
+    mode_command_type_t mode_command;   // MODE_CMD_NONE for manual commands
+    esp_err_t result;                   // Execution result (DONE only)
+    uint16_t merged;                    // Speed steps folded into this execution
+    float target_speed_ms;              // Manual target speed after execution
+    uint64_t submitted_us;              // manual_command_t timestamp
+    uint64_t completed_us;              // Control loop time of the outcome
+    uint32_t completion;                // Outcome sequence number (1, 2, ...)
+} command_result_t;
+
+/**
+ * @brief Queue counters since boot
+ */
+typedef struct {
+    uint32_t submitted;                 // Commands accepted onto either lane
+    uint32_t executed;                  // Commands run by the control loop
+    uint32_t coalesced;                 // Speed steps merged into a later target
+    uint32_t superseded;                // Commands dropped by an emergency stop
+    uint32_t rejected_full;             // Submissions refused because the ring was full
+    uint32_t emergency_stops;           // Emergency lane executions
+    uint32_t max_depth;                 // Most entries drained in one tick
+    uint32_t completions;               // Outcomes published (cursor for get_completed_since)
+} command_queue_stats_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRODUCER API (any task)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Initialize the queue (before the control loop and web commands start)
+ * @return ESP_OK on success
+ */
+esp_err_t command_queue_init(void);
+
+/**
+ * @brief Queue a manual command for the next control tick
+ * @param command Command from manual_mode_create_command()
+ * @param id Set to the command ID on success (may be NULL)
+ * @return ESP_OK if queued, ESP_ERR_NO_MEM if the ring is full,
+ *         ESP_ERR_INVALID_STATE before init, ESP_ERR_INVALID_ARG if command is NULL
+ * @note MANUAL_CMD_EMERGENCY_STOP is routed to the emergency lane
+ */
+esp_err_t command_queue_submit(const manual_command_t* command, uint32_t* id);
+
+/**
+ * @brief Queue a mode start/stop for the next control tick
+ * @param type Mode command (not MODE_CMD_NONE)
+ * @param source Command source for the log (may be NULL)
+ * @param id Set to the command ID on success (may be NULL)
+ * @return ESP_OK if queued, ESP_ERR_NO_MEM if the ring is full,
+ *         ESP_ERR_INVALID_STATE before init, ESP_ERR_INVALID_ARG for MODE_CMD_NONE
+ * @note Availability is checked when it runs: a refused start reports its error in the outcome
+ * @note MODE_CMD_EMERGENCY_STOP is routed to the emergency lane
+ */
+esp_err_t command_queue_submit_mode(mode_command_type_t type, const char* source, uint32_t* id);
+
+/**
+ * @brief Queue a site change (MODE_CMD_SELECT_SITE) for the next control tick
+ * @param site_id Site ID, copied into the queue
+ * @param source Command source for the log (may be NULL)
+ * @param id Set to the command ID on success (may be NULL)
+ * @return ESP_OK if queued, ESP_ERR_INVALID_ARG for an invalid site ID,
+ *         ESP_ERR_NO_MEM if the ring is full, ESP_ERR_INVALID_STATE before init
+ * @note Refused when it runs while a mode is active or another site is still loading
+ */
+esp_err_t command_queue_submit_site(const char* site_id, const char* source, uint32_t* id);
+
+/**
+ * @brief Request an emergency stop of all modes ahead of every queued command
+ * @param source Command source for the log (may be NULL)
+ * @param id Set to the command ID on success (may be NULL)
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE before init
+ * @note Never fails for lack of space: repeated requests merge into one
+ */
+esp_err_t command_queue_submit_emergency_stop(const char* source, uint32_t* id);
+
+/**
+ * @brief Set what else an emergency stop request cancels (e.g. a pending fleet start)
+ * @param hook Called from command_queue_submit_emergency_stop(), NULL for none
+ * @note Runs on the submitting task: must not block
+ */
+void command_queue_set_emergency_hook(command_queue_emergency_hook_t hook);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSUMER API (control loop task only)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Execute the emergency lane, then everything in the normal lane
+ */
+void command_queue_drain(void);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// OUTCOME API (any task)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Look up a command's outcome
+ * @param id Command ID from submit
+ * @param result Filled on success (status QUEUED while it waits)
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if never issued or recycled
+ */
+esp_err_t command_queue_get_result(uint32_t id, command_result_t* result);
+
+/**
+ * @brief Copy outcomes published after a completion number (for push)
+ * @param since Last completion already seen, advanced to the newest copied
+ * @param results Destination, oldest first
+ * @param max Capacity of results
+ * @return Number of outcomes copied
+ */
+size_t command_queue_get_completed_since(uint32_t* since, command_result_t* results, size_t max);
+
+/**
+ * @brief Get queue counters
+ * @return command_queue_stats_t structure
+ */
+command_queue_stats_t command_queue_get_stats(void);
+
+/**
+ * @brief Convert mode command to string
+ * @param type Mode command to convert
+ * @return Display name ("Start Automatic", ...)
+ */
+const char* command_queue_mode_command_to_string(mode_command_type_t type);
+
+/**
+ * @brief Convert command status to string
+ * @param status Status to convert
+ * @return Lower-case status name
+ */
+const char* command_queue_status_to_string(command_status_t status);
+
+#endif // COMMAND_QUEUE_H
@@ -0,0 +1,466 @@
+// components/command_queue/src/command_queue.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// COMMAND_QUEUE.CPP - MPSC RING, EMERGENCY LANE, SPEED COALESCING, OUTCOMES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "command_queue.h"
+#include "mode_coordinator.h"
+#include "calibration_store.h"
+#include "automatic_mode.h"
+#include "hal_clock.h"
+#include "status_snapshot.h"
+#include "esp_log.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+static const char* TAG = "COMMAND_QUEUE";
+
+static_assert((COMMAND_QUEUE_DEPTH & (COMMAND_QUEUE_DEPTH - 1)) == 0, "queue depth must be a power of 2");
+static_assert((COMMAND_QUEUE_RESULT_SLOTS & (COMMAND_QUEUE_RESULT_SLOTS - 1)) == 0,
+              "result slots must be a power of 2");
+
+#define COMMAND_QUEUE_MASK      (COMMAND_QUEUE_DEPTH - 1)
+#define COMMAND_RESULT_MASK     (COMMAND_QUEUE_RESULT_SLOTS - 1)
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// GLOBAL STATE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Bounded MPSC ring: a slot's sequence says whose turn it is
+// (== position: free for that producer, == position + 1: ready for the consumer)
+typedef struct {
+    std::atomic<uint32_t> sequence;
+    uint32_t id;
+    mode_command_type_t mode_command;   // MODE_CMD_NONE: command is a manual command
+    manual_command_t command;
+    char site_id[CALIBRATION_SITE_ID_MAX + 1];  // MODE_CMD_SELECT_SITE argument
+} queue_slot_t;
+
+static queue_slot_t g_slots[COMMAND_QUEUE_DEPTH];
+static std::atomic<uint32_t> g_enqueue_position{0};
+static uint32_t g_dequeue_position = 0;                 // Control loop only
+
+static std::atomic<uint32_t> g_next_id{1};
+static std::atomic<uint32_t> g_emergency_id{0};         // 0 = no emergency stop pending
+static std::atomic<bool> g_initialized{false};
+static std::atomic<command_queue_emergency_hook_t> g_emergency_hook{nullptr};
+
+// Outcomes: written by the control loop only, read from any task
+static status_snapshot<command_result_t> g_results[COMMAND_QUEUE_RESULT_SLOTS];
+static std::atomic<uint32_t> g_completions{0};
+
+// Speed steps waiting to become one target (control loop only)
+typedef struct {
+    uint32_t id;                        // Newest step; the coalesced target reports here
+    manual_command_type_t type;         // Newest step's type
+    int32_t steps;                      // Net +/- increments
+    uint16_t count;                     // Steps merged so far
+    uint64_t submitted_us;
+    char source[32];
+} pending_speed_t;
+
+static pending_speed_t g_pending_speed = {};
+static uint64_t g_last_speed_apply_us = 0;
+
+// Producer counters are shared, consumer counters have one writer
+static std::atomic<uint32_t> g_submitted{0};
+static std::atomic<uint32_t> g_rejected_full{0};
+static command_queue_stats_t g_stats = {};
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// RING
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static bool ring_push(mode_command_type_t mode_command, const manual_command_t* command, const char* site_id,
+                      uint32_t* id) {
+    uint32_t position = g_enqueue_position.load(std::memory_order_relaxed);
+    queue_slot_t* slot;
+
+    while (true) {
+        slot = &g_slots[position & COMMAND_QUEUE_MASK];
+        uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int32_t diff = (int32_t)(sequence - position);
+        if (diff == 0) {
+            if (g_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;               // Consumer has not freed this slot yet: full
+        } else {
+            position = g_enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Slot reserved: IDs are issued only to commands that made it in
+    slot->id = g_next_id.fetch_add(1, std::memory_order_relaxed);
+    slot->mode_command = mode_command;
+    memcpy(&slot->command, command, sizeof(manual_command_t));
+    snprintf(slot->site_id, sizeof(slot->site_id), "%s", site_id ? site_id : "");
+    *id = slot->id;
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+static bool ring_pop(uint32_t* id, mode_command_type_t* mode_command, manual_command_t* command, char* site_id) {
+    queue_slot_t* slot = &g_slots[g_dequeue_position & COMMAND_QUEUE_MASK];
+    uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+    if ((int32_t)(sequence - (g_dequeue_position + 1)) < 0) {
+        return false;                   // Empty, or the producer is mid-copy
+    }
+
+    *id = slot->id;
+    *mode_command = slot->mode_command;
+    memcpy(command, &slot->command, sizeof(manual_command_t));
+    memcpy(site_id, slot->site_id, sizeof(slot->site_id));
+    slot->sequence.store(g_dequeue_position + COMMAND_QUEUE_DEPTH, std::memory_order_release);
+    g_dequeue_position++;
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// OUTCOMES (control loop only)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void publish(uint32_t id, command_status_t status, manual_command_type_t type,
+                    mode_command_type_t mode_command, esp_err_t result, uint16_t merged,
+                    uint64_t submitted_us) {
+    command_result_t outcome;
+    memset(&outcome, 0, sizeof(outcome));
+    outcome.id = id;
+    outcome.status = status;
+    outcome.type = type;
+    outcome.mode_command = mode_command;
+    outcome.result = result;
+    outcome.merged = merged;
+    outcome.target_speed_ms = manual_mode_get_current_speed();
+    outcome.submitted_us = submitted_us;
+    outcome.completed_us = hal_clock_now_us();
+    outcome.completion = g_completions.load(std::memory_order_relaxed) + 1;
+
+    g_results[id & COMMAND_RESULT_MASK].write(outcome);
+    g_completions.store(outcome.completion, std::memory_order_release);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// EXECUTION (control loop only)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static inline bool is_speed_step(manual_command_type_t type) {
+    return type == MANUAL_CMD_INCREASE_SPEED || type == MANUAL_CMD_DECREASE_SPEED;
+}
+
+static void pending_speed_add(uint32_t id, const manual_command_t* command) {
+    pending_speed_t* pending = &g_pending_speed;
+
+    // The previous newest step now lives on in this one's target
+    if (pending->count > 0) {
+        publish(pending->id, COMMAND_STATUS_COALESCED, pending->type, MODE_CMD_NONE, ESP_OK, 0,
+                pending->submitted_us);
+        g_stats.coalesced++;
+    }
+
+    pending->id = id;
+    pending->type = command->type;
+    pending->steps += (command->type == MANUAL_CMD_INCREASE_SPEED) ? 1 : -1;
+    pending->count++;
+    pending->submitted_us = command->timestamp;
+    memcpy(pending->source, command->source, sizeof(pending->source));
+}
+
+static void pending_speed_flush(uint64_t now_us, bool force) {
+    pending_speed_t* pending = &g_pending_speed;
+    if (pending->count == 0) return;
+    if (!force && g_last_speed_apply_us != 0 &&
+        now_us - g_last_speed_apply_us < COMMAND_QUEUE_SPEED_INTERVAL_MS * 1000ULL) {
+        return;                         // Keep merging until the next slot
+    }
+
+    float target = manual_mode_get_current_speed() + pending->steps * MANUAL_MODE_SPEED_INCREMENT;
+    if (target < 0.0f) target = 0.0f;
+    if (target > MANUAL_MODE_MAX_SPEED_MS) target = MANUAL_MODE_MAX_SPEED_MS;
+
+    manual_command_t command = manual_mode_create_command(MANUAL_CMD_SET_SPEED, target,
+                                                          manual_mode_get_current_direction(),
+                                                          pending->source);
+    esp_err_t result = manual_mode_execute_command(&command);
+    publish(pending->id, COMMAND_STATUS_DONE, MANUAL_CMD_SET_SPEED, MODE_CMD_NONE, result, pending->count,
+            pending->submitted_us);
+
+    g_stats.executed++;
+    g_last_speed_apply_us = now_us;
+    memset(pending, 0, sizeof(*pending));
+}
+
+static void supersede_all(void) {
+    if (g_pending_speed.count > 0) {
+        publish(g_pending_speed.id, COMMAND_STATUS_SUPERSEDED, MANUAL_CMD_SET_SPEED, MODE_CMD_NONE,
+                ESP_ERR_INVALID_STATE, g_pending_speed.count, g_pending_speed.submitted_us);
+        g_stats.superseded++;
+        memset(&g_pending_speed, 0, sizeof(g_pending_speed));
+    }
+
+    uint32_t id;
+    mode_command_type_t mode_command;
+    manual_command_t command;
+    char site_id[CALIBRATION_SITE_ID_MAX + 1];
+    while (ring_pop(&id, &mode_command, &command, site_id)) {
+        publish(id, COMMAND_STATUS_SUPERSEDED, command.type, mode_command, ESP_ERR_INVALID_STATE, 0,
+                command.timestamp);
+        g_stats.superseded++;
+    }
+}
+
+static esp_err_t execute_mode_command(mode_command_type_t mode_command, const char* site_id) {
+    switch (mode_command) {
+        case MODE_CMD_ACTIVATE_WIRE_LEARNING: return mode_coordinator_activate_wire_learning();
+        case MODE_CMD_ACTIVATE_AUTOMATIC:     return mode_coordinator_activate_automatic();
+        case MODE_CMD_ACTIVATE_MANUAL:        return mode_coordinator_activate_manual();
+        case MODE_CMD_STOP:                   return mode_coordinator_stop_current_mode(false);
+        case MODE_CMD_INTERRUPT:
+            // Decided here, not at submit: the mode may have changed while queued
+            if (automatic_mode_is_active()) return automatic_mode_interrupt();
+            return mode_coordinator_stop_current_mode(true);
+        case MODE_CMD_RESET_SYSTEM:           return mode_coordinator_reset_system();
+        case MODE_CMD_CLEAR_CALIBRATION:
+            // A running mode still uses the profile, a loading one is not the active site's yet;
+            // the erase itself waits for housekeeping
+            if (mode_coordinator_get_current_mode() != TROLLEY_MODE_NONE ||
+                mode_coordinator_get_calibration_state() == CALIBRATION_PROFILE_LOADING) {
+                return ESP_ERR_INVALID_STATE;
+            }
+            return mode_coordinator_clear_calibration();
+        case MODE_CMD_SELECT_SITE:            return mode_coordinator_select_site(site_id);
+        case MODE_CMD_EMERGENCY_STOP:         return mode_coordinator_emergency_stop();
+        default:                              return ESP_ERR_INVALID_ARG;
+    }
+}
+
+void command_queue_drain(void) {
+    if (!g_initialized.load(std::memory_order_acquire)) return;
+    uint64_t now_us = hal_clock_now_us();
+
+    // 1. Emergency lane pre-empts: stop first, then nothing queued before it runs
+    uint32_t emergency_id = g_emergency_id.exchange(0, std::memory_order_acq_rel);
+    if (emergency_id != 0) {
+        esp_err_t result = mode_coordinator_emergency_stop();
+        publish(emergency_id, COMMAND_STATUS_DONE, MANUAL_CMD_EMERGENCY_STOP, MODE_CMD_NONE, result, 0, now_us);
+        g_stats.emergency_stops++;
+        g_stats.executed++;
+        supersede_all();
+        return;
+    }
+
+    // 2. Normal lane in order; speed steps accumulate, anything else flushes them first
+    uint32_t drained = 0;
+    uint32_t id;
+    mode_command_type_t mode_command;
+    manual_command_t command;
+    char site_id[CALIBRATION_SITE_ID_MAX + 1];
+    while (ring_pop(&id, &mode_command, &command, site_id)) {
+        drained++;
+        if (mode_command == MODE_CMD_NONE && is_speed_step(command.type)) {
+            pending_speed_add(id, &command);
+            continue;
+        }
+        pending_speed_flush(now_us, true);
+        esp_err_t result = (mode_command != MODE_CMD_NONE) ? execute_mode_command(mode_command, site_id)
+                                                           : manual_mode_execute_command(&command);
+        publish(id, COMMAND_STATUS_DONE, command.type, mode_command, result, 0, command.timestamp);
+        g_stats.executed++;
+    }
+    if (drained > g_stats.max_depth) g_stats.max_depth = drained;
+
+    // 3. Coalesced speed target, at most one per interval
+    pending_speed_flush(now_us, false);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t command_queue_init(void) {
+    g_initialized.store(false, std::memory_order_release);
+
+    for (uint32_t i = 0; i < COMMAND_QUEUE_DEPTH; i++) {
+        g_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    g_enqueue_position.store(0, std::memory_order_relaxed);
+    g_dequeue_position = 0;
+    g_emergency_id.store(0, std::memory_order_relaxed);
+    memset(&g_pending_speed, 0, sizeof(g_pending_speed));
+    g_last_speed_apply_us = 0;
+    memset(&g_stats, 0, sizeof(g_stats));
+
+    g_initialized.store(true, std::memory_order_release);
+    ESP_LOGI(TAG, "Command queue ready (%d entries, emergency lane, speed coalescing every %d ms)",
+             COMMAND_QUEUE_DEPTH, COMMAND_QUEUE_SPEED_INTERVAL_MS);
+    return ESP_OK;
+}
+
+esp_err_t command_queue_submit(const manual_command_t* command, uint32_t* id) {
+    if (command == NULL) return ESP_ERR_INVALID_ARG;
+    if (!g_initialized.load(std::memory_order_acquire)) return ESP_ERR_INVALID_STATE;
+
+    if (command->type == MANUAL_CMD_EMERGENCY_STOP) {
+        return command_queue_submit_emergency_stop(command->source, id);
+    }
+
+    uint32_t issued = 0;
+    if (!ring_push(MODE_CMD_NONE, command, NULL, &issued)) {
+        g_rejected_full.fetch_add(1, std::memory_order_relaxed);
+        ESP_LOGW(TAG, "Queue full - %s from %s rejected",
+                 manual_mode_command_type_to_string(command->type), command->source);
+        return ESP_ERR_NO_MEM;
+    }
+
+    g_submitted.fetch_add(1, std::memory_order_relaxed);
+    if (id != NULL) *id = issued;
+    return ESP_OK;
+}
+
+static esp_err_t submit_mode(mode_command_type_t type, const char* site_id, const char* source, uint32_t* id) {
+    // Carrier for the timestamp and source; NONE keeps it out of manual mode
+    manual_command_t command;
+    memset(&command, 0, sizeof(command));
+    command.type = MANUAL_CMD_NONE;
+    command.timestamp = hal_clock_now_us();
+    strncpy(command.source, source ? source : "unknown", sizeof(command.source) - 1);
+
+    uint32_t issued = 0;
+    if (!ring_push(type, &command, site_id, &issued)) {
+        g_rejected_full.fetch_add(1, std::memory_order_relaxed);
+        ESP_LOGW(TAG, "Queue full - %s from %s rejected", command_queue_mode_command_to_string(type), command.source);
+        return ESP_ERR_NO_MEM;
+    }
+
+    g_submitted.fetch_add(1, std::memory_order_relaxed);
+    if (id != NULL) *id = issued;
+    return ESP_OK;
+}
+
+esp_err_t command_queue_submit_mode(mode_command_type_t type, const char* source, uint32_t* id) {
+    if (type == MODE_CMD_NONE || type == MODE_CMD_SELECT_SITE) return ESP_ERR_INVALID_ARG;
+    if (!g_initialized.load(std::memory_order_acquire)) return ESP_ERR_INVALID_STATE;
+
+    if (type == MODE_CMD_EMERGENCY_STOP) {
+        return command_queue_submit_emergency_stop(source, id);
+    }
+    return submit_mode(type, NULL, source, id);
+}
+
+esp_err_t command_queue_submit_site(const char* site_id, const char* source, uint32_t* id) {
+    if (!calibration_store_is_valid_site_id(site_id)) return ESP_ERR_INVALID_ARG;
+    if (!g_initialized.load(std::memory_order_acquire)) return ESP_ERR_INVALID_STATE;
+
+    return submit_mode(MODE_CMD_SELECT_SITE, site_id, source, id);
+}
+
+esp_err_t command_queue_submit_emergency_stop(const char* source, uint32_t* id) {
+    if (!g_initialized.load(std::memory_order_acquire)) return ESP_ERR_INVALID_STATE;
+
+    // A stop already pending absorbs this one: both callers poll the same ID
+    uint32_t pending = g_emergency_id.load(std::memory_order_acquire);
+    if (pending == 0) {
+        uint32_t fresh = g_next_id.fetch_add(1, std::memory_order_relaxed);
+        if (g_emergency_id.compare_exchange_strong(pending, fresh, std::memory_order_acq_rel)) {
+            pending = fresh;
+        }
+    }
+
+    // Work scheduled elsewhere (a coordinated start) must not outlive the stop
+    command_queue_emergency_hook_t hook = g_emergency_hook.load(std::memory_order_acquire);
+    if (hook != nullptr) hook();
+
+    g_submitted.fetch_add(1, std::memory_order_relaxed);
+    ESP_LOGW(TAG, "Emergency stop #%lu requested by %s", (unsigned long)pending, source ? source : "unknown");
+    if (id != NULL) *id = pending;
+    return ESP_OK;
+}
+
+void command_queue_set_emergency_hook(command_queue_emergency_hook_t hook) {
+    g_emergency_hook.store(hook, std::memory_order_release);
+}
+
+esp_err_t command_queue_get_result(uint32_t id, command_result_t* result) {
+    if (result == NULL) return ESP_ERR_INVALID_ARG;
+    if (id == 0 || (int32_t)(id - g_next_id.load(std::memory_order_acquire)) >= 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    command_result_t outcome = g_results[id & COMMAND_RESULT_MASK].read();
+    if (outcome.id == id) {
+        *result = outcome;
+        return ESP_OK;
+    }
+    if ((int32_t)(outcome.id - id) > 0) {
+        return ESP_ERR_NOT_FOUND;       // Slot already holds a newer command
+    }
+
+    memset(result, 0, sizeof(*result));
+    result->id = id;
+    result->status = COMMAND_STATUS_QUEUED;
+    return ESP_OK;
+}
+
+size_t command_queue_get_completed_since(uint32_t* since, command_result_t* results, size_t max) {
+    if (since == NULL || results == NULL || max == 0) return 0;
+    uint32_t newest = g_completions.load(std::memory_order_acquire);
+    if (newest == *since) return 0;
+
+    // Oldest first: insertion sort of the (few) slots newer than *since
+    size_t count = 0;
+    for (uint32_t i = 0; i < COMMAND_QUEUE_RESULT_SLOTS; i++) {
+        command_result_t outcome = g_results[i].read();
+        if (outcome.completion == 0 || (int32_t)(outcome.completion - *since) <= 0) continue;
+
+        size_t at = count < max ? count : max;
+        while (at > 0 && (int32_t)(results[at - 1].completion - outcome.completion) > 0) {
+            if (at < max) results[at] = results[at - 1];
+            at--;
+        }
+        if (at < max) {
+            results[at] = outcome;
+            if (count < max) count++;
+        }
+    }
+
+    // Outcomes recycled before the caller looked are skipped, not retried
+    *since = (count == max && count > 0) ? results[count - 1].completion : newest;
+    return count;
+}
+
+command_queue_stats_t command_queue_get_stats(void) {
+    command_queue_stats_t stats = g_stats;
+    stats.submitted = g_submitted.load(std::memory_order_relaxed);
+    stats.rejected_full = g_rejected_full.load(std::memory_order_relaxed);
+    stats.completions = g_completions.load(std::memory_order_acquire);
+    return stats;
+}
+
+const char* command_queue_mode_command_to_string(mode_command_type_t type) {
+    switch (type) {
+        case MODE_CMD_NONE:                   return "None";
+        case MODE_CMD_ACTIVATE_WIRE_LEARNING: return "Start Wire Learning";
+        case MODE_CMD_ACTIVATE_AUTOMATIC:     return "Start Automatic";
+        case MODE_CMD_ACTIVATE_MANUAL:        return "Start Manual";
+        case MODE_CMD_STOP:                   return "Stop Mode";
+        case MODE_CMD_INTERRUPT:              return "Interrupt Mode";
+        case MODE_CMD_RESET_SYSTEM:           return "Reset System";
+        case MODE_CMD_CLEAR_CALIBRATION:      return "Clear Calibration";
+        case MODE_CMD_SELECT_SITE:            return "Select Site";
+        case MODE_CMD_EMERGENCY_STOP:         return "Emergency Stop";
+        default:                              return "Unknown";
+    }
+}
+
+const char* command_queue_status_to_string(command_status_t status) {
+    switch (status) {
+        case COMMAND_STATUS_UNKNOWN:    return "unknown";
+        case COMMAND_STATUS_QUEUED:     return "queued";
+        case COMMAND_STATUS_DONE:       return "done";
+        case COMMAND_STATUS_COALESCED:  return "coalesced";
+        case COMMAND_STATUS_SUPERSEDED: return "superseded";
+        default:                        return "invalid";
+    }
+}
@@ -0,0 +1,100 @@
+// components/control_loop/include/control_loop.h
+#ifndef CONTROL_LOOP_H
+#define CONTROL_LOOP_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONTROL_LOOP.H - DETERMINISTIC HIGH-RATE CONTROL PIPELINE
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Run the time-critical pipeline at a fixed rate
+// - GPTimer alarm wakes a high-priority task pinned to core 1
+// - One tick = sense (Hall/IMU) → estimate → queued commands → active mode
+//   step → ESC output
+// - Measures its own wake-up jitter, execution time and overruns
+//
+// NO status strings, NO logging in the tick, NO web work - those belong to
+// the housekeeping task in main.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Control loop configuration
+#define CONTROL_LOOP_DEFAULT_RATE_HZ    500         // Default tick rate
+#define CONTROL_LOOP_MIN_RATE_HZ        500         // Slowest supported rate
+#define CONTROL_LOOP_MAX_RATE_HZ        1000        // Fastest supported rate
+#define CONTROL_LOOP_TIMER_RESOLUTION   1000000     // GPTimer resolution (1 MHz = 1 us)
+#define CONTROL_LOOP_TASK_CORE          1           // Pinned core (WiFi/httpd live on core 0)
+#define CONTROL_LOOP_TASK_PRIORITY      20          // Above all application tasks
+#define CONTROL_LOOP_TASK_STACK         3072        // Static stack: ~0.9 KB deepest pipeline call chain,
+                                                    // the rest for the start log and Xtensa frames
+#define CONTROL_LOOP_IMU_RATE_HZ        100         // Sensor health IMU ring drain rate
+#define CONTROL_LOOP_COORDINATOR_RATE_HZ 20         // Mode coordinator supervision rate
+
+// Control loop timing statistics
+typedef struct {
+    bool running;                      // Loop ticking
+    uint32_t rate_hz;                  // Configured tick rate
+    uint32_t period_us;                // Tick period
+    uint64_t tick_count;               // Ticks executed since start
+    uint32_t overrun_count;            // Ticks whose pipeline took longer than period
+    uint32_t missed_ticks;             // Timer alarms skipped because loop was late
+    int32_t last_jitter_us;            // Wake-up time minus ideal time (last tick)
+    int32_t max_jitter_us;             // Largest |jitter| since reset
+    float avg_jitter_us;               // Running mean of |jitter|
+    uint32_t last_exec_us;             // Pipeline execution time (last tick)
+    uint32_t max_exec_us;              // Longest pipeline execution since reset
+    float avg_exec_us;                 // Running mean of execution time
+} control_loop_stats_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CORE CONTROL LOOP API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Configure the control loop (call after hardware and modes are initialized)
+ * @param rate_hz Tick rate, CONTROL_LOOP_MIN_RATE_HZ..CONTROL_LOOP_MAX_RATE_HZ (0 = default)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if rate out of range,
+ *         ESP_ERR_INVALID_STATE if already running
+ */
+esp_err_t control_loop_init(uint32_t rate_hz);
+
+/**
+ * @brief Create the pinned control task and start the tick timer
+ * @return ESP_OK on success, ESP_FAIL if the task could not be created or
+ *         its tick timer failed, ESP_ERR_INVALID_STATE if not initialized
+ */
+esp_err_t control_loop_start(void);
+
+/**
+ * @brief Stop the tick timer (the task idles until restarted)
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not running
+ */
+esp_err_t control_loop_stop(void);
+
+/**
+ * @brief Check if control loop is ticking
+ * @return true if running, false otherwise
+ */
+bool control_loop_is_running(void);
+
+/**
+ * @brief Get control loop timing statistics (tear-free snapshot)
+ * @return control_loop_stats_t structure
+ */
+control_loop_stats_t control_loop_get_stats(void);
+
+/**
+ * @brief Reset jitter/execution/overrun statistics
+ * @return ESP_OK on success
+ */
+esp_err_t control_loop_reset_stats(void);
+
+/**
+ * @brief Get configured tick period
+ * @return Tick period in microseconds
+ */
+uint32_t control_loop_get_period_us(void);
+
+#endif // CONTROL_LOOP_H
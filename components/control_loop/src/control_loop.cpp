@@ -0,0 +1,350 @@
+// components/control_loop/src/control_loop.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONTROL_LOOP.CPP - FIXED-RATE SENSE → ESTIMATE → MODE → ESC PIPELINE
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Deterministic control tick
+// - GPTimer alarm ISR only notifies the control task
+// - Control task (core 1, high priority) runs one pipeline pass per tick
+// - Jitter = actual wake time minus ideal tick time
+// - Overrun = pipeline execution longer than one period
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "control_loop.h"
+#include "hardware_control.h"
+#include "status_snapshot.h"
+#include "sensor_health.h"
+#include "state_estimator.h"
+#include "wire_end_detector.h"
+#include "wire_learning_mode.h"
+#include "automatic_mode.h"
+#include "manual_mode.h"
+#include "mode_coordinator.h"
+#include "command_queue.h"
+#include "telemetry_frame.h"
+#include "perf_monitor.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/gptimer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <cstring>
+#include <cstdlib>
+
+static const char* TAG = "CONTROL_LOOP";
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// GLOBAL STATE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static gptimer_handle_t g_tick_timer = NULL;
+static TaskHandle_t g_control_task_handle = NULL;
+static StackType_t g_control_task_stack[CONTROL_LOOP_TASK_STACK];
+static StaticTask_t g_control_task_tcb;
+static volatile bool g_tick_timer_failed = false;
+static uint32_t g_rate_hz = CONTROL_LOOP_DEFAULT_RATE_HZ;
+static uint32_t g_period_us = 1000000 / CONTROL_LOOP_DEFAULT_RATE_HZ;
+static bool g_loop_initialized = false;
+static volatile bool g_loop_running = false;
+static volatile bool g_stats_reset_requested = false;
+
+// Written only by the control task, read anywhere through the snapshot
+static control_loop_stats_t g_stats = {};
+static status_snapshot<control_loop_stats_t> g_stats_snapshot;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// TICK SOURCE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static bool IRAM_ATTR control_tick_isr(gptimer_handle_t timer,
+                                       const gptimer_alarm_event_data_t* edata,
+                                       void* user_ctx) {
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(g_control_task_handle, &xHigherPriorityTaskWoken);
+    return xHigherPriorityTaskWoken == pdTRUE;
+}
+
+static esp_err_t init_tick_timer(void) {
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = CONTROL_LOOP_TIMER_RESOLUTION
+    };
+    esp_err_t ret = gptimer_new_timer(&timer_config, &g_tick_timer);
+    if (ret != ESP_OK) return ret;
+
+    // Interrupt is allocated on the calling core - call from the control task
+    gptimer_event_callbacks_t callbacks = {
+        .on_alarm = control_tick_isr
+    };
+    ret = gptimer_register_event_callbacks(g_tick_timer, &callbacks, NULL);
+    if (ret != ESP_OK) return ret;
+
+    return gptimer_enable(g_tick_timer);
+}
+
+static esp_err_t start_tick_timer(void) {
+    // Period may have changed via control_loop_init() while stopped
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count = g_period_us,
+        .reload_count = 0,
+        .flags = {
+            .auto_reload_on_alarm = true
+        }
+    };
+    esp_err_t ret = gptimer_set_alarm_action(g_tick_timer, &alarm_config);
+    if (ret != ESP_OK) return ret;
+
+    ret = gptimer_set_raw_count(g_tick_timer, 0);
+    if (ret != ESP_OK) return ret;
+
+    return gptimer_start(g_tick_timer);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PIPELINE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void control_pipeline_tick(uint64_t tick) {
+    PERF_SCOPE(PERF_PROBE_LOOP_TICK);
+
+    // 1. Sense: Hall edges → speed/position; IMU ring drained by sensor health
+    {
+        PERF_SCOPE(PERF_PROBE_SENSE);
+        hardware_sense_update();
+    }
+
+    uint32_t imu_decimation = g_rate_hz / CONTROL_LOOP_IMU_RATE_HZ;
+    if (imu_decimation == 0 || (tick % imu_decimation) == 0) {
+        PERF_SCOPE(PERF_PROBE_SENSOR_HEALTH);
+        sensor_health_update();
+    }
+
+    // 2. Estimate: Hall edges + IMU acceleration → position/velocity
+    {
+        PERF_SCOPE(PERF_PROBE_ESTIMATOR);
+        state_estimator_update(g_period_us);
+    }
+
+    // 2b. Detect: IMU shock + Hall timing + command tracking → wire end events
+    {
+        PERF_SCOPE(PERF_PROBE_WIRE_END);
+        wire_end_detector_update();
+    }
+
+    // 2c. Commands: emergency lane first, then queued manual commands
+    {
+        PERF_SCOPE(PERF_PROBE_COMMANDS);
+        command_queue_drain();
+    }
+
+    // 3. Mode logic: each update returns immediately when its mode is idle
+    {
+        PERF_SCOPE(PERF_PROBE_WIRE_LEARNING);
+        wire_learning_mode_update();
+    }
+    {
+        PERF_SCOPE(PERF_PROBE_AUTOMATIC);
+        automatic_mode_update();
+    }
+    {
+        PERF_SCOPE(PERF_PROBE_MANUAL);
+        manual_mode_update();
+    }
+
+    // 3b. Supervise: mode availability, health and status after the mode steps
+    uint32_t coordinator_decimation = g_rate_hz / CONTROL_LOOP_COORDINATOR_RATE_HZ;
+    if (coordinator_decimation == 0 || (tick % coordinator_decimation) == 0) {
+        PERF_SCOPE(PERF_PROBE_MODE_COORDINATOR);
+        mode_coordinator_update();
+    }
+
+    // 4. Output: speed controller on the estimated speed → ESC duty
+    {
+        PERF_SCOPE(PERF_PROBE_ESC_OUTPUT);
+        hardware_output_update(g_period_us, state_estimator_get_speed());
+    }
+
+    // 5. Record: binary telemetry of this tick for stream/log consumers
+    uint32_t telemetry_decimation = g_rate_hz / TELEMETRY_CAPTURE_RATE_HZ;
+    if (telemetry_decimation == 0 || (tick % telemetry_decimation) == 0) {
+        PERF_SCOPE(PERF_PROBE_TELEMETRY);
+        telemetry_frame_capture();
+    }
+}
+
+static void update_timing_stats(int32_t jitter_us, uint32_t exec_us, uint32_t missed) {
+    if (g_stats_reset_requested) {
+        g_stats_reset_requested = false;
+        g_stats.overrun_count = 0;
+        g_stats.missed_ticks = 0;
+        g_stats.max_jitter_us = 0;
+        g_stats.avg_jitter_us = 0.0f;
+        g_stats.max_exec_us = 0;
+        g_stats.avg_exec_us = 0.0f;
+    }
+
+    g_stats.tick_count++;
+    g_stats.missed_ticks += missed;
+
+    int32_t abs_jitter = abs(jitter_us);
+    g_stats.last_jitter_us = jitter_us;
+    if (abs_jitter > g_stats.max_jitter_us) {
+        g_stats.max_jitter_us = abs_jitter;
+    }
+    g_stats.avg_jitter_us += (abs_jitter - g_stats.avg_jitter_us) * 0.01f;
+
+    g_stats.last_exec_us = exec_us;
+    if (exec_us > g_stats.max_exec_us) {
+        g_stats.max_exec_us = exec_us;
+    }
+    g_stats.avg_exec_us += (exec_us - g_stats.avg_exec_us) * 0.01f;
+
+    if (exec_us > g_period_us) {
+        g_stats.overrun_count++;
+    }
+
+    g_stats_snapshot.write(g_stats);
+}
+
+static void control_loop_task(void* pvParameter) {
+    if (init_tick_timer() != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create tick timer - control loop not running");
+        // Static TCB: parked, never deleted, so it can't be recreated over itself
+        g_tick_timer_failed = true;
+        g_loop_running = false;
+        vTaskSuspend(NULL);
+    }
+
+    ESP_LOGI(TAG, "Control loop task started on core %d at %lu Hz",
+             CONTROL_LOOP_TASK_CORE, g_rate_hz);
+
+    uint64_t ideal_time = 0;
+
+    while (1) {
+        if (!g_loop_running) {
+            // Stopped: wait for control_loop_start() to kick the task
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            if (!g_loop_running) continue;
+
+            g_stats.rate_hz = g_rate_hz;
+            g_stats.period_us = g_period_us;
+            ideal_time = esp_timer_get_time() + g_period_us;
+            if (start_tick_timer() != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to start tick timer");
+                g_loop_running = false;
+            }
+            continue;
+        }
+
+        // Block until the next alarm; >1 means we fell behind
+        uint32_t pending = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+        if (pending == 0 || !g_loop_running) {
+            continue;
+        }
+
+        uint64_t wake_time = esp_timer_get_time();
+        uint32_t missed = pending - 1;
+        ideal_time += (uint64_t)missed * g_period_us;
+        int32_t jitter_us = (int32_t)(wake_time - ideal_time);
+        ideal_time += g_period_us;
+
+        control_pipeline_tick(g_stats.tick_count);
+
+        uint32_t exec_us = (uint32_t)(esp_timer_get_time() - wake_time);
+        update_timing_stats(jitter_us, exec_us, missed);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t control_loop_init(uint32_t rate_hz) {
+    if (g_loop_running) return ESP_ERR_INVALID_STATE;
+
+    if (rate_hz == 0) {
+        rate_hz = CONTROL_LOOP_DEFAULT_RATE_HZ;
+    }
+    if (rate_hz < CONTROL_LOOP_MIN_RATE_HZ || rate_hz > CONTROL_LOOP_MAX_RATE_HZ) {
+        ESP_LOGE(TAG, "Invalid control rate %lu Hz (%d-%d)", rate_hz,
+                 CONTROL_LOOP_MIN_RATE_HZ, CONTROL_LOOP_MAX_RATE_HZ);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    g_rate_hz = rate_hz;
+    g_period_us = CONTROL_LOOP_TIMER_RESOLUTION / rate_hz;
+
+    // Control task is idle while stopped, safe to reset its stats here
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_stats.rate_hz = g_rate_hz;
+    g_stats.period_us = g_period_us;
+    g_stats_snapshot.write(g_stats);
+
+    g_loop_initialized = true;
+    ESP_LOGI(TAG, "Control loop configured: %lu Hz (%lu us period)", g_rate_hz, g_period_us);
+    return ESP_OK;
+}
+
+esp_err_t control_loop_start(void) {
+    if (!g_loop_initialized) return ESP_ERR_INVALID_STATE;
+    if (g_loop_running) return ESP_OK;
+    if (g_tick_timer_failed) return ESP_FAIL;
+
+    // Set before the first start: a tick timer failure on core 1 must win
+    g_loop_running = true;
+    if (g_control_task_handle == NULL) {
+        // Static stack and TCB: no heap at start, sized at link time
+        g_control_task_handle = xTaskCreateStaticPinnedToCore(control_loop_task, "control_loop",
+                                                              CONTROL_LOOP_TASK_STACK, NULL,
+                                                              CONTROL_LOOP_TASK_PRIORITY,
+                                                              g_control_task_stack,
+                                                              &g_control_task_tcb,
+                                                              CONTROL_LOOP_TASK_CORE);
+        if (g_control_task_handle == NULL) {
+            ESP_LOGE(TAG, "Failed to create control loop task");
+            g_loop_running = false;
+            return ESP_FAIL;
+        }
+    }
+
+    xTaskNotifyGive(g_control_task_handle);
+
+    ESP_LOGI(TAG, "Control loop started");
+    return ESP_OK;
+}
+
+esp_err_t control_loop_stop(void) {
+    if (!g_loop_running) return ESP_ERR_INVALID_STATE;
+
+    g_loop_running = false;
+    if (g_tick_timer) {
+        gptimer_stop(g_tick_timer);
+    }
+
+    // Leave the ESC in a safe state - nobody is driving the output stage now
+    hardware_emergency_stop();
+
+    ESP_LOGW(TAG, "Control loop stopped");
+    return ESP_OK;
+}
+
+bool control_loop_is_running(void) {
+    return g_loop_running;
+}
+
+control_loop_stats_t control_loop_get_stats(void) {
+    control_loop_stats_t stats = g_stats_snapshot.read();
+    stats.running = g_loop_running;
+    return stats;
+}
+
+esp_err_t control_loop_reset_stats(void) {
+    // Applied by the control task on its next tick (single writer)
+    g_stats_reset_requested = true;
+    return ESP_OK;
+}
+
+uint32_t control_loop_get_period_us(void) {
+    return g_period_us;
+}
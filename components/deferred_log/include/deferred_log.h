@@ -0,0 +1,297 @@
+// components/deferred_log/include/deferred_log.h
+#ifndef DEFERRED_LOG_H
+#define DEFERRED_LOG_H
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DEFERRED_LOG.H - BINARY LOG RECORDS, FORMATTED OFF THE CONTROL PATH
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Keep printf and the UART out of hot code
+// - deferred_log(DLOG_MSG_x, args...) stores a message ID, a millisecond
+//   timestamp and up to DEFERRED_LOG_MAX_ARGS raw arguments in a lock-free
+//   ring: no formatting, no locks, never blocks (ISR safe)
+// - Format strings, tags and levels live in one const table
+//   (deferred_log_messages.cpp), so a record is ~40 bytes whatever it says
+// - A low-priority task on core 0 formats the records and writes them to
+//   the console in the ESP_LOG layout (with the time they were logged, not
+//   printed) and to the optional sink (WebSocket "log" events)
+// - Per-tag token bucket: a tag may burst DEFERRED_LOG_TAG_BURST records,
+//   then DEFERRED_LOG_TAG_RATE_HZ; the rest are counted, reported once per
+//   DEFERRED_LOG_REPORT_MS and never queued. Errors are never rate limited
+// - A full ring drops the record and counts it
+//
+// %s arguments are stored as pointers: pass literals or *_to_string()
+// results only, never a stack buffer.
+//
+// CONFIG_TROLLEY_DEFERRED_LOG=n formats every record inline through
+// esp_log_write() (the old timing, for debugging ordering).
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Pipeline configuration
+#define DEFERRED_LOG_RING_SIZE      64          // Records waiting (power of 2)
+#define DEFERRED_LOG_MAX_ARGS       6           // Arguments per record
+#define DEFERRED_LOG_LINE_SIZE      160         // Formatted message bytes
+#define DEFERRED_LOG_TAG_BURST      10          // Records a tag may send back to back
+#define DEFERRED_LOG_TAG_RATE_HZ    5           // Sustained records per second per tag
+#define DEFERRED_LOG_REPORT_MS      1000        // Suppressed-count report interval
+
+// Task configuration
+#define DEFERRED_LOG_TASK_STACK     4096        // vsnprintf + esp_log_write + the sink's JSON
+#define DEFERRED_LOG_TASK_PRIORITY  1           // Below everything but idle
+#define DEFERRED_LOG_TASK_CORE      0           // Away from the control loop
+
+// Rate-limited sources (one per module TAG)
+typedef enum : uint8_t {
+    DLOG_TAG_SENSOR_HEALTH = 0,
+    DLOG_TAG_WIRE_LEARNING,
+    DLOG_TAG_AUTOMATIC,
+    DLOG_TAG_MANUAL,
+    DLOG_TAG_WIRE_END,
+    DLOG_TAG_HARDWARE,
+    DLOG_TAG_COORDINATOR,
+    DLOG_TAG_COUNT
+} dlog_tag_t;
+
+// Messages (format, tag and level in deferred_log_messages.cpp)
+typedef enum : uint16_t {
+    DLOG_MSG_NONE = 0,
+
+    // Sensor health
+    DLOG_MSG_SENSOR_WHEEL_ROTATION,     // pulses
+    DLOG_MSG_SENSOR_SHAKE,              // g
+    DLOG_MSG_SENSOR_IMPACT,             // g
+
+    // Wire learning
+    DLOG_MSG_WL_HOMING,                 // m/s
+    DLOG_MSG_WL_HOMING_COMPLETE,        // source
+    DLOG_MSG_WL_TESTING_SPEED,          // m/s
+    DLOG_MSG_WL_SPEED_SET_FAILED,
+    DLOG_MSG_WL_SPEED_VALIDATED,        // m/s, pulses, ms
+    DLOG_MSG_WL_SPEED_TIMEOUT,          // m/s, pulses, ms
+    DLOG_MSG_WL_SPEED_FAILED,           // m/s, pulses, ms
+    DLOG_MSG_WL_MAX_SPEED,              // m/s
+    DLOG_MSG_WL_WIRE_END,               // source, confidence, g
+    DLOG_MSG_WL_COAST_PLANNED,          // m/s, m
+    DLOG_MSG_WL_COAST_SKIPPED,          // m
+    DLOG_MSG_WL_COAST_START,            // m/s
+    DLOG_MSG_WL_COAST_ACCEL_TIMEOUT,    // m/s, m/s
+    DLOG_MSG_WL_COAST_ABORTED,
+    DLOG_MSG_WL_COAST_TIMEOUT,
+    DLOG_MSG_WL_COAST_COMPLETE,         // m, ms, m/s², m
+    DLOG_MSG_WL_FORWARD_COMPLETE,       // m, rotations
+    DLOG_MSG_WL_REVERSE_COMPLETE,       // m, rotations
+    DLOG_MSG_WL_SUCCESS,                // m, m/s, m/s, %
+    DLOG_MSG_WL_FAILED,                 // m, m, %
+
+    // Automatic mode
+    DLOG_MSG_AUTO_COAST_TRACE_UNUSED,   // error name
+    DLOG_MSG_AUTO_COAST_MODEL,          // direction, base, drag, fit, residual
+    DLOG_MSG_AUTO_COAST_CAL_STOP,       // m/s
+    DLOG_MSG_AUTO_COAST_OUT_OF_RANGE,   // m
+    DLOG_MSG_AUTO_COAST_CAL_COMPLETE,   // m, ms, m/s², m
+    DLOG_MSG_AUTO_SLOW_ZONE_UNTRACKED,  // m, pending
+    DLOG_MSG_AUTO_SAFETY_FAILED,
+    DLOG_MSG_AUTO_RAMP_COMPLETE,        // m/s
+    DLOG_MSG_AUTO_RUN_OVERRUN,          // m, m/s
+    DLOG_MSG_AUTO_RUN_PLAN_FAILED,
+    DLOG_MSG_AUTO_RUN_PLANNED,          // m, m/s, s
+    DLOG_MSG_AUTO_REPLANNING,           // m, m/s, suffix
+    DLOG_MSG_AUTO_CRUISE_TARGET,        // m/s
+    DLOG_MSG_AUTO_WIRE_END,             // source, confidence, g
+    DLOG_MSG_AUTO_COAST_WIRE_END,       // m/s
+    DLOG_MSG_AUTO_ESC_ARMED,
+    DLOG_MSG_AUTO_EMERGENCY,            // status text
+    DLOG_MSG_AUTO_WIRE_END_REACHED,
+    DLOG_MSG_AUTO_SEEKING,              // m/s
+    DLOG_MSG_AUTO_SEEK_STALLED,
+    DLOG_MSG_AUTO_SEEK_TIMEOUT,         // s
+    DLOG_MSG_AUTO_RUN_COMPLETE,         // direction, run, m
+    DLOG_MSG_AUTO_CYCLE_COMPLETE,       // cycle, s
+    DLOG_MSG_AUTO_FINISHED,             // cycles
+    DLOG_MSG_AUTO_COAST_CAL_SKIPPED,
+    DLOG_MSG_AUTO_COAST_CAL_FAILED,
+    DLOG_MSG_AUTO_COAST_CAL_START,      // m/s
+    DLOG_MSG_AUTO_SPEED_CLAMPED,        // m/s, m/s
+    DLOG_MSG_AUTO_ACCELERATING,         // m/s
+    DLOG_MSG_AUTO_ACCEL_FAILED,
+    DLOG_MSG_AUTO_DECELERATING,         // m/s
+    DLOG_MSG_AUTO_DECEL_NOT_NEEDED,
+    DLOG_MSG_AUTO_STOP_GRACEFUL,
+    DLOG_MSG_AUTO_INTERRUPTED,
+    DLOG_MSG_AUTO_DISARMING,
+
+    // Manual mode
+    DLOG_MSG_MANUAL_SENSORS_INVALID,
+    DLOG_MSG_MANUAL_EXCESSIVE_IMPACT,
+    DLOG_MSG_MANUAL_HALL_SILENT,
+    DLOG_MSG_MANUAL_IMPACT,             // g, g
+    DLOG_MSG_MANUAL_HALL_NO_MOVEMENT,
+    DLOG_MSG_MANUAL_ESC_NOT_RESPONDING,
+    DLOG_MSG_MANUAL_ESC_ARMED,
+    DLOG_MSG_MANUAL_SAFETY_STOP,
+    DLOG_MSG_MANUAL_EMERGENCY,
+
+    // Wire end detector
+    DLOG_MSG_WIRE_END_EVENT,            // sources, confidence, g, ms
+    DLOG_MSG_WIRE_END_FALSE,            // m
+
+    // Hardware control
+    DLOG_MSG_HW_SPEED_SET,              // m/s, direction, loop
+    DLOG_MSG_HW_ESC_ARMING,             // ms
+    DLOG_MSG_HW_ESC_ARMED,
+    DLOG_MSG_HW_ESC_DISARMED,
+    DLOG_MSG_HW_EMERGENCY_STOP,
+
+    // Mode coordinator
+    DLOG_MSG_COORD_COASTING_SET,        // m
+    DLOG_MSG_COORD_ERROR,               // status text, count
+    DLOG_MSG_COORD_CAL_VERIFIED,        // m, m, %
+    DLOG_MSG_COORD_CAL_REJECTED,        // m, m, %
+    DLOG_MSG_COORD_STOPPING,            // immediate/graceful
+    DLOG_MSG_COORD_EMERGENCY_STOP,
+
+    DLOG_MSG_COUNT
+} dlog_message_t;
+
+// Stored argument
+typedef enum : uint8_t {
+    DLOG_ARG_INT = 0,
+    DLOG_ARG_UINT,
+    DLOG_ARG_FLOAT,
+    DLOG_ARG_STR
+} dlog_arg_type_t;
+
+typedef union {
+    int32_t i;
+    uint32_t u;
+    float f;
+    const char* s;                      // Static strings only
+} dlog_value_t;
+
+typedef struct {
+    dlog_arg_type_t type;
+    dlog_value_t value;
+} dlog_arg_t;
+
+// Table entry
+typedef struct {
+    dlog_tag_t tag;
+    esp_log_level_t level;
+    const char* format;                 // printf format; conversions are matched to the stored type
+} dlog_message_info_t;
+
+// Pipeline counters since boot
+typedef struct {
+    bool deferred;                      // false: CONFIG_TROLLEY_DEFERRED_LOG=n, inline formatting
+    uint32_t written;                   // Records queued
+    uint32_t printed;                   // Records formatted and written out
+    uint32_t dropped;                   // Ring full
+    uint32_t suppressed;                // Rate limited, all tags
+    uint32_t suppressed_by_tag[DLOG_TAG_COUNT];
+    uint32_t max_depth;                 // Deepest the ring has been
+} deferred_log_stats_t;
+
+/**
+ * @brief Receives every formatted record (log task context)
+ */
+typedef void (*deferred_log_sink_t)(esp_log_level_t level, const char* tag,
+                                    uint32_t timestamp_ms, const char* text);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// LIFECYCLE API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Start the log task (records written before this wait in the ring)
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the task could not be created
+ */
+esp_err_t deferred_log_init(void);
+
+/**
+ * @brief Set where formatted records go besides the console
+ * @param sink Sink, NULL for console only
+ */
+void deferred_log_set_sink(deferred_log_sink_t sink);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// RECORDING API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Queue one record (any task or ISR, never blocks)
+ * @param message Message ID
+ * @param args Arguments in format order
+ * @param count Number of arguments (extra ones are ignored)
+ */
+void deferred_log_write(dlog_message_t message, const dlog_arg_t* args, uint8_t count);
+
+// Argument packing: the stored type follows the C++ type of the argument
+static inline dlog_arg_t dlog_arg(int value)                { dlog_arg_t a; a.type = DLOG_ARG_INT;   a.value.i = value; return a; }
+static inline dlog_arg_t dlog_arg(long value)               { dlog_arg_t a; a.type = DLOG_ARG_INT;   a.value.i = (int32_t)value; return a; }
+static inline dlog_arg_t dlog_arg(long long value)          { dlog_arg_t a; a.type = DLOG_ARG_INT;   a.value.i = (int32_t)value; return a; }
+static inline dlog_arg_t dlog_arg(unsigned int value)       { dlog_arg_t a; a.type = DLOG_ARG_UINT;  a.value.u = value; return a; }
+static inline dlog_arg_t dlog_arg(unsigned long value)      { dlog_arg_t a; a.type = DLOG_ARG_UINT;  a.value.u = (uint32_t)value; return a; }
+static inline dlog_arg_t dlog_arg(unsigned long long value) { dlog_arg_t a; a.type = DLOG_ARG_UINT;  a.value.u = (uint32_t)value; return a; }
+static inline dlog_arg_t dlog_arg(bool value)               { dlog_arg_t a; a.type = DLOG_ARG_UINT;  a.value.u = value ? 1 : 0; return a; }
+static inline dlog_arg_t dlog_arg(float value)              { dlog_arg_t a; a.type = DLOG_ARG_FLOAT; a.value.f = value; return a; }
+static inline dlog_arg_t dlog_arg(double value)             { dlog_arg_t a; a.type = DLOG_ARG_FLOAT; a.value.f = (float)value; return a; }
+static inline dlog_arg_t dlog_arg(const char* value)        { dlog_arg_t a; a.type = DLOG_ARG_STR;   a.value.s = value; return a; }
+
+/**
+ * @brief Queue one record: deferred_log(DLOG_MSG_WL_TESTING_SPEED, speed_ms)
+ */
+template <typename... Args>
+static inline void deferred_log(dlog_message_t message, Args... args) {
+    static_assert(sizeof...(Args) <= DEFERRED_LOG_MAX_ARGS, "too many deferred log arguments");
+    const dlog_arg_t packed[sizeof...(Args) + 1] = {dlog_arg(args)..., dlog_arg(0)};
+    deferred_log_write(message, packed, (uint8_t)sizeof...(Args));
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FORMATTING API (deferred_log_messages.cpp, no RTOS dependencies)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Look up a message
+ * @param message Message ID
+ * @return Table entry, NULL for an unknown ID
+ */
+const dlog_message_info_t* deferred_log_message_info(dlog_message_t message);
+
+/**
+ * @brief Render a record's text
+ * @param message Message ID
+ * @param types Stored argument types
+ * @param values Stored argument values
+ * @param count Number of arguments
+ * @param buffer Output, always NUL-terminated
+ * @param size Capacity of buffer
+ * @return Characters written (truncated to size - 1)
+ */
+size_t deferred_log_format(dlog_message_t message, const dlog_arg_type_t* types,
+                           const dlog_value_t* values, uint8_t count, char* buffer, size_t size);
+
+/**
+ * @brief Tag name (the module's ESP_LOG TAG)
+ * @param tag Tag
+ * @return Static string
+ */
+const char* deferred_log_tag_to_string(dlog_tag_t tag);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STATUS API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Get pipeline counters
+ * @return deferred_log_stats_t structure
+ */
+deferred_log_stats_t deferred_log_get_stats(void);
+
+#endif // DEFERRED_LOG_H
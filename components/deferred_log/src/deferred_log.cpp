@@ -0,0 +1,401 @@
+// components/deferred_log/src/deferred_log.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// DEFERRED_LOG.CPP - RECORD RING, RATE LIMITER, LOG WRITER TASK
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "deferred_log.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+static const char* TAG = "DEFERRED_LOG";
+
+#define RING_MASK                   (DEFERRED_LOG_RING_SIZE - 1)
+#define REFILL_WAIT_MS              100         // Writer wake-up while buckets refill
+#define TOKEN_SCALE                 1000        // Bucket fill in milli-records
+
+static_assert((DEFERRED_LOG_RING_SIZE & RING_MASK) == 0, "ring size must be a power of 2");
+
+#ifdef CONFIG_LOG_DEFAULT_LEVEL
+#define RECORD_MAX_LEVEL            CONFIG_LOG_DEFAULT_LEVEL
+#else
+#define RECORD_MAX_LEVEL            ESP_LOG_INFO
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SHARED HELPERS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static inline bool level_enabled(esp_log_level_t level) {
+    // Above the default level nobody would see it: do not even queue it
+    return level != ESP_LOG_NONE && (int)level <= (int)RECORD_MAX_LEVEL;
+}
+
+static inline char level_letter(esp_log_level_t level) {
+    switch (level) {
+        case ESP_LOG_ERROR:   return 'E';
+        case ESP_LOG_WARN:    return 'W';
+        case ESP_LOG_INFO:    return 'I';
+        case ESP_LOG_DEBUG:   return 'D';
+        case ESP_LOG_VERBOSE: return 'V';
+        default:              return '?';
+    }
+}
+
+static void print_line(esp_log_level_t level, const char* tag, uint32_t timestamp_ms, const char* text) {
+    // Same layout as ESP_LOGx, stamped with the time the record was taken
+    esp_log_write(level, tag, "%c (%lu) %s: %s\n", level_letter(level),
+                  (unsigned long)timestamp_ms, tag, text);
+}
+
+#if CONFIG_TROLLEY_DEFERRED_LOG
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// GLOBAL STATE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Bounded MPSC ring, as in command_queue.cpp. The sequence is kept relative
+// to the slot index, so the zero-filled ring is valid before init
+// (== position: free for that producer, == position + 1: ready for the writer)
+typedef struct {
+    std::atomic<uint32_t> sequence;
+    dlog_message_t message;
+    uint8_t count;
+    uint32_t timestamp_ms;
+    dlog_arg_type_t types[DEFERRED_LOG_MAX_ARGS];
+    dlog_value_t values[DEFERRED_LOG_MAX_ARGS];
+} log_slot_t;
+
+static log_slot_t g_slots[DEFERRED_LOG_RING_SIZE];
+static std::atomic<uint32_t> g_enqueue_position{0};
+static uint32_t g_dequeue_position = 0;                 // Writer task only
+
+// Per-tag token buckets: producers take, the writer task refills
+static std::atomic<int32_t> g_tokens[DLOG_TAG_COUNT];
+static std::atomic<bool> g_buckets_primed{false};
+static uint64_t g_last_refill_us = 0;
+static uint64_t g_last_report_us = 0;
+static uint32_t g_reported_by_tag[DLOG_TAG_COUNT];      // suppressed_by_tag at the last report
+
+static TaskHandle_t g_task_handle = NULL;
+static StackType_t g_task_stack[DEFERRED_LOG_TASK_STACK];
+static StaticTask_t g_task_tcb;
+static std::atomic<bool> g_writer_idle{false};          // Writer about to block: wake it
+static std::atomic<deferred_log_sink_t> g_sink{NULL};
+
+// Producer counters are shared, writer counters have one writer
+static std::atomic<uint32_t> g_written{0};
+static std::atomic<uint32_t> g_dropped{0};
+static std::atomic<uint32_t> g_suppressed_by_tag[DLOG_TAG_COUNT];
+static std::atomic<uint32_t> g_printed{0};
+static std::atomic<uint32_t> g_max_depth{0};
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// RING
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static inline uint32_t slot_sequence(uint32_t index) {
+    return g_slots[index].sequence.load(std::memory_order_acquire) + index;
+}
+
+static inline void slot_publish(uint32_t index, uint32_t sequence) {
+    g_slots[index].sequence.store(sequence - index, std::memory_order_release);
+}
+
+static bool ring_push(dlog_message_t message, const dlog_arg_t* args, uint8_t count, uint32_t timestamp_ms) {
+    uint32_t position = g_enqueue_position.load(std::memory_order_relaxed);
+    uint32_t index;
+
+    while (true) {
+        index = position & RING_MASK;
+        int32_t diff = (int32_t)(slot_sequence(index) - position);
+        if (diff == 0) {
+            if (g_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;               // Writer has not freed this slot yet: full
+        } else {
+            position = g_enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+
+    log_slot_t* slot = &g_slots[index];
+    slot->message = message;
+    slot->count = count;
+    slot->timestamp_ms = timestamp_ms;
+    for (uint8_t i = 0; i < count; i++) {
+        slot->types[i] = args[i].type;
+        slot->values[i] = args[i].value;
+    }
+    slot_publish(index, position + 1);
+    return true;
+}
+
+static bool ring_pop(log_slot_t* record) {
+    uint32_t index = g_dequeue_position & RING_MASK;
+    if ((int32_t)(slot_sequence(index) - (g_dequeue_position + 1)) < 0) {
+        return false;                   // Empty, or the producer is mid-copy
+    }
+
+    const log_slot_t* slot = &g_slots[index];
+    record->message = slot->message;
+    record->count = slot->count;
+    record->timestamp_ms = slot->timestamp_ms;
+    memcpy(record->types, slot->types, sizeof(record->types));
+    memcpy(record->values, slot->values, sizeof(record->values));
+    slot_publish(index, g_dequeue_position + DEFERRED_LOG_RING_SIZE);
+    g_dequeue_position++;
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// RATE LIMITER
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void prime_buckets(void) {
+    // Once, from whoever logs first: a full burst for every tag
+    bool expected = false;
+    if (g_buckets_primed.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+        for (int i = 0; i < DLOG_TAG_COUNT; i++) {
+            g_tokens[i].fetch_add(DEFERRED_LOG_TAG_BURST * TOKEN_SCALE, std::memory_order_relaxed);
+        }
+    }
+}
+
+static bool take_token(dlog_tag_t tag) {
+    if (g_tokens[tag].fetch_sub(TOKEN_SCALE, std::memory_order_relaxed) >= TOKEN_SCALE) {
+        return true;
+    }
+    g_tokens[tag].fetch_add(TOKEN_SCALE, std::memory_order_relaxed);
+    g_suppressed_by_tag[tag].fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+/**
+ * @brief Top up every bucket for the time since the last refill
+ * @return true while any bucket is below a full burst
+ */
+static bool refill_buckets(uint64_t now_us) {
+    uint64_t earned = (now_us - g_last_refill_us) * DEFERRED_LOG_TAG_RATE_HZ * TOKEN_SCALE / 1000000ULL;
+    int32_t gain = earned > DEFERRED_LOG_TAG_BURST * TOKEN_SCALE ? DEFERRED_LOG_TAG_BURST * TOKEN_SCALE : (int32_t)earned;
+    if (gain > 0) {
+        g_last_refill_us = now_us;
+    }
+
+    bool refilling = false;
+    for (int i = 0; i < DLOG_TAG_COUNT; i++) {
+        int32_t tokens = g_tokens[i].load(std::memory_order_relaxed);
+        int32_t room = DEFERRED_LOG_TAG_BURST * TOKEN_SCALE - tokens;
+        if (room <= 0) continue;
+        g_tokens[i].fetch_add(gain < room ? gain : room, std::memory_order_relaxed);
+        refilling |= gain < room;
+    }
+    return refilling;
+}
+
+/**
+ * @brief Print one line per tag that lost records since the last report
+ * @return true while a report is still owed
+ */
+static bool report_suppressed(uint64_t now_us) {
+    bool owed = false;
+    bool due = now_us - g_last_report_us >= DEFERRED_LOG_REPORT_MS * 1000ULL;
+
+    for (int i = 0; i < DLOG_TAG_COUNT; i++) {
+        uint32_t total = g_suppressed_by_tag[i].load(std::memory_order_relaxed);
+        uint32_t fresh = total - g_reported_by_tag[i];
+        if (fresh == 0) continue;
+        if (!due) {
+            owed = true;
+            continue;
+        }
+
+        char text[64];
+        snprintf(text, sizeof(text), "%lu messages suppressed (rate limit)", (unsigned long)fresh);
+        print_line(ESP_LOG_WARN, deferred_log_tag_to_string((dlog_tag_t)i), (uint32_t)(now_us / 1000), text);
+        g_reported_by_tag[i] = total;
+    }
+    if (due) {
+        g_last_report_us = now_us;
+    }
+    return owed;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// WRITER TASK
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void emit(const log_slot_t* record) {
+    const dlog_message_info_t* info = deferred_log_message_info(record->message);
+    if (info == NULL) return;
+
+    char text[DEFERRED_LOG_LINE_SIZE];
+    deferred_log_format(record->message, record->types, record->values, record->count, text, sizeof(text));
+
+    const char* tag = deferred_log_tag_to_string(info->tag);
+    print_line(info->level, tag, record->timestamp_ms, text);
+
+    deferred_log_sink_t sink = g_sink.load(std::memory_order_acquire);
+    if (sink != NULL && esp_log_level_get(tag) >= info->level) {
+        sink(info->level, tag, record->timestamp_ms, text);
+    }
+    g_printed.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void deferred_log_task(void* pvParameters) {
+    (void)pvParameters;
+    g_last_refill_us = esp_timer_get_time();
+    g_last_report_us = g_last_refill_us;
+    log_slot_t record;
+
+    while (true) {
+        uint32_t depth = g_enqueue_position.load(std::memory_order_relaxed) - g_dequeue_position;
+        if (depth > g_max_depth.load(std::memory_order_relaxed)) {
+            g_max_depth.store(depth, std::memory_order_relaxed);
+        }
+
+        while (ring_pop(&record)) {
+            emit(&record);
+        }
+
+        uint64_t now_us = esp_timer_get_time();
+        bool pending = refill_buckets(now_us);
+        pending |= report_suppressed(now_us);
+
+        // Announce the sleep, then re-check: a record pushed after this sends a notification.
+        // A slot reserved but not yet filled is picked up on the next tick
+        g_writer_idle.store(true, std::memory_order_seq_cst);
+        TickType_t wait = pending ? pdMS_TO_TICKS(REFILL_WAIT_MS) : portMAX_DELAY;
+        if (g_enqueue_position.load(std::memory_order_seq_cst) != g_dequeue_position) {
+            wait = 1;
+        }
+        ulTaskNotifyTake(pdTRUE, wait);
+        g_writer_idle.store(false, std::memory_order_relaxed);
+    }
+}
+
+static void wake_writer(void) {
+    if (g_task_handle == NULL || !g_writer_idle.exchange(false, std::memory_order_seq_cst)) {
+        return;                         // Not started yet, or already draining
+    }
+    if (xPortInIsrContext()) {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(g_task_handle, &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    } else {
+        xTaskNotifyGive(g_task_handle);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t deferred_log_init(void) {
+    if (g_task_handle != NULL) return ESP_OK;
+    prime_buckets();
+
+    g_task_handle = xTaskCreateStaticPinnedToCore(deferred_log_task, "log_writer",
+                                                  DEFERRED_LOG_TASK_STACK, NULL,
+                                                  DEFERRED_LOG_TASK_PRIORITY, g_task_stack, &g_task_tcb,
+                                                  DEFERRED_LOG_TASK_CORE);
+    if (g_task_handle == NULL) {
+        ESP_LOGE(TAG, "Failed to create log writer task");
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Deferred logging: %d-record ring, %d-record burst then %d/s per tag",
+             DEFERRED_LOG_RING_SIZE, DEFERRED_LOG_TAG_BURST, DEFERRED_LOG_TAG_RATE_HZ);
+    return ESP_OK;
+}
+
+void deferred_log_set_sink(deferred_log_sink_t sink) {
+    g_sink.store(sink, std::memory_order_release);
+}
+
+void deferred_log_write(dlog_message_t message, const dlog_arg_t* args, uint8_t count) {
+    const dlog_message_info_t* info = deferred_log_message_info(message);
+    if (info == NULL || !level_enabled(info->level)) return;
+    if (!g_buckets_primed.load(std::memory_order_acquire)) {
+        prime_buckets();
+    }
+
+    // Errors always get through; everything else spends a token
+    if (info->level != ESP_LOG_ERROR && !take_token(info->tag)) {
+        return;
+    }
+
+    if (count > DEFERRED_LOG_MAX_ARGS) count = DEFERRED_LOG_MAX_ARGS;
+    if (!ring_push(message, args, count, (uint32_t)(esp_timer_get_time() / 1000))) {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    g_written.fetch_add(1, std::memory_order_relaxed);
+    wake_writer();
+}
+
+deferred_log_stats_t deferred_log_get_stats(void) {
+    deferred_log_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.deferred = true;
+    stats.written = g_written.load(std::memory_order_relaxed);
+    stats.printed = g_printed.load(std::memory_order_relaxed);
+    stats.dropped = g_dropped.load(std::memory_order_relaxed);
+    for (int i = 0; i < DLOG_TAG_COUNT; i++) {
+        stats.suppressed_by_tag[i] = g_suppressed_by_tag[i].load(std::memory_order_relaxed);
+        stats.suppressed += stats.suppressed_by_tag[i];
+    }
+    stats.max_depth = g_max_depth.load(std::memory_order_relaxed);
+    return stats;
+}
+
+#else // !CONFIG_TROLLEY_DEFERRED_LOG
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// INLINE FALLBACK: format in the caller, console only
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static std::atomic<uint32_t> g_printed{0};
+
+esp_err_t deferred_log_init(void) {
+    ESP_LOGI(TAG, "Deferred logging disabled: records are formatted inline");
+    return ESP_OK;
+}
+
+void deferred_log_set_sink(deferred_log_sink_t sink) {
+    (void)sink;                         // Caller context may be an ISR: no sink inline
+}
+
+void deferred_log_write(dlog_message_t message, const dlog_arg_t* args, uint8_t count) {
+    const dlog_message_info_t* info = deferred_log_message_info(message);
+    if (info == NULL || !level_enabled(info->level)) return;
+
+    if (count > DEFERRED_LOG_MAX_ARGS) count = DEFERRED_LOG_MAX_ARGS;
+    dlog_arg_type_t types[DEFERRED_LOG_MAX_ARGS];
+    dlog_value_t values[DEFERRED_LOG_MAX_ARGS];
+    for (uint8_t i = 0; i < count; i++) {
+        types[i] = args[i].type;
+        values[i] = args[i].value;
+    }
+
+    char text[DEFERRED_LOG_LINE_SIZE];
+    deferred_log_format(message, types, values, count, text, sizeof(text));
+    print_line(info->level, deferred_log_tag_to_string(info->tag), esp_log_timestamp(), text);
+    g_printed.fetch_add(1, std::memory_order_relaxed);
+}
+
+deferred_log_stats_t deferred_log_get_stats(void) {
+    deferred_log_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.written = g_printed.load(std::memory_order_relaxed);
+    stats.printed = stats.written;
+    return stats;
+}
+
+#endif // CONFIG_TROLLEY_DEFERRED_LOG
@@ -0,0 +1,277 @@
+// components/deferred_log/src/deferred_log_messages.cpp
+#include "deferred_log.h"
+#include <stdio.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DEFERRED_LOG_MESSAGES.CPP - MESSAGE TABLE AND RECORD FORMATTER
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Turn a (message ID, raw arguments) record into text
+// - Tag strings are the modules' own TAGs, so deferred lines read exactly
+//   like the ESP_LOG lines they replace
+// - Conversions are matched to the stored argument type, not trusted: a %lu
+//   fed a float still prints a number, a missing argument prints "?"
+// - No RTOS dependencies: the simulator formats with the same code
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define FORMAT_SPEC_SIZE            24          // One rewritten conversion, e.g. "%-+08.3f"
+
+static const char* const TAG_NAMES[DLOG_TAG_COUNT] = {
+    "SENSOR_HEALTH",
+    "WIRE_LEARNING",
+    "AUTOMATIC_MODE",
+    "MANUAL_MODE",
+    "WIRE_END_DET",
+    "HARDWARE_CONTROL",
+    "MODE_COORDINATOR"
+};
+
+static const dlog_message_info_t MESSAGES[] = {
+    /* NONE */                      {DLOG_TAG_HARDWARE,      ESP_LOG_NONE,    ""},
+
+    // Sensor health
+    /* SENSOR_WHEEL_ROTATION */     {DLOG_TAG_SENSOR_HEALTH, ESP_LOG_INFO,    "Wheel rotation detected! Pulses: %lu"},
+    /* SENSOR_SHAKE */              {DLOG_TAG_SENSOR_HEALTH, ESP_LOG_INFO,    "Trolley shake detected! Accel: %.2f g"},
+    /* SENSOR_IMPACT */             {DLOG_TAG_SENSOR_HEALTH, ESP_LOG_WARN,    "Impact detected: %.2f g"},
+
+    // Wire learning
+    /* WL_HOMING */                 {DLOG_TAG_WIRE_LEARNING, ESP_LOG_INFO,    "Finding the reverse wire end at %.1f m/s"},
+    /* WL_HOMING_COMPLETE */        {DLOG_TAG_WIRE_LEARNING, ESP_LOG_INFO,    "At the reverse wire end (%s) - learning starts here"},
+    /* WL_TESTING_SPEED */          {DLOG_TAG_WIRE_LEARNING, ESP_LOG_INFO,    "Testing speed: %.1f m/s"},
+    /* WL_SPEED_SET_FAILED */       {DLOG_TAG_WIRE_LEARNING, ESP_LOG_ERROR,   "Failed to set motor speed"},
+    /* WL_SPEED_VALIDATED */        {DLOG_TAG_WIRE_LEARNING, ESP_LOG_INFO,    "Speed %.1f m/s validated (%lu pulses in %lu ms)"},
+    /* WL_SPEED_TIMEOUT */          {DLOG_TAG_WIRE_LEARNING, ESP_LOG_WARN,    "Speed %.1f m/s failed validation (timeout: %lu pulses in %lu ms)"},
+    /* WL_SPEED_FAILED */           {DLOG_TAG_WIRE_LEARNING, ESP_LOG_ERROR,   "Speed %.1f m/s failed validation again (%lu pulses in %lu ms) - stopping"},
+    /* WL_MAX_SPEED */              {DLOG_TAG_WIRE_LEARNING, ESP_LOG_INFO,    "Maximum learning speed reached: %.1f m/s"},
+    /* WL_WIRE_END */               {DLOG_TAG_WIRE_LEARNING, ESP_LOG_INFO,    "Wire end detected: %s (confidence %.2f, peak %.2f g)"},
+    /* WL_COAST_PLANNED */          {DLOG_TAG_WIRE_LEARNING, ESP_LOG_INFO,    "Coasting calibration: accelerating to %.1f m/s with %.1f m to the wire end"},
+    /* WL_COAST_SKIPPED */          {DLOG_TAG_WIRE_LEARNING, ESP_LOG_WARN,    "Coasting calibration skipped: %.1f m to the wire end is too short"},
+    /* WL_COAST_START */            {DLOG_TAG_WIRE_LEARNING, ESP_LOG_INFO,    "Reached %.1f m/s - starting coast measurement"},
+    /* WL_COAST_ACCEL_TIMEOUT */    {DLOG_TAG_WIRE_LEARNING, ESP_LOG_WARN,    "Coasting calibration abandoned: %.1f of %.1f m/s reached in time"},
+    /* WL_COAST_ABORTED */          {DLOG_TAG_WIRE_LEARNING, ESP_LOG_WARN,    "Coasting calibration aborted by a wire end"},
+    /* WL_COAST_TIMEOUT */          {DLOG_TAG_WIRE_LEARNING, ESP_LOG_WARN,    "Coasting calibration timeout"},
+    /* WL_COAST_COMPLETE */         {DLOG_TAG_WIRE_LEARNING, ESP_LOG_INFO,    "Coasting calibration complete: %.2f m in %lu ms, deceleration %.2f m/s², coast start %.2f m"},
+    /* WL_FORWARD_COMPLETE */       {DLOG_TAG_WIRE_LEARNING, ESP_LOG_INFO,    "Forward direction complete: %.2f m (%lu rotations)"},
+    /* WL_REVERSE_COMPLETE */       {DLOG_TAG_WIRE_LEARNING, ESP_LOG_INFO,    "Reverse direction complete: %.2f m (%lu rotations)"},
+    /* WL_SUCCESS */                {DLOG_TAG_WIRE_LEARNING, ESP_LOG_INFO,    "=== WIRE LEARNING SUCCESSFUL === Wire Length: %.2f m, Optimal Speed: %.1f m/s, Cruise Speed: %.1f m/s, Accuracy: %.1f%%"},
+    /* WL_FAILED */                 {DLOG_TAG_WIRE_LEARNING, ESP_LOG_ERROR,   "Wire learning failed: Forward %.2f m, Reverse %.2f m (%.1f%% difference)"},
+
+    // Automatic mode
+    /* AUTO_COAST_TRACE_UNUSED */   {DLOG_TAG_AUTOMATIC,     ESP_LOG_DEBUG,   "Coast trace not used for refit: %s"},
+    /* AUTO_COAST_MODEL */          {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "Coast model %s: %.3f + %.4f v^2 m/s^2 (fit #%u, residual %.3f)"},
+    /* AUTO_COAST_CAL_STOP */       {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "Reached %.1f m/s - stopping motor for coasting measurement"},
+    /* AUTO_COAST_OUT_OF_RANGE */   {DLOG_TAG_AUTOMATIC,     ESP_LOG_WARN,    "Coasting distance out of expected range: %.2f m"},
+    /* AUTO_COAST_CAL_COMPLETE */   {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "=== COASTING CALIBRATION COMPLETE === %.2f m in %lu ms, deceleration %.2f m/s², coast start %.2f m from wire end"},
+    /* AUTO_SLOW_ZONE_UNTRACKED */  {DLOG_TAG_AUTOMATIC,     ESP_LOG_DEBUG,   "Slow zone at %.1f m not tracked (%d pending)"},
+    /* AUTO_SAFETY_FAILED */        {DLOG_TAG_AUTOMATIC,     ESP_LOG_WARN,    "Safety check failed during planned motion"},
+    /* AUTO_RAMP_COMPLETE */        {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "Speed ramp to %.1f m/s complete"},
+    /* AUTO_RUN_OVERRUN */          {DLOG_TAG_AUTOMATIC,     ESP_LOG_WARN,    "Run plan overrun: %.2f m left at %.2f m/s - coasting now"},
+    /* AUTO_RUN_PLAN_FAILED */      {DLOG_TAG_AUTOMATIC,     ESP_LOG_ERROR,   "Failed to plan run"},
+    /* AUTO_RUN_PLANNED */          {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "Planned run: %.1f m, peak %.2f m/s, %.1f s"},
+    /* AUTO_REPLANNING */           {DLOG_TAG_AUTOMATIC,     ESP_LOG_DEBUG,   "Replanning: position error %.2f m, speed error %.2f m/s%s"},
+    /* AUTO_CRUISE_TARGET */        {DLOG_TAG_AUTOMATIC,     ESP_LOG_DEBUG,   "Cruise speed target: %.1f m/s"},
+    /* AUTO_WIRE_END */             {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "Wire end detected: %s (confidence %.2f, peak %.2f g)"},
+    /* AUTO_COAST_WIRE_END */       {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "Wire end reached via coasting - speed: %.2f m/s"},
+    /* AUTO_ESC_ARMED */            {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "ESC auto-armed successfully"},
+    /* AUTO_EMERGENCY */            {DLOG_TAG_AUTOMATIC,     ESP_LOG_ERROR,   "EMERGENCY: %s"},
+    /* AUTO_WIRE_END_REACHED */     {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "Wire end reached - completing current run"},
+    /* AUTO_SEEKING */              {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "Seeking the wire end at %.1f m/s"},
+    /* AUTO_SEEK_STALLED */         {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "No Hall edge toward the wire end - already there"},
+    /* AUTO_SEEK_TIMEOUT */         {DLOG_TAG_AUTOMATIC,     ESP_LOG_ERROR,   "Wire end not reached within %.0f s"},
+    /* AUTO_RUN_COMPLETE */         {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "%s run %lu complete: %.2f m"},
+    /* AUTO_CYCLE_COMPLETE */       {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "=== CYCLE %lu COMPLETE === %.1f s"},
+    /* AUTO_FINISHED */             {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "Automatic mode finished after %lu cycles"},
+    /* AUTO_COAST_CAL_SKIPPED */    {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "Coasting already calibrated - skipping"},
+    /* AUTO_COAST_CAL_FAILED */     {DLOG_TAG_AUTOMATIC,     ESP_LOG_ERROR,   "Failed to plan the coasting calibration run"},
+    /* AUTO_COAST_CAL_START */      {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "Starting coasting calibration run at %.1f m/s"},
+    /* AUTO_SPEED_CLAMPED */        {DLOG_TAG_AUTOMATIC,     ESP_LOG_WARN,    "Target speed %.1f m/s exceeds maximum %.1f m/s"},
+    /* AUTO_ACCELERATING */         {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "Starting jerk-limited acceleration to %.1f m/s"},
+    /* AUTO_ACCEL_FAILED */         {DLOG_TAG_AUTOMATIC,     ESP_LOG_ERROR,   "Failed to start acceleration"},
+    /* AUTO_DECELERATING */         {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "Starting deceleration to %.1f m/s"},
+    /* AUTO_DECEL_NOT_NEEDED */     {DLOG_TAG_AUTOMATIC,     ESP_LOG_WARN,    "Already at or below target speed"},
+    /* AUTO_STOP_GRACEFUL */        {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "Graceful stop requested - will finish current run"},
+    /* AUTO_INTERRUPTED */          {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "Immediate interruption requested"},
+    /* AUTO_DISARMING */            {DLOG_TAG_AUTOMATIC,     ESP_LOG_INFO,    "Auto-disarming ESC"},
+
+    // Manual mode
+    /* MANUAL_SENSORS_INVALID */    {DLOG_TAG_MANUAL,        ESP_LOG_WARN,    "Sensors no longer validated"},
+    /* MANUAL_EXCESSIVE_IMPACT */   {DLOG_TAG_MANUAL,        ESP_LOG_WARN,    "Excessive impact detected"},
+    /* MANUAL_HALL_SILENT */        {DLOG_TAG_MANUAL,        ESP_LOG_WARN,    "Hall sensor not responding during movement"},
+    /* MANUAL_IMPACT */             {DLOG_TAG_MANUAL,        ESP_LOG_WARN,    "Impact detected: %.2f g > %.2f g threshold"},
+    /* MANUAL_HALL_NO_MOVEMENT */   {DLOG_TAG_MANUAL,        ESP_LOG_WARN,    "Hall sensor validation failed - no movement detected"},
+    /* MANUAL_ESC_NOT_RESPONDING */ {DLOG_TAG_MANUAL,        ESP_LOG_WARN,    "ESC not responding"},
+    /* MANUAL_ESC_ARMED */          {DLOG_TAG_MANUAL,        ESP_LOG_INFO,    "ESC armed successfully in manual mode"},
+    /* MANUAL_SAFETY_STOP */        {DLOG_TAG_MANUAL,        ESP_LOG_WARN,    "Safety check failed - stopping manual mode"},
+    /* MANUAL_EMERGENCY */          {DLOG_TAG_MANUAL,        ESP_LOG_WARN,    "EMERGENCY STOP activated in manual mode"},
+
+    // Wire end detector
+    /* WIRE_END_EVENT */            {DLOG_TAG_WIRE_END,      ESP_LOG_INFO,    "Wire end: %s, confidence %.2f, peak %.2f g, %lu ms past the expected edge"},
+    /* WIRE_END_FALSE */            {DLOG_TAG_WIRE_END,      ESP_LOG_WARN,    "Wire end event was false: %.2f m travelled past it"},
+
+    // Hardware control
+    /* HW_SPEED_SET */              {DLOG_TAG_HARDWARE,      ESP_LOG_DEBUG,   "Motor speed set: %.2f m/s %s (%s)"},
+    /* HW_ESC_ARMING */             {DLOG_TAG_HARDWARE,      ESP_LOG_INFO,    "Arming ESC (%lu ms sequence)..."},
+    /* HW_ESC_ARMED */              {DLOG_TAG_HARDWARE,      ESP_LOG_INFO,    "ESC armed successfully"},
+    /* HW_ESC_DISARMED */           {DLOG_TAG_HARDWARE,      ESP_LOG_INFO,    "ESC disarmed"},
+    /* HW_EMERGENCY_STOP */         {DLOG_TAG_HARDWARE,      ESP_LOG_WARN,    "EMERGENCY STOP activated"},
+
+    // Mode coordinator
+    /* COORD_COASTING_SET */        {DLOG_TAG_COORDINATOR,   ESP_LOG_INFO,    "Coasting data set: %.2f m coasting distance"},
+    /* COORD_ERROR */               {DLOG_TAG_COORDINATOR,   ESP_LOG_WARN,    "System error reported: %s (count: %lu)"},
+    /* COORD_CAL_VERIFIED */        {DLOG_TAG_COORDINATOR,   ESP_LOG_INFO,    "Stored calibration verified: run %.2f m vs stored %.2f m (%.1f%%)"},
+    /* COORD_CAL_REJECTED */        {DLOG_TAG_COORDINATOR,   ESP_LOG_WARN,    "Stored calibration rejected: run %.2f m vs stored %.2f m (%.1f%%)"},
+    /* COORD_STOPPING */            {DLOG_TAG_COORDINATOR,   ESP_LOG_INFO,    "Stopping current mode (%s)"},
+    /* COORD_EMERGENCY_STOP */      {DLOG_TAG_COORDINATOR,   ESP_LOG_WARN,    "EMERGENCY STOP activated - stopping all modes"},
+};
+
+static_assert(sizeof(MESSAGES) / sizeof(MESSAGES[0]) == DLOG_MSG_COUNT,
+              "deferred log message table out of step with dlog_message_t");
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// TABLE LOOKUP
+// ═══════════════════════════════════════════════════════════════════════════════
+
+const dlog_message_info_t* deferred_log_message_info(dlog_message_t message) {
+    if (message == DLOG_MSG_NONE || message >= DLOG_MSG_COUNT) {
+        return NULL;
+    }
+    return &MESSAGES[message];
+}
+
+const char* deferred_log_tag_to_string(dlog_tag_t tag) {
+    return tag < DLOG_TAG_COUNT ? TAG_NAMES[tag] : "LOG";
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FORMATTER
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Append one snprintf result, keeping the running length clamped
+ */
+static void append_result(int written, size_t* length, size_t size) {
+    if (written <= 0) {
+        return;
+    }
+    *length += (size_t)written;
+    if (*length > size - 1) {
+        *length = size - 1;
+    }
+}
+
+size_t deferred_log_format(dlog_message_t message, const dlog_arg_type_t* types,
+                           const dlog_value_t* values, uint8_t count, char* buffer, size_t size) {
+    if (buffer == NULL || size == 0) {
+        return 0;
+    }
+    buffer[0] = '\0';
+
+    const dlog_message_info_t* info = deferred_log_message_info(message);
+    if (info == NULL) {
+        snprintf(buffer, size, "<unknown log message %u>", (unsigned)message);
+        return strlen(buffer);
+    }
+
+    size_t length = 0;
+    uint8_t arg = 0;
+    const char* p = info->format;
+
+    while (*p != '\0' && length < size - 1) {
+        if (*p != '%') {
+            buffer[length++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            buffer[length++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // Copy flags, width and precision; drop length modifiers
+        char spec[FORMAT_SPEC_SIZE];
+        size_t spec_length = 0;
+        spec[spec_length++] = *p++;
+        while (*p != '\0' && strchr("-+ #0123456789.", *p) != NULL && spec_length < FORMAT_SPEC_SIZE - 4) {
+            spec[spec_length++] = *p++;
+        }
+        while (*p != '\0' && strchr("hlzjt", *p) != NULL) {
+            p++;
+        }
+        char conversion = *p;
+        if (conversion == '\0') {
+            break;
+        }
+        p++;
+
+        if (arg >= count) {
+            buffer[length++] = '?';
+            continue;
+        }
+        dlog_arg_type_t type = types[arg];
+        dlog_value_t value = values[arg];
+        arg++;
+
+        char* out = buffer + length;
+        size_t room = size - length;
+        int written = 0;
+
+        switch (conversion) {
+            case 'd':
+            case 'i': {
+                long number = type == DLOG_ARG_FLOAT ? (long)value.f :
+                              type == DLOG_ARG_UINT  ? (long)value.u : (long)value.i;
+                spec[spec_length++] = 'l';
+                spec[spec_length++] = 'd';
+                spec[spec_length] = '\0';
+                written = snprintf(out, room, spec, number);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o': {
+                unsigned long number = type == DLOG_ARG_FLOAT ? (unsigned long)value.f :
+                                       type == DLOG_ARG_INT   ? (unsigned long)value.i : (unsigned long)value.u;
+                spec[spec_length++] = 'l';
+                spec[spec_length++] = conversion;
+                spec[spec_length] = '\0';
+                written = snprintf(out, room, spec, number);
+                break;
+            }
+            case 'c': {
+                spec[spec_length++] = 'c';
+                spec[spec_length] = '\0';
+                written = snprintf(out, room, spec, (int)(type == DLOG_ARG_INT ? value.i : (int32_t)value.u));
+                break;
+            }
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G': {
+                double number = type == DLOG_ARG_FLOAT ? (double)value.f :
+                                type == DLOG_ARG_INT   ? (double)value.i : (double)value.u;
+                spec[spec_length++] = conversion;
+                spec[spec_length] = '\0';
+                written = snprintf(out, room, spec, number);
+                break;
+            }
+            case 's': {
+                const char* text = type == DLOG_ARG_STR ? value.s : NULL;
+                spec[spec_length++] = 's';
+                spec[spec_length] = '\0';
+                written = snprintf(out, room, spec, text != NULL ? text : "(null)");
+                break;
+            }
+            default:
+                buffer[length++] = '?';
+                break;
+        }
+        append_result(written, &length, size);
+    }
+
+    buffer[length] = '\0';
+    return length;
+}
@@ -0,0 +1,181 @@
+// components/fleet_link/include/fleet_link.h
+#ifndef FLEET_LINK_H
+#define FLEET_LINK_H
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include "telemetry_frame.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FLEET_LINK.H - TROLLEY-TO-TROLLEY STATE SHARING AND COMMAND RELAY (ESP-NOW)
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Let every unit see and command every other unit
+// - Each unit broadcasts its newest telemetry_frame_t (26 bytes, same record
+//   as /ws and the serial stream) at FLEET_STATE_RATE_HZ over ESP-NOW on the
+//   AP channel: no router, no station mode, the APs stay up
+// - Peers heard within FLEET_PEER_TIMEOUT_MS form the fleet table, so the web
+//   UI of whichever trolley a phone joined is a dashboard for all of them
+// - Commands (the web command characters) are relayed to one unit or all:
+//   repeated every FLEET_COMMAND_RETRY_MS until acknowledged, de-duplicated
+//   by the receiver, which re-sends its stored acknowledgement for a repeat
+// - Coordinated start: a command with a start time runs on every target at
+//   the same instant (each copy carries the time remaining, so the repeats
+//   do not shift it); worst-case skew is one ESP-NOW frame plus a task wake
+//
+// Broadcast ESP-NOW is neither encrypted nor authenticated: CONFIG_TROLLEY_FLEET_ID
+// only keeps neighbouring fleets apart. By default (CONFIG_TROLLEY_FLEET_ACCEPT_COMMANDS=n)
+// a unit shares its state and relays commands, but runs no relayed command
+// other than an emergency stop. An emergency stop, relayed or local, also
+// cancels a coordinated start still waiting on this unit.
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#if CONFIG_TROLLEY_FLEET
+#define FLEET_ENABLED               1
+#else
+#define FLEET_ENABLED               0
+#endif
+
+// Link configuration
+#define FLEET_PROTOCOL_VERSION      1           // Bumped on any message layout change
+#define FLEET_MAX_PEERS             8           // Other units tracked
+#define FLEET_STATE_RATE_HZ         5           // State broadcasts per second
+#define FLEET_PEER_TIMEOUT_MS       2000        // Silence after which a peer is dropped
+#define FLEET_COMMAND_RETRY_MS      30          // Relay repeat interval
+#define FLEET_COMMAND_ATTEMPTS      4           // Relay sends before giving up
+#define FLEET_SYNC_START_LEAD_MS    400         // Default lead time of a coordinated start (> all attempts)
+#define FLEET_SYNC_START_MAX_MS     5000        // Longest accepted start delay
+#define FLEET_RELAY_QUEUE_DEPTH     4           // Relays waiting behind the one in flight
+#define FLEET_RELAY_RESULTS         8           // Acknowledgements kept for the UI
+#define FLEET_RESPONSE_SIZE         48          // Acknowledgement message bytes
+
+// Task configuration
+#define FLEET_TASK_STACK            4096        // Runs relayed commands (web command handler)
+#define FLEET_TASK_PRIORITY         6           // Above httpd: coordinated starts wake on time
+#define FLEET_TASK_CORE             0           // With WiFi
+#define FLEET_RX_QUEUE_DEPTH        16          // Received frames waiting for the task
+
+#define FLEET_UNIT_ALL              0           // Target: every unit, this one included
+
+/**
+ * @brief Runs one command character (web_process_command() signature)
+ */
+typedef esp_err_t (*fleet_command_handler_t)(char command, const char* source,
+                                             char* response, size_t response_size);
+
+/**
+ * @brief Another unit as last heard
+ */
+typedef struct {
+    uint32_t unit_id;                   // Low 3 bytes of the unit's MAC
+    int8_t rssi;                        // dBm of the last frame
+    uint32_t age_ms;                    // Since the last state broadcast
+    uint32_t states_received;
+    uint32_t states_lost;               // Gaps in the broadcast sequence
+    telemetry_frame_t state;            // Newest telemetry record
+} fleet_peer_t;
+
+/**
+ * @brief Acknowledgement of a relayed command
+ */
+typedef struct {
+    uint16_t sequence;                  // Relay sequence from fleet_link_send_command()
+    uint32_t unit_id;                   // Unit that answered
+    char command;
+    esp_err_t result;                   // ESP_ERR_TIMEOUT: no acknowledgement
+    uint32_t latency_ms;                // First send to acknowledgement
+    char message[FLEET_RESPONSE_SIZE];
+} fleet_relay_result_t;
+
+/**
+ * @brief Link counters since boot
+ */
+typedef struct {
+    bool running;
+    uint32_t unit_id;
+    uint32_t frames_sent;
+    uint32_t frames_received;
+    uint32_t frames_ignored;            // Other fleet, other version, malformed
+    uint32_t rx_dropped;                // Receive queue full
+    uint32_t send_failures;
+    uint32_t commands_relayed;          // Relays started here
+    uint32_t commands_run;              // Relayed commands run here
+    uint32_t commands_refused;          // CONFIG_TROLLEY_FLEET_ACCEPT_COMMANDS=n
+    uint32_t sync_starts;               // Coordinated starts run here
+} fleet_stats_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// LIFECYCLE API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Start ESP-NOW and the fleet task
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED with CONFIG_TROLLEY_FLEET=n
+ * @note WiFi must be started (AP up); the AP channel is the fleet channel
+ */
+esp_err_t fleet_link_init(void);
+
+/**
+ * @brief Set what runs relayed commands (before or after init)
+ * @param handler Command handler, NULL to refuse relayed commands
+ */
+void fleet_link_set_command_handler(fleet_command_handler_t handler);
+
+/**
+ * @brief Drop a coordinated start still waiting on this unit (any task)
+ * @note Registered with command_queue_set_emergency_hook(): a local emergency
+ *       stop must not be followed by a start that was scheduled before it
+ */
+void fleet_link_cancel_scheduled_start(void);
+
+/**
+ * @brief This unit's ID
+ * @return Low 3 bytes of the WiFi MAC, 0 before init
+ */
+uint32_t fleet_link_get_unit_id(void);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FLEET API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Copy the peers heard within FLEET_PEER_TIMEOUT_MS
+ * @param peers Output array
+ * @param max_peers Capacity of peers
+ * @return Number of peers copied
+ */
+size_t fleet_link_get_peers(fleet_peer_t* peers, size_t max_peers);
+
+/**
+ * @brief Relay a command to one unit or all of them
+ * @param unit_id Target unit, FLEET_UNIT_ALL for every unit including this one
+ * @param command Web command character
+ * @param start_in_ms 0 = run on receipt, otherwise run this many ms from now
+ *        on every target at once (coordinated start)
+ * @param sequence Set to the relay sequence for fleet_link_get_relay_results() (may be NULL)
+ * @return ESP_OK if handed to the fleet task, ESP_ERR_INVALID_STATE if not running,
+ *         ESP_ERR_INVALID_ARG for a start delay over FLEET_SYNC_START_MAX_MS,
+ *         ESP_ERR_NO_MEM if the link is backed up
+ * @note Relays go out one at a time in order; 'E' jumps the line and cancels
+ *       the rest, like the command queue's emergency lane
+ */
+esp_err_t fleet_link_send_command(uint32_t unit_id, char command, uint32_t start_in_ms, uint16_t* sequence);
+
+/**
+ * @brief Copy the newest relay acknowledgements, newest first
+ * @param results Output array
+ * @param max_results Capacity of results
+ * @return Number copied
+ */
+size_t fleet_link_get_relay_results(fleet_relay_result_t* results, size_t max_results);
+
+/**
+ * @brief Get link counters
+ * @return fleet_stats_t structure
+ */
+fleet_stats_t fleet_link_get_stats(void);
+
+#endif // FLEET_LINK_H
@@ -0,0 +1,770 @@
+// components/fleet_link/src/fleet_link.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// FLEET_LINK.CPP - ESP-NOW STATE BROADCAST, COMMAND RELAY, COORDINATED START
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// One task owns the link. Everything else reaches it through one queue:
+// - ESP-NOW receive callback (WiFi task): copies the frame, never parses it
+// - fleet_link_send_command() (httpd): a relay request
+// - coordinated start timer (esp_timer task): "start is due"
+// The pending coordinated start itself is atomic: an emergency stop on any
+// task cancels it without waiting for the queue.
+// The task sleeps on that queue until the next state broadcast or relay
+// repeat is due. The peer table and relay results are shared with readers
+// under g_lock; the relay FIFO and dedup state are the task's alone.
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "fleet_link.h"
+
+#if FLEET_ENABLED
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "esp_now.h"
+#include "esp_random.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+static const char* TAG = "FLEET";
+
+#define FLEET_MAGIC                 0xF7
+#define FLEET_STATE_INTERVAL_US     (1000000 / FLEET_STATE_RATE_HZ)
+#define FLEET_MAX_MESSAGE           80          // Largest message below (ESP-NOW allows 250)
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// WIRE FORMAT (packed little-endian, FLEET_PROTOCOL_VERSION)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef enum {
+    FLEET_MSG_STATE = 1,                // Newest telemetry record
+    FLEET_MSG_COMMAND,                  // Relayed command
+    FLEET_MSG_ACK                       // Command acknowledgement
+} fleet_msg_type_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t magic;                      // FLEET_MAGIC
+    uint8_t version;                    // FLEET_PROTOCOL_VERSION
+    uint8_t fleet_id;                   // CONFIG_TROLLEY_FLEET_ID
+    uint8_t type;                       // fleet_msg_type_t
+    uint32_t unit_id;                   // Sender
+    uint16_t sequence;                  // Per sender and type (STATE: gaps = lost)
+} fleet_msg_header_t;
+
+typedef struct __attribute__((packed)) {
+    fleet_msg_header_t header;
+    uint8_t state[TELEMETRY_FRAME_SIZE];            // telemetry_frame_encode()
+} fleet_msg_state_t;
+
+typedef struct __attribute__((packed)) {
+    fleet_msg_header_t header;                      // sequence = relay sequence
+    uint32_t target;                                // Unit ID or FLEET_UNIT_ALL
+    char command;
+    uint8_t attempt;
+    uint32_t start_in_us;                           // Until a coordinated start, 0 = now
+} fleet_msg_command_t;
+
+typedef struct __attribute__((packed)) {
+    fleet_msg_header_t header;
+    uint32_t origin;                                // Unit that relayed the command
+    uint16_t relay_sequence;
+    char command;
+    uint8_t reserved;
+    int32_t result;                                 // esp_err_t
+    char message[FLEET_RESPONSE_SIZE];
+} fleet_msg_ack_t;
+
+static_assert(sizeof(fleet_msg_ack_t) <= FLEET_MAX_MESSAGE, "fleet message too large");
+static_assert(sizeof(fleet_msg_state_t) <= FLEET_MAX_MESSAGE, "fleet message too large");
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// TASK QUEUE ITEMS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef enum {
+    FLEET_ITEM_FRAME = 0,               // Received ESP-NOW frame
+    FLEET_ITEM_RELAY,                   // fleet_link_send_command()
+    FLEET_ITEM_SYNC_DUE                 // Coordinated start timer fired
+} fleet_item_kind_t;
+
+typedef struct {
+    uint8_t kind;                       // fleet_item_kind_t
+    int8_t rssi;
+    uint8_t length;
+    uint64_t received_us;
+    union {
+        uint8_t data[FLEET_MAX_MESSAGE];
+        struct {
+            uint32_t target;
+            uint32_t start_in_ms;
+            uint16_t sequence;
+            char command;
+        } relay;
+    };
+} fleet_item_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STATE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    bool used;
+    uint32_t unit_id;
+    int8_t rssi;
+    uint64_t last_heard_us;
+    uint64_t last_state_us;
+    bool have_state;
+    uint16_t last_state_sequence;
+    uint32_t states_received;
+    uint32_t states_lost;
+    telemetry_frame_t state;
+    // Receiver side: the newest relay from this unit, for de-duplication
+    bool have_relay;
+    uint16_t last_relay_sequence;
+    fleet_msg_ack_t last_ack;
+} fleet_peer_entry_t;
+
+typedef struct {
+    bool active;
+    fleet_msg_command_t message;
+    uint64_t first_sent_us;
+    uint64_t next_send_us;
+    uint64_t start_at_us;               // Coordinated start deadline, 0 = none
+    uint32_t acked_mask;                // Peer slots that answered
+} fleet_relay_t;
+
+static QueueHandle_t g_items = NULL;
+static SemaphoreHandle_t g_lock = NULL;             // g_peers, g_results
+static esp_timer_handle_t g_sync_timer = NULL;
+static std::atomic<char> g_sync_command{0};         // Command waiting for the start timer
+static fleet_command_handler_t g_handler = NULL;
+static uint32_t g_unit_id = 0;
+static std::atomic<uint16_t> g_next_relay_sequence{0};
+static std::atomic<uint32_t> g_rx_dropped{0};
+
+static fleet_peer_entry_t g_peers[FLEET_MAX_PEERS];
+static fleet_relay_result_t g_results[FLEET_RELAY_RESULTS];
+static uint32_t g_result_count = 0;                 // Results ever recorded
+static fleet_stats_t g_stats = {};
+static StackType_t g_task_stack[FLEET_TASK_STACK];
+static StaticTask_t g_task_tcb;
+
+// Fleet task only
+static fleet_relay_t g_relay = {};                  // In flight
+static fleet_item_t g_relay_fifo[FLEET_RELAY_QUEUE_DEPTH];
+static uint32_t g_relay_fifo_head = 0;
+static uint32_t g_relay_fifo_count = 0;
+static uint16_t g_state_sequence = 0;
+static uint16_t g_ack_sequence = 0;
+
+static const uint8_t k_broadcast_mac[ESP_NOW_ETH_ALEN] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+
+static const char* source_label(uint32_t unit_id, char* buffer, size_t size) {
+    snprintf(buffer, size, "fleet:%06lX", (unsigned long)unit_id);
+    return buffer;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SENDING
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void fill_header(fleet_msg_header_t* header, fleet_msg_type_t type, uint16_t sequence) {
+    header->magic = FLEET_MAGIC;
+    header->version = FLEET_PROTOCOL_VERSION;
+    header->fleet_id = CONFIG_TROLLEY_FLEET_ID;
+    header->type = type;
+    header->unit_id = g_unit_id;
+    header->sequence = sequence;
+}
+
+static void send_frame(const void* message, size_t length) {
+    if (esp_now_send(k_broadcast_mac, (const uint8_t*)message, length) == ESP_OK) {
+        g_stats.frames_sent++;
+    } else {
+        g_stats.send_failures++;
+    }
+}
+
+static void broadcast_state(void) {
+    telemetry_frame_t frame;
+    if (telemetry_frame_get_latest(&frame) != ESP_OK) return;      // Control loop not up yet
+
+    fleet_msg_state_t message;
+    fill_header(&message.header, FLEET_MSG_STATE, g_state_sequence++);
+    telemetry_frame_encode(&frame, message.state, sizeof(message.state));
+    send_frame(&message, sizeof(message));
+}
+
+static void record_result(uint16_t sequence, uint32_t unit_id, char command, esp_err_t result,
+                          uint32_t latency_ms, const char* message) {
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+    fleet_relay_result_t* slot = &g_results[g_result_count % FLEET_RELAY_RESULTS];
+    slot->sequence = sequence;
+    slot->unit_id = unit_id;
+    slot->command = command;
+    slot->result = result;
+    slot->latency_ms = latency_ms;
+    strncpy(slot->message, message ? message : "", sizeof(slot->message) - 1);
+    slot->message[sizeof(slot->message) - 1] = '\0';
+    g_result_count++;
+    xSemaphoreGive(g_lock);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// RUNNING COMMANDS HERE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static bool is_emergency_stop(char command) {
+    return command == 'E' || command == 'e';
+}
+
+static esp_err_t run_command(char command, uint32_t origin, char* response, size_t size) {
+    char source[16];
+#if !CONFIG_TROLLEY_FLEET_ACCEPT_COMMANDS
+    if (!is_emergency_stop(command)) {
+        g_stats.commands_refused++;
+        snprintf(response, size, "❌ Relayed commands disabled on this unit");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+#endif
+    fleet_command_handler_t handler = g_handler;
+    if (handler == NULL) {
+        snprintf(response, size, "❌ No command handler");
+        return ESP_ERR_INVALID_STATE;
+    }
+    g_stats.commands_run++;
+    return handler(command, source_label(origin, source, sizeof(source)), response, size);
+}
+
+static void sync_timer_callback(void* arg) {
+    (void)arg;
+    fleet_item_t item;
+    item.kind = FLEET_ITEM_SYNC_DUE;
+    xQueueSendToFront(g_items, &item, 0);
+}
+
+// A newer coordinated start replaces a pending one
+static esp_err_t schedule_start(char command, uint64_t start_at_us, char* response, size_t size) {
+    uint64_t now_us = esp_timer_get_time();
+    uint64_t delay_us = start_at_us > now_us ? start_at_us - now_us : 1;
+    esp_timer_stop(g_sync_timer);
+    g_sync_command.store(command, std::memory_order_release);
+    esp_err_t result = esp_timer_start_once(g_sync_timer, delay_us);
+    snprintf(response, size, result == ESP_OK ? "⏱ '%c' in %lu ms" : "❌ Cannot schedule '%c'",
+             command, (unsigned long)(delay_us / 1000));
+    return result;
+}
+
+static void run_scheduled_start(void) {
+    // Cancelled after the timer fired: nothing to run
+    char command = g_sync_command.exchange(0, std::memory_order_acq_rel);
+    if (command == 0) return;
+
+    char response[FLEET_RESPONSE_SIZE];
+    esp_err_t result = run_command(command, g_unit_id, response, sizeof(response));
+    g_stats.sync_starts++;
+    ESP_LOGI(TAG, "Coordinated '%c': %s", command, esp_err_to_name(result));
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PEER TABLE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Caller holds g_lock. Finds the unit's slot or takes the stalest one
+static int peer_slot_locked(uint32_t unit_id, uint64_t now_us) {
+    int free_slot = -1;
+    int stalest = 0;
+    for (int i = 0; i < FLEET_MAX_PEERS; i++) {
+        if (g_peers[i].used && g_peers[i].unit_id == unit_id) return i;
+        if (!g_peers[i].used || now_us - g_peers[i].last_heard_us > FLEET_PEER_TIMEOUT_MS * 1000ULL) {
+            if (free_slot < 0) free_slot = i;
+        } else if (g_peers[i].last_heard_us < g_peers[stalest].last_heard_us) {
+            stalest = i;
+        }
+    }
+    int slot = free_slot >= 0 ? free_slot : stalest;
+    memset(&g_peers[slot], 0, sizeof(g_peers[slot]));
+    g_peers[slot].used = true;
+    g_peers[slot].unit_id = unit_id;
+    return slot;
+}
+
+static void handle_state(const fleet_item_t* item, const fleet_msg_state_t* message) {
+    telemetry_frame_t frame;
+    if (telemetry_frame_decode(message->state, sizeof(message->state), &frame) != ESP_OK) {
+        g_stats.frames_ignored++;
+        return;
+    }
+
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+    fleet_peer_entry_t* peer = &g_peers[peer_slot_locked(message->header.unit_id, item->received_us)];
+    if (peer->have_state) {
+        uint16_t gap = (uint16_t)(message->header.sequence - peer->last_state_sequence);
+        if (gap > 1 && gap < 0x8000) peer->states_lost += gap - 1;
+    }
+    peer->have_state = true;
+    peer->last_state_sequence = message->header.sequence;
+    peer->states_received++;
+    peer->state = frame;
+    peer->rssi = item->rssi;
+    peer->last_heard_us = item->received_us;
+    peer->last_state_us = item->received_us;
+    xSemaphoreGive(g_lock);
+}
+
+static void handle_command(const fleet_item_t* item, const fleet_msg_command_t* message) {
+    uint32_t origin = message->header.unit_id;
+    if (message->target != FLEET_UNIT_ALL && message->target != g_unit_id) return;
+
+    // Repeat of the newest relay from this unit: answer again, run nothing
+    fleet_msg_ack_t ack;
+    bool repeat = false;
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+    fleet_peer_entry_t* peer = &g_peers[peer_slot_locked(origin, item->received_us)];
+    peer->last_heard_us = item->received_us;
+    peer->rssi = item->rssi;
+    if (peer->have_relay && peer->last_relay_sequence == message->header.sequence) {
+        ack = peer->last_ack;
+        repeat = true;
+    }
+    xSemaphoreGive(g_lock);
+
+    if (!repeat) {
+        memset(&ack, 0, sizeof(ack));
+        ack.origin = origin;
+        ack.relay_sequence = message->header.sequence;
+        ack.command = message->command;
+        if (is_emergency_stop(message->command)) {
+            // Never delayed, and whatever was scheduled here is off
+            fleet_link_cancel_scheduled_start();
+            ack.result = run_command(message->command, origin, ack.message, sizeof(ack.message));
+        } else if (message->start_in_us > FLEET_SYNC_START_MAX_MS * 1000UL) {
+            ack.result = ESP_ERR_INVALID_ARG;
+            snprintf(ack.message, sizeof(ack.message), "❌ Start delay too long");
+        } else if (message->start_in_us > 0) {
+            ack.result = schedule_start(message->command, item->received_us + message->start_in_us,
+                                        ack.message, sizeof(ack.message));
+        } else {
+            ack.result = run_command(message->command, origin, ack.message, sizeof(ack.message));
+        }
+
+        xSemaphoreTake(g_lock, portMAX_DELAY);
+        peer = &g_peers[peer_slot_locked(origin, item->received_us)];
+        peer->have_relay = true;
+        peer->last_relay_sequence = message->header.sequence;
+        peer->last_ack = ack;
+        xSemaphoreGive(g_lock);
+    }
+
+    fill_header(&ack.header, FLEET_MSG_ACK, g_ack_sequence++);
+    send_frame(&ack, sizeof(ack));
+}
+
+static bool all_live_peers_acked(uint64_t now_us) {
+    bool all = true;
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+    for (int i = 0; i < FLEET_MAX_PEERS; i++) {
+        if (g_peers[i].used && !(g_relay.acked_mask & (1u << i)) &&
+            now_us - g_peers[i].last_heard_us <= FLEET_PEER_TIMEOUT_MS * 1000ULL) {
+            all = false;
+            break;
+        }
+    }
+    xSemaphoreGive(g_lock);
+    return all;
+}
+
+static void handle_ack(const fleet_item_t* item, const fleet_msg_ack_t* message) {
+    if (message->origin != g_unit_id || !g_relay.active ||
+        message->relay_sequence != g_relay.message.header.sequence) {
+        return;
+    }
+
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+    int slot = peer_slot_locked(message->header.unit_id, item->received_us);
+    g_peers[slot].last_heard_us = item->received_us;
+    g_peers[slot].rssi = item->rssi;
+    xSemaphoreGive(g_lock);
+
+    if (g_relay.acked_mask & (1u << slot)) return;     // Answer to a repeat
+    g_relay.acked_mask |= 1u << slot;
+
+    char text[FLEET_RESPONSE_SIZE];
+    memcpy(text, message->message, sizeof(text));
+    text[sizeof(text) - 1] = '\0';
+    record_result(message->relay_sequence, message->header.unit_id, message->command, message->result,
+                  (uint32_t)((item->received_us - g_relay.first_sent_us) / 1000), text);
+
+    if (g_relay.message.target != FLEET_UNIT_ALL || all_live_peers_acked(item->received_us)) {
+        g_relay.active = false;
+    }
+}
+
+static void handle_frame(const fleet_item_t* item) {
+    const fleet_msg_header_t* header = (const fleet_msg_header_t*)item->data;
+    if (item->length < sizeof(fleet_msg_header_t) || header->magic != FLEET_MAGIC ||
+        header->version != FLEET_PROTOCOL_VERSION || header->fleet_id != CONFIG_TROLLEY_FLEET_ID ||
+        header->unit_id == g_unit_id) {
+        g_stats.frames_ignored++;
+        return;
+    }
+    g_stats.frames_received++;
+
+    switch (header->type) {
+        case FLEET_MSG_STATE:
+            if (item->length >= sizeof(fleet_msg_state_t)) {
+                handle_state(item, (const fleet_msg_state_t*)item->data);
+                return;
+            }
+            break;
+        case FLEET_MSG_COMMAND:
+            if (item->length >= sizeof(fleet_msg_command_t)) {
+                handle_command(item, (const fleet_msg_command_t*)item->data);
+                return;
+            }
+            break;
+        case FLEET_MSG_ACK:
+            if (item->length >= sizeof(fleet_msg_ack_t)) {
+                handle_ack(item, (const fleet_msg_ack_t*)item->data);
+                return;
+            }
+            break;
+        default:
+            break;
+    }
+    g_stats.frames_ignored++;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// RELAYING COMMANDS FROM HERE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Relay in flight is over: every target that stayed silent is a timeout
+static void finish_relay(void) {
+    if (!g_relay.active) return;
+    g_relay.active = false;
+
+    uint16_t sequence = g_relay.message.header.sequence;
+    char command = g_relay.message.command;
+    if (g_relay.message.target != FLEET_UNIT_ALL) {
+        record_result(sequence, g_relay.message.target, command, ESP_ERR_TIMEOUT, 0, "No answer");
+        return;
+    }
+
+    uint64_t now_us = esp_timer_get_time();
+    uint32_t silent[FLEET_MAX_PEERS];
+    int silent_count = 0;
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+    for (int i = 0; i < FLEET_MAX_PEERS; i++) {
+        if (g_peers[i].used && !(g_relay.acked_mask & (1u << i)) &&
+            now_us - g_peers[i].last_heard_us <= FLEET_PEER_TIMEOUT_MS * 1000ULL) {
+            silent[silent_count++] = g_peers[i].unit_id;
+        }
+    }
+    xSemaphoreGive(g_lock);
+    for (int i = 0; i < silent_count; i++) {
+        record_result(sequence, silent[i], command, ESP_ERR_TIMEOUT, 0, "No answer");
+    }
+}
+
+static void start_relay(const fleet_item_t* request) {
+    uint64_t now_us = esp_timer_get_time();
+    g_stats.commands_relayed++;
+
+    memset(&g_relay, 0, sizeof(g_relay));
+    g_relay.active = true;
+    fill_header(&g_relay.message.header, FLEET_MSG_COMMAND, request->relay.sequence);
+    g_relay.message.target = request->relay.target;
+    g_relay.message.command = request->relay.command;
+    g_relay.first_sent_us = now_us;
+    g_relay.next_send_us = now_us;
+    // An emergency stop is never scheduled, on this unit or the others
+    g_relay.start_at_us = request->relay.start_in_ms && !is_emergency_stop(request->relay.command)
+                          ? now_us + request->relay.start_in_ms * 1000ULL : 0;
+
+    // "All" includes this unit, on the same clock as the others
+    if (request->relay.target == FLEET_UNIT_ALL) {
+        char response[FLEET_RESPONSE_SIZE];
+        esp_err_t result;
+        if (g_relay.start_at_us != 0) {
+            result = schedule_start(request->relay.command, g_relay.start_at_us, response, sizeof(response));
+        } else {
+            fleet_command_handler_t handler = g_handler;
+            result = handler ? handler(request->relay.command, "fleet:local", response, sizeof(response))
+                             : ESP_ERR_INVALID_STATE;
+            if (handler == NULL) snprintf(response, sizeof(response), "❌ No command handler");
+        }
+        record_result(request->relay.sequence, g_unit_id, request->relay.command, result, 0, response);
+    }
+}
+
+static void queue_relay(const fleet_item_t* request) {
+    if (is_emergency_stop(request->relay.command)) {
+        // Ahead of everything; whatever was waiting is moot
+        for (uint32_t i = 0; i < g_relay_fifo_count; i++) {
+            const fleet_item_t* dropped = &g_relay_fifo[(g_relay_fifo_head + i) % FLEET_RELAY_QUEUE_DEPTH];
+            record_result(dropped->relay.sequence, dropped->relay.target, dropped->relay.command,
+                          ESP_ERR_INVALID_STATE, 0, "Superseded by emergency stop");
+        }
+        g_relay_fifo_count = 0;
+        if (g_relay.active) {
+            record_result(g_relay.message.header.sequence, g_relay.message.target, g_relay.message.command,
+                          ESP_ERR_INVALID_STATE, 0, "Superseded by emergency stop");
+            g_relay.active = false;
+        }
+        fleet_link_cancel_scheduled_start();
+        start_relay(request);
+        return;
+    }
+
+    if (g_relay_fifo_count == FLEET_RELAY_QUEUE_DEPTH) {
+        record_result(request->relay.sequence, request->relay.target, request->relay.command,
+                      ESP_ERR_NO_MEM, 0, "Relay queue full");
+        return;
+    }
+    g_relay_fifo[(g_relay_fifo_head + g_relay_fifo_count) % FLEET_RELAY_QUEUE_DEPTH] = *request;
+    g_relay_fifo_count++;
+}
+
+static void service_relays(uint64_t now_us) {
+    if (g_relay.active && g_relay.message.attempt >= FLEET_COMMAND_ATTEMPTS && now_us >= g_relay.next_send_us) {
+        finish_relay();
+    }
+    if (!g_relay.active && g_relay_fifo_count > 0) {
+        start_relay(&g_relay_fifo[g_relay_fifo_head]);
+        g_relay_fifo_head = (g_relay_fifo_head + 1) % FLEET_RELAY_QUEUE_DEPTH;
+        g_relay_fifo_count--;
+    }
+    if (!g_relay.active || now_us < g_relay.next_send_us || g_relay.message.attempt >= FLEET_COMMAND_ATTEMPTS) {
+        return;
+    }
+
+    // Each copy carries the time left, so every receiver lands on start_at_us
+    if (g_relay.start_at_us != 0) {
+        g_relay.message.start_in_us = g_relay.start_at_us > now_us ? (uint32_t)(g_relay.start_at_us - now_us) : 1;
+    }
+    g_relay.message.attempt++;
+    send_frame(&g_relay.message, sizeof(g_relay.message));
+    g_relay.next_send_us = now_us + FLEET_COMMAND_RETRY_MS * 1000ULL;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// TASK
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void espnow_receive_callback(const esp_now_recv_info_t* info, const uint8_t* data, int length) {
+    if (length <= 0 || length > FLEET_MAX_MESSAGE || data[0] != FLEET_MAGIC) return;
+
+    fleet_item_t item;
+    item.kind = FLEET_ITEM_FRAME;
+    item.rssi = info->rx_ctrl != NULL ? (int8_t)info->rx_ctrl->rssi : 0;
+    item.length = (uint8_t)length;
+    item.received_us = esp_timer_get_time();
+    memcpy(item.data, data, length);
+    if (xQueueSend(g_items, &item, 0) != pdTRUE) {
+        g_rx_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static void fleet_task(void* pvParameter) {
+    (void)pvParameter;
+    uint64_t next_state_us = esp_timer_get_time();
+    fleet_item_t item;
+
+    while (true) {
+        uint64_t now_us = esp_timer_get_time();
+        uint64_t wake_us = next_state_us;
+        if (g_relay.active && g_relay.next_send_us < wake_us) wake_us = g_relay.next_send_us;
+        TickType_t wait = wake_us > now_us ? pdMS_TO_TICKS((wake_us - now_us + 999) / 1000) : 0;
+
+        if (xQueueReceive(g_items, &item, wait) == pdTRUE) {
+            switch (item.kind) {
+                case FLEET_ITEM_FRAME:    handle_frame(&item); break;
+                case FLEET_ITEM_RELAY:    queue_relay(&item); break;
+                case FLEET_ITEM_SYNC_DUE: run_scheduled_start(); break;
+                default: break;
+            }
+        }
+
+        now_us = esp_timer_get_time();
+        service_relays(now_us);
+        if (now_us >= next_state_us) {
+            broadcast_state();
+            next_state_us += FLEET_STATE_INTERVAL_US;
+            if (next_state_us < now_us) next_state_us = now_us + FLEET_STATE_INTERVAL_US;
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t fleet_link_init(void) {
+    if (g_stats.running) return ESP_OK;
+
+    uint8_t mac[6];
+    esp_err_t result = esp_wifi_get_mac(WIFI_IF_AP, mac);
+    if (result != ESP_OK) return result;
+    g_unit_id = ((uint32_t)mac[3] << 16) | ((uint32_t)mac[4] << 8) | mac[5];
+    if (g_unit_id == FLEET_UNIT_ALL) g_unit_id = 1;
+    g_next_relay_sequence.store((uint16_t)esp_random(), std::memory_order_relaxed);   // No false repeats after a reboot
+
+    g_items = xQueueCreate(FLEET_RX_QUEUE_DEPTH, sizeof(fleet_item_t));
+    g_lock = xSemaphoreCreateMutex();
+    if (g_items == NULL || g_lock == NULL) return ESP_ERR_NO_MEM;
+
+    esp_timer_create_args_t timer_args = {};
+    timer_args.callback = sync_timer_callback;
+    timer_args.name = "fleet_sync";
+    result = esp_timer_create(&timer_args, &g_sync_timer);
+    if (result != ESP_OK) return result;
+
+    result = esp_now_init();
+    if (result != ESP_OK) return result;
+    result = esp_now_register_recv_cb(espnow_receive_callback);
+    if (result != ESP_OK) return result;
+
+    esp_now_peer_info_t broadcast = {};
+    memcpy(broadcast.peer_addr, k_broadcast_mac, ESP_NOW_ETH_ALEN);
+    broadcast.channel = 0;              // Current (AP) channel
+    broadcast.ifidx = WIFI_IF_AP;
+    broadcast.encrypt = false;
+    result = esp_now_add_peer(&broadcast);
+    if (result != ESP_OK) return result;
+
+    if (xTaskCreateStaticPinnedToCore(fleet_task, "fleet_link", FLEET_TASK_STACK, NULL,
+                                      FLEET_TASK_PRIORITY, g_task_stack, &g_task_tcb, FLEET_TASK_CORE) == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    g_stats.running = true;
+    g_stats.unit_id = g_unit_id;
+    ESP_LOGI(TAG, "Fleet link up: unit %06lX, fleet %d", (unsigned long)g_unit_id, CONFIG_TROLLEY_FLEET_ID);
+    return ESP_OK;
+}
+
+void fleet_link_set_command_handler(fleet_command_handler_t handler) {
+    g_handler = handler;
+}
+
+void fleet_link_cancel_scheduled_start(void) {
+    if (g_sync_timer != NULL) esp_timer_stop(g_sync_timer);
+    char command = g_sync_command.exchange(0, std::memory_order_acq_rel);
+    if (command != 0) ESP_LOGW(TAG, "Coordinated '%c' cancelled by emergency stop", command);
+}
+
+uint32_t fleet_link_get_unit_id(void) {
+    return g_unit_id;
+}
+
+size_t fleet_link_get_peers(fleet_peer_t* peers, size_t max_peers) {
+    if (peers == NULL || g_lock == NULL) return 0;
+
+    uint64_t now_us = esp_timer_get_time();
+    size_t count = 0;
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+    for (int i = 0; i < FLEET_MAX_PEERS && count < max_peers; i++) {
+        const fleet_peer_entry_t* entry = &g_peers[i];
+        if (!entry->used || !entry->have_state ||
+            now_us - entry->last_state_us > FLEET_PEER_TIMEOUT_MS * 1000ULL) {
+            continue;
+        }
+        fleet_peer_t* peer = &peers[count++];
+        peer->unit_id = entry->unit_id;
+        peer->rssi = entry->rssi;
+        peer->age_ms = (uint32_t)((now_us - entry->last_state_us) / 1000);
+        peer->states_received = entry->states_received;
+        peer->states_lost = entry->states_lost;
+        peer->state = entry->state;
+    }
+    xSemaphoreGive(g_lock);
+    return count;
+}
+
+esp_err_t fleet_link_send_command(uint32_t unit_id, char command, uint32_t start_in_ms, uint16_t* sequence) {
+    if (!g_stats.running) return ESP_ERR_INVALID_STATE;
+    if (start_in_ms > FLEET_SYNC_START_MAX_MS) return ESP_ERR_INVALID_ARG;
+
+    fleet_item_t item;
+    item.kind = FLEET_ITEM_RELAY;
+    item.relay.target = unit_id;
+    item.relay.start_in_ms = start_in_ms;
+    item.relay.sequence = g_next_relay_sequence.fetch_add(1, std::memory_order_relaxed);
+    item.relay.command = command;
+
+    // An emergency stop waits for nothing, not even frames already received
+    BaseType_t queued = is_emergency_stop(command) ? xQueueSendToFront(g_items, &item, 0)
+                                                   : xQueueSend(g_items, &item, 0);
+    if (queued != pdTRUE) return ESP_ERR_NO_MEM;
+    if (sequence != NULL) *sequence = item.relay.sequence;
+    return ESP_OK;
+}
+
+size_t fleet_link_get_relay_results(fleet_relay_result_t* results, size_t max_results) {
+    if (results == NULL || g_lock == NULL) return 0;
+
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+    size_t available = g_result_count < FLEET_RELAY_RESULTS ? g_result_count : FLEET_RELAY_RESULTS;
+    size_t count = available < max_results ? available : max_results;
+    for (size_t i = 0; i < count; i++) {
+        results[i] = g_results[(g_result_count - 1 - i) % FLEET_RELAY_RESULTS];
+    }
+    xSemaphoreGive(g_lock);
+    return count;
+}
+
+fleet_stats_t fleet_link_get_stats(void) {
+    fleet_stats_t stats = g_stats;
+    stats.rx_dropped = g_rx_dropped.load(std::memory_order_relaxed);
+    return stats;
+}
+
+#else // !FLEET_ENABLED
+
+void fleet_link_cancel_scheduled_start(void) {
+}
+
+esp_err_t fleet_link_init(void) {
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void fleet_link_set_command_handler(fleet_command_handler_t handler) {
+    (void)handler;
+}
+
+uint32_t fleet_link_get_unit_id(void) {
+    return 0;
+}
+
+size_t fleet_link_get_peers(fleet_peer_t* peers, size_t max_peers) {
+    (void)peers;
+    (void)max_peers;
+    return 0;
+}
+
+esp_err_t fleet_link_send_command(uint32_t unit_id, char command, uint32_t start_in_ms, uint16_t* sequence) {
+    (void)unit_id;
+    (void)command;
+    (void)start_in_ms;
+    (void)sequence;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+size_t fleet_link_get_relay_results(fleet_relay_result_t* results, size_t max_results) {
+    (void)results;
+    (void)max_results;
+    return 0;
+}
+
+fleet_stats_t fleet_link_get_stats(void) {
+    fleet_stats_t stats = {};
+    return stats;
+}
+
+#endif // FLEET_ENABLED
@@ -0,0 +1,180 @@
+// components/flight_recorder/include/flight_recorder.h
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FLIGHT_RECORDER.H - BLACK-BOX INCIDENT RECORDER
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Keep the seconds around an incident
+// - Drains the control loop's telemetry_frame ring into a PSRAM history,
+//   so the only hot-path cost is the existing record capture
+// - A trigger (emergency stop, impact, mode error) freezes the pre/post
+//   window into a staging buffer and writes it to the "flightrec" flash
+//   partition in small chunks, only while the trolley is stationary
+//   (flash erase/program stalls both cores)
+// - Last FLIGHT_RECORDER_SLOTS incidents survive reboots and are served
+//   over HTTP (/api/incidents, /api/incident?id=N)
+//
+// flight_recorder_trigger() is lock-free and safe from any task.
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Recorder configuration
+#define FLIGHT_RECORDER_PARTITION       "flightrec" // Data partition label (partitions.csv)
+#define FLIGHT_RECORDER_HISTORY_RECORDS 4096        // PSRAM history (~16 s at 250 Hz)
+#define FLIGHT_RECORDER_PRE_RECORDS     750         // Kept before the trigger (~3 s)
+#define FLIGHT_RECORDER_POST_RECORDS    250         // Kept after the trigger (~1 s)
+#define FLIGHT_RECORDER_SLOT_SIZE       32768       // Flash bytes per incident (sector multiple)
+#define FLIGHT_RECORDER_SLOTS           8           // Incidents kept in flash
+#define FLIGHT_RECORDER_WRITE_CHUNK     1024        // Flash bytes per recorder tick
+#define FLIGHT_RECORDER_PERIOD_MS       100         // Recorder task period
+#define FLIGHT_RECORDER_TASK_STACK      3072        // Recorder task stack size
+#define FLIGHT_RECORDER_TASK_PRIORITY   2           // Background, below housekeeping
+#define FLIGHT_RECORDER_TASK_CORE       0           // Away from the control loop
+
+// Incident file format (slot layout: header, then record_count records)
+#define FLIGHT_INCIDENT_MAGIC           0x43455246  // "FREC"
+#define FLIGHT_INCIDENT_VERSION         1
+
+// Why an incident was recorded
+typedef enum {
+    FLIGHT_TRIGGER_NONE = 0,
+    FLIGHT_TRIGGER_EMERGENCY,           // Emergency stop
+    FLIGHT_TRIGGER_IMPACT,              // Wire end arrival over AUTO_MODE_IMPACT_SPEED_MS
+    FLIGHT_TRIGGER_MODE_ERROR,          // Mode or coordinator error
+    FLIGHT_TRIGGER_MANUAL               // Operator request
+} flight_trigger_t;
+
+// Recorder state
+typedef enum {
+    FLIGHT_RECORDER_DISABLED = 0,       // Not initialized or no memory
+    FLIGHT_RECORDER_RECORDING,          // Filling history, waiting for a trigger
+    FLIGHT_RECORDER_TRIGGERED,          // Collecting the post-trigger window
+    FLIGHT_RECORDER_FLUSHING            // Erasing the next slot, writing the staged incident
+} flight_recorder_state_t;
+
+// On-flash incident header (little-endian, followed by telemetry_frame_t records)
+typedef struct __attribute__((packed)) {
+    uint32_t magic;                    // FLIGHT_INCIDENT_MAGIC when the slot is complete
+    uint8_t version;                   // FLIGHT_INCIDENT_VERSION
+    uint8_t reason;                    // flight_trigger_t
+    uint8_t record_version;            // TELEMETRY_FRAME_VERSION of the records
+    uint8_t record_size;               // TELEMETRY_FRAME_SIZE of the records
+    uint32_t sequence;                 // Incident number (increases across reboots)
+    uint64_t trigger_time_us;          // esp_timer time of the trigger
+    uint16_t record_count;             // Records stored
+    uint16_t pre_records;              // Records before the trigger
+    uint32_t lost_records;             // Records the recorder missed in the window
+    uint32_t crc32;                    // CRC-32 of the records
+} flight_incident_header_t;
+
+// Stored incident summary
+typedef struct {
+    uint8_t slot;                      // Flash slot (download id)
+    uint32_t sequence;
+    flight_trigger_t reason;
+    uint64_t trigger_time_us;
+    uint16_t record_count;
+    uint16_t pre_records;
+    uint32_t size_bytes;               // Header + records
+} flight_incident_info_t;
+
+// Recorder statistics
+typedef struct {
+    flight_recorder_state_t state;
+    bool history_in_psram;             // false = smaller internal RAM fallback
+    bool flash_available;              // Partition found
+    uint32_t history_records;          // History capacity
+    uint32_t records_seen;             // Records drained from the capture ring
+    uint32_t records_lost;             // Capture ring overwrote records before the drain
+    uint32_t triggers;                 // Triggers accepted
+    uint32_t triggers_dropped;         // Triggers while an incident was in progress
+    uint32_t incidents_stored;         // Incidents written since boot
+    uint32_t flash_errors;             // Failed erase/write operations
+    uint32_t max_drain_us;             // Longest drain pass
+} flight_recorder_stats_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CORE RECORDER API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Allocate the history and scan stored incidents
+ * @return ESP_OK (also without partition: incidents are then counted, not stored),
+ *         ESP_ERR_NO_MEM if no history buffer could be allocated
+ */
+esp_err_t flight_recorder_init(void);
+
+/**
+ * @brief Start the recorder task
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not initialized
+ */
+esp_err_t flight_recorder_start(void);
+
+/**
+ * @brief Request an incident recording around the current moment
+ * @param reason Why (first trigger wins until the incident is stored)
+ * @note Lock-free, callable from any task including the control loop
+ */
+void flight_recorder_trigger(flight_trigger_t reason);
+
+/**
+ * @brief Get recorder statistics
+ * @param stats Output statistics
+ */
+void flight_recorder_get_stats(flight_recorder_stats_t* stats);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// INCIDENT ACCESS API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Get the number of stored incidents
+ * @return Incident count (0..FLIGHT_RECORDER_SLOTS)
+ */
+size_t flight_recorder_get_incident_count(void);
+
+/**
+ * @brief Describe a stored incident
+ * @param index 0 = newest
+ * @param info Output summary
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if index out of range
+ */
+esp_err_t flight_recorder_get_incident(size_t index, flight_incident_info_t* info);
+
+/**
+ * @brief Read raw incident bytes (header + records) from flash
+ * @param slot Flash slot (flight_incident_info_t.slot)
+ * @param offset Byte offset into the incident
+ * @param buffer Output buffer
+ * @param length Bytes wanted
+ * @param bytes_read Bytes copied (0 at end of incident)
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if the slot holds no incident
+ */
+esp_err_t flight_recorder_read_incident(uint8_t slot, uint32_t offset, void* buffer,
+                                        size_t length, size_t* bytes_read);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// UTILITY API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Get trigger name
+ * @param reason Trigger
+ * @return String name
+ */
+const char* flight_recorder_trigger_to_string(flight_trigger_t reason);
+
+/**
+ * @brief Get recorder state name
+ * @param state State
+ * @return String name
+ */
+const char* flight_recorder_state_to_string(flight_recorder_state_t state);
+
+#endif // FLIGHT_RECORDER_H
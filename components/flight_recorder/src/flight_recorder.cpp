@@ -0,0 +1,507 @@
+// components/flight_recorder/src/flight_recorder.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// FLIGHT_RECORDER.CPP - PSRAM HISTORY, INCIDENT STAGING, CHUNKED FLASH WRITES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "flight_recorder.h"
+#include "telemetry_frame.h"
+#include "status_snapshot.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_partition.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <cstring>
+
+static const char* TAG = "FLIGHT_REC";
+
+#define FLASH_SECTOR_SIZE           4096
+#define FALLBACK_HISTORY_RECORDS    (FLIGHT_RECORDER_PRE_RECORDS + FLIGHT_RECORDER_POST_RECORDS + 256)
+#define DRAIN_BATCH_RECORDS         64
+#define INCIDENT_MAX_RECORDS        (FLIGHT_RECORDER_PRE_RECORDS + FLIGHT_RECORDER_POST_RECORDS)
+#define INCIDENT_MAX_BYTES          (sizeof(flight_incident_header_t) + INCIDENT_MAX_RECORDS * TELEMETRY_FRAME_SIZE)
+
+static_assert(INCIDENT_MAX_BYTES <= FLIGHT_RECORDER_SLOT_SIZE, "incident does not fit a flash slot");
+static_assert(FLIGHT_RECORDER_SLOT_SIZE % FLASH_SECTOR_SIZE == 0, "slot must be whole sectors");
+static_assert(sizeof(flight_incident_header_t) == 32, "incident header layout changed");
+
+// Stored incidents as last read from / written to flash
+typedef struct {
+    uint8_t slot_count;                // Slots that fit the partition
+    bool valid[FLIGHT_RECORDER_SLOTS];
+    flight_incident_header_t headers[FLIGHT_RECORDER_SLOTS];
+} incident_table_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// GLOBAL STATE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static bool g_initialized = false;
+static TaskHandle_t g_task_handle = NULL;
+static StackType_t g_task_stack[FLIGHT_RECORDER_TASK_STACK];
+static StaticTask_t g_task_tcb;
+static const esp_partition_t* g_partition = NULL;
+
+// Trigger handoff: claim first, then fill in, then publish the reason
+static std::atomic<bool> g_trigger_claimed{false};
+static std::atomic<uint8_t> g_pending_reason{FLIGHT_TRIGGER_NONE};
+static std::atomic<uint32_t> g_pending_capture{0};      // Capture count at trigger
+static std::atomic<uint32_t> g_pending_time_low{0};     // esp_timer low 32 bits at trigger
+static std::atomic<uint32_t> g_triggers_dropped{0};
+
+// Owned by the recorder task
+static telemetry_reader_t g_reader = {0, 0};
+static telemetry_frame_t* g_history = NULL;
+static uint32_t g_history_capacity = 0;
+static uint32_t g_history_count = 0;                    // Records written since init
+static telemetry_frame_t g_latest;
+static bool g_latest_valid = false;
+
+static uint8_t* g_staging = NULL;                       // Frozen incident (header + records)
+static size_t g_staging_length = 0;
+static size_t g_flush_offset = 0;
+static uint32_t g_trigger_pos = 0;                      // History index of the trigger record
+static uint32_t g_trigger_lost = 0;                     // Reader losses at trigger time
+static flight_trigger_t g_trigger_reason = FLIGHT_TRIGGER_NONE;
+static uint64_t g_trigger_time_us = 0;
+
+static uint8_t g_next_slot = 0;
+static uint32_t g_next_sequence = 1;
+static bool g_next_slot_erased = false;
+static uint8_t g_erase_sector = 0;
+
+static flight_recorder_stats_t g_stats;
+static incident_table_t g_table;
+
+// Published for the web server and other tasks
+static status_snapshot<flight_recorder_stats_t> g_stats_snapshot;
+static status_snapshot<incident_table_t> g_table_snapshot;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// HISTORY AND STAGING (RECORDER TASK)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void drain_capture_ring(void) {
+    uint64_t start_us = esp_timer_get_time();
+
+    // Read straight into the history: no intermediate copy
+    for (;;) {
+        uint32_t index = g_history_count % g_history_capacity;
+        size_t space = g_history_capacity - index;
+        size_t want = space < DRAIN_BATCH_RECORDS ? space : DRAIN_BATCH_RECORDS;
+        size_t got = telemetry_reader_read(&g_reader, &g_history[index], want);
+        if (got == 0) break;
+
+        g_history_count += got;
+        g_stats.records_seen += got;
+        g_latest = g_history[index + got - 1];
+        g_latest_valid = true;
+        if (got < want) break;
+    }
+    g_stats.records_lost = g_reader.lost;
+
+    uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start_us);
+    if (elapsed_us > g_stats.max_drain_us) g_stats.max_drain_us = elapsed_us;
+}
+
+static bool trolley_stationary(void) {
+    // Nothing captured (control loop not running) counts as stationary
+    if (!g_latest_valid) return true;
+    return (g_latest.flags & TELEMETRY_FLAG_STOPPED) && g_latest.target_mm_s == 0;
+}
+
+static void release_trigger(void) {
+    g_trigger_reason = FLIGHT_TRIGGER_NONE;
+    g_pending_reason.store(FLIGHT_TRIGGER_NONE, std::memory_order_relaxed);
+    g_trigger_claimed.store(false, std::memory_order_release);
+}
+
+static void accept_trigger(flight_trigger_t reason) {
+    uint32_t capture = g_pending_capture.load(std::memory_order_relaxed);
+    uint32_t time_low = g_pending_time_low.load(std::memory_order_relaxed);
+
+    // Negative: records captured after the trigger were already drained
+    int32_t offset = (int32_t)(capture - g_reader.next);
+    if (offset < -(int32_t)g_history_count) offset = -(int32_t)g_history_count;
+
+    uint64_t now_us = esp_timer_get_time();
+    g_trigger_time_us = now_us - (uint32_t)((uint32_t)now_us - time_low);
+    g_trigger_pos = g_history_count + offset;
+    g_trigger_lost = g_reader.lost;
+    g_trigger_reason = reason;
+    g_stats.triggers++;
+    g_stats.state = FLIGHT_RECORDER_TRIGGERED;
+
+    ESP_LOGW(TAG, "Incident triggered: %s", flight_recorder_trigger_to_string(reason));
+}
+
+static void stage_incident(void) {
+    uint32_t pre = FLIGHT_RECORDER_PRE_RECORDS;
+    if (pre > g_trigger_pos) pre = g_trigger_pos;
+    uint32_t start = g_trigger_pos - pre;
+    uint32_t count = g_history_count - start;
+    if (count > INCIDENT_MAX_RECORDS) count = INCIDENT_MAX_RECORDS;
+
+    uint8_t* records = g_staging + sizeof(flight_incident_header_t);
+    for (uint32_t i = 0; i < count; i++) {
+        memcpy(records + i * TELEMETRY_FRAME_SIZE,
+               &g_history[(start + i) % g_history_capacity], TELEMETRY_FRAME_SIZE);
+    }
+
+    flight_incident_header_t header;
+    header.magic = FLIGHT_INCIDENT_MAGIC;
+    header.version = FLIGHT_INCIDENT_VERSION;
+    header.reason = (uint8_t)g_trigger_reason;
+    header.record_version = TELEMETRY_FRAME_VERSION;
+    header.record_size = TELEMETRY_FRAME_SIZE;
+    header.sequence = g_next_sequence;
+    header.trigger_time_us = g_trigger_time_us;
+    header.record_count = (uint16_t)count;
+    header.pre_records = (uint16_t)pre;
+    header.lost_records = g_reader.lost - g_trigger_lost;
+    header.crc32 = esp_rom_crc32_le(0, records, count * TELEMETRY_FRAME_SIZE);
+    memcpy(g_staging, &header, sizeof(header));
+
+    g_staging_length = sizeof(header) + count * TELEMETRY_FRAME_SIZE;
+    g_flush_offset = sizeof(header);    // Records first, header last marks the slot complete
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FLASH (RECORDER TASK, ONLY WHILE STATIONARY)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static uint8_t slot_count(void) {
+    if (g_partition == NULL) return 0;
+    uint32_t slots = g_partition->size / FLIGHT_RECORDER_SLOT_SIZE;
+    return (uint8_t)(slots < FLIGHT_RECORDER_SLOTS ? slots : FLIGHT_RECORDER_SLOTS);
+}
+
+static void publish_table(void) {
+    g_table_snapshot.write(g_table);
+}
+
+/**
+ * @brief One bounded flash step: erase a sector of the next slot or write a chunk
+ * @return true when the staged incident is completely stored
+ */
+static bool flush_step(void) {
+    uint32_t slot_base = (uint32_t)g_next_slot * FLIGHT_RECORDER_SLOT_SIZE;
+    esp_err_t result;
+
+    if (!g_next_slot_erased) {
+        if (g_erase_sector == 0 && g_table.valid[g_next_slot]) {
+            g_table.valid[g_next_slot] = false;     // Oldest incident is being overwritten
+            publish_table();
+        }
+        result = esp_partition_erase_range(g_partition, slot_base + g_erase_sector * FLASH_SECTOR_SIZE,
+                                           FLASH_SECTOR_SIZE);
+        if (result != ESP_OK) {
+            g_stats.flash_errors++;
+            return false;
+        }
+        if (++g_erase_sector >= FLIGHT_RECORDER_SLOT_SIZE / FLASH_SECTOR_SIZE) {
+            g_next_slot_erased = true;
+            g_erase_sector = 0;
+        }
+        return false;
+    }
+
+    if (g_flush_offset < g_staging_length) {
+        size_t chunk = g_staging_length - g_flush_offset;
+        if (chunk > FLIGHT_RECORDER_WRITE_CHUNK) chunk = FLIGHT_RECORDER_WRITE_CHUNK;
+        result = esp_partition_write(g_partition, slot_base + g_flush_offset, g_staging + g_flush_offset, chunk);
+        if (result != ESP_OK) {
+            g_stats.flash_errors++;
+            return false;
+        }
+        g_flush_offset += chunk;
+        return false;
+    }
+
+    result = esp_partition_write(g_partition, slot_base, g_staging, sizeof(flight_incident_header_t));
+    if (result != ESP_OK) {
+        g_stats.flash_errors++;
+        return false;
+    }
+
+    memcpy(&g_table.headers[g_next_slot], g_staging, sizeof(flight_incident_header_t));
+    g_table.valid[g_next_slot] = true;
+    publish_table();
+
+    ESP_LOGI(TAG, "Incident #%lu stored in slot %u (%u records)",
+             (unsigned long)g_next_sequence, g_next_slot,
+             g_table.headers[g_next_slot].record_count);
+
+    g_stats.incidents_stored++;
+    g_next_sequence++;
+    g_next_slot = (uint8_t)((g_next_slot + 1) % slot_count());
+    g_next_slot_erased = false;
+    return true;
+}
+
+static void scan_slots(void) {
+    memset(&g_table, 0, sizeof(g_table));
+    g_table.slot_count = slot_count();
+
+    uint32_t newest_sequence = 0;
+    int newest_slot = -1;
+    bool found_any = false;
+
+    for (uint8_t slot = 0; slot < g_table.slot_count; slot++) {
+        flight_incident_header_t header;
+        if (esp_partition_read(g_partition, (uint32_t)slot * FLIGHT_RECORDER_SLOT_SIZE,
+                               &header, sizeof(header)) != ESP_OK) {
+            continue;
+        }
+        if (header.magic != FLIGHT_INCIDENT_MAGIC || header.version != FLIGHT_INCIDENT_VERSION ||
+            header.record_count > INCIDENT_MAX_RECORDS) {
+            continue;
+        }
+        g_table.headers[slot] = header;
+        g_table.valid[slot] = true;
+        if (!found_any || header.sequence > newest_sequence) {
+            newest_sequence = header.sequence;
+            newest_slot = slot;
+            found_any = true;
+        }
+    }
+
+    if (found_any) {
+        g_next_sequence = newest_sequence + 1;
+        g_next_slot = (uint8_t)((newest_slot + 1) % g_table.slot_count);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// RECORDER TASK
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void flight_recorder_task(void* parameter) {
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (1) {
+        drain_capture_ring();
+
+        switch (g_stats.state) {
+            case FLIGHT_RECORDER_RECORDING: {
+                uint8_t reason = g_pending_reason.load(std::memory_order_acquire);
+                if (reason != FLIGHT_TRIGGER_NONE) accept_trigger((flight_trigger_t)reason);
+                break;
+            }
+
+            case FLIGHT_RECORDER_TRIGGERED:
+                if ((int32_t)(g_history_count - g_trigger_pos) < FLIGHT_RECORDER_POST_RECORDS) break;
+                if (g_partition == NULL || g_table.slot_count == 0) {
+                    ESP_LOGW(TAG, "No '%s' partition - incident not stored", FLIGHT_RECORDER_PARTITION);
+                    release_trigger();
+                    g_stats.state = FLIGHT_RECORDER_RECORDING;
+                    break;
+                }
+                stage_incident();
+                g_stats.state = FLIGHT_RECORDER_FLUSHING;
+                break;
+
+            case FLIGHT_RECORDER_FLUSHING:
+                // Flash erase/program stalls both cores: never while moving
+                if (!trolley_stationary()) break;
+                if (flush_step()) {
+                    release_trigger();
+                    g_stats.state = FLIGHT_RECORDER_RECORDING;
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        g_stats.triggers_dropped = g_triggers_dropped.load(std::memory_order_relaxed);
+        g_stats_snapshot.write(g_stats);
+
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(FLIGHT_RECORDER_PERIOD_MS));
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CORE RECORDER API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t flight_recorder_init(void) {
+    if (g_initialized) return ESP_OK;
+
+    memset(&g_stats, 0, sizeof(g_stats));
+
+    // History prefers PSRAM; internal RAM fallback only holds one window
+    g_history = (telemetry_frame_t*)heap_caps_malloc(FLIGHT_RECORDER_HISTORY_RECORDS * sizeof(telemetry_frame_t),
+                                                     MALLOC_CAP_SPIRAM);
+    g_history_capacity = FLIGHT_RECORDER_HISTORY_RECORDS;
+    g_stats.history_in_psram = (g_history != NULL);
+    if (g_history == NULL) {
+        g_history = (telemetry_frame_t*)heap_caps_malloc(FALLBACK_HISTORY_RECORDS * sizeof(telemetry_frame_t),
+                                                         MALLOC_CAP_8BIT);
+        g_history_capacity = FALLBACK_HISTORY_RECORDS;
+    }
+    g_staging = (uint8_t*)heap_caps_malloc(INCIDENT_MAX_BYTES, g_stats.history_in_psram ? MALLOC_CAP_SPIRAM : MALLOC_CAP_8BIT);
+    if (g_history == NULL || g_staging == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate recorder buffers");
+        heap_caps_free(g_history);
+        heap_caps_free(g_staging);
+        g_history = NULL;
+        g_staging = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    g_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                           FLIGHT_RECORDER_PARTITION);
+    if (g_partition != NULL) {
+        scan_slots();
+    } else {
+        memset(&g_table, 0, sizeof(g_table));
+        ESP_LOGW(TAG, "No '%s' partition - incidents will not be stored", FLIGHT_RECORDER_PARTITION);
+    }
+    publish_table();
+
+    g_stats.state = FLIGHT_RECORDER_RECORDING;
+    g_stats.flash_available = (g_partition != NULL && g_table.slot_count > 0);
+    g_stats.history_records = g_history_capacity;
+    g_stats_snapshot.write(g_stats);
+
+    telemetry_reader_init(&g_reader);
+    g_initialized = true;
+
+    ESP_LOGI(TAG, "Flight recorder: %lu-record history in %s, %u flash slots, next incident #%lu",
+             (unsigned long)g_history_capacity, g_stats.history_in_psram ? "PSRAM" : "internal RAM",
+             g_table.slot_count, (unsigned long)g_next_sequence);
+    return ESP_OK;
+}
+
+esp_err_t flight_recorder_start(void) {
+    if (!g_initialized) return ESP_ERR_INVALID_STATE;
+    if (g_task_handle != NULL) return ESP_OK;
+
+    // Attach at the newest record: nothing older than the start is of interest
+    telemetry_reader_init(&g_reader);
+
+    g_task_handle = xTaskCreateStaticPinnedToCore(flight_recorder_task, "flight_rec",
+                                                  FLIGHT_RECORDER_TASK_STACK, NULL,
+                                                  FLIGHT_RECORDER_TASK_PRIORITY, g_task_stack, &g_task_tcb,
+                                                  FLIGHT_RECORDER_TASK_CORE);
+    if (g_task_handle == NULL) {
+        ESP_LOGE(TAG, "Failed to create recorder task");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void flight_recorder_trigger(flight_trigger_t reason) {
+    if (!g_initialized || reason == FLIGHT_TRIGGER_NONE) return;
+
+    bool expected = false;
+    if (!g_trigger_claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        g_triggers_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    g_pending_capture.store(telemetry_frame_get_capture_count(), std::memory_order_relaxed);
+    g_pending_time_low.store((uint32_t)esp_timer_get_time(), std::memory_order_relaxed);
+    g_pending_reason.store((uint8_t)reason, std::memory_order_release);
+}
+
+void flight_recorder_get_stats(flight_recorder_stats_t* stats) {
+    if (stats == NULL) return;
+    *stats = g_stats_snapshot.read();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// INCIDENT ACCESS API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+size_t flight_recorder_get_incident_count(void) {
+    incident_table_t table = g_table_snapshot.read();
+    size_t count = 0;
+    for (uint8_t slot = 0; slot < table.slot_count; slot++) {
+        if (table.valid[slot]) count++;
+    }
+    return count;
+}
+
+esp_err_t flight_recorder_get_incident(size_t index, flight_incident_info_t* info) {
+    if (info == NULL) return ESP_ERR_INVALID_ARG;
+    incident_table_t table = g_table_snapshot.read();
+
+    // Selection by rank: newest first, at most FLIGHT_RECORDER_SLOTS entries
+    uint32_t upper_bound = UINT32_MAX;
+    bool has_bound = false;
+    for (size_t rank = 0; rank <= index; rank++) {
+        int best = -1;
+        for (uint8_t slot = 0; slot < table.slot_count; slot++) {
+            if (!table.valid[slot]) continue;
+            uint32_t sequence = table.headers[slot].sequence;
+            if (has_bound && sequence >= upper_bound) continue;
+            if (best < 0 || sequence > table.headers[best].sequence) best = slot;
+        }
+        if (best < 0) return ESP_ERR_NOT_FOUND;
+        if (rank == index) {
+            const flight_incident_header_t* header = &table.headers[best];
+            info->slot = (uint8_t)best;
+            info->sequence = header->sequence;
+            info->reason = (flight_trigger_t)header->reason;
+            info->trigger_time_us = header->trigger_time_us;
+            info->record_count = header->record_count;
+            info->pre_records = header->pre_records;
+            info->size_bytes = sizeof(flight_incident_header_t) + header->record_count * header->record_size;
+            return ESP_OK;
+        }
+        upper_bound = table.headers[best].sequence;
+        has_bound = true;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t flight_recorder_read_incident(uint8_t slot, uint32_t offset, void* buffer,
+                                        size_t length, size_t* bytes_read) {
+    if (buffer == NULL || bytes_read == NULL) return ESP_ERR_INVALID_ARG;
+    *bytes_read = 0;
+
+    incident_table_t table = g_table_snapshot.read();
+    if (g_partition == NULL || slot >= table.slot_count || !table.valid[slot]) return ESP_ERR_NOT_FOUND;
+
+    const flight_incident_header_t* header = &table.headers[slot];
+    uint32_t size = sizeof(flight_incident_header_t) + header->record_count * header->record_size;
+    if (offset >= size) return ESP_OK;
+    if (length > size - offset) length = size - offset;
+
+    esp_err_t result = esp_partition_read(g_partition, (uint32_t)slot * FLIGHT_RECORDER_SLOT_SIZE + offset,
+                                          buffer, length);
+    if (result != ESP_OK) return result;
+
+    *bytes_read = length;
+    return ESP_OK;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// UTILITY API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+const char* flight_recorder_trigger_to_string(flight_trigger_t reason) {
+    switch (reason) {
+        case FLIGHT_TRIGGER_NONE:       return "none";
+        case FLIGHT_TRIGGER_EMERGENCY:  return "emergency";
+        case FLIGHT_TRIGGER_IMPACT:     return "impact";
+        case FLIGHT_TRIGGER_MODE_ERROR: return "mode_error";
+        case FLIGHT_TRIGGER_MANUAL:     return "manual";
+        default:                        return "unknown";
+    }
+}
+
+const char* flight_recorder_state_to_string(flight_recorder_state_t state) {
+    switch (state) {
+        case FLIGHT_RECORDER_DISABLED:  return "disabled";
+        case FLIGHT_RECORDER_RECORDING: return "recording";
+        case FLIGHT_RECORDER_TRIGGERED: return "triggered";
+        case FLIGHT_RECORDER_FLUSHING:  return "flushing";
+        default:                        return "unknown";
+    }
+}
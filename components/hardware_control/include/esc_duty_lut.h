@@ -0,0 +1,110 @@
+// components/hardware_control/include/esc_duty_lut.h
+#ifndef ESC_DUTY_LUT_H
+#define ESC_DUTY_LUT_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// ESC_DUTY_LUT.H - CALIBRATED SPEED → ESC DUTY LOOKUP TABLE
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Map a speed command to an ESC duty without float math
+// - One monotonic table per direction, ESC_LUT_ENTRIES points spanning
+//   0..ESC_LUT_MAX_SPEED_MM_S, entries are duty offsets from neutral
+// - Lookup is integer interpolation (Q8 fraction between entries)
+// - Built from (duty, measured speed) points collected by a calibration sweep
+//   (wire learning speed progression), persisted in NVS per unit
+// - Uncalibrated direction uses the factory linear map
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// LUT configuration
+#define ESC_LUT_ENTRIES                 256         // Table points per direction
+#define ESC_LUT_MAX_SPEED_MM_S          5000        // Speed at last entry (mm/s)
+#define ESC_LUT_DEFAULT_FULL_SPEED_MM_S 2000        // Factory map: full duty at this speed
+#define ESC_LUT_MAX_CAL_POINTS          32          // Calibration points per direction
+#define ESC_LUT_MIN_CAL_POINTS          2           // Points needed to calibrate a direction
+#define ESC_LUT_NVS_NAMESPACE           "esc_lut"   // NVS namespace
+#define ESC_LUT_NVS_KEY                 "table"     // NVS blob key
+#define ESC_LUT_VERSION                 1           // Stored blob layout version
+
+// LUT status
+typedef struct {
+    bool forward_calibrated;           // Forward table built from measurements
+    bool reverse_calibrated;           // Reverse table built from measurements
+    bool loaded_from_nvs;              // Tables restored at boot
+    bool save_pending;                 // New tables waiting to be written to NVS
+    uint8_t forward_points;            // Points collected in current sweep
+    uint8_t reverse_points;
+    uint16_t forward_full_duty_speed_mm_s;  // Speed reached at full forward duty
+    uint16_t reverse_full_duty_speed_mm_s;  // Speed reached at full reverse duty
+} esc_lut_info_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// LOOKUP API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Build factory tables and restore calibrated tables from NVS
+ * @return ESP_OK on success (missing NVS data is not an error)
+ * @note Requires nvs_flash_init() to have run
+ */
+esp_err_t esc_lut_init(void);
+
+/**
+ * @brief Convert speed command to ESC duty (integer only, control loop safe)
+ * @param speed_mm_s Speed magnitude in mm/s (clamped to ESC_LUT_MAX_SPEED_MM_S)
+ * @param forward Direction (true = forward, false = reverse)
+ * @return Absolute LEDC duty value
+ */
+uint16_t esc_lut_speed_to_duty(uint16_t speed_mm_s, bool forward);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CALIBRATION API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Start a calibration sweep (discards previously collected points)
+ * @return ESP_OK on success
+ */
+esp_err_t esc_lut_calibration_begin(void);
+
+/**
+ * @brief Record one steady-state measurement
+ * @param forward Direction of measurement
+ * @param duty Absolute ESC duty that was applied
+ * @param measured_speed_mm_s Speed measured by the Hall sensor at that duty
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if point list full,
+ *         ESP_ERR_INVALID_ARG if duty is on the wrong side of neutral
+ */
+esp_err_t esc_lut_calibration_add_point(bool forward, uint16_t duty, uint16_t measured_speed_mm_s);
+
+/**
+ * @brief Build tables from collected points and make them active
+ * @return ESP_OK if at least one direction was calibrated,
+ *         ESP_ERR_INVALID_STATE if no direction had enough points
+ * @note NVS write is deferred to esc_lut_process_pending_save()
+ */
+esp_err_t esc_lut_calibration_commit(void);
+
+/**
+ * @brief Write committed tables to NVS if a save is pending
+ * @return ESP_OK on success or nothing to do, NVS error code on failure
+ * @note Call from housekeeping (flash writes must not run in the control loop)
+ */
+esp_err_t esc_lut_process_pending_save(void);
+
+/**
+ * @brief Drop calibration and return to the factory linear map
+ * @return ESP_OK on success
+ */
+esp_err_t esc_lut_reset_to_default(void);
+
+/**
+ * @brief Get LUT calibration status
+ * @return esc_lut_info_t structure
+ */
+esc_lut_info_t esc_lut_get_info(void);
+
+#endif // ESC_DUTY_LUT_H
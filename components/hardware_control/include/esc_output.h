@@ -0,0 +1,153 @@
+// components/hardware_control/include/esc_output.h
+#ifndef ESC_OUTPUT_H
+#define ESC_OUTPUT_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// ESC_OUTPUT.H - ESC SIGNAL BACKENDS BEHIND A LATEST-COMMAND MAILBOX
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Put the commanded ESC duty on the signal pin
+// - Callers keep working in servo duty counts (ESC_MIN_DUTY..ESC_MAX_DUTY,
+//   ESC_NEUTRAL_DUTY = stop): the duty LUT and the speed controller do not
+//   change with the protocol; each backend scales the offset from neutral
+// - esc_output_set() is the mailbox: one atomic store, never blocks, newest
+//   value wins. A frame already on the wire is never torn
+// - Backends:
+//   PWM50       LEDC, 1000-2000 µs at 50 Hz (20 ms per update)
+//   ONESHOT125  MCPWM, 125-250 µs at 2 kHz; comparator shadowed on timer
+//               zero, so a new width starts with a whole pulse
+//   MULTISHOT   MCPWM, 5-25 µs at 8 kHz
+//   DSHOT300/600 RMT (DMA), digital 3D throttle sent at ESC_DSHOT_FRAME_RATE_HZ
+//               from the newest mailbox value; bidirectional DShot adds eRPM
+//               telemetry read back on the same pin
+// - The bidirectional ESC setting must match: servo/OneShot neutral is the
+//   mid pulse, DShot needs the ESC in 3D mode (1048+ forward, 48-1047 reverse)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// OneShot/Multishot (MCPWM)
+#define ESC_MCPWM_RESOLUTION_HZ     10000000    // 0.1 µs per tick
+#define ESC_ONESHOT125_PERIOD_US    500         // 2 kHz frame rate
+#define ESC_ONESHOT125_MIN_US       125.0f
+#define ESC_ONESHOT125_MAX_US       250.0f
+#define ESC_MULTISHOT_PERIOD_US     125         // 8 kHz frame rate
+#define ESC_MULTISHOT_MIN_US        5.0f
+#define ESC_MULTISHOT_MAX_US        25.0f
+
+// DShot (RMT)
+#define ESC_DSHOT_RESOLUTION_HZ     40000000    // 25 ns per tick
+#define ESC_DSHOT_FRAME_RATE_HZ     1000        // Frames per second (≥ control loop rate)
+#define ESC_DSHOT_USE_DMA           1           // TX channel on the RMT DMA path
+#define ESC_DSHOT_3D_REVERSE_MIN    48          // Slowest reverse
+#define ESC_DSHOT_3D_REVERSE_MAX    1047        // Fastest reverse
+#define ESC_DSHOT_3D_FORWARD_MIN    1048        // Slowest forward
+#define ESC_DSHOT_3D_FORWARD_MAX    2047        // Fastest forward
+#define ESC_DSHOT_TELEMETRY_TIMEOUT_MS 100      // No valid eRPM frame for this long: stale
+
+// eRPM → wheel speed
+#define ESC_MOTOR_POLE_PAIRS        7           // Eco II 2807: 12N14P
+#define ESC_MOTOR_REVS_PER_WHEEL_REV 1.0f       // Direct drive
+
+typedef enum {
+    ESC_PROTOCOL_PWM50 = 0,
+    ESC_PROTOCOL_ONESHOT125,
+    ESC_PROTOCOL_MULTISHOT,
+    ESC_PROTOCOL_DSHOT300,
+    ESC_PROTOCOL_DSHOT600,
+    ESC_PROTOCOL_COUNT
+} esc_protocol_t;
+
+// Boot protocol (menuconfig "Trolley ESC output"; the includer provides sdkconfig.h)
+#if defined(CONFIG_TROLLEY_ESC_PROTOCOL_ONESHOT125)
+#define ESC_DEFAULT_PROTOCOL        ESC_PROTOCOL_ONESHOT125
+#elif defined(CONFIG_TROLLEY_ESC_PROTOCOL_MULTISHOT)
+#define ESC_DEFAULT_PROTOCOL        ESC_PROTOCOL_MULTISHOT
+#elif defined(CONFIG_TROLLEY_ESC_PROTOCOL_DSHOT300)
+#define ESC_DEFAULT_PROTOCOL        ESC_PROTOCOL_DSHOT300
+#elif defined(CONFIG_TROLLEY_ESC_PROTOCOL_DSHOT600)
+#define ESC_DEFAULT_PROTOCOL        ESC_PROTOCOL_DSHOT600
+#else
+#define ESC_DEFAULT_PROTOCOL        ESC_PROTOCOL_PWM50
+#endif
+
+// ESC-reported motor speed (bidirectional DShot only)
+typedef struct {
+    bool valid;                        // Fresh frame within ESC_DSHOT_TELEMETRY_TIMEOUT_MS
+    uint32_t erpm;                     // Electrical RPM
+    uint16_t wheel_speed_mm_s;         // Unsigned: DShot eRPM carries no direction
+    uint64_t timestamp_us;             // Last valid frame
+    uint32_t frames;                   // Valid telemetry frames
+    uint32_t errors;                   // Missing, malformed or bad checksum
+} esc_telemetry_t;
+
+// Backend counters
+typedef struct {
+    esc_protocol_t protocol;
+    uint32_t frame_rate_hz;            // Signal updates per second
+    uint32_t frames_sent;              // DShot frames handed to RMT
+    uint32_t frames_skipped;           // DShot: previous frame still in flight
+    bool telemetry_enabled;
+} esc_output_info_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// OUTPUT API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Start the signal backend, output at neutral
+ * @param protocol Backend to start
+ * @return ESP_OK on success, driver error otherwise
+ */
+esp_err_t esc_output_init(esc_protocol_t protocol);
+
+/**
+ * @brief Switch the signal backend (neutral on the new one)
+ * @param protocol Backend to start
+ * @return ESP_OK on success, driver error (previous backend restarted) otherwise
+ * @note Only while the ESC is disarmed: hardware_esc_set_protocol() checks that
+ */
+esp_err_t esc_output_select(esc_protocol_t protocol);
+
+/**
+ * @brief Post the newest duty (mailbox, lock-free, any task)
+ * @param duty Servo duty counts, clamped to ESC_MIN_DUTY..ESC_MAX_DUTY
+ */
+void esc_output_set(uint16_t duty);
+
+/**
+ * @brief Post the arming signal: ESC_ARM_DUTY for pulse protocols, DShot 0
+ * @note DShot has no "low pulse": in 3D mode the minimum duty means full reverse
+ */
+void esc_output_set_arm_signal(void);
+
+/**
+ * @brief Active protocol
+ * @return esc_protocol_t
+ */
+esc_protocol_t esc_output_get_protocol(void);
+
+/**
+ * @brief Protocol name for logs and JSON
+ * @param protocol Protocol
+ * @return Static string
+ */
+const char* esc_output_protocol_to_string(esc_protocol_t protocol);
+
+/**
+ * @brief Get backend counters
+ * @return esc_output_info_t structure
+ */
+esc_output_info_t esc_output_get_info(void);
+
+/**
+ * @brief Get the ESC's own speed report (second speed source next to the Hall sensor)
+ * @param telemetry Output
+ * @return ESP_OK if telemetry is fresh, ESP_ERR_NOT_SUPPORTED without
+ *         bidirectional DShot, ESP_ERR_TIMEOUT if stale (telemetry still filled)
+ */
+esp_err_t esc_output_get_telemetry(esc_telemetry_t* telemetry);
+
+#endif // ESC_OUTPUT_H
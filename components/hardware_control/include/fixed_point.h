@@ -0,0 +1,197 @@
+// components/hardware_control/include/fixed_point.h
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FIXED_POINT.H - SATURATING Q-FORMAT ARITHMETIC FOR THE CONTROL PATH
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Integer-only math for tasks that should not touch the FPU
+// - fixed<F>: signed 32-bit value with F fraction bits (q16_16_t, q8_24_t)
+// - fx_add/fx_sub/fx_mul/fx_div saturate to the int32 range instead of
+//   wrapping; products and quotients go through 64 bits and round to nearest
+// - fx_isqrt32/fx_isqrt64: integer square root (floor), bit-by-bit, no divides
+// - fx_magnitude3: |(x, y, z)| of raw sensor counts in the same units
+//
+// A task that never executes a float instruction never gets an FPU context
+// to save, so the IMU acquisition task and the Hall batch stay integer-only.
+// to_float() exists for the UI/API edge, not for the hot path.
+// ═══════════════════════════════════════════════════════════════════════════════
+
+template <int FRAC_BITS>
+struct fixed {
+    static_assert(FRAC_BITS > 0 && FRAC_BITS < 31, "fixed<F>: F must be 1..30");
+
+    static constexpr int frac_bits = FRAC_BITS;
+    static constexpr int32_t one = (int32_t)1 << FRAC_BITS;
+
+    int32_t raw;
+
+    static constexpr fixed from_raw(int32_t value) {
+        return fixed{value};
+    }
+
+    static constexpr fixed from_int(int32_t value) {
+        return fixed{saturate((int64_t)value * one)};
+    }
+
+    /**
+     * @brief Compile-time constant from a float literal (rounds to nearest)
+     * @note Use in constexpr initializers only; at run time this is FPU work
+     */
+    static constexpr fixed from_float(float value) {
+        return fixed{saturate((int64_t)(value * (float)one + (value >= 0.0f ? 0.5f : -0.5f)))};
+    }
+
+    static constexpr fixed from_ratio(int64_t numerator, int64_t denominator) {
+        return fixed{denominator == 0 ? (numerator >= 0 ? INT32_MAX : INT32_MIN)
+                                      : saturate(round_div(numerator * one, denominator))};
+    }
+
+    static constexpr fixed max() { return fixed{INT32_MAX}; }
+    static constexpr fixed min() { return fixed{INT32_MIN}; }
+
+    constexpr float to_float() const { return raw * (1.0f / (float)one); }
+    constexpr int32_t to_int() const { return raw >> FRAC_BITS; }                        // Floor
+    constexpr int32_t round_to_int() const {
+        return (int32_t)(((int64_t)raw + (one >> 1)) >> FRAC_BITS);
+    }
+
+    static constexpr int32_t saturate(int64_t value) {
+        return value > INT32_MAX ? INT32_MAX : (value < INT32_MIN ? INT32_MIN : (int32_t)value);
+    }
+
+    static constexpr int64_t round_div(int64_t numerator, int64_t denominator) {
+        // Round half away from zero
+        return ((numerator < 0) != (denominator < 0))
+                   ? (numerator - denominator / 2) / denominator
+                   : (numerator + denominator / 2) / denominator;
+    }
+};
+
+typedef fixed<16> q16_16_t;                    // ±32768, 1.5e-5 resolution (speeds, meters)
+typedef fixed<24> q8_24_t;                     // ±128, 6e-8 resolution (gains, ratios)
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SATURATING OPERATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+template <int F>
+constexpr fixed<F> fx_add(fixed<F> a, fixed<F> b) {
+    return fixed<F>::from_raw(fixed<F>::saturate((int64_t)a.raw + b.raw));
+}
+
+template <int F>
+constexpr fixed<F> fx_sub(fixed<F> a, fixed<F> b) {
+    return fixed<F>::from_raw(fixed<F>::saturate((int64_t)a.raw - b.raw));
+}
+
+template <int F>
+constexpr fixed<F> fx_neg(fixed<F> a) {
+    return fixed<F>::from_raw(fixed<F>::saturate(-(int64_t)a.raw));
+}
+
+template <int F>
+constexpr fixed<F> fx_abs(fixed<F> a) {
+    return a.raw < 0 ? fx_neg(a) : a;
+}
+
+template <int F>
+constexpr fixed<F> fx_mul(fixed<F> a, fixed<F> b) {
+    int64_t product = (int64_t)a.raw * b.raw;
+    return fixed<F>::from_raw(fixed<F>::saturate((product + ((int64_t)1 << (F - 1))) >> F));
+}
+
+template <int F>
+constexpr fixed<F> fx_mul_int(fixed<F> a, int32_t b) {
+    return fixed<F>::from_raw(fixed<F>::saturate((int64_t)a.raw * b));
+}
+
+/**
+ * @brief a / b, saturating (division by zero returns the limit of a's sign)
+ */
+template <int F>
+constexpr fixed<F> fx_div(fixed<F> a, fixed<F> b) {
+    return fixed<F>::from_ratio(a.raw, b.raw);
+}
+
+template <int F>
+constexpr fixed<F> fx_clamp(fixed<F> value, fixed<F> low, fixed<F> high) {
+    return value.raw < low.raw ? low : (value.raw > high.raw ? high : value);
+}
+
+/**
+ * @brief Change the number of fraction bits (rounds, saturates)
+ */
+template <int TO, int FROM>
+constexpr fixed<TO> fx_convert(fixed<FROM> value) {
+    if constexpr (TO >= FROM) {
+        return fixed<TO>::from_raw(fixed<TO>::saturate((int64_t)value.raw * ((int64_t)1 << (TO - FROM))));
+    } else {
+        return fixed<TO>::from_raw(
+            fixed<TO>::saturate(((int64_t)value.raw + ((int64_t)1 << (FROM - TO - 1))) >> (FROM - TO)));
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// INTEGER ROOTS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief floor(sqrt(value)) without multiplies or divides
+ */
+static inline uint32_t fx_isqrt32(uint32_t value) {
+    uint32_t root = 0;
+    uint32_t bit = 1u << 30;
+    while (bit > value) bit >>= 2;
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+/**
+ * @brief floor(sqrt(value)) for 64-bit sums of squares
+ */
+static inline uint32_t fx_isqrt64(uint64_t value) {
+    if (value <= UINT32_MAX) return fx_isqrt32((uint32_t)value);
+    uint64_t root = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > value) bit >>= 2;
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+/**
+ * @brief Square root of a non-negative fixed-point value (negative → 0)
+ */
+template <int F>
+static inline fixed<F> fx_sqrt(fixed<F> value) {
+    if (value.raw <= 0) return fixed<F>::from_raw(0);
+    return fixed<F>::from_raw((int32_t)fx_isqrt64((uint64_t)value.raw << F));
+}
+
+/**
+ * @brief Vector magnitude in the units of its components (floor)
+ */
+static inline uint32_t fx_magnitude3(int32_t x, int32_t y, int32_t z) {
+    return fx_isqrt64((uint64_t)((int64_t)x * x) + (uint64_t)((int64_t)y * y) + (uint64_t)((int64_t)z * z));
+}
+
+#endif // FIXED_POINT_H
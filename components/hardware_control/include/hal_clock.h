@@ -0,0 +1,38 @@
+// components/hardware_control/include/hal_clock.h
+#ifndef HAL_CLOCK_H
+#define HAL_CLOCK_H
+
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// HAL_CLOCK.H - TIME SOURCE SEAM FOR THE MODE STATE MACHINES
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: The one place mode logic asks for the time
+// - Target: esp_timer_get_time() behind one indirect call
+// - Host simulation (sim/): a virtual clock stepped by the physics model, so
+//   an hour of wire cycles runs in seconds and every run is reproducible
+//
+// The other half of the seam is hardware_control.h itself: the target links
+// hardware_control.cpp, the simulation links sim/src/sim_hardware.cpp.
+// Mode logic includes nothing else from the platform.
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Clock implementation
+typedef struct {
+    int64_t (*now_us)(void);           // Monotonic microseconds since boot
+} hal_clock_t;
+
+/**
+ * @brief Replace the time source (before any task that reads it starts)
+ * @param clock Clock to use, NULL restores esp_timer
+ */
+void hal_clock_install(const hal_clock_t* clock);
+
+/**
+ * @brief Current time from the installed clock
+ * @return Microseconds since boot
+ */
+int64_t hal_clock_now_us(void);
+
+#endif // HAL_CLOCK_H
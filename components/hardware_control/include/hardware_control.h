@@ -2,6 +2,7 @@
 #define HARDWARE_CONTROL_H
 
 #include "esp_err.h"
+#include "esc_output.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -11,22 +12,49 @@
 // 
 // SINGLE RESPONSIBILITY: Hardware abstraction only
 // - ESC PWM control (init, set_duty, arm, disarm)
-// - Hall sensor interrupt handling  
+// - Speed → duty via calibrated lookup table (esc_duty_lut.h)
+// - Hall sensor pulse counting (PCNT) and edge timestamping
 // - GPIO initialization
 // - Basic motor speed commands
 // - Emergency stop (hardware level)
 // 
 // NO business logic, NO mode management - Pure hardware interface
+//
+// This header is the hardware seam: sim/src/sim_hardware.cpp implements it
+// over a trolley physics model for the host simulation build (see hal_clock.h)
 // ═══════════════════════════════════════════════════════════════════════════════
 
 // Hardware configuration constants
 #define WHEEL_CIRCUMFERENCE_MM      191.6f      // 61mm wheel circumference
 #define MM_TO_M                     0.001f      // Conversion factor
-#define MAX_SPEED_MS               2.0f         // Hardware speed limit
+#define MAX_SPEED_MS               5.0f         // Hardware speed limit (top of ESC duty LUT)
 #define ESC_SPEED_DEADBAND         0.05f        // Minimum ESC response speed
-#define ESC_UPDATE_INTERVAL_MS     20           // 50Hz update rate
+#define ESC_SPEED_DEADBAND_MM_S    50           // Same deadband for the integer output path
+#define ESC_MAX_ACCEL_MS2          2.0f         // Speed setpoint acceleration limit (rate limiter)
 #define HALL_TIMEOUT_MS            2000         // Hall sensor timeout
 
+// Hall sensor backend selection
+// 1 = PCNT hardware pulse counter + ISR edge timestamps in a lock-free ring
+// 0 = GPIO ISR counts pulses itself (fallback, no PCNT unit required)
+#ifndef HALL_BACKEND_PCNT
+#define HALL_BACKEND_PCNT          1
+#endif
+#define HALL_MAGNETS_PER_REV       1            // Hall pulses per wheel revolution
+#define HALL_DISTANCE_PER_PULSE_M  (WHEEL_CIRCUMFERENCE_MM * MM_TO_M / HALL_MAGNETS_PER_REV)
+#define WHEEL_CIRCUMFERENCE_UM     ((uint32_t)(WHEEL_CIRCUMFERENCE_MM * 1000.0f + 0.5f))   // Integer path
+#define HALL_DISTANCE_PER_PULSE_UM (WHEEL_CIRCUMFERENCE_UM / HALL_MAGNETS_PER_REV)
+#define HALL_EDGE_RING_SIZE        64           // Edge timestamp ring (power of 2)
+#define HALL_PCNT_HIGH_LIMIT       10000        // PCNT watch point for count accumulation
+#define HALL_GLITCH_FILTER_NS      1000         // PCNT input glitch filter
+#define HALL_GLITCH_FILTER_US      ((HALL_GLITCH_FILTER_NS + 999) / 1000)   // Same width for ISR edges
+
+// Closed-loop speed controller defaults (PI around the ESC duty LUT feed-forward)
+#define SPEED_CTRL_DEFAULT_KP      60.0f        // Duty counts per m/s of speed error
+#define SPEED_CTRL_DEFAULT_KI      120.0f       // Duty counts per m/s per second of error
+#define SPEED_CTRL_DEFAULT_I_LIMIT 80.0f        // Max integrator contribution (duty counts)
+#define SPEED_CTRL_MIN_FEEDBACK_MS 0.3f         // Below this one pulse per revolution is too coarse
+#define SPEED_CTRL_MAX_BIAS_DUTY   80.0f        // Feed-forward bias clamp (duty counts)
+
 // Hardware status structure
 typedef struct {
     bool esc_armed;                    // ESC armed status
@@ -35,12 +63,62 @@ typedef struct {
     float current_speed_ms;            // Current speed from Hall sensor
     float target_speed_ms;             // Target speed command
     bool direction_forward;            // Current direction
-    uint32_t total_rotations;          // Total Hall pulses since init
+    uint32_t total_rotations;          // Total wheel revolutions since init
     uint64_t last_hall_time;           // Last Hall pulse timestamp
     bool hall_sensor_healthy;          // Hall sensor status
     bool system_initialized;           // Hardware initialization status
 } hardware_status_t;
 
+// ESC arming sequence (stepped by the control loop, see hardware_esc_arm)
+typedef enum {
+    ESC_ARM_DISARMED = 0,               // Neutral, motor commands rejected
+    ESC_ARM_SETTLING,                   // Requested, waiting out ESC_POWER_SETTLE_MS after boot
+    ESC_ARM_NEUTRAL,                    // Neutral hold (ESC_ARM_NEUTRAL_MS)
+    ESC_ARM_SIGNAL,                     // Arming pulse (ESC_ARM_TIME_MS)
+    ESC_ARM_ARMED                       // Ready for motor commands
+} esc_arm_state_t;
+
+// Hall backend diagnostics
+typedef struct {
+    bool pcnt_backend;                 // true if PCNT counts pulses in hardware
+    uint32_t total_pulses;             // Raw Hall pulses (all magnets)
+    uint32_t timestamps_captured;      // Edge timestamps pushed into the ring
+    uint32_t timestamps_dropped;       // Timestamps lost to ring overrun (count still exact)
+    uint32_t glitches_rejected;        // ISR edges inside the glitch filter of the previous edge
+    uint32_t batches_processed;        // Processing task batches with new pulses
+    uint32_t max_batch_size;           // Largest number of edges drained in one batch
+} hall_backend_stats_t;
+
+// Hall edges drained by one sense update (input to the state estimator)
+typedef struct {
+    uint32_t new_pulses;               // Pulses counted by this sense update
+    uint32_t edge_count;               // Edge timestamps drained by this sense update
+    uint64_t newest_edge_us;           // Timestamp of newest drained edge (0 if none)
+    int32_t position_pulses;           // Direction-signed Hall position in pulses (exact)
+    float position_m;                  // Same position in meters
+    uint32_t position_resets;          // Incremented by hardware_reset_position()
+} hall_batch_t;
+
+// Speed controller tuning (units are LEDC duty counts)
+typedef struct {
+    float kp;                          // Proportional gain (counts per m/s)
+    float ki;                          // Integral gain (counts per m/s per second)
+    float integrator_limit;            // Integrator clamp (counts)
+    float accel_limit_ms2;             // Setpoint acceleration limit
+} speed_controller_gains_t;
+
+// Speed controller state (published every control loop tick)
+typedef struct {
+    bool closed_loop;                  // Feedback active this tick
+    float setpoint_ms;                 // Acceleration-limited setpoint
+    float measured_ms;                 // Estimated speed used as feedback
+    uint16_t feed_forward_duty;        // LUT duty for the setpoint
+    float bias_duty;                   // Feed-forward bias applied (counts, closed loop only)
+    float correction_duty;             // P + I correction (counts)
+    float integrator_duty;             // Integrator state (counts)
+    bool saturated;                    // Output clamped, integrator held
+} speed_controller_status_t;
+
 // Hardware error types
 typedef enum {
     HW_ERROR_NONE = 0,
@@ -65,9 +143,17 @@ esp_err_t hardware_init(void);
 /**
  * @brief Get current hardware status
  * @return hardware_status_t structure with current state
+ * @note Safe from any task/core: each section (Hall, ESC output, command) is
+ *       a tear-free snapshot, no mutex is taken
  */
 hardware_status_t hardware_get_status(void);
 
+/**
+ * @brief Get change counter for hardware status
+ * @return Value that changes whenever any part of hardware status is republished
+ */
+uint32_t hardware_get_status_generation(void);
+
 /**
  * @brief Get last hardware error
  * @return hardware_error_t error code
@@ -85,14 +171,32 @@ bool hardware_is_ready(void);
 // ═══════════════════════════════════════════════════════════════════════════════
 
 /**
- * @brief Arm the ESC (required before motor operation)
- * @return ESP_OK on success, error code on failure
+ * @brief Start arming the ESC (required before motor operation)
+ * @return ESP_OK if the sequence started or the ESC is already armed/arming,
+ *         ESP_ERR_INVALID_STATE if hardware is not initialized
+ * @note Non-blocking: the control loop steps the neutral → arm pulse → neutral
+ *       sequence; poll hardware_esc_is_armed() or hardware_esc_get_arm_state()
  */
 esp_err_t hardware_esc_arm(void);
 
+/**
+ * @brief Get arming sequence state
+ * @return Current arming state
+ */
+esc_arm_state_t hardware_esc_get_arm_state(void);
+
+/**
+ * @brief Get arming state name
+ * @param state Arming state
+ * @return String name
+ */
+const char* hardware_esc_arm_state_to_string(esc_arm_state_t state);
+
 /**
  * @brief Disarm the ESC (safe state)
  * @return ESP_OK on success, error code on failure
+ * @note Safe from any task: writes neutral and posts the disarm, which the
+ *       control loop's output stage applies to the command on its next tick
  */
 esp_err_t hardware_esc_disarm(void);
 
@@ -110,9 +214,22 @@ bool hardware_esc_is_armed(void);
  */
 esp_err_t hardware_set_motor_speed(float speed_ms, bool forward);
 
+/**
+ * @brief Set speed target held by the closed-loop controller
+ * @param speed_ms Speed in meters per second (0.0 to MAX_SPEED_MS)
+ * @param forward Direction (true = forward, false = reverse)
+ * @return ESP_OK on success, error code on failure
+ * @note Duty = LUT feed-forward + PI on Hall speed error. hardware_set_motor_speed()
+ *       stays open-loop (LUT only) so calibration sweeps measure the raw ESC
+ */
+esp_err_t hardware_set_speed_closed_loop(float speed_ms, bool forward);
+
 /**
  * @brief Emergency stop - immediate motor halt
  * @return ESP_OK on success, error code on failure
+ * @note Safe from any task: writes neutral and sets a latch that holds the
+ *       output at neutral and refuses speed commands until the output stage
+ *       has zeroed the command (next control tick)
  */
 esp_err_t hardware_emergency_stop(void);
 
@@ -150,6 +267,19 @@ uint64_t hardware_get_time_since_last_hall_pulse(void);
  */
 bool hardware_is_hall_sensor_healthy(void);
 
+/**
+ * @brief Get Hall backend counters (pulse totals, ring overruns, batching)
+ * @return hall_backend_stats_t structure with current counters
+ */
+hall_backend_stats_t hardware_get_hall_stats(void);
+
+/**
+ * @brief Get the Hall edges drained by the last hardware_sense_update()
+ * @return hall_batch_t structure
+ * @note Control loop task only (same task as hardware_sense_update)
+ */
+hall_batch_t hardware_get_last_hall_batch(void);
+
 /**
  * @brief Calculate distance traveled from rotation count
  * @param rotations Number of rotations
@@ -157,6 +287,13 @@ bool hardware_is_hall_sensor_healthy(void);
  */
 float hardware_rotations_to_distance(uint32_t rotations);
 
+/**
+ * @brief Integer-only hardware_rotations_to_distance()
+ * @param rotations Number of rotations
+ * @return Distance in millimeters (rounded)
+ */
+uint32_t hardware_rotations_to_distance_mm(uint32_t rotations);
+
 /**
  * @brief Calculate rotations needed for given distance
  * @param distance_m Distance in meters
@@ -188,11 +325,27 @@ float hardware_get_current_position(void);
 esp_err_t hardware_reset_position(void);
 
 /**
- * @brief Update hardware control loop (call regularly)
+ * @brief Update hardware housekeeping (call regularly, not time-critical)
  * @return ESP_OK on success
  */
 esp_err_t hardware_update(void);
 
+/**
+ * @brief Control loop sense stage: drain Hall edges, update speed/position
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not initialized
+ * @note Call from the control loop task only (single writer of Hall state)
+ */
+esp_err_t hardware_sense_update(void);
+
+/**
+ * @brief Control loop output stage: ramp setpoint, run speed controller, apply ESC duty
+ * @param dt_us Time since previous call in microseconds (scales rate limit)
+ * @param measured_speed_ms Estimated speed magnitude used as controller feedback
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not initialized
+ * @note Call from the control loop task only
+ */
+esp_err_t hardware_output_update(uint32_t dt_us, float measured_speed_ms);
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // UTILITY FUNCTIONS
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -260,11 +413,49 @@ esp_err_t hardware_set_esc_duty_direct(uint16_t duty_cycle);
  */
 uint16_t hardware_get_esc_duty(void);
 
+/**
+ * @brief Switch the ESC signal protocol at runtime
+ * @param protocol PWM50, OneShot125, Multishot or DShot300/600
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE unless the ESC is disarmed,
+ *         driver error otherwise (previous protocol kept)
+ * @note The ESC must be configured for the protocol; re-arm afterwards
+ */
+esp_err_t hardware_esc_set_protocol(esc_protocol_t protocol);
+
 /**
  * @brief Enable/disable ESC rate limiting
- * @param enable Enable rate limiting for smooth acceleration
+ * @param enable Limit setpoint changes to accel_limit_ms2 for smooth acceleration
  * @return ESP_OK on success
  */
 esp_err_t hardware_set_esc_rate_limiting(bool enable);
 
+/**
+ * @brief Set speed controller gains and acceleration limit
+ * @param gains New tuning (applied at the next control loop tick)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if any value is negative
+ */
+esp_err_t hardware_set_speed_controller_gains(const speed_controller_gains_t* gains);
+
+/**
+ * @brief Get active speed controller gains
+ * @return speed_controller_gains_t structure
+ */
+speed_controller_gains_t hardware_get_speed_controller_gains(void);
+
+/**
+ * @brief Get speed controller state from the last control loop tick
+ * @return speed_controller_status_t structure
+ */
+speed_controller_status_t hardware_get_speed_controller_status(void);
+
+/**
+ * @brief Add a duty bias to the closed-loop feed-forward
+ * @param bias_duty Duty counts toward the travel direction (+ pushes harder, e.g. uphill),
+ *        clamped to ±SPEED_CTRL_MAX_BIAS_DUTY; reset to 0 by disarm and emergency stop
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not initialized
+ * @note Lets a position-dependent load (wire map grade/friction) be fed forward
+ *       instead of waiting for the integrator to wind up
+ */
+esp_err_t hardware_set_feed_forward_bias(float bias_duty);
+
 #endif // HARDWARE_CONTROL_H
\ No newline at end of file
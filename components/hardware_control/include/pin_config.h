@@ -16,6 +16,7 @@
 #define I2C_SDA_PIN             ((gpio_num_t)8)     // I2C SDA (ESP32-S3 default)
 #define I2C_SCL_PIN             ((gpio_num_t)9)     // I2C SCL (ESP32-S3 default)
 #define I2C_PORT_NUM            I2C_NUM_0
+#define IMU_INT_PIN             ((gpio_num_t)5)     // MPU6050 INT (data ready, active high)
 
 // Status LED Pins - ESP32-S3 compatible
 #define STATUS_LED_PIN          ((gpio_num_t)2)     // Built-in RGB LED data pin on ESP32-S3
@@ -45,9 +46,10 @@
 #define ESC_ARM_DUTY            819    // 1000us pulse for arming - 14-bit
 
 // ESC Configuration - Same as ESP32
+#define ESC_POWER_SETTLE_MS     2000   // ESC power-up settle at neutral before arming
+#define ESC_ARM_NEUTRAL_MS      1000   // Neutral hold before the arming signal
 #define ESC_ARM_TIME_MS         3000   // Time to keep arming signal (3 seconds)
 #define ESC_DEADBAND            50     // Deadband around neutral position
-#define ESC_MAX_SPEED_CHANGE    100    // Maximum speed change per update
 
 // Direction control for brushless motor
 typedef enum {
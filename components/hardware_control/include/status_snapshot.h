@@ -0,0 +1,101 @@
+// components/hardware_control/include/status_snapshot.h
+#ifndef STATUS_SNAPSHOT_H
+#define STATUS_SNAPSHOT_H
+
+#include <atomic>
+#include <cstring>
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STATUS_SNAPSHOT.H - TEAR-FREE PUBLISHED STATE FOR CROSS-CORE READERS
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Publish a struct so that any task on any core can read
+// a consistent copy without a mutex.
+// - Two copies guarded by a sequence counter (seqlock "latch" variant)
+// - Readers always copy the buffer the writer is NOT touching, so a reader
+//   that preempts a writer on the same core never spins
+// - Writers never wait: concurrent publish_from() calls coalesce, the task
+//   already publishing picks up the newer source before it finishes
+// - generation() advances once per publish (usable as a change token)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+template <typename T>
+class status_snapshot {
+public:
+    status_snapshot() : m_sequence(0), m_pending(false), m_busy(false) {
+        memset(m_buffer, 0, sizeof(m_buffer));
+    }
+
+    /**
+     * @brief Publish a new value (single writer only)
+     * @param value New state to publish
+     */
+    void write(const T& value) {
+        uint32_t seq = m_sequence.load(std::memory_order_relaxed);
+
+        // Odd sequence: readers use buffer[1] while buffer[0] is rewritten
+        m_sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&m_buffer[0], &value, sizeof(T));
+
+        // Even sequence: readers use buffer[0] while buffer[1] is rewritten
+        m_sequence.store(seq + 2, std::memory_order_release);
+        memcpy(&m_buffer[1], &value, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    /**
+     * @brief Publish *source from any task without blocking
+     * @param source Live state owned by the caller's component
+     *
+     * If another task is already publishing, this call only marks the state
+     * dirty and returns; the active publisher copies the source again.
+     */
+    void publish_from(const T* source) {
+        m_pending.store(true, std::memory_order_release);
+
+        while (!m_busy.exchange(true, std::memory_order_acquire)) {
+            while (m_pending.exchange(false, std::memory_order_acq_rel)) {
+                write(*source);
+            }
+            m_busy.store(false, std::memory_order_release);
+
+            // A writer that saw us busy after our last check left work behind
+            if (!m_pending.load(std::memory_order_acquire)) {
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Read a consistent copy of the last published value
+     * @return Copy of the published state
+     */
+    T read() const {
+        T value;
+        uint32_t seq;
+        do {
+            seq = m_sequence.load(std::memory_order_acquire);
+            memcpy(&value, &m_buffer[seq & 1], sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while (m_sequence.load(std::memory_order_relaxed) != seq);
+        return value;
+    }
+
+    /**
+     * @brief Number of completed publishes since boot
+     * @return Generation counter (changes whenever new state is published)
+     */
+    uint32_t generation(void) const {
+        return m_sequence.load(std::memory_order_acquire) >> 1;
+    }
+
+private:
+    T m_buffer[2];
+    std::atomic<uint32_t> m_sequence;
+    std::atomic<bool> m_pending;
+    std::atomic<bool> m_busy;
+};
+
+#endif // STATUS_SNAPSHOT_H
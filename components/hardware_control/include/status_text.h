@@ -0,0 +1,116 @@
+// components/hardware_control/include/status_text.h
+#ifndef STATUS_TEXT_H
+#define STATUS_TEXT_H
+
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STATUS_TEXT.H - INTERNED STATUS AND ERROR MESSAGES
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: One code per user-facing status line
+// - Status structs carry a status_text_t (1 byte) instead of char[128]
+//   buffers, so snapshots and getters copy tens of bytes, not hundreds
+// - The strings live once in flash (rodata), looked up at display time
+// - Numbers that used to be formatted into a message are fields of the same
+//   struct; logs keep printing them
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef enum : uint8_t {
+    STATUS_TEXT_NONE = 0,                           // Empty string
+
+    // Shared
+    STATUS_TEXT_ARMING_ESC,
+    STATUS_TEXT_ARM_FAILED,
+    STATUS_TEXT_ARM_CANCELLED,
+    STATUS_TEXT_EMERGENCY_STOP,
+    STATUS_TEXT_SYSTEM_INITIALIZING,
+
+    // Mode coordinator
+    STATUS_TEXT_COORD_WIRE_LEARNING_ACTIVE,
+    STATUS_TEXT_COORD_AUTOMATIC_ACTIVE,
+    STATUS_TEXT_COORD_MANUAL_ACTIVE,
+    STATUS_TEXT_COORD_NO_MODE,
+    STATUS_TEXT_COORD_CALIBRATION_MISMATCH,
+    STATUS_TEXT_VALIDATION_REQUIRED,
+    STATUS_TEXT_VALIDATION_ROTATE_WHEEL,
+    STATUS_TEXT_VALIDATION_HALL_OK,
+    STATUS_TEXT_VALIDATION_SHAKE,
+    STATUS_TEXT_VALIDATION_ACCEL_OK,
+    STATUS_TEXT_VALIDATION_ALL_VALIDATED,
+    STATUS_TEXT_VALIDATION_READY,
+    STATUS_TEXT_VALIDATION_FAILED,
+
+    // Sensor health
+    STATUS_TEXT_SENSOR_ROTATE_WHEEL,
+    STATUS_TEXT_SENSOR_SHAKE_TROLLEY,
+    STATUS_TEXT_SENSOR_NO_ROTATION,
+    STATUS_TEXT_SENSOR_BOTH_VALIDATED,
+    STATUS_TEXT_SENSOR_ACCEL_FAULT,
+    STATUS_TEXT_SENSOR_OPERATIONAL,
+
+    // Wire learning
+    STATUS_TEXT_LEARN_READY,
+    STATUS_TEXT_LEARN_INITIALIZING,
+    STATUS_TEXT_LEARN_HOMING,
+    STATUS_TEXT_LEARN_FORWARD,
+    STATUS_TEXT_LEARN_PAUSING,
+    STATUS_TEXT_LEARN_REVERSE,
+    STATUS_TEXT_LEARN_COMPLETE,
+    STATUS_TEXT_LEARN_MISMATCH,
+    STATUS_TEXT_LEARN_LENGTH_RANGE,
+    STATUS_TEXT_LEARN_TIMEOUT,
+    STATUS_TEXT_LEARN_NO_MOTION,
+    STATUS_TEXT_LEARN_STOPPED,
+    STATUS_TEXT_LEARN_STOPPING,
+    STATUS_TEXT_LEARN_RESET,
+
+    // Automatic mode
+    STATUS_TEXT_AUTO_READY,
+    STATUS_TEXT_AUTO_ARMING,
+    STATUS_TEXT_AUTO_ARM_FAILED,
+    STATUS_TEXT_AUTO_LEARNING_REQUIRED,
+    STATUS_TEXT_AUTO_COAST_CAL_ACCELERATING,
+    STATUS_TEXT_AUTO_COAST_CAL_MEASURING,
+    STATUS_TEXT_AUTO_COAST_CAL_COMPLETE,
+    STATUS_TEXT_AUTO_RUN_PLANNED,
+    STATUS_TEXT_AUTO_RUN_CHANGING_SPEED,
+    STATUS_TEXT_AUTO_RUN_CRUISING,
+    STATUS_TEXT_AUTO_RUN_COASTING,
+    STATUS_TEXT_AUTO_FINAL_APPROACH,
+    STATUS_TEXT_AUTO_SEEKING_WIRE_END,
+    STATUS_TEXT_AUTO_WIRE_END_NOT_FOUND,
+    STATUS_TEXT_AUTO_DIRECTION_CHANGE,
+    STATUS_TEXT_AUTO_COMPLETE,
+    STATUS_TEXT_AUTO_STOPPING_GRACEFULLY,
+    STATUS_TEXT_AUTO_INTERRUPTED,
+    STATUS_TEXT_AUTO_EMERGENCY,
+    STATUS_TEXT_AUTO_SAFETY_FAILURE,
+    STATUS_TEXT_AUTO_CALIBRATION_MISMATCH,
+
+    // Manual mode
+    STATUS_TEXT_MANUAL_READY,
+    STATUS_TEXT_MANUAL_ACTIVE_ARM,
+    STATUS_TEXT_MANUAL_STOPPED,
+    STATUS_TEXT_MANUAL_MOTOR_ACTIVE,
+    STATUS_TEXT_MANUAL_MOTOR_STOPPED,
+    STATUS_TEXT_MANUAL_STOPPING_MOTOR,
+    STATUS_TEXT_MANUAL_DISARMING,
+    STATUS_TEXT_MANUAL_DISARMED,
+    STATUS_TEXT_MANUAL_ARMED,
+    STATUS_TEXT_MANUAL_ARM_CANCELLED,
+    STATUS_TEXT_MANUAL_EMERGENCY,
+    STATUS_TEXT_MANUAL_RESET_ARMED,
+    STATUS_TEXT_MANUAL_RESET_DISARMED,
+
+    STATUS_TEXT_COUNT
+} status_text_t;
+
+/**
+ * @brief Message for a status code
+ * @param code Status code
+ * @return Static string in flash ("" for STATUS_TEXT_NONE or an unknown code)
+ */
+const char* status_text_to_string(status_text_t code);
+
+#endif // STATUS_TEXT_H
@@ -0,0 +1,388 @@
+// components/hardware_control/src/esc_duty_lut.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// ESC_DUTY_LUT.CPP - SPEED → DUTY TABLES, CALIBRATION FIT AND NVS STORAGE
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Own the speed→duty tables
+// - Two banks of tables; a rebuild fills the inactive bank and flips the
+//   active index, so the control loop never reads a half-built table
+// - Calibration fit: sort points by duty, force speed monotonic, invert by
+//   piecewise-linear interpolation through (neutral, 0 m/s)
+// - NVS write is deferred to housekeeping (flash writes stall both cores)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "esc_duty_lut.h"
+#include "pin_config.h"
+#include "status_snapshot.h"
+#include "esp_log.h"
+#include "nvs_flash.h"
+#include "nvs.h"
+#include <cinttypes>
+#include <atomic>
+#include <cstring>
+
+static const char* TAG = "ESC_LUT";
+
+#define LUT_DIR_FORWARD             0
+#define LUT_DIR_REVERSE             1
+#define LUT_FORWARD_MAX_OFFSET      (ESC_MAX_DUTY - ESC_NEUTRAL_DUTY)
+#define LUT_REVERSE_MAX_OFFSET      (ESC_NEUTRAL_DUTY - ESC_MIN_DUTY)
+
+// Calibration measurement (duty offset from neutral, measured speed)
+typedef struct {
+    uint16_t offset;
+    uint16_t speed_mm_s;
+} lut_cal_point_t;
+
+// NVS blob layout
+typedef struct {
+    uint32_t version;
+    uint8_t forward_calibrated;
+    uint8_t reverse_calibrated;
+    uint16_t forward_full_duty_speed_mm_s;
+    uint16_t reverse_full_duty_speed_mm_s;
+    uint16_t forward[ESC_LUT_ENTRIES];
+    uint16_t reverse[ESC_LUT_ENTRIES];
+} esc_lut_blob_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// GLOBAL LUT STATE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// [bank][direction][entry] - entries are duty offsets from ESC_NEUTRAL_DUTY
+static uint16_t g_tables[2][2][ESC_LUT_ENTRIES];
+static std::atomic<uint8_t> g_active_bank(0);
+
+static lut_cal_point_t g_cal_points[2][ESC_LUT_MAX_CAL_POINTS];
+static uint8_t g_cal_point_count[2] = {0, 0};
+
+static std::atomic<bool> g_save_pending(false);
+
+static esc_lut_info_t g_info = {};
+static status_snapshot<esc_lut_info_t> g_info_snapshot;
+
+static const uint16_t g_max_offset[2] = { LUT_FORWARD_MAX_OFFSET, LUT_REVERSE_MAX_OFFSET };
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// TABLE CONSTRUCTION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static inline uint32_t entry_speed_mm_s(uint32_t entry) {
+    return (entry * ESC_LUT_MAX_SPEED_MM_S) / (ESC_LUT_ENTRIES - 1);
+}
+
+static void build_factory_table(uint16_t* table, uint16_t max_offset) {
+    // Same linear map as the original float code: full duty at the factory speed
+    for (uint32_t i = 0; i < ESC_LUT_ENTRIES; i++) {
+        uint32_t offset = (entry_speed_mm_s(i) * max_offset) / ESC_LUT_DEFAULT_FULL_SPEED_MM_S;
+        table[i] = (uint16_t)(offset > max_offset ? max_offset : offset);
+    }
+}
+
+static bool build_calibrated_table(uint16_t* table, const lut_cal_point_t* raw_points,
+                                   uint8_t raw_count, uint16_t max_offset,
+                                   uint16_t* full_duty_speed_mm_s) {
+    if (raw_count < ESC_LUT_MIN_CAL_POINTS) return false;
+
+    // Anchor at neutral, then measurements sorted by duty offset
+    lut_cal_point_t points[ESC_LUT_MAX_CAL_POINTS + 1];
+    uint8_t count = 1;
+    points[0].offset = 0;
+    points[0].speed_mm_s = 0;
+
+    for (uint8_t i = 0; i < raw_count; i++) {
+        lut_cal_point_t p = raw_points[i];
+        if (p.offset > max_offset) p.offset = max_offset;
+        uint8_t j = count;
+        while (j > 1 && points[j - 1].offset > p.offset) {
+            points[j] = points[j - 1];
+            j--;
+        }
+        points[j] = p;
+        count++;
+    }
+
+    // More duty never means less speed - flatten measurement noise
+    for (uint8_t i = 1; i < count; i++) {
+        if (points[i].speed_mm_s < points[i - 1].speed_mm_s) {
+            points[i].speed_mm_s = points[i - 1].speed_mm_s;
+        }
+    }
+
+    const lut_cal_point_t* last = &points[count - 1];
+    if (last->speed_mm_s == 0) return false;    // Never moved - nothing to fit
+
+    // Slope of the last segment that actually gained speed (for extrapolation)
+    uint8_t k = count - 1;
+    while (k > 0 && points[k - 1].speed_mm_s == last->speed_mm_s) k--;
+    const lut_cal_point_t* seg_lo = (k > 0) ? &points[k - 1] : &points[0];
+    const lut_cal_point_t* seg_hi = &points[k];
+    uint32_t seg_doffset = seg_hi->offset - seg_lo->offset;
+    uint32_t seg_dspeed = seg_hi->speed_mm_s - seg_lo->speed_mm_s;
+
+    table[0] = 0;
+    uint8_t seg = 1;
+    for (uint32_t i = 1; i < ESC_LUT_ENTRIES; i++) {
+        uint32_t target = entry_speed_mm_s(i);
+        uint32_t offset;
+
+        while (seg < count && points[seg].speed_mm_s < target) seg++;
+
+        if (seg < count) {
+            // Inverse interpolation inside the measured range
+            const lut_cal_point_t* lo = &points[seg - 1];
+            const lut_cal_point_t* hi = &points[seg];
+            uint32_t dspeed = hi->speed_mm_s - lo->speed_mm_s;
+            offset = lo->offset;
+            if (dspeed > 0) {
+                offset += ((uint32_t)(hi->offset - lo->offset) * (target - lo->speed_mm_s)) / dspeed;
+            }
+        } else if (seg_dspeed > 0) {
+            // Beyond the fastest measurement - extend the last slope
+            offset = seg_hi->offset + (seg_doffset * (target - seg_hi->speed_mm_s)) / seg_dspeed;
+        } else {
+            offset = max_offset;
+        }
+
+        if (offset > max_offset) offset = max_offset;
+        if (offset < table[i - 1]) offset = table[i - 1];
+        table[i] = (uint16_t)offset;
+    }
+
+    // Estimated speed at full duty (what this unit can actually reach)
+    uint32_t full_speed = last->speed_mm_s;
+    if (last->offset < max_offset && seg_doffset > 0) {
+        full_speed += (seg_dspeed * (max_offset - last->offset)) / seg_doffset;
+    }
+    *full_duty_speed_mm_s = (uint16_t)(full_speed > UINT16_MAX ? UINT16_MAX : full_speed);
+    return true;
+}
+
+static void publish_info(void) {
+    g_info.save_pending = g_save_pending.load(std::memory_order_relaxed);
+    g_info.forward_points = g_cal_point_count[LUT_DIR_FORWARD];
+    g_info.reverse_points = g_cal_point_count[LUT_DIR_REVERSE];
+    g_info_snapshot.publish_from(&g_info);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// NVS STORAGE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static esp_err_t load_from_nvs(uint8_t bank) {
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(ESC_LUT_NVS_NAMESPACE, NVS_READONLY, &handle);
+    if (ret != ESP_OK) return ret;
+
+    static esc_lut_blob_t blob;
+    size_t size = sizeof(blob);
+    ret = nvs_get_blob(handle, ESC_LUT_NVS_KEY, &blob, &size);
+    nvs_close(handle);
+    if (ret != ESP_OK) return ret;
+
+    if (size != sizeof(blob) || blob.version != ESC_LUT_VERSION) {
+        ESP_LOGW(TAG, "Stored LUT has wrong layout (v%" PRIu32 ", %u bytes) - ignoring",
+                 blob.version, (unsigned)size);
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    if (blob.forward_calibrated) {
+        memcpy(g_tables[bank][LUT_DIR_FORWARD], blob.forward, sizeof(blob.forward));
+        g_info.forward_full_duty_speed_mm_s = blob.forward_full_duty_speed_mm_s;
+    }
+    if (blob.reverse_calibrated) {
+        memcpy(g_tables[bank][LUT_DIR_REVERSE], blob.reverse, sizeof(blob.reverse));
+        g_info.reverse_full_duty_speed_mm_s = blob.reverse_full_duty_speed_mm_s;
+    }
+    g_info.forward_calibrated = blob.forward_calibrated;
+    g_info.reverse_calibrated = blob.reverse_calibrated;
+    return ESP_OK;
+}
+
+static esp_err_t save_to_nvs(void) {
+    static esc_lut_blob_t blob;
+    uint8_t bank = g_active_bank.load(std::memory_order_acquire);
+
+    memset(&blob, 0, sizeof(blob));
+    blob.version = ESC_LUT_VERSION;
+    blob.forward_calibrated = g_info.forward_calibrated;
+    blob.reverse_calibrated = g_info.reverse_calibrated;
+    blob.forward_full_duty_speed_mm_s = g_info.forward_full_duty_speed_mm_s;
+    blob.reverse_full_duty_speed_mm_s = g_info.reverse_full_duty_speed_mm_s;
+    memcpy(blob.forward, g_tables[bank][LUT_DIR_FORWARD], sizeof(blob.forward));
+    memcpy(blob.reverse, g_tables[bank][LUT_DIR_REVERSE], sizeof(blob.reverse));
+
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(ESC_LUT_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (ret != ESP_OK) return ret;
+
+    ret = nvs_set_blob(handle, ESC_LUT_NVS_KEY, &blob, sizeof(blob));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return ret;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t esc_lut_init(void) {
+    ESP_LOGI(TAG, "Initializing ESC duty LUT (%d entries, 0-%d mm/s)...",
+             ESC_LUT_ENTRIES, ESC_LUT_MAX_SPEED_MM_S);
+
+    memset(&g_info, 0, sizeof(g_info));
+    g_info.forward_full_duty_speed_mm_s = ESC_LUT_DEFAULT_FULL_SPEED_MM_S;
+    g_info.reverse_full_duty_speed_mm_s = ESC_LUT_DEFAULT_FULL_SPEED_MM_S;
+
+    build_factory_table(g_tables[0][LUT_DIR_FORWARD], LUT_FORWARD_MAX_OFFSET);
+    build_factory_table(g_tables[0][LUT_DIR_REVERSE], LUT_REVERSE_MAX_OFFSET);
+
+    esp_err_t ret = load_from_nvs(0);
+    if (ret == ESP_OK) {
+        g_info.loaded_from_nvs = true;
+        ESP_LOGI(TAG, "Calibrated LUT restored (forward %s, reverse %s)",
+                 g_info.forward_calibrated ? "yes" : "factory",
+                 g_info.reverse_calibrated ? "yes" : "factory");
+    } else {
+        ESP_LOGI(TAG, "No calibrated LUT stored - using factory linear map");
+    }
+
+    g_active_bank.store(0, std::memory_order_release);
+    publish_info();
+    return ESP_OK;
+}
+
+uint16_t esc_lut_speed_to_duty(uint16_t speed_mm_s, bool forward) {
+    if (speed_mm_s > ESC_LUT_MAX_SPEED_MM_S) speed_mm_s = ESC_LUT_MAX_SPEED_MM_S;
+
+    const uint16_t* table = g_tables[g_active_bank.load(std::memory_order_acquire)]
+                                    [forward ? LUT_DIR_FORWARD : LUT_DIR_REVERSE];
+
+    // Position in entries, Q8 fixed point
+    uint32_t position_q8 = ((uint32_t)speed_mm_s * (ESC_LUT_ENTRIES - 1) << 8) / ESC_LUT_MAX_SPEED_MM_S;
+    uint32_t index = position_q8 >> 8;
+    uint32_t fraction = position_q8 & 0xFF;
+
+    uint32_t offset = table[index];
+    if (index < ESC_LUT_ENTRIES - 1) {
+        offset += ((uint32_t)(table[index + 1] - table[index]) * fraction) >> 8;
+    }
+
+    return forward ? (uint16_t)(ESC_NEUTRAL_DUTY + offset) : (uint16_t)(ESC_NEUTRAL_DUTY - offset);
+}
+
+esp_err_t esc_lut_calibration_begin(void) {
+    g_cal_point_count[LUT_DIR_FORWARD] = 0;
+    g_cal_point_count[LUT_DIR_REVERSE] = 0;
+    publish_info();
+    ESP_LOGI(TAG, "Calibration sweep started");
+    return ESP_OK;
+}
+
+esp_err_t esc_lut_calibration_add_point(bool forward, uint16_t duty, uint16_t measured_speed_mm_s) {
+    int dir = forward ? LUT_DIR_FORWARD : LUT_DIR_REVERSE;
+
+    if (forward ? (duty < ESC_NEUTRAL_DUTY) : (duty > ESC_NEUTRAL_DUTY)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (g_cal_point_count[dir] >= ESC_LUT_MAX_CAL_POINTS) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    lut_cal_point_t* point = &g_cal_points[dir][g_cal_point_count[dir]++];
+    point->offset = forward ? (duty - ESC_NEUTRAL_DUTY) : (ESC_NEUTRAL_DUTY - duty);
+    point->speed_mm_s = measured_speed_mm_s;
+
+    publish_info();
+    return ESP_OK;
+}
+
+esp_err_t esc_lut_calibration_commit(void) {
+    uint8_t active = g_active_bank.load(std::memory_order_acquire);
+    uint8_t target = active ^ 1;
+    bool calibrated[2] = {false, false};
+    uint16_t full_speed[2] = {g_info.forward_full_duty_speed_mm_s, g_info.reverse_full_duty_speed_mm_s};
+
+    for (int dir = 0; dir < 2; dir++) {
+        calibrated[dir] = build_calibrated_table(g_tables[target][dir], g_cal_points[dir],
+                                                 g_cal_point_count[dir], g_max_offset[dir],
+                                                 &full_speed[dir]);
+        if (!calibrated[dir]) {
+            // Keep whatever this direction had before
+            memcpy(g_tables[target][dir], g_tables[active][dir], sizeof(g_tables[target][dir]));
+        }
+    }
+
+    if (!calibrated[LUT_DIR_FORWARD] && !calibrated[LUT_DIR_REVERSE]) {
+        ESP_LOGW(TAG, "Calibration commit skipped - not enough points (fwd %u, rev %u)",
+                 g_cal_point_count[LUT_DIR_FORWARD], g_cal_point_count[LUT_DIR_REVERSE]);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    g_active_bank.store(target, std::memory_order_release);
+
+    for (int dir = 0; dir < 2; dir++) {
+        if (!calibrated[dir]) continue;
+        if (dir == LUT_DIR_FORWARD) {
+            g_info.forward_calibrated = true;
+            g_info.forward_full_duty_speed_mm_s = full_speed[dir];
+        } else {
+            g_info.reverse_calibrated = true;
+            g_info.reverse_full_duty_speed_mm_s = full_speed[dir];
+        }
+    }
+    g_save_pending.store(true, std::memory_order_release);
+    publish_info();
+
+    ESP_LOGI(TAG, "Calibrated LUT active: forward %s (%u mm/s at full duty), reverse %s (%u mm/s)",
+             calibrated[LUT_DIR_FORWARD] ? "new" : "kept", g_info.forward_full_duty_speed_mm_s,
+             calibrated[LUT_DIR_REVERSE] ? "new" : "kept", g_info.reverse_full_duty_speed_mm_s);
+    return ESP_OK;
+}
+
+esp_err_t esc_lut_process_pending_save(void) {
+    if (!g_save_pending.exchange(false, std::memory_order_acq_rel)) {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = save_to_nvs();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to save LUT to NVS: %s", esp_err_to_name(ret));
+    } else {
+        ESP_LOGI(TAG, "Calibrated LUT saved to NVS");
+    }
+    publish_info();
+    return ret;
+}
+
+esp_err_t esc_lut_reset_to_default(void) {
+    uint8_t target = g_active_bank.load(std::memory_order_acquire) ^ 1;
+
+    build_factory_table(g_tables[target][LUT_DIR_FORWARD], LUT_FORWARD_MAX_OFFSET);
+    build_factory_table(g_tables[target][LUT_DIR_REVERSE], LUT_REVERSE_MAX_OFFSET);
+    g_active_bank.store(target, std::memory_order_release);
+
+    g_info.forward_calibrated = false;
+    g_info.reverse_calibrated = false;
+    g_info.loaded_from_nvs = false;
+    g_info.forward_full_duty_speed_mm_s = ESC_LUT_DEFAULT_FULL_SPEED_MM_S;
+    g_info.reverse_full_duty_speed_mm_s = ESC_LUT_DEFAULT_FULL_SPEED_MM_S;
+    g_save_pending.store(false, std::memory_order_release);
+
+    nvs_handle_t handle;
+    if (nvs_open(ESC_LUT_NVS_NAMESPACE, NVS_READWRITE, &handle) == ESP_OK) {
+        nvs_erase_key(handle, ESC_LUT_NVS_KEY);
+        nvs_commit(handle);
+        nvs_close(handle);
+    }
+
+    publish_info();
+    ESP_LOGI(TAG, "LUT reset to factory linear map");
+    return ESP_OK;
+}
+
+esc_lut_info_t esc_lut_get_info(void) {
+    return g_info_snapshot.read();
+}
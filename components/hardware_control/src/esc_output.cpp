@@ -0,0 +1,562 @@
+// components/hardware_control/src/esc_output.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// ESC_OUTPUT.CPP - LEDC / MCPWM / RMT ESC SIGNAL BACKENDS
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// One backend owns ESC_PWM_PIN at a time. Writers (control loop output stage,
+// disarm, e-stop) only ever call esc_output_set():
+// - PWM50 / OneShot125 / Multishot: the duty goes straight to the peripheral's
+//   shadow register; hardware picks it up at the next period start
+// - DShot: the duty goes to g_mailbox; pump_dshot() (esp_timer task, every
+//   frame period) encodes the newest value and hands one frame to RMT. The
+//   ESC keeps receiving frames when the control loop stalls, as DShot needs
+//
+// Switching backends waits for in-flight writers (g_writers) after taking the
+// backend away, so a writer never touches a peripheral being deleted.
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "sdkconfig.h"
+#include "esc_output.h"
+#include "pin_config.h"
+#include "hardware_control.h"
+#include "status_snapshot.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "driver/ledc.h"
+#include "driver/mcpwm_prelude.h"
+#include "driver/rmt_tx.h"
+#include "driver/rmt_rx.h"
+#include "driver/rmt_encoder.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <cstring>
+
+static const char* TAG = "ESC_OUTPUT";
+
+#ifdef CONFIG_TROLLEY_ESC_DSHOT_TELEMETRY
+#define ESC_DSHOT_TELEMETRY         1
+#else
+#define ESC_DSHOT_TELEMETRY         0
+#endif
+
+#define ESC_FORWARD_SPAN            (ESC_MAX_DUTY - ESC_NEUTRAL_DUTY)
+#define ESC_REVERSE_SPAN            (ESC_NEUTRAL_DUTY - ESC_MIN_DUTY)
+#define ESC_MAILBOX_ARM             0           // Not a valid duty: "send the arming signal"
+
+#define DSHOT_RX_SYMBOLS            96          // Own frame (loop-back) + 21-bit reply
+#define DSHOT_REPLY_BITS            21
+#define DSHOT_REPLY_GAP_BITS        6           // Idle run that separates our frame from the reply
+#define DSHOT_RX_MIN_NS             200         // Glitch filter
+#define DSHOT_RX_MAX_NS             50000       // Idle that ends a reception (reply starts ~30 µs after the frame)
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// BACKEND TABLE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    esc_protocol_t protocol;
+    const char* name;
+    uint32_t frame_rate_hz;
+    esp_err_t (*start)(esc_protocol_t protocol);
+    void (*stop)(void);
+    void (*apply)(uint16_t duty);      // Writer context; DShot leaves it to the pump
+} esc_backend_t;
+
+static std::atomic<const esc_backend_t*> g_backend{nullptr};
+static std::atomic<uint32_t> g_writers{0};
+static std::atomic<uint16_t> g_mailbox{ESC_NEUTRAL_DUTY};
+
+static std::atomic<uint32_t> g_frames_sent{0};
+static std::atomic<uint32_t> g_frames_skipped{0};
+
+// Signed offset from neutral scaled onto [-half_span, +half_span]
+static inline int32_t scale_offset(uint16_t duty, int32_t half_span) {
+    int32_t offset = (int32_t)duty - ESC_NEUTRAL_DUTY;
+    int32_t span = offset >= 0 ? ESC_FORWARD_SPAN : ESC_REVERSE_SPAN;
+    return (offset * half_span + (offset >= 0 ? span / 2 : -span / 2)) / span;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PWM50 (LEDC)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static esp_err_t ledc_start(esc_protocol_t protocol) {
+    (void)protocol;
+    ledc_timer_config_t ledc_timer = {
+        .speed_mode = LEDC_LOW_SPEED_MODE,
+        .duty_resolution = ESC_PWM_RESOLUTION,
+        .timer_num = ESC_PWM_TIMER,
+        .freq_hz = ESC_PWM_FREQ_HZ,
+        .clk_cfg = LEDC_AUTO_CLK
+    };
+    esp_err_t result = ledc_timer_config(&ledc_timer);
+    if (result != ESP_OK) return result;
+
+    // Also (re)routes the pin to LEDC after another backend had it
+    ledc_channel_config_t esc_channel = {
+        .gpio_num = ESC_PWM_PIN,
+        .speed_mode = LEDC_LOW_SPEED_MODE,
+        .channel = ESC_PWM_CHANNEL,
+        .intr_type = LEDC_INTR_DISABLE,
+        .timer_sel = ESC_PWM_TIMER,
+        .duty = ESC_NEUTRAL_DUTY,
+        .hpoint = 0
+    };
+    return ledc_channel_config(&esc_channel);
+}
+
+static void ledc_stop_output(void) {
+    ledc_stop(LEDC_LOW_SPEED_MODE, ESC_PWM_CHANNEL, 0);
+}
+
+static void ledc_apply(uint16_t duty) {
+    if (duty == ESC_MAILBOX_ARM) duty = ESC_ARM_DUTY;
+    ledc_set_duty(LEDC_LOW_SPEED_MODE, ESC_PWM_CHANNEL, duty);
+    ledc_update_duty(LEDC_LOW_SPEED_MODE, ESC_PWM_CHANNEL);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// ONESHOT125 / MULTISHOT (MCPWM)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static mcpwm_timer_handle_t g_mcpwm_timer = NULL;
+static mcpwm_oper_handle_t g_mcpwm_operator = NULL;
+static mcpwm_cmpr_handle_t g_mcpwm_comparator = NULL;
+static mcpwm_gen_handle_t g_mcpwm_generator = NULL;
+static int32_t g_pulse_neutral_ticks = 0;
+static int32_t g_pulse_half_span_ticks = 0;
+static uint32_t g_pulse_arm_ticks = 0;
+
+static void mcpwm_stop_output(void) {
+    if (g_mcpwm_timer != NULL) {
+        mcpwm_timer_start_stop(g_mcpwm_timer, MCPWM_TIMER_STOP_EMPTY);
+        mcpwm_timer_disable(g_mcpwm_timer);
+    }
+    if (g_mcpwm_generator != NULL) mcpwm_del_generator(g_mcpwm_generator);
+    if (g_mcpwm_comparator != NULL) mcpwm_del_comparator(g_mcpwm_comparator);
+    if (g_mcpwm_operator != NULL) mcpwm_del_operator(g_mcpwm_operator);
+    if (g_mcpwm_timer != NULL) mcpwm_del_timer(g_mcpwm_timer);
+    g_mcpwm_generator = NULL;
+    g_mcpwm_comparator = NULL;
+    g_mcpwm_operator = NULL;
+    g_mcpwm_timer = NULL;
+}
+
+static esp_err_t mcpwm_start(esc_protocol_t protocol) {
+    bool oneshot = (protocol == ESC_PROTOCOL_ONESHOT125);
+    float min_us = oneshot ? ESC_ONESHOT125_MIN_US : ESC_MULTISHOT_MIN_US;
+    float max_us = oneshot ? ESC_ONESHOT125_MAX_US : ESC_MULTISHOT_MAX_US;
+    uint32_t ticks_per_us = ESC_MCPWM_RESOLUTION_HZ / 1000000;
+    g_pulse_neutral_ticks = (int32_t)((min_us + max_us) * 0.5f * ticks_per_us + 0.5f);
+    g_pulse_half_span_ticks = (int32_t)((max_us - min_us) * 0.5f * ticks_per_us + 0.5f);
+    g_pulse_arm_ticks = (uint32_t)(g_pulse_neutral_ticks + scale_offset(ESC_ARM_DUTY, g_pulse_half_span_ticks));
+
+    mcpwm_timer_config_t timer_config = {};
+    timer_config.group_id = 0;
+    timer_config.clk_src = MCPWM_TIMER_CLK_SRC_DEFAULT;
+    timer_config.resolution_hz = ESC_MCPWM_RESOLUTION_HZ;
+    timer_config.count_mode = MCPWM_TIMER_COUNT_MODE_UP;
+    timer_config.period_ticks = (oneshot ? ESC_ONESHOT125_PERIOD_US : ESC_MULTISHOT_PERIOD_US) * ticks_per_us;
+
+    mcpwm_operator_config_t operator_config = {};
+    operator_config.group_id = 0;
+
+    // New width takes effect at the next timer zero: no runt or stretched pulse
+    mcpwm_comparator_config_t comparator_config = {};
+    comparator_config.flags.update_cmp_on_tez = true;
+
+    mcpwm_generator_config_t generator_config = {};
+    generator_config.gen_gpio_num = ESC_PWM_PIN;
+
+    esp_err_t result = mcpwm_new_timer(&timer_config, &g_mcpwm_timer);
+    if (result == ESP_OK) result = mcpwm_new_operator(&operator_config, &g_mcpwm_operator);
+    if (result == ESP_OK) result = mcpwm_operator_connect_timer(g_mcpwm_operator, g_mcpwm_timer);
+    if (result == ESP_OK) result = mcpwm_new_comparator(g_mcpwm_operator, &comparator_config, &g_mcpwm_comparator);
+    if (result == ESP_OK) result = mcpwm_new_generator(g_mcpwm_operator, &generator_config, &g_mcpwm_generator);
+    if (result == ESP_OK) result = mcpwm_comparator_set_compare_value(g_mcpwm_comparator, g_pulse_neutral_ticks);
+    if (result == ESP_OK) {
+        result = mcpwm_generator_set_action_on_timer_event(g_mcpwm_generator,
+                     MCPWM_GEN_TIMER_EVENT_ACTION(MCPWM_TIMER_DIRECTION_UP, MCPWM_TIMER_EVENT_EMPTY, MCPWM_GEN_ACTION_HIGH));
+    }
+    if (result == ESP_OK) {
+        result = mcpwm_generator_set_action_on_compare_event(g_mcpwm_generator,
+                     MCPWM_GEN_COMPARE_EVENT_ACTION(MCPWM_TIMER_DIRECTION_UP, g_mcpwm_comparator, MCPWM_GEN_ACTION_LOW));
+    }
+    if (result == ESP_OK) result = mcpwm_timer_enable(g_mcpwm_timer);
+    if (result == ESP_OK) result = mcpwm_timer_start_stop(g_mcpwm_timer, MCPWM_TIMER_START_NO_STOP);
+
+    if (result != ESP_OK) mcpwm_stop_output();
+    return result;
+}
+
+static void mcpwm_apply(uint16_t duty) {
+    uint32_t ticks = duty == ESC_MAILBOX_ARM ? g_pulse_arm_ticks
+                   : (uint32_t)(g_pulse_neutral_ticks + scale_offset(duty, g_pulse_half_span_ticks));
+    mcpwm_comparator_set_compare_value(g_mcpwm_comparator, ticks);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DSHOT300 / DSHOT600 (RMT)
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// Frame: 11-bit throttle, telemetry request bit, 4-bit checksum, MSB first.
+// Bidirectional DShot inverts the line (idle high) and the checksum; the ESC
+// answers ~30 µs later on the same wire with a GCR-coded eRPM period at 5/4
+// of the bit rate. TX loops back into an RX channel on the pin, so one
+// reception holds our frame, a long idle, then the reply.
+
+static rmt_channel_handle_t g_dshot_tx = NULL;
+static rmt_channel_handle_t g_dshot_rx = NULL;
+static rmt_encoder_handle_t g_dshot_encoder = NULL;
+static esp_timer_handle_t g_dshot_pump = NULL;
+static uint32_t g_dshot_bit_rate = 0;
+static bool g_dshot_telemetry = false;
+static uint8_t g_dshot_frame[2];                     // Pump only, read by RMT while in flight
+static std::atomic<bool> g_dshot_tx_busy{false};
+static std::atomic<bool> g_dshot_pumping{false};      // Pump callback running (teardown waits)
+
+static rmt_symbol_word_t g_dshot_rx_symbols[DSHOT_RX_SYMBOLS];
+static std::atomic<uint32_t> g_dshot_rx_count{0};    // Symbols of the finished reception, 0 = none yet
+static bool g_dshot_rx_armed = false;                // Pump only
+
+static esc_telemetry_t g_telemetry = {};             // Pump only
+static status_snapshot<esc_telemetry_t> g_telemetry_snapshot;
+
+static uint16_t dshot_throttle(uint16_t duty) {
+    if (duty == ESC_MAILBOX_ARM || duty == ESC_NEUTRAL_DUTY) return 0;     // Motor stop / arm
+    const int32_t range = ESC_DSHOT_3D_FORWARD_MAX - ESC_DSHOT_3D_FORWARD_MIN;
+    int32_t scaled = scale_offset(duty, range);
+    if (scaled > 0) return (uint16_t)(ESC_DSHOT_3D_FORWARD_MIN + scaled);
+    if (scaled < 0) return (uint16_t)(ESC_DSHOT_3D_REVERSE_MIN - scaled);
+    return 0;
+}
+
+static void dshot_encode(uint16_t throttle, bool inverted) {
+    uint16_t value = (uint16_t)(throttle << 1);      // Telemetry request bit stays 0
+    uint16_t crc = (value ^ (value >> 4) ^ (value >> 8)) & 0x0F;
+    if (inverted) crc = (~crc) & 0x0F;
+    uint16_t frame = (uint16_t)((value << 4) | crc);
+    g_dshot_frame[0] = (uint8_t)(frame >> 8);
+    g_dshot_frame[1] = (uint8_t)(frame & 0xFF);
+}
+
+static bool IRAM_ATTR dshot_tx_done(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t* event, void* ctx) {
+    (void)channel;
+    (void)event;
+    (void)ctx;
+    g_dshot_tx_busy.store(false, std::memory_order_release);
+    return false;
+}
+
+static bool IRAM_ATTR dshot_rx_done(rmt_channel_handle_t channel, const rmt_rx_done_event_data_t* event, void* ctx) {
+    (void)channel;
+    (void)ctx;
+    g_dshot_rx_count.store(event->num_symbols ? event->num_symbols : 1, std::memory_order_release);
+    return false;
+}
+
+// 5 GCR bits → 4 data bits, 0xFF = invalid code
+static const uint8_t k_gcr_decode[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x09, 0x0A, 0x0B, 0xFF, 0x0D, 0x0E, 0x0F,
+    0xFF, 0xFF, 0x02, 0x03, 0xFF, 0x05, 0x06, 0x07, 0xFF, 0x00, 0x08, 0x01, 0xFF, 0x04, 0x0C, 0xFF
+};
+
+/**
+ * @brief Decode the ESC reply out of one reception
+ * @return eRPM, or -1 if there is no valid reply
+ */
+static int32_t dshot_decode_reply(const rmt_symbol_word_t* symbols, uint32_t count) {
+    // Reply bit in 1/16 RX ticks
+    uint32_t bit_x16 = (uint32_t)((uint64_t)ESC_DSHOT_RESOLUTION_HZ * 16 * 4 / (5ULL * g_dshot_bit_rate));
+    uint32_t value = 0;
+    int bits = 0;
+    bool in_reply = false;
+
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t durations[2] = {symbols[i].duration0, symbols[i].duration1};
+        const uint32_t levels[2] = {symbols[i].level0, symbols[i].level1};
+        for (int half = 0; half < 2; half++) {
+            if (durations[half] == 0) goto done;      // End of reception: trailing idle
+            uint32_t run = (durations[half] * 16 + bit_x16 / 2) / bit_x16;
+            if (!in_reply) {
+                // Our own frame, then the idle-high turnaround gap
+                if (levels[half] == 1 && run >= DSHOT_REPLY_GAP_BITS) in_reply = true;
+                continue;
+            }
+            if (run == 0) run = 1;
+            if (bits + (int)run > DSHOT_REPLY_BITS) return -1;
+            value = (value << run) | (1u << (run - 1));      // Edge = 1, then zeros
+            bits += run;
+        }
+    }
+done:
+    // Trailing high run is cut by the end of reception: fill up to 21 bits
+    if (bits < DSHOT_REPLY_BITS - 3) return -1;
+    if (bits < DSHOT_REPLY_BITS) {
+        int fill = DSHOT_REPLY_BITS - bits;
+        value = (value << fill) | (1u << (fill - 1));
+    }
+
+    uint32_t gcr = (value ^ (value >> 1)) & 0xFFFFF;
+    uint32_t decoded = 0;
+    for (int quintet = 3; quintet >= 0; quintet--) {
+        uint8_t nibble = k_gcr_decode[(gcr >> (quintet * 5)) & 0x1F];
+        if (nibble == 0xFF) return -1;
+        decoded = (decoded << 4) | nibble;
+    }
+
+    uint32_t crc = decoded ^ (decoded >> 8);
+    crc ^= crc >> 4;
+    if ((crc & 0x0F) != 0x0F) return -1;
+
+    decoded >>= 4;
+    if (decoded == 0x0FFF) return 0;                  // Motor stopped
+    uint32_t period_us = (decoded & 0x1FF) << (decoded >> 9);
+    if (period_us == 0) return -1;
+    return (int32_t)(60000000UL / period_us);
+}
+
+static void dshot_update_telemetry(uint64_t now_us) {
+    uint32_t count = g_dshot_rx_count.exchange(0, std::memory_order_acquire);
+    if (count == 0) {
+        if (g_dshot_rx_armed) g_telemetry.errors++;   // Nothing back since the last frame
+    } else {
+        int32_t erpm = dshot_decode_reply(g_dshot_rx_symbols, count);
+        if (erpm >= 0) {
+            float wheel_rpm = (float)erpm / ESC_MOTOR_POLE_PAIRS / ESC_MOTOR_REVS_PER_WHEEL_REV;
+            g_telemetry.erpm = (uint32_t)erpm;
+            g_telemetry.wheel_speed_mm_s = (uint16_t)(wheel_rpm * WHEEL_CIRCUMFERENCE_MM / 60.0f + 0.5f);
+            g_telemetry.timestamp_us = now_us;
+            g_telemetry.frames++;
+        } else {
+            g_telemetry.errors++;
+        }
+    }
+    g_telemetry.valid = g_telemetry.frames > 0 &&
+                        now_us - g_telemetry.timestamp_us <= ESC_DSHOT_TELEMETRY_TIMEOUT_MS * 1000ULL;
+    g_telemetry_snapshot.write(g_telemetry);
+
+    rmt_receive_config_t receive_config = {};
+    receive_config.signal_range_min_ns = DSHOT_RX_MIN_NS;
+    receive_config.signal_range_max_ns = DSHOT_RX_MAX_NS;
+    g_dshot_rx_armed = (rmt_receive(g_dshot_rx, g_dshot_rx_symbols, sizeof(g_dshot_rx_symbols), &receive_config) == ESP_OK);
+}
+
+static void pump_dshot(void* arg) {
+    (void)arg;
+    if (g_dshot_tx_busy.load(std::memory_order_acquire)) {
+        g_frames_skipped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    g_dshot_pumping.store(true, std::memory_order_seq_cst);
+
+    if (g_dshot_telemetry) dshot_update_telemetry(esp_timer_get_time());
+
+    dshot_encode(dshot_throttle(g_mailbox.load(std::memory_order_acquire)), g_dshot_telemetry);
+    rmt_transmit_config_t transmit_config = {};
+    transmit_config.loop_count = 0;
+    g_dshot_tx_busy.store(true, std::memory_order_release);
+    if (rmt_transmit(g_dshot_tx, g_dshot_encoder, g_dshot_frame, sizeof(g_dshot_frame), &transmit_config) == ESP_OK) {
+        g_frames_sent.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        g_dshot_tx_busy.store(false, std::memory_order_release);
+        g_frames_skipped.fetch_add(1, std::memory_order_relaxed);
+    }
+    g_dshot_pumping.store(false, std::memory_order_seq_cst);
+}
+
+static void dshot_stop_output(void) {
+    if (g_dshot_pump != NULL) {
+        esp_timer_stop(g_dshot_pump);
+        while (g_dshot_pumping.load(std::memory_order_seq_cst)) {
+            vTaskDelay(1);                            // A callback already dispatched finishes first
+        }
+        esp_timer_delete(g_dshot_pump);
+    }
+    if (g_dshot_tx != NULL) {
+        rmt_tx_wait_all_done(g_dshot_tx, 10);
+        rmt_disable(g_dshot_tx);
+        rmt_del_channel(g_dshot_tx);
+    }
+    if (g_dshot_rx != NULL) {
+        rmt_disable(g_dshot_rx);
+        rmt_del_channel(g_dshot_rx);
+    }
+    if (g_dshot_encoder != NULL) rmt_del_encoder(g_dshot_encoder);
+    g_dshot_pump = NULL;
+    g_dshot_tx = NULL;
+    g_dshot_rx = NULL;
+    g_dshot_encoder = NULL;
+    g_dshot_tx_busy.store(false, std::memory_order_release);
+    g_dshot_rx_count.store(0, std::memory_order_release);
+    g_dshot_rx_armed = false;
+}
+
+static esp_err_t dshot_start(esc_protocol_t protocol) {
+    g_dshot_bit_rate = (protocol == ESC_PROTOCOL_DSHOT600) ? 600000 : 300000;
+    g_dshot_telemetry = ESC_DSHOT_TELEMETRY;
+    g_telemetry = {};
+    g_telemetry_snapshot.write(g_telemetry);
+
+    uint32_t bit_ticks = ESC_DSHOT_RESOLUTION_HZ / g_dshot_bit_rate;
+    uint32_t t1h = bit_ticks * 3 / 4;                 // '1': 75 % high
+    uint32_t t0h = bit_ticks * 3 / 8;                 // '0': 37.5 % high
+    esp_err_t result = ESP_OK;
+
+    // Receiver first: the transmitter then loops back into it on the same pin
+    if (g_dshot_telemetry) {
+        rmt_rx_channel_config_t rx_config = {};
+        rx_config.gpio_num = ESC_PWM_PIN;
+        rx_config.clk_src = RMT_CLK_SRC_DEFAULT;
+        rx_config.resolution_hz = ESC_DSHOT_RESOLUTION_HZ;
+        rx_config.mem_block_symbols = DSHOT_RX_SYMBOLS;
+        result = rmt_new_rx_channel(&rx_config, &g_dshot_rx);
+        rmt_rx_event_callbacks_t rx_callbacks = {};
+        rx_callbacks.on_recv_done = dshot_rx_done;
+        if (result == ESP_OK) result = rmt_rx_register_event_callbacks(g_dshot_rx, &rx_callbacks, NULL);
+        if (result == ESP_OK) result = rmt_enable(g_dshot_rx);
+    }
+
+    rmt_tx_channel_config_t tx_config = {};
+    tx_config.gpio_num = ESC_PWM_PIN;
+    tx_config.clk_src = RMT_CLK_SRC_DEFAULT;
+    tx_config.resolution_hz = ESC_DSHOT_RESOLUTION_HZ;
+    tx_config.mem_block_symbols = ESC_DSHOT_USE_DMA ? 64 : 48;
+    tx_config.trans_queue_depth = 2;
+    tx_config.flags.with_dma = ESC_DSHOT_USE_DMA;
+    tx_config.flags.invert_out = g_dshot_telemetry;   // Bidirectional: idle high
+    tx_config.flags.io_loop_back = g_dshot_telemetry;
+    tx_config.flags.io_od_mode = g_dshot_telemetry;   // The ESC drives the reply
+    if (result == ESP_OK) result = rmt_new_tx_channel(&tx_config, &g_dshot_tx);
+    rmt_tx_event_callbacks_t tx_callbacks = {};
+    tx_callbacks.on_trans_done = dshot_tx_done;
+    if (result == ESP_OK) result = rmt_tx_register_event_callbacks(g_dshot_tx, &tx_callbacks, NULL);
+
+    rmt_bytes_encoder_config_t encoder_config = {};
+    encoder_config.bit0.level0 = 1;
+    encoder_config.bit0.duration0 = t0h;
+    encoder_config.bit0.level1 = 0;
+    encoder_config.bit0.duration1 = bit_ticks - t0h;
+    encoder_config.bit1.level0 = 1;
+    encoder_config.bit1.duration0 = t1h;
+    encoder_config.bit1.level1 = 0;
+    encoder_config.bit1.duration1 = bit_ticks - t1h;
+    encoder_config.flags.msb_first = 1;
+    if (result == ESP_OK) result = rmt_new_bytes_encoder(&encoder_config, &g_dshot_encoder);
+    if (result == ESP_OK) result = rmt_enable(g_dshot_tx);
+    if (g_dshot_telemetry && result == ESP_OK) gpio_pullup_en(ESC_PWM_PIN);
+
+    esp_timer_create_args_t pump_args = {};
+    pump_args.callback = pump_dshot;
+    pump_args.name = "esc_dshot";
+    if (result == ESP_OK) result = esp_timer_create(&pump_args, &g_dshot_pump);
+    if (result == ESP_OK) result = esp_timer_start_periodic(g_dshot_pump, 1000000 / ESC_DSHOT_FRAME_RATE_HZ);
+
+    if (result != ESP_OK) dshot_stop_output();
+    return result;
+}
+
+static void dshot_apply(uint16_t duty) {
+    (void)duty;                                       // The pump reads g_mailbox
+}
+
+static const esc_backend_t k_backends[ESC_PROTOCOL_COUNT] = {
+    {ESC_PROTOCOL_PWM50,      "PWM50",      ESC_PWM_FREQ_HZ,                     ledc_start,  ledc_stop_output,  ledc_apply},
+    {ESC_PROTOCOL_ONESHOT125, "OneShot125", 1000000 / ESC_ONESHOT125_PERIOD_US,  mcpwm_start, mcpwm_stop_output, mcpwm_apply},
+    {ESC_PROTOCOL_MULTISHOT,  "Multishot",  1000000 / ESC_MULTISHOT_PERIOD_US,   mcpwm_start, mcpwm_stop_output, mcpwm_apply},
+    {ESC_PROTOCOL_DSHOT300,   "DShot300",   ESC_DSHOT_FRAME_RATE_HZ,             dshot_start, dshot_stop_output, dshot_apply},
+    {ESC_PROTOCOL_DSHOT600,   "DShot600",   ESC_DSHOT_FRAME_RATE_HZ,             dshot_start, dshot_stop_output, dshot_apply},
+};
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static esp_err_t start_backend(const esc_backend_t* backend) {
+    g_mailbox.store(ESC_NEUTRAL_DUTY, std::memory_order_release);
+    esp_err_t result = backend->start(backend->protocol);
+    if (result != ESP_OK) {
+        ESP_LOGE(TAG, "%s start failed: %s", backend->name, esp_err_to_name(result));
+        return result;
+    }
+    g_backend.store(backend, std::memory_order_seq_cst);
+    ESP_LOGI(TAG, "ESC output: %s on GPIO%d, %lu Hz", backend->name, (int)ESC_PWM_PIN,
+             (unsigned long)backend->frame_rate_hz);
+    return ESP_OK;
+}
+
+esp_err_t esc_output_init(esc_protocol_t protocol) {
+    if ((int)protocol < 0 || protocol >= ESC_PROTOCOL_COUNT) return ESP_ERR_INVALID_ARG;
+    if (g_backend.load() != nullptr) return esc_output_select(protocol);
+    return start_backend(&k_backends[protocol]);
+}
+
+esp_err_t esc_output_select(esc_protocol_t protocol) {
+    if ((int)protocol < 0 || protocol >= ESC_PROTOCOL_COUNT) return ESP_ERR_INVALID_ARG;
+    const esc_backend_t* previous = g_backend.load(std::memory_order_seq_cst);
+    if (previous == &k_backends[protocol]) return ESP_OK;
+
+    // Take the backend away, then wait out any writer still inside apply()
+    g_backend.store(nullptr, std::memory_order_seq_cst);
+    while (g_writers.load(std::memory_order_seq_cst) != 0) {
+        taskYIELD();
+    }
+    if (previous != nullptr) previous->stop();
+
+    esp_err_t result = start_backend(&k_backends[protocol]);
+    if (result != ESP_OK && previous != nullptr) start_backend(previous);
+    return result;
+}
+
+void esc_output_set(uint16_t duty) {
+    if (duty < ESC_MIN_DUTY) duty = ESC_MIN_DUTY;
+    if (duty > ESC_MAX_DUTY) duty = ESC_MAX_DUTY;
+    g_mailbox.store(duty, std::memory_order_release);
+
+    g_writers.fetch_add(1, std::memory_order_seq_cst);
+    const esc_backend_t* backend = g_backend.load(std::memory_order_seq_cst);
+    if (backend != nullptr) backend->apply(duty);
+    g_writers.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+void esc_output_set_arm_signal(void) {
+    g_mailbox.store(ESC_MAILBOX_ARM, std::memory_order_release);
+
+    g_writers.fetch_add(1, std::memory_order_seq_cst);
+    const esc_backend_t* backend = g_backend.load(std::memory_order_seq_cst);
+    if (backend != nullptr) backend->apply(ESC_MAILBOX_ARM);
+    g_writers.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+esc_protocol_t esc_output_get_protocol(void) {
+    const esc_backend_t* backend = g_backend.load(std::memory_order_acquire);
+    return backend != nullptr ? backend->protocol : ESC_PROTOCOL_PWM50;
+}
+
+const char* esc_output_protocol_to_string(esc_protocol_t protocol) {
+    if ((int)protocol < 0 || protocol >= ESC_PROTOCOL_COUNT) return "Unknown";
+    return k_backends[protocol].name;
+}
+
+esc_output_info_t esc_output_get_info(void) {
+    esc_output_info_t info = {};
+    const esc_backend_t* backend = g_backend.load(std::memory_order_acquire);
+    info.protocol = backend != nullptr ? backend->protocol : ESC_PROTOCOL_PWM50;
+    info.frame_rate_hz = backend != nullptr ? backend->frame_rate_hz : 0;
+    info.frames_sent = g_frames_sent.load(std::memory_order_relaxed);
+    info.frames_skipped = g_frames_skipped.load(std::memory_order_relaxed);
+    info.telemetry_enabled = backend != nullptr && backend->start == dshot_start && ESC_DSHOT_TELEMETRY;
+    return info;
+}
+
+esp_err_t esc_output_get_telemetry(esc_telemetry_t* telemetry) {
+    if (telemetry == NULL) return ESP_ERR_INVALID_ARG;
+    if (!esc_output_get_info().telemetry_enabled) {
+        memset(telemetry, 0, sizeof(*telemetry));
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    *telemetry = g_telemetry_snapshot.read();
+    return telemetry->valid ? ESP_OK : ESP_ERR_TIMEOUT;
+}
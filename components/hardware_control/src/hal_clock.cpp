@@ -0,0 +1,27 @@
+// components/hardware_control/src/hal_clock.cpp
+#include "hal_clock.h"
+#include "esp_timer.h"
+#include <stddef.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// HAL_CLOCK.CPP - DEFAULT (ESP_TIMER) AND INSTALLED TIME SOURCES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static int64_t esp_timer_now_us(void) {
+    return esp_timer_get_time();
+}
+
+static const hal_clock_t g_esp_timer_clock = {
+    .now_us = esp_timer_now_us
+};
+
+// Installed once at startup, read from every core afterwards
+static const hal_clock_t* g_clock = &g_esp_timer_clock;
+
+void hal_clock_install(const hal_clock_t* clock) {
+    g_clock = (clock != NULL && clock->now_us != NULL) ? clock : &g_esp_timer_clock;
+}
+
+int64_t hal_clock_now_us(void) {
+    return g_clock->now_us();
+}
@@ -1,144 +1,378 @@
 // components/hardware_control/src/hardware_control.cpp - FIXED VERSION
 #include "hardware_control.h"
 #include "pin_config.h"
+#include "status_snapshot.h"
+#include "fixed_point.h"
+#include "esc_duty_lut.h"
+#include "esc_output.h"
+#include "perf_monitor.h"
+#include "power_manager.h"
+#include "deferred_log.h"
+#include "sdkconfig.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "driver/gpio.h"
-#include "driver/ledc.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/queue.h"
+#if HALL_BACKEND_PCNT
+#include "driver/pulse_cnt.h"
+#endif
+#include <atomic>
 #include <cstring>
 #include <cmath>
 
 static const char* TAG = "HARDWARE_CONTROL";
 
 // ═══════════════════════════════════════════════════════════════════════════════
-// GLOBAL HARDWARE STATE - FIXED: Proper struct initialization
+// GLOBAL HARDWARE STATE - split by writer, published as tear-free snapshots
 // ═══════════════════════════════════════════════════════════════════════════════
+//
+// hardware_status_t is assembled from three sections. Each section has one
+// owner (or coalescing writers) and its own snapshot, so a reader on any core
+// always sees e.g. current_speed_ms and last_hall_time from the same batch.
 
-static hardware_status_t g_hw_status = {
-    .esc_armed = false,
-    .esc_responding = false,
+// Written only by the control loop sense stage (and hardware_init before it starts)
+typedef struct {
+    q16_16_t speed_ms;                 // Raw batch speed, converted at the API edge
+    uint32_t total_rotations;
+    uint64_t last_hall_time;
+    bool hall_sensor_healthy;
+} hall_state_t;
+
+// Written by the control loop output stage and the direct ESC output calls
+typedef struct {
+    uint16_t current_esc_duty;
+    bool esc_responding;
+} esc_output_state_t;
+
+// Written by the control loop only (mode updates, output stage); other tasks
+// post e-stop and disarm through the atomic latches below
+typedef struct {
+    bool esc_armed;
+    float target_speed_ms;
+    uint16_t target_speed_mm_s;        // Same command in integer form for the output stage
+    bool direction_forward;
+    bool closed_loop;                  // Speed controller feedback requested
+    float feed_forward_bias_duty;      // Added to the LUT feed-forward in closed loop
+    uint64_t motion_start_us;          // When the target last rose from standstill (Hall timeout reference)
+    bool system_initialized;
+} command_state_t;
+
+static hall_state_t g_hall_state = {
+    .speed_ms = {0},
+    .total_rotations = 0,
+    .last_hall_time = 0,
+    .hall_sensor_healthy = false
+};
+
+static esc_output_state_t g_esc_state = {
     .current_esc_duty = ESC_NEUTRAL_DUTY,
-    .current_speed_ms = 0.0f,
+    .esc_responding = false
+};
+
+static command_state_t g_command_state = {
+    .esc_armed = false,
     .target_speed_ms = 0.0f,
+    .target_speed_mm_s = 0,
     .direction_forward = true,
-    .total_rotations = 0,
-    .last_hall_time = 0,
-    .hall_sensor_healthy = false,
+    .closed_loop = false,
+    .feed_forward_bias_duty = 0.0f,
+    .motion_start_us = 0,
     .system_initialized = false
 };
 
-static QueueHandle_t g_hall_event_queue = NULL;
-static TaskHandle_t g_esc_update_task_handle = NULL;
+static status_snapshot<hall_state_t> g_hall_snapshot;
+static status_snapshot<esc_output_state_t> g_esc_snapshot;
+static status_snapshot<command_state_t> g_command_snapshot;
+
+static inline void publish_hall_state(void) {
+    g_hall_snapshot.write(g_hall_state);
+}
+
+static inline void publish_esc_state(void) {
+    g_esc_snapshot.publish_from(&g_esc_state);
+}
+
+static inline void publish_command_state(void) {
+    g_command_snapshot.publish_from(&g_command_state);
+}
+
 static hall_pulse_callback_t g_hall_callback = NULL;
 static esc_status_callback_t g_esc_callback = NULL;
 static hardware_error_t g_last_error = HW_ERROR_NONE;
 
 // Position tracking
-static float g_current_position_m = 0.0f;
+static int32_t g_position_pulses = 0;           // Signed pulse count: no float accumulation drift
 static uint32_t g_rotation_count_offset = 0;
 
 // Rate limiting
 static bool g_rate_limiting_enabled = true;
 static uint16_t g_last_esc_duty = ESC_NEUTRAL_DUTY;
 
+// Speed controller (state owned by the control loop task)
+static speed_controller_gains_t g_controller_gains = {
+    .kp = SPEED_CTRL_DEFAULT_KP,
+    .ki = SPEED_CTRL_DEFAULT_KI,
+    .integrator_limit = SPEED_CTRL_DEFAULT_I_LIMIT,
+    .accel_limit_ms2 = ESC_MAX_ACCEL_MS2
+};
+static status_snapshot<speed_controller_gains_t> g_gains_snapshot;
+static speed_controller_status_t g_controller_status = {};
+static status_snapshot<speed_controller_status_t> g_controller_snapshot;
+static uint32_t g_setpoint_um_s = 0;                 // Acceleration-limited setpoint magnitude
+static bool g_setpoint_forward = true;               // Direction of the ramped setpoint
+static float g_integrator_duty = 0.0f;
+static std::atomic<bool> g_estop_latched{false};     // Set by hardware_emergency_stop() from any task
+static std::atomic<bool> g_disarm_requested{false};  // Set by hardware_esc_disarm() from any task
+static float g_feedback_speed_ms = 0.0f;             // State estimator speed for this tick
+
+// ESC arming sequence: requested by any task, stepped by the control loop
+static std::atomic<uint8_t> g_arm_state{ESC_ARM_DISARMED};  // esc_arm_state_t
+static uint64_t g_arm_phase_deadline = 0;            // Control loop only
+static uint64_t g_esc_settle_until = 0;              // Set once by init_esc_pwm()
+
 // ═══════════════════════════════════════════════════════════════════════════════
-// HALL SENSOR INTERRUPT AND PROCESSING
+// HALL SENSOR EDGE CAPTURE AND BATCH PROCESSING
 // ═══════════════════════════════════════════════════════════════════════════════
+//
+// Pulses are counted by the PCNT unit (or by the ISR in fallback mode), so the
+// rotation count never depends on a consumer keeping up. The ISR only stores
+// the edge timestamp in a single-producer/single-consumer ring; the control
+// loop sense stage drains the ring once per tick and computes speed from the
+// whole batch of periods. If the ring overruns, timestamps are dropped and
+// counted, but position and rotation counts stay exact.
+
+#define HALL_EDGE_RING_MASK         (HALL_EDGE_RING_SIZE - 1)
+
+static_assert((HALL_EDGE_RING_SIZE & HALL_EDGE_RING_MASK) == 0, "HALL_EDGE_RING_SIZE must be a power of 2");
+static_assert((int)(MAX_SPEED_MS * 1000.0f) == ESC_LUT_MAX_SPEED_MM_S, "ESC LUT must span the full speed range");
+
+static uint64_t g_hall_edge_ring[HALL_EDGE_RING_SIZE];
+static std::atomic<uint32_t> g_hall_ring_head{0};          // Written by ISR only
+static std::atomic<uint32_t> g_hall_ring_tail{0};          // Written by processing task only
+static std::atomic<uint32_t> g_hall_timestamps_captured{0};
+static std::atomic<uint32_t> g_hall_timestamps_dropped{0};
+static std::atomic<uint32_t> g_hall_glitches_rejected{0};
+static uint64_t g_hall_isr_last_edge_us = 0;                 // ISR only: last accepted edge
+static uint32_t g_hall_total_pulses = 0;
+static uint32_t g_hall_batches_processed = 0;
+static uint32_t g_hall_max_batch_size = 0;
+
+#if HALL_BACKEND_PCNT
+static pcnt_unit_handle_t g_hall_pcnt_unit = NULL;
+#else
+static std::atomic<uint32_t> g_hall_isr_pulse_count{0};
+#endif
 
 static void IRAM_ATTR hall_sensor_isr_handler(void* arg) {
+    PERF_SCOPE(PERF_PROBE_HALL_ISR);
     uint64_t current_time = esp_timer_get_time();
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
     
-    // Send timestamp to processing queue
-    xQueueSendFromISR(g_hall_event_queue, &current_time, &xHigherPriorityTaskWoken);
+    // PCNT filters its own input, not this interrupt: apply the same width here
+    // so a bounce can't put a near-zero period into the speed batch
+    if (g_hall_isr_last_edge_us != 0 &&
+        (current_time - g_hall_isr_last_edge_us) < HALL_GLITCH_FILTER_US) {
+        g_hall_glitches_rejected.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    g_hall_isr_last_edge_us = current_time;
+    
+#if !HALL_BACKEND_PCNT
+    g_hall_isr_pulse_count.fetch_add(1, std::memory_order_relaxed);
+#endif
+    
+    uint32_t head = g_hall_ring_head.load(std::memory_order_relaxed);
+    uint32_t tail = g_hall_ring_tail.load(std::memory_order_acquire);
     
-    if (xHigherPriorityTaskWoken) {
-        portYIELD_FROM_ISR();
+    if ((head - tail) >= HALL_EDGE_RING_SIZE) {
+        // Ring full - pulse is still counted, only its timestamp is lost
+        g_hall_timestamps_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
     }
+    
+    g_hall_edge_ring[head & HALL_EDGE_RING_MASK] = current_time;
+    g_hall_ring_head.store(head + 1, std::memory_order_release);
+    g_hall_timestamps_captured.fetch_add(1, std::memory_order_relaxed);
 }
 
-static void hall_processing_task(void* pvParameter) {
-    uint64_t hall_time;
-    uint64_t last_time = 0;
+static uint32_t hall_read_pulse_count(void) {
+#if HALL_BACKEND_PCNT
+    int count = 0;
+    if (g_hall_pcnt_unit == NULL || pcnt_unit_get_count(g_hall_pcnt_unit, &count) != ESP_OK) {
+        return g_hall_total_pulses;
+    }
+    return (uint32_t)count;
+#else
+    return g_hall_isr_pulse_count.load(std::memory_order_relaxed);
+#endif
+}
+
+#if HALL_BACKEND_PCNT
+static esp_err_t init_hall_pcnt(void) {
+    pcnt_unit_config_t unit_config = {
+        .low_limit = -1,
+        .high_limit = HALL_PCNT_HIGH_LIMIT,
+        .flags = {
+            .accum_count = 1    // Driver accumulates across high-limit resets
+        }
+    };
+    esp_err_t ret = pcnt_new_unit(&unit_config, &g_hall_pcnt_unit);
+    if (ret != ESP_OK) return ret;
     
-    ESP_LOGI(TAG, "Hall sensor processing task started");
+    pcnt_glitch_filter_config_t filter_config = {
+        .max_glitch_ns = HALL_GLITCH_FILTER_NS
+    };
+    ret = pcnt_unit_set_glitch_filter(g_hall_pcnt_unit, &filter_config);
+    if (ret != ESP_OK) return ret;
     
-    while (1) {
-        if (xQueueReceive(g_hall_event_queue, &hall_time, portMAX_DELAY)) {
-            // Increment rotation counter
-            g_hw_status.total_rotations++;
-            
-            // Calculate speed from time between pulses
-            if (last_time > 0) {
-                uint64_t time_diff_us = hall_time - last_time;
-                if (time_diff_us > 0) {
-                    float time_diff_s = time_diff_us / 1000000.0f;
-                    float speed_ms = (WHEEL_CIRCUMFERENCE_MM * MM_TO_M) / time_diff_s;
-                    // Apply smoothing filter
-                    g_hw_status.current_speed_ms = g_hw_status.current_speed_ms * 0.7f + speed_ms * 0.3f;
-                }
-            }
-            
-            // Update position based on direction
-            float distance_increment = WHEEL_CIRCUMFERENCE_MM * MM_TO_M;
-            if (g_hw_status.direction_forward) {
-                g_current_position_m += distance_increment;
-            } else {
-                g_current_position_m -= distance_increment;
-            }
-            
-            // Update timing
-            last_time = hall_time;
-            g_hw_status.last_hall_time = hall_time;
-            g_hw_status.hall_sensor_healthy = true;
-            
-            // Call registered callback
-            if (g_hall_callback) {
-                g_hall_callback(g_hw_status.total_rotations, hall_time);
+    pcnt_chan_config_t chan_config = {
+        .edge_gpio_num = HALL_SENSOR_PIN,
+        .level_gpio_num = -1
+    };
+    pcnt_channel_handle_t hall_chan = NULL;
+    ret = pcnt_new_channel(g_hall_pcnt_unit, &chan_config, &hall_chan);
+    if (ret != ESP_OK) return ret;
+    
+    // Count rising edges only, same as the GPIO interrupt edge
+    ret = pcnt_channel_set_edge_action(hall_chan, PCNT_CHANNEL_EDGE_ACTION_INCREASE,
+                                       PCNT_CHANNEL_EDGE_ACTION_HOLD);
+    if (ret != ESP_OK) return ret;
+    
+    ret = pcnt_unit_add_watch_point(g_hall_pcnt_unit, HALL_PCNT_HIGH_LIMIT);
+    if (ret != ESP_OK) return ret;
+    
+    ret = pcnt_unit_enable(g_hall_pcnt_unit);
+    if (ret != ESP_OK) return ret;
+    ret = pcnt_unit_clear_count(g_hall_pcnt_unit);
+    if (ret != ESP_OK) return ret;
+    ret = pcnt_unit_start(g_hall_pcnt_unit);
+    if (ret != ESP_OK) return ret;
+    
+    ESP_LOGI(TAG, "Hall PCNT unit started (glitch filter %d ns)", HALL_GLITCH_FILTER_NS);
+    return ESP_OK;
+}
+#endif
+
+// Batch state, owned by the control loop task via hardware_sense_update()
+static uint64_t g_hall_batch_last_time = 0;
+static uint32_t g_hall_batch_last_count = 0;
+static uint32_t g_hall_batch_last_dropped = 0;
+static hall_batch_t g_last_hall_batch = {};
+static std::atomic<uint32_t> g_position_reset_count{0};
+
+static void hall_process_batch(void) {
+    // Hardware count is authoritative for rotations and position
+    uint32_t pulse_count = hall_read_pulse_count();
+    uint32_t new_pulses = pulse_count - g_hall_batch_last_count;
+    g_hall_batch_last_count = pulse_count;
+    
+    // Drain all timestamps captured since the last batch
+    uint32_t tail = g_hall_ring_tail.load(std::memory_order_relaxed);
+    uint32_t head = g_hall_ring_head.load(std::memory_order_acquire);
+    uint32_t batch_size = head - tail;
+    uint64_t first_time = 0;
+    uint64_t newest_time = 0;
+    if (batch_size > 0) {
+        first_time = g_hall_edge_ring[tail & HALL_EDGE_RING_MASK];
+        newest_time = g_hall_edge_ring[(head - 1) & HALL_EDGE_RING_MASK];
+        g_hall_ring_tail.store(head, std::memory_order_release);
+        
+        // Edge-to-processing latency: how long the oldest edge waited in the ring
+        PERF_RECORD_US(PERF_PROBE_HALL_LATENCY, (uint32_t)(esp_timer_get_time() - first_time));
+    }
+    
+    g_last_hall_batch.new_pulses = new_pulses;
+    g_last_hall_batch.edge_count = batch_size;
+    g_last_hall_batch.newest_edge_us = newest_time;
+    
+    if (new_pulses == 0 && batch_size == 0) {
+        // Hall timeout: wheel stopped, or sensor lost while driving. A start from
+        // rest gets the full timeout from the command, not from the last edge
+        uint64_t current_time = esp_timer_get_time();
+        uint64_t reference_time = g_hall_state.last_hall_time > g_command_state.motion_start_us
+                                  ? g_hall_state.last_hall_time : g_command_state.motion_start_us;
+        if (g_hall_state.last_hall_time > 0 &&
+            (current_time - reference_time) > (HALL_TIMEOUT_MS * 1000ULL)) {
+            bool healthy = g_hall_state.hall_sensor_healthy &&
+                           g_command_state.target_speed_mm_s < ESC_SPEED_DEADBAND_MM_S;
+            if (g_hall_state.speed_ms.raw != 0 || healthy != g_hall_state.hall_sensor_healthy) {
+                g_hall_state.speed_ms = q16_16_t::from_raw(0);
+                g_hall_state.hall_sensor_healthy = healthy;
+                publish_hall_state();
             }
         }
+        return;
+    }
+    
+    // A gap in the timestamp stream makes the period across it meaningless
+    uint32_t dropped = g_hall_timestamps_dropped.load(std::memory_order_relaxed);
+    if (dropped != g_hall_batch_last_dropped) {
+        g_hall_batch_last_dropped = dropped;
+        g_hall_batch_last_time = 0;
+    }
+    
+    // Speed from the batch: N periods over the span they cover
+    if (batch_size > 0) {
+        uint64_t span_start = g_hall_batch_last_time;
+        uint32_t periods = batch_size;
+        if (span_start == 0) {
+            span_start = first_time;
+            periods = batch_size - 1;
+        }
+        uint64_t span_us = newest_time - span_start;
+        if (periods > 0 && span_us > 0) {
+            // Raw batch speed - filtering belongs to the state estimator
+            // µm per µs is m/s, so the Q16.16 quotient needs no scaling
+            g_hall_state.speed_ms = q16_16_t::from_ratio((int64_t)periods * HALL_DISTANCE_PER_PULSE_UM,
+                                                         (int64_t)span_us);
+        }
+        g_hall_batch_last_time = newest_time;
+        g_hall_state.last_hall_time = newest_time;
+    }
+    
+    // Update position based on direction
+    if (g_command_state.direction_forward) {
+        g_position_pulses += (int32_t)new_pulses;
+    } else {
+        g_position_pulses -= (int32_t)new_pulses;
+    }
+    g_last_hall_batch.position_pulses = g_position_pulses;
+    g_last_hall_batch.position_m = g_position_pulses * HALL_DISTANCE_PER_PULSE_M;
+    
+    g_hall_total_pulses += new_pulses;
+    g_hall_state.total_rotations = g_hall_total_pulses / HALL_MAGNETS_PER_REV;
+    g_hall_state.hall_sensor_healthy = true;
+    publish_hall_state();
+    
+    g_hall_batches_processed++;
+    if (batch_size > g_hall_max_batch_size) {
+        g_hall_max_batch_size = batch_size;
+    }
+    
+    // Call registered callback once per batch
+    if (g_hall_callback) {
+        g_hall_callback(g_hall_state.total_rotations, g_hall_state.last_hall_time);
     }
 }
 
 // ═══════════════════════════════════════════════════════════════════════════════
-// ESC PWM INITIALIZATION AND CONTROL - FIXED: Proper LEDC configuration
+// ESC SIGNAL INITIALIZATION AND CONTROL (backend in esc_output.cpp)
 // ═══════════════════════════════════════════════════════════════════════════════
 
 static esp_err_t init_esc_pwm(void) {
-    ESP_LOGI(TAG, "Initializing ESC PWM system...");
-    
-    // Wait for power stabilization
-    vTaskDelay(pdMS_TO_TICKS(2000));
-    
-    // Configure LEDC timer - FIXED: Correct field order and all required fields
-    ledc_timer_config_t ledc_timer = {
-        .speed_mode = LEDC_LOW_SPEED_MODE,
-        .duty_resolution = ESC_PWM_RESOLUTION,
-        .timer_num = ESC_PWM_TIMER,
-        .freq_hz = ESC_PWM_FREQ_HZ,
-        .clk_cfg = LEDC_AUTO_CLK
-    };
-    ESP_ERROR_CHECK(ledc_timer_config(&ledc_timer));
-    
-    // Configure LEDC channel - FIXED: Proper initialization with all fields
-    ledc_channel_config_t esc_channel = {
-        .gpio_num = ESC_PWM_PIN,
-        .speed_mode = LEDC_LOW_SPEED_MODE,
-        .channel = ESC_PWM_CHANNEL,
-        .intr_type = LEDC_INTR_DISABLE,
-        .timer_sel = ESC_PWM_TIMER,
-        .duty = ESC_NEUTRAL_DUTY,
-        .hpoint = 0
-    };
-    ESP_ERROR_CHECK(ledc_channel_config(&esc_channel));
+    ESP_LOGI(TAG, "Initializing ESC signal (%s)...", esc_output_protocol_to_string(ESC_DEFAULT_PROTOCOL));
     
-    g_hw_status.current_esc_duty = ESC_NEUTRAL_DUTY;
+    // Power stabilization is waited out by the arming sequence, not here:
+    // the ESC sees neutral from now on
+    g_esc_settle_until = esp_timer_get_time() + ESC_POWER_SETTLE_MS * 1000ULL;
+    
+    ESP_ERROR_CHECK(esc_output_init(ESC_DEFAULT_PROTOCOL));
+    
+    g_esc_state.current_esc_duty = ESC_NEUTRAL_DUTY;
     g_last_esc_duty = ESC_NEUTRAL_DUTY;
+    publish_esc_state();
     
-    ESP_LOGI(TAG, "ESC PWM initialized successfully");
+    ESP_LOGI(TAG, "ESC signal initialized successfully");
     return ESP_OK;
 }
 
@@ -170,76 +404,266 @@ static esp_err_t init_gpio_pins(void) {
     return ESP_OK;
 }
 
-static uint16_t speed_to_esc_duty(float speed_ms, bool forward) {
-    if (speed_ms > MAX_SPEED_MS) speed_ms = MAX_SPEED_MS;
-    if (speed_ms < 0.0f) speed_ms = 0.0f;
+static uint16_t speed_to_esc_duty(uint16_t speed_mm_s, bool forward) {
+    if (speed_mm_s < ESC_SPEED_DEADBAND_MM_S) {
+        return ESC_NEUTRAL_DUTY;
+    }
+    
+    // Calibrated (or factory linear) table, integer interpolation only
+    return esc_lut_speed_to_duty(speed_mm_s, forward);
+}
+
+/**
+ * @brief Move the speed setpoint toward the command within the acceleration limit
+ * @note A direction change ramps the setpoint to zero before it flips
+ */
+static void ramp_speed_setpoint(const command_state_t* cmd, const speed_controller_gains_t* gains,
+                                uint32_t dt_us) {
+    uint32_t target_um_s = (uint32_t)cmd->target_speed_mm_s * 1000;
     
-    if (speed_ms < ESC_SPEED_DEADBAND) {
+    if (!g_rate_limiting_enabled) {
+        g_setpoint_um_s = target_um_s;
+        g_setpoint_forward = cmd->direction_forward;
+        return;
+    }
+    
+    if (cmd->direction_forward != g_setpoint_forward) {
+        if (g_setpoint_um_s == 0) {
+            g_setpoint_forward = cmd->direction_forward;
+        } else {
+            target_um_s = 0;
+        }
+    }
+    
+    // m/s² × µs = µm/s per tick
+    uint32_t max_step = (uint32_t)(gains->accel_limit_ms2 * (float)dt_us);
+    if (max_step < 1) max_step = 1;
+    
+    if (target_um_s > g_setpoint_um_s) {
+        g_setpoint_um_s = (target_um_s - g_setpoint_um_s > max_step) ? g_setpoint_um_s + max_step : target_um_s;
+    } else {
+        g_setpoint_um_s = (g_setpoint_um_s - target_um_s > max_step) ? g_setpoint_um_s - max_step : target_um_s;
+    }
+}
+
+/**
+ * @brief Feed-forward from the duty LUT plus PI correction on Hall speed error
+ * @return Absolute ESC duty for this tick
+ * @note Anti-windup by conditional integration: the integrator is held while the
+ *       output is clamped and the error would push it further into the clamp
+ */
+static uint16_t compute_output_duty(const command_state_t* cmd, const speed_controller_gains_t* gains,
+                                    uint32_t dt_us) {
+    // A stop latched since the output stage checked wins over this tick's command
+    if (g_estop_latched.load(std::memory_order_acquire)) {
+        g_setpoint_um_s = 0;
+        g_integrator_duty = 0.0f;
         return ESC_NEUTRAL_DUTY;
     }
     
+    uint16_t setpoint_mm_s = (uint16_t)(g_setpoint_um_s / 1000);
+    uint16_t feed_forward = speed_to_esc_duty(setpoint_mm_s, g_setpoint_forward);
+    float setpoint_ms = (float)g_setpoint_um_s * 1e-6f;
+    float measured_ms = g_feedback_speed_ms;
+    
+    g_controller_status.setpoint_ms = setpoint_ms;
+    g_controller_status.measured_ms = measured_ms;
+    g_controller_status.feed_forward_duty = feed_forward;
+    g_controller_status.saturated = false;
+    
+    // Feedback only with a healthy Hall sensor and above the pulse-resolution floor
+    bool feedback = cmd->closed_loop && g_hall_state.hall_sensor_healthy &&
+                    setpoint_ms >= SPEED_CTRL_MIN_FEEDBACK_MS;
+    g_controller_status.closed_loop = feedback;
+    
+    if (!feedback) {
+        g_integrator_duty = 0.0f;
+        g_controller_status.bias_duty = 0.0f;
+        g_controller_status.correction_duty = 0.0f;
+        g_controller_status.integrator_duty = 0.0f;
+        return feed_forward;
+    }
+    
+    // Work in duty offset from neutral toward the setpoint direction
+    float max_offset = g_setpoint_forward ? (float)(ESC_MAX_DUTY - ESC_NEUTRAL_DUTY)
+                                          : (float)(ESC_NEUTRAL_DUTY - ESC_MIN_DUTY);
+    float ff_offset = g_setpoint_forward ? (float)feed_forward - ESC_NEUTRAL_DUTY
+                                         : (float)ESC_NEUTRAL_DUTY - feed_forward;
+    ff_offset += cmd->feed_forward_bias_duty;
+    g_controller_status.bias_duty = cmd->feed_forward_bias_duty;
+    
+    float error = setpoint_ms - measured_ms;
+    float proportional = gains->kp * error;
+    float unclamped = ff_offset + proportional + g_integrator_duty;
+    
+    bool saturated_high = (unclamped >= max_offset) && (error > 0.0f);
+    bool saturated_low = (unclamped <= 0.0f) && (error < 0.0f);
+    if (!saturated_high && !saturated_low) {
+        g_integrator_duty += gains->ki * error * ((float)dt_us * 1e-6f);
+        if (g_integrator_duty > gains->integrator_limit) g_integrator_duty = gains->integrator_limit;
+        if (g_integrator_duty < -gains->integrator_limit) g_integrator_duty = -gains->integrator_limit;
+    }
+    
+    float correction = proportional + g_integrator_duty;
+    float output = ff_offset + correction;
+    if (output > max_offset) {
+        output = max_offset;
+        g_controller_status.saturated = true;
+    } else if (output < 0.0f) {
+        output = 0.0f;  // Never drive through neutral to correct overspeed
+        g_controller_status.saturated = true;
+    }
+    
+    g_controller_status.correction_duty = correction;
+    g_controller_status.integrator_duty = g_integrator_duty;
+    
+    uint16_t offset = (uint16_t)(output + 0.5f);
+    return g_setpoint_forward ? (uint16_t)(ESC_NEUTRAL_DUTY + offset)
+                              : (uint16_t)(ESC_NEUTRAL_DUTY - offset);
+}
+
+static inline void write_esc_duty(uint16_t duty) {
+    esc_output_set(duty);
+}
+
+/**
+ * @brief Advance the arming sequence (control loop), one deadline check per tick
+ */
+static void esc_arm_step(void) {
+    uint8_t state = g_arm_state.load(std::memory_order_acquire);
+    if (state == ESC_ARM_DISARMED || state == ESC_ARM_ARMED) return;
+    
+    uint64_t now = esp_timer_get_time();
+    if (state != ESC_ARM_SETTLING && now < g_arm_phase_deadline) return;
+    
+    uint8_t next;
     uint16_t duty;
-    if (forward) {
-        float duty_range = ESC_MAX_DUTY - ESC_NEUTRAL_DUTY;
-        duty = ESC_NEUTRAL_DUTY + (uint16_t)((speed_ms / MAX_SPEED_MS) * duty_range);
+    switch (state) {
+        case ESC_ARM_SETTLING:
+            if (now < g_esc_settle_until) return;
+            next = ESC_ARM_NEUTRAL;
+            duty = ESC_NEUTRAL_DUTY;
+            g_arm_phase_deadline = now + ESC_ARM_NEUTRAL_MS * 1000ULL;
+            break;
+        case ESC_ARM_NEUTRAL:
+            next = ESC_ARM_SIGNAL;
+            duty = ESC_ARM_DUTY;
+            g_arm_phase_deadline = now + ESC_ARM_TIME_MS * 1000ULL;
+            break;
+        default:
+            next = ESC_ARM_ARMED;
+            duty = ESC_NEUTRAL_DUTY;
+            break;
+    }
+    
+    // A disarm or e-stop in between wins
+    if (!g_arm_state.compare_exchange_strong(state, next, std::memory_order_acq_rel)) return;
+    if (next == ESC_ARM_SIGNAL) {
+        esc_output_set_arm_signal();        // DShot arms on command 0, not a low pulse
     } else {
-        float duty_range = ESC_NEUTRAL_DUTY - ESC_MIN_DUTY;
-        duty = ESC_NEUTRAL_DUTY - (uint16_t)((speed_ms / MAX_SPEED_MS) * duty_range);
-    }
-    
-    return duty;
-}
-
-static void esc_update_task(void* pvParameter) {
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    
-    ESP_LOGI(TAG, "ESC update task started");
-    
-    while (1) {
-        if (g_hw_status.system_initialized && g_hw_status.esc_armed) {
-            uint16_t target_duty = speed_to_esc_duty(g_hw_status.target_speed_ms, g_hw_status.direction_forward);
-            
-            // Apply rate limiting if enabled
-            if (g_rate_limiting_enabled) {
-                int16_t duty_diff = target_duty - g_hw_status.current_esc_duty;
-                if (abs(duty_diff) > ESC_MAX_SPEED_CHANGE) {
-                    if (duty_diff > 0) {
-                        g_hw_status.current_esc_duty += ESC_MAX_SPEED_CHANGE;
-                    } else {
-                        g_hw_status.current_esc_duty -= ESC_MAX_SPEED_CHANGE;
-                    }
-                } else {
-                    g_hw_status.current_esc_duty = target_duty;
-                }
-            } else {
-                g_hw_status.current_esc_duty = target_duty;
-            }
-            
-            // Update ESC PWM output
-            ledc_set_duty(LEDC_LOW_SPEED_MODE, ESC_PWM_CHANNEL, g_hw_status.current_esc_duty);
-            ledc_update_duty(LEDC_LOW_SPEED_MODE, ESC_PWM_CHANNEL);
-            
-            g_last_esc_duty = g_hw_status.current_esc_duty;
-            
-            // Update status LED
-            gpio_set_level(STATUS_LED_PIN, (g_hw_status.target_speed_ms > ESC_SPEED_DEADBAND) ? 1 : 0);
-        }
-        
-        // Check ESC health
-        g_hw_status.esc_responding = (g_hw_status.current_esc_duty == g_last_esc_duty);
+        write_esc_duty(duty);
+    }
+    if (g_arm_state.load(std::memory_order_acquire) == ESC_ARM_DISARMED) {
+        // Cancelled while writing: make sure neutral is the last duty written
+        write_esc_duty(ESC_NEUTRAL_DUTY);
+        return;
+    }
+    
+    if (next != ESC_ARM_ARMED) return;
+    
+    g_esc_state.current_esc_duty = ESC_NEUTRAL_DUTY;
+    g_last_esc_duty = ESC_NEUTRAL_DUTY;
+    publish_esc_state();
+    g_command_state.esc_armed = true;
+    publish_command_state();
+    
+    // Notify callback (control loop context)
+    if (g_esc_callback) {
+        g_esc_callback(true, true);
+    }
+    
+    deferred_log(DLOG_MSG_HW_ESC_ARMED);
+}
+
+/**
+ * @brief Cancel an arming sequence in progress (armed state is left alone)
+ */
+static void esc_arm_cancel(void) {
+    uint8_t state = g_arm_state.load(std::memory_order_acquire);
+    while (state != ESC_ARM_DISARMED && state != ESC_ARM_ARMED &&
+           !g_arm_state.compare_exchange_weak(state, ESC_ARM_DISARMED, std::memory_order_acq_rel)) {
+    }
+}
+
+/**
+ * @brief Apply an e-stop or disarm posted from any task (control loop only)
+ * @note The command is zeroed here rather than by the caller, so
+ *       g_command_state keeps a single writer
+ */
+static void apply_stop_requests(void) {
+    bool disarm = g_disarm_requested.exchange(false, std::memory_order_acq_rel);
+    bool estop = g_estop_latched.exchange(false, std::memory_order_acq_rel);
+    if (!disarm && !estop) return;
+    
+    g_command_state.target_speed_ms = 0.0f;
+    g_command_state.target_speed_mm_s = 0;
+    g_command_state.feed_forward_bias_duty = 0.0f;
+    bool was_armed = g_command_state.esc_armed;
+    if (disarm) g_command_state.esc_armed = false;
+    publish_command_state();
+    
+    // Restart the ramp from standstill
+    g_setpoint_um_s = 0;
+    g_integrator_duty = 0.0f;
+    write_esc_duty(ESC_NEUTRAL_DUTY);
+    g_esc_state.current_esc_duty = ESC_NEUTRAL_DUTY;
+    g_last_esc_duty = ESC_NEUTRAL_DUTY;
+    publish_esc_state();
+    gpio_set_level(STATUS_LED_PIN, 0);
+    
+    // Notify callback (control loop context)
+    if (disarm && was_armed && g_esc_callback) {
+        g_esc_callback(false, true);
+    }
+}
+
+static void esc_output_step(uint32_t dt_us) {
+    uint16_t previous_duty = g_esc_state.current_esc_duty;
+    
+    esc_arm_step();
+    apply_stop_requests();
+    
+    // Target and direction always come from the same command
+    command_state_t cmd = g_command_state;
+    
+    if (cmd.system_initialized && cmd.esc_armed) {
+        speed_controller_gains_t gains = g_gains_snapshot.read();
+        ramp_speed_setpoint(&cmd, &gains, dt_us);
+        g_esc_state.current_esc_duty = compute_output_duty(&cmd, &gains, dt_us);
         
-        // Check Hall sensor health
-        uint64_t current_time = esp_timer_get_time();
-        if (g_hw_status.last_hall_time > 0 && 
-            (current_time - g_hw_status.last_hall_time) > (HALL_TIMEOUT_MS * 1000ULL)) {
-            g_hw_status.current_speed_ms = 0.0f;
-            if (g_hw_status.target_speed_ms > ESC_SPEED_DEADBAND) {
-                g_hw_status.hall_sensor_healthy = false;
-            }
+        // Post to the ESC mailbox (the backend latches it at its next frame)
+        if (g_esc_state.current_esc_duty != g_last_esc_duty) {
+            write_esc_duty(g_esc_state.current_esc_duty);
         }
         
-        vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(ESC_UPDATE_INTERVAL_MS));
+        g_last_esc_duty = g_esc_state.current_esc_duty;
+        
+        // Update status LED
+        gpio_set_level(STATUS_LED_PIN, (cmd.target_speed_mm_s >= ESC_SPEED_DEADBAND_MM_S) ? 1 : 0);
+    } else {
+        g_setpoint_um_s = 0;
+        g_integrator_duty = 0.0f;
+        g_controller_status = {};
+    }
+    
+    // Check ESC health, publish only on change
+    bool responding = (g_esc_state.current_esc_duty == g_last_esc_duty);
+    if (responding != g_esc_state.esc_responding || g_esc_state.current_esc_duty != previous_duty) {
+        g_esc_state.esc_responding = responding;
+        publish_esc_state();
     }
+    
+    g_controller_snapshot.write(g_controller_status);
 }
 
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -250,24 +674,33 @@ esp_err_t hardware_init(void) {
     ESP_LOGI(TAG, "Initializing hardware control system...");
     
     // Reset hardware status to known state
-    g_hw_status.esc_armed = false;
-    g_hw_status.esc_responding = false;
-    g_hw_status.current_esc_duty = ESC_NEUTRAL_DUTY;
-    g_hw_status.current_speed_ms = 0.0f;
-    g_hw_status.target_speed_ms = 0.0f;
-    g_hw_status.direction_forward = true;
-    g_hw_status.total_rotations = 0;
-    g_hw_status.last_hall_time = 0;
-    g_hw_status.hall_sensor_healthy = false;
-    g_hw_status.system_initialized = false;
-    
-    // Create Hall sensor event queue
-    g_hall_event_queue = xQueueCreate(10, sizeof(uint64_t));
-    if (g_hall_event_queue == NULL) {
-        ESP_LOGE(TAG, "Failed to create Hall sensor queue");
-        g_last_error = HW_ERROR_GPIO_INIT_FAILED;
-        return ESP_ERR_NO_MEM;
-    }
+    g_arm_state.store(ESC_ARM_DISARMED, std::memory_order_release);
+    g_command_state.esc_armed = false;
+    g_command_state.target_speed_ms = 0.0f;
+    g_command_state.target_speed_mm_s = 0;
+    g_command_state.direction_forward = true;
+    g_command_state.closed_loop = false;
+    g_command_state.feed_forward_bias_duty = 0.0f;
+    g_command_state.motion_start_us = 0;
+    g_command_state.system_initialized = false;
+    g_esc_state.esc_responding = false;
+    g_esc_state.current_esc_duty = ESC_NEUTRAL_DUTY;
+    g_hall_state.speed_ms = q16_16_t::from_raw(0);
+    g_hall_state.total_rotations = 0;
+    g_hall_state.last_hall_time = 0;
+    g_hall_state.hall_sensor_healthy = false;
+    publish_command_state();
+    publish_esc_state();
+    publish_hall_state();
+    g_gains_snapshot.publish_from(&g_controller_gains);
+    
+    // Reset Hall edge ring
+    g_hall_ring_head.store(0);
+    g_hall_ring_tail.store(0);
+    g_hall_total_pulses = 0;
+    
+    // Speed → duty tables (factory map, or this unit's calibration from NVS)
+    esc_lut_init();
     
     // Initialize GPIO pins
     if (init_gpio_pins() != ESP_OK) {
@@ -275,90 +708,75 @@ esp_err_t hardware_init(void) {
         return ESP_FAIL;
     }
     
+#if HALL_BACKEND_PCNT
+    // Hardware pulse counter on the Hall pin
+    if (init_hall_pcnt() != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize Hall PCNT unit");
+        g_last_error = HW_ERROR_GPIO_INIT_FAILED;
+        return ESP_FAIL;
+    }
+#endif
+    
     // Initialize ESC PWM
     if (init_esc_pwm() != ESP_OK) {
         g_last_error = HW_ERROR_PWM_INIT_FAILED;
         return ESP_FAIL;
     }
     
-    // Install Hall sensor interrupt
+    // Install Hall sensor edge timestamp interrupt
     ESP_ERROR_CHECK(gpio_install_isr_service(0));
     ESP_ERROR_CHECK(gpio_isr_handler_add(HALL_SENSOR_PIN, hall_sensor_isr_handler, 
                                         (void*) HALL_SENSOR_PIN));
     
-    // Create tasks
-    xTaskCreate(hall_processing_task, "hall_proc", 4096, NULL, 10, NULL);
-    xTaskCreate(esc_update_task, "esc_update", 4096, NULL, 8, &g_esc_update_task_handle);
+    // Hall batching and ESC output run from the control loop
+    // (hardware_sense_update / hardware_output_update), no tasks here
+    g_hall_batch_last_count = hall_read_pulse_count();
+    g_hall_batch_last_time = 0;
     
-    g_hw_status.system_initialized = true;
+    g_command_state.system_initialized = true;
+    publish_command_state();
     ESP_LOGI(TAG, "Hardware control system initialized successfully");
     
     return ESP_OK;
 }
 
 esp_err_t hardware_esc_arm(void) {
-    if (!g_hw_status.system_initialized) {
+    if (!g_command_state.system_initialized) {
         g_last_error = HW_ERROR_SYSTEM_NOT_INITIALIZED;
         return ESP_ERR_INVALID_STATE;
     }
     
-    ESP_LOGI(TAG, "Arming ESC...");
-    
-    // Step 1: Neutral position
-    ledc_set_duty(LEDC_LOW_SPEED_MODE, ESC_PWM_CHANNEL, ESC_NEUTRAL_DUTY);
-    ledc_update_duty(LEDC_LOW_SPEED_MODE, ESC_PWM_CHANNEL);
-    vTaskDelay(pdMS_TO_TICKS(1000));
-    
-    // Step 2: Arming signal
-    ledc_set_duty(LEDC_LOW_SPEED_MODE, ESC_PWM_CHANNEL, ESC_ARM_DUTY);
-    ledc_update_duty(LEDC_LOW_SPEED_MODE, ESC_PWM_CHANNEL);
-    vTaskDelay(pdMS_TO_TICKS(3000));
-    
-    // Step 3: Return to neutral
-    ledc_set_duty(LEDC_LOW_SPEED_MODE, ESC_PWM_CHANNEL, ESC_NEUTRAL_DUTY);
-    ledc_update_duty(LEDC_LOW_SPEED_MODE, ESC_PWM_CHANNEL);
-    
-    g_hw_status.esc_armed = true;
-    g_hw_status.current_esc_duty = ESC_NEUTRAL_DUTY;
-    
-    // Notify callback
-    if (g_esc_callback) {
-        g_esc_callback(true, true);
+    // Neutral → arming pulse → neutral, stepped by esc_arm_step() in the control loop
+    uint8_t expected = ESC_ARM_DISARMED;
+    power_manager_motion_begin();
+    if (g_arm_state.compare_exchange_strong(expected, ESC_ARM_SETTLING, std::memory_order_acq_rel)) {
+        deferred_log(DLOG_MSG_HW_ESC_ARMING, (unsigned long)(ESC_ARM_NEUTRAL_MS + ESC_ARM_TIME_MS));
     }
-    
-    ESP_LOGI(TAG, "ESC armed successfully");
     return ESP_OK;
 }
 
+esc_arm_state_t hardware_esc_get_arm_state(void) {
+    return (esc_arm_state_t)g_arm_state.load(std::memory_order_acquire);
+}
+
 esp_err_t hardware_esc_disarm(void) {
-    ESP_LOGI(TAG, "Disarming ESC...");
-    
-    // Stop motor immediately
-    g_hw_status.target_speed_ms = 0.0f;
-    ledc_set_duty(LEDC_LOW_SPEED_MODE, ESC_PWM_CHANNEL, ESC_NEUTRAL_DUTY);
-    ledc_update_duty(LEDC_LOW_SPEED_MODE, ESC_PWM_CHANNEL);
-    
-    g_hw_status.esc_armed = false;
-    g_hw_status.current_esc_duty = ESC_NEUTRAL_DUTY;
-    
-    // Turn off status LED
-    gpio_set_level(STATUS_LED_PIN, 0);
-    
-    // Notify callback
-    if (g_esc_callback) {
-        g_esc_callback(false, true);
-    }
+    // Neutral now; the output stage clears the command on its next tick
+    g_arm_state.store(ESC_ARM_DISARMED, std::memory_order_release);
+    g_disarm_requested.store(true, std::memory_order_release);
+    write_esc_duty(ESC_NEUTRAL_DUTY);
     
-    ESP_LOGI(TAG, "ESC disarmed");
+    deferred_log(DLOG_MSG_HW_ESC_DISARMED);
     return ESP_OK;
 }
 
 bool hardware_esc_is_armed(void) {
-    return g_hw_status.esc_armed;
+    // Disarmed as soon as requested, before the output stage catches up
+    return g_command_snapshot.read().esc_armed &&
+           g_arm_state.load(std::memory_order_acquire) == ESC_ARM_ARMED;
 }
 
-esp_err_t hardware_set_motor_speed(float speed_ms, bool forward) {
-    if (!g_hw_status.system_initialized) {
+static esp_err_t set_speed_command(float speed_ms, bool forward, bool closed_loop) {
+    if (!g_command_state.system_initialized) {
         g_last_error = HW_ERROR_SYSTEM_NOT_INITIALIZED;
         return ESP_ERR_INVALID_STATE;
     }
@@ -368,58 +786,107 @@ esp_err_t hardware_set_motor_speed(float speed_ms, bool forward) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    if (!g_hw_status.esc_armed) {
+    if (!g_command_state.esc_armed || g_arm_state.load(std::memory_order_acquire) != ESC_ARM_ARMED) {
         g_last_error = HW_ERROR_ESC_NOT_RESPONDING;
         return ESP_ERR_INVALID_STATE;
     }
     
-    g_hw_status.target_speed_ms = speed_ms;
-    g_hw_status.direction_forward = forward;
+    // A stop not yet applied by the output stage must not be overwritten
+    if (g_estop_latched.load(std::memory_order_acquire) ||
+        g_disarm_requested.load(std::memory_order_acquire)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    // Full clock before the control loop sees the new target
+    if (speed_ms > 0.0f) {
+        power_manager_motion_begin();
+    }
+    
+    uint16_t target_mm_s = (uint16_t)(speed_ms * 1000.0f + 0.5f);
+    if (g_command_state.target_speed_mm_s < ESC_SPEED_DEADBAND_MM_S && target_mm_s >= ESC_SPEED_DEADBAND_MM_S) {
+        g_command_state.motion_start_us = esp_timer_get_time();
+    }
+    g_command_state.target_speed_ms = speed_ms;
+    g_command_state.target_speed_mm_s = target_mm_s;
+    g_command_state.direction_forward = forward;
+    g_command_state.closed_loop = closed_loop;
+    publish_command_state();
     
-    ESP_LOGD(TAG, "Motor speed set: %.2f m/s %s", speed_ms, forward ? "forward" : "reverse");
+    deferred_log(DLOG_MSG_HW_SPEED_SET, speed_ms, forward ? "forward" : "reverse",
+                 closed_loop ? "closed loop" : "open loop");
     return ESP_OK;
 }
 
+esp_err_t hardware_set_motor_speed(float speed_ms, bool forward) {
+    return set_speed_command(speed_ms, forward, false);
+}
+
+esp_err_t hardware_set_speed_closed_loop(float speed_ms, bool forward) {
+    return set_speed_command(speed_ms, forward, true);
+}
+
 esp_err_t hardware_emergency_stop(void) {
-    ESP_LOGW(TAG, "EMERGENCY STOP activated");
+    deferred_log(DLOG_MSG_HW_EMERGENCY_STOP);
     
-    g_hw_status.target_speed_ms = 0.0f;
-    g_hw_status.current_esc_duty = ESC_NEUTRAL_DUTY;
-    
-    ledc_set_duty(LEDC_LOW_SPEED_MODE, ESC_PWM_CHANNEL, ESC_NEUTRAL_DUTY);
-    ledc_update_duty(LEDC_LOW_SPEED_MODE, ESC_PWM_CHANNEL);
-    
-    gpio_set_level(STATUS_LED_PIN, 0);
+    // Latch first: compute_output_duty() holds neutral from here on, and the
+    // output stage zeroes the command on its next tick
+    esc_arm_cancel();
+    g_estop_latched.store(true, std::memory_order_release);
+    write_esc_duty(ESC_NEUTRAL_DUTY);
     
     return ESP_OK;
 }
 
 float hardware_get_current_speed(void) {
-    return g_hw_status.current_speed_ms;
+    return g_hall_snapshot.read().speed_ms.to_float();
 }
 
 uint32_t hardware_get_rotation_count(void) {
-    return g_hw_status.total_rotations - g_rotation_count_offset;
+    return g_hall_snapshot.read().total_rotations - g_rotation_count_offset;
 }
 
 esp_err_t hardware_reset_rotation_count(void) {
-    g_rotation_count_offset = g_hw_status.total_rotations;
+    g_rotation_count_offset = g_hall_snapshot.read().total_rotations;
     return ESP_OK;
 }
 
 uint64_t hardware_get_time_since_last_hall_pulse(void) {
-    if (g_hw_status.last_hall_time == 0) return 0;
-    return esp_timer_get_time() - g_hw_status.last_hall_time;
+    uint64_t last_hall_time = g_hall_snapshot.read().last_hall_time;
+    if (last_hall_time == 0) return 0;
+    return esp_timer_get_time() - last_hall_time;
 }
 
 bool hardware_is_hall_sensor_healthy(void) {
-    return g_hw_status.hall_sensor_healthy;
+    return g_hall_snapshot.read().hall_sensor_healthy;
+}
+
+hall_batch_t hardware_get_last_hall_batch(void) {
+    hall_batch_t batch = g_last_hall_batch;
+    batch.position_resets = g_position_reset_count.load(std::memory_order_acquire);
+    return batch;
+}
+
+hall_backend_stats_t hardware_get_hall_stats(void) {
+    hall_backend_stats_t stats = {
+        .pcnt_backend = (HALL_BACKEND_PCNT != 0),
+        .total_pulses = g_hall_total_pulses,
+        .timestamps_captured = g_hall_timestamps_captured.load(std::memory_order_relaxed),
+        .timestamps_dropped = g_hall_timestamps_dropped.load(std::memory_order_relaxed),
+        .glitches_rejected = g_hall_glitches_rejected.load(std::memory_order_relaxed),
+        .batches_processed = g_hall_batches_processed,
+        .max_batch_size = g_hall_max_batch_size
+    };
+    return stats;
 }
 
 float hardware_rotations_to_distance(uint32_t rotations) {
     return rotations * WHEEL_CIRCUMFERENCE_MM * MM_TO_M;
 }
 
+uint32_t hardware_rotations_to_distance_mm(uint32_t rotations) {
+    return (uint32_t)(((uint64_t)rotations * WHEEL_CIRCUMFERENCE_UM + 500) / 1000);
+}
+
 uint32_t hardware_distance_to_rotations(float distance_m) {
     return (uint32_t)(distance_m / (WHEEL_CIRCUMFERENCE_MM * MM_TO_M));
 }
@@ -430,23 +897,60 @@ esp_err_t hardware_set_status_led(bool on) {
 }
 
 float hardware_get_current_position(void) {
-    return g_current_position_m;
+    return g_position_pulses * HALL_DISTANCE_PER_PULSE_M;
 }
 
 esp_err_t hardware_reset_position(void) {
-    g_current_position_m = 0.0f;
+    g_position_pulses = 0;
+    g_last_hall_batch.position_pulses = 0;
+    g_last_hall_batch.position_m = 0.0f;
     hardware_reset_rotation_count();
+    g_position_reset_count.fetch_add(1, std::memory_order_release);
     return ESP_OK;
 }
 
 esp_err_t hardware_update(void) {
-    // Hardware update is handled by background tasks
-    // This function can be used for additional periodic checks
+    // Time-critical work runs in hardware_sense_update/hardware_output_update
+    // Flash writes belong here, never in the control loop
+    return esc_lut_process_pending_save();
+}
+
+esp_err_t hardware_sense_update(void) {
+    if (!g_command_state.system_initialized) return ESP_ERR_INVALID_STATE;
+    hall_process_batch();
+    return ESP_OK;
+}
+
+esp_err_t hardware_output_update(uint32_t dt_us, float measured_speed_ms) {
+    if (!g_command_state.system_initialized) return ESP_ERR_INVALID_STATE;
+    g_feedback_speed_ms = measured_speed_ms;
+    esc_output_step(dt_us);
     return ESP_OK;
 }
 
 hardware_status_t hardware_get_status(void) {
-    return g_hw_status;
+    hall_state_t hall = g_hall_snapshot.read();
+    esc_output_state_t esc = g_esc_snapshot.read();
+    command_state_t cmd = g_command_snapshot.read();
+    
+    hardware_status_t status = {
+        .esc_armed = cmd.esc_armed,
+        .esc_responding = esc.esc_responding,
+        .current_esc_duty = esc.current_esc_duty,
+        .current_speed_ms = hall.speed_ms.to_float(),
+        .target_speed_ms = cmd.target_speed_ms,
+        .direction_forward = cmd.direction_forward,
+        .total_rotations = hall.total_rotations,
+        .last_hall_time = hall.last_hall_time,
+        .hall_sensor_healthy = hall.hall_sensor_healthy,
+        .system_initialized = cmd.system_initialized
+    };
+    return status;
+}
+
+uint32_t hardware_get_status_generation(void) {
+    return g_hall_snapshot.generation() + g_esc_snapshot.generation() +
+           g_command_snapshot.generation();
 }
 
 hardware_error_t hardware_get_last_error(void) {
@@ -454,9 +958,9 @@ hardware_error_t hardware_get_last_error(void) {
 }
 
 bool hardware_is_ready(void) {
-    return g_hw_status.system_initialized && 
-           g_hw_status.hall_sensor_healthy && 
-           g_hw_status.esc_responding;
+    return g_command_snapshot.read().system_initialized && 
+           g_hall_snapshot.read().hall_sensor_healthy && 
+           g_esc_snapshot.read().esc_responding;
 }
 
 const char* hardware_error_to_string(hardware_error_t error) {
@@ -472,19 +976,34 @@ const char* hardware_error_to_string(hardware_error_t error) {
     }
 }
 
+const char* hardware_esc_arm_state_to_string(esc_arm_state_t state) {
+    switch (state) {
+        case ESC_ARM_DISARMED: return "Disarmed";
+        case ESC_ARM_SETTLING: return "Power settling";
+        case ESC_ARM_NEUTRAL: return "Neutral hold";
+        case ESC_ARM_SIGNAL: return "Arming signal";
+        case ESC_ARM_ARMED: return "Armed";
+        default: return "Unknown";
+    }
+}
+
 bool hardware_is_speed_valid(float speed_ms) {
     return (speed_ms >= 0.0f && speed_ms <= MAX_SPEED_MS);
 }
 
 esp_err_t hardware_get_info(char* info_buffer, size_t buffer_size) {
+    esc_output_info_t esc_info = esc_output_get_info();
     snprintf(info_buffer, buffer_size,
         "Hardware Control System\n"
-        "ESC: GPIO%d (50Hz PWM)\n"
-        "Hall: GPIO%d (Interrupt)\n"
+        "ESC: GPIO%d (%s, %luHz)\n"
+        "Hall: GPIO%d (%s, %d magnet)\n"
         "LED: GPIO%d\n"
         "Wheel: %.1fmm circumference\n"
         "Max Speed: %.1f m/s",
-        (int)ESC_PWM_PIN, (int)HALL_SENSOR_PIN, (int)STATUS_LED_PIN,
+        (int)ESC_PWM_PIN, esc_output_protocol_to_string(esc_info.protocol),
+        (unsigned long)esc_info.frame_rate_hz, (int)HALL_SENSOR_PIN,
+        HALL_BACKEND_PCNT ? "PCNT" : "Interrupt", HALL_MAGNETS_PER_REV,
+        (int)STATUS_LED_PIN,
         WHEEL_CIRCUMFERENCE_MM, MAX_SPEED_MS);
     return ESP_OK;
 }
@@ -500,7 +1019,7 @@ esp_err_t hardware_register_esc_callback(esc_status_callback_t callback) {
 }
 
 esp_err_t hardware_set_esc_duty_direct(uint16_t duty_cycle) {
-    if (!g_hw_status.esc_armed) {
+    if (!g_command_state.esc_armed) {
         return ESP_ERR_INVALID_STATE;
     }
     
@@ -508,18 +1027,65 @@ esp_err_t hardware_set_esc_duty_direct(uint16_t duty_cycle) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    ledc_set_duty(LEDC_LOW_SPEED_MODE, ESC_PWM_CHANNEL, duty_cycle);
-    ledc_update_duty(LEDC_LOW_SPEED_MODE, ESC_PWM_CHANNEL);
-    g_hw_status.current_esc_duty = duty_cycle;
+    power_manager_motion_begin();
+    write_esc_duty(duty_cycle);
+    g_esc_state.current_esc_duty = duty_cycle;
+    publish_esc_state();
     
     return ESP_OK;
 }
 
+esp_err_t hardware_esc_set_protocol(esc_protocol_t protocol) {
+    // Never swap the signal under a live or arming ESC
+    if (g_arm_state.load(std::memory_order_acquire) != ESC_ARM_DISARMED) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t result = esc_output_select(protocol);
+    if (result == ESP_OK) {
+        g_esc_state.current_esc_duty = ESC_NEUTRAL_DUTY;
+        g_last_esc_duty = ESC_NEUTRAL_DUTY;
+        publish_esc_state();
+    }
+    return result;
+}
+
 uint16_t hardware_get_esc_duty(void) {
-    return g_hw_status.current_esc_duty;
+    return g_esc_snapshot.read().current_esc_duty;
 }
 
 esp_err_t hardware_set_esc_rate_limiting(bool enable) {
     g_rate_limiting_enabled = enable;
     return ESP_OK;
+}
+
+esp_err_t hardware_set_speed_controller_gains(const speed_controller_gains_t* gains) {
+    if (!gains || gains->kp < 0.0f || gains->ki < 0.0f ||
+        gains->integrator_limit < 0.0f || gains->accel_limit_ms2 <= 0.0f) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    g_controller_gains = *gains;
+    g_gains_snapshot.publish_from(&g_controller_gains);
+    
+    ESP_LOGI(TAG, "Speed controller gains: kp=%.1f ki=%.1f i_limit=%.0f accel=%.2f m/s²",
+             gains->kp, gains->ki, gains->integrator_limit, gains->accel_limit_ms2);
+    return ESP_OK;
+}
+
+speed_controller_gains_t hardware_get_speed_controller_gains(void) {
+    return g_gains_snapshot.read();
+}
+
+speed_controller_status_t hardware_get_speed_controller_status(void) {
+    return g_controller_snapshot.read();
+}
+
+esp_err_t hardware_set_feed_forward_bias(float bias_duty) {
+    if (!g_command_state.system_initialized) return ESP_ERR_INVALID_STATE;
+    
+    if (bias_duty > SPEED_CTRL_MAX_BIAS_DUTY) bias_duty = SPEED_CTRL_MAX_BIAS_DUTY;
+    if (bias_duty < -SPEED_CTRL_MAX_BIAS_DUTY) bias_duty = -SPEED_CTRL_MAX_BIAS_DUTY;
+    g_command_state.feed_forward_bias_duty = bias_duty;
+    publish_command_state();
+    return ESP_OK;
 }
\ No newline at end of file
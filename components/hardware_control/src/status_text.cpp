@@ -0,0 +1,102 @@
+// components/hardware_control/src/status_text.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// STATUS_TEXT.CPP - MESSAGE TABLE (RODATA)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "status_text.h"
+
+static const char* const k_status_text[] = {
+    "",
+
+    // Shared
+    "Arming ESC...",
+    "Failed to arm ESC",
+    "ESC arming cancelled",
+    "Emergency stop activated",
+    "System initializing...",
+
+    // Mode coordinator
+    "Wire Learning: Active",
+    "Automatic: Active",
+    "Manual: Active",
+    "No active mode",
+    "Stored calibration does not match wire - wire learning required",
+    "SENSOR VALIDATION REQUIRED: Step 1: ROTATE THE WHEEL manually",
+    "Step 1: ROTATE THE WHEEL manually to test Hall sensor",
+    "HALL SENSOR OK! Press 'Confirm Hall Sensor' button to continue",
+    "Step 2: SHAKE THE TROLLEY to test accelerometer",
+    "ACCELEROMETER OK! Press 'Confirm Accelerometer' button to complete",
+    "✅ ALL SENSORS VALIDATED - Modes now available",
+    "✅ Sensors validated and ready for operation",
+    "❌ Sensor validation FAILED - Check connections and retry",
+
+    // Sensor health
+    "ROTATE THE WHEEL - Testing Hall sensor...",
+    "SHAKE THE TROLLEY - Testing accelerometer...",
+    "No wheel rotation detected - check/replace Hall sensor",
+    "Both sensors validated - System ready!",
+    "Fix/replace accelerometer or its connections",
+    "System operational - All sensors healthy",
+
+    // Wire learning
+    "Wire learning ready",
+    "Initializing wire learning...",
+    "Finding the reverse wire end...",
+    "Learning forward direction...",
+    "Pausing before reverse direction...",
+    "Learning reverse direction...",
+    "Wire learning completed successfully",
+    "Wire learning failed: forward and reverse lengths differ beyond tolerance",
+    "Wire length out of valid range",
+    "Wire learning timeout",
+    "Wire learning failed: no Hall pulses at the test speed",
+    "Wire learning stopped by user",
+    "Wire learning stopping gracefully...",
+    "Wire learning reset",
+
+    // Automatic mode
+    "Automatic mode ready",
+    "Auto-arming ESC...",
+    "Failed to auto-arm ESC",
+    "Wire learning required before automatic mode",
+    "Coasting calibration - accelerating",
+    "Measuring coasting distance...",
+    "Coasting calibration complete",
+    "Planned run - accelerating",
+    "Planned run - changing speed",
+    "Planned run - cruising",
+    "Planned run - coasting to wire end",
+    "Final approach to wire end",
+    "Seeking wire end at approach speed",
+    "Wire end not reached at approach speed",
+    "Wire end reached - changing direction",
+    "Automatic cycling complete",
+    "Stopping gracefully - finishing current run",
+    "Interrupted by user - stopping immediately",
+    "EMERGENCY STOP - Automatic mode halted",
+    "Safety failure during planned motion",
+    "Stored calibration mismatch - run wire learning",
+
+    // Manual mode
+    "Manual mode ready",
+    "Manual mode active - ARM ESC to enable motor control",
+    "Manual mode stopped",
+    "Motor active - manual control",
+    "Motor stopped - ready for commands",
+    "Stopping motor...",
+    "Disarming ESC...",
+    "ESC disarmed - ready for arming",
+    "ESC armed - ready for motor commands",
+    "ESC arming cancelled - arm again to drive",
+    "EMERGENCY STOP - All motion halted",
+    "Session reset - ESC armed and ready",
+    "Session reset - ARM ESC to enable motor control",
+};
+
+static_assert(sizeof(k_status_text) / sizeof(k_status_text[0]) == STATUS_TEXT_COUNT,
+              "k_status_text must have one entry per status_text_t");
+
+const char* status_text_to_string(status_text_t code) {
+    if (code >= STATUS_TEXT_COUNT) return "";
+    return k_status_text[code];
+}
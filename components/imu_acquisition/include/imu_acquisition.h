@@ -0,0 +1,130 @@
+// components/imu_acquisition/include/imu_acquisition.h
+#ifndef IMU_ACQUISITION_H
+#define IMU_ACQUISITION_H
+
+#include "esp_err.h"
+#include "MPU.hpp"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// IMU_ACQUISITION.H - HIGH-RATE MPU6050 SAMPLING VIA FIFO + DATA-READY INT
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Own the MPU6050 after init and deliver every sample
+// - MPU6050 samples accel into its FIFO at IMU_SAMPLE_RATE_HZ
+// - Data-ready INT wakes the acquisition task, which bursts a whole batch
+//   out of the FIFO in one I2C transaction
+// - Samples go into a broadcast ring: every consumer has its own cursor, so
+//   sensor_health, wire learning and automatic mode all see every sample
+// - Samples stay in raw counts with an integer magnitude (fixed_point.h):
+//   the acquisition task never uses the FPU; consumers convert with imu_raw_to_g()
+//
+// Consumers NEVER talk to the MPU over I2C themselves
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Acquisition configuration
+#define IMU_SAMPLE_RATE_HZ          500         // MPU6050 output data rate
+#define IMU_BATCH_SAMPLES           8           // Data-ready interrupts per FIFO burst
+#define IMU_RING_SIZE               256         // Samples kept (must be power of 2)
+#define IMU_ACCEL_LSB_PER_G         4096        // ±8g full scale: raw counts are Q3.12 g
+#define IMU_FIFO_SAMPLE_BYTES       6           // Accel X/Y/Z, big-endian int16
+#define IMU_FIFO_SIZE_BYTES         1024        // MPU6050 hardware FIFO size
+#define IMU_TASK_CORE               1           // Next to the control loop consumer
+#define IMU_TASK_PRIORITY           19          // Just below the control loop
+#define IMU_TASK_STACK              4096        // Task stack size
+
+// One accelerometer sample (counts of 1/IMU_ACCEL_LSB_PER_G g)
+typedef struct {
+    uint64_t timestamp_us;             // Estimated sample time (esp_timer)
+    int16_t x_raw;
+    int16_t y_raw;
+    int16_t z_raw;
+    uint16_t total_raw;                // Magnitude of x/y/z (integer square root)
+} imu_sample_t;
+
+/**
+ * @brief Convert raw accelerometer counts to g (UI/float consumers)
+ * @param raw Counts of 1/IMU_ACCEL_LSB_PER_G g
+ * @return Acceleration in g
+ */
+static inline float imu_raw_to_g(int32_t raw) {
+    return raw * (1.0f / IMU_ACCEL_LSB_PER_G);
+}
+
+// Per-consumer read cursor (owned by the consumer, one per reading task)
+typedef struct {
+    uint32_t position;                 // Next sample index to read
+    uint32_t overruns;                 // Samples lost because reader fell behind
+} imu_reader_t;
+
+// Acquisition statistics
+typedef struct {
+    bool running;                      // Acquisition task active
+    bool interrupt_driven;             // false = INT not seen, polling FIFO on timeout
+    uint32_t sample_rate_hz;           // Configured output data rate
+    uint32_t samples_total;            // Samples pushed into the ring
+    uint32_t batches_total;            // FIFO bursts read
+    uint32_t max_batch_samples;        // Largest burst seen
+    uint32_t fifo_overflows;           // FIFO resets due to overflow/misalignment
+    uint32_t i2c_errors;               // Failed FIFO reads
+    uint32_t last_burst_us;            // Duration of last FIFO burst read
+} imu_acquisition_stats_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CORE ACQUISITION API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Configure MPU6050 FIFO and INT pin, start the acquisition task
+ * @param mpu_sensor Initialized MPU6050 (acquisition owns it afterwards)
+ * @return ESP_OK on success, error code on failure
+ */
+esp_err_t imu_acquisition_init(MPU_t* mpu_sensor);
+
+/**
+ * @brief Check if acquisition is delivering samples
+ * @return true if running, false otherwise
+ */
+bool imu_acquisition_is_running(void);
+
+/**
+ * @brief Get acquisition statistics (tear-free snapshot)
+ * @return imu_acquisition_stats_t structure
+ */
+imu_acquisition_stats_t imu_acquisition_get_stats(void);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSUMER API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Attach a reader at the newest sample (older samples are skipped)
+ * @param reader Reader cursor to initialize
+ */
+void imu_acquisition_reader_init(imu_reader_t* reader);
+
+/**
+ * @brief Copy samples not yet seen by this reader, oldest first
+ * @param reader Reader cursor (advanced past the returned samples)
+ * @param samples Destination buffer
+ * @param max_samples Capacity of destination buffer
+ * @return Number of samples copied (0 if none new)
+ */
+size_t imu_acquisition_read(imu_reader_t* reader, imu_sample_t* samples, size_t max_samples);
+
+/**
+ * @brief Consume all new samples and return the largest magnitude among them
+ * @param reader Reader cursor (advanced to the newest sample)
+ * @return Peak total_g since last call, 0.0 if no new samples
+ */
+float imu_acquisition_read_peak_g(imu_reader_t* reader);
+
+/**
+ * @brief Get most recent sample without consuming anything
+ * @return Latest sample (all zero before the first sample)
+ */
+imu_sample_t imu_acquisition_get_latest(void);
+
+#endif // IMU_ACQUISITION_H
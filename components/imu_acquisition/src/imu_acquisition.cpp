@@ -0,0 +1,309 @@
+// components/imu_acquisition/src/imu_acquisition.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// IMU_ACQUISITION.CPP - MPU6050 FIFO BURST READER AND SAMPLE RING
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Move accelerometer samples from the MPU6050 FIFO
+// into a lock-free broadcast ring
+// - INT pin ISR only notifies the acquisition task
+// - Task counts data-ready pulses and reads the FIFO once per batch
+// - If no INT arrives (pin not wired) the task polls the FIFO on timeout
+// - Single writer (this task), any number of readers with their own cursor
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "imu_acquisition.h"
+#include "pin_config.h"
+#include "status_snapshot.h"
+#include "fixed_point.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <cstring>
+
+static const char* TAG = "IMU_ACQ";
+
+#define IMU_DLPF_BANDWIDTH          mpud::DLPF_188HZ    // Keeps ms-scale impacts at 500 Hz
+#define IMU_SAMPLE_PERIOD_US        (1000000 / IMU_SAMPLE_RATE_HZ)
+#define IMU_BATCH_PERIOD_MS         (IMU_BATCH_SAMPLES * 1000 / IMU_SAMPLE_RATE_HZ)
+#define IMU_POLL_TIMEOUT_MS         (IMU_BATCH_PERIOD_MS * 2)
+#define IMU_RING_MASK               (IMU_RING_SIZE - 1)
+
+static_assert((IMU_RING_SIZE & IMU_RING_MASK) == 0, "IMU_RING_SIZE must be a power of 2");
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// GLOBAL STATE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static MPU_t* g_mpu = nullptr;
+static TaskHandle_t g_imu_task_handle = NULL;
+static StackType_t g_imu_task_stack[IMU_TASK_STACK];     // Static: counted at link time, never fragments the heap
+static StaticTask_t g_imu_task_tcb;
+static bool g_imu_initialized = false;
+
+// Broadcast ring: slot i holds sample number i (mod size), head = samples written
+static imu_sample_t g_sample_ring[IMU_RING_SIZE];
+static std::atomic<uint32_t> g_ring_head(0);
+
+// FIFO burst buffer (only touched by the acquisition task)
+static uint8_t g_fifo_buffer[IMU_FIFO_SIZE_BYTES];
+
+// Written only by the acquisition task
+static imu_acquisition_stats_t g_stats = {};
+static status_snapshot<imu_acquisition_stats_t> g_stats_snapshot;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// INTERRUPT AND FIFO HANDLING
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void IRAM_ATTR imu_int_isr_handler(void* arg) {
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(g_imu_task_handle, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+static void push_sample(const imu_sample_t* sample) {
+    uint32_t head = g_ring_head.load(std::memory_order_relaxed);
+    g_sample_ring[head & IMU_RING_MASK] = *sample;
+    g_ring_head.store(head + 1, std::memory_order_release);
+}
+
+static void drain_fifo(void) {
+    uint64_t burst_start = esp_timer_get_time();
+
+    uint16_t fifo_count = g_mpu->getFIFOCount();
+    if (g_mpu->lastError() != ESP_OK) {
+        g_stats.i2c_errors++;
+        return;
+    }
+
+    // A full FIFO has dropped bytes - frame alignment is lost, start over
+    if (fifo_count > IMU_FIFO_SIZE_BYTES - IMU_FIFO_SAMPLE_BYTES) {
+        g_mpu->resetFIFO();
+        g_stats.fifo_overflows++;
+        return;
+    }
+
+    uint32_t sample_count = fifo_count / IMU_FIFO_SAMPLE_BYTES;
+    if (sample_count == 0) return;
+
+    // One I2C transaction for the whole batch
+    if (g_mpu->readFIFO(sample_count * IMU_FIFO_SAMPLE_BYTES, g_fifo_buffer) != ESP_OK) {
+        g_stats.i2c_errors++;
+        return;
+    }
+
+    uint64_t read_time = esp_timer_get_time();
+    for (uint32_t i = 0; i < sample_count; i++) {
+        const uint8_t* raw = &g_fifo_buffer[i * IMU_FIFO_SAMPLE_BYTES];
+        int16_t raw_x = (int16_t)((raw[0] << 8) | raw[1]);
+        int16_t raw_y = (int16_t)((raw[2] << 8) | raw[3]);
+        int16_t raw_z = (int16_t)((raw[4] << 8) | raw[5]);
+
+        imu_sample_t sample;
+        // Newest sample in the burst was taken just before the read
+        sample.timestamp_us = read_time - (uint64_t)(sample_count - 1 - i) * IMU_SAMPLE_PERIOD_US;
+        sample.x_raw = raw_x;
+        sample.y_raw = raw_y;
+        sample.z_raw = raw_z;
+        sample.total_raw = (uint16_t)fx_magnitude3(raw_x, raw_y, raw_z);   // ≤ √3·32768
+        push_sample(&sample);
+    }
+
+    g_stats.samples_total += sample_count;
+    g_stats.batches_total++;
+    if (sample_count > g_stats.max_batch_samples) {
+        g_stats.max_batch_samples = sample_count;
+    }
+    g_stats.last_burst_us = (uint32_t)(esp_timer_get_time() - burst_start);
+}
+
+static void imu_acquisition_task(void* pvParameter) {
+    uint32_t pending_ready = 0;
+
+    ESP_LOGI(TAG, "IMU acquisition task started (%d Hz, %d-sample bursts)",
+             IMU_SAMPLE_RATE_HZ, IMU_BATCH_SAMPLES);
+
+    g_stats.running = true;
+    g_stats_snapshot.write(g_stats);
+
+    while (1) {
+        // Each notification is one data-ready pulse from the MPU6050
+        uint32_t notified = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(IMU_POLL_TIMEOUT_MS));
+
+        if (notified == 0) {
+            // No INT within two batch periods - poll so samples keep flowing
+            g_stats.interrupt_driven = false;
+            pending_ready = 0;
+            drain_fifo();
+        } else {
+            g_stats.interrupt_driven = true;
+            pending_ready += notified;
+            if (pending_ready < IMU_BATCH_SAMPLES) {
+                continue;
+            }
+            pending_ready = 0;
+            drain_fifo();
+        }
+
+        g_stats_snapshot.write(g_stats);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t imu_acquisition_init(MPU_t* mpu_sensor) {
+    if (mpu_sensor == nullptr) return ESP_ERR_INVALID_ARG;
+    if (g_imu_initialized) return ESP_ERR_INVALID_STATE;
+
+    ESP_LOGI(TAG, "Initializing IMU acquisition (FIFO + INT on GPIO%d)...", IMU_INT_PIN);
+
+    g_mpu = mpu_sensor;
+
+    // Sample rate and bandwidth for impact capture
+    esp_err_t ret = g_mpu->setSampleRate(IMU_SAMPLE_RATE_HZ);
+    if (ret != ESP_OK) return ret;
+    ret = g_mpu->setDigitalLowPassFilter(IMU_DLPF_BANDWIDTH);
+    if (ret != ESP_OK) return ret;
+
+    // FIFO holds accelerometer only (6 bytes per sample)
+    ret = g_mpu->setFIFOConfig(mpud::FIFO_CFG_ACCEL);
+    if (ret != ESP_OK) return ret;
+    ret = g_mpu->setFIFOEnabled(true);
+    if (ret != ESP_OK) return ret;
+    ret = g_mpu->resetFIFO();
+    if (ret != ESP_OK) return ret;
+
+    // Data-ready pulse on INT, cleared by any register read
+    mpud::int_config_t int_config = {
+        .level = mpud::INT_LVL_ACTIVE_HIGH,
+        .drive = mpud::INT_DRV_PUSHPULL,
+        .mode = mpud::INT_MODE_PULSE50US,
+        .clear = mpud::INT_CLEAR_ANYREAD
+    };
+    ret = g_mpu->setInterruptConfig(int_config);
+    if (ret != ESP_OK) return ret;
+    ret = g_mpu->setInterruptEnabled(mpud::INT_EN_RAWDATA_READY);
+    if (ret != ESP_OK) return ret;
+
+    // Task must exist before the ISR can notify it (kept across a failed init: static buffers)
+    if (g_imu_task_handle == NULL) {
+        g_imu_task_handle = xTaskCreateStaticPinnedToCore(imu_acquisition_task, "imu_acq",
+                                                          IMU_TASK_STACK, NULL, IMU_TASK_PRIORITY,
+                                                          g_imu_task_stack, &g_imu_task_tcb, IMU_TASK_CORE);
+    }
+    if (g_imu_task_handle == NULL) {
+        ESP_LOGE(TAG, "Failed to create IMU acquisition task");
+        return ESP_ERR_NO_MEM;
+    }
+
+    gpio_config_t io_conf = {
+        .pin_bit_mask = (1ULL << IMU_INT_PIN),
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_ENABLE,
+        .intr_type = GPIO_INTR_POSEDGE
+    };
+    ret = gpio_config(&io_conf);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "INT pin config failed - polling FIFO instead");
+    } else {
+        // ISR service is normally installed by hardware_init()
+        ret = gpio_install_isr_service(0);
+        if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+            ESP_LOGW(TAG, "GPIO ISR service unavailable - polling FIFO instead");
+        } else {
+            gpio_isr_handler_add(IMU_INT_PIN, imu_int_isr_handler, NULL);
+        }
+    }
+
+    g_stats.sample_rate_hz = IMU_SAMPLE_RATE_HZ;
+    g_imu_initialized = true;
+
+    ESP_LOGI(TAG, "IMU acquisition initialized: %d Hz, ring %d samples",
+             IMU_SAMPLE_RATE_HZ, IMU_RING_SIZE);
+    return ESP_OK;
+}
+
+bool imu_acquisition_is_running(void) {
+    return g_stats_snapshot.read().running;
+}
+
+imu_acquisition_stats_t imu_acquisition_get_stats(void) {
+    return g_stats_snapshot.read();
+}
+
+void imu_acquisition_reader_init(imu_reader_t* reader) {
+    if (reader == NULL) return;
+    reader->position = g_ring_head.load(std::memory_order_acquire);
+    reader->overruns = 0;
+}
+
+size_t imu_acquisition_read(imu_reader_t* reader, imu_sample_t* samples, size_t max_samples) {
+    if (reader == NULL || samples == NULL || max_samples == 0) return 0;
+
+    uint32_t head = g_ring_head.load(std::memory_order_acquire);
+
+    // Reader fell more than a ring behind - skip to the oldest slot still intact
+    if (head - reader->position > IMU_RING_SIZE) {
+        reader->overruns += head - reader->position - IMU_RING_SIZE;
+        reader->position = head - IMU_RING_SIZE;
+    }
+
+    uint32_t available = head - reader->position;
+    size_t count = available < max_samples ? available : max_samples;
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = g_sample_ring[(reader->position + i) & IMU_RING_MASK];
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    // Writer may have lapped us during the copy; slot of sample n is reused
+    // by sample n + IMU_RING_SIZE, and the writer may be filling head_now
+    uint32_t head_now = g_ring_head.load(std::memory_order_relaxed);
+    uint32_t oldest_intact = head_now + 1 - IMU_RING_SIZE;
+    if ((int32_t)(oldest_intact - reader->position) > 0) {
+        size_t stale = oldest_intact - reader->position;
+        if (stale > count) stale = count;
+        memmove(samples, samples + stale, (count - stale) * sizeof(imu_sample_t));
+        reader->overruns += stale;
+        reader->position += stale;
+        count -= stale;
+    }
+
+    reader->position += count;
+    return count;
+}
+
+float imu_acquisition_read_peak_g(imu_reader_t* reader) {
+    imu_sample_t batch[IMU_BATCH_SAMPLES * 2];
+    uint16_t peak_raw = 0;
+
+    size_t count;
+    while ((count = imu_acquisition_read(reader, batch, sizeof(batch) / sizeof(batch[0]))) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            if (batch[i].total_raw > peak_raw) {
+                peak_raw = batch[i].total_raw;
+            }
+        }
+    }
+
+    return imu_raw_to_g(peak_raw);
+}
+
+imu_sample_t imu_acquisition_get_latest(void) {
+    imu_sample_t sample = {};
+    uint32_t head;
+
+    do {
+        head = g_ring_head.load(std::memory_order_acquire);
+        if (head == 0) return sample;
+        sample = g_sample_ring[(head - 1) & IMU_RING_MASK];
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while (g_ring_head.load(std::memory_order_relaxed) - head >= IMU_RING_SIZE - 1);
+
+    return sample;
+}
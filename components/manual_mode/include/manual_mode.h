@@ -2,6 +2,7 @@
 #define MANUAL_MODE_H
 
 #include "esp_err.h"
+#include "status_text.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -124,8 +125,8 @@ typedef struct {
     uint32_t safety_violations;         // Number of safety violations
     
     // Status and error tracking
-    char status_message[128];
-    char error_message[128];
+    status_text_t status_text;
+    status_text_t error_text;
     uint32_t error_count;
 } manual_mode_status_t;
 
@@ -179,6 +180,12 @@ esp_err_t manual_mode_update(void);
  */
 bool manual_mode_is_active(void);
 
+/**
+ * @brief Get current manual mode state (no status struct copy)
+ * @return Current manual_mode_state_t
+ */
+manual_mode_state_t manual_mode_get_state(void);
+
 /**
  * @brief Get current manual mode status
  * @return Current status data structure
@@ -5,10 +5,14 @@
 
 #include "manual_mode.h"
 #include "hardware_control.h"
+#include "hal_clock.h"
 #include "sensor_health.h"
+#include "state_estimator.h"
 #include "mode_coordinator.h"
+#include "flight_recorder.h"
+#include "deferred_log.h"
 #include "esp_log.h"
-#include "esp_timer.h"
+#include <cinttypes>
 #include <cstring>
 #include <cmath>
 
@@ -16,6 +20,7 @@ static const char* TAG = "MANUAL_MODE";
 
 // FIXED: Add missing constant definition
 #define MOTION_VALIDATION_TIMEOUT_MS    2000      // 2 second timeout for motion validation
+#define MANUAL_STOP_SETTLE_MS           200       // Time in STOPPING before accepting as stopped
 
 // ═══════════════════════════════════════════════════════════════════════════════
 // GLOBAL MANUAL MODE STATE - FIXED: Proper struct initialization
@@ -38,8 +43,8 @@ static manual_mode_status_t g_manual_status = {
     .max_speed_reached = 0.0f,
     .total_distance_traveled = 0.0f,
     .safety_violations = 0,
-    .status_message = {0},
-    .error_message = {0},
+    .status_text = STATUS_TEXT_NONE,
+    .error_text = STATUS_TEXT_NONE,
     .error_count = 0
 };
 
@@ -50,7 +55,7 @@ static manual_mode_session_stats_t g_session_stats = {
     .speed_changes = 0,
     .esc_arm_disarm_cycles = 0,
     .max_speed_used = 0.0f,
-    .total_distance_traveled_m = 0.0f,
+    .total_distance_traveled = 0.0f,
     .session_duration_ms = 0,
     .motor_active_time_ms = 0,
     .average_speed = 0.0f
@@ -68,12 +73,15 @@ static uint64_t g_last_second_start = 0;
 static uint64_t g_last_motion_validation_time = 0;
 static uint32_t g_motion_validation_failures = 0;
 
+// Smooth stop - STOPPING ends when this deadline passes (checked in update)
+static uint64_t g_stop_settle_deadline = 0;
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // COMMAND VALIDATION AND RATE LIMITING
 // ═══════════════════════════════════════════════════════════════════════════════
 
 bool manual_mode_check_command_rate_limit(void) {
-    uint64_t current_time = esp_timer_get_time();
+    uint64_t current_time = hal_clock_now_us();
     
     // Reset counter every second
     if (current_time - g_last_second_start > 1000000ULL) {
@@ -83,7 +91,7 @@ bool manual_mode_check_command_rate_limit(void) {
     
     // Check rate limit
     if (g_commands_this_second >= MANUAL_MAX_COMMANDS_PER_SEC) {
-        ESP_LOGW(TAG, "Command rate limit exceeded: %lu commands this second", g_commands_this_second);
+        ESP_LOGW(TAG, "Command rate limit exceeded: %" PRIu32 " commands this second", g_commands_this_second);
         return false;
     }
     
@@ -236,7 +244,7 @@ esp_err_t manual_mode_execute_command(const manual_command_t* command) {
     if (result == ESP_OK) {
         memcpy(&g_manual_status.last_command, command, sizeof(manual_command_t));
         g_manual_status.command_count++;
-        g_manual_status.last_command_time = esp_timer_get_time();
+        g_manual_status.last_command_time = hal_clock_now_us();
         g_session_stats.total_commands_executed++;
     } else {
         g_manual_status.error_count++;
@@ -253,7 +261,7 @@ manual_command_t manual_mode_create_command(manual_command_type_t type,
         .type = type,
         .speed_parameter = speed,
         .direction_forward = forward,
-        .timestamp = esp_timer_get_time(),
+        .timestamp = (uint64_t)hal_clock_now_us(),
         .validated = false,
         .source = {0}
     };
@@ -303,7 +311,7 @@ esp_err_t manual_mode_set_speed(float speed_ms, bool forward) {
     }
     
     // Apply speed to hardware
-    esp_err_t result = hardware_set_motor_speed(speed_ms, forward);
+    esp_err_t result = hardware_set_speed_closed_loop(speed_ms, forward);
     if (result != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set hardware speed");
         return result;
@@ -316,10 +324,10 @@ esp_err_t manual_mode_set_speed(float speed_ms, bool forward) {
         } else {
             g_manual_status.state = MANUAL_MODE_MOVING_BACKWARD;
         }
-        strcpy(g_manual_status.status_message, "Motor active - manual control");
+        g_manual_status.status_text = STATUS_TEXT_MANUAL_MOTOR_ACTIVE;
     } else {
         g_manual_status.state = MANUAL_MODE_ACTIVE;
-        strcpy(g_manual_status.status_message, "Motor stopped - ready for commands");
+        g_manual_status.status_text = STATUS_TEXT_MANUAL_MOTOR_STOPPED;
     }
     
     return ESP_OK;
@@ -339,13 +347,10 @@ esp_err_t manual_mode_stop_movement(void) {
     esp_err_t result = manual_mode_set_speed(0.0f, g_manual_status.direction_forward);
     if (result == ESP_OK) {
         g_manual_status.state = MANUAL_MODE_STOPPING;
-        strcpy(g_manual_status.status_message, "Stopping motor...");
-        
-        // Brief delay for smooth stop
-        vTaskDelay(pdMS_TO_TICKS(200));
+        g_manual_status.status_text = STATUS_TEXT_MANUAL_STOPPING_MOTOR;
         
-        g_manual_status.state = MANUAL_MODE_ACTIVE;
-        strcpy(g_manual_status.status_message, "Motor stopped - ready for commands");
+        // Brief settle time for smooth stop - completed by manual_mode_update()
+        g_stop_settle_deadline = hal_clock_now_us() + MANUAL_STOP_SETTLE_MS * 1000ULL;
     }
     
     return result;
@@ -401,20 +406,14 @@ esp_err_t manual_mode_arm_esc(void) {
     ESP_LOGI(TAG, "Arming ESC in manual mode");
     
     g_manual_status.state = MANUAL_MODE_ESC_ARMING;
-    strcpy(g_manual_status.status_message, "Arming ESC...");
+    g_manual_status.status_text = STATUS_TEXT_ARMING_ESC;
     
+    // Non-blocking: manual_mode_update() finishes once the sequence completes
     esp_err_t result = hardware_esc_arm();
-    if (result == ESP_OK) {
-        g_manual_status.esc_armed = true;
-        g_manual_status.esc_responding = true;
-        g_manual_status.esc_arm_time = esp_timer_get_time();
-        g_manual_status.state = MANUAL_MODE_ACTIVE;
-        strcpy(g_manual_status.status_message, "ESC armed - ready for motor commands");
-        
-        ESP_LOGI(TAG, "ESC armed successfully in manual mode");
-    } else {
+    if (result != ESP_OK) {
         g_manual_status.state = MANUAL_MODE_ERROR;
-        strcpy(g_manual_status.error_message, "Failed to arm ESC");
+        g_manual_status.error_text = STATUS_TEXT_ARM_FAILED;
+        flight_recorder_trigger(FLIGHT_TRIGGER_MODE_ERROR);
         ESP_LOGE(TAG, "Failed to arm ESC in manual mode");
     }
     
@@ -428,7 +427,7 @@ esp_err_t manual_mode_disarm_esc(void) {
     manual_mode_stop_movement();
     
     g_manual_status.state = MANUAL_MODE_ESC_DISARMING;
-    strcpy(g_manual_status.status_message, "Disarming ESC...");
+    g_manual_status.status_text = STATUS_TEXT_MANUAL_DISARMING;
     
     esp_err_t result = hardware_esc_disarm();
     
@@ -437,7 +436,7 @@ esp_err_t manual_mode_disarm_esc(void) {
     g_manual_status.motor_active = false;
     g_manual_status.target_speed_ms = 0.0f;
     g_manual_status.state = MANUAL_MODE_READY;
-    strcpy(g_manual_status.status_message, "ESC disarmed - ready for arming");
+    g_manual_status.status_text = STATUS_TEXT_MANUAL_DISARMED;
     
     ESP_LOGI(TAG, "ESC disarmed in manual mode");
     return result;
@@ -456,7 +455,7 @@ uint32_t manual_mode_get_esc_armed_time(void) {
         return 0;
     }
     
-    return (esp_timer_get_time() - g_manual_status.esc_arm_time) / 1000;
+    return (hal_clock_now_us() - g_manual_status.esc_arm_time) / 1000;
 }
 
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -464,23 +463,21 @@ uint32_t manual_mode_get_esc_armed_time(void) {
 // ═══════════════════════════════════════════════════════════════════════════════
 
 bool manual_mode_monitor_sensor_health(void) {
-    sensor_health_t sensor_status = sensor_health_get_status();
-    
     // Check if sensors are still validated
     if (!mode_coordinator_are_sensors_validated()) {
-        ESP_LOGW(TAG, "Sensors no longer validated");
+        deferred_log(DLOG_MSG_MANUAL_SENSORS_INVALID);
         return false;
     }
     
     // Check for excessive impact
     if (manual_mode_check_impact_detection()) {
-        ESP_LOGW(TAG, "Excessive impact detected");
+        deferred_log(DLOG_MSG_MANUAL_EXCESSIVE_IMPACT);
         return false;
     }
     
     // Check Hall sensor during movement
     if (g_manual_status.motor_active && !manual_mode_monitor_hall_sensor()) {
-        ESP_LOGW(TAG, "Hall sensor not responding during movement");
+        deferred_log(DLOG_MSG_MANUAL_HALL_SILENT);
         return false;
     }
     
@@ -491,8 +488,7 @@ bool manual_mode_check_impact_detection(void) {
     sensor_health_t sensor_status = sensor_health_get_status();
     
     if (sensor_status.total_accel_g > MANUAL_MODE_MAX_IMPACT_G) {
-        ESP_LOGW(TAG, "Impact detected: %.2f g > %.2f g threshold", 
-                sensor_status.total_accel_g, MANUAL_MODE_MAX_IMPACT_G);
+        deferred_log(DLOG_MSG_MANUAL_IMPACT, sensor_status.total_accel_g, MANUAL_MODE_MAX_IMPACT_G);
         
         // Auto-stop on high impact
         manual_mode_emergency_stop();
@@ -503,7 +499,7 @@ bool manual_mode_check_impact_detection(void) {
 }
 
 bool manual_mode_monitor_hall_sensor(void) {
-    uint64_t current_time = esp_timer_get_time();
+    uint64_t current_time = hal_clock_now_us();
     
     // Only check during movement
     if (!g_manual_status.motor_active) {
@@ -519,7 +515,7 @@ bool manual_mode_monitor_hall_sensor(void) {
             g_motion_validation_failures++;
             
             if (g_motion_validation_failures >= 3) {
-                ESP_LOGW(TAG, "Hall sensor validation failed - no movement detected");
+                deferred_log(DLOG_MSG_MANUAL_HALL_NO_MOVEMENT);
                 manual_mode_emergency_stop();
                 return false;
             }
@@ -546,7 +542,7 @@ bool manual_mode_is_operation_safe(void) {
     
     // Check ESC health if armed
     if (g_manual_status.esc_armed && !manual_mode_is_esc_responding()) {
-        ESP_LOGW(TAG, "ESC not responding");
+        deferred_log(DLOG_MSG_MANUAL_ESC_NOT_RESPONDING);
         return false;
     }
     
@@ -554,7 +550,7 @@ bool manual_mode_is_operation_safe(void) {
 }
 
 esp_err_t manual_mode_emergency_stop(void) {
-    ESP_LOGW(TAG, "EMERGENCY STOP activated in manual mode");
+    deferred_log(DLOG_MSG_MANUAL_EMERGENCY);
     
     // Stop hardware immediately
     hardware_emergency_stop();
@@ -564,7 +560,7 @@ esp_err_t manual_mode_emergency_stop(void) {
     g_manual_status.motor_active = false;
     g_manual_status.target_speed_ms = 0.0f;
     g_manual_status.current_speed_ms = 0.0f;
-    strcpy(g_manual_status.status_message, "EMERGENCY STOP - All motion halted");
+    g_manual_status.status_text = STATUS_TEXT_MANUAL_EMERGENCY;
     
     return ESP_OK;
 }
@@ -574,7 +570,7 @@ esp_err_t manual_mode_emergency_stop(void) {
 // ═══════════════════════════════════════════════════════════════════════════════
 
 float manual_mode_get_current_position(void) {
-    return hardware_get_current_position();
+    return state_estimator_get_position();
 }
 
 esp_err_t manual_mode_reset_position(void) {
@@ -583,7 +579,7 @@ esp_err_t manual_mode_reset_position(void) {
     esp_err_t result = hardware_reset_position();
     if (result == ESP_OK) {
         g_manual_status.total_distance_traveled = 0.0f;
-        g_session_stats.total_distance_traveled_m = 0.0f;
+        g_session_stats.total_distance_traveled = 0.0f;
     }
     
     return result;
@@ -598,8 +594,8 @@ esp_err_t manual_mode_init(void) {
     
     // Reset manual mode state - already properly initialized above
     g_manual_status.state = MANUAL_MODE_IDLE;
-    strcpy(g_manual_status.status_message, "Manual mode ready");
-    strcpy(g_manual_status.error_message, "");
+    g_manual_status.status_text = STATUS_TEXT_MANUAL_READY;
+    g_manual_status.error_text = STATUS_TEXT_NONE;
     
     // Reset rate limiting
     memset(g_command_times, 0, sizeof(g_command_times));
@@ -636,7 +632,7 @@ esp_err_t manual_mode_start(void) {
     
     // Update state
     g_manual_status.state = MANUAL_MODE_READY;
-    g_manual_status.mode_start_time = esp_timer_get_time();
+    g_manual_status.mode_start_time = hal_clock_now_us();
     g_manual_status.esc_armed = false;
     g_manual_status.motor_active = false;
     g_manual_status.target_speed_ms = 0.0f;
@@ -645,8 +641,8 @@ esp_err_t manual_mode_start(void) {
     g_manual_status.command_count = 0;
     g_manual_status.error_count = 0;
     
-    strcpy(g_manual_status.status_message, "Manual mode active - ARM ESC to enable motor control");
-    strcpy(g_manual_status.error_message, "");
+    g_manual_status.status_text = STATUS_TEXT_MANUAL_ACTIVE_ARM;
+    g_manual_status.error_text = STATUS_TEXT_NONE;
     
     // Reset position tracking
     hardware_reset_position();
@@ -665,20 +661,20 @@ esp_err_t manual_mode_stop(void) {
     }
     
     // Calculate final session stats
-    g_session_stats.session_duration_ms = (esp_timer_get_time() - g_manual_status.mode_start_time) / 1000;
+    g_session_stats.session_duration_ms = (hal_clock_now_us() - g_manual_status.mode_start_time) / 1000;
     g_session_stats.total_commands_executed = g_manual_status.command_count;
     
     if (g_session_stats.motor_active_time_ms > 0) {
-        g_session_stats.average_speed = g_session_stats.total_distance_traveled_m / 
+        g_session_stats.average_speed = g_session_stats.total_distance_traveled / 
                                        (g_session_stats.motor_active_time_ms / 1000.0f);
     }
     
     // Update state
     g_manual_status.state = MANUAL_MODE_IDLE;
-    strcpy(g_manual_status.status_message, "Manual mode stopped");
+    g_manual_status.status_text = STATUS_TEXT_MANUAL_STOPPED;
     
-    ESP_LOGI(TAG, "Manual mode stopped - Session: %lu commands, %.2f m traveled", 
-            g_session_stats.total_commands_executed, g_session_stats.total_distance_traveled_m);
+    ESP_LOGI(TAG, "Manual mode stopped - Session: %" PRIu32 " commands, %.2f m traveled", 
+            g_session_stats.total_commands_executed, g_session_stats.total_distance_traveled);
     
     return ESP_OK;
 }
@@ -688,32 +684,53 @@ esp_err_t manual_mode_update(void) {
         return ESP_OK;
     }
     
-    // Update current speed from hardware
-    g_manual_status.current_speed_ms = hardware_get_current_speed();
+    // Update current speed from the state estimator
+    g_manual_status.current_speed_ms = state_estimator_get_speed();
     
     // Update ESC status
     g_manual_status.esc_responding = hardware_esc_is_armed();
     
+    // Finish ESC arming started by manual_mode_arm_esc()
+    if (g_manual_status.state == MANUAL_MODE_ESC_ARMING) {
+        esc_arm_state_t arm_state = hardware_esc_get_arm_state();
+        if (arm_state == ESC_ARM_ARMED) {
+            g_manual_status.esc_armed = true;
+            g_manual_status.esc_arm_time = hal_clock_now_us();
+            g_manual_status.state = MANUAL_MODE_ACTIVE;
+            g_manual_status.status_text = STATUS_TEXT_MANUAL_ARMED;
+            deferred_log(DLOG_MSG_MANUAL_ESC_ARMED);
+        } else if (arm_state == ESC_ARM_DISARMED) {
+            g_manual_status.state = MANUAL_MODE_ACTIVE;
+            g_manual_status.status_text = STATUS_TEXT_MANUAL_ARM_CANCELLED;
+        }
+    }
+    
     // Update distance tracking
     static float last_position = 0.0f;
-    float current_position = hardware_get_current_position();
+    float current_position = state_estimator_get_position();
     float distance_increment = fabs(current_position - last_position);
     g_manual_status.total_distance_traveled += distance_increment;
-    g_session_stats.total_distance_traveled_m += distance_increment;
+    g_session_stats.total_distance_traveled += distance_increment;
     last_position = current_position;
     
     // Update motor active time
     static uint64_t last_update_time = 0;
-    uint64_t current_time = esp_timer_get_time();
+    uint64_t current_time = hal_clock_now_us();
     if (last_update_time > 0 && g_manual_status.motor_active) {
         uint32_t time_increment = (current_time - last_update_time) / 1000;
         g_session_stats.motor_active_time_ms += time_increment;
     }
     last_update_time = current_time;
     
+    // Finish a smooth stop once its settle time has passed
+    if (g_manual_status.state == MANUAL_MODE_STOPPING && current_time >= g_stop_settle_deadline) {
+        g_manual_status.state = MANUAL_MODE_ACTIVE;
+        g_manual_status.status_text = STATUS_TEXT_MANUAL_MOTOR_STOPPED;
+    }
+    
     // Monitor safety
     if (!manual_mode_is_operation_safe()) {
-        ESP_LOGW(TAG, "Safety check failed - stopping manual mode");
+        deferred_log(DLOG_MSG_MANUAL_SAFETY_STOP);
         manual_mode_emergency_stop();
         return ESP_ERR_INVALID_STATE;
     }
@@ -726,6 +743,10 @@ bool manual_mode_is_active(void) {
            g_manual_status.state < MANUAL_MODE_EMERGENCY_STOP;
 }
 
+manual_mode_state_t manual_mode_get_state(void) {
+    return g_manual_status.state;
+}
+
 manual_mode_status_t manual_mode_get_status(void) {
     return g_manual_status;
 }
@@ -739,7 +760,7 @@ manual_mode_session_stats_t manual_mode_get_session_stats(void) {
 // ═══════════════════════════════════════════════════════════════════════════════
 
 esp_err_t manual_mode_process_user_command(char command_char, const char* source) {
-    manual_command_t command = {0};
+    manual_command_t command = {};
     
     switch (command_char) {
         case 'A':
@@ -820,11 +841,11 @@ esp_err_t manual_mode_get_command_help(char* help_buffer, size_t buffer_size) {
 // ═══════════════════════════════════════════════════════════════════════════════
 
 const char* manual_mode_get_status_message(void) {
-    return g_manual_status.status_message;
+    return status_text_to_string(g_manual_status.status_text);
 }
 
 const char* manual_mode_get_error_message(void) {
-    return g_manual_status.error_message;
+    return status_text_to_string(g_manual_status.error_text);
 }
 
 const char* manual_mode_state_to_string(manual_mode_state_t state) {
@@ -870,8 +891,8 @@ esp_err_t manual_mode_get_detailed_status(char* status_buffer, size_t buffer_siz
         "Motor Active: %s\n"
         "Speed: %.2f m/s %s\n"
         "Position: %.2f m\n"
-        "Commands: %lu total, %lu errors\n"
-        "Session Time: %lu ms\n"
+        "Commands: %" PRIu32 " total, %" PRIu32 " errors\n"
+        "Session Time: %" PRIu32 " ms\n"
         "Distance: %.2f m\n"
         "Max Speed: %.2f m/s\n"
         "Status: %s\n",
@@ -886,7 +907,7 @@ esp_err_t manual_mode_get_detailed_status(char* status_buffer, size_t buffer_siz
         manual_mode_get_session_duration(),
         g_manual_status.total_distance_traveled,
         g_manual_status.max_speed_reached,
-        g_manual_status.status_message);
+        status_text_to_string(g_manual_status.status_text));
     
     return ESP_OK;
 }
@@ -907,18 +928,18 @@ esp_err_t manual_mode_reset_session(void) {
     g_manual_status.error_count = 0;
     g_manual_status.max_speed_reached = 0.0f;
     g_manual_status.total_distance_traveled = 0.0f;
-    g_manual_status.mode_start_time = esp_timer_get_time();
+    g_manual_status.mode_start_time = hal_clock_now_us();
     
     // Reset position
     manual_mode_reset_position();
     
     // Clear error message
-    strcpy(g_manual_status.error_message, "");
+    g_manual_status.error_text = STATUS_TEXT_NONE;
     
     if (g_manual_status.esc_armed) {
-        strcpy(g_manual_status.status_message, "Session reset - ESC armed and ready");
+        g_manual_status.status_text = STATUS_TEXT_MANUAL_RESET_ARMED;
     } else {
-        strcpy(g_manual_status.status_message, "Session reset - ARM ESC to enable motor control");
+        g_manual_status.status_text = STATUS_TEXT_MANUAL_RESET_DISARMED;
     }
     
     ESP_LOGI(TAG, "Manual mode session reset complete");
@@ -930,7 +951,7 @@ uint32_t manual_mode_get_session_duration(void) {
         return 0;
     }
     
-    return (esp_timer_get_time() - g_manual_status.mode_start_time) / 1000;
+    return (hal_clock_now_us() - g_manual_status.mode_start_time) / 1000;
 }
 
 esp_err_t manual_mode_export_session_data(char* data_buffer, size_t buffer_size) {
@@ -940,17 +961,17 @@ esp_err_t manual_mode_export_session_data(char* data_buffer, size_t buffer_size)
     
     snprintf(data_buffer, buffer_size,
         "MANUAL_MODE_SESSION_DATA\n"
-        "session_duration_ms=%lu\n"
-        "total_commands=%lu\n"
-        "forward_commands=%lu\n"
-        "backward_commands=%lu\n"
-        "speed_changes=%lu\n"
-        "esc_cycles=%lu\n"
+        "session_duration_ms=%" PRIu32 "\n"
+        "total_commands=%" PRIu32 "\n"
+        "forward_commands=%" PRIu32 "\n"
+        "backward_commands=%" PRIu32 "\n"
+        "speed_changes=%" PRIu32 "\n"
+        "esc_cycles=%" PRIu32 "\n"
         "max_speed_ms=%.2f\n"
         "total_distance_m=%.2f\n"
-        "motor_active_time_ms=%lu\n"
+        "motor_active_time_ms=%" PRIu32 "\n"
         "average_speed_ms=%.2f\n"
-        "error_count=%lu\n"
+        "error_count=%" PRIu32 "\n"
         "max_speed_reached=%.2f\n",
         stats.session_duration_ms,
         stats.total_commands_executed,
@@ -959,18 +980,11 @@ esp_err_t manual_mode_export_session_data(char* data_buffer, size_t buffer_size)
         stats.speed_changes,
         stats.esc_arm_disarm_cycles,
         stats.max_speed_used,
-        stats.total_distance_traveled_m,
+        stats.total_distance_traveled,
         stats.motor_active_time_ms,
         stats.average_speed,
         g_manual_status.error_count,
         g_manual_status.max_speed_reached);
     
     return ESP_OK;
-}buffer, buffer_size, "A=Arm ESC");
-    } else if (g_manual_status.state == MANUAL_MODE_ACTIVE) {
-        snprintf(commands_buffer, buffer_size, "F=Forward, B=Backward, S=Stop, +=Faster, -=Slower, D=Disarm, E=Emergency");
-    } else {
-        snprintf(commands_// components/manual_mode/src/manual_mode.cpp
-
-
-// ═══════════════
\ No newline at end of file
+}
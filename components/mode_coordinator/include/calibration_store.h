@@ -0,0 +1,99 @@
+// components/mode_coordinator/include/calibration_store.h
+#ifndef CALIBRATION_STORE_H
+#define CALIBRATION_STORE_H
+
+#include "esp_err.h"
+#include "mode_coordinator.h"
+#include "wire_learning_mode.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CALIBRATION_STORE.H - PER-SITE WIRE LEARNING AND COASTING PROFILES IN NVS
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Survive power cycles without re-learning the wire
+// - One blob per wire/site, the site ID is the NVS key
+// - Blob carries magic, layout version, struct sizes and a CRC-32, so a
+//   stale firmware layout or a torn write reads as "no profile"
+// - The active site ID is kept in the same namespace
+//
+// Plain NVS calls: use from the housekeeping task, not the control loop.
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Store configuration
+#define CALIBRATION_NVS_NAMESPACE       "trolley_cal"   // NVS namespace
+#define CALIBRATION_ACTIVE_SITE_KEY     "_active"       // String key: selected site ID
+#define CALIBRATION_DEFAULT_SITE        "default"       // Site used until one is selected
+#define CALIBRATION_SITE_ID_MAX         15              // NVS key length limit
+#define CALIBRATION_MAGIC               0x4C414354      // "TCAL"
+#define CALIBRATION_VERSION             2               // Stored blob layout version (2: coast models)
+
+// First-run verification
+#define CALIBRATION_VERIFY_TOLERANCE_PERCENT  5.0f      // Allowed wire length disagreement
+
+// Profile contents
+typedef struct {
+    bool wire_valid;                   // wire_learning holds a complete result
+    bool coasting_valid;               // coasting holds a calibrated result
+    wire_learning_results_t wire_learning;
+    coasting_data_t coasting;
+    uint32_t save_count;               // Times this site's profile was written
+} calibration_profile_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PROFILE API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Check a site ID (letters, digits, '-', '_'; must not start with '_')
+ * @param site_id Site ID
+ * @return true if usable as a profile key
+ */
+bool calibration_store_is_valid_site_id(const char* site_id);
+
+/**
+ * @brief Load a site's profile
+ * @param site_id Site ID
+ * @param profile Output profile
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if none stored, ESP_ERR_INVALID_VERSION on
+ *         a foreign layout, ESP_ERR_INVALID_CRC on a corrupt blob
+ */
+esp_err_t calibration_store_load(const char* site_id, calibration_profile_t* profile);
+
+/**
+ * @brief Write a site's profile (save_count is incremented by the store)
+ * @param site_id Site ID
+ * @param profile Profile to store
+ * @return ESP_OK on success, NVS error otherwise
+ */
+esp_err_t calibration_store_save(const char* site_id, const calibration_profile_t* profile);
+
+/**
+ * @brief Delete a site's profile
+ * @param site_id Site ID
+ * @return ESP_OK (also if nothing was stored)
+ */
+esp_err_t calibration_store_erase(const char* site_id);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// ACTIVE SITE API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Read the selected site ID
+ * @param site_id Output buffer (CALIBRATION_SITE_ID_MAX + 1 bytes)
+ * @param size Buffer size
+ * @return ESP_OK; CALIBRATION_DEFAULT_SITE is returned if none was selected
+ */
+esp_err_t calibration_store_get_active_site(char* site_id, size_t size);
+
+/**
+ * @brief Remember the selected site ID across reboots
+ * @param site_id Site ID
+ * @return ESP_OK, ESP_ERR_INVALID_ARG if the ID is not valid
+ */
+esp_err_t calibration_store_set_active_site(const char* site_id);
+
+#endif // CALIBRATION_STORE_H
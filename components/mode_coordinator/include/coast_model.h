@@ -0,0 +1,137 @@
+// components/mode_coordinator/include/coast_model.h
+#ifndef COAST_MODEL_H
+#define COAST_MODEL_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// COAST_MODEL.H - SPEED-DEPENDENT COASTING DECELERATION, REFIT EVERY COAST
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Predict how far and how long the trolley rolls
+// - Motor-off deceleration modelled as a + b·v² (rolling resistance plus
+//   aerodynamic/wire drag); closed-form stop distance, stop time and
+//   speed/distance at any time into a coast
+// - coast_fit_*: least-squares refit from the speed trace of one coasting
+//   phase (running sums, no sample storage), blended into the stored model
+//   so every coast tightens the next prediction and slow drift (temperature,
+//   sag, load) is followed
+// - One model per direction; stored with the site's calibration profile
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Fit configuration
+#define COAST_FIT_SAMPLE_MS             100         // Speed trace decimation
+#define COAST_FIT_MIN_SPEED_MS          0.15f       // Ignore the noisy crawl before the stop
+#define COAST_FIT_MIN_SAMPLES           8           // Decel samples needed for a refit
+#define COAST_FIT_MIN_SPEED2_SPREAD     0.5f        // v² variance (m²/s⁴) needed to fit b
+#define COAST_MODEL_MIN_DECEL_MS2       0.02f       // Smaller a is rejected as a bad fit
+#define COAST_MODEL_MAX_DECEL_MS2       5.0f        // Larger a is rejected as a bad fit
+#define COAST_MODEL_MIN_DRAG_PER_M      1e-5f       // Below this b is treated as zero
+#define COAST_MODEL_MIN_GAIN            0.25f       // Weight of a new fit once the model has history
+
+// Per-direction coasting model: decel(v) = base_decel_ms2 + drag_per_m · v²
+typedef struct {
+    bool valid;
+    float base_decel_ms2;              // a (m/s²)
+    float drag_per_m;                  // b (1/m)
+    float residual_ms2;                // RMS decel residual of the last refit
+    uint16_t fits;                     // Coasting phases folded in
+} coast_model_t;
+
+// Running fit over one coasting phase
+typedef struct {
+    bool active;
+    float last_speed_ms;
+    uint64_t last_time_us;
+    uint32_t samples;
+    float sum_x;                       // x = v² at the interval midpoint
+    float sum_y;                       // y = measured deceleration
+    float sum_xx;
+    float sum_xy;
+    float sum_yy;
+} coast_fit_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PREDICTION API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Model with constant deceleration (seed from a single calibration)
+ * @param decel_ms2 Deceleration
+ * @return Model (invalid if decel_ms2 out of range)
+ */
+coast_model_t coast_model_constant(float decel_ms2);
+
+/**
+ * @brief Deceleration at a speed
+ * @param model Model
+ * @param speed_ms Speed
+ * @return Deceleration in m/s² (positive)
+ */
+float coast_model_decel(const coast_model_t* model, float speed_ms);
+
+/**
+ * @brief Distance to coast to a stop
+ * @param model Model
+ * @param speed_ms Speed at motor cut-off
+ * @return Distance in meters
+ */
+float coast_model_stop_distance(const coast_model_t* model, float speed_ms);
+
+/**
+ * @brief Time to coast to a stop
+ * @param model Model
+ * @param speed_ms Speed at motor cut-off
+ * @return Time in seconds
+ */
+float coast_model_stop_time(const coast_model_t* model, float speed_ms);
+
+/**
+ * @brief Evaluate a coast
+ * @param model Model
+ * @param start_speed_ms Speed at motor cut-off
+ * @param time_s Time since cut-off
+ * @param distance_m Output distance since cut-off (may be NULL)
+ * @param speed_ms Output speed (may be NULL)
+ */
+void coast_model_sample(const coast_model_t* model, float start_speed_ms, float time_s,
+                        float* distance_m, float* speed_ms);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FIT API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Start collecting a coasting phase
+ * @param fit Fit state
+ * @param speed_ms Speed at motor cut-off
+ * @param time_us Timestamp
+ */
+void coast_fit_begin(coast_fit_t* fit, float speed_ms, uint64_t time_us);
+
+/**
+ * @brief Add a speed sample (decimated to COAST_FIT_SAMPLE_MS internally)
+ * @param fit Fit state
+ * @param speed_ms Estimated speed
+ * @param time_us Timestamp
+ */
+void coast_fit_sample(coast_fit_t* fit, float speed_ms, uint64_t time_us);
+
+/**
+ * @brief Refit from the collected coast and blend into a model
+ * @param fit Fit state (ended by this call)
+ * @param model Model to update
+ * @return ESP_OK, ESP_ERR_INVALID_SIZE if too few samples, ESP_ERR_INVALID_RESPONSE
+ *         if the fit is implausible (model unchanged)
+ */
+esp_err_t coast_fit_finish(coast_fit_t* fit, coast_model_t* model);
+
+/**
+ * @brief Discard a coasting phase (motor came back on, emergency)
+ * @param fit Fit state
+ */
+void coast_fit_abort(coast_fit_t* fit);
+
+#endif // COAST_MODEL_H
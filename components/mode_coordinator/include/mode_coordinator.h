@@ -2,6 +2,8 @@
 #define MODE_COORDINATOR_H
 
 #include "esp_err.h"
+#include "coast_model.h"
+#include "status_text.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -26,6 +28,7 @@ typedef enum {
     MODE_BLOCKED_SENSORS_NOT_VALIDATED = 0,  // Sensors require validation
     MODE_BLOCKED_WIRE_LEARNING_REQUIRED,     // Wire learning must be completed first
     MODE_BLOCKED_SYSTEM_ERROR,               // System error blocking mode
+    MODE_BLOCKED_PROFILE_LOADING,            // Site change: stored profile still being read
     MODE_AVAILABLE,                          // Mode ready for activation
     MODE_ACTIVE,                             // Mode currently running
     MODE_STOPPING                            // Mode in process of stopping
@@ -43,6 +46,17 @@ typedef enum {
     SENSOR_VALIDATION_FAILED             // Validation failed
 } sensor_validation_state_t;
 
+/**
+ * @brief Stored calibration profile state (see calibration_store.h)
+ */
+typedef enum {
+    CALIBRATION_PROFILE_NONE = 0,        // No stored profile, wire learning required
+    CALIBRATION_PROFILE_UNVERIFIED,      // Loaded from NVS, first automatic run checks it
+    CALIBRATION_PROFILE_VERIFIED,        // Measured this boot or confirmed by a run
+    CALIBRATION_PROFILE_REJECTED,        // First run disagreed, profile erased
+    CALIBRATION_PROFILE_LOADING          // Site selected, housekeeping reading its profile
+} calibration_profile_state_t;
+
 /**
  * @brief Coasting data for automatic mode
  */
@@ -52,6 +66,8 @@ typedef struct {
     float coast_start_distance_m;       // Distance from wire end to start coasting
     uint32_t coast_time_ms;             // Time taken to coast to stop
     float decel_rate_ms2;               // Measured deceleration rate
+    coast_model_t model_forward;        // a + b·v² model, refit after every forward coast
+    coast_model_t model_reverse;        // a + b·v² model, refit after every reverse coast
 } coasting_data_t;
 
 /**
@@ -85,15 +101,19 @@ typedef struct {
     float wire_length_m;
     coasting_data_t coasting_data;
     
+    // Stored calibration
+    calibration_profile_state_t calibration_state;
+    char calibration_site_id[16];
+    
     // Automatic mode data
     uint32_t auto_cycle_count;
     bool auto_cycle_interrupted;
     bool auto_coasting_calibrated;
     
     // Status messages
-    char current_mode_status[128];
-    char sensor_validation_message[128];
-    char error_message[128];
+    status_text_t current_mode_text;
+    status_text_t sensor_validation_text;
+    status_text_t error_text;
     
     // System health
     bool system_healthy;
@@ -117,6 +137,12 @@ esp_err_t mode_coordinator_init(void);
  */
 system_mode_status_t mode_coordinator_get_status(void);
 
+/**
+ * @brief Get change counter for system mode status
+ * @return Value that changes whenever mode_coordinator_update() publishes a changed status
+ */
+uint32_t mode_coordinator_get_status_generation(void);
+
 /**
  * @brief Get current active mode
  * @return Current trolley operation mode
@@ -131,11 +157,21 @@ trolley_operation_mode_t mode_coordinator_get_current_mode(void);
 bool mode_coordinator_is_mode_available(trolley_operation_mode_t mode);
 
 /**
- * @brief Update mode coordinator (call regularly from main loop)
+ * @brief Update mode coordinator (control loop stage, CONTROL_LOOP_COORDINATOR_RATE_HZ)
+ * 
+ * Runs on the same task as the mode updates, so mode state is never read
+ * mid-transition. Flash work is only handed off; see mode_coordinator_service_flash().
  * @return ESP_OK on success, error code on system issues
  */
 esp_err_t mode_coordinator_update(void);
 
+/**
+ * @brief Write or erase pending calibration profiles, read a selected site's
+ *        profile and do wire map steps (housekeeping task)
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE before init
+ */
+esp_err_t mode_coordinator_service_flash(void);
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // SENSOR VALIDATION API
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -247,6 +283,50 @@ esp_err_t mode_coordinator_set_coasting_data(const coasting_data_t* coasting_dat
  */
 const coasting_data_t* mode_coordinator_get_coasting_data(void);
 
+// ═══════════════════════════════════════════════════════════════════════════════
+// CALIBRATION PROFILE MANAGEMENT
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Switch to another wire/site and load its stored profile
+ * @param site_id Site ID (letters, digits, '-', '_', up to CALIBRATION_SITE_ID_MAX)
+ * @return ESP_OK (also when the site has no profile yet), ESP_ERR_INVALID_ARG,
+ *         ESP_ERR_INVALID_STATE while a mode is active or another site is loading
+ * @note Control loop (MODE_CMD_SELECT_SITE): the profile reads as LOADING until
+ *       mode_coordinator_service_flash() has read it, after any save or erase
+ *       still due for the previous site; wire learning and automatic wait for it
+ */
+esp_err_t mode_coordinator_select_site(const char* site_id);
+
+/**
+ * @brief Get the active site ID
+ * @return Site ID string
+ */
+const char* mode_coordinator_get_site_id(void);
+
+/**
+ * @brief Get the state of the active calibration profile
+ * @return Profile state
+ */
+calibration_profile_state_t mode_coordinator_get_calibration_state(void);
+
+/**
+ * @brief Check a loaded profile against a measured end-to-end run
+ * @param measured_length_m Distance of one full wire-end to wire-end run
+ * @return ESP_OK if verified (or nothing to verify), ESP_ERR_INVALID_RESPONSE if
+ *         the length disagrees: the profile is then erased and wire learning required
+ * @note Called by automatic_mode at each wire end; only the first check after a
+ *       warm start does any work
+ */
+esp_err_t mode_coordinator_verify_calibration(float measured_length_m);
+
+/**
+ * @brief Forget wire learning and coasting results for the active site (RAM and NVS)
+ * @return ESP_OK on success
+ * @note RAM is cleared at once; the NVS erase is left to mode_coordinator_service_flash()
+ */
+esp_err_t mode_coordinator_clear_calibration(void);
+
 /**
  * @brief Update automatic mode cycle count
  * @param cycle_count Current cycle count
@@ -267,10 +347,10 @@ esp_err_t mode_coordinator_set_auto_interrupted(bool interrupted);
 
 /**
  * @brief Report system error to mode coordinator
- * @param error_message Error description
- * @return ESP_OK on success
+ * @param error Error code (status_text_to_string() gives the text)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for STATUS_TEXT_NONE
  */
-esp_err_t mode_coordinator_report_error(const char* error_message);
+esp_err_t mode_coordinator_report_error(status_text_t error);
 
 /**
  * @brief Check if system is healthy for mode operation
@@ -321,6 +401,13 @@ const char* mode_coordinator_availability_to_string(mode_availability_t availabi
  */
 const char* mode_coordinator_validation_to_string(sensor_validation_state_t state);
 
+/**
+ * @brief Convert calibration profile state to string
+ * @param state Profile state
+ * @return String representation of profile state
+ */
+const char* mode_coordinator_calibration_to_string(calibration_profile_state_t state);
+
 /**
  * @brief Get detailed system status for debugging
  * @param status_buffer Buffer to write status string
@@ -0,0 +1,176 @@
+// components/mode_coordinator/src/calibration_store.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// CALIBRATION_STORE.CPP - VERSIONED, CRC-CHECKED PROFILE BLOBS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "calibration_store.h"
+#include "nvs.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include <cstring>
+#include <cstddef>
+
+static const char* TAG = "CAL_STORE";
+
+// Stored blob (the CRC covers everything before it)
+typedef struct {
+    uint32_t magic;                    // CALIBRATION_MAGIC
+    uint16_t version;                  // CALIBRATION_VERSION
+    uint8_t wire_size;                 // sizeof(wire_learning_results_t) when written
+    uint8_t coasting_size;             // sizeof(coasting_data_t) when written
+    char site_id[CALIBRATION_SITE_ID_MAX + 1];
+    uint32_t save_count;
+    uint8_t wire_valid;
+    uint8_t coasting_valid;
+    uint8_t reserved[2];
+    wire_learning_results_t wire_learning;
+    coasting_data_t coasting;
+    uint32_t crc32;
+} calibration_blob_t;
+
+static_assert(sizeof(wire_learning_results_t) <= UINT8_MAX, "wire_size field too small");
+static_assert(sizeof(coasting_data_t) <= UINT8_MAX, "coasting_size field too small");
+
+static uint32_t blob_crc(const calibration_blob_t* blob) {
+    return esp_rom_crc32_le(0, (const uint8_t*)blob, offsetof(calibration_blob_t, crc32));
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PROFILE API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+bool calibration_store_is_valid_site_id(const char* site_id) {
+    if (site_id == NULL || site_id[0] == '\0' || site_id[0] == '_') return false;
+
+    size_t length = 0;
+    for (const char* c = site_id; *c != '\0'; c++, length++) {
+        bool ok = (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') ||
+                  (*c >= '0' && *c <= '9') || *c == '-' || *c == '_';
+        if (!ok || length >= CALIBRATION_SITE_ID_MAX) return false;
+    }
+    return true;
+}
+
+esp_err_t calibration_store_load(const char* site_id, calibration_profile_t* profile) {
+    if (profile == NULL || !calibration_store_is_valid_site_id(site_id)) return ESP_ERR_INVALID_ARG;
+    memset(profile, 0, sizeof(*profile));
+
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(CALIBRATION_NVS_NAMESPACE, NVS_READONLY, &handle);
+    if (ret != ESP_OK) return ESP_ERR_NOT_FOUND;   // Namespace not created yet
+
+    static calibration_blob_t blob;
+    size_t size = sizeof(blob);
+    ret = nvs_get_blob(handle, site_id, &blob, &size);
+    nvs_close(handle);
+    if (ret == ESP_ERR_NVS_NOT_FOUND) return ESP_ERR_NOT_FOUND;
+    if (ret != ESP_OK && ret != ESP_ERR_NVS_INVALID_LENGTH) return ret;
+
+    if (ret == ESP_ERR_NVS_INVALID_LENGTH || size != sizeof(blob) ||
+        blob.magic != CALIBRATION_MAGIC || blob.version != CALIBRATION_VERSION ||
+        blob.wire_size != sizeof(blob.wire_learning) || blob.coasting_size != sizeof(blob.coasting)) {
+        ESP_LOGW(TAG, "Profile '%s' has a foreign layout (%u bytes) - ignoring",
+                 site_id, (unsigned)size);
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    if (blob.crc32 != blob_crc(&blob) ||
+        strncmp(blob.site_id, site_id, sizeof(blob.site_id)) != 0) {
+        ESP_LOGW(TAG, "Profile '%s' failed CRC check - ignoring", site_id);
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    profile->wire_valid = blob.wire_valid;
+    profile->coasting_valid = blob.coasting_valid;
+    profile->wire_learning = blob.wire_learning;
+    profile->coasting = blob.coasting;
+    profile->save_count = blob.save_count;
+    return ESP_OK;
+}
+
+esp_err_t calibration_store_save(const char* site_id, const calibration_profile_t* profile) {
+    if (profile == NULL || !calibration_store_is_valid_site_id(site_id)) return ESP_ERR_INVALID_ARG;
+
+    static calibration_blob_t blob;
+    memset(&blob, 0, sizeof(blob));
+    blob.magic = CALIBRATION_MAGIC;
+    blob.version = CALIBRATION_VERSION;
+    blob.wire_size = sizeof(blob.wire_learning);
+    blob.coasting_size = sizeof(blob.coasting);
+    strncpy(blob.site_id, site_id, sizeof(blob.site_id) - 1);
+    blob.save_count = profile->save_count + 1;
+    blob.wire_valid = profile->wire_valid;
+    blob.coasting_valid = profile->coasting_valid;
+    blob.wire_learning = profile->wire_learning;
+    blob.coasting = profile->coasting;
+    blob.crc32 = blob_crc(&blob);
+
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(CALIBRATION_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (ret != ESP_OK) return ret;
+
+    ret = nvs_set_blob(handle, site_id, &blob, sizeof(blob));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    }
+    nvs_close(handle);
+
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "Profile '%s' saved (write #%lu)", site_id, (unsigned long)blob.save_count);
+    }
+    return ret;
+}
+
+esp_err_t calibration_store_erase(const char* site_id) {
+    if (!calibration_store_is_valid_site_id(site_id)) return ESP_ERR_INVALID_ARG;
+
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(CALIBRATION_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (ret != ESP_OK) return ret;
+
+    ret = nvs_erase_key(handle, site_id);
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    } else if (ret == ESP_ERR_NVS_NOT_FOUND) {
+        ret = ESP_OK;
+    }
+    nvs_close(handle);
+    return ret;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// ACTIVE SITE API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t calibration_store_get_active_site(char* site_id, size_t size) {
+    if (site_id == NULL || size < CALIBRATION_SITE_ID_MAX + 1) return ESP_ERR_INVALID_ARG;
+
+    nvs_handle_t handle;
+    if (nvs_open(CALIBRATION_NVS_NAMESPACE, NVS_READONLY, &handle) == ESP_OK) {
+        size_t length = size;
+        esp_err_t ret = nvs_get_str(handle, CALIBRATION_ACTIVE_SITE_KEY, site_id, &length);
+        nvs_close(handle);
+        if (ret == ESP_OK && calibration_store_is_valid_site_id(site_id)) {
+            return ESP_OK;
+        }
+    }
+
+    strncpy(site_id, CALIBRATION_DEFAULT_SITE, size - 1);
+    site_id[size - 1] = '\0';
+    return ESP_OK;
+}
+
+esp_err_t calibration_store_set_active_site(const char* site_id) {
+    if (!calibration_store_is_valid_site_id(site_id)) return ESP_ERR_INVALID_ARG;
+
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(CALIBRATION_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (ret != ESP_OK) return ret;
+
+    ret = nvs_set_str(handle, CALIBRATION_ACTIVE_SITE_KEY, site_id);
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return ret;
+}
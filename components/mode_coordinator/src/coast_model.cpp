@@ -0,0 +1,165 @@
+// components/mode_coordinator/src/coast_model.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// COAST_MODEL.CPP - a + b·v² COASTING MODEL AND ONLINE REFIT
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// With k = sqrt(a·b) and θ0 = atan(v0·sqrt(b/a)), dv/dt = -(a + b·v²) gives
+//   v(t) = sqrt(a/b)·tan(θ0 - k·t)
+//   x(t) = ln(cos(θ0 - k·t) / cos θ0) / b
+//   stop time θ0 / k, stop distance ln(1 + b·v0²/a) / (2b)
+// and reduces to the constant-deceleration formulas as b → 0.
+
+#include "coast_model.h"
+#include <cmath>
+#include <cstring>
+
+static bool has_drag(const coast_model_t* model) {
+    return model->drag_per_m >= COAST_MODEL_MIN_DRAG_PER_M;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PREDICTION API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+coast_model_t coast_model_constant(float decel_ms2) {
+    coast_model_t model = {};
+    if (decel_ms2 >= COAST_MODEL_MIN_DECEL_MS2 && decel_ms2 <= COAST_MODEL_MAX_DECEL_MS2) {
+        model.valid = true;
+        model.base_decel_ms2 = decel_ms2;
+        model.fits = 1;
+    }
+    return model;
+}
+
+float coast_model_decel(const coast_model_t* model, float speed_ms) {
+    if (model == NULL || !model->valid) return 0.0f;
+    return model->base_decel_ms2 + model->drag_per_m * speed_ms * speed_ms;
+}
+
+float coast_model_stop_distance(const coast_model_t* model, float speed_ms) {
+    if (model == NULL || !model->valid || speed_ms <= 0.0f) return 0.0f;
+    float a = model->base_decel_ms2;
+    if (!has_drag(model)) {
+        return speed_ms * speed_ms / (2.0f * a);
+    }
+    float b = model->drag_per_m;
+    return log1pf(b * speed_ms * speed_ms / a) / (2.0f * b);
+}
+
+float coast_model_stop_time(const coast_model_t* model, float speed_ms) {
+    if (model == NULL || !model->valid || speed_ms <= 0.0f) return 0.0f;
+    float a = model->base_decel_ms2;
+    if (!has_drag(model)) {
+        return speed_ms / a;
+    }
+    float b = model->drag_per_m;
+    return atanf(speed_ms * sqrtf(b / a)) / sqrtf(a * b);
+}
+
+void coast_model_sample(const coast_model_t* model, float start_speed_ms, float time_s,
+                        float* distance_m, float* speed_ms) {
+    float x = 0.0f;
+    float v = 0.0f;
+
+    if (model != NULL && model->valid && start_speed_ms > 0.0f) {
+        float t = fminf(fmaxf(time_s, 0.0f), coast_model_stop_time(model, start_speed_ms));
+        float a = model->base_decel_ms2;
+
+        if (!has_drag(model)) {
+            v = start_speed_ms - a * t;
+            x = start_speed_ms * t - 0.5f * a * t * t;
+        } else {
+            float b = model->drag_per_m;
+            float theta0 = atanf(start_speed_ms * sqrtf(b / a));
+            float theta = fmaxf(theta0 - sqrtf(a * b) * t, 0.0f);
+            v = sqrtf(a / b) * tanf(theta);
+            x = logf(cosf(theta) / cosf(theta0)) / b;
+        }
+    }
+
+    if (distance_m != NULL) *distance_m = fmaxf(x, 0.0f);
+    if (speed_ms != NULL) *speed_ms = fmaxf(v, 0.0f);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FIT API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void coast_fit_begin(coast_fit_t* fit, float speed_ms, uint64_t time_us) {
+    if (fit == NULL) return;
+    memset(fit, 0, sizeof(*fit));
+    fit->active = true;
+    fit->last_speed_ms = speed_ms;
+    fit->last_time_us = time_us;
+}
+
+void coast_fit_sample(coast_fit_t* fit, float speed_ms, uint64_t time_us) {
+    if (fit == NULL || !fit->active) return;
+
+    uint64_t dt_us = time_us - fit->last_time_us;
+    if (dt_us < COAST_FIT_SAMPLE_MS * 1000ULL) return;
+
+    float v0 = fit->last_speed_ms;
+    fit->last_speed_ms = speed_ms;
+    fit->last_time_us = time_us;
+    if (v0 < COAST_FIT_MIN_SPEED_MS || speed_ms < COAST_FIT_MIN_SPEED_MS) return;
+
+    // Deceleration over the interval against v² at its midpoint
+    float mid = 0.5f * (v0 + speed_ms);
+    float x = mid * mid;
+    float y = (v0 - speed_ms) / (dt_us / 1000000.0f);
+    if (fabsf(y) > COAST_MODEL_MAX_DECEL_MS2) return;  // Impact or speed glitch, not coasting
+
+    fit->samples++;
+    fit->sum_x += x;
+    fit->sum_y += y;
+    fit->sum_xx += x * x;
+    fit->sum_xy += x * y;
+    fit->sum_yy += y * y;
+}
+
+esp_err_t coast_fit_finish(coast_fit_t* fit, coast_model_t* model) {
+    if (fit == NULL || model == NULL) return ESP_ERR_INVALID_ARG;
+    if (!fit->active) return ESP_ERR_INVALID_STATE;
+    fit->active = false;
+    if (fit->samples < COAST_FIT_MIN_SAMPLES) return ESP_ERR_INVALID_SIZE;
+
+    float n = (float)fit->samples;
+    float mean_x = fit->sum_x / n;
+    float mean_y = fit->sum_y / n;
+    float var_x = fit->sum_xx / n - mean_x * mean_x;
+    float cov_xy = fit->sum_xy / n - mean_x * mean_y;
+
+    // A slow coast barely spans v²: refit a only and keep the known drag
+    float b = model->valid ? model->drag_per_m : 0.0f;
+    if (var_x >= COAST_FIT_MIN_SPEED2_SPREAD) {
+        b = fmaxf(cov_xy / var_x, 0.0f);
+    }
+    float a = mean_y - b * mean_x;
+    if (a < COAST_MODEL_MIN_DECEL_MS2 || a > COAST_MODEL_MAX_DECEL_MS2) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    float sse = fit->sum_yy - 2.0f * a * fit->sum_y - 2.0f * b * fit->sum_xy +
+                n * a * a + 2.0f * a * b * fit->sum_x + b * b * fit->sum_xx;
+    float residual = sqrtf(fmaxf(sse, 0.0f) / n);
+
+    if (!model->valid) {
+        model->valid = true;
+        model->base_decel_ms2 = a;
+        model->drag_per_m = b;
+        model->fits = 1;
+    } else {
+        // Average while the history is short, then track drift
+        float gain = fmaxf(1.0f / (model->fits + 1), COAST_MODEL_MIN_GAIN);
+        model->base_decel_ms2 += gain * (a - model->base_decel_ms2);
+        model->drag_per_m += gain * (b - model->drag_per_m);
+        if (model->fits < UINT16_MAX) model->fits++;
+    }
+    model->residual_ms2 = residual;
+    return ESP_OK;
+}
+
+void coast_fit_abort(coast_fit_t* fit) {
+    if (fit != NULL) fit->active = false;
+}
@@ -1,17 +1,109 @@
 // components/mode_coordinator/src/mode_coordinator.cpp - SIMPLIFIED BUT COMPLETE
 #include "mode_coordinator.h"
 #include "hardware_control.h"
+#include "hal_clock.h"
 #include "sensor_health.h"
 #include "wire_learning_mode.h"
 #include "automatic_mode.h"
 #include "manual_mode.h"
+#include "status_snapshot.h"
+#include "flight_recorder.h"
+#include "calibration_store.h"
+#include "wire_map.h"
+#include "wire_end_detector.h"
+#include "deferred_log.h"
 #include "esp_log.h"
-#include "esp_timer.h"
+#include <atomic>
 #include <cstring>
 #include <cmath>
 
 static const char* TAG = "MODE_COORDINATOR";
 
+// Defined with the calibration profile section below
+static void request_calibration_save(void);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// GLOBAL STATE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static system_mode_status_t g_mode_status = {
+    .current_mode = TROLLEY_MODE_NONE,
+    .previous_mode = TROLLEY_MODE_NONE,
+    .mode_start_time = 0,
+    .wire_learning_availability = MODE_BLOCKED_SENSORS_NOT_VALIDATED,
+    .automatic_availability = MODE_BLOCKED_SENSORS_NOT_VALIDATED, 
+    .manual_availability = MODE_BLOCKED_SENSORS_NOT_VALIDATED,
+    .sensor_validation_state = SENSOR_VALIDATION_NOT_STARTED,
+    .sensors_validated = false,
+    .hall_validation_complete = false,
+    .accel_validation_complete = false,
+    .wire_learning_complete = false,
+    .wire_length_m = 0.0f,
+    .coasting_data = {},
+    .calibration_state = CALIBRATION_PROFILE_NONE,
+    .calibration_site_id = {},
+    .auto_cycle_count = 0,
+    .auto_cycle_interrupted = false,
+    .auto_coasting_calibrated = false,
+    .current_mode_text = STATUS_TEXT_NONE,
+    .sensor_validation_text = STATUS_TEXT_NONE,
+    .error_text = STATUS_TEXT_NONE,
+    .system_healthy = true,
+    .error_count = 0,
+    .last_error_time = 0
+};
+
+// Published copy for other tasks (web, heartbeat), republished only on change
+static system_mode_status_t g_published_status = {};
+static status_snapshot<system_mode_status_t> g_status_snapshot;
+
+static bool g_coordinator_initialized = false;
+static wire_learning_results_t g_wire_learning_data = {};
+static coasting_data_t g_coasting_data = {};
+
+// Calibration profile (persisted per site by calibration_store)
+static char g_site_id[CALIBRATION_SITE_ID_MAX + 1] = CALIBRATION_DEFAULT_SITE;
+static std::atomic<uint32_t> g_profile_save_count{0};
+static bool g_calibration_save_pending = false;
+
+// Flash work handed to housekeeping (mode_coordinator_service_flash, core 0):
+// the control loop fills g_save_profile and publishes it with g_save_ready
+static calibration_profile_t g_save_profile;
+static std::atomic<bool> g_save_ready{false};
+static std::atomic<bool> g_erase_pending{false};  // Stored profile cleared or rejected, NVS erase due
+static std::atomic<bool> g_flash_window{false};   // Idle and stationary (wire map flash work)
+
+// Site change: the control loop requests it, housekeeping reads the profile
+// into g_load_profile, the control loop applies it
+typedef enum : uint8_t {
+    SITE_LOAD_IDLE = 0,
+    SITE_LOAD_REQUESTED,                           // g_requested_site set, waiting for housekeeping
+    SITE_LOAD_READY                                // g_load_profile read, waiting for the control loop
+} site_load_state_t;
+
+static char g_requested_site[CALIBRATION_SITE_ID_MAX + 1] = "";
+static calibration_profile_t g_load_profile;
+static bool g_load_profile_valid = false;         // g_load_profile passed the learning range checks
+static std::atomic<uint8_t> g_site_load{SITE_LOAD_IDLE};
+
+// Sensor validation tracking
+static uint64_t g_sensor_validation_start_time = 0;
+static bool g_hall_validation_user_confirmed = false;
+static bool g_accel_validation_user_confirmed = false;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// INITIALIZATION HELPER
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void init_wire_learning_data(void) {
+    memset(&g_wire_learning_data, 0, sizeof(g_wire_learning_data));
+}
+
+static void init_coasting_data(void) {
+    memset(&g_coasting_data, 0, sizeof(g_coasting_data));
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
 // MODE DATA MANAGEMENT IMPLEMENTATION
 // ═══════════════════════════════════════════════════════════════════════════════
 
@@ -24,6 +116,12 @@ esp_err_t mode_coordinator_set_wire_learning_results(const wire_learning_results
     g_mode_status.wire_learning_complete = results->complete;
     g_mode_status.wire_length_m = results->wire_length_m;
     
+    // A fresh measurement needs no verification run
+    if (results->complete) {
+        g_mode_status.calibration_state = CALIBRATION_PROFILE_VERIFIED;
+        request_calibration_save();
+    }
+    
     ESP_LOGI(TAG, "Wire learning results set: %.2f m wire length", results->wire_length_m);
     return ESP_OK;
 }
@@ -43,8 +141,14 @@ esp_err_t mode_coordinator_set_coasting_data(const coasting_data_t* coasting_dat
     g_mode_status.coasting_data.coast_start_distance_m = coasting_data->coast_start_distance_m;
     g_mode_status.coasting_data.coast_time_ms = coasting_data->coast_time_ms;
     g_mode_status.coasting_data.decel_rate_ms2 = coasting_data->decel_rate_ms2;
+    g_mode_status.coasting_data.model_forward = coasting_data->model_forward;
+    g_mode_status.coasting_data.model_reverse = coasting_data->model_reverse;
+    
+    if (coasting_data->calibrated) {
+        request_calibration_save();
+    }
     
-    ESP_LOGI(TAG, "Coasting data set: %.2f m coasting distance", coasting_data->coasting_distance_m);
+    deferred_log(DLOG_MSG_COORD_COASTING_SET, coasting_data->coasting_distance_m);
     return ESP_OK;
 }
 
@@ -66,16 +170,16 @@ esp_err_t mode_coordinator_set_auto_interrupted(bool interrupted) {
 // ERROR HANDLING AND SAFETY IMPLEMENTATION
 // ═══════════════════════════════════════════════════════════════════════════════
 
-esp_err_t mode_coordinator_report_error(const char* error_message) {
-    if (error_message == NULL) return ESP_ERR_INVALID_ARG;
+esp_err_t mode_coordinator_report_error(status_text_t error) {
+    if (error == STATUS_TEXT_NONE || error >= STATUS_TEXT_COUNT) return ESP_ERR_INVALID_ARG;
     
     g_mode_status.error_count++;
-    g_mode_status.last_error_time = esp_timer_get_time();
+    g_mode_status.last_error_time = hal_clock_now_us();
     
-    strncpy(g_mode_status.error_message, error_message, sizeof(g_mode_status.error_message) - 1);
-    g_mode_status.error_message[sizeof(g_mode_status.error_message) - 1] = '\0';
+    g_mode_status.error_text = error;
     
-    ESP_LOGW(TAG, "System error reported: %s (count: %lu)", error_message, g_mode_status.error_count);
+    deferred_log(DLOG_MSG_COORD_ERROR, status_text_to_string(error), (unsigned long)g_mode_status.error_count);
+    flight_recorder_trigger(FLIGHT_TRIGGER_MODE_ERROR);
     
     return ESP_OK;
 }
@@ -85,12 +189,12 @@ bool mode_coordinator_is_system_healthy(void) {
 }
 
 const char* mode_coordinator_get_error_message(void) {
-    return g_mode_status.error_message;
+    return status_text_to_string(g_mode_status.error_text);
 }
 
 esp_err_t mode_coordinator_clear_error(void) {
     g_mode_status.error_count = 0;
-    strcpy(g_mode_status.error_message, "");
+    g_mode_status.error_text = STATUS_TEXT_NONE;
     g_mode_status.system_healthy = true;
     
     ESP_LOGI(TAG, "Error condition cleared");
@@ -142,6 +246,7 @@ const char* mode_coordinator_availability_to_string(mode_availability_t availabi
         case MODE_BLOCKED_SENSORS_NOT_VALIDATED: return "Sensors not validated";
         case MODE_BLOCKED_WIRE_LEARNING_REQUIRED: return "Wire learning required";
         case MODE_BLOCKED_SYSTEM_ERROR: return "System error";
+        case MODE_BLOCKED_PROFILE_LOADING: return "Calibration loading";
         case MODE_AVAILABLE: return "Available";
         case MODE_ACTIVE: return "Active";
         case MODE_STOPPING: return "Stopping";
@@ -161,9 +266,24 @@ const char* mode_coordinator_validation_to_string(sensor_validation_state_t stat
     }
 }
 
+const char* mode_coordinator_calibration_to_string(calibration_profile_state_t state) {
+    switch (state) {
+        case CALIBRATION_PROFILE_NONE: return "None";
+        case CALIBRATION_PROFILE_UNVERIFIED: return "Stored, unverified";
+        case CALIBRATION_PROFILE_VERIFIED: return "Verified";
+        case CALIBRATION_PROFILE_REJECTED: return "Rejected";
+        case CALIBRATION_PROFILE_LOADING: return "Loading";
+        default: return "Unknown";
+    }
+}
+
 esp_err_t mode_coordinator_get_detailed_status(char* status_buffer, size_t buffer_size) {
     if (status_buffer == NULL) return ESP_ERR_INVALID_ARG;
     
+    wire_map_stats_t map_stats;
+    wire_map_get_stats(&map_stats);
+    wire_end_detector_stats_t end_stats = wire_end_detector_get_stats();
+    
     snprintf(status_buffer, buffer_size,
         "=== 3-MODE SYSTEM STATUS ===\n"
         "Current Mode: %s\n"
@@ -174,6 +294,10 @@ esp_err_t mode_coordinator_get_detailed_status(char* status_buffer, size_t buffe
         "System Health: %s\n"
         "Wire Length: %.2f m\n"
         "Coasting Distance: %.2f m\n"
+        "Coast Model: fwd %.3f + %.4f v^2 (%u fits), rev %.3f + %.4f v^2 (%u fits)\n"
+        "Wire Map: %s (%lu bins, %lu/%lu with residual, %lu slow-zone bins%s)\n"
+        "Wire End Detector: %lu events, %lu false positive, %lu false negative, last %s %lu ms late\n"
+        "Calibration: %s (site %s)\n"
         "Current Status: %s\n",
         mode_coordinator_mode_to_string(g_mode_status.current_mode),
         mode_coordinator_validation_to_string(g_mode_status.sensor_validation_state),
@@ -183,67 +307,186 @@ esp_err_t mode_coordinator_get_detailed_status(char* status_buffer, size_t buffe
         g_mode_status.system_healthy ? "Healthy" : "Error",
         g_wire_learning_data.wire_length_m,
         g_coasting_data.coasting_distance_m,
-        g_mode_status.current_mode_status);
+        g_coasting_data.model_forward.base_decel_ms2, g_coasting_data.model_forward.drag_per_m,
+        (unsigned)g_coasting_data.model_forward.fits,
+        g_coasting_data.model_reverse.base_decel_ms2, g_coasting_data.model_reverse.drag_per_m,
+        (unsigned)g_coasting_data.model_reverse.fits,
+        map_stats.valid ? "Valid" : (map_stats.learning ? "Learning" : "None"),
+        (unsigned long)map_stats.bin_count, (unsigned long)map_stats.known_bins_forward,
+        (unsigned long)map_stats.known_bins_reverse, (unsigned long)map_stats.slow_zone_bins,
+        map_stats.save_pending ? ", save pending" : "",
+        (unsigned long)end_stats.events, (unsigned long)end_stats.false_positives,
+        (unsigned long)end_stats.false_negatives,
+        end_stats.events ? wire_end_detector_source_to_string(end_stats.last_event.sources) : "-",
+        (unsigned long)end_stats.last_latency_ms,
+        mode_coordinator_calibration_to_string(g_mode_status.calibration_state),
+        g_mode_status.calibration_site_id,
+        status_text_to_string(g_mode_status.current_mode_text));
     
     return ESP_OK;
 }
-// GLOBAL STATE - FIXED INITIALIZATION
+// ═══════════════════════════════════════════════════════════════════════════════
+// CALIBRATION PROFILE HELPERS
 // ═══════════════════════════════════════════════════════════════════════════════
 
-static system_mode_status_t g_mode_status = {
-    .current_mode = TROLLEY_MODE_NONE,
-    .previous_mode = TROLLEY_MODE_NONE,
-    .mode_start_time = 0,
-    .wire_learning_availability = MODE_BLOCKED_SENSORS_NOT_VALIDATED,
-    .automatic_availability = MODE_BLOCKED_SENSORS_NOT_VALIDATED, 
-    .manual_availability = MODE_BLOCKED_SENSORS_NOT_VALIDATED,
-    .sensor_validation_state = SENSOR_VALIDATION_NOT_STARTED,
-    .sensors_validated = false,
-    .hall_validation_complete = false,
-    .accel_validation_complete = false,
-    .wire_learning = {false, 0.0f, 0.0f, 0.0f, 0, 0, 0},
-    .coasting_data = {false, 0.0f, 0.0f, 0, 0.0f},
-    .auto_cycle_count = 0,
-    .auto_cycle_interrupted = false,
-    .auto_coasting_calibrated = false,
-    .current_mode_status = {0},
-    .sensor_validation_message = {0},
-    .error_message = {0},
-    .system_healthy = true,
-    .error_count = 0,
-    .last_error_time = 0
-};
+static void request_calibration_save(void) {
+    g_calibration_save_pending = true;
+}
+
+/**
+ * @brief Drop the profile in RAM (flash copy kept)
+ */
+static void reset_calibration_profile(calibration_profile_state_t state) {
+    init_wire_learning_data();
+    init_coasting_data();
+    memset(&g_mode_status.coasting_data, 0, sizeof(g_mode_status.coasting_data));
+    g_mode_status.wire_learning_complete = false;
+    g_mode_status.wire_length_m = 0.0f;
+    g_mode_status.calibration_state = state;
+    g_profile_save_count = 0;
+    g_calibration_save_pending = false;
+}
+
+/**
+ * @brief Read g_site_id's profile and wire map from flash (housekeeping side, or init)
+ */
+static void read_calibration_profile(void) {
+    memset(&g_load_profile, 0, sizeof(g_load_profile));
+    g_load_profile_valid = false;
+
+    esp_err_t result = calibration_store_load(g_site_id, &g_load_profile);
+    if (result != ESP_OK) {
+        ESP_LOGI(TAG, "No usable calibration for site '%s' (%s) - wire learning required",
+                 g_site_id, esp_err_to_name(result));
+        memset(&g_load_profile, 0, sizeof(g_load_profile));
+        return;
+    }
 
-static bool g_coordinator_initialized = false;
-static wire_learning_results_t g_wire_learning_data = {false, 0.0f, 0.0f, 0.0f, 0, 0, 0};
-static coasting_data_t g_coasting_data = {false, 0.0f, 0.0f, 0, 0.0f};
+    // Range checks of the learning itself still apply to stored results
+    if (!g_load_profile.wire_valid || !wire_learning_validate_results(&g_load_profile.wire_learning)) {
+        ESP_LOGW(TAG, "Stored wire learning for site '%s' failed validation", g_site_id);
+        return;
+    }
+    g_load_profile_valid = true;
 
-// Sensor validation tracking
-static uint64_t g_sensor_validation_start_time = 0;
-static bool g_hall_validation_user_confirmed = false;
-static bool g_accel_validation_user_confirmed = false;
+    // Map of this wire (optional: automatic mode treats an unmapped wire as uniform)
+    if (wire_map_load(g_site_id, g_load_profile.wire_learning.wire_length_m) == ESP_ERR_INVALID_RESPONSE) {
+        wire_map_clear();
+    }
 
-// ═══════════════════════════════════════════════════════════════════════════════
-// INITIALIZATION HELPER
-// ═══════════════════════════════════════════════════════════════════════════════
+    ESP_LOGI(TAG, "Calibration for site '%s' loaded: %.2f m wire, coasting %s, wire map %s - verified on first run",
+             g_site_id, g_load_profile.wire_learning.wire_length_m,
+             g_load_profile.coasting_valid && g_load_profile.coasting.calibrated ? "calibrated" : "not calibrated",
+             wire_map_is_valid() ? "loaded" : "none");
+}
+
+/**
+ * @brief Make the profile read by read_calibration_profile() the active one (control loop side, or init)
+ */
+static void apply_calibration_profile(void) {
+    reset_calibration_profile(CALIBRATION_PROFILE_NONE);
+    g_profile_save_count = g_load_profile.save_count;
+    snprintf(g_mode_status.calibration_site_id, sizeof(g_mode_status.calibration_site_id), "%s", g_site_id);
+    if (!g_load_profile_valid) {
+        return;
+    }
 
-static void init_mode_status(void) {
-    memset(&g_mode_status, 0, sizeof(g_mode_status));
-    g_mode_status.current_mode = TROLLEY_MODE_NONE;
-    g_mode_status.previous_mode = TROLLEY_MODE_NONE;
-    g_mode_status.wire_learning_availability = MODE_BLOCKED_SENSORS_NOT_VALIDATED;
-    g_mode_status.automatic_availability = MODE_BLOCKED_SENSORS_NOT_VALIDATED;
-    g_mode_status.manual_availability = MODE_BLOCKED_SENSORS_NOT_VALIDATED;
-    g_mode_status.sensor_validation_state = SENSOR_VALIDATION_NOT_STARTED;
-    g_mode_status.system_healthy = true;
+    memcpy(&g_wire_learning_data, &g_load_profile.wire_learning, sizeof(g_wire_learning_data));
+    g_mode_status.wire_learning_complete = true;
+    g_mode_status.wire_length_m = g_wire_learning_data.wire_length_m;
+    if (g_load_profile.coasting_valid && g_load_profile.coasting.calibrated) {
+        memcpy(&g_coasting_data, &g_load_profile.coasting, sizeof(g_coasting_data));
+        memcpy(&g_mode_status.coasting_data, &g_load_profile.coasting, sizeof(g_coasting_data));
+    }
+    g_mode_status.calibration_state = CALIBRATION_PROFILE_UNVERIFIED;
 }
 
-static void init_wire_learning_data(void) {
-    memset(&g_wire_learning_data, 0, sizeof(g_wire_learning_data));
+/**
+ * @brief Snapshot the profile for housekeeping to write (control loop side)
+ * @return false while the previous snapshot is still being written
+ */
+static bool hand_off_calibration_profile(void) {
+    // A pending erase must not land after (and wipe) the newer profile
+    if (g_save_ready.load(std::memory_order_acquire) || g_erase_pending.load(std::memory_order_acquire)) {
+        return false;
+    }
+    memset(&g_save_profile, 0, sizeof(g_save_profile));
+    g_save_profile.wire_valid = g_wire_learning_data.complete;
+    g_save_profile.coasting_valid = g_coasting_data.calibrated;
+    memcpy(&g_save_profile.wire_learning, &g_wire_learning_data, sizeof(g_save_profile.wire_learning));
+    memcpy(&g_save_profile.coasting, &g_coasting_data, sizeof(g_save_profile.coasting));
+    g_save_profile.save_count = g_profile_save_count.load(std::memory_order_relaxed);
+    g_save_ready.store(true, std::memory_order_release);
+    return true;
 }
 
-static void init_coasting_data(void) {
-    memset(&g_coasting_data, 0, sizeof(g_coasting_data));
+/**
+ * @brief Write a handed-off profile to NVS (housekeeping side)
+ */
+static void save_calibration_profile(void) {
+    if (!g_save_ready.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    esp_err_t result = calibration_store_save(g_site_id, &g_save_profile);
+    if (result != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to save calibration for site '%s': %s", g_site_id, esp_err_to_name(result));
+    } else {
+        g_profile_save_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    g_save_ready.store(false, std::memory_order_release);
+}
+
+/**
+ * @brief Erase a cleared or rejected profile from NVS (housekeeping side)
+ *
+ * Runs after save_calibration_profile(), so a profile handed off before the
+ * clear cannot be written back over the erase.
+ */
+static void erase_calibration_profile(void) {
+    if (!g_erase_pending.load(std::memory_order_acquire)) {
+        return;
+    }
+    
+    esp_err_t result = calibration_store_erase(g_site_id);
+    if (result != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to erase calibration for site '%s': %s", g_site_id, esp_err_to_name(result));
+        return;   // Retried next housekeeping pass
+    }
+    ESP_LOGI(TAG, "Calibration for site '%s' erased", g_site_id);
+    g_erase_pending.store(false, std::memory_order_release);
+}
+
+/**
+ * @brief Switch g_site_id and read the selected site's profile (housekeeping side)
+ *
+ * Runs after save_calibration_profile() and erase_calibration_profile(), and
+ * waits while either is still due: both act on g_site_id, which must stay the
+ * previous site until they are done. A wire map write in progress shares the
+ * map's staging buffer with wire_map_load(), so that is waited for too.
+ */
+static void load_selected_site(void) {
+    if (g_site_load.load(std::memory_order_acquire) != SITE_LOAD_REQUESTED) {
+        return;
+    }
+    wire_map_stats_t map_stats;
+    wire_map_get_stats(&map_stats);
+    if (g_save_ready.load(std::memory_order_acquire) || g_erase_pending.load(std::memory_order_acquire) ||
+        map_stats.save_pending) {
+        return;
+    }
+
+    esp_err_t result = calibration_store_set_active_site(g_requested_site);
+    if (result != ESP_OK) {
+        ESP_LOGW(TAG, "Site selection not persisted: %s", esp_err_to_name(result));
+    }
+
+    strncpy(g_site_id, g_requested_site, sizeof(g_site_id) - 1);
+    g_site_id[sizeof(g_site_id) - 1] = '\0';
+    read_calibration_profile();
+
+    ESP_LOGI(TAG, "Site '%s' selected", g_site_id);
+    g_site_load.store(SITE_LOAD_READY, std::memory_order_release);
 }
 // ═══════════════════════════════════════════════════════════════════════════════
 
@@ -252,15 +495,13 @@ static void update_sensor_validation_state(void) {
     
     switch (g_mode_status.sensor_validation_state) {
         case SENSOR_VALIDATION_NOT_STARTED:
-            strcpy(g_mode_status.sensor_validation_message, 
-                  "SENSOR VALIDATION REQUIRED: Step 1: ROTATE THE WHEEL manually");
+            g_mode_status.sensor_validation_text = STATUS_TEXT_VALIDATION_REQUIRED;
             break;
             
         case SENSOR_VALIDATION_IN_PROGRESS:
             if (sensor_status.wheel_rotation_detected && !g_hall_validation_user_confirmed) {
                 g_mode_status.sensor_validation_state = SENSOR_VALIDATION_HALL_PENDING;
-                strcpy(g_mode_status.sensor_validation_message,
-                      "HALL SENSOR OK! Press 'Confirm Hall Sensor' button to continue");
+                g_mode_status.sensor_validation_text = STATUS_TEXT_VALIDATION_HALL_OK;
             }
             break;
             
@@ -268,40 +509,39 @@ static void update_sensor_validation_state(void) {
             if (g_hall_validation_user_confirmed) {
                 g_mode_status.sensor_validation_state = SENSOR_VALIDATION_ACCEL_PENDING;
                 g_mode_status.hall_validation_complete = true;
-                strcpy(g_mode_status.sensor_validation_message,
-                      "Step 2: SHAKE THE TROLLEY to test accelerometer");
+                g_mode_status.sensor_validation_text = STATUS_TEXT_VALIDATION_SHAKE;
             }
             break;
             
         case SENSOR_VALIDATION_ACCEL_PENDING:
             if (sensor_status.trolley_shake_detected && !g_accel_validation_user_confirmed) {
-                strcpy(g_mode_status.sensor_validation_message,
-                      "ACCELEROMETER OK! Press 'Confirm Accelerometer' button to complete");
+                g_mode_status.sensor_validation_text = STATUS_TEXT_VALIDATION_ACCEL_OK;
             } else if (g_accel_validation_user_confirmed) {
                 g_mode_status.sensor_validation_state = SENSOR_VALIDATION_COMPLETE;
                 g_mode_status.accel_validation_complete = true;
                 g_mode_status.sensors_validated = true;
-                strcpy(g_mode_status.sensor_validation_message,
-                      "✅ ALL SENSORS VALIDATED - Modes now available");
+                g_mode_status.sensor_validation_text = STATUS_TEXT_VALIDATION_ALL_VALIDATED;
             }
             break;
             
         case SENSOR_VALIDATION_COMPLETE:
-            strcpy(g_mode_status.sensor_validation_message,
-                  "✅ Sensors validated and ready for operation");
+            g_mode_status.sensor_validation_text = STATUS_TEXT_VALIDATION_READY;
             break;
             
         case SENSOR_VALIDATION_FAILED:
-            strcpy(g_mode_status.sensor_validation_message,
-                  "❌ Sensor validation FAILED - Check connections and retry");
+            g_mode_status.sensor_validation_text = STATUS_TEXT_VALIDATION_FAILED;
             break;
     }
 }
 
 static void update_mode_availability(void) {
+    bool profile_loading = g_mode_status.calibration_state == CALIBRATION_PROFILE_LOADING;
+    
     // Wire Learning Mode availability
     if (!g_mode_status.sensors_validated) {
         g_mode_status.wire_learning_availability = MODE_BLOCKED_SENSORS_NOT_VALIDATED;
+    } else if (profile_loading) {
+        g_mode_status.wire_learning_availability = MODE_BLOCKED_PROFILE_LOADING;
     } else if (wire_learning_mode_is_active()) {
         g_mode_status.wire_learning_availability = MODE_ACTIVE;
     } else if (!g_mode_status.system_healthy) {
@@ -313,6 +553,8 @@ static void update_mode_availability(void) {
     // Automatic Mode availability
     if (!g_mode_status.sensors_validated) {
         g_mode_status.automatic_availability = MODE_BLOCKED_SENSORS_NOT_VALIDATED;
+    } else if (profile_loading) {
+        g_mode_status.automatic_availability = MODE_BLOCKED_PROFILE_LOADING;
     } else if (!g_wire_learning_data.complete) {
         g_mode_status.automatic_availability = MODE_BLOCKED_WIRE_LEARNING_REQUIRED;
     } else if (automatic_mode_is_active()) {
@@ -338,17 +580,16 @@ static void update_mode_availability(void) {
 static void update_current_mode_status(void) {
     if (wire_learning_mode_is_active()) {
         g_mode_status.current_mode = TROLLEY_MODE_WIRE_LEARNING;
-        strcpy(g_mode_status.current_mode_status, "Wire Learning: Active");
+        g_mode_status.current_mode_text = STATUS_TEXT_COORD_WIRE_LEARNING_ACTIVE;
     } else if (automatic_mode_is_active()) {
         g_mode_status.current_mode = TROLLEY_MODE_AUTOMATIC;
-        snprintf(g_mode_status.current_mode_status, sizeof(g_mode_status.current_mode_status),
-                "Automatic: Cycle %lu", g_mode_status.auto_cycle_count);
+        g_mode_status.current_mode_text = STATUS_TEXT_COORD_AUTOMATIC_ACTIVE;
     } else if (manual_mode_is_active()) {
         g_mode_status.current_mode = TROLLEY_MODE_MANUAL;
-        strcpy(g_mode_status.current_mode_status, "Manual: Active");
+        g_mode_status.current_mode_text = STATUS_TEXT_COORD_MANUAL_ACTIVE;
     } else {
         g_mode_status.current_mode = TROLLEY_MODE_NONE;
-        strcpy(g_mode_status.current_mode_status, "No active mode");
+        g_mode_status.current_mode_text = STATUS_TEXT_COORD_NO_MODE;
     }
 }
 
@@ -360,10 +601,20 @@ esp_err_t mode_coordinator_init(void) {
     ESP_LOGI(TAG, "Initializing 3-mode coordination system...");
     
     // Initialize status messages
-    strcpy(g_mode_status.current_mode_status, "System initializing...");
-    strcpy(g_mode_status.sensor_validation_message, 
-          "SENSOR VALIDATION REQUIRED: Step 1: ROTATE THE WHEEL manually");
-    strcpy(g_mode_status.error_message, "");
+    g_mode_status.current_mode_text = STATUS_TEXT_SYSTEM_INITIALIZING;
+    g_mode_status.sensor_validation_text = STATUS_TEXT_VALIDATION_REQUIRED;
+    g_mode_status.error_text = STATUS_TEXT_NONE;
+    
+    // Warm start: a stored profile unlocks automatic mode without re-learning
+    if (wire_map_init() != ESP_OK) {
+        ESP_LOGW(TAG, "Wire map unavailable - automatic mode treats the wire as uniform");
+    }
+    calibration_store_get_active_site(g_site_id, sizeof(g_site_id));
+    read_calibration_profile();
+    apply_calibration_profile();
+    
+    memcpy(&g_published_status, &g_mode_status, sizeof(g_mode_status));
+    g_status_snapshot.write(g_published_status);
     
     g_coordinator_initialized = true;
     
@@ -372,7 +623,11 @@ esp_err_t mode_coordinator_init(void) {
 }
 
 system_mode_status_t mode_coordinator_get_status(void) {
-    return g_mode_status;
+    return g_status_snapshot.read();
+}
+
+uint32_t mode_coordinator_get_status_generation(void) {
+    return g_status_snapshot.generation();
 }
 
 trolley_operation_mode_t mode_coordinator_get_current_mode(void) {
@@ -398,6 +653,12 @@ esp_err_t mode_coordinator_update(void) {
     // Update sensor validation state
     update_sensor_validation_state();
     
+    // Site change read by housekeeping: applied here, where the profile is used
+    if (g_site_load.load(std::memory_order_acquire) == SITE_LOAD_READY) {
+        apply_calibration_profile();
+        g_site_load.store(SITE_LOAD_IDLE, std::memory_order_release);
+    }
+    
     // Update mode availability
     update_mode_availability();
     
@@ -411,6 +672,99 @@ esp_err_t mode_coordinator_update(void) {
     g_mode_status.system_healthy = hw_status.system_initialized && 
                                    sensor_status.system_ready;
     
+    // NVS write between modes: snapshot here, written by housekeeping
+    if (g_calibration_save_pending && g_mode_status.current_mode == TROLLEY_MODE_NONE &&
+        hand_off_calibration_profile()) {
+        g_calibration_save_pending = false;
+    }
+    
+    // Wire map flash work in bounded steps, never while the trolley moves
+    g_flash_window.store(g_mode_status.current_mode == TROLLEY_MODE_NONE && hw_status.target_speed_ms == 0.0f &&
+                         hw_status.current_speed_ms < 0.05f, std::memory_order_relaxed);
+    
+    // Publish only on change so the generation works as a change token
+    if (memcmp(&g_published_status, &g_mode_status, sizeof(g_mode_status)) != 0) {
+        memcpy(&g_published_status, &g_mode_status, sizeof(g_mode_status));
+        g_status_snapshot.write(g_published_status);
+    }
+    
+    return ESP_OK;
+}
+
+esp_err_t mode_coordinator_service_flash(void) {
+    if (!g_coordinator_initialized) return ESP_ERR_INVALID_STATE;
+    
+    save_calibration_profile();
+    erase_calibration_profile();
+    load_selected_site();
+    if (g_flash_window.load(std::memory_order_relaxed)) {
+        wire_map_process_flash(g_site_id);
+    }
+    return ESP_OK;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CALIBRATION PROFILE API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t mode_coordinator_select_site(const char* site_id) {
+    if (!calibration_store_is_valid_site_id(site_id)) return ESP_ERR_INVALID_ARG;
+    if (g_mode_status.current_mode != TROLLEY_MODE_NONE ||
+        g_site_load.load(std::memory_order_acquire) != SITE_LOAD_IDLE) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    // NVS is housekeeping's: modes stay blocked until load_selected_site() has run
+    strncpy(g_requested_site, site_id, sizeof(g_requested_site) - 1);
+    g_requested_site[sizeof(g_requested_site) - 1] = '\0';
+    reset_calibration_profile(CALIBRATION_PROFILE_LOADING);
+    wire_map_reset();
+    snprintf(g_mode_status.calibration_site_id, sizeof(g_mode_status.calibration_site_id), "%s", g_requested_site);
+    g_site_load.store(SITE_LOAD_REQUESTED, std::memory_order_release);
+    return ESP_OK;
+}
+
+const char* mode_coordinator_get_site_id(void) {
+    return g_site_id;
+}
+
+calibration_profile_state_t mode_coordinator_get_calibration_state(void) {
+    return g_mode_status.calibration_state;
+}
+
+esp_err_t mode_coordinator_verify_calibration(float measured_length_m) {
+    if (g_mode_status.calibration_state != CALIBRATION_PROFILE_UNVERIFIED) return ESP_OK;
+    
+    float stored_m = g_wire_learning_data.wire_length_m;
+    float difference_percent = fabsf(measured_length_m - stored_m) / stored_m * 100.0f;
+    
+    if (difference_percent <= CALIBRATION_VERIFY_TOLERANCE_PERCENT) {
+        g_mode_status.calibration_state = CALIBRATION_PROFILE_VERIFIED;
+        deferred_log(DLOG_MSG_COORD_CAL_VERIFIED, measured_length_m, stored_m, difference_percent);
+        return ESP_OK;
+    }
+    
+    deferred_log(DLOG_MSG_COORD_CAL_REJECTED, measured_length_m, stored_m, difference_percent);
+    
+    // Wire changed (or wrong site selected): back to wire learning
+    mode_coordinator_clear_calibration();
+    g_mode_status.calibration_state = CALIBRATION_PROFILE_REJECTED;
+    mode_coordinator_report_error(STATUS_TEXT_COORD_CALIBRATION_MISMATCH);
+    return ESP_ERR_INVALID_RESPONSE;
+}
+
+esp_err_t mode_coordinator_clear_calibration(void) {
+    init_wire_learning_data();
+    init_coasting_data();
+    memset(&g_mode_status.coasting_data, 0, sizeof(g_mode_status.coasting_data));
+    g_mode_status.wire_learning_complete = false;
+    g_mode_status.wire_length_m = 0.0f;
+    g_mode_status.calibration_state = CALIBRATION_PROFILE_NONE;
+    g_calibration_save_pending = false;
+    wire_map_clear();
+    
+    // NVS erase stalls the caller for tens of ms: housekeeping does it
+    g_erase_pending.store(true, std::memory_order_release);
     return ESP_OK;
 }
 
@@ -422,15 +776,14 @@ esp_err_t mode_coordinator_start_sensor_validation(void) {
     ESP_LOGI(TAG, "Starting sensor validation process");
     
     g_mode_status.sensor_validation_state = SENSOR_VALIDATION_IN_PROGRESS;
-    g_sensor_validation_start_time = esp_timer_get_time();
+    g_sensor_validation_start_time = hal_clock_now_us();
     g_hall_validation_user_confirmed = false;
     g_accel_validation_user_confirmed = false;
     g_mode_status.sensors_validated = false;
     g_mode_status.hall_validation_complete = false;
     g_mode_status.accel_validation_complete = false;
     
-    strcpy(g_mode_status.sensor_validation_message,
-          "Step 1: ROTATE THE WHEEL manually to test Hall sensor");
+    g_mode_status.sensor_validation_text = STATUS_TEXT_VALIDATION_ROTATE_WHEEL;
     
     return ESP_OK;
 }
@@ -480,7 +833,7 @@ bool mode_coordinator_are_sensors_validated(void) {
 }
 
 const char* mode_coordinator_get_sensor_validation_message(void) {
-    return g_mode_status.sensor_validation_message;
+    return status_text_to_string(g_mode_status.sensor_validation_text);
 }
 
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -500,7 +853,7 @@ esp_err_t mode_coordinator_activate_wire_learning(void) {
     
     esp_err_t result = wire_learning_mode_start();
     if (result == ESP_OK) {
-        g_mode_status.mode_start_time = esp_timer_get_time();
+        g_mode_status.mode_start_time = hal_clock_now_us();
     }
     
     return result;
@@ -519,7 +872,7 @@ esp_err_t mode_coordinator_activate_automatic(void) {
     
     esp_err_t result = automatic_mode_start();
     if (result == ESP_OK) {
-        g_mode_status.mode_start_time = esp_timer_get_time();
+        g_mode_status.mode_start_time = hal_clock_now_us();
     }
     
     return result;
@@ -538,14 +891,14 @@ esp_err_t mode_coordinator_activate_manual(void) {
     
     esp_err_t result = manual_mode_start();
     if (result == ESP_OK) {
-        g_mode_status.mode_start_time = esp_timer_get_time();
+        g_mode_status.mode_start_time = hal_clock_now_us();
     }
     
     return result;
 }
 
 esp_err_t mode_coordinator_stop_current_mode(bool immediate) {
-    ESP_LOGI(TAG, "Stopping current mode (%s)", immediate ? "immediate" : "graceful");
+    deferred_log(DLOG_MSG_COORD_STOPPING, immediate ? "immediate" : "graceful");
     
     switch (g_mode_status.current_mode) {
         case TROLLEY_MODE_WIRE_LEARNING:
@@ -573,10 +926,11 @@ esp_err_t mode_coordinator_stop_current_mode(bool immediate) {
 }
 
 esp_err_t mode_coordinator_emergency_stop(void) {
-    ESP_LOGW(TAG, "EMERGENCY STOP activated - stopping all modes");
+    deferred_log(DLOG_MSG_COORD_EMERGENCY_STOP);
     
     // Stop hardware immediately
     hardware_emergency_stop();
+    flight_recorder_trigger(FLIGHT_TRIGGER_EMERGENCY);
     
     // Stop all modes immediately
     wire_learning_mode_stop(true);
@@ -584,7 +938,7 @@ esp_err_t mode_coordinator_emergency_stop(void) {
     manual_mode_stop();
     
     g_mode_status.current_mode = TROLLEY_MODE_NONE;
-    strcpy(g_mode_status.error_message, "Emergency stop activated");
+    g_mode_status.error_text = STATUS_TEXT_EMERGENCY_STOP;
     
     return ESP_OK;
 }
@@ -598,12 +952,14 @@ esp_err_t mode_coordinator_reset_system(void) {
     // Reset all mode data
     memset(&g_wire_learning_data, 0, sizeof(g_wire_learning_data));
     memset(&g_coasting_data, 0, sizeof(g_coasting_data));
+    g_mode_status.calibration_state = CALIBRATION_PROFILE_NONE;
+    g_calibration_save_pending = false;
     
     // Reset sensor validation
     mode_coordinator_reset_sensor_validation();
     
     // Reset error tracking
-    strcpy(g_mode_status.error_message, "");
+    g_mode_status.error_text = STATUS_TEXT_NONE;
     
     // Reset hardware
     hardware_reset_position();
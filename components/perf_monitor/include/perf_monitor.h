@@ -0,0 +1,172 @@
+// components/perf_monitor/include/perf_monitor.h
+#ifndef PERF_MONITOR_H
+#define PERF_MONITOR_H
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PERF_MONITOR.H - HOT-PATH CYCLE COUNTERS AND LATENCY HISTOGRAMS
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Measure where the time goes, cheaply
+// - PERF_SCOPE(probe) times the enclosing block with the CPU cycle counter
+//   (a few dozen cycles per probe, IRAM safe, usable in ISRs)
+// - One fixed log2 histogram per probe: min/max/mean/p50/p99 without
+//   storing samples
+// - Each probe has exactly one writer (its task or ISR); readers copy
+//   without locking, so a report may be off by the sample in flight
+// - Stack high-water marks of the application tasks
+//
+// CONFIG_TROLLEY_PERF_MONITOR=n compiles every probe out; the query API
+// then reports PERF_PROBE_COUNT probes with zero samples.
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#if CONFIG_TROLLEY_PERF_MONITOR
+#define PERF_MONITOR_ENABLED        1
+#else
+#define PERF_MONITOR_ENABLED        0
+#endif
+
+// Monitor configuration
+#define PERF_HISTOGRAM_BUCKETS      32          // Bucket b holds [2^b, 2^(b+1)) cycles
+#define PERF_MAX_TASKS              12          // Tasks in the stack report
+
+// Instrumented code paths
+typedef enum {
+    // Control loop (core 1)
+    PERF_PROBE_LOOP_TICK = 0,           // Whole pipeline tick
+    PERF_PROBE_SENSE,                   // hardware_sense_update()
+    PERF_PROBE_SENSOR_HEALTH,           // sensor_health_update()
+    PERF_PROBE_ESTIMATOR,               // state_estimator_update()
+    PERF_PROBE_WIRE_END,                // wire_end_detector_update()
+    PERF_PROBE_WIRE_LEARNING,           // wire_learning_mode_update()
+    PERF_PROBE_AUTOMATIC,               // automatic_mode_update()
+    PERF_PROBE_MANUAL,                  // manual_mode_update()
+    PERF_PROBE_ESC_OUTPUT,              // hardware_output_update()
+    PERF_PROBE_TELEMETRY,               // telemetry_frame_capture()
+    PERF_PROBE_COMMANDS,                // command_queue_drain()
+    PERF_PROBE_MODE_COORDINATOR,        // mode_coordinator_update()
+
+    // Hall sensor
+    PERF_PROBE_HALL_ISR,                // GPIO edge ISR
+    PERF_PROBE_HALL_LATENCY,            // Oldest edge timestamp → batch processing
+
+    // Housekeeping (core 0)
+    PERF_PROBE_HARDWARE_UPDATE,         // hardware_update()
+
+    // HTTP handlers (httpd task, core 0)
+    PERF_PROBE_HTTP_ROOT,
+    PERF_PROBE_HTTP_JS,
+    PERF_PROBE_HTTP_STATUS,
+    PERF_PROBE_HTTP_COMMAND,
+    PERF_PROBE_HTTP_INCIDENTS,
+    PERF_PROBE_HTTP_PERF,
+    PERF_PROBE_HTTP_WS,
+
+    PERF_PROBE_COUNT
+} perf_probe_t;
+
+// Probe summary (microseconds at the current CPU clock)
+typedef struct {
+    const char* name;
+    uint32_t count;                    // Samples since boot or reset
+    float min_us;
+    float max_us;
+    float mean_us;
+    float p50_us;                      // Upper edge of the median's bucket
+    float p99_us;                      // Upper edge of the 99th percentile's bucket
+} perf_probe_stats_t;
+
+// Task stack usage
+typedef struct {
+    const char* name;
+    uint32_t free_min_bytes;           // Stack high-water mark (never-used bytes)
+} perf_task_stack_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// RECORDING API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Add one sample to a probe's histogram
+ * @param probe Probe (single writer per probe)
+ * @param cycles Duration in CPU cycles
+ * @note IRAM resident, ISR safe
+ */
+void perf_record_cycles(perf_probe_t probe, uint32_t cycles);
+
+/**
+ * @brief Add one sample measured in microseconds (e.g. from esp_timer timestamps)
+ * @param probe Probe (single writer per probe)
+ * @param duration_us Duration in microseconds
+ */
+void perf_record_us(perf_probe_t probe, uint32_t duration_us);
+
+#if PERF_MONITOR_ENABLED
+#include "esp_cpu.h"
+
+#ifdef __cplusplus
+// Times the enclosing scope; the destructor records on every exit path
+class perf_scope {
+public:
+    explicit perf_scope(perf_probe_t probe) : m_probe(probe), m_start(esp_cpu_get_cycle_count()) {}
+    ~perf_scope() { perf_record_cycles(m_probe, esp_cpu_get_cycle_count() - m_start); }
+    perf_scope(const perf_scope&) = delete;
+    perf_scope& operator=(const perf_scope&) = delete;
+private:
+    perf_probe_t m_probe;
+    uint32_t m_start;
+};
+#endif
+
+#define PERF_CONCAT_INNER(a, b)     a##b
+#define PERF_CONCAT(a, b)           PERF_CONCAT_INNER(a, b)
+#define PERF_SCOPE(probe)           perf_scope PERF_CONCAT(perf_scope_, __LINE__)(probe)
+#define PERF_RECORD_US(probe, us)   perf_record_us((probe), (us))
+#else
+#define PERF_SCOPE(probe)           do { } while (0)
+#define PERF_RECORD_US(probe, us)   do { } while (0)
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// QUERY API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Summarize one probe
+ * @param probe Probe
+ * @param stats Output summary
+ * @return ESP_OK, ESP_ERR_INVALID_ARG if probe out of range
+ */
+esp_err_t perf_monitor_get_probe(perf_probe_t probe, perf_probe_stats_t* stats);
+
+/**
+ * @brief Report stack high-water marks of the application tasks that exist
+ * @param stacks Output array
+ * @param max_tasks Capacity of stacks
+ * @return Number of entries written
+ */
+size_t perf_monitor_get_task_stacks(perf_task_stack_t* stacks, size_t max_tasks);
+
+/**
+ * @brief Clear all histograms (each probe clears at its next sample)
+ */
+void perf_monitor_reset(void);
+
+/**
+ * @brief Log a compact summary (system heartbeat)
+ */
+void perf_monitor_log_summary(void);
+
+/**
+ * @brief Get probe name
+ * @param probe Probe
+ * @return String name
+ */
+const char* perf_monitor_probe_to_string(perf_probe_t probe);
+
+#endif // PERF_MONITOR_H
@@ -0,0 +1,203 @@
+// components/perf_monitor/src/perf_monitor.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// PERF_MONITOR.CPP - LOG2 HISTOGRAMS, TASK STACK REPORT
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "perf_monitor.h"
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_rom_sys.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <cstring>
+#include <cstdio>
+
+static_assert(PERF_PROBE_COUNT <= 32, "reset mask holds 32 probes");
+
+#if PERF_MONITOR_ENABLED
+static const char* TAG = "PERF";
+
+// One histogram per probe, written only by that probe's task or ISR
+typedef struct {
+    uint32_t count;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+    uint32_t buckets[PERF_HISTOGRAM_BUCKETS];
+} perf_histogram_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// GLOBAL STATE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static DRAM_ATTR perf_histogram_t g_histograms[PERF_PROBE_COUNT];
+static DRAM_ATTR std::atomic<uint32_t> g_reset_mask{0};    // Probes to clear at next sample
+#endif
+
+// Application tasks in the stack report (names as passed to xTaskCreate)
+static const char* const TASK_NAMES[PERF_MAX_TASKS] = {
+    "control_loop", "imu_acq", "housekeeping", "sys_monitor", "serial_debug",
+    "httpd", "web_telemetry", "flight_rec", "web_async0", "web_async1",
+    "fleet_link", "log_writer"
+};
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// RECORDING API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void IRAM_ATTR perf_record_cycles(perf_probe_t probe, uint32_t cycles) {
+#if PERF_MONITOR_ENABLED
+    if ((unsigned)probe >= PERF_PROBE_COUNT) return;
+    perf_histogram_t* h = &g_histograms[probe];
+    uint32_t bit = 1u << probe;
+
+    if (g_reset_mask.load(std::memory_order_relaxed) & bit) {
+        g_reset_mask.fetch_and(~bit, std::memory_order_relaxed);
+        h->count = 0;
+        h->total_cycles = 0;
+        for (int b = 0; b < PERF_HISTOGRAM_BUCKETS; b++) h->buckets[b] = 0;
+    }
+
+    if (h->count == 0 || cycles < h->min_cycles) h->min_cycles = cycles;
+    if (h->count == 0 || cycles > h->max_cycles) h->max_cycles = cycles;
+    h->total_cycles += cycles;
+    h->buckets[cycles ? 31 - __builtin_clz(cycles) : 0]++;
+    h->count++;
+#else
+    (void)probe;
+    (void)cycles;
+#endif
+}
+
+void IRAM_ATTR perf_record_us(perf_probe_t probe, uint32_t duration_us) {
+    perf_record_cycles(probe, duration_us * esp_rom_get_cpu_ticks_per_us());
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// QUERY API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#if PERF_MONITOR_ENABLED
+/**
+ * @brief Upper edge of the bucket holding the given fraction of samples
+ */
+static uint32_t percentile_cycles(const perf_histogram_t* h, float fraction) {
+    uint32_t target = (uint32_t)(h->count * fraction);
+    if (target == 0) target = 1;
+
+    uint32_t cumulative = 0;
+    for (int b = 0; b < PERF_HISTOGRAM_BUCKETS; b++) {
+        cumulative += h->buckets[b];
+        if (cumulative >= target) {
+            uint64_t upper = (2ULL << b) - 1;
+            return upper < h->max_cycles ? (uint32_t)upper : h->max_cycles;
+        }
+    }
+    return h->max_cycles;
+}
+#endif
+
+esp_err_t perf_monitor_get_probe(perf_probe_t probe, perf_probe_stats_t* stats) {
+    if (stats == NULL || (unsigned)probe >= PERF_PROBE_COUNT) return ESP_ERR_INVALID_ARG;
+    memset(stats, 0, sizeof(*stats));
+    stats->name = perf_monitor_probe_to_string(probe);
+
+#if PERF_MONITOR_ENABLED
+    // Unlocked copy: the writer may add one sample while we copy
+    perf_histogram_t h = g_histograms[probe];
+    if ((g_reset_mask.load(std::memory_order_relaxed) & (1u << probe)) || h.count == 0) {
+        return ESP_OK;
+    }
+
+    float cycles_per_us = (float)esp_rom_get_cpu_ticks_per_us();
+    stats->count = h.count;
+    stats->min_us = h.min_cycles / cycles_per_us;
+    stats->max_us = h.max_cycles / cycles_per_us;
+    stats->mean_us = (float)(h.total_cycles / h.count) / cycles_per_us;
+    stats->p50_us = percentile_cycles(&h, 0.50f) / cycles_per_us;
+    stats->p99_us = percentile_cycles(&h, 0.99f) / cycles_per_us;
+#endif
+    return ESP_OK;
+}
+
+size_t perf_monitor_get_task_stacks(perf_task_stack_t* stacks, size_t max_tasks) {
+    if (stacks == NULL) return 0;
+
+    size_t count = 0;
+    for (int i = 0; i < PERF_MAX_TASKS && TASK_NAMES[i] != NULL && count < max_tasks; i++) {
+        TaskHandle_t handle = xTaskGetHandle(TASK_NAMES[i]);
+        if (handle == NULL) continue;
+        stacks[count].name = TASK_NAMES[i];
+        stacks[count].free_min_bytes = uxTaskGetStackHighWaterMark(handle);
+        count++;
+    }
+    return count;
+}
+
+void perf_monitor_reset(void) {
+#if PERF_MONITOR_ENABLED
+    g_reset_mask.store((PERF_PROBE_COUNT >= 32) ? UINT32_MAX : ((1u << PERF_PROBE_COUNT) - 1),
+                       std::memory_order_relaxed);
+#endif
+}
+
+void perf_monitor_log_summary(void) {
+#if PERF_MONITOR_ENABLED
+    static const perf_probe_t SUMMARY_PROBES[] = {
+        PERF_PROBE_LOOP_TICK, PERF_PROBE_SENSE, PERF_PROBE_ESTIMATOR, PERF_PROBE_AUTOMATIC,
+        PERF_PROBE_ESC_OUTPUT, PERF_PROBE_HALL_ISR, PERF_PROBE_HALL_LATENCY,
+        PERF_PROBE_MODE_COORDINATOR, PERF_PROBE_HTTP_STATUS
+    };
+
+    for (size_t i = 0; i < sizeof(SUMMARY_PROBES) / sizeof(SUMMARY_PROBES[0]); i++) {
+        perf_probe_stats_t stats;
+        perf_monitor_get_probe(SUMMARY_PROBES[i], &stats);
+        if (stats.count == 0) continue;
+        ESP_LOGI(TAG, "%-16s p50 %7.1f  p99 %7.1f  max %7.1f us (%lu)",
+                 stats.name, stats.p50_us, stats.p99_us, stats.max_us, (unsigned long)stats.count);
+    }
+
+    perf_task_stack_t stacks[PERF_MAX_TASKS];
+    size_t task_count = perf_monitor_get_task_stacks(stacks, PERF_MAX_TASKS);
+    char line[160];
+    int n = 0;
+    for (size_t i = 0; i < task_count && n >= 0 && (size_t)n < sizeof(line); i++) {
+        n += snprintf(line + n, sizeof(line) - n, "%s%s %lu", i ? ", " : "",
+                      stacks[i].name, (unsigned long)stacks[i].free_min_bytes);
+    }
+    if (task_count > 0) ESP_LOGI(TAG, "Stack free (bytes): %s", line);
+#endif
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// UTILITY API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+const char* perf_monitor_probe_to_string(perf_probe_t probe) {
+    switch (probe) {
+        case PERF_PROBE_LOOP_TICK:          return "loop_tick";
+        case PERF_PROBE_SENSE:              return "sense";
+        case PERF_PROBE_SENSOR_HEALTH:      return "sensor_health";
+        case PERF_PROBE_ESTIMATOR:          return "estimator";
+        case PERF_PROBE_WIRE_END:           return "wire_end";
+        case PERF_PROBE_WIRE_LEARNING:      return "wire_learning";
+        case PERF_PROBE_AUTOMATIC:          return "automatic";
+        case PERF_PROBE_MANUAL:             return "manual";
+        case PERF_PROBE_ESC_OUTPUT:         return "esc_output";
+        case PERF_PROBE_TELEMETRY:          return "telemetry";
+        case PERF_PROBE_COMMANDS:           return "commands";
+        case PERF_PROBE_MODE_COORDINATOR:   return "mode_coordinator";
+        case PERF_PROBE_HALL_ISR:           return "hall_isr";
+        case PERF_PROBE_HALL_LATENCY:       return "hall_latency";
+        case PERF_PROBE_HARDWARE_UPDATE:    return "hardware_update";
+        case PERF_PROBE_HTTP_ROOT:          return "http_root";
+        case PERF_PROBE_HTTP_JS:            return "http_js";
+        case PERF_PROBE_HTTP_STATUS:        return "http_status";
+        case PERF_PROBE_HTTP_COMMAND:       return "http_command";
+        case PERF_PROBE_HTTP_INCIDENTS:     return "http_incidents";
+        case PERF_PROBE_HTTP_PERF:          return "http_perf";
+        case PERF_PROBE_HTTP_WS:            return "http_ws";
+        default:                            return "unknown";
+    }
+}
@@ -0,0 +1,96 @@
+// components/power_manager/include/power_manager.h
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// POWER_MANAGER.H - CLOCK SCALING AND SLEEP GATED BY MOTION
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Run at full clock only while the trolley moves
+// - ESP-IDF DFS between POWER_CPU_MIN_FREQ_MHZ and the project CPU frequency;
+//   the minimum keeps APB at 80 MHz, so LEDC/MCPWM/RMT/GPTimer/UART timing
+//   never changes with the clock
+// - "motion" lock (CPU_FREQ_MAX): taken by power_manager_motion_begin() the
+//   moment a speed command or arming is issued, before the control loop acts
+//   on it, so resuming costs no tick; dropped POWER_IDLE_HOLD_MS after the
+//   trolley is commanded to zero and has stopped (cycle and direction pauses
+//   longer than the hold run at the low clock)
+// - "esc" lock (NO_LIGHT_SLEEP): held while the ESC is armed or arming; light
+//   sleep would stop the ESC signal
+// - Automatic light sleep (CONFIG_FREERTOS_USE_TICKLESS_IDLE) is allowed for
+//   everything else; it only engages when no driver holds a lock of its own
+//   (with the SoftAP up the WiFi driver keeps the radio awake, DFS still applies)
+//
+// CONFIG_PM_ENABLE=n leaves the clock fixed: init returns ESP_ERR_NOT_SUPPORTED
+// and the rest of the API does nothing.
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#if CONFIG_PM_ENABLE
+#define POWER_MANAGER_ENABLED       1
+#else
+#define POWER_MANAGER_ENABLED       0
+#endif
+
+// Power configuration
+#define POWER_CPU_MIN_FREQ_MHZ      80          // Lowest DFS step that keeps APB at 80 MHz
+#define POWER_IDLE_HOLD_MS          500         // Stopped this long before the clock drops
+#define POWER_IDLE_SPEED_MS         0.02f       // Below this the wheel counts as stopped
+
+/**
+ * @brief Power manager counters since init
+ */
+typedef struct {
+    bool enabled;                       // DFS configured
+    bool light_sleep_enabled;           // Automatic light sleep allowed when idle
+    bool motion_locked;                 // Full clock held now
+    bool esc_locked;                    // Light sleep blocked for the ESC now
+    uint32_t max_freq_mhz;
+    uint32_t min_freq_mhz;
+    uint32_t motion_begins;             // Idle → full clock transitions
+    uint32_t full_clock_ms;             // Time the motion lock was held
+    uint32_t uptime_ms;                 // Since power_manager_init()
+} power_manager_stats_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// POWER MANAGER API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Configure DFS / light sleep and create the locks
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED with CONFIG_PM_ENABLE=n,
+ *         esp_pm error otherwise
+ */
+esp_err_t power_manager_init(void);
+
+/**
+ * @brief Full clock and no light sleep from now on (any task, non-blocking)
+ * @note Call before the command takes effect; repeated calls are free
+ */
+void power_manager_motion_begin(void);
+
+/**
+ * @brief Release the locks once the trolley has been idle long enough
+ * @param moving Commanded speed, wheel speed or ESC output not at rest
+ * @param esc_live ESC armed or arming (light sleep would drop its signal)
+ * @note Called periodically by the housekeeping task
+ */
+void power_manager_update(bool moving, bool esc_live);
+
+/**
+ * @brief True while the motion lock is released
+ * @return Idle state
+ */
+bool power_manager_is_idle(void);
+
+/**
+ * @brief Get power manager counters
+ * @return power_manager_stats_t structure
+ */
+power_manager_stats_t power_manager_get_stats(void);
+
+#endif // POWER_MANAGER_H
@@ -0,0 +1,179 @@
+// components/power_manager/src/power_manager.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// POWER_MANAGER.CPP - DFS / LIGHT SLEEP LOCKS
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// power_manager_motion_begin() may run on any task (control loop, httpd,
+// housekeeping); power_manager_update() runs on housekeeping only. Neither
+// blocks: the motion lock is taken by whoever flips g_motion_held false → true
+// and released by update() alone. update() re-checks the motion stamp after
+// releasing, so a begin that raced the release re-takes the lock.
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "power_manager.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <atomic>
+
+static const char* TAG = "POWER_MANAGER";
+
+#if POWER_MANAGER_ENABLED
+
+#include "esp_pm.h"
+
+#ifdef CONFIG_FREERTOS_USE_TICKLESS_IDLE
+#define POWER_LIGHT_SLEEP           1
+#else
+#define POWER_LIGHT_SLEEP           0
+#endif
+
+static esp_pm_lock_handle_t g_motion_lock = NULL;      // ESP_PM_CPU_FREQ_MAX
+static esp_pm_lock_handle_t g_esc_lock = NULL;         // ESP_PM_NO_LIGHT_SLEEP
+static bool g_initialized = false;
+
+static std::atomic<bool> g_motion_held{false};
+static std::atomic<uint32_t> g_motion_stamp_ms{0};     // Last motion_begin()
+static bool g_esc_held = false;                        // Housekeeping only
+
+static std::atomic<uint32_t> g_motion_begins{0};
+static std::atomic<uint32_t> g_full_clock_ms{0};
+static uint64_t g_init_us = 0;
+static uint64_t g_last_update_us = 0;                  // Housekeeping only
+static uint64_t g_full_clock_us = 0;                   // Housekeeping only
+
+static inline uint32_t now_ms(void) {
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+static void take_motion_lock(void) {
+    if (!g_motion_held.exchange(true, std::memory_order_seq_cst)) {
+        esp_pm_lock_acquire(g_motion_lock);
+        g_motion_begins.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+esp_err_t power_manager_init(void) {
+    if (g_initialized) return ESP_OK;
+
+    esp_err_t ret = esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "motion", &g_motion_lock);
+    if (ret == ESP_OK) ret = esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "esc", &g_esc_lock);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create PM locks: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    // Boot and the first command run at full clock until the first idle hold
+    g_motion_stamp_ms.store(now_ms(), std::memory_order_seq_cst);
+    take_motion_lock();
+
+    esp_pm_config_t pm_config = {};
+    pm_config.max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+    pm_config.min_freq_mhz = POWER_CPU_MIN_FREQ_MHZ;
+    pm_config.light_sleep_enable = POWER_LIGHT_SLEEP;
+    ret = esp_pm_configure(&pm_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "DFS configuration failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    g_init_us = esp_timer_get_time();
+    g_last_update_us = g_init_us;
+    g_initialized = true;
+    ESP_LOGI(TAG, "DFS %d-%d MHz, light sleep %s, idle after %d ms stopped",
+             POWER_CPU_MIN_FREQ_MHZ, CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+             POWER_LIGHT_SLEEP ? "allowed" : "off", POWER_IDLE_HOLD_MS);
+    return ESP_OK;
+}
+
+void power_manager_motion_begin(void) {
+    if (!g_initialized) return;
+    // Stamp first: a concurrent release either sees it or left the flag for us
+    g_motion_stamp_ms.store(now_ms(), std::memory_order_seq_cst);
+    if (g_motion_held.load(std::memory_order_seq_cst)) return;
+    take_motion_lock();
+}
+
+void power_manager_update(bool moving, bool esc_live) {
+    if (!g_initialized) return;
+
+    uint64_t now_us = esp_timer_get_time();
+    if (g_motion_held.load(std::memory_order_relaxed)) {
+        g_full_clock_us += now_us - g_last_update_us;
+        g_full_clock_ms.store((uint32_t)(g_full_clock_us / 1000), std::memory_order_relaxed);
+    }
+    g_last_update_us = now_us;
+
+    if (esc_live != g_esc_held) {
+        if (esc_live) {
+            esp_pm_lock_acquire(g_esc_lock);
+        } else {
+            esp_pm_lock_release(g_esc_lock);
+        }
+        g_esc_held = esc_live;
+    }
+
+    if (moving) {
+        power_manager_motion_begin();
+        return;
+    }
+
+    uint32_t stamp = g_motion_stamp_ms.load(std::memory_order_seq_cst);
+    if ((uint32_t)(now_us / 1000) - stamp < POWER_IDLE_HOLD_MS) return;
+
+    if (g_motion_held.exchange(false, std::memory_order_seq_cst)) {
+        esp_pm_lock_release(g_motion_lock);
+        ESP_LOGD(TAG, "Idle: clock may drop to %d MHz", POWER_CPU_MIN_FREQ_MHZ);
+
+        // A motion_begin() that saw the flag still set before our exchange
+        if (g_motion_stamp_ms.load(std::memory_order_seq_cst) != stamp) {
+            take_motion_lock();
+        }
+    }
+}
+
+bool power_manager_is_idle(void) {
+    return g_initialized && !g_motion_held.load(std::memory_order_acquire);
+}
+
+power_manager_stats_t power_manager_get_stats(void) {
+    power_manager_stats_t stats = {};
+    stats.enabled = g_initialized;
+    stats.light_sleep_enabled = g_initialized && POWER_LIGHT_SLEEP;
+    stats.motion_locked = g_motion_held.load(std::memory_order_acquire);
+    stats.esc_locked = g_esc_held;
+    stats.max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+    stats.min_freq_mhz = g_initialized ? POWER_CPU_MIN_FREQ_MHZ : CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+    stats.motion_begins = g_motion_begins.load(std::memory_order_relaxed);
+    stats.full_clock_ms = g_full_clock_ms.load(std::memory_order_relaxed);
+    stats.uptime_ms = g_initialized ? (uint32_t)((esp_timer_get_time() - g_init_us) / 1000) : 0;
+    return stats;
+}
+
+#else // !POWER_MANAGER_ENABLED
+
+esp_err_t power_manager_init(void) {
+    ESP_LOGI(TAG, "Power management disabled (CONFIG_PM_ENABLE=n): fixed clock");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void power_manager_motion_begin(void) {
+}
+
+void power_manager_update(bool moving, bool esc_live) {
+    (void)moving;
+    (void)esc_live;
+}
+
+bool power_manager_is_idle(void) {
+    return false;
+}
+
+power_manager_stats_t power_manager_get_stats(void) {
+    power_manager_stats_t stats = {};
+    stats.max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+    stats.min_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+    stats.uptime_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    return stats;
+}
+
+#endif // POWER_MANAGER_ENABLED
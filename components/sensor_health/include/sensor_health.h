@@ -3,7 +3,7 @@
 #define SENSOR_HEALTH_H
 
 #include "esp_err.h"
-#include "MPU.hpp"
+#include "status_text.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -42,14 +42,14 @@ typedef struct {
     float accel_y_g;
     float accel_z_g;
     float total_accel_g;
-    float last_impact_g;
+    float last_impact_g;                // Deviation from 1 g, not total magnitude
     uint64_t last_impact_time;
     bool trolley_shake_detected;
     
     // System state
     init_state_t init_state;
-    char status_message[128];
-    char error_message[128];
+    status_text_t status_text;
+    status_text_t error_text;            // STATUS_TEXT_NONE unless validation failed
     uint64_t init_start_time;
     bool sensors_validated;
     bool system_ready;
@@ -61,14 +61,14 @@ typedef struct {
 #define HALL_VALIDATION_TIMEOUT_MS      60000     // 1 minute timeout
 #define ACCEL_VALIDATION_TIMEOUT_MS     60000     // 1 minute timeout
 #define MINIMUM_SHAKE_THRESHOLD_G       0.3f      // Minimum shake detection
-#define IMPACT_THRESHOLD_G              0.1f      // Impact detection threshold
+#define IMPACT_THRESHOLD_G              0.5f      // Impact: |accel| deviation from 1 g
 #define HALL_PULSE_TIMEOUT_MS           5000      // Hall pulse timeout
-#define ACCEL_SAMPLE_RATE_MS            50        // Accelerometer sampling rate
 
 // Function declarations
-esp_err_t sensor_health_init(MPU_t* mpu_sensor);
+esp_err_t sensor_health_init(void);
 void sensor_health_update(void);
 sensor_health_t sensor_health_get_status(void);
+uint32_t sensor_health_get_status_generation(void);
 bool sensor_health_is_system_ready(void);
 bool sensor_health_validate_hall_sensor(void);
 bool sensor_health_validate_accelerometer(void);
@@ -82,7 +82,8 @@ float sensor_health_calculate_wheel_speed(void);
 bool sensor_health_is_hall_healthy(void);
 
 // Accelerometer specific functions
-void sensor_health_process_accel_data(float x_g, float y_g, float z_g);
+void sensor_health_process_accel_raw(int16_t x_raw, int16_t y_raw, int16_t z_raw, uint16_t total_raw);
+void sensor_health_process_accel_data(float x_g, float y_g, float z_g);   // Float wrapper
 bool sensor_health_is_accel_healthy(void);
 float sensor_health_get_last_impact(void);
 
@@ -1,5 +1,10 @@
 // components/sensor_health/src/sensor_health.cpp - FIXED VERSION
 #include "sensor_health.h"
+#include "status_snapshot.h"
+#include "imu_acquisition.h"
+#include "state_estimator.h"
+#include "fixed_point.h"
+#include "deferred_log.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
@@ -9,6 +14,11 @@
 
 static const char* TAG = "SENSOR_HEALTH";
 
+// Thresholds in raw accelerometer counts (compared without the FPU)
+static constexpr uint32_t SHAKE_THRESHOLD_RAW = (uint32_t)(MINIMUM_SHAKE_THRESHOLD_G * IMU_ACCEL_LSB_PER_G);
+static constexpr uint32_t IMPACT_THRESHOLD_RAW = (uint32_t)(IMPACT_THRESHOLD_G * IMU_ACCEL_LSB_PER_G);
+static constexpr uint32_t ONE_G_RAW = (uint32_t)IMU_ACCEL_LSB_PER_G;
+
 // Global sensor health data - FIXED: Proper struct initialization
 static sensor_health_t g_sensor_health = {
     .hall_status = SENSOR_STATUS_UNKNOWN,
@@ -26,24 +36,40 @@ static sensor_health_t g_sensor_health = {
     .last_impact_time = 0,
     .trolley_shake_detected = false,
     .init_state = INIT_STATE_START,
-    .status_message = {0},
-    .error_message = {0},
+    .status_text = STATUS_TEXT_NONE,
+    .error_text = STATUS_TEXT_NONE,
     .init_start_time = 0,
     .sensors_validated = false,
     .system_ready = false
 };
 
-static MPU_t* g_mpu_sensor = nullptr;
-static uint32_t g_last_hall_count = 0;
-static uint64_t g_last_hall_time = 0;
+// Published copy for readers on other tasks/cores (web, monitor, modes)
+static status_snapshot<sensor_health_t> g_sensor_snapshot;
+
+// Accelerometer samples come from the IMU acquisition ring (no I2C here)
+static imu_reader_t g_imu_reader = {};
 static bool g_validation_active = false;
 
+// Drain new IMU samples; only feed them to the accel logic when wanted
+static void drain_imu_samples(bool process) {
+    imu_sample_t batch[IMU_BATCH_SAMPLES * 2];
+    size_t count;
+    
+    while ((count = imu_acquisition_read(&g_imu_reader, batch, sizeof(batch) / sizeof(batch[0]))) > 0) {
+        if (!process) continue;
+        for (size_t i = 0; i < count; i++) {
+            sensor_health_process_accel_raw(batch[i].x_raw, batch[i].y_raw, batch[i].z_raw,
+                                            batch[i].total_raw);
+        }
+    }
+}
+
 // Initialize sensor health monitoring
-esp_err_t sensor_health_init(MPU_t* mpu_sensor) {
+esp_err_t sensor_health_init(void) {
     ESP_LOGI(TAG, "Initializing sensor health monitoring system...");
     ESP_LOGI(TAG, "Wheel: 61mm diameter, 191.6mm circumference");
     
-    g_mpu_sensor = mpu_sensor;
+    imu_acquisition_reader_init(&g_imu_reader);
     
     // Initialize sensor health structure with proper enum values
     g_sensor_health.hall_status = SENSOR_STATUS_UNKNOWN;
@@ -51,8 +77,9 @@ esp_err_t sensor_health_init(MPU_t* mpu_sensor) {
     g_sensor_health.init_state = INIT_STATE_START;
     g_sensor_health.init_start_time = esp_timer_get_time();
     
-    strcpy(g_sensor_health.status_message, "System initializing...");
-    strcpy(g_sensor_health.error_message, "");
+    g_sensor_health.status_text = STATUS_TEXT_SYSTEM_INITIALIZING;
+    g_sensor_health.error_text = STATUS_TEXT_NONE;
+    g_sensor_snapshot.publish_from(&g_sensor_health);
     
     ESP_LOGI(TAG, "Sensor health monitoring initialized");
     return ESP_OK;
@@ -63,83 +90,76 @@ void sensor_health_update(void) {
     uint64_t current_time = esp_timer_get_time();
     uint64_t elapsed_time = current_time - g_sensor_health.init_start_time;
     
+    // Wheel speed comes from the state estimator (single speed source)
+    g_sensor_health.wheel_speed_ms = state_estimator_get_speed();
+    g_sensor_health.current_rpm = g_sensor_health.wheel_speed_ms * 60.0f / (WHEEL_CIRCUMFERENCE_MM * 0.001f);
+    
     switch (g_sensor_health.init_state) {
         case INIT_STATE_START:
+            drain_imu_samples(false);
             g_sensor_health.init_state = INIT_STATE_WAIT_WHEEL_ROTATION;
             g_sensor_health.hall_status = SENSOR_STATUS_TESTING;
-            strcpy(g_sensor_health.status_message, "ROTATE THE WHEEL - Testing Hall sensor...");
+            g_sensor_health.status_text = STATUS_TEXT_SENSOR_ROTATE_WHEEL;
             ESP_LOGI(TAG, "=== ROTATE THE WHEEL ===");
             g_validation_active = true;
             break;
             
         case INIT_STATE_WAIT_WHEEL_ROTATION:
+            drain_imu_samples(false);
             if (g_sensor_health.wheel_rotation_detected) {
                 g_sensor_health.hall_status = SENSOR_STATUS_HEALTHY;
                 g_sensor_health.init_state = INIT_STATE_WAIT_TROLLEY_SHAKE;
                 g_sensor_health.accel_status = SENSOR_STATUS_TESTING;
-                strcpy(g_sensor_health.status_message, "SHAKE THE TROLLEY - Testing accelerometer...");
+                g_sensor_health.status_text = STATUS_TEXT_SENSOR_SHAKE_TROLLEY;
                 ESP_LOGI(TAG, "Hall sensor OK. === SHAKE THE TROLLEY ===");
             } else if (elapsed_time > HALL_VALIDATION_TIMEOUT_MS * 1000ULL) {
                 g_sensor_health.hall_status = SENSOR_STATUS_TIMEOUT;
                 g_sensor_health.init_state = INIT_STATE_FAILED;
-                strcpy(g_sensor_health.error_message, "No wheel rotation detected - check/replace Hall sensor");
+                g_sensor_health.error_text = STATUS_TEXT_SENSOR_NO_ROTATION;
                 ESP_LOGE(TAG, "Hall sensor validation FAILED - timeout");
             }
             break;
             
         case INIT_STATE_WAIT_TROLLEY_SHAKE:
-            // Update accelerometer readings
-            if (g_mpu_sensor) {
-                mpud::raw_axes_t accelRaw, gyroRaw;
-                if (g_mpu_sensor->motion(&accelRaw, &gyroRaw) == ESP_OK) {
-                    // Convert to g-force (assuming ±8g range, 4096 LSB/g for MPU6050)
-                    float x_g = accelRaw.x / 4096.0f;
-                    float y_g = accelRaw.y / 4096.0f;
-                    float z_g = accelRaw.z / 4096.0f;
-                    sensor_health_process_accel_data(x_g, y_g, z_g);
-                }
-            }
+            // Process every accelerometer sample since last update
+            drain_imu_samples(true);
             
             if (g_sensor_health.trolley_shake_detected) {
                 g_sensor_health.accel_status = SENSOR_STATUS_HEALTHY;
                 g_sensor_health.init_state = INIT_STATE_SENSORS_READY;
-                strcpy(g_sensor_health.status_message, "Both sensors validated - System ready!");
+                g_sensor_health.status_text = STATUS_TEXT_SENSOR_BOTH_VALIDATED;
                 ESP_LOGI(TAG, "Accelerometer OK. Both sensors validated!");
             } else if (elapsed_time > ACCEL_VALIDATION_TIMEOUT_MS * 1000ULL) {
                 g_sensor_health.accel_status = SENSOR_STATUS_TIMEOUT;
                 g_sensor_health.init_state = INIT_STATE_FAILED;
-                strcpy(g_sensor_health.error_message, "Fix/replace accelerometer or its connections");
+                g_sensor_health.error_text = STATUS_TEXT_SENSOR_ACCEL_FAULT;
                 ESP_LOGE(TAG, "Accelerometer validation FAILED - timeout");
             }
             break;
             
         case INIT_STATE_SENSORS_READY:
+            drain_imu_samples(false);
             g_sensor_health.sensors_validated = true;
             g_sensor_health.system_ready = true;
             g_sensor_health.init_state = INIT_STATE_SYSTEM_READY;
             g_validation_active = false;
-            strcpy(g_sensor_health.status_message, "System operational - All sensors healthy");
+            g_sensor_health.status_text = STATUS_TEXT_SENSOR_OPERATIONAL;
             break;
             
         case INIT_STATE_SYSTEM_READY:
             // Continuous health monitoring
             sensor_health_validate_hall_sensor();
-            if (g_mpu_sensor) {
-                mpud::raw_axes_t accelRaw, gyroRaw;
-                if (g_mpu_sensor->motion(&accelRaw, &gyroRaw) == ESP_OK) {
-                    float x_g = accelRaw.x / 4096.0f;
-                    float y_g = accelRaw.y / 4096.0f;
-                    float z_g = accelRaw.z / 4096.0f;
-                    sensor_health_process_accel_data(x_g, y_g, z_g);
-                }
-            }
+            drain_imu_samples(true);
             break;
             
         case INIT_STATE_FAILED:
             // System blocked - sensors failed validation
+            drain_imu_samples(false);
             g_sensor_health.system_ready = false;
             break;
     }
+    
+    g_sensor_snapshot.publish_from(&g_sensor_health);
 }
 
 // Hall sensor pulse detected callback
@@ -148,67 +168,60 @@ void sensor_health_hall_pulse_detected(void) {
     g_sensor_health.hall_pulse_count++;
     g_sensor_health.last_hall_pulse_time = current_time;
     
-    // Calculate RPM and wheel speed
-    if (g_last_hall_time > 0) {
-        uint64_t time_diff_us = current_time - g_last_hall_time;
-        if (time_diff_us > 0) {
-            // Calculate RPM (assuming 1 pulse per revolution)
-            float time_diff_s = time_diff_us / 1000000.0f;
-            g_sensor_health.current_rpm = 60.0f / time_diff_s;
-            
-            // Calculate wheel speed using 61mm wheel circumference
-            g_sensor_health.wheel_speed_ms = (WHEEL_CIRCUMFERENCE_MM * 0.001f) * 
-                                           (g_sensor_health.current_rpm / 60.0f);
-        }
-    }
-    
-    g_last_hall_time = current_time;
-    
     // Mark wheel rotation as detected during validation
     if (g_validation_active) {
         g_sensor_health.wheel_rotation_detected = true;
-        ESP_LOGI(TAG, "Wheel rotation detected! RPM: %.1f, Speed: %.2f m/s", 
-                g_sensor_health.current_rpm, g_sensor_health.wheel_speed_ms);
+        deferred_log(DLOG_MSG_SENSOR_WHEEL_ROTATION, g_sensor_health.hall_pulse_count);
     }
+    
+    g_sensor_snapshot.publish_from(&g_sensor_health);
 }
 
-// Process accelerometer data
-void sensor_health_process_accel_data(float x_g, float y_g, float z_g) {
-    g_sensor_health.accel_x_g = x_g;
-    g_sensor_health.accel_y_g = y_g;
-    g_sensor_health.accel_z_g = z_g;
-    
-    // Calculate total acceleration magnitude (subtract gravity)
-    float total_accel = sqrt(x_g * x_g + y_g * y_g + z_g * z_g);
-    g_sensor_health.total_accel_g = total_accel;
+// Process one accelerometer sample in raw counts (magnitude already integer)
+void sensor_health_process_accel_raw(int16_t x_raw, int16_t y_raw, int16_t z_raw, uint16_t total_raw) {
+    // Float copies are for the UI only
+    g_sensor_health.accel_x_g = imu_raw_to_g(x_raw);
+    g_sensor_health.accel_y_g = imu_raw_to_g(y_raw);
+    g_sensor_health.accel_z_g = imu_raw_to_g(z_raw);
+    g_sensor_health.total_accel_g = imu_raw_to_g(total_raw);
     
     // Detect shake during validation (above threshold)
-    if (g_validation_active && total_accel > MINIMUM_SHAKE_THRESHOLD_G) {
+    if (g_validation_active && total_raw > SHAKE_THRESHOLD_RAW) {
+        if (!g_sensor_health.trolley_shake_detected) {
+            deferred_log(DLOG_MSG_SENSOR_SHAKE, g_sensor_health.total_accel_g);
+        }
         g_sensor_health.trolley_shake_detected = true;
-        ESP_LOGI(TAG, "Trolley shake detected! Accel: %.2f g", total_accel);
     }
     
-    // Detect impacts during normal operation
-    if (!g_validation_active && total_accel > IMPACT_THRESHOLD_G) {
-        g_sensor_health.last_impact_g = total_accel;
+    // Detect impacts during normal operation (runs in the control loop - deferred, rate limited).
+    // A unit at rest reads 1 g, so only the deviation from gravity counts as an impact
+    uint32_t dynamic_raw = total_raw > ONE_G_RAW ? total_raw - ONE_G_RAW : ONE_G_RAW - total_raw;
+    if (!g_validation_active && dynamic_raw > IMPACT_THRESHOLD_RAW) {
+        g_sensor_health.last_impact_g = imu_raw_to_g((int32_t)dynamic_raw);
         g_sensor_health.last_impact_time = esp_timer_get_time();
-        ESP_LOGI(TAG, "Impact detected: %.2f g", total_accel);
+        deferred_log(DLOG_MSG_SENSOR_IMPACT, g_sensor_health.last_impact_g);
     }
 }
 
+static int16_t accel_g_to_raw(float value_g) {
+    float raw = value_g * IMU_ACCEL_LSB_PER_G;
+    if (raw > INT16_MAX) return INT16_MAX;
+    if (raw < INT16_MIN) return INT16_MIN;
+    return (int16_t)lroundf(raw);
+}
+
+// Process accelerometer data given in g (float API, same path as the IMU ring)
+void sensor_health_process_accel_data(float x_g, float y_g, float z_g) {
+    int16_t x_raw = accel_g_to_raw(x_g);
+    int16_t y_raw = accel_g_to_raw(y_g);
+    int16_t z_raw = accel_g_to_raw(z_g);
+    sensor_health_process_accel_raw(x_raw, y_raw, z_raw, (uint16_t)fx_magnitude3(x_raw, y_raw, z_raw));
+}
+
 // Validate Hall sensor health
 bool sensor_health_validate_hall_sensor(void) {
-    uint64_t current_time = esp_timer_get_time();
-    
+    // Speed decay after the last pulse is handled by the state estimator
     if (g_sensor_health.last_hall_pulse_time > 0) {
-        uint64_t time_since_last_pulse = current_time - g_sensor_health.last_hall_pulse_time;
-        
-        if (time_since_last_pulse > HALL_PULSE_TIMEOUT_MS * 1000ULL) {
-            // No recent pulses - might be stopped or failed
-            g_sensor_health.current_rpm = 0.0f;
-            g_sensor_health.wheel_speed_ms = 0.0f;
-        }
-        
         return true; // Has received pulses
     }
     
@@ -230,27 +243,32 @@ bool sensor_health_check_command_safety(void) {
     return true;
 }
 
-// Get sensor health status
+// Get sensor health status (tear-free snapshot, safe from any core)
 sensor_health_t sensor_health_get_status(void) {
-    return g_sensor_health;
+    return g_sensor_snapshot.read();
+}
+
+// Get change counter for sensor health status
+uint32_t sensor_health_get_status_generation(void) {
+    return g_sensor_snapshot.generation();
 }
 
 // Check if system is ready
 bool sensor_health_is_system_ready(void) {
-    return g_sensor_health.system_ready;
+    return g_sensor_snapshot.read().system_ready;
 }
 
 // Get initialization message
 const char* sensor_health_get_init_message(void) {
-    if (strlen(g_sensor_health.error_message) > 0) {
-        return g_sensor_health.error_message;
+    if (g_sensor_health.error_text != STATUS_TEXT_NONE) {
+        return status_text_to_string(g_sensor_health.error_text);
     }
-    return g_sensor_health.status_message;
+    return status_text_to_string(g_sensor_health.status_text);
 }
 
 // Get last impact G-force
 float sensor_health_get_last_impact(void) {
-    return g_sensor_health.last_impact_g;
+    return g_sensor_snapshot.read().last_impact_g;
 }
 
 // Reset validation (for testing)
@@ -270,9 +288,10 @@ void sensor_health_reset_validation(void) {
     g_sensor_health.total_accel_g = 0.0f;
     g_sensor_health.last_impact_g = 0.0f;
     
-    strcpy(g_sensor_health.status_message, "");
-    strcpy(g_sensor_health.error_message, "");
+    g_sensor_health.status_text = STATUS_TEXT_NONE;
+    g_sensor_health.error_text = STATUS_TEXT_NONE;
     
     g_validation_active = false;
+    g_sensor_snapshot.publish_from(&g_sensor_health);
     ESP_LOGI(TAG, "Sensor validation reset");
 }
\ No newline at end of file
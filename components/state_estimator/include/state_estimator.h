@@ -0,0 +1,100 @@
+// components/state_estimator/include/state_estimator.h
+#ifndef STATE_ESTIMATOR_H
+#define STATE_ESTIMATOR_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STATE_ESTIMATOR.H - POSITION/VELOCITY ESTIMATE FROM HALL EDGES + ACCELEROMETER
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: One trusted speed/position for every mode
+// - 3-state Kalman filter: position, velocity, accelerometer bias
+// - Predict every control tick with longitudinal IMU acceleration
+// - Correct with Hall position at each edge timestamp
+// - Between edges the wheel cannot have passed the next magnet: speed is
+//   bounded by one pulse distance over the time since the last edge, so a
+//   slowing trolley reads slow instead of holding the last period
+// - No edge for HALL_TIMEOUT_MS = stopped (zero-velocity update, learns bias)
+//
+// Modes read this instead of hardware_get_current_speed()/position()
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Estimator configuration
+#define STATE_EST_IMU_AXIS              0           // Longitudinal accel axis (0=x, 1=y, 2=z)
+#define STATE_EST_IMU_SIGN              1.0f        // +1 if axis points forward, -1 if backward
+#define STATE_EST_IMU_STALE_MS          50          // Hold last accel this long, then drop IMU
+#define STATE_EST_ACCEL_NOISE_MS2       1.5f        // Process noise with IMU input (vibration)
+#define STATE_EST_NO_IMU_NOISE_MS2      4.0f        // Process noise without IMU (unknown accel)
+#define STATE_EST_BIAS_DRIFT_MS2        0.05f       // Bias random walk per sqrt(second)
+#define STATE_EST_HALL_POS_NOISE_M      0.005f      // Magnet position uncertainty at an edge
+#define STATE_EST_STOPPED_VEL_NOISE_MS  0.01f       // Zero-velocity update noise
+#define STATE_EST_EDGE_MARGIN           1.25f       // Slack on the one-pulse-per-gap bound
+
+// Estimated motion state (published every control tick)
+typedef struct {
+    uint64_t timestamp_us;             // Control tick the estimate belongs to
+    float position_m;                  // Direction-signed position (same origin as Hall)
+    float velocity_ms;                 // Signed velocity (+ = forward)
+    float speed_ms;                    // |velocity_ms|
+    float acceleration_ms2;            // Bias-corrected longitudinal acceleration
+    float accel_bias_ms2;              // Learned IMU bias (includes wire slope at rest)
+    float position_sigma_m;            // 1-sigma position uncertainty
+    float velocity_sigma_ms;           // 1-sigma velocity uncertainty
+    bool imu_fused;                    // IMU acceleration used this tick
+    bool stopped;                      // No Hall edge for HALL_TIMEOUT_MS
+    uint32_t hall_updates;             // Hall corrections applied since init
+} state_estimate_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CORE ESTIMATOR API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Reset the filter and attach to the IMU sample ring
+ * @return ESP_OK on success
+ * @note Call after hardware_init() and imu_acquisition_init()
+ */
+esp_err_t state_estimator_init(void);
+
+/**
+ * @brief Control loop estimate stage: predict with IMU, correct with Hall edges
+ * @param dt_us Time since previous call in microseconds
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not initialized
+ * @note Call from the control loop task only, after hardware_sense_update()
+ */
+esp_err_t state_estimator_update(uint32_t dt_us);
+
+/**
+ * @brief Get latest estimate (tear-free snapshot)
+ * @return state_estimate_t structure
+ */
+state_estimate_t state_estimator_get_state(void);
+
+/**
+ * @brief Get estimated speed magnitude
+ * @return Speed in m/s
+ */
+float state_estimator_get_speed(void);
+
+/**
+ * @brief Get estimated position
+ * @return Position in meters (can be negative)
+ */
+float state_estimator_get_position(void);
+
+/**
+ * @brief Get estimated longitudinal acceleration
+ * @return Acceleration in m/s² (+ = speeding up forward)
+ */
+float state_estimator_get_acceleration(void);
+
+/**
+ * @brief Get change counter for the estimate
+ * @return Value that changes whenever a new estimate is published
+ */
+uint32_t state_estimator_get_generation(void);
+
+#endif // STATE_ESTIMATOR_H
@@ -0,0 +1,308 @@
+// components/state_estimator/src/state_estimator.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// STATE_ESTIMATOR.CPP - HALL + IMU KALMAN FILTER (CONTROL LOOP ESTIMATE STAGE)
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// State x = [position, velocity, accel bias], covariance P (3x3, fixed size)
+// - Predict:  p += v dt + (a - b) dt²/2,  v += (a - b) dt,  b random walk
+// - Hall:     position measurement at each edge, propagated to tick time
+// - Gap:      no edge yet → |p - p_edge| and |v| bounded by one pulse distance
+// - Stopped:  no edge for HALL_TIMEOUT_MS → velocity measurement of zero
+//
+// Without IMU samples the bias state is frozen and acceleration becomes
+// process noise (Hall-only constant-velocity filter)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "state_estimator.h"
+#include "hardware_control.h"
+#include "hal_clock.h"
+#include "imu_acquisition.h"
+#include "status_snapshot.h"
+#include "esp_log.h"
+#include <cmath>
+#include <cstring>
+
+static const char* TAG = "STATE_EST";
+
+#define STATE_EST_GRAVITY_MS2       9.80665f
+#define STATE_EST_IMU_READ_MAX      16          // Samples drained per tick (ring keeps the rest)
+#define STATE_EST_ACCEL_LP_ALPHA    0.05f       // Hall-only acceleration smoothing
+
+enum {
+    S_POS = 0,
+    S_VEL = 1,
+    S_BIAS = 2,
+    S_COUNT = 3
+};
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// GLOBAL STATE (control loop task only, published through the snapshot)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static bool g_estimator_initialized = false;
+static float g_x[S_COUNT];
+static float g_P[S_COUNT][S_COUNT];
+
+static imu_reader_t g_imu_reader;
+static imu_sample_t g_imu_buffer[STATE_EST_IMU_READ_MAX];
+static float g_accel_input_ms2 = 0.0f;           // Longitudinal accel input (bias not removed)
+static uint64_t g_last_imu_time = 0;
+
+static float g_last_edge_position_m = 0.0f;
+static uint64_t g_last_edge_time = 0;            // Last edge, or init/reset time
+static bool g_anchor_is_edge = false;            // false = wheel phase unknown (after stop/reset)
+static uint32_t g_seen_position_resets = 0;
+static float g_accel_lp_ms2 = 0.0f;
+
+static state_estimate_t g_estimate = {};
+static status_snapshot<state_estimate_t> g_estimate_snapshot;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FILTER MATH
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void filter_reset(float position_m) {
+    memset(g_x, 0, sizeof(g_x));
+    memset(g_P, 0, sizeof(g_P));
+    g_x[S_POS] = position_m;
+    g_P[S_POS][S_POS] = STATE_EST_HALL_POS_NOISE_M * STATE_EST_HALL_POS_NOISE_M;
+    g_P[S_VEL][S_VEL] = 0.01f;
+    g_P[S_BIAS][S_BIAS] = 0.25f;
+}
+
+static void filter_predict(float dt, bool imu_ok) {
+    float a = imu_ok ? (g_accel_input_ms2 - g_x[S_BIAS]) : 0.0f;
+    g_x[S_POS] += g_x[S_VEL] * dt + 0.5f * a * dt * dt;
+    g_x[S_VEL] += a * dt;
+
+    // Bias only enters the dynamics when it is subtracted from a measurement
+    float F[S_COUNT][S_COUNT] = {
+        {1.0f, dt,   imu_ok ? -0.5f * dt * dt : 0.0f},
+        {0.0f, 1.0f, imu_ok ? -dt : 0.0f},
+        {0.0f, 0.0f, 1.0f}
+    };
+
+    float FP[S_COUNT][S_COUNT];
+    for (int i = 0; i < S_COUNT; i++) {
+        for (int j = 0; j < S_COUNT; j++) {
+            FP[i][j] = F[i][0] * g_P[0][j] + F[i][1] * g_P[1][j] + F[i][2] * g_P[2][j];
+        }
+    }
+    for (int i = 0; i < S_COUNT; i++) {
+        for (int j = 0; j < S_COUNT; j++) {
+            g_P[i][j] = FP[i][0] * F[j][0] + FP[i][1] * F[j][1] + FP[i][2] * F[j][2];
+        }
+    }
+
+    // Acceleration noise enters as white noise on (position, velocity)
+    float q = imu_ok ? STATE_EST_ACCEL_NOISE_MS2 : STATE_EST_NO_IMU_NOISE_MS2;
+    float q2 = q * q;
+    g_P[S_POS][S_POS] += q2 * dt * dt * dt * dt * 0.25f;
+    g_P[S_POS][S_VEL] += q2 * dt * dt * dt * 0.5f;
+    g_P[S_VEL][S_POS] += q2 * dt * dt * dt * 0.5f;
+    g_P[S_VEL][S_VEL] += q2 * dt * dt;
+    if (imu_ok) {
+        g_P[S_BIAS][S_BIAS] += STATE_EST_BIAS_DRIFT_MS2 * STATE_EST_BIAS_DRIFT_MS2 * dt;
+    }
+}
+
+/**
+ * @brief Scalar Kalman correction of one directly measured state
+ * @param index Measured state (H selects it)
+ * @param z Measurement
+ * @param r Measurement variance
+ */
+static void filter_correct(int index, float z, float r) {
+    float innovation = z - g_x[index];
+    float s = g_P[index][index] + r;
+    if (s <= 0.0f) return;
+
+    float k[S_COUNT];
+    float row[S_COUNT];
+    for (int i = 0; i < S_COUNT; i++) {
+        k[i] = g_P[i][index] / s;
+        row[i] = g_P[index][i];
+    }
+    for (int i = 0; i < S_COUNT; i++) {
+        g_x[i] += k[i] * innovation;
+        for (int j = 0; j < S_COUNT; j++) {
+            g_P[i][j] -= k[i] * row[j];
+        }
+    }
+
+    // Keep P symmetric against float round-off
+    for (int i = 0; i < S_COUNT; i++) {
+        for (int j = i + 1; j < S_COUNT; j++) {
+            float avg = 0.5f * (g_P[i][j] + g_P[j][i]);
+            g_P[i][j] = avg;
+            g_P[j][i] = avg;
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MEASUREMENT INPUTS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static bool drain_imu(uint64_t now) {
+    size_t count = imu_acquisition_read(&g_imu_reader, g_imu_buffer, STATE_EST_IMU_READ_MAX);
+    if (count > 0) {
+        int32_t sum_raw = 0;
+        for (size_t i = 0; i < count; i++) {
+            const imu_sample_t* sample = &g_imu_buffer[i];
+            sum_raw += (STATE_EST_IMU_AXIS == 0) ? sample->x_raw :
+                       (STATE_EST_IMU_AXIS == 1) ? sample->y_raw : sample->z_raw;
+        }
+        // IMU delivers in FIFO bursts: the batch mean is held until the next burst
+        g_accel_input_ms2 = STATE_EST_IMU_SIGN * (imu_raw_to_g(sum_raw) / count) * STATE_EST_GRAVITY_MS2;
+        g_last_imu_time = now;
+    }
+
+    return g_last_imu_time > 0 &&
+           (now - g_last_imu_time) <= (STATE_EST_IMU_STALE_MS * 1000ULL);
+}
+
+static void apply_hall_batch(uint64_t now, const hall_batch_t* batch) {
+    // Origin moved by hardware_reset_position(): restart position, keep speed
+    if (batch->position_resets != g_seen_position_resets) {
+        g_seen_position_resets = batch->position_resets;
+        g_x[S_POS] = batch->position_m;
+        for (int i = 0; i < S_COUNT; i++) {
+            g_P[S_POS][i] = 0.0f;
+            g_P[i][S_POS] = 0.0f;
+        }
+        g_P[S_POS][S_POS] = STATE_EST_HALL_POS_NOISE_M * STATE_EST_HALL_POS_NOISE_M;
+        g_last_edge_position_m = batch->position_m;
+        g_last_edge_time = now;
+        g_anchor_is_edge = false;
+    }
+
+    if (batch->new_pulses == 0) return;
+
+    // Edge was captured earlier in this tick - carry it forward to tick time
+    uint64_t edge_time = (batch->newest_edge_us > 0 && batch->newest_edge_us <= now) ?
+                         batch->newest_edge_us : now;
+    float age_s = (now - edge_time) * 1e-6f;
+    float z = batch->position_m + g_x[S_VEL] * age_s;
+
+    // First edge after a stop: the magnet may have been anywhere within one pulse
+    float r = g_anchor_is_edge ? STATE_EST_HALL_POS_NOISE_M * STATE_EST_HALL_POS_NOISE_M :
+              HALL_DISTANCE_PER_PULSE_M * HALL_DISTANCE_PER_PULSE_M / 12.0f;
+    filter_correct(S_POS, z, r);
+
+    g_last_edge_position_m = batch->position_m;
+    g_last_edge_time = edge_time;
+    g_anchor_is_edge = true;
+    g_estimate.hall_updates++;
+}
+
+static bool apply_gap_constraints(uint64_t now) {
+    uint64_t since_edge_us = now - g_last_edge_time;
+
+    if (since_edge_us > (HALL_TIMEOUT_MS * 1000ULL)) {
+        // Stopped: zero-velocity update also pins down the accelerometer bias
+        filter_correct(S_VEL, 0.0f, STATE_EST_STOPPED_VEL_NOISE_MS * STATE_EST_STOPPED_VEL_NOISE_MS);
+        g_anchor_is_edge = false;
+        return true;
+    }
+
+    if (since_edge_us == 0) return false;
+
+    // No edge yet, so the wheel has not reached the next magnet
+    float gap_m = HALL_DISTANCE_PER_PULSE_M * STATE_EST_EDGE_MARGIN;
+    float travelled_m = g_x[S_POS] - g_last_edge_position_m;
+    if (fabsf(travelled_m) > gap_m) {
+        g_x[S_POS] = g_last_edge_position_m + copysignf(gap_m, travelled_m);
+    }
+
+    float max_speed_ms = gap_m / (since_edge_us * 1e-6f);
+    if (fabsf(g_x[S_VEL]) > max_speed_ms) {
+        g_x[S_VEL] = copysignf(max_speed_ms, g_x[S_VEL]);
+    }
+    return false;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t state_estimator_init(void) {
+    hall_batch_t batch = hardware_get_last_hall_batch();
+    uint64_t now = (uint64_t)hal_clock_now_us();
+
+    filter_reset(batch.position_m);
+    imu_acquisition_reader_init(&g_imu_reader);
+    g_accel_input_ms2 = 0.0f;
+    g_last_imu_time = 0;
+    g_last_edge_position_m = batch.position_m;
+    g_last_edge_time = now;
+    g_anchor_is_edge = false;
+    g_seen_position_resets = batch.position_resets;
+    g_accel_lp_ms2 = 0.0f;
+
+    memset(&g_estimate, 0, sizeof(g_estimate));
+    g_estimate.timestamp_us = now;
+    g_estimate.position_m = batch.position_m;
+    g_estimate.stopped = true;
+    g_estimate_snapshot.write(g_estimate);
+
+    g_estimator_initialized = true;
+    ESP_LOGI(TAG, "State estimator initialized (IMU axis %d, %s)", STATE_EST_IMU_AXIS,
+             imu_acquisition_is_running() ? "IMU fused" : "Hall only until IMU samples arrive");
+    return ESP_OK;
+}
+
+esp_err_t state_estimator_update(uint32_t dt_us) {
+    if (!g_estimator_initialized) return ESP_ERR_INVALID_STATE;
+
+    uint64_t now = (uint64_t)hal_clock_now_us();
+    float dt = dt_us * 1e-6f;
+    float previous_velocity = g_x[S_VEL];
+
+    bool imu_ok = drain_imu(now);
+    filter_predict(dt, imu_ok);
+
+    hall_batch_t batch = hardware_get_last_hall_batch();
+    apply_hall_batch(now, &batch);
+    bool stopped = apply_gap_constraints(now);
+
+    // Hall-only acceleration: smoothed velocity derivative
+    if (dt > 0.0f) {
+        float dv = (g_x[S_VEL] - previous_velocity) / dt;
+        g_accel_lp_ms2 += (dv - g_accel_lp_ms2) * STATE_EST_ACCEL_LP_ALPHA;
+    }
+
+    g_estimate.timestamp_us = now;
+    g_estimate.position_m = g_x[S_POS];
+    g_estimate.velocity_ms = g_x[S_VEL];
+    g_estimate.speed_ms = fabsf(g_x[S_VEL]);
+    g_estimate.acceleration_ms2 = imu_ok ? (g_accel_input_ms2 - g_x[S_BIAS]) : g_accel_lp_ms2;
+    g_estimate.accel_bias_ms2 = g_x[S_BIAS];
+    g_estimate.position_sigma_m = sqrtf(fmaxf(g_P[S_POS][S_POS], 0.0f));
+    g_estimate.velocity_sigma_ms = sqrtf(fmaxf(g_P[S_VEL][S_VEL], 0.0f));
+    g_estimate.imu_fused = imu_ok;
+    g_estimate.stopped = stopped;
+    g_estimate_snapshot.write(g_estimate);
+
+    return ESP_OK;
+}
+
+state_estimate_t state_estimator_get_state(void) {
+    return g_estimate_snapshot.read();
+}
+
+float state_estimator_get_speed(void) {
+    return g_estimate_snapshot.read().speed_ms;
+}
+
+float state_estimator_get_position(void) {
+    return g_estimate_snapshot.read().position_m;
+}
+
+float state_estimator_get_acceleration(void) {
+    return g_estimate_snapshot.read().acceleration_ms2;
+}
+
+uint32_t state_estimator_get_generation(void) {
+    return g_estimate_snapshot.generation();
+}
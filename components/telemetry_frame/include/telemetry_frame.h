@@ -0,0 +1,164 @@
+// components/telemetry_frame/include/telemetry_frame.h
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// TELEMETRY_FRAME.H - VERSIONED BINARY TELEMETRY RECORD
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: One compact record format for every telemetry sink
+// - 26-byte packed little-endian record: timestamp, quantized motion, ESC duty,
+//   mode/state enums, accelerations, flag bits (vs ~900 bytes of status JSON)
+// - Captured by the control loop at TELEMETRY_CAPTURE_RATE_HZ into a ring
+//   that any number of readers drain at their own pace (WebSocket push,
+//   serial stream, flight recorder); a slow reader loses records, it never
+//   blocks the writer
+// - Capture is integer quantization of values already in RAM: no formatting
+//
+// Layout changes bump TELEMETRY_FRAME_VERSION; decoders reject unknown versions.
+// The JS decoder in web_interface_main.cpp mirrors this layout.
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Record configuration
+#define TELEMETRY_FRAME_VERSION         1           // Layout version (first byte of every record)
+#define TELEMETRY_FRAME_SIZE            26          // Encoded bytes per record
+#define TELEMETRY_CAPTURE_RATE_HZ       250         // Records per second from the control loop
+#define TELEMETRY_RING_SIZE             512         // Records kept (power of 2, ~2 s)
+
+// Serial framing: sync word + record + CRC-8 (poly 0x07) over the record
+#define TELEMETRY_SERIAL_SYNC_0         0xA5
+#define TELEMETRY_SERIAL_SYNC_1         0x5A
+#define TELEMETRY_SERIAL_FRAME_SIZE     (TELEMETRY_FRAME_SIZE + 3)
+
+// flags
+#define TELEMETRY_FLAG_ESC_ARMED        (1u << 0)
+#define TELEMETRY_FLAG_FORWARD          (1u << 1)   // Commanded direction
+#define TELEMETRY_FLAG_CLOSED_LOOP      (1u << 2)   // Speed controller feedback active
+#define TELEMETRY_FLAG_SATURATED        (1u << 3)   // Controller output clamped
+#define TELEMETRY_FLAG_IMU_FUSED        (1u << 4)   // Estimator used IMU this tick
+#define TELEMETRY_FLAG_STOPPED          (1u << 5)   // No Hall edge for HALL_TIMEOUT_MS
+#define TELEMETRY_FLAG_HALL_HEALTHY     (1u << 6)
+#define TELEMETRY_FLAG_IMPACT           (1u << 7)   // New impact since previous record
+
+// system_flags
+#define TELEMETRY_SYS_READY             (1u << 0)   // Hardware + sensors ready
+#define TELEMETRY_SYS_SENSORS_VALIDATED (1u << 1)
+#define TELEMETRY_SYS_WIRE_LEARNED      (1u << 2)   // Wire learning complete
+
+// Record layout (wire format: ESP32 is little-endian, the struct is stored as is)
+typedef struct __attribute__((packed)) {
+    uint8_t version;                   // TELEMETRY_FRAME_VERSION
+    uint8_t flags;                     // TELEMETRY_FLAG_*
+    uint16_t sequence;                 // Record counter (gaps = lost records)
+    uint32_t timestamp_us;             // esp_timer time, wraps every ~71 minutes
+    int32_t position_mm;               // Estimated position
+    int16_t velocity_mm_s;             // Estimated signed velocity
+    int16_t target_mm_s;               // Commanded speed (signed by direction)
+    uint16_t esc_duty;                 // Absolute LEDC duty applied
+    int16_t accel_mg;                  // Estimated longitudinal acceleration (milli-g)
+    uint16_t accel_total_mg;           // Accelerometer magnitude (milli-g)
+    uint8_t mode;                      // trolley_operation_mode_t
+    uint8_t mode_state;                // Active mode's state enum (0 when no mode)
+    uint8_t sensor_status;             // Hall sensor_status_t | accel sensor_status_t << 4
+    uint8_t system_flags;              // TELEMETRY_SYS_*
+} telemetry_frame_t;
+
+// Independent cursor into the capture ring (one per consumer)
+typedef struct {
+    uint32_t next;                     // Next record number to read
+    uint32_t lost;                     // Records overwritten before this reader got them
+} telemetry_reader_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CAPTURE API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Reset the capture ring
+ * @return ESP_OK on success
+ */
+esp_err_t telemetry_frame_init(void);
+
+/**
+ * @brief Build a record from the current published state and append it to the ring
+ * @note Control loop task only (single writer), call at TELEMETRY_CAPTURE_RATE_HZ
+ */
+void telemetry_frame_capture(void);
+
+/**
+ * @brief Get the newest captured record
+ * @param frame Output record
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if nothing captured yet
+ */
+esp_err_t telemetry_frame_get_latest(telemetry_frame_t* frame);
+
+/**
+ * @brief Get total records captured since init
+ * @return Record count
+ */
+uint32_t telemetry_frame_get_capture_count(void);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// READER API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Attach a reader at the newest record (older records are not replayed)
+ * @param reader Reader to initialize
+ */
+void telemetry_reader_init(telemetry_reader_t* reader);
+
+/**
+ * @brief Copy records captured since the previous read, oldest first
+ * @param reader Reader cursor (advanced)
+ * @param frames Output records
+ * @param max_frames Capacity of frames
+ * @return Number of records copied (remaining ones are returned next call)
+ */
+size_t telemetry_reader_read(telemetry_reader_t* reader, telemetry_frame_t* frames, size_t max_frames);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// ENCODE / DECODE API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Encode one record
+ * @param frame Record
+ * @param out Output buffer
+ * @param size Output buffer size
+ * @return Bytes written (TELEMETRY_FRAME_SIZE), 0 if out is too small
+ */
+size_t telemetry_frame_encode(const telemetry_frame_t* frame, uint8_t* out, size_t size);
+
+/**
+ * @brief Encode one record with serial framing (sync word + record + CRC-8)
+ * @param frame Record
+ * @param out Output buffer
+ * @param size Output buffer size
+ * @return Bytes written (TELEMETRY_SERIAL_FRAME_SIZE), 0 if out is too small
+ */
+size_t telemetry_frame_encode_serial(const telemetry_frame_t* frame, uint8_t* out, size_t size);
+
+/**
+ * @brief Decode one record
+ * @param data Encoded record
+ * @param length Bytes available
+ * @param frame Output record
+ * @return ESP_OK, ESP_ERR_INVALID_SIZE if too short, ESP_ERR_INVALID_VERSION if layout unknown
+ */
+esp_err_t telemetry_frame_decode(const uint8_t* data, size_t length, telemetry_frame_t* frame);
+
+/**
+ * @brief CRC-8 (poly 0x07, init 0) used by the serial framing
+ * @param data Bytes
+ * @param length Byte count
+ * @return CRC value
+ */
+uint8_t telemetry_frame_crc8(const uint8_t* data, size_t length);
+
+#endif // TELEMETRY_FRAME_H
@@ -0,0 +1,248 @@
+// components/telemetry_frame/src/telemetry_frame.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// TELEMETRY_FRAME.CPP - RECORD CAPTURE, MULTI-READER RING, ENCODE/DECODE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "telemetry_frame.h"
+#include "hardware_control.h"
+#include "sensor_health.h"
+#include "state_estimator.h"
+#include "mode_coordinator.h"
+#include "wire_learning_mode.h"
+#include "automatic_mode.h"
+#include "manual_mode.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <atomic>
+#include <cstring>
+#include <cmath>
+
+static const char* TAG = "TELEMETRY";
+
+static_assert(sizeof(telemetry_frame_t) == TELEMETRY_FRAME_SIZE, "telemetry record layout changed");
+static_assert((TELEMETRY_RING_SIZE & (TELEMETRY_RING_SIZE - 1)) == 0, "ring size must be a power of 2");
+
+#define TELEMETRY_RING_MASK     (TELEMETRY_RING_SIZE - 1)
+#define STANDARD_GRAVITY_MS2    9.80665f
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// GLOBAL STATE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Single writer (control loop), readers copy and then check they were not lapped
+static telemetry_frame_t g_ring[TELEMETRY_RING_SIZE];
+static std::atomic<uint32_t> g_head{0};         // Records written since init
+
+// Owned by the control loop task
+static uint64_t g_last_impact_time = 0;
+static bool g_impact_primed = false;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// QUANTIZATION HELPERS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static inline int16_t quantize_i16(float value, float scale) {
+    long q = lroundf(value * scale);
+    if (q > INT16_MAX) return INT16_MAX;
+    if (q < INT16_MIN) return INT16_MIN;
+    return (int16_t)q;
+}
+
+static inline uint16_t quantize_u16(float value, float scale) {
+    long q = lroundf(value * scale);
+    if (q > UINT16_MAX) return UINT16_MAX;
+    if (q < 0) return 0;
+    return (uint16_t)q;
+}
+
+static inline int32_t quantize_i32(float value, float scale) {
+    float q = roundf(value * scale);
+    if (q >= 2147483520.0f) return INT32_MAX;
+    if (q <= -2147483520.0f) return INT32_MIN;
+    return (int32_t)q;
+}
+
+static uint8_t active_mode_state(trolley_operation_mode_t mode) {
+    switch (mode) {
+        case TROLLEY_MODE_WIRE_LEARNING: return (uint8_t)wire_learning_mode_get_state();
+        case TROLLEY_MODE_AUTOMATIC:     return (uint8_t)automatic_mode_get_state();
+        case TROLLEY_MODE_MANUAL:        return (uint8_t)manual_mode_get_state();
+        default:                         return 0;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CAPTURE API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t telemetry_frame_init(void) {
+    memset(g_ring, 0, sizeof(g_ring));
+    g_head.store(0, std::memory_order_release);
+    g_impact_primed = false;
+
+    ESP_LOGI(TAG, "Telemetry v%d: %d-byte records at %d Hz, %d-record ring",
+             TELEMETRY_FRAME_VERSION, TELEMETRY_FRAME_SIZE,
+             TELEMETRY_CAPTURE_RATE_HZ, TELEMETRY_RING_SIZE);
+    return ESP_OK;
+}
+
+void telemetry_frame_capture(void) {
+    state_estimate_t estimate = state_estimator_get_state();
+    hardware_status_t hw = hardware_get_status();
+    speed_controller_status_t controller = hardware_get_speed_controller_status();
+    sensor_health_t sensors = sensor_health_get_status();
+    trolley_operation_mode_t mode = mode_coordinator_get_current_mode();
+
+    uint32_t n = g_head.load(std::memory_order_relaxed);
+    telemetry_frame_t* frame = &g_ring[n & TELEMETRY_RING_MASK];
+
+    uint8_t flags = 0;
+    if (hw.esc_armed)               flags |= TELEMETRY_FLAG_ESC_ARMED;
+    if (hw.direction_forward)       flags |= TELEMETRY_FLAG_FORWARD;
+    if (controller.closed_loop)     flags |= TELEMETRY_FLAG_CLOSED_LOOP;
+    if (controller.saturated)       flags |= TELEMETRY_FLAG_SATURATED;
+    if (estimate.imu_fused)         flags |= TELEMETRY_FLAG_IMU_FUSED;
+    if (estimate.stopped)           flags |= TELEMETRY_FLAG_STOPPED;
+    if (hw.hall_sensor_healthy)     flags |= TELEMETRY_FLAG_HALL_HEALTHY;
+
+    // Impact is an event: flagged once per new impact timestamp
+    if (sensors.last_impact_time != g_last_impact_time) {
+        if (g_impact_primed) flags |= TELEMETRY_FLAG_IMPACT;
+        g_last_impact_time = sensors.last_impact_time;
+    }
+    g_impact_primed = true;
+
+    uint8_t system_flags = 0;
+    if (hw.system_initialized && sensors.system_ready) system_flags |= TELEMETRY_SYS_READY;
+    if (sensors.sensors_validated)                     system_flags |= TELEMETRY_SYS_SENSORS_VALIDATED;
+    if (wire_learning_mode_is_complete())              system_flags |= TELEMETRY_SYS_WIRE_LEARNED;
+
+    uint64_t timestamp_us = estimate.timestamp_us ? estimate.timestamp_us : (uint64_t)esp_timer_get_time();
+    float target_ms = hw.direction_forward ? hw.target_speed_ms : -hw.target_speed_ms;
+
+    frame->version = TELEMETRY_FRAME_VERSION;
+    frame->flags = flags;
+    frame->sequence = (uint16_t)n;
+    frame->timestamp_us = (uint32_t)timestamp_us;
+    frame->position_mm = quantize_i32(estimate.position_m, 1000.0f);
+    frame->velocity_mm_s = quantize_i16(estimate.velocity_ms, 1000.0f);
+    frame->target_mm_s = quantize_i16(target_ms, 1000.0f);
+    frame->esc_duty = hw.current_esc_duty;
+    frame->accel_mg = quantize_i16(estimate.acceleration_ms2, 1000.0f / STANDARD_GRAVITY_MS2);
+    frame->accel_total_mg = quantize_u16(sensors.total_accel_g, 1000.0f);
+    frame->mode = (uint8_t)mode;
+    frame->mode_state = active_mode_state(mode);
+    frame->sensor_status = (uint8_t)((sensors.hall_status & 0x0F) | ((sensors.accel_status & 0x0F) << 4));
+    frame->system_flags = system_flags;
+
+    g_head.store(n + 1, std::memory_order_release);
+}
+
+esp_err_t telemetry_frame_get_latest(telemetry_frame_t* frame) {
+    if (frame == NULL) return ESP_ERR_INVALID_ARG;
+
+    telemetry_reader_t reader;
+    reader.lost = 0;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        uint32_t head = g_head.load(std::memory_order_acquire);
+        if (head == 0) return ESP_ERR_NOT_FOUND;
+        reader.next = head - 1;
+        if (telemetry_reader_read(&reader, frame, 1) == 1) return ESP_OK;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+uint32_t telemetry_frame_get_capture_count(void) {
+    return g_head.load(std::memory_order_relaxed);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// READER API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void telemetry_reader_init(telemetry_reader_t* reader) {
+    if (reader == NULL) return;
+    reader->next = g_head.load(std::memory_order_acquire);
+    reader->lost = 0;
+}
+
+size_t telemetry_reader_read(telemetry_reader_t* reader, telemetry_frame_t* frames, size_t max_frames) {
+    if (reader == NULL || frames == NULL || max_frames == 0) return 0;
+
+    uint32_t head = g_head.load(std::memory_order_acquire);
+    if ((int32_t)(head - reader->next) < 0) {
+        reader->next = head;            // Ring was reset under this reader
+    }
+
+    // Fell more than a ring behind: skip to the oldest record still intact
+    uint32_t available = head - reader->next;
+    if (available > TELEMETRY_RING_SIZE - 1) {
+        uint32_t skip = available - (TELEMETRY_RING_SIZE - 1);
+        reader->lost += skip;
+        reader->next += skip;
+        available -= skip;
+    }
+
+    size_t count = available < max_frames ? available : max_frames;
+    for (size_t i = 0; i < count; i++) {
+        frames[i] = g_ring[(reader->next + i) & TELEMETRY_RING_MASK];
+    }
+
+    // The writer may have lapped the copy: its current slot and older are suspect
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t head_after = g_head.load(std::memory_order_acquire);
+    uint32_t oldest_intact = head_after - (TELEMETRY_RING_SIZE - 1);
+    if (head_after >= TELEMETRY_RING_SIZE - 1 && (int32_t)(oldest_intact - reader->next) > 0) {
+        size_t torn = oldest_intact - reader->next;
+        if (torn >= count) {
+            reader->lost += oldest_intact - reader->next;
+            reader->next = oldest_intact;
+            return 0;
+        }
+        memmove(frames, frames + torn, (count - torn) * sizeof(telemetry_frame_t));
+        reader->lost += torn;
+        reader->next += torn;
+        count -= torn;
+    }
+
+    reader->next += count;
+    return count;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// ENCODE / DECODE API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+uint8_t telemetry_frame_crc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+size_t telemetry_frame_encode(const telemetry_frame_t* frame, uint8_t* out, size_t size) {
+    if (frame == NULL || out == NULL || size < TELEMETRY_FRAME_SIZE) return 0;
+    memcpy(out, frame, TELEMETRY_FRAME_SIZE);
+    return TELEMETRY_FRAME_SIZE;
+}
+
+size_t telemetry_frame_encode_serial(const telemetry_frame_t* frame, uint8_t* out, size_t size) {
+    if (frame == NULL || out == NULL || size < TELEMETRY_SERIAL_FRAME_SIZE) return 0;
+    out[0] = TELEMETRY_SERIAL_SYNC_0;
+    out[1] = TELEMETRY_SERIAL_SYNC_1;
+    memcpy(out + 2, frame, TELEMETRY_FRAME_SIZE);
+    out[2 + TELEMETRY_FRAME_SIZE] = telemetry_frame_crc8(out + 2, TELEMETRY_FRAME_SIZE);
+    return TELEMETRY_SERIAL_FRAME_SIZE;
+}
+
+esp_err_t telemetry_frame_decode(const uint8_t* data, size_t length, telemetry_frame_t* frame) {
+    if (data == NULL || frame == NULL) return ESP_ERR_INVALID_ARG;
+    if (length < TELEMETRY_FRAME_SIZE) return ESP_ERR_INVALID_SIZE;
+    if (data[0] != TELEMETRY_FRAME_VERSION) return ESP_ERR_INVALID_VERSION;
+    memcpy(frame, data, TELEMETRY_FRAME_SIZE);
+    return ESP_OK;
+}
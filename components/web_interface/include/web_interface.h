@@ -3,6 +3,7 @@
 
 #include "esp_err.h"
 #include "esp_http_server.h"
+#include "command_queue.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -15,7 +16,7 @@
 // - Web page generation and serving
 // - Command routing to mode_coordinator
 // - Status JSON generation for real-time updates
-// - WebSocket support for live data (optional future)
+// - WebSocket telemetry push and commands (/ws)
 // 
 // Uses: mode_coordinator (for commands), all mode components (for status)
 // Called by: main.cpp
@@ -27,18 +28,30 @@
 
 // HTTP server configuration
 #define WEB_SERVER_PORT                 80        // HTTP server port
-#define WEB_MAX_OPEN_SOCKETS           7         // Maximum concurrent connections
+#define WEB_MAX_OPEN_SOCKETS           12        // Maximum concurrent connections (+3 httpd internal <= CONFIG_LWIP_MAX_SOCKETS)
+#define WEB_WIFI_MAX_STATIONS          8         // Phones/laptops on the AP at once
 #define WEB_RESPONSE_TIMEOUT_MS        5000      // Response timeout
 #define WEB_REQUEST_TIMEOUT_MS         10000     // Request timeout
 
 // Content configuration
 #define WEB_HTML_BUFFER_SIZE           8192      // HTML content buffer size
-#define WEB_JSON_BUFFER_SIZE           2048      // JSON response buffer size
+#define WEB_JSON_BUFFER_SIZE           2048      // JSON response buffer size (status cache)
+#define WEB_JSON_CHUNK_SIZE            512       // Streaming JSON chunk size
+#define WEB_STATUS_QUERY_SIZE          256       // Max /api/status query string (?fields=)
 #define WEB_COMMAND_BUFFER_SIZE        256       // Command buffer size
+#define WEB_COMMAND_RESULT_SIZE        320       // One command outcome as JSON
 #define WEB_STATUS_UPDATE_INTERVAL_MS  1000      // Status update interval
 
-// Security and rate limiting
-#define WEB_MAX_COMMANDS_PER_MINUTE    60        // Command rate limiting
+// Slow GETs (status, perf, incidents) run on a worker pool so the httpd task stays free for commands
+#define WEB_ASYNC_WORKERS              2         // Worker tasks
+#define WEB_ASYNC_WORKER_STACK         6144      // Per worker (largest handler: incident list, 2 KB JSON)
+#define WEB_ASYNC_WORKER_PRIORITY      5         // Same as the httpd task
+#define WEB_ASYNC_WORKER_CORE          0         // With WiFi and httpd
+
+// Security and rate limiting (token bucket per client address)
+#define WEB_MAX_COMMANDS_PER_MINUTE    120       // Sustained commands per client
+#define WEB_COMMAND_BURST              20        // Commands a client may send back to back
+#define WEB_RATE_CLIENT_SLOTS          16        // Clients tracked (power of 2; least recent evicted)
 #define WEB_MAX_CONCURRENT_COMMANDS    3         // Concurrent command limit
 #define WEB_COMMAND_TIMEOUT_MS         5000      // Individual command timeout
 
@@ -47,6 +60,21 @@
 #define WEB_STATUS_CACHE_TIME_MS       1000      // Status caching time
 #define WEB_ERROR_DISPLAY_TIME_MS      5000      // Error message display time
 
+// WebSocket telemetry (needs CONFIG_HTTPD_WS_SUPPORT)
+#define WEB_WS_URI                     "/ws"     // Telemetry + command socket
+#define WEB_WS_MAX_CLIENTS             4         // Telemetry subscribers
+#define WEB_WS_MAX_RX_SIZE             64        // Largest accepted command frame
+#define WEB_TELEMETRY_DEFAULT_HZ       20        // Push rate
+#define WEB_TELEMETRY_MIN_HZ           10        // Slowest configurable push rate
+#define WEB_TELEMETRY_MAX_HZ           50        // Fastest configurable push rate
+#define WEB_TELEMETRY_KEYFRAME_MS      1000      // Full frame interval (deltas in between)
+#define WEB_TELEMETRY_FRAME_SIZE       1024      // Frame buffer (JSON delta or binary batch)
+#define WEB_TELEMETRY_MAX_BATCH        32        // Binary records per message (fits FRAME_SIZE)
+#define WEB_TELEMETRY_FRAME_SLOTS      3         // Frames queued to the httpd task
+#define WEB_TELEMETRY_TASK_STACK       4096      // Telemetry task stack size
+#define WEB_TELEMETRY_TASK_PRIORITY    4         // Below the httpd task
+#define WEB_TELEMETRY_TASK_CORE        0         // With WiFi and httpd
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // WEB INTERFACE DATA STRUCTURES
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -83,6 +111,11 @@ typedef struct {
     uint32_t failed_requests;           // Failed requests
     uint32_t commands_executed;         // Commands executed via web
     uint32_t status_requests;           // Status page requests
+    uint32_t status_cache_hits;         // Status requests served from the cached document
+    uint32_t asset_not_modified;        // UI asset requests answered 304 (ETag still current)
+    uint32_t async_requests;            // Requests handed to the worker pool
+    uint32_t async_rejected;            // Answered 503: every worker busy
+    uint32_t rate_limited_commands;     // Commands refused by a client's token bucket
     uint32_t active_connections;        // Current active connections
     uint32_t max_concurrent_connections; // Peak concurrent connections
     uint64_t server_start_time;         // Server start timestamp
@@ -100,9 +133,24 @@ typedef struct {
     bool enable_rate_limiting;          // Enable request rate limiting
     bool enable_command_logging;        // Log all commands
     bool enable_real_time_updates;      // Enable real-time status updates
+    uint8_t telemetry_rate_hz;          // WebSocket push rate (0 = default)
     char server_name[32];               // Server identification name
 } web_interface_config_t;
 
+/**
+ * @brief WebSocket telemetry statistics
+ */
+typedef struct {
+    bool supported;                     // Built with CONFIG_HTTPD_WS_SUPPORT
+    bool enabled;                       // Pushing frames to subscribers
+    uint32_t rate_hz;                   // Current push rate
+    uint32_t subscribers;               // Open telemetry sockets
+    uint32_t frames_rendered;           // Frames rendered (once per tick, all clients)
+    uint32_t frames_sent;               // Per-client frame sends
+    uint32_t frames_dropped;            // Ticks skipped, httpd still sending older frames
+    uint32_t commands_received;         // Commands received over the socket
+} web_telemetry_stats_t;
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // CORE WEB INTERFACE API
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -196,6 +244,14 @@ esp_err_t web_handler_api_info(httpd_req_t *req);
  */
 esp_err_t web_handler_stats(httpd_req_t *req);
 
+/**
+ * @brief WebSocket handler (telemetry subscription and commands)
+ * @param req HTTP request (GET = handshake, otherwise a received frame)
+ * @note Text frames: "rate=N", "fmt=bin" (telemetry_frame_t batches), "fmt=json", or a command
+ * @return ESP_OK on success, error code closes the socket
+ */
+esp_err_t web_handler_ws(httpd_req_t *req);
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // CONTENT GENERATION API
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -212,10 +268,63 @@ esp_err_t web_generate_main_page(char* html_buffer, size_t buffer_size);
  * @brief Generate system status JSON
  * @param json_buffer Buffer to write JSON content
  * @param buffer_size Size of JSON buffer
- * @return ESP_OK on success, error code on failure
+ * @return ESP_OK on success, ESP_ERR_INVALID_SIZE if the document does not fit
  */
 esp_err_t web_generate_status_json(char* json_buffer, size_t buffer_size);
 
+/**
+ * @brief Send system status JSON as the response to req
+ * @param req HTTP request (?fields=name,group,... selects fields; groups are
+ *            system, sensors, availability, hall, accel, hardware, wire, auto, manual)
+ * @param cache_hit Set true if the cached document was reused (may be NULL)
+ * @return ESP_OK on success, error code on failure
+ * @note Full documents come from a cache keyed on the status generations;
+ *       filtered documents are streamed chunked straight from the snapshots
+ */
+esp_err_t web_send_status_json(httpd_req_t* req, bool* cache_hit);
+
+/**
+ * @brief Create the status document cache
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the mutex cannot be created
+ */
+esp_err_t web_status_cache_init(void);
+
+/**
+ * @brief Send the flight recorder state and stored incident list as JSON
+ * @param req HTTP request
+ * @return ESP_OK on success, error code on failure
+ */
+esp_err_t web_send_incident_list(httpd_req_t* req);
+
+/**
+ * @brief Stream one stored incident (?id=N) as application/octet-stream
+ * @param req HTTP request
+ * @return ESP_OK on success, ESP_FAIL if id is missing/unknown or flash read fails
+ */
+esp_err_t web_send_incident(httpd_req_t* req);
+
+/**
+ * @brief Send the perf_monitor report (probe histograms, task stacks) as JSON
+ * @param req HTTP request (?reset=1 clears the histograms afterwards)
+ * @return ESP_OK on success, error code on failure
+ */
+esp_err_t web_send_perf_json(httpd_req_t* req);
+
+/**
+ * @brief Send this unit, the fleet peers and the newest relay results as JSON
+ * @param req HTTP request
+ * @return ESP_OK on success, error code on failure
+ */
+esp_err_t web_send_fleet_json(httpd_req_t* req);
+
+/**
+ * @brief Relay the command in the POST body (unit=<hex|all>&cmd=X[&start_ms=N])
+ * @param req HTTP request
+ * @param relayed Set true if fleet_link accepted the relay (may be NULL)
+ * @return ESP_OK if answered, ESP_FAIL on a bad or rate-limited request
+ */
+esp_err_t web_send_fleet_command(httpd_req_t* req, bool* relayed);
+
 /**
  * @brief Generate command response JSON
  * @param success Command execution success status
@@ -254,10 +363,54 @@ esp_err_t web_generate_api_info_json(char* json_buffer, size_t buffer_size);
  * @param response_buffer Buffer for response message
  * @param buffer_size Size of response buffer
  * @return ESP_OK on success, error code on failure
+ * @note Same as web_submit_command() without the command ID
  */
 esp_err_t web_process_command(char command_char, const char* client_ip,
                              char* response_buffer, size_t buffer_size);
 
+/**
+ * @brief Process web command; manual and emergency commands go to command_queue
+ * @param command_char Single character command
+ * @param client_ip Client IP address for logging
+ * @param response_buffer Buffer for response message
+ * @param buffer_size Size of response buffer
+ * @param command_id Set to the queued command ID, 0 if it ran here (may be NULL)
+ * @return ESP_OK if executed or queued, error code on failure
+ * @note A queued command's outcome arrives later: poll GET /api/command?id=N
+ *       or watch for the WebSocket "cmd" event
+ */
+esp_err_t web_submit_command(char command_char, const char* client_ip,
+                             char* response_buffer, size_t buffer_size, uint32_t* command_id);
+
+/**
+ * @brief Process a text command: a command letter, then its argument if it takes one
+ * @param text Command text ("L<site id>" selects a site, any other text is its first letter)
+ * @param client_ip Client IP address for logging
+ * @param response_buffer Buffer for response message
+ * @param buffer_size Size of response buffer
+ * @param command_id Set to the queued command ID, 0 if it ran here (may be NULL)
+ * @return ESP_OK if executed or queued, error code on failure
+ * @note POST /api/command bodies, WebSocket commands and the serial console come through here
+ */
+esp_err_t web_submit_command_text(const char* text, const char* client_ip,
+                                  char* response_buffer, size_t buffer_size, uint32_t* command_id);
+
+/**
+ * @brief Render a queued command's outcome as JSON (poll reply and push body)
+ * @param result Outcome from command_queue
+ * @param json_buffer Buffer to write JSON
+ * @param buffer_size Size of JSON buffer (WEB_COMMAND_RESULT_SIZE fits)
+ * @return Length written, 0 if it does not fit
+ */
+size_t web_format_command_result(const command_result_t* result, char* json_buffer, size_t buffer_size);
+
+/**
+ * @brief Send one queued command's outcome (?id=N) as JSON
+ * @param req HTTP request
+ * @return ESP_OK on success, ESP_FAIL if id is missing or no longer known
+ */
+esp_err_t web_send_command_result(httpd_req_t* req);
+
 /**
  * @brief Validate web command before processing
  * @param command_char Command to validate
@@ -266,6 +419,12 @@ esp_err_t web_process_command(char command_char, const char* client_ip,
  */
 bool web_validate_command(char command_char, const char* client_ip);
 
+/**
+ * @brief Accept or refuse commands (the UI comes up before the control path)
+ * @param ready true once every subsystem a command may touch is initialized
+ */
+void web_set_commands_ready(bool ready);
+
 /**
  * @brief Log command execution for security/debugging
  * @param command_char Executed command
@@ -285,21 +444,85 @@ esp_err_t web_log_command(char command_char, const char* client_ip,
  */
 esp_err_t web_get_command_help(char* help_buffer, size_t buffer_size);
 
+// ═══════════════════════════════════════════════════════════════════════════════
+// ASYNC REQUEST API (worker pool)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Request handler signature carried in user_ctx
+ */
+typedef esp_err_t (*web_request_handler_t)(httpd_req_t *req);
+
+/**
+ * @brief Start the worker tasks (once, before the server registers handlers)
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if a task cannot be created
+ */
+esp_err_t web_async_init(void);
+
+/**
+ * @brief URI handler that runs the handler in user_ctx on a worker
+ * @param req Request whose user_ctx is a web_request_handler_t
+ * @return ESP_OK once handed off (or answered 503 when every worker is busy)
+ * @note Register as {.handler = web_async_handler, .user_ctx = (void*)real_handler}
+ */
+esp_err_t web_async_handler(httpd_req_t *req);
+
+/**
+ * @brief Number of requests handed to workers and refused as busy
+ * @param dispatched Set to requests handed off (may be NULL)
+ * @param rejected Set to requests answered 503 (may be NULL)
+ */
+void web_async_get_counts(uint32_t* dispatched, uint32_t* rejected);
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // SECURITY AND RATE LIMITING API
 // ═══════════════════════════════════════════════════════════════════════════════
+//
+// One token bucket per client IPv4 address, WEB_COMMAND_BURST deep and
+// refilled at WEB_MAX_COMMANDS_PER_MINUTE, in a fixed hash table: a busy
+// client runs out of tokens without touching anyone else's. Emergency stops
+// are never rate limited.
+
+/**
+ * @brief Initialize the client table (called by web_interface_init)
+ * @return ESP_OK on success
+ */
+esp_err_t web_rate_limit_init(void);
+
+/**
+ * @brief Peer IPv4 address of a socket
+ * @param sockfd Socket (httpd_req_to_sockfd())
+ * @param ip Set to dotted quad, "" if unknown (may be NULL)
+ * @param ip_size Size of ip
+ * @return Address in network byte order, 0 if unknown
+ */
+uint32_t web_get_peer_address(int sockfd, char* ip, size_t ip_size);
 
 /**
- * @brief Check if client is rate limited
+ * @brief Take one command token from a client's bucket
+ * @param client_addr Address from web_get_peer_address() (0 = unknown, shares one bucket)
+ * @param command_char Command about to be submitted ('E' is always allowed, free)
+ * @return true if allowed, false if the client is rate limited or blocked
+ */
+bool web_rate_limit_allow_command(uint32_t client_addr, char command_char);
+
+/**
+ * @brief Commands refused by rate limiting since boot
+ * @return Refusal count
+ */
+uint32_t web_rate_limit_get_refused(void);
+
+/**
+ * @brief Check if client is rate limited (bucket empty or blocked)
  * @param client_ip Client IP address
  * @return true if rate limited, false if allowed
  */
 bool web_is_client_rate_limited(const char* client_ip);
 
 /**
- * @brief Update rate limiting for client
+ * @brief Take one command token from a client's bucket
  * @param client_ip Client IP address
- * @return ESP_OK on success
+ * @return ESP_OK if allowed, ESP_ERR_INVALID_STATE if rate limited, ESP_ERR_INVALID_ARG for a bad address
  */
 esp_err_t web_update_rate_limiting(const char* client_ip);
 
@@ -358,8 +581,48 @@ bool web_wifi_is_ap_running(void);
 uint8_t web_wifi_get_client_count(void);
 
 // ═══════════════════════════════════════════════════════════════════════════════
-// REAL-TIME UPDATES API (Future WebSocket Support)
+// REAL-TIME UPDATES API (WebSocket /ws)
 // ═══════════════════════════════════════════════════════════════════════════════
+//
+// One telemetry task renders a compact JSON frame per tick and queues it to
+// the httpd task, which sends the same bytes to every subscriber. Frames carry
+// only fields that changed ("k":1 marks a full keyframe):
+//   t = ms timestamp, p = position m, v = speed m/s, g = target m/s,
+//   m = mode, ms = mode state, a = ESC armed, imp = impact g (event)
+// Text frames received on the socket are commands: one command character
+// (same set as POST /api/command) or "rate=<hz>".
+
+/**
+ * @brief Create telemetry locks (call from web_interface_init)
+ * @return ESP_OK on success, ESP_ERR_NO_MEM on failure
+ */
+esp_err_t web_telemetry_init(void);
+
+/**
+ * @brief Register /ws on a running server and start the telemetry task
+ * @param server Running httpd instance
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED without CONFIG_HTTPD_WS_SUPPORT
+ */
+esp_err_t web_telemetry_start(httpd_handle_t server);
+
+/**
+ * @brief Drop all subscribers and detach from the server
+ * @return ESP_OK on success
+ */
+esp_err_t web_telemetry_stop(void);
+
+/**
+ * @brief Set telemetry push rate
+ * @param rate_hz Rate, clamped to WEB_TELEMETRY_MIN_HZ..WEB_TELEMETRY_MAX_HZ
+ * @return ESP_OK on success
+ */
+esp_err_t web_telemetry_set_rate(uint32_t rate_hz);
+
+/**
+ * @brief Get telemetry statistics
+ * @return web_telemetry_stats_t structure
+ */
+web_telemetry_stats_t web_telemetry_get_stats(void);
 
 /**
  * @brief Enable real-time status updates for clients
@@ -371,22 +634,23 @@ esp_err_t web_enable_real_time_updates(bool enable);
 /**
  * @brief Send real-time update to all connected clients
  * @param update_type Type of update (status, mode_change, error, etc.)
- * @param data Update data in JSON format
- * @return ESP_OK on success
+ * @param data Update data in JSON format (NULL for none)
+ * @return ESP_OK if queued, ESP_ERR_INVALID_STATE if not running,
+ *         ESP_ERR_NO_MEM if all frame slots are in flight, ESP_ERR_INVALID_SIZE if too long
  */
 esp_err_t web_send_real_time_update(const char* update_type, const char* data);
 
 /**
- * @brief Register for real-time update notifications
+ * @brief Resume telemetry for sockets opened from client_ip
  * @param client_ip Client IP to register
- * @return ESP_OK on success
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if that client has no open /ws socket
  */
 esp_err_t web_register_for_updates(const char* client_ip);
 
 /**
- * @brief Unregister from real-time update notifications
+ * @brief Pause telemetry for sockets opened from client_ip (socket stays open for commands)
  * @param client_ip Client IP to unregister
- * @return ESP_OK on success
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if that client has no open /ws socket
  */
 esp_err_t web_unregister_from_updates(const char* client_ip);
 
@@ -0,0 +1,112 @@
+// components/web_interface/src/web_async.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// WEB_ASYNC.CPP - SLOW REQUESTS OFF THE HTTPD TASK
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Run long GET handlers on a small worker pool
+// - esp_http_server has one task: a status stream or incident download used
+//   to hold every other socket, commands included, until it finished
+// - web_async_handler() detaches the request (httpd_req_async_handler_begin)
+//   and hands it to an idle worker; the httpd task goes straight back to
+//   select() and answers the next socket
+// - No idle worker: 503 + Retry-After at once (the page polls again), never
+//   a queue that grows behind a slow client
+// - Commands, the UI assets and /ws stay on the httpd task: they are short,
+//   and keeping them inline keeps their latency independent of the workers
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "web_interface.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include <atomic>
+#include <cstdio>
+
+static const char* TAG = "WEB_ASYNC";
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// WORKER POOL
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    httpd_req_t* req;                   // Detached copy, owned by the worker until complete
+    web_request_handler_t handler;
+} web_async_job_t;
+
+static QueueHandle_t g_jobs = NULL;
+static SemaphoreHandle_t g_idle_workers = NULL;    // Counts workers waiting for a job
+static std::atomic<uint32_t> g_dispatched{0};
+static std::atomic<uint32_t> g_rejected{0};
+
+static void worker_task(void* arg) {
+    (void)arg;
+    web_async_job_t job;
+    while (true) {
+        xSemaphoreGive(g_idle_workers);
+        if (xQueueReceive(g_jobs, &job, portMAX_DELAY) != pdTRUE) continue;
+
+        job.handler(job.req);
+        httpd_req_async_handler_complete(job.req);
+    }
+}
+
+esp_err_t web_async_init(void) {
+    if (g_jobs != NULL) return ESP_OK;
+
+    g_jobs = xQueueCreate(WEB_ASYNC_WORKERS, sizeof(web_async_job_t));
+    g_idle_workers = xSemaphoreCreateCounting(WEB_ASYNC_WORKERS, 0);
+    if (g_jobs == NULL || g_idle_workers == NULL) return ESP_ERR_NO_MEM;
+
+    for (int i = 0; i < WEB_ASYNC_WORKERS; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "web_async%d", i);
+        if (xTaskCreatePinnedToCore(worker_task, name, WEB_ASYNC_WORKER_STACK, NULL,
+                                    WEB_ASYNC_WORKER_PRIORITY, NULL, WEB_ASYNC_WORKER_CORE) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create %s", name);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    ESP_LOGI(TAG, "%d request workers started", WEB_ASYNC_WORKERS);
+    return ESP_OK;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DISPATCH (httpd task)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t web_async_handler(httpd_req_t *req) {
+    web_request_handler_t handler = (web_request_handler_t)req->user_ctx;
+    if (handler == NULL) return ESP_FAIL;
+
+    // Not started: behave like a plain handler
+    if (g_jobs == NULL) return handler(req);
+
+    if (xSemaphoreTake(g_idle_workers, 0) != pdTRUE) {
+        g_rejected.fetch_add(1, std::memory_order_relaxed);
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_set_hdr(req, "Retry-After", "1");
+        httpd_resp_send(req, "Busy", HTTPD_RESP_USE_STRLEN);
+        return ESP_OK;
+    }
+
+    web_async_job_t job = {NULL, handler};
+    esp_err_t result = httpd_req_async_handler_begin(req, &job.req);
+    if (result != ESP_OK) {
+        xSemaphoreGive(g_idle_workers);
+        ESP_LOGW(TAG, "Cannot detach request: %s", esp_err_to_name(result));
+        return handler(req);
+    }
+
+    // A worker was reserved above, so the queue has room
+    xQueueSend(g_jobs, &job, portMAX_DELAY);
+    g_dispatched.fetch_add(1, std::memory_order_relaxed);
+    return ESP_OK;
+}
+
+void web_async_get_counts(uint32_t* dispatched, uint32_t* rejected) {
+    if (dispatched != NULL) *dispatched = g_dispatched.load(std::memory_order_relaxed);
+    if (rejected != NULL) *rejected = g_rejected.load(std::memory_order_relaxed);
+}
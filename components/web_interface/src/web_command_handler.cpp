@@ -5,12 +5,15 @@
 
 #include "web_interface.h"
 #include "mode_coordinator.h"
+#include "calibration_store.h"
 #include "wire_learning_mode.h"
-#include "automatic_mode.h"
+#include "hardware_control.h"
 #include "manual_mode.h"
+#include "command_queue.h"
 #include "esp_log.h"
 #include <cstring>
 #include <cctype>
+#include <cstdlib>
 
 static const char* TAG = "WEB_COMMAND";
 
@@ -18,6 +21,13 @@ static const char* TAG = "WEB_COMMAND";
 #define MANUAL_MODE_MAX_SPEED_MS        2.0f      // Maximum allowed manual speed
 #define MANUAL_MODE_DEFAULT_SPEED_MS    0.5f      // Default speed for forward/backward
 
+// Set by app_main when boot completes: the web UI is up before the control path
+static bool g_commands_ready = false;
+
+void web_set_commands_ready(bool ready) {
+    g_commands_ready = ready;
+}
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // COMMAND VALIDATION
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -27,7 +37,7 @@ bool web_validate_command(char command_char, const char* client_ip) {
     command_char = toupper(command_char);
     
     // Check if command is in valid set
-    const char* valid_commands = "WUMHCVADFSB+-QIETRLK";
+    const char* valid_commands = "WUMHCVADFSB+-QIETRLKX";
     if (strchr(valid_commands, command_char) == NULL) {
         ESP_LOGW(TAG, "Invalid command character: '%c' from %s", command_char, client_ip);
         return false;
@@ -45,9 +55,103 @@ bool web_validate_command(char command_char, const char* client_ip) {
 // COMMAND PROCESSING
 // ═══════════════════════════════════════════════════════════════════════════════
 
+// Manual commands run on the control loop: queue them and answer with the ID
+static esp_err_t queue_manual_command(manual_command_type_t type, float speed, bool forward,
+                                      const char* client_ip, char* response_buffer, size_t buffer_size,
+                                      uint32_t* command_id) {
+    if (!manual_mode_is_active()) {
+        snprintf(response_buffer, buffer_size, 
+                "⚠️ Manual mode not active - Activate manual mode first");
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    manual_command_t command = manual_mode_create_command(type, speed, forward, client_ip);
+    uint32_t id = 0;
+    esp_err_t result = command_queue_submit(&command, &id);
+    if (result != ESP_OK) {
+        snprintf(response_buffer, buffer_size, 
+                "❌ Command queue full - try again in a moment");
+        return result;
+    }
+    
+    if (command_id != NULL) *command_id = id;
+    snprintf(response_buffer, buffer_size, 
+            "⏳ %s queued (#%lu)", manual_mode_command_type_to_string(type), (unsigned long)id);
+    return ESP_OK;
+}
+
+// Mode starts and stops run on the control loop too, in order with manual commands
+static esp_err_t queue_mode_command(mode_command_type_t type, const char* client_ip,
+                                    char* response_buffer, size_t buffer_size, uint32_t* command_id) {
+    uint32_t id = 0;
+    esp_err_t result = command_queue_submit_mode(type, client_ip, &id);
+    if (result != ESP_OK) {
+        snprintf(response_buffer, buffer_size, 
+                "❌ Command queue full - try again in a moment");
+        return result;
+    }
+    
+    if (command_id != NULL) *command_id = id;
+    snprintf(response_buffer, buffer_size, 
+            "⏳ %s queued (#%lu)", command_queue_mode_command_to_string(type), (unsigned long)id);
+    return ESP_OK;
+}
+
+// Site changes carry the site ID through the queue; the profile loads on housekeeping
+static esp_err_t queue_site_command(const char* site_id, const char* client_ip,
+                                    char* response_buffer, size_t buffer_size, uint32_t* command_id) {
+    uint32_t id = 0;
+    esp_err_t result = command_queue_submit_site(site_id, client_ip, &id);
+    if (result == ESP_ERR_INVALID_ARG) {
+        snprintf(response_buffer, buffer_size, 
+                "⚠️ Usage: L<site id> - up to %d letters, digits, '-' or '_'", CALIBRATION_SITE_ID_MAX);
+        return result;
+    }
+    if (result != ESP_OK) {
+        snprintf(response_buffer, buffer_size, 
+                "❌ Command queue full - try again in a moment");
+        return result;
+    }
+    
+    if (command_id != NULL) *command_id = id;
+    snprintf(response_buffer, buffer_size, 
+            "⏳ %s '%s' queued (#%lu)", command_queue_mode_command_to_string(MODE_CMD_SELECT_SITE), site_id,
+            (unsigned long)id);
+    return ESP_OK;
+}
+
+static esp_err_t submit_command(char command_char, const char* argument, const char* client_ip,
+                                char* response_buffer, size_t buffer_size, uint32_t* command_id);
+
 esp_err_t web_process_command(char command_char, const char* client_ip,
                              char* response_buffer, size_t buffer_size) {
+    return web_submit_command(command_char, client_ip, response_buffer, buffer_size, NULL);
+}
+
+esp_err_t web_submit_command(char command_char, const char* client_ip,
+                             char* response_buffer, size_t buffer_size, uint32_t* command_id) {
+    return submit_command(command_char, "", client_ip, response_buffer, buffer_size, command_id);
+}
+
+esp_err_t web_submit_command_text(const char* text, const char* client_ip,
+                                  char* response_buffer, size_t buffer_size, uint32_t* command_id) {
+    if (text == NULL || text[0] == '\0') return ESP_ERR_INVALID_ARG;
+    
+    // Argument: the rest of the text, without the line ending a terminal adds
+    char argument[CALIBRATION_SITE_ID_MAX + 2];
+    snprintf(argument, sizeof(argument), "%s", text + 1);
+    size_t length = strlen(argument);
+    while (length > 0 && isspace((unsigned char)argument[length - 1])) {
+        argument[--length] = '\0';
+    }
+    return submit_command(text[0], argument, client_ip, response_buffer, buffer_size, command_id);
+}
+
+static esp_err_t submit_command(char command_char, const char* argument, const char* client_ip,
+                                char* response_buffer, size_t buffer_size, uint32_t* command_id) {
     if (response_buffer == NULL) return ESP_ERR_INVALID_ARG;
+    if (command_id != NULL) *command_id = 0;
+    if (client_ip == NULL) client_ip = "unknown";
     
     // Validate command
     if (!web_validate_command(command_char, client_ip)) {
@@ -55,6 +159,11 @@ esp_err_t web_process_command(char command_char, const char* client_ip,
         return ESP_ERR_INVALID_ARG;
     }
     
+    if (!g_commands_ready) {
+        snprintf(response_buffer, buffer_size, "⏳ System starting - try again in a moment");
+        return ESP_ERR_INVALID_STATE;
+    }
+    
     esp_err_t result = ESP_OK;
     command_char = toupper(command_char);
     
@@ -66,39 +175,18 @@ esp_err_t web_process_command(char command_char, const char* client_ip,
         // ═══════════════════════════════════════════════════════════════════════
         
         case 'W': // Wire Learning Mode
-            result = mode_coordinator_activate_wire_learning();
-            if (result == ESP_OK) {
-                snprintf(response_buffer, buffer_size, 
-                        "🔍 Wire learning mode activated - Finding wire length with gradual speed progression (0.1→1.0 m/s)");
-            } else {
-                snprintf(response_buffer, buffer_size, 
-                        "❌ Failed to activate wire learning: %s", 
-                        mode_coordinator_get_error_message());
-            }
+            result = queue_mode_command(MODE_CMD_ACTIVATE_WIRE_LEARNING, client_ip,
+                                        response_buffer, buffer_size, command_id);
             break;
             
         case 'U': // Automatic Mode
-            result = mode_coordinator_activate_automatic();
-            if (result == ESP_OK) {
-                snprintf(response_buffer, buffer_size, 
-                        "🚀 Automatic mode activated - 5 m/s cycling with coasting calibration started");
-            } else {
-                snprintf(response_buffer, buffer_size, 
-                        "❌ Failed to activate automatic mode: %s", 
-                        mode_coordinator_get_error_message());
-            }
+            result = queue_mode_command(MODE_CMD_ACTIVATE_AUTOMATIC, client_ip,
+                                        response_buffer, buffer_size, command_id);
             break;
             
         case 'M': // Manual Mode
-            result = mode_coordinator_activate_manual();
-            if (result == ESP_OK) {
-                snprintf(response_buffer, buffer_size, 
-                        "🎮 Manual mode activated - Use ARM ESC button to enable motor control");
-            } else {
-                snprintf(response_buffer, buffer_size, 
-                        "❌ Failed to activate manual mode: %s", 
-                        mode_coordinator_get_error_message());
-            }
+            result = queue_mode_command(MODE_CMD_ACTIVATE_MANUAL, client_ip,
+                                        response_buffer, buffer_size, command_id);
             break;
             
         // ═══════════════════════════════════════════════════════════════════════
@@ -143,117 +231,38 @@ esp_err_t web_process_command(char command_char, const char* client_ip,
         // ═══════════════════════════════════════════════════════════════════════
         
         case 'A': // Arm ESC
-            if (manual_mode_is_active()) {
-                result = manual_mode_arm_esc();
-                if (result == ESP_OK) {
-                    snprintf(response_buffer, buffer_size, 
-                            "⚡ ESC armed successfully - Motor control enabled, ready for movement commands");
-                } else {
-                    snprintf(response_buffer, buffer_size, 
-                            "❌ Failed to arm ESC - Check hardware connections");
-                }
-            } else {
-                snprintf(response_buffer, buffer_size, 
-                        "⚠️ Manual mode not active - Activate manual mode first");
-                result = ESP_ERR_INVALID_STATE;
-            }
+            result = queue_manual_command(MANUAL_CMD_ARM_ESC, 0.0f, true, client_ip,
+                                          response_buffer, buffer_size, command_id);
             break;
             
         case 'D': // Disarm ESC
-            if (manual_mode_is_active()) {
-                result = manual_mode_disarm_esc();
-                snprintf(response_buffer, buffer_size, 
-                        "🛑 ESC disarmed - Motor control disabled, system safe");
-            } else {
-                snprintf(response_buffer, buffer_size, 
-                        "⚠️ Manual mode not active");
-                result = ESP_ERR_INVALID_STATE;
-            }
+            result = queue_manual_command(MANUAL_CMD_DISARM_ESC, 0.0f, true, client_ip,
+                                          response_buffer, buffer_size, command_id);
             break;
             
         case 'F': // Forward
-            if (manual_mode_is_active()) {
-                result = manual_mode_move_forward();
-                if (result == ESP_OK) {
-                    snprintf(response_buffer, buffer_size, 
-                            "➡️ Moving forward at %.1f m/s - Use +/- to adjust speed", 
-                            manual_mode_get_current_speed());
-                } else {
-                    snprintf(response_buffer, buffer_size, 
-                            "❌ Failed to move forward - Ensure ESC is armed first");
-                }
-            } else {
-                snprintf(response_buffer, buffer_size, 
-                        "⚠️ Manual mode not active");
-                result = ESP_ERR_INVALID_STATE;
-            }
+            result = queue_manual_command(MANUAL_CMD_FORWARD, MANUAL_MODE_DEFAULT_SPEED_MS, true, client_ip,
+                                          response_buffer, buffer_size, command_id);
             break;
             
         case 'B': // Backward
-            if (manual_mode_is_active()) {
-                result = manual_mode_move_backward();
-                if (result == ESP_OK) {
-                    snprintf(response_buffer, buffer_size, 
-                            "⬅️ Moving backward at %.1f m/s - Use +/- to adjust speed", 
-                            manual_mode_get_current_speed());
-                } else {
-                    snprintf(response_buffer, buffer_size, 
-                            "❌ Failed to move backward - Ensure ESC is armed first");
-                }
-            } else {
-                snprintf(response_buffer, buffer_size, 
-                        "⚠️ Manual mode not active");
-                result = ESP_ERR_INVALID_STATE;
-            }
+            result = queue_manual_command(MANUAL_CMD_BACKWARD, MANUAL_MODE_DEFAULT_SPEED_MS, false, client_ip,
+                                          response_buffer, buffer_size, command_id);
             break;
             
         case 'S': // Stop movement
-            if (manual_mode_is_active()) {
-                result = manual_mode_stop_movement();
-                snprintf(response_buffer, buffer_size, 
-                        "⏹️ Motor stopped - ESC remains armed for further commands");
-            } else {
-                snprintf(response_buffer, buffer_size, 
-                        "⚠️ Manual mode not active");
-                result = ESP_ERR_INVALID_STATE;
-            }
+            result = queue_manual_command(MANUAL_CMD_STOP, 0.0f, true, client_ip,
+                                          response_buffer, buffer_size, command_id);
             break;
             
-        case '+': // Increase speed
-            if (manual_mode_is_active()) {
-                result = manual_mode_increase_speed();
-                if (result == ESP_OK) {
-                    snprintf(response_buffer, buffer_size, 
-                            "⬆️ Speed increased to %.1f m/s", 
-                            manual_mode_get_current_speed());
-                } else {
-                    snprintf(response_buffer, buffer_size, 
-                            "⚠️ Cannot increase speed - At maximum (%.1f m/s) or ESC not armed", 
-                            MANUAL_MODE_MAX_SPEED_MS);
-                }
-            } else {
-                snprintf(response_buffer, buffer_size, 
-                        "⚠️ Manual mode not active");
-                result = ESP_ERR_INVALID_STATE;
-            }
+        case '+': // Increase speed (bursts coalesce into one target)
+            result = queue_manual_command(MANUAL_CMD_INCREASE_SPEED, 0.0f, true, client_ip,
+                                          response_buffer, buffer_size, command_id);
             break;
             
-        case '-': // Decrease speed
-            if (manual_mode_is_active()) {
-                result = manual_mode_decrease_speed();
-                if (result == ESP_OK) {
-                    snprintf(response_buffer, buffer_size, 
-                            "⬇️ Speed decreased to %.1f m/s", 
-                            manual_mode_get_current_speed());
-                } else {
-                    snprintf(response_buffer, buffer_size, 
-                            "⚠️ Cannot decrease speed further");
-                }
-            } else {
-                snprintf(response_buffer, buffer_size, 
-                        "⚠️ Manual mode not active");
-                result = ESP_ERR_INVALID_STATE;
-            }
+        case '-': // Decrease speed (bursts coalesce into one target)
+            result = queue_manual_command(MANUAL_CMD_DECREASE_SPEED, 0.0f, true, client_ip,
+                                          response_buffer, buffer_size, command_id);
             break;
             
         // ═══════════════════════════════════════════════════════════════════════
@@ -261,21 +270,13 @@ esp_err_t web_process_command(char command_char, const char* client_ip,
         // ═══════════════════════════════════════════════════════════════════════
         
         case 'Q': // Stop current mode gracefully
-            result = mode_coordinator_stop_current_mode(false);
-            snprintf(response_buffer, buffer_size, 
-                    "⏹️ Current mode stopping gracefully - Will complete current operation safely");
+            result = queue_mode_command(MODE_CMD_STOP, client_ip,
+                                        response_buffer, buffer_size, command_id);
             break;
             
         case 'I': // Interrupt current mode
-            if (automatic_mode_is_active()) {
-                result = automatic_mode_interrupt();
-                snprintf(response_buffer, buffer_size, 
-                        "⚠️ Automatic mode interrupted - Will stop at next wire end");
-            } else {
-                result = mode_coordinator_stop_current_mode(true);
-                snprintf(response_buffer, buffer_size, 
-                        "⏹️ Current mode stopped immediately");
-            }
+            result = queue_mode_command(MODE_CMD_INTERRUPT, client_ip,
+                                        response_buffer, buffer_size, command_id);
             break;
             
         // ═══════════════════════════════════════════════════════════════════════
@@ -283,15 +284,37 @@ esp_err_t web_process_command(char command_char, const char* client_ip,
         // ═══════════════════════════════════════════════════════════════════════
         
         case 'E': // Emergency stop
-            result = mode_coordinator_emergency_stop();
-            snprintf(response_buffer, buffer_size, 
-                    "🚨 EMERGENCY STOP ACTIVATED - All modes stopped, motor halted immediately");
+            {
+                // Pre-empts everything queued; executes on the next control tick
+                uint32_t id = 0;
+                result = command_queue_submit_emergency_stop(client_ip, &id);
+                if (result == ESP_OK) {
+                    if (command_id != NULL) *command_id = id;
+                    snprintf(response_buffer, buffer_size, 
+                            "🚨 EMERGENCY STOP #%lu - All modes stopping, motor halts on the next control tick",
+                            (unsigned long)id);
+                } else {
+                    // Queue not running: latch the output stage; the coordinator stays on the control loop
+                    result = hardware_emergency_stop();
+                    snprintf(response_buffer, buffer_size, 
+                            "🚨 EMERGENCY STOP - Motor output latched at neutral (command queue not running)");
+                }
+            }
             break;
             
         case 'R': // Reset system
-            result = mode_coordinator_reset_system();
-            snprintf(response_buffer, buffer_size, 
-                    "🔄 System reset complete - Sensor validation required before operation");
+            result = queue_mode_command(MODE_CMD_RESET_SYSTEM, client_ip,
+                                        response_buffer, buffer_size, command_id);
+            break;
+            
+        case 'X': // Forget stored calibration (refused at execution while a mode runs)
+            result = queue_mode_command(MODE_CMD_CLEAR_CALIBRATION, client_ip,
+                                        response_buffer, buffer_size, command_id);
+            break;
+            
+        case 'L': // Select site "L<site id>" (refused at execution while a mode runs)
+            result = queue_site_command(argument, client_ip,
+                                        response_buffer, buffer_size, command_id);
             break;
             
         case 'T': // Status
@@ -305,7 +328,7 @@ esp_err_t web_process_command(char command_char, const char* client_ip,
                         status.sensors_validated ? "✅ Validated" : "❌ Not Validated",
                         hw_status.esc_armed ? "✅ Armed" : "❌ Disarmed",
                         hw_status.current_speed_ms,
-                        hw_status.current_position_m);
+                        hardware_get_current_position());
             }
             break;
             
@@ -331,6 +354,167 @@ esp_err_t web_process_command(char command_char, const char* client_ip,
     return result;
 }
 
+// ═══════════════════════════════════════════════════════════════════════════════
+// QUEUED COMMAND OUTCOMES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static const char* command_name(const command_result_t* result) {
+    return result->mode_command != MODE_CMD_NONE ? command_queue_mode_command_to_string(result->mode_command)
+                                                 : manual_mode_command_type_to_string(result->type);
+}
+
+static void describe_mode_outcome(const command_result_t* result, char* message, size_t size) {
+    if (result->mode_command == MODE_CMD_CLEAR_CALIBRATION && result->result == ESP_ERR_INVALID_STATE) {
+        snprintf(message, size, "❌ Stop the current mode before clearing calibration");
+        return;
+    }
+    if (result->mode_command == MODE_CMD_SELECT_SITE && result->result == ESP_ERR_INVALID_STATE) {
+        snprintf(message, size, "❌ Stop the current mode (and let a site change finish) before selecting a site");
+        return;
+    }
+    if (result->result != ESP_OK) {
+        snprintf(message, size, "❌ %s failed: %s", command_name(result), mode_coordinator_get_error_message());
+        return;
+    }
+
+    switch (result->mode_command) {
+        case MODE_CMD_ACTIVATE_WIRE_LEARNING:
+            snprintf(message, size, "🔍 Wire learning mode activated - Finding wire length with gradual speed progression (0.1→1.0 m/s)");
+            break;
+        case MODE_CMD_ACTIVATE_AUTOMATIC:
+            snprintf(message, size, "🚀 Automatic mode activated - 5 m/s cycling with coasting calibration started");
+            break;
+        case MODE_CMD_ACTIVATE_MANUAL:
+            snprintf(message, size, "🎮 Manual mode activated - Use ARM ESC button to enable motor control");
+            break;
+        case MODE_CMD_STOP:
+            snprintf(message, size, "⏹️ Current mode stopping gracefully - Will complete current operation safely");
+            break;
+        case MODE_CMD_INTERRUPT:
+            snprintf(message, size, "⚠️ Mode interrupted - Automatic stops at the next wire end, other modes stop at once");
+            break;
+        case MODE_CMD_RESET_SYSTEM:
+            snprintf(message, size, "🔄 System reset complete - Sensor validation required before operation");
+            break;
+        case MODE_CMD_CLEAR_CALIBRATION:
+            snprintf(message, size, "🗑️ Stored calibration for site '%s' cleared - Wire learning required",
+                     mode_coordinator_get_site_id());
+            break;
+        case MODE_CMD_SELECT_SITE:
+            snprintf(message, size, "📍 Site selected - Loading its stored calibration, modes wait until it is in");
+            break;
+        default:
+            snprintf(message, size, "✅ %s done", command_name(result));
+            break;
+    }
+}
+
+static void describe_outcome(const command_result_t* result, char* message, size_t size) {
+    if (result->status == COMMAND_STATUS_QUEUED) {
+        snprintf(message, size, "⏳ Waiting for the control loop");
+        return;
+    }
+    if (result->status == COMMAND_STATUS_COALESCED) {
+        snprintf(message, size, "⏩ Merged into a later speed change");
+        return;
+    }
+    if (result->status == COMMAND_STATUS_SUPERSEDED) {
+        snprintf(message, size, "🚨 Cancelled by emergency stop");
+        return;
+    }
+    if (result->mode_command != MODE_CMD_NONE) {
+        describe_mode_outcome(result, message, size);
+        return;
+    }
+    if (result->result != ESP_OK) {
+        snprintf(message, size, "❌ %s rejected (%s) - Check manual mode and ESC state",
+                 manual_mode_command_type_to_string(result->type), esp_err_to_name(result->result));
+        return;
+    }
+
+    switch (result->type) {
+        case MANUAL_CMD_ARM_ESC:
+            snprintf(message, size, "⚡ ESC arming started - Movement commands accepted once armed (~4 s)");
+            break;
+        case MANUAL_CMD_DISARM_ESC:
+            snprintf(message, size, "🛑 ESC disarmed - Motor control disabled, system safe");
+            break;
+        case MANUAL_CMD_FORWARD:
+            snprintf(message, size, "➡️ Moving forward at %.1f m/s - Use +/- to adjust speed", result->target_speed_ms);
+            break;
+        case MANUAL_CMD_BACKWARD:
+            snprintf(message, size, "⬅️ Moving backward at %.1f m/s - Use +/- to adjust speed", result->target_speed_ms);
+            break;
+        case MANUAL_CMD_STOP:
+            snprintf(message, size, "⏹️ Motor stopped - ESC remains armed for further commands");
+            break;
+        case MANUAL_CMD_SET_SPEED:
+            snprintf(message, size, "🎚️ Speed set to %.1f m/s (%u step%s)", result->target_speed_ms,
+                     (unsigned)result->merged, result->merged == 1 ? "" : "s");
+            break;
+        case MANUAL_CMD_EMERGENCY_STOP:
+            snprintf(message, size, "🚨 EMERGENCY STOP complete - All modes stopped, motor halted");
+            break;
+        default:
+            snprintf(message, size, "✅ %s done", manual_mode_command_type_to_string(result->type));
+            break;
+    }
+}
+
+size_t web_format_command_result(const command_result_t* result, char* json_buffer, size_t buffer_size) {
+    if (result == NULL || json_buffer == NULL) return 0;
+    
+    char message[160];
+    describe_outcome(result, message, sizeof(message));
+    
+    bool success = result->status == COMMAND_STATUS_COALESCED ||
+                   (result->status == COMMAND_STATUS_DONE && result->result == ESP_OK);
+    bool finished = result->status != COMMAND_STATUS_QUEUED;
+    uint32_t latency_us = finished && result->completed_us > result->submitted_us
+                          ? (uint32_t)(result->completed_us - result->submitted_us) : 0;
+    
+    int n = snprintf(json_buffer, buffer_size,
+        "{\"id\":%lu,\"status\":\"%s\",\"success\":%s,\"command\":\"%s\","
+        "\"result\":\"%s\",\"merged\":%u,\"speed\":%.2f,\"latency_ms\":%.1f,\"message\":\"%s\"}",
+        (unsigned long)result->id, command_queue_status_to_string(result->status),
+        success ? "true" : "false", command_name(result),
+        finished ? esp_err_to_name(result->result) : "", (unsigned)result->merged,
+        result->target_speed_ms, latency_us / 1000.0f, message);
+    if (n < 0 || (size_t)n >= buffer_size) return 0;
+    return (size_t)n;
+}
+
+esp_err_t web_send_command_result(httpd_req_t* req) {
+    char query[WEB_STATUS_QUERY_SIZE];
+    char value[12];
+    if (httpd_req_get_url_query_len(req) == 0 ||
+        httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK ||
+        httpd_query_key_value(query, "id", value, sizeof(value)) != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Missing id");
+        return ESP_FAIL;
+    }
+    
+    char* end = NULL;
+    unsigned long id = strtoul(value, &end, 10);
+    command_result_t result;
+    if (end == value || *end != '\0' || command_queue_get_result((uint32_t)id, &result) != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "Unknown or expired command id");
+        return ESP_FAIL;
+    }
+    
+    char json[WEB_COMMAND_RESULT_SIZE];
+    size_t length = web_format_command_result(&result, json, sizeof(json));
+    if (length == 0) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Result too large");
+        return ESP_FAIL;
+    }
+    
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    return httpd_resp_send(req, json, length);
+}
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // COMMAND HELP AND DOCUMENTATION
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -365,6 +549,7 @@ esp_err_t web_get_command_help(char* help_buffer, size_t buffer_size) {
         "🚨 EMERGENCY & SYSTEM:\n"
         "  E = Emergency Stop (immediate halt)\n"
         "  R = Reset System (clear all data)\n"
+        "  X = Forget Stored Calibration (wire learning + coasting)\n"
         "  T = System Status (current state)\n"
         "\n"
         "📝 USAGE NOTES:\n"
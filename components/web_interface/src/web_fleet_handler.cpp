@@ -0,0 +1,165 @@
+// components/web_interface/src/web_fleet_handler.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// WEB_FLEET_HANDLER.CPP - FLEET DASHBOARD AND COMMAND RELAY (/api/fleet)
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Put fleet_link on HTTP
+// - GET: this unit, every peer heard, the newest relay acknowledgements and
+//   the link counters; one chunk per peer, no large buffer
+// - POST unit=<hex id|all>&cmd=<char>[&start_ms=N]: relay a web command;
+//   start_ms > 0 runs it on every target at once. Same per-client token
+//   bucket as /api/command: one phone cannot flood the whole fleet
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "web_interface.h"
+#include "fleet_link.h"
+#include "telemetry_frame.h"
+#include "esp_timer.h"
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+
+#define WEB_FLEET_BODY_SIZE         64          // POST body
+
+static int fleet_state_json(char* out, size_t size, const telemetry_frame_t* state) {
+    return snprintf(out, size,
+                    "\"mode\":%u,\"mode_state\":%u,\"position_mm\":%ld,\"velocity_mm_s\":%d,"
+                    "\"target_mm_s\":%d,\"flags\":%u,\"system_flags\":%u",
+                    state->mode, state->mode_state, (long)state->position_mm, state->velocity_mm_s,
+                    state->target_mm_s, state->flags, state->system_flags);
+}
+
+// Peer messages come off the air: nothing in them may end the JSON string
+static void copy_message(char* out, const char* message) {
+    size_t i = 0;
+    for (; i < FLEET_RESPONSE_SIZE - 1 && message[i] != '\0'; i++) {
+        char c = message[i];
+        out[i] = (c == '"' || c == '\\' || (unsigned char)c < 0x20) ? '\'' : c;
+    }
+    out[i] = '\0';
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FLEET REPORT
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t web_send_fleet_json(httpd_req_t* req) {
+    char chunk[WEB_JSON_CHUNK_SIZE];
+    int n;
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+
+    fleet_stats_t stats = fleet_link_get_stats();
+    n = snprintf(chunk, sizeof(chunk), "{\"enabled\":%s,\"running\":%s,\"self\":{\"unit\":\"%06lX\"",
+                 FLEET_ENABLED ? "true" : "false", stats.running ? "true" : "false",
+                 (unsigned long)fleet_link_get_unit_id());
+    telemetry_frame_t own;
+    if (telemetry_frame_get_latest(&own) == ESP_OK) {
+        chunk[n++] = ',';
+        n += fleet_state_json(chunk + n, sizeof(chunk) - n, &own);
+    }
+    n += snprintf(chunk + n, sizeof(chunk) - n, "},\"peers\":[");
+    if (httpd_resp_send_chunk(req, chunk, n) != ESP_OK) return ESP_FAIL;
+
+    fleet_peer_t peers[FLEET_MAX_PEERS];
+    size_t peer_count = fleet_link_get_peers(peers, FLEET_MAX_PEERS);
+    for (size_t i = 0; i < peer_count; i++) {
+        n = snprintf(chunk, sizeof(chunk), "%s{\"unit\":\"%06lX\",\"rssi\":%d,\"age_ms\":%lu,\"lost\":%lu,",
+                     i ? "," : "", (unsigned long)peers[i].unit_id, peers[i].rssi,
+                     (unsigned long)peers[i].age_ms, (unsigned long)peers[i].states_lost);
+        n += fleet_state_json(chunk + n, sizeof(chunk) - n, &peers[i].state);
+        n += snprintf(chunk + n, sizeof(chunk) - n, "}");
+        if (httpd_resp_send_chunk(req, chunk, n) != ESP_OK) return ESP_FAIL;
+    }
+
+    if (httpd_resp_send_chunk(req, "],\"relays\":[", HTTPD_RESP_USE_STRLEN) != ESP_OK) return ESP_FAIL;
+    fleet_relay_result_t results[FLEET_RELAY_RESULTS];
+    size_t result_count = fleet_link_get_relay_results(results, FLEET_RELAY_RESULTS);
+    for (size_t i = 0; i < result_count; i++) {
+        char message[FLEET_RESPONSE_SIZE];
+        copy_message(message, results[i].message);
+        n = snprintf(chunk, sizeof(chunk),
+                     "%s{\"sequence\":%u,\"unit\":\"%06lX\",\"command\":\"%c\",\"success\":%s,"
+                     "\"error\":\"%s\",\"latency_ms\":%lu,\"message\":\"%s\"}",
+                     i ? "," : "", results[i].sequence, (unsigned long)results[i].unit_id,
+                     results[i].command, results[i].result == ESP_OK ? "true" : "false",
+                     esp_err_to_name(results[i].result), (unsigned long)results[i].latency_ms, message);
+        if (httpd_resp_send_chunk(req, chunk, n) != ESP_OK) return ESP_FAIL;
+    }
+
+    n = snprintf(chunk, sizeof(chunk),
+                 "],\"stats\":{\"frames_sent\":%lu,\"frames_received\":%lu,\"frames_ignored\":%lu,"
+                 "\"rx_dropped\":%lu,\"send_failures\":%lu,\"commands_relayed\":%lu,"
+                 "\"commands_run\":%lu,\"commands_refused\":%lu,\"sync_starts\":%lu},"
+                 "\"sync_lead_ms\":%d}",
+                 (unsigned long)stats.frames_sent, (unsigned long)stats.frames_received,
+                 (unsigned long)stats.frames_ignored, (unsigned long)stats.rx_dropped,
+                 (unsigned long)stats.send_failures, (unsigned long)stats.commands_relayed,
+                 (unsigned long)stats.commands_run, (unsigned long)stats.commands_refused,
+                 (unsigned long)stats.sync_starts, FLEET_SYNC_START_LEAD_MS);
+    if (httpd_resp_send_chunk(req, chunk, n) != ESP_OK) return ESP_FAIL;
+
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FLEET COMMAND
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t web_send_fleet_command(httpd_req_t* req, bool* relayed) {
+    if (relayed != NULL) *relayed = false;
+    char body[WEB_FLEET_BODY_SIZE];
+    int received = httpd_req_recv(req, body, sizeof(body) - 1);
+    if (received <= 0) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Bad request");
+        return ESP_FAIL;
+    }
+    body[received] = '\0';
+
+    char unit[12];
+    char command[4];
+    char start[8];
+    if (httpd_query_key_value(body, "unit", unit, sizeof(unit)) != ESP_OK ||
+        httpd_query_key_value(body, "cmd", command, sizeof(command)) != ESP_OK ||
+        command[0] == '\0') {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "unit and cmd required");
+        return ESP_FAIL;
+    }
+    uint32_t start_in_ms = 0;
+    if (httpd_query_key_value(body, "start_ms", start, sizeof(start)) == ESP_OK) {
+        start_in_ms = strtoul(start, NULL, 10);
+    }
+
+    uint32_t target = FLEET_UNIT_ALL;
+    if (strcmp(unit, "all") != 0) {
+        char* end = NULL;
+        target = strtoul(unit, &end, 16);
+        if (end == unit || *end != '\0' || target == FLEET_UNIT_ALL) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Bad unit");
+            return ESP_FAIL;
+        }
+    }
+
+    char client_ip[16];
+    uint32_t client_addr = web_get_peer_address(httpd_req_to_sockfd(req), client_ip, sizeof(client_ip));
+    if (!web_rate_limit_allow_command(client_addr, command[0])) {
+        httpd_resp_set_hdr(req, "Retry-After", "1");
+        httpd_resp_send_err(req, HTTPD_429_TOO_MANY_REQUESTS, "Rate limit exceeded");
+        return ESP_FAIL;
+    }
+
+    uint16_t sequence = 0;
+    esp_err_t result = fleet_link_send_command(target, command[0], start_in_ms, &sequence);
+
+    char json_response[160];
+    snprintf(json_response, sizeof(json_response),
+             "{\"success\":%s,\"error\":\"%s\",\"sequence\":%u,\"timestamp\":%llu}",
+             result == ESP_OK ? "true" : "false", esp_err_to_name(result), sequence,
+             esp_timer_get_time() / 1000);
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    if (relayed != NULL) *relayed = (result == ESP_OK);
+    return httpd_resp_send(req, json_response, HTTPD_RESP_USE_STRLEN);
+}
@@ -0,0 +1,113 @@
+// components/web_interface/src/web_incident_handler.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// WEB_INCIDENT_HANDLER.CPP - FLIGHT RECORDER INCIDENT LIST AND DOWNLOAD
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Expose stored flight recorder incidents over HTTP
+// - GET /api/incidents       → recorder state + incident summaries (newest first)
+// - GET /api/incident?id=N   → raw incident (flight_incident_header_t followed
+//                              by telemetry_frame_t records), streamed from flash
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "web_interface.h"
+#include "flight_recorder.h"
+#include "esp_log.h"
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+
+static const char* TAG = "WEB_INCIDENT";
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// INCIDENT HANDLERS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t web_send_incident_list(httpd_req_t* req) {
+    flight_recorder_stats_t stats;
+    flight_recorder_get_stats(&stats);
+
+    char json[WEB_JSON_BUFFER_SIZE];
+    int n = snprintf(json, sizeof(json),
+        "{\"recorder\":{\"state\":\"%s\",\"history_records\":%lu,\"psram\":%s,\"flash\":%s,"
+        "\"triggers\":%lu,\"triggers_dropped\":%lu,\"records_lost\":%lu,\"flash_errors\":%lu},"
+        "\"incidents\":[",
+        flight_recorder_state_to_string(stats.state), (unsigned long)stats.history_records,
+        stats.history_in_psram ? "true" : "false", stats.flash_available ? "true" : "false",
+        (unsigned long)stats.triggers, (unsigned long)stats.triggers_dropped,
+        (unsigned long)stats.records_lost, (unsigned long)stats.flash_errors);
+
+    size_t count = flight_recorder_get_incident_count();
+    for (size_t i = 0; i < count && n > 0 && (size_t)n < sizeof(json); i++) {
+        flight_incident_info_t info;
+        if (flight_recorder_get_incident(i, &info) != ESP_OK) break;
+        n += snprintf(json + n, sizeof(json) - n,
+            "%s{\"id\":%u,\"sequence\":%lu,\"reason\":\"%s\",\"time_ms\":%llu,"
+            "\"records\":%u,\"pre_records\":%u,\"bytes\":%lu}",
+            i ? "," : "", info.slot, (unsigned long)info.sequence,
+            flight_recorder_trigger_to_string(info.reason),
+            (unsigned long long)(info.trigger_time_us / 1000ULL),
+            info.record_count, info.pre_records, (unsigned long)info.size_bytes);
+    }
+    if (n > 0 && (size_t)n < sizeof(json)) {
+        n += snprintf(json + n, sizeof(json) - n, "]}");
+    }
+    if (n <= 0 || (size_t)n >= sizeof(json)) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Incident list too large");
+        return ESP_FAIL;
+    }
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    return httpd_resp_send(req, json, n);
+}
+
+esp_err_t web_send_incident(httpd_req_t* req) {
+    char query[WEB_STATUS_QUERY_SIZE];
+    char value[8];
+    if (httpd_req_get_url_query_len(req) == 0 ||
+        httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK ||
+        httpd_query_key_value(query, "id", value, sizeof(value)) != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Missing id");
+        return ESP_FAIL;
+    }
+
+    char* end = NULL;
+    long slot = strtol(value, &end, 10);
+    flight_incident_info_t info;
+    bool found = false;
+    if (end != value && *end == '\0' && slot >= 0) {
+        size_t count = flight_recorder_get_incident_count();
+        for (size_t i = 0; i < count && !found; i++) {
+            found = (flight_recorder_get_incident(i, &info) == ESP_OK && info.slot == slot);
+        }
+    }
+    if (!found) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "No such incident");
+        return ESP_FAIL;
+    }
+
+    char disposition[64];
+    snprintf(disposition, sizeof(disposition), "attachment; filename=\"incident-%lu.bin\"",
+             (unsigned long)info.sequence);
+    httpd_resp_set_type(req, "application/octet-stream");
+    httpd_resp_set_hdr(req, "Content-Disposition", disposition);
+
+    // Stream from flash in chunks: the incident never sits in RAM whole
+    char chunk[WEB_JSON_CHUNK_SIZE];
+    uint32_t offset = 0;
+    while (offset < info.size_bytes) {
+        size_t bytes_read = 0;
+        esp_err_t result = flight_recorder_read_incident(info.slot, offset, chunk, sizeof(chunk), &bytes_read);
+        if (result != ESP_OK || bytes_read == 0) {
+            // Slot recycled or flash error mid-download: failing closes the socket
+            ESP_LOGW(TAG, "Incident %ld read failed at %lu: %s", slot, (unsigned long)offset,
+                     esp_err_to_name(result));
+                return ESP_FAIL;
+        }
+        if (httpd_resp_send_chunk(req, chunk, bytes_read) != ESP_OK) {
+                return ESP_FAIL;
+        }
+        offset += bytes_read;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
@@ -244,7 +244,7 @@ esp_err_t web_process_command(char command_char, const char* client_ip,
                         "Mode: %s, Sensors: %s, Status: %s", 
                         mode_coordinator_mode_to_string(status.current_mode),
                         status.sensors_validated ? "Validated" : "Not Validated",
-                        status.current_mode_status);
+                        status_text_to_string(status.current_mode_text));
             }
             break;
             
@@ -633,13 +633,13 @@ esp_err_t web_generate_status_json(char* json_buffer, size_t buffer_size) {
         // System status
         mode_status.system_healthy ? "true" : "false",
         mode_coordinator_mode_to_string(mode_status.current_mode),
-        mode_status.current_mode_status,
-        mode_status.error_message,
+        status_text_to_string(mode_status.current_mode_text),
+        status_text_to_string(mode_status.error_text),
         
         // Sensor validation
         mode_status.sensors_validated ? "true" : "false",
         mode_coordinator_validation_to_string(mode_status.sensor_validation_state),
-        mode_status.sensor_validation_message,
+        status_text_to_string(mode_status.sensor_validation_text),
         mode_status.hall_validation_complete ? "true" : "false",
         mode_status.accel_validation_complete ? "true" : "false",
         
@@ -1179,14 +1179,14 @@ static const char* TAG = "WEB_INTERFACE";
 // GLOBAL WEB INTERFACE STATE
 // ═══════════════════════════════════════════════════════════════════════════════
 
-static web_interface_config_t g_web_config = {0};
-static web_server_stats_t g_server_stats = {0};
+static web_interface_config_t g_web_config = {};
+static web_server_stats_t g_server_stats = {};
 static web_interface_status_t g_web_status = WEB_STATUS_STOPPED;
 static httpd_handle_t g_server_handle = NULL;
 static bool g_web_initialized = false;
 
 // Rate limiting and security
-static web_client_info_t g_client_info[10] = {0}; // Track up to 10 clients
+static web_client_info_t g_client_info[10] = {}; // Track up to 10 clients
 static int g_client_count = 0;
 
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -1238,7 +1238,7 @@ esp_err_t web_wifi_init_ap(const char* ssid, const char* password) {
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));
     
     // Configure WiFi AP
-    wifi_config_t wifi_config = {0};
+    wifi_config_t wifi_config = {};
     strncpy((char*)wifi_config.ap.ssid, ssid, sizeof(wifi_config.ap.ssid) - 1);
     wifi_config.ap.ssid_len = strlen(ssid);
     
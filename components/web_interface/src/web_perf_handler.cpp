@@ -0,0 +1,73 @@
+// components/web_interface/src/web_perf_handler.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// WEB_PERF_HANDLER.CPP - HOT-PATH PROFILING REPORT (/api/perf)
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Serve perf_monitor histograms and stack marks as JSON
+// - One chunk per probe: the report never needs a large buffer
+// - ?reset=1 clears the histograms after this report
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "web_interface.h"
+#include "perf_monitor.h"
+#include "control_loop.h"
+#include "esp_rom_sys.h"
+#include <cstring>
+#include <cstdio>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PERF REPORT
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t web_send_perf_json(httpd_req_t* req) {
+    char chunk[WEB_JSON_CHUNK_SIZE];
+    int n;
+
+    bool reset = false;
+    char query[WEB_STATUS_QUERY_SIZE];
+    char value[4];
+    if (httpd_req_get_url_query_len(req) > 0 &&
+        httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "reset", value, sizeof(value)) == ESP_OK) {
+        reset = (strcmp(value, "1") == 0);
+    }
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+
+    control_loop_stats_t loop = control_loop_get_stats();
+    n = snprintf(chunk, sizeof(chunk),
+                 "{\"enabled\":%s,\"cpu_mhz\":%lu,"
+                 "\"control_loop\":{\"rate_hz\":%lu,\"overruns\":%lu,\"missed\":%lu,\"max_jitter_us\":%ld},"
+                 "\"probes\":[",
+                 PERF_MONITOR_ENABLED ? "true" : "false",
+                 (unsigned long)esp_rom_get_cpu_ticks_per_us(),
+                 (unsigned long)loop.rate_hz, (unsigned long)loop.overrun_count,
+                 (unsigned long)loop.missed_ticks, (long)loop.max_jitter_us);
+    if (httpd_resp_send_chunk(req, chunk, n) != ESP_OK) return ESP_FAIL;
+
+    for (int probe = 0; probe < PERF_PROBE_COUNT; probe++) {
+        perf_probe_stats_t stats;
+        perf_monitor_get_probe((perf_probe_t)probe, &stats);
+        n = snprintf(chunk, sizeof(chunk),
+                     "%s{\"name\":\"%s\",\"count\":%lu,\"min_us\":%.2f,\"p50_us\":%.2f,"
+                     "\"p99_us\":%.2f,\"max_us\":%.2f,\"mean_us\":%.2f}",
+                     probe ? "," : "", stats.name, (unsigned long)stats.count,
+                     stats.min_us, stats.p50_us, stats.p99_us, stats.max_us, stats.mean_us);
+        if (httpd_resp_send_chunk(req, chunk, n) != ESP_OK) return ESP_FAIL;
+    }
+
+    perf_task_stack_t stacks[PERF_MAX_TASKS];
+    size_t task_count = perf_monitor_get_task_stacks(stacks, PERF_MAX_TASKS);
+    if (httpd_resp_send_chunk(req, "],\"stacks\":[", HTTPD_RESP_USE_STRLEN) != ESP_OK) return ESP_FAIL;
+    for (size_t i = 0; i < task_count; i++) {
+        n = snprintf(chunk, sizeof(chunk), "%s{\"task\":\"%s\",\"free_min_bytes\":%lu}",
+                     i ? "," : "", stacks[i].name, (unsigned long)stacks[i].free_min_bytes);
+        if (httpd_resp_send_chunk(req, chunk, n) != ESP_OK) return ESP_FAIL;
+    }
+    n = snprintf(chunk, sizeof(chunk), "],\"reset\":%s}", reset ? "true" : "false");
+    if (httpd_resp_send_chunk(req, chunk, n) != ESP_OK) return ESP_FAIL;
+
+    if (reset) perf_monitor_reset();
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
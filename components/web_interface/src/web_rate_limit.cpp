@@ -0,0 +1,233 @@
+// components/web_interface/src/web_rate_limit.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// WEB_RATE_LIMIT.CPP - PER-CLIENT COMMAND TOKEN BUCKETS
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Decide whether a client may send another command
+// - Keyed by the socket's peer IPv4 address, not by anything the client sends
+// - Fixed table of WEB_RATE_CLIENT_SLOTS, open addressing from a
+//   multiplicative hash; slots are never emptied, so a full table evicts the
+//   least recently seen client in place and probe chains stay intact
+// - Bucket level in milli-tokens, refilled lazily on each request
+// - Callers: POST /api/command (httpd task) and /ws commands (httpd task);
+//   the async workers never take tokens, the mutex is for the report API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "web_interface.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "lwip/sockets.h"
+#include <atomic>
+#include <cstring>
+
+static const char* TAG = "WEB_RATE";
+
+#define RATE_MILLI_PER_TOKEN        1000
+#define RATE_BUCKET_MILLI           (WEB_COMMAND_BURST * RATE_MILLI_PER_TOKEN)
+#define RATE_HASH_SHIFT             28          // 32 - log2(WEB_RATE_CLIENT_SLOTS)
+
+static_assert((WEB_RATE_CLIENT_SLOTS & (WEB_RATE_CLIENT_SLOTS - 1)) == 0, "client slots must be a power of 2");
+static_assert((1u << (32 - RATE_HASH_SHIFT)) == WEB_RATE_CLIENT_SLOTS, "hash shift must match the slot count");
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CLIENT TABLE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    bool used;
+    uint32_t addr;                      // IPv4, network byte order (0 = unknown peer)
+    uint32_t tokens_milli;              // Bucket level
+    uint32_t requests;                  // Commands allowed
+    bool limited;                       // Last command refused
+    uint64_t first_seen_us;
+    uint64_t last_refill_us;            // Also the LRU key
+    uint64_t blocked_until_us;          // web_block_client()
+} client_bucket_t;
+
+static client_bucket_t g_clients[WEB_RATE_CLIENT_SLOTS];
+static SemaphoreHandle_t g_clients_mutex = NULL;
+static std::atomic<uint32_t> g_refused{0};
+
+static inline uint32_t client_hash(uint32_t addr) {
+    return (addr * 2654435761u) >> RATE_HASH_SHIFT;
+}
+
+// Caller holds g_clients_mutex. Finds the client's slot, or claims one for it
+static client_bucket_t* find_or_claim_locked(uint32_t addr, uint64_t now_us) {
+    uint32_t index = client_hash(addr);
+    client_bucket_t* oldest = &g_clients[index];
+    for (int probe = 0; probe < WEB_RATE_CLIENT_SLOTS; probe++) {
+        client_bucket_t* slot = &g_clients[(index + probe) & (WEB_RATE_CLIENT_SLOTS - 1)];
+        if (slot->used && slot->addr == addr) return slot;
+        if (!slot->used) {
+            oldest = slot;
+            break;
+        }
+        if (slot->last_refill_us < oldest->last_refill_us) oldest = slot;
+    }
+
+    // New client starts with a full bucket
+    memset(oldest, 0, sizeof(*oldest));
+    oldest->used = true;
+    oldest->addr = addr;
+    oldest->tokens_milli = RATE_BUCKET_MILLI;
+    oldest->first_seen_us = now_us;
+    oldest->last_refill_us = now_us;
+    return oldest;
+}
+
+// Caller holds g_clients_mutex
+static client_bucket_t* find_locked(uint32_t addr) {
+    uint32_t index = client_hash(addr);
+    for (int probe = 0; probe < WEB_RATE_CLIENT_SLOTS; probe++) {
+        client_bucket_t* slot = &g_clients[(index + probe) & (WEB_RATE_CLIENT_SLOTS - 1)];
+        if (!slot->used) return NULL;
+        if (slot->addr == addr) return slot;
+    }
+    return NULL;
+}
+
+static void refill(client_bucket_t* client, uint64_t now_us) {
+    uint64_t elapsed_us = now_us - client->last_refill_us;
+    uint64_t added = elapsed_us * WEB_MAX_COMMANDS_PER_MINUTE / 60000;     // µs → milli-tokens
+    uint64_t level = client->tokens_milli + added;
+    client->tokens_milli = (uint32_t)(level > RATE_BUCKET_MILLI ? RATE_BUCKET_MILLI : level);
+    client->last_refill_us = now_us;
+}
+
+static bool parse_ip(const char* client_ip, uint32_t* addr) {
+    struct in_addr parsed;
+    if (client_ip == NULL || inet_pton(AF_INET, client_ip, &parsed) != 1) return false;
+    *addr = parsed.s_addr;
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// RATE LIMITING API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t web_rate_limit_init(void) {
+    if (g_clients_mutex == NULL) {
+        g_clients_mutex = xSemaphoreCreateMutex();
+        if (g_clients_mutex == NULL) return ESP_ERR_NO_MEM;
+    }
+    return web_clear_rate_limiting();
+}
+
+uint32_t web_get_peer_address(int sockfd, char* ip, size_t ip_size) {
+    struct sockaddr_in6 addr;
+    socklen_t addr_len = sizeof(addr);
+    if (ip != NULL && ip_size > 0) ip[0] = '\0';
+    if (sockfd < 0 || getpeername(sockfd, (struct sockaddr*)&addr, &addr_len) != 0) return 0;
+
+    // httpd listens on IPv6, IPv4 peers are v4-mapped
+    uint32_t v4 = addr.sin6_addr.un.u32_addr[3];
+    if (ip != NULL && ip_size > 0) inet_ntop(AF_INET, &v4, ip, ip_size);
+    return v4;
+}
+
+bool web_rate_limit_allow_command(uint32_t client_addr, char command_char) {
+    // Stopping is never throttled, and costs nothing
+    if (command_char == 'E' || command_char == 'e') return true;
+    if (g_clients_mutex == NULL) return true;
+
+    uint64_t now_us = esp_timer_get_time();
+    bool allowed = false;
+
+    xSemaphoreTake(g_clients_mutex, portMAX_DELAY);
+    client_bucket_t* client = find_or_claim_locked(client_addr, now_us);
+    refill(client, now_us);
+    if (now_us >= client->blocked_until_us && client->tokens_milli >= RATE_MILLI_PER_TOKEN) {
+        client->tokens_milli -= RATE_MILLI_PER_TOKEN;
+        client->requests++;
+        allowed = true;
+    }
+    bool newly_limited = !allowed && !client->limited;
+    client->limited = !allowed;
+    xSemaphoreGive(g_clients_mutex);
+
+    if (!allowed) {
+        g_refused.fetch_add(1, std::memory_order_relaxed);
+        if (newly_limited) {
+            char ip[16];
+            inet_ntop(AF_INET, &client_addr, ip, sizeof(ip));
+            ESP_LOGW(TAG, "Client %s rate limited", ip);
+        }
+    }
+    return allowed;
+}
+
+uint32_t web_rate_limit_get_refused(void) {
+    return g_refused.load(std::memory_order_relaxed);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// IP STRING API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+bool web_is_client_rate_limited(const char* client_ip) {
+    uint32_t addr;
+    if (!parse_ip(client_ip, &addr) || g_clients_mutex == NULL) return false;
+
+    uint64_t now_us = esp_timer_get_time();
+    xSemaphoreTake(g_clients_mutex, portMAX_DELAY);
+    client_bucket_t* client = find_locked(addr);
+    bool limited = false;
+    if (client != NULL) {
+        refill(client, now_us);
+        limited = now_us < client->blocked_until_us || client->tokens_milli < RATE_MILLI_PER_TOKEN;
+    }
+    xSemaphoreGive(g_clients_mutex);
+    return limited;
+}
+
+esp_err_t web_update_rate_limiting(const char* client_ip) {
+    uint32_t addr;
+    if (!parse_ip(client_ip, &addr)) return ESP_ERR_INVALID_ARG;
+    return web_rate_limit_allow_command(addr, '\0') ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t web_get_client_info(const char* client_ip, web_client_info_t* client_info) {
+    uint32_t addr;
+    if (client_info == NULL || !parse_ip(client_ip, &addr)) return ESP_ERR_INVALID_ARG;
+    if (g_clients_mutex == NULL) return ESP_ERR_INVALID_STATE;
+
+    xSemaphoreTake(g_clients_mutex, portMAX_DELAY);
+    client_bucket_t* client = find_locked(addr);
+    if (client != NULL) {
+        memset(client_info, 0, sizeof(*client_info));
+        client_info->client_id = (uint32_t)(client - g_clients);
+        inet_ntop(AF_INET, &client->addr, client_info->ip_address, sizeof(client_info->ip_address));
+        client_info->connect_time = client->first_seen_us;
+        client_info->requests_sent = client->requests;
+        client_info->last_request_time = client->last_refill_us;
+        client_info->rate_limited = client->limited;
+    }
+    xSemaphoreGive(g_clients_mutex);
+    return client != NULL ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t web_clear_rate_limiting(void) {
+    if (g_clients_mutex == NULL) return ESP_ERR_INVALID_STATE;
+    xSemaphoreTake(g_clients_mutex, portMAX_DELAY);
+    memset(g_clients, 0, sizeof(g_clients));
+    xSemaphoreGive(g_clients_mutex);
+    return ESP_OK;
+}
+
+esp_err_t web_block_client(const char* client_ip, uint32_t duration_ms) {
+    uint32_t addr;
+    if (!parse_ip(client_ip, &addr)) return ESP_ERR_INVALID_ARG;
+    if (g_clients_mutex == NULL) return ESP_ERR_INVALID_STATE;
+
+    uint64_t now_us = esp_timer_get_time();
+    xSemaphoreTake(g_clients_mutex, portMAX_DELAY);
+    client_bucket_t* client = find_or_claim_locked(addr, now_us);
+    client->blocked_until_us = now_us + (uint64_t)duration_ms * 1000;
+    xSemaphoreGive(g_clients_mutex);
+
+    ESP_LOGW(TAG, "Client %s blocked for %lu ms", client_ip, (unsigned long)duration_ms);
+    return ESP_OK;
+}
@@ -2,199 +2,744 @@
 // ═══════════════════════════════════════════════════════════════════════════════
 // WEB_STATUS_HANDLER.CPP - STATUS JSON GENERATION
 // ═══════════════════════════════════════════════════════════════════════════════
-// 
+//
 // SINGLE RESPONSIBILITY: Generate JSON status responses
-// - Collect status from all components
-// - Format as clean JSON for web interface
+// - Stream fields straight from the published snapshots into a small chunk
+//   buffer (no full-document buffer, no 50-argument snprintf)
+// - ?fields= selects fields or groups, only the snapshots they need are read
+// - Full documents are cached and reused while no source has changed
 // - Handle mode-specific status data
-// - Provide real-time sensor updates
 // ═══════════════════════════════════════════════════════════════════════════════
 
 #include "web_interface.h"
 #include "mode_coordinator.h"
 #include "hardware_control.h"
 #include "sensor_health.h"
+#include "state_estimator.h"
 #include "wire_learning_mode.h"
 #include "automatic_mode.h"
 #include "manual_mode.h"
 #include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include <cstring>
+#include <cstdio>
+#include <cmath>
 
 static const char* TAG = "WEB_STATUS";
 
 // ═══════════════════════════════════════════════════════════════════════════════
-// STATUS JSON GENERATION
+// STREAMING JSON WRITER
 // ═══════════════════════════════════════════════════════════════════════════════
 
-esp_err_t web_generate_status_json(char* json_buffer, size_t buffer_size) {
-    if (json_buffer == NULL) return ESP_ERR_INVALID_ARG;
-    
-    // Get status from all components
-    system_mode_status_t mode_status = mode_coordinator_get_status();
-    hardware_status_t hw_status = hardware_get_status();
-    sensor_health_t sensor_status = sensor_health_get_status();
-    
-    // Get mode-specific status
-    wire_learning_progress_t wire_progress = {0};
-    automatic_mode_progress_t auto_progress = {0};
-    manual_mode_status_t manual_status = {0};
-    
-    if (wire_learning_mode_is_active()) {
-        wire_progress = wire_learning_mode_get_progress();
+typedef esp_err_t (*json_sink_t)(void* ctx, const char* data, size_t length);
+
+typedef struct {
+    char chunk[WEB_JSON_CHUNK_SIZE];    // Pending output, flushed when full
+    size_t used;
+    json_sink_t sink;
+    void* sink_ctx;
+    esp_err_t error;                    // First sink error, later writes are dropped
+    bool first_field;
+} json_stream_t;
+
+static void json_stream_init(json_stream_t* stream, json_sink_t sink, void* sink_ctx) {
+    stream->used = 0;
+    stream->sink = sink;
+    stream->sink_ctx = sink_ctx;
+    stream->error = ESP_OK;
+    stream->first_field = true;
+}
+
+static void json_flush(json_stream_t* stream) {
+    if (stream->used > 0 && stream->error == ESP_OK) {
+        stream->error = stream->sink(stream->sink_ctx, stream->chunk, stream->used);
     }
-    
-    if (automatic_mode_is_active()) {
-        auto_progress = automatic_mode_get_progress();
+    stream->used = 0;
+}
+
+static void json_write(json_stream_t* stream, const char* data, size_t length) {
+    while (length > 0 && stream->error == ESP_OK) {
+        size_t space = sizeof(stream->chunk) - stream->used;
+        size_t n = length < space ? length : space;
+        memcpy(stream->chunk + stream->used, data, n);
+        stream->used += n;
+        data += n;
+        length -= n;
+        if (stream->used == sizeof(stream->chunk)) {
+            json_flush(stream);
+        }
     }
-    
-    if (manual_mode_is_active()) {
-        manual_status = manual_mode_get_status();
+}
+
+static inline void json_write_char(json_stream_t* stream, char c) {
+    json_write(stream, &c, 1);
+}
+
+static void json_write_string(json_stream_t* stream, const char* text) {
+    json_write_char(stream, '"');
+    const char* run = text;
+    for (const char* p = text; *p != '\0'; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c != '"' && c != '\\' && c >= 0x20) continue;
+
+        // Flush the clean run, then the escape
+        json_write(stream, run, p - run);
+        char escape[8];
+        int n = (c == '"' || c == '\\') ? snprintf(escape, sizeof(escape), "\\%c", c)
+                                        : snprintf(escape, sizeof(escape), "\\u%04x", c);
+        json_write(stream, escape, n);
+        run = p + 1;
     }
-    
-    // Generate comprehensive JSON status
-    snprintf(json_buffer, buffer_size,
-        "{"
-        "\"system_healthy\": %s,"
-        "\"current_mode\": \"%s\","
-        "\"current_mode_status\": \"%s\","
-        "\"error_message\": \"%s\","
-        
-        // Sensor Validation Status
-        "\"sensors_validated\": %s,"
-        "\"sensor_validation_state\": \"%s\","
-        "\"sensor_validation_message\": \"%s\","
-        "\"hall_validation_complete\": %s,"
-        "\"accel_validation_complete\": %s,"
-        
-        // Mode Availability
-        "\"wire_learning_availability\": \"%s\","
-        "\"automatic_availability\": \"%s\","
-        "\"manual_availability\": \"%s\","
-        
-        // Hall Sensor Data
-        "\"hall_status\": \"%s\","
-        "\"hall_pulses\": %lu,"
-        "\"wheel_rpm\": %.1f,"
-        "\"wheel_speed\": %.2f,"
-        "\"wheel_rotation_detected\": %s,"
-        
-        // Accelerometer Data
-        "\"accel_status\": \"%s\","
-        "\"accel_total\": %.2f,"
-        "\"last_impact\": %.2f,"
-        "\"impact_threshold\": %.1f,"
-        "\"trolley_shake_detected\": %s,"
-        
-        // Hardware Status
-        "\"esc_armed\": %s,"
-        "\"position_m\": %.2f,"
-        "\"current_speed_ms\": %.2f,"
-        "\"target_speed_ms\": %.2f,"
-        "\"direction_forward\": %s,"
-        "\"rotations\": %lu,"
-        
-        // Wire Learning Status
-        "\"wire_learning_complete\": %s,"
-        "\"wire_length_m\": %.2f,"
-        "\"wire_learning_state\": \"%s\","
-        "\"wire_learning_progress\": %d,"
-        
-        // Automatic Mode Status
-        "\"auto_cycle_count\": %lu,"
-        "\"auto_cycle_interrupted\": %s,"
-        "\"auto_coasting_calibrated\": %s,"
-        "\"automatic_state\": \"%s\","
-        "\"automatic_progress\": %d,"
-        
-        // Manual Mode Status
-        "\"manual_speed\": %.2f,"
-        "\"manual_direction_forward\": %s,"
-        "\"manual_esc_armed\": %s,"
-        "\"manual_motor_active\": %s,"
-        "\"manual_state\": \"%s\""
-        "}",
-        
+    json_write(stream, run, strlen(run));
+    json_write_char(stream, '"');
+}
+
+static void json_key(json_stream_t* stream, const char* name) {
+    if (!stream->first_field) json_write_char(stream, ',');
+    stream->first_field = false;
+    json_write_string(stream, name);
+    json_write_char(stream, ':');
+}
+
+static void json_bool(json_stream_t* stream, bool value) {
+    if (value) {
+        json_write(stream, "true", 4);
+    } else {
+        json_write(stream, "false", 5);
+    }
+}
+
+static void json_int(json_stream_t* stream, int64_t value) {
+    char text[24];
+    int n = snprintf(text, sizeof(text), "%lld", (long long)value);
+    json_write(stream, text, n);
+}
+
+static void json_float(json_stream_t* stream, float value, int decimals) {
+    if (!std::isfinite(value)) {
+        json_write(stream, "null", 4);
+        return;
+    }
+    char text[24];
+    int n = snprintf(text, sizeof(text), "%.*f", decimals, (double)value);
+    json_write(stream, text, n);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// OUTPUT SINKS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    char* buffer;
+    size_t size;
+    size_t length;
+} json_buffer_sink_t;
+
+static esp_err_t json_buffer_sink(void* ctx, const char* data, size_t length) {
+    json_buffer_sink_t* out = (json_buffer_sink_t*)ctx;
+    if (out->length + length + 1 > out->size) return ESP_ERR_INVALID_SIZE;
+    memcpy(out->buffer + out->length, data, length);
+    out->length += length;
+    out->buffer[out->length] = '\0';
+    return ESP_OK;
+}
+
+static esp_err_t json_chunk_sink(void* ctx, const char* data, size_t length) {
+    return httpd_resp_send_chunk((httpd_req_t*)ctx, data, length);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STATUS FIELD TABLE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef enum {
+    STATUS_GROUP_SYSTEM = 0,
+    STATUS_GROUP_SENSORS,
+    STATUS_GROUP_AVAILABILITY,
+    STATUS_GROUP_HALL,
+    STATUS_GROUP_ACCEL,
+    STATUS_GROUP_HARDWARE,
+    STATUS_GROUP_WIRE,
+    STATUS_GROUP_AUTO,
+    STATUS_GROUP_MANUAL,
+    STATUS_GROUP_COUNT
+} status_group_t;
+
+static const char* const STATUS_GROUP_NAMES[STATUS_GROUP_COUNT] = {
+    "system", "sensors", "availability", "hall", "accel",
+    "hardware", "wire", "auto", "manual"
+};
+
+// Order is the document order of the legacy /api/status response
+typedef enum {
+    FIELD_SYSTEM_HEALTHY = 0,
+    FIELD_CURRENT_MODE,
+    FIELD_CURRENT_MODE_STATUS,
+    FIELD_ERROR_MESSAGE,
+    FIELD_SENSORS_VALIDATED,
+    FIELD_SENSOR_VALIDATION_STATE,
+    FIELD_SENSOR_VALIDATION_MESSAGE,
+    FIELD_HALL_VALIDATION_COMPLETE,
+    FIELD_ACCEL_VALIDATION_COMPLETE,
+    FIELD_WIRE_LEARNING_AVAILABILITY,
+    FIELD_AUTOMATIC_AVAILABILITY,
+    FIELD_MANUAL_AVAILABILITY,
+    FIELD_HALL_STATUS,
+    FIELD_HALL_PULSES,
+    FIELD_WHEEL_RPM,
+    FIELD_WHEEL_SPEED,
+    FIELD_WHEEL_ROTATION_DETECTED,
+    FIELD_ACCEL_STATUS,
+    FIELD_ACCEL_TOTAL,
+    FIELD_LAST_IMPACT,
+    FIELD_IMPACT_THRESHOLD,
+    FIELD_TROLLEY_SHAKE_DETECTED,
+    FIELD_ESC_ARMED,
+    FIELD_POSITION_M,
+    FIELD_CURRENT_SPEED_MS,
+    FIELD_TARGET_SPEED_MS,
+    FIELD_DIRECTION_FORWARD,
+    FIELD_ROTATIONS,
+    FIELD_WIRE_LEARNING_COMPLETE,
+    FIELD_WIRE_LENGTH_M,
+    FIELD_WIRE_LEARNING_STATE,
+    FIELD_WIRE_LEARNING_PROGRESS,
+    FIELD_CALIBRATION_STATE,
+    FIELD_CALIBRATION_SITE,
+    FIELD_AUTO_CYCLE_COUNT,
+    FIELD_AUTO_CYCLE_INTERRUPTED,
+    FIELD_AUTO_COASTING_CALIBRATED,
+    FIELD_AUTOMATIC_STATE,
+    FIELD_AUTOMATIC_PROGRESS,
+    FIELD_MANUAL_SPEED,
+    FIELD_MANUAL_DIRECTION_FORWARD,
+    FIELD_MANUAL_ESC_ARMED,
+    FIELD_MANUAL_MOTOR_ACTIVE,
+    FIELD_MANUAL_STATE,
+    FIELD_COUNT
+} status_field_t;
+
+typedef struct {
+    const char* name;
+    status_group_t group;
+} status_field_desc_t;
+
+static const status_field_desc_t STATUS_FIELDS[FIELD_COUNT] = {
+    {"system_healthy",             STATUS_GROUP_SYSTEM},
+    {"current_mode",               STATUS_GROUP_SYSTEM},
+    {"current_mode_status",        STATUS_GROUP_SYSTEM},
+    {"error_message",              STATUS_GROUP_SYSTEM},
+    {"sensors_validated",          STATUS_GROUP_SENSORS},
+    {"sensor_validation_state",    STATUS_GROUP_SENSORS},
+    {"sensor_validation_message",  STATUS_GROUP_SENSORS},
+    {"hall_validation_complete",   STATUS_GROUP_SENSORS},
+    {"accel_validation_complete",  STATUS_GROUP_SENSORS},
+    {"wire_learning_availability", STATUS_GROUP_AVAILABILITY},
+    {"automatic_availability",     STATUS_GROUP_AVAILABILITY},
+    {"manual_availability",        STATUS_GROUP_AVAILABILITY},
+    {"hall_status",                STATUS_GROUP_HALL},
+    {"hall_pulses",                STATUS_GROUP_HALL},
+    {"wheel_rpm",                  STATUS_GROUP_HALL},
+    {"wheel_speed",                STATUS_GROUP_HALL},
+    {"wheel_rotation_detected",    STATUS_GROUP_HALL},
+    {"accel_status",               STATUS_GROUP_ACCEL},
+    {"accel_total",                STATUS_GROUP_ACCEL},
+    {"last_impact",                STATUS_GROUP_ACCEL},
+    {"impact_threshold",           STATUS_GROUP_ACCEL},
+    {"trolley_shake_detected",     STATUS_GROUP_ACCEL},
+    {"esc_armed",                  STATUS_GROUP_HARDWARE},
+    {"position_m",                 STATUS_GROUP_HARDWARE},
+    {"current_speed_ms",           STATUS_GROUP_HARDWARE},
+    {"target_speed_ms",            STATUS_GROUP_HARDWARE},
+    {"direction_forward",          STATUS_GROUP_HARDWARE},
+    {"rotations",                  STATUS_GROUP_HARDWARE},
+    {"wire_learning_complete",     STATUS_GROUP_WIRE},
+    {"wire_length_m",              STATUS_GROUP_WIRE},
+    {"wire_learning_state",        STATUS_GROUP_WIRE},
+    {"wire_learning_progress",     STATUS_GROUP_WIRE},
+    {"calibration_state",          STATUS_GROUP_WIRE},
+    {"calibration_site",           STATUS_GROUP_WIRE},
+    {"auto_cycle_count",           STATUS_GROUP_AUTO},
+    {"auto_cycle_interrupted",     STATUS_GROUP_AUTO},
+    {"auto_coasting_calibrated",   STATUS_GROUP_AUTO},
+    {"automatic_state",            STATUS_GROUP_AUTO},
+    {"automatic_progress",         STATUS_GROUP_AUTO},
+    {"manual_speed",               STATUS_GROUP_MANUAL},
+    {"manual_direction_forward",   STATUS_GROUP_MANUAL},
+    {"manual_esc_armed",           STATUS_GROUP_MANUAL},
+    {"manual_motor_active",        STATUS_GROUP_MANUAL},
+    {"manual_state",               STATUS_GROUP_MANUAL},
+};
+
+typedef uint64_t status_field_mask_t;
+
+#define STATUS_FIELD_BIT(field)    ((status_field_mask_t)1 << (field))
+#define STATUS_FIELDS_ALL          (STATUS_FIELD_BIT(FIELD_COUNT) - 1)
+
+static_assert(FIELD_COUNT <= 63, "status field mask is 64 bits");
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// LAZY STATUS SOURCES - each snapshot is read at most once per document
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define SOURCE_MODE       (1u << 0)
+#define SOURCE_HARDWARE   (1u << 1)
+#define SOURCE_SENSORS    (1u << 2)
+#define SOURCE_ESTIMATE   (1u << 3)
+
+typedef struct {
+    uint32_t loaded;
+    system_mode_status_t mode;
+    hardware_status_t hardware;
+    sensor_health_t sensors;
+    state_estimate_t estimate;
+} status_sources_t;
+
+static const system_mode_status_t* source_mode(status_sources_t* src) {
+    if (!(src->loaded & SOURCE_MODE)) {
+        src->mode = mode_coordinator_get_status();
+        src->loaded |= SOURCE_MODE;
+    }
+    return &src->mode;
+}
+
+static const hardware_status_t* source_hardware(status_sources_t* src) {
+    if (!(src->loaded & SOURCE_HARDWARE)) {
+        src->hardware = hardware_get_status();
+        src->loaded |= SOURCE_HARDWARE;
+    }
+    return &src->hardware;
+}
+
+static const sensor_health_t* source_sensors(status_sources_t* src) {
+    if (!(src->loaded & SOURCE_SENSORS)) {
+        src->sensors = sensor_health_get_status();
+        src->loaded |= SOURCE_SENSORS;
+    }
+    return &src->sensors;
+}
+
+static const state_estimate_t* source_estimate(status_sources_t* src) {
+    if (!(src->loaded & SOURCE_ESTIMATE)) {
+        src->estimate = state_estimator_get_state();
+        src->loaded |= SOURCE_ESTIMATE;
+    }
+    return &src->estimate;
+}
+
+static const char* sensor_status_to_string(sensor_status_t status) {
+    switch (status) {
+        case SENSOR_STATUS_HEALTHY: return "healthy";
+        case SENSOR_STATUS_FAILED:  return "failed";
+        case SENSOR_STATUS_TIMEOUT: return "timeout";
+        default:                    return "testing";
+    }
+}
+
+static void emit_field(json_stream_t* out, status_field_t field, status_sources_t* src) {
+    json_key(out, STATUS_FIELDS[field].name);
+
+    switch (field) {
         // System Status
-        mode_status.system_healthy ? "true" : "false",
-        mode_coordinator_mode_to_string(mode_status.current_mode),
-        mode_status.current_mode_status,
-        mode_status.error_message,
-        
+        case FIELD_SYSTEM_HEALTHY:
+            json_bool(out, source_mode(src)->system_healthy);
+            break;
+        case FIELD_CURRENT_MODE:
+            json_write_string(out, mode_coordinator_mode_to_string(source_mode(src)->current_mode));
+            break;
+        case FIELD_CURRENT_MODE_STATUS:
+            json_write_string(out, status_text_to_string(source_mode(src)->current_mode_text));
+            break;
+        case FIELD_ERROR_MESSAGE:
+            json_write_string(out, status_text_to_string(source_mode(src)->error_text));
+            break;
+
         // Sensor Validation
-        mode_status.sensors_validated ? "true" : "false",
-        mode_coordinator_validation_to_string(mode_status.sensor_validation_state),
-        mode_status.sensor_validation_message,
-        mode_status.hall_validation_complete ? "true" : "false",
-        mode_status.accel_validation_complete ? "true" : "false",
-        
+        case FIELD_SENSORS_VALIDATED:
+            json_bool(out, source_mode(src)->sensors_validated);
+            break;
+        case FIELD_SENSOR_VALIDATION_STATE:
+            json_write_string(out, mode_coordinator_validation_to_string(source_mode(src)->sensor_validation_state));
+            break;
+        case FIELD_SENSOR_VALIDATION_MESSAGE:
+            json_write_string(out, status_text_to_string(source_mode(src)->sensor_validation_text));
+            break;
+        case FIELD_HALL_VALIDATION_COMPLETE:
+            json_bool(out, source_mode(src)->hall_validation_complete);
+            break;
+        case FIELD_ACCEL_VALIDATION_COMPLETE:
+            json_bool(out, source_mode(src)->accel_validation_complete);
+            break;
+
         // Mode Availability
-        mode_coordinator_availability_to_string(mode_status.wire_learning_availability),
-        mode_coordinator_availability_to_string(mode_status.automatic_availability),
-        mode_coordinator_availability_to_string(mode_status.manual_availability),
-        
+        case FIELD_WIRE_LEARNING_AVAILABILITY:
+            json_write_string(out, mode_coordinator_availability_to_string(source_mode(src)->wire_learning_availability));
+            break;
+        case FIELD_AUTOMATIC_AVAILABILITY:
+            json_write_string(out, mode_coordinator_availability_to_string(source_mode(src)->automatic_availability));
+            break;
+        case FIELD_MANUAL_AVAILABILITY:
+            json_write_string(out, mode_coordinator_availability_to_string(source_mode(src)->manual_availability));
+            break;
+
         // Hall Sensor Data
-        sensor_status.hall_status == SENSOR_STATUS_HEALTHY ? "healthy" :
-        sensor_status.hall_status == SENSOR_STATUS_FAILED ? "failed" :
-        sensor_status.hall_status == SENSOR_STATUS_TIMEOUT ? "timeout" : "testing",
-        sensor_status.hall_pulse_count,
-        sensor_status.current_rpm,
-        sensor_status.wheel_speed_ms,
-        sensor_status.wheel_rotation_detected ? "true" : "false",
-        
+        case FIELD_HALL_STATUS:
+            json_write_string(out, sensor_status_to_string(source_sensors(src)->hall_status));
+            break;
+        case FIELD_HALL_PULSES:
+            json_int(out, source_sensors(src)->hall_pulse_count);
+            break;
+        case FIELD_WHEEL_RPM:
+            json_float(out, source_sensors(src)->current_rpm, 1);
+            break;
+        case FIELD_WHEEL_SPEED:
+            json_float(out, source_sensors(src)->wheel_speed_ms, 2);
+            break;
+        case FIELD_WHEEL_ROTATION_DETECTED:
+            json_bool(out, source_sensors(src)->wheel_rotation_detected);
+            break;
+
         // Accelerometer Data
-        sensor_status.accel_status == SENSOR_STATUS_HEALTHY ? "healthy" :
-        sensor_status.accel_status == SENSOR_STATUS_FAILED ? "failed" :
-        sensor_status.accel_status == SENSOR_STATUS_TIMEOUT ? "timeout" : "testing",
-        sensor_status.total_accel_g,
-        sensor_status.last_impact_g,
-        0.5f, // Default impact threshold
-        sensor_status.trolley_shake_detected ? "true" : "false",
-        
-        // Hardware Status
-        hw_status.esc_armed ? "true" : "false",
-        hw_status.current_position_m,
-        hw_status.current_speed_ms,
-        hw_status.target_speed_ms,
-        hw_status.direction_forward ? "true" : "false",
-        hw_status.total_rotations,
-        
+        case FIELD_ACCEL_STATUS:
+            json_write_string(out, sensor_status_to_string(source_sensors(src)->accel_status));
+            break;
+        case FIELD_ACCEL_TOTAL:
+            json_float(out, source_sensors(src)->total_accel_g, 2);
+            break;
+        case FIELD_LAST_IMPACT:
+            json_float(out, source_sensors(src)->last_impact_g, 2);
+            break;
+        case FIELD_IMPACT_THRESHOLD:
+            json_float(out, 0.5f, 1); // Default impact threshold
+            break;
+        case FIELD_TROLLEY_SHAKE_DETECTED:
+            json_bool(out, source_sensors(src)->trolley_shake_detected);
+            break;
+
+        // Hardware Status (motion from the state estimator)
+        case FIELD_ESC_ARMED:
+            json_bool(out, source_hardware(src)->esc_armed);
+            break;
+        case FIELD_POSITION_M:
+            json_float(out, source_estimate(src)->position_m, 2);
+            break;
+        case FIELD_CURRENT_SPEED_MS:
+            json_float(out, source_estimate(src)->speed_ms, 2);
+            break;
+        case FIELD_TARGET_SPEED_MS:
+            json_float(out, source_hardware(src)->target_speed_ms, 2);
+            break;
+        case FIELD_DIRECTION_FORWARD:
+            json_bool(out, source_hardware(src)->direction_forward);
+            break;
+        case FIELD_ROTATIONS:
+            json_int(out, source_hardware(src)->total_rotations);
+            break;
+
         // Wire Learning Status
-        mode_status.wire_learning.complete ? "true" : "false",
-        mode_status.wire_learning.wire_length_m,
-        wire_learning_state_to_string(wire_progress.state),
-        wire_learning_mode_is_active() ? wire_learning_get_progress_percentage() : 
-            (mode_status.wire_learning.complete ? 100 : 0),
-        
+        case FIELD_WIRE_LEARNING_COMPLETE:
+            json_bool(out, source_mode(src)->wire_learning_complete);
+            break;
+        case FIELD_WIRE_LENGTH_M:
+            json_float(out, source_mode(src)->wire_length_m, 2);
+            break;
+        case FIELD_WIRE_LEARNING_STATE:
+            json_write_string(out, wire_learning_state_to_string(wire_learning_mode_get_state()));
+            break;
+        case FIELD_WIRE_LEARNING_PROGRESS:
+            json_int(out, wire_learning_mode_is_active() ? wire_learning_get_progress_percentage() :
+                          (source_mode(src)->wire_learning_complete ? 100 : 0));
+            break;
+        case FIELD_CALIBRATION_STATE:
+            json_write_string(out, mode_coordinator_calibration_to_string(source_mode(src)->calibration_state));
+            break;
+        case FIELD_CALIBRATION_SITE:
+            json_write_string(out, source_mode(src)->calibration_site_id);
+            break;
+
         // Automatic Mode Status
-        mode_status.auto_cycle_count,
-        mode_status.auto_cycle_interrupted ? "true" : "false",
-        mode_status.auto_coasting_calibrated ? "true" : "false",
-        automatic_mode_state_to_string(auto_progress.state),
-        automatic_mode_is_active() ? automatic_mode_get_progress_percentage() : 0,
-        
+        case FIELD_AUTO_CYCLE_COUNT:
+            json_int(out, source_mode(src)->auto_cycle_count);
+            break;
+        case FIELD_AUTO_CYCLE_INTERRUPTED:
+            json_bool(out, source_mode(src)->auto_cycle_interrupted);
+            break;
+        case FIELD_AUTO_COASTING_CALIBRATED:
+            json_bool(out, source_mode(src)->auto_coasting_calibrated);
+            break;
+        case FIELD_AUTOMATIC_STATE:
+            json_write_string(out, automatic_mode_state_to_string(automatic_mode_get_state()));
+            break;
+        case FIELD_AUTOMATIC_PROGRESS:
+            json_int(out, automatic_mode_is_active() ? automatic_mode_get_progress_percentage() : 0);
+            break;
+
         // Manual Mode Status
-        manual_status.current_speed_ms,
-        manual_status.direction_forward ? "true" : "false",
-        manual_status.esc_armed ? "true" : "false",
-        manual_status.motor_active ? "true" : "false",
-        manual_mode_state_to_string(manual_status.state)
-    );
-    
+        case FIELD_MANUAL_SPEED:
+            json_float(out, manual_mode_is_active() ? source_estimate(src)->speed_ms : 0.0f, 2);
+            break;
+        case FIELD_MANUAL_DIRECTION_FORWARD:
+            json_bool(out, manual_mode_is_active() && manual_mode_get_current_direction());
+            break;
+        case FIELD_MANUAL_ESC_ARMED:
+            json_bool(out, manual_mode_is_active() && manual_mode_is_esc_armed());
+            break;
+        case FIELD_MANUAL_MOTOR_ACTIVE:
+            json_bool(out, manual_mode_is_active() && manual_mode_is_moving());
+            break;
+        case FIELD_MANUAL_STATE:
+            json_write_string(out, manual_mode_state_to_string(manual_mode_get_state()));
+            break;
+
+        default:
+            json_write(out, "null", 4);
+            break;
+    }
+}
+
+/**
+ * @brief Stream the selected status fields as one JSON object
+ * @return First sink error, ESP_OK if the whole document was written
+ */
+static esp_err_t render_status(status_field_mask_t fields, json_sink_t sink, void* sink_ctx) {
+    json_stream_t out;
+    status_sources_t src;
+    src.loaded = 0;
+
+    json_stream_init(&out, sink, sink_ctx);
+    json_write_char(&out, '{');
+    for (int field = 0; field < FIELD_COUNT; field++) {
+        if (fields & STATUS_FIELD_BIT(field)) {
+            emit_field(&out, (status_field_t)field, &src);
+        }
+    }
+    json_write_char(&out, '}');
+    json_flush(&out);
+
+    return out.error;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FIELD FILTER (?fields=name,group,...)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static status_field_mask_t lookup_filter_token(const char* token, size_t length) {
+    for (int group = 0; group < STATUS_GROUP_COUNT; group++) {
+        if (strlen(STATUS_GROUP_NAMES[group]) == length &&
+            strncmp(STATUS_GROUP_NAMES[group], token, length) == 0) {
+            status_field_mask_t mask = 0;
+            for (int field = 0; field < FIELD_COUNT; field++) {
+                if (STATUS_FIELDS[field].group == group) mask |= STATUS_FIELD_BIT(field);
+            }
+            return mask;
+        }
+    }
+    for (int field = 0; field < FIELD_COUNT; field++) {
+        if (strlen(STATUS_FIELDS[field].name) == length &&
+            strncmp(STATUS_FIELDS[field].name, token, length) == 0) {
+            return STATUS_FIELD_BIT(field);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Build the field mask from the request query
+ * @return STATUS_FIELDS_ALL when there is no fields= parameter, unknown names are ignored
+ */
+static status_field_mask_t parse_fields_filter(httpd_req_t* req) {
+    char query[WEB_STATUS_QUERY_SIZE];
+    char value[WEB_STATUS_QUERY_SIZE];
+
+    if (httpd_req_get_url_query_len(req) == 0 ||
+        httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK ||
+        httpd_query_key_value(query, "fields", value, sizeof(value)) != ESP_OK) {
+        return STATUS_FIELDS_ALL;
+    }
+
+    status_field_mask_t mask = 0;
+    const char* token = value;
+    while (*token != '\0') {
+        const char* end = strchr(token, ',');
+        size_t length = end ? (size_t)(end - token) : strlen(token);
+        mask |= lookup_filter_token(token, length);
+        token += length;
+        if (*token == ',') token++;
+    }
+    return mask;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FULL DOCUMENT CACHE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Everything the full document depends on. Snapshot generations cover the
+// published structs; the rest (mode state machines, estimator output at the
+// precision it is printed with) is folded into a fingerprint.
+typedef struct {
+    uint32_t mode_generation;
+    uint32_t hardware_generation;
+    uint32_t sensor_generation;
+    uint32_t fingerprint;
+} status_cache_key_t;
+
+static char* g_status_cache = NULL;              // WEB_JSON_BUFFER_SIZE, PSRAM when present
+static size_t g_status_cache_length = 0;
+static bool g_status_cache_valid = false;
+static status_cache_key_t g_status_cache_key = {0, 0, 0, 0};
+static SemaphoreHandle_t g_status_cache_mutex = NULL;
+
+static inline uint32_t fingerprint_mix(uint32_t hash, int32_t value) {
+    // FNV-1a over the 4 bytes of value
+    for (int i = 0; i < 4; i++) {
+        hash ^= (uint32_t)(value >> (i * 8)) & 0xFF;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static status_cache_key_t build_cache_key(void) {
+    status_cache_key_t key;
+    key.mode_generation = mode_coordinator_get_status_generation();
+    key.hardware_generation = hardware_get_status_generation();
+    key.sensor_generation = sensor_health_get_status_generation();
+
+    bool wire_active = wire_learning_mode_is_active();
+    bool auto_active = automatic_mode_is_active();
+    bool manual_active = manual_mode_is_active();
+
+    uint32_t hash = 2166136261u;
+    hash = fingerprint_mix(hash, (int32_t)lroundf(state_estimator_get_speed() * 100.0f));
+    hash = fingerprint_mix(hash, (int32_t)lroundf(state_estimator_get_position() * 100.0f));
+    hash = fingerprint_mix(hash, wire_learning_mode_get_state());
+    hash = fingerprint_mix(hash, wire_active ? wire_learning_get_progress_percentage() : -1);
+    hash = fingerprint_mix(hash, automatic_mode_get_state());
+    hash = fingerprint_mix(hash, auto_active ? automatic_mode_get_progress_percentage() : -1);
+    hash = fingerprint_mix(hash, manual_mode_get_state());
+    hash = fingerprint_mix(hash, manual_active ? ((manual_mode_get_current_direction() ? 1 : 0) |
+                                                  (manual_mode_is_esc_armed() ? 2 : 0) |
+                                                  (manual_mode_is_moving() ? 4 : 0)) : -1);
+    key.fingerprint = hash;
+    return key;
+}
+
+static inline bool cache_key_equal(const status_cache_key_t* a, const status_cache_key_t* b) {
+    return a->mode_generation == b->mode_generation &&
+           a->hardware_generation == b->hardware_generation &&
+           a->sensor_generation == b->sensor_generation &&
+           a->fingerprint == b->fingerprint;
+}
+
+esp_err_t web_status_cache_init(void) {
+    if (g_status_cache_mutex == NULL) {
+        g_status_cache_mutex = xSemaphoreCreateMutex();
+        if (g_status_cache_mutex == NULL) {
+            ESP_LOGE(TAG, "Failed to create status cache mutex");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (g_status_cache == NULL) {
+        // Read once per GET and copied out by httpd: PSRAM speed is plenty
+        g_status_cache = (char*)heap_caps_malloc(WEB_JSON_BUFFER_SIZE, MALLOC_CAP_SPIRAM);
+        if (g_status_cache == NULL) {
+            g_status_cache = (char*)heap_caps_malloc(WEB_JSON_BUFFER_SIZE, MALLOC_CAP_8BIT);
+        }
+        if (g_status_cache == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate status cache");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    g_status_cache_valid = false;
     return ESP_OK;
 }
 
+/**
+ * @brief Send the full document from cache, re-rendering it if a source changed
+ * @return ESP_OK if sent, ESP_ERR_INVALID_STATE if the cache is unavailable
+ *         (busy or document too large) and the caller should stream instead
+ */
+static esp_err_t send_cached_status(httpd_req_t* req, bool* cache_hit) {
+    if (g_status_cache == NULL || g_status_cache_mutex == NULL ||
+        xSemaphoreTake(g_status_cache_mutex, 0) != pdTRUE) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    status_cache_key_t key = build_cache_key();
+    bool hit = g_status_cache_valid && cache_key_equal(&key, &g_status_cache_key);
+
+    if (!hit) {
+        json_buffer_sink_t sink = {g_status_cache, WEB_JSON_BUFFER_SIZE, 0};
+        esp_err_t result = render_status(STATUS_FIELDS_ALL, json_buffer_sink, &sink);
+        g_status_cache_valid = (result == ESP_OK);
+        if (!g_status_cache_valid) {
+            xSemaphoreGive(g_status_cache_mutex);
+            ESP_LOGW(TAG, "Status document exceeds cache (%d bytes), streaming", WEB_JSON_BUFFER_SIZE);
+            return ESP_ERR_INVALID_STATE;
+        }
+        g_status_cache_length = sink.length;
+        g_status_cache_key = key;
+    }
+
+    esp_err_t result = httpd_resp_send(req, g_status_cache, g_status_cache_length);
+    xSemaphoreGive(g_status_cache_mutex);
+
+    *cache_hit = hit;
+    return result;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STATUS JSON GENERATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t web_send_status_json(httpd_req_t* req, bool* cache_hit) {
+    if (req == NULL) return ESP_ERR_INVALID_ARG;
+
+    bool hit = false;
+    status_field_mask_t fields = parse_fields_filter(req);
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+
+    esp_err_t result = ESP_ERR_INVALID_STATE;
+    if (fields == STATUS_FIELDS_ALL) {
+        result = send_cached_status(req, &hit);
+    }
+
+    if (result == ESP_ERR_INVALID_STATE) {
+        // Filtered, cache busy or oversized: stream chunked from the snapshots
+        result = render_status(fields, json_chunk_sink, req);
+        if (result == ESP_OK) {
+            result = httpd_resp_send_chunk(req, NULL, 0);
+        }
+    }
+
+    if (cache_hit != NULL) *cache_hit = hit;
+    return result;
+}
+
+esp_err_t web_generate_status_json(char* json_buffer, size_t buffer_size) {
+    if (json_buffer == NULL || buffer_size == 0) return ESP_ERR_INVALID_ARG;
+
+    json_buffer_sink_t sink = {json_buffer, buffer_size, 0};
+    json_buffer[0] = '\0';
+    return render_status(STATUS_FIELDS_ALL, json_buffer_sink, &sink);
+}
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // UTILITY FUNCTIONS
 // ═══════════════════════════════════════════════════════════════════════════════
 
 esp_err_t web_generate_simple_status_json(char* json_buffer, size_t buffer_size) {
     if (json_buffer == NULL) return ESP_ERR_INVALID_ARG;
-    
+
     // Lightweight status for frequent polling
     system_mode_status_t mode_status = mode_coordinator_get_status();
     hardware_status_t hw_status = hardware_get_status();
     sensor_health_t sensor_status = sensor_health_get_status();
-    
+
     snprintf(json_buffer, buffer_size,
         "{"
         "\"mode\": \"%s\","
@@ -206,22 +751,22 @@ esp_err_t web_generate_simple_status_json(char* json_buffer, size_t buffer_size)
         "}",
         mode_coordinator_mode_to_string(mode_status.current_mode),
         mode_status.system_healthy ? "true" : "false",
-        hw_status.current_speed_ms,
+        state_estimator_get_speed(),
         sensor_status.hall_pulse_count,
         sensor_status.total_accel_g,
         hw_status.esc_armed ? "true" : "false"
     );
-    
+
     return ESP_OK;
 }
 
 esp_err_t web_generate_sensor_status_json(char* json_buffer, size_t buffer_size) {
     if (json_buffer == NULL) return ESP_ERR_INVALID_ARG;
-    
+
     // Sensor-specific status for validation UI
     sensor_health_t sensor_status = sensor_health_get_status();
     system_mode_status_t mode_status = mode_coordinator_get_status();
-    
+
     snprintf(json_buffer, buffer_size,
         "{"
         "\"validation_state\": \"%s\","
@@ -235,7 +780,7 @@ esp_err_t web_generate_sensor_status_json(char* json_buffer, size_t buffer_size)
         "\"sensors_validated\": %s"
         "}",
         mode_coordinator_validation_to_string(mode_status.sensor_validation_state),
-        mode_status.sensor_validation_message,
+        status_text_to_string(mode_status.sensor_validation_text),
         sensor_status.hall_status == SENSOR_STATUS_HEALTHY ? "true" : "false",
         sensor_status.hall_pulse_count,
         sensor_status.wheel_rotation_detected ? "true" : "false",
@@ -244,16 +789,16 @@ esp_err_t web_generate_sensor_status_json(char* json_buffer, size_t buffer_size)
         sensor_status.trolley_shake_detected ? "true" : "false",
         mode_status.sensors_validated ? "true" : "false"
     );
-    
+
     return ESP_OK;
 }
 
 esp_err_t web_generate_mode_status_json(char* json_buffer, size_t buffer_size) {
     if (json_buffer == NULL) return ESP_ERR_INVALID_ARG;
-    
+
     // Mode-specific status for mode selection UI
     system_mode_status_t mode_status = mode_coordinator_get_status();
-    
+
     snprintf(json_buffer, buffer_size,
         "{"
         "\"current_mode\": \"%s\","
@@ -268,10 +813,10 @@ esp_err_t web_generate_mode_status_json(char* json_buffer, size_t buffer_size) {
         mode_coordinator_availability_to_string(mode_status.wire_learning_availability),
         mode_coordinator_availability_to_string(mode_status.automatic_availability),
         mode_coordinator_availability_to_string(mode_status.manual_availability),
-        mode_status.wire_learning.complete ? "true" : "false",
-        mode_status.wire_learning.wire_length_m,
+        mode_status.wire_learning_complete ? "true" : "false",
+        mode_status.wire_length_m,
         mode_status.auto_cycle_count
     );
-    
+
     return ESP_OK;
-}
\ No newline at end of file
+}
@@ -0,0 +1,801 @@
+// components/web_interface/src/web_telemetry.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// WEB_TELEMETRY.CPP - WEBSOCKET TELEMETRY PUSH AND COMMAND CHANNEL
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Live data to the browser without HTTP polling
+// - /ws on the existing esp_http_server (CONFIG_HTTPD_WS_SUPPORT)
+// - Telemetry task samples and renders ONE delta frame per tick, the httpd
+//   task fans the same bytes out to every subscriber (cost is per tick,
+//   not per client)
+// - Frames carry only fields that changed, full keyframe every
+//   WEB_TELEMETRY_KEYFRAME_MS and whenever a client joins
+// - Clients that send "fmt=bin" get binary messages instead: every
+//   telemetry_frame_t record captured since the previous tick (hundreds of
+//   Hz), packed back to back, read once per tick for all binary clients
+// - Nothing is rendered while there are no subscribers
+// - Text frames received on the socket are routed like POST /api/command;
+//   queued command outcomes are pushed to everyone as {"e":"cmd"} events
+// - Deferred log records (deferred_log.h) are pushed as {"e":"log"} events
+//   from the log writer task, only while someone is subscribed
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "web_interface.h"
+#include "mode_coordinator.h"
+#include "hardware_control.h"
+#include "sensor_health.h"
+#include "state_estimator.h"
+#include "wire_learning_mode.h"
+#include "automatic_mode.h"
+#include "manual_mode.h"
+#include "command_queue.h"
+#include "telemetry_frame.h"
+#include "perf_monitor.h"
+#include "deferred_log.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "lwip/sockets.h"
+#include <atomic>
+#include <cstring>
+#include <cstdio>
+#include <cstdarg>
+#include <cstdlib>
+
+static_assert(WEB_TELEMETRY_MAX_BATCH * TELEMETRY_FRAME_SIZE <= WEB_TELEMETRY_FRAME_SIZE,
+              "binary batch does not fit a frame slot");
+#include <cmath>
+
+static const char* TAG = "WEB_TELEMETRY";
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// GLOBAL STATE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    int fd;                             // Socket, -1 = free slot
+    bool muted;                         // web_unregister_from_updates()
+    bool binary;                        // Wants binary record batches ("fmt=bin")
+    char ip[16];                        // Peer address for (un)register by IP
+} ws_subscriber_t;
+
+// Which subscribers a queued frame goes to
+typedef enum {
+    WS_AUDIENCE_JSON = 0,               // JSON delta subscribers
+    WS_AUDIENCE_BINARY,                 // Binary record subscribers
+    WS_AUDIENCE_ALL                     // Events (JSON text to everyone)
+} ws_audience_t;
+
+typedef struct {
+    std::atomic<bool> in_flight;        // Claimed: being rendered or queued to httpd
+    ws_audience_t audience;
+    size_t length;
+    char text[WEB_TELEMETRY_FRAME_SIZE];
+} ws_frame_slot_t;
+
+// Sampled values at the precision they are sent with
+typedef struct {
+    int32_t position_cm;
+    int32_t speed_cms;
+    int32_t target_cms;
+    trolley_operation_mode_t mode;
+    const char* mode_state;             // Static string from *_state_to_string()
+    bool esc_armed;
+} telemetry_sample_t;
+
+static httpd_handle_t g_server = NULL;
+static SemaphoreHandle_t g_subscriber_mutex = NULL;
+static ws_subscriber_t g_subscribers[WEB_WS_MAX_CLIENTS];
+static std::atomic<uint32_t> g_active_subscribers{0};
+static std::atomic<uint32_t> g_binary_subscribers{0};
+static ws_frame_slot_t g_frames[WEB_TELEMETRY_FRAME_SLOTS];
+
+static TaskHandle_t g_telemetry_task = NULL;
+static StackType_t g_telemetry_task_stack[WEB_TELEMETRY_TASK_STACK];
+static StaticTask_t g_telemetry_task_tcb;
+static std::atomic<bool> g_enabled{true};
+static std::atomic<uint32_t> g_rate_hz{WEB_TELEMETRY_DEFAULT_HZ};
+static std::atomic<bool> g_keyframe_pending{true};
+static std::atomic<bool> g_binary_reader_reset{true};
+
+// Owned by the telemetry task
+static telemetry_sample_t g_last_sent = {};
+static uint64_t g_last_keyframe_us = 0;
+static uint64_t g_last_impact_time = 0;
+static bool g_impact_primed = false;    // Impacts from before the first tick are not events
+static telemetry_reader_t g_binary_reader = {0, 0};
+static uint32_t g_command_cursor = 0;           // Last command outcome pushed
+static bool g_command_cursor_primed = false;    // Outcomes from before the clients joined are not events
+
+// Statistics (each counter has a single writer task)
+static uint32_t g_frames_rendered = 0;
+static uint32_t g_frames_sent = 0;
+static uint32_t g_frames_dropped = 0;
+static uint32_t g_commands_received = 0;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SUBSCRIBER LIST
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void update_active_count_locked(void) {
+    uint32_t active = 0;
+    uint32_t binary = 0;
+    for (int i = 0; i < WEB_WS_MAX_CLIENTS; i++) {
+        if (g_subscribers[i].fd >= 0 && !g_subscribers[i].muted) {
+            active++;
+            if (g_subscribers[i].binary) binary++;
+        }
+    }
+    g_active_subscribers.store(active, std::memory_order_relaxed);
+    g_binary_subscribers.store(binary, std::memory_order_relaxed);
+}
+
+static void wake_telemetry_task(void) {
+    g_keyframe_pending.store(true, std::memory_order_relaxed);
+    if (g_telemetry_task != NULL) {
+        xTaskNotifyGive(g_telemetry_task);
+    }
+}
+
+static esp_err_t add_subscriber(int fd) {
+    char ip[16];
+    web_get_peer_address(fd, ip, sizeof(ip));
+
+    xSemaphoreTake(g_subscriber_mutex, portMAX_DELAY);
+    int slot = -1;
+    for (int i = 0; i < WEB_WS_MAX_CLIENTS; i++) {
+        if (g_subscribers[i].fd == fd) {
+            slot = i;                   // Socket reused by a new handshake
+            break;
+        }
+        if (slot < 0 && g_subscribers[i].fd < 0) slot = i;
+    }
+    if (slot >= 0) {
+        g_subscribers[slot].fd = fd;
+        g_subscribers[slot].muted = false;
+        g_subscribers[slot].binary = false;
+        strncpy(g_subscribers[slot].ip, ip, sizeof(g_subscribers[slot].ip) - 1);
+        g_subscribers[slot].ip[sizeof(g_subscribers[slot].ip) - 1] = '\0';
+        update_active_count_locked();
+    }
+    xSemaphoreGive(g_subscriber_mutex);
+
+    if (slot < 0) {
+        ESP_LOGW(TAG, "Telemetry client %s rejected - %d subscribers max", ip, WEB_WS_MAX_CLIENTS);
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Telemetry client %s subscribed (fd %d)", ip, fd);
+    wake_telemetry_task();
+    return ESP_OK;
+}
+
+static void remove_subscriber(int fd) {
+    xSemaphoreTake(g_subscriber_mutex, portMAX_DELAY);
+    for (int i = 0; i < WEB_WS_MAX_CLIENTS; i++) {
+        if (g_subscribers[i].fd == fd) {
+            ESP_LOGI(TAG, "Telemetry client %s gone (fd %d)", g_subscribers[i].ip, fd);
+            g_subscribers[i].fd = -1;
+        }
+    }
+    update_active_count_locked();
+    xSemaphoreGive(g_subscriber_mutex);
+}
+
+static esp_err_t set_muted_by_ip(const char* client_ip, bool muted) {
+    if (client_ip == NULL) return ESP_ERR_INVALID_ARG;
+    if (g_subscriber_mutex == NULL) return ESP_ERR_INVALID_STATE;
+
+    int matched = 0;
+    xSemaphoreTake(g_subscriber_mutex, portMAX_DELAY);
+    for (int i = 0; i < WEB_WS_MAX_CLIENTS; i++) {
+        if (g_subscribers[i].fd >= 0 && strcmp(g_subscribers[i].ip, client_ip) == 0) {
+            g_subscribers[i].muted = muted;
+            matched++;
+        }
+    }
+    update_active_count_locked();
+    xSemaphoreGive(g_subscriber_mutex);
+
+    if (matched == 0) return ESP_ERR_NOT_FOUND;
+    if (!muted) wake_telemetry_task();
+    return ESP_OK;
+}
+
+static void set_binary(int fd, bool binary) {
+    xSemaphoreTake(g_subscriber_mutex, portMAX_DELAY);
+    for (int i = 0; i < WEB_WS_MAX_CLIENTS; i++) {
+        if (g_subscribers[i].fd == fd) g_subscribers[i].binary = binary;
+    }
+    update_active_count_locked();
+    xSemaphoreGive(g_subscriber_mutex);
+
+    // New binary clients start at the newest record, JSON clients need a keyframe
+    if (binary) g_binary_reader_reset.store(true, std::memory_order_relaxed);
+    wake_telemetry_task();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FAN-OUT (runs on the httpd task)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static ws_frame_slot_t* claim_frame(void) {
+    for (int i = 0; i < WEB_TELEMETRY_FRAME_SLOTS; i++) {
+        bool expected = false;
+        if (g_frames[i].in_flight.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return &g_frames[i];
+        }
+    }
+    return NULL;
+}
+
+static inline void release_frame(ws_frame_slot_t* frame) {
+    frame->in_flight.store(false, std::memory_order_release);
+}
+
+#if CONFIG_HTTPD_WS_SUPPORT
+
+static void broadcast_work(void* arg) {
+    ws_frame_slot_t* frame = (ws_frame_slot_t*)arg;
+    httpd_handle_t server = g_server;
+
+    // Copy the targets so sends never run under the lock
+    int targets[WEB_WS_MAX_CLIENTS];
+    int target_count = 0;
+    xSemaphoreTake(g_subscriber_mutex, portMAX_DELAY);
+    for (int i = 0; i < WEB_WS_MAX_CLIENTS; i++) {
+        const ws_subscriber_t* sub = &g_subscribers[i];
+        if (sub->fd < 0 || sub->muted) continue;
+        if (frame->audience == WS_AUDIENCE_ALL ||
+            (frame->audience == WS_AUDIENCE_BINARY) == sub->binary) {
+            targets[target_count++] = sub->fd;
+        }
+    }
+    xSemaphoreGive(g_subscriber_mutex);
+
+    httpd_ws_frame_t packet;
+    memset(&packet, 0, sizeof(packet));
+    packet.final = true;
+    packet.type = (frame->audience == WS_AUDIENCE_BINARY) ? HTTPD_WS_TYPE_BINARY : HTTPD_WS_TYPE_TEXT;
+    packet.payload = (uint8_t*)frame->text;
+    packet.len = frame->length;
+
+    for (int i = 0; i < target_count && server != NULL; i++) {
+        int fd = targets[i];
+        // A closed socket number can be reused by a plain HTTP connection
+        if (httpd_ws_get_fd_info(server, fd) != HTTPD_WS_CLIENT_WEBSOCKET ||
+            httpd_ws_send_frame_async(server, fd, &packet) != ESP_OK) {
+            remove_subscriber(fd);
+            continue;
+        }
+        g_frames_sent++;
+    }
+
+    release_frame(frame);
+}
+
+static esp_err_t queue_broadcast(ws_frame_slot_t* frame) {
+    httpd_handle_t server = g_server;
+    if (server == NULL || httpd_queue_work(server, broadcast_work, frame) != ESP_OK) {
+        release_frame(frame);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+#else
+
+static esp_err_t queue_broadcast(ws_frame_slot_t* frame) {
+    release_frame(frame);
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif // CONFIG_HTTPD_WS_SUPPORT
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FRAME RENDERING
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    char* buffer;
+    size_t size;
+    size_t length;
+    bool overflow;
+} frame_writer_t;
+
+static void frame_append(frame_writer_t* out, const char* format, ...) {
+    if (out->overflow) return;
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(out->buffer + out->length, out->size - out->length, format, args);
+    va_end(args);
+    if (n < 0 || (size_t)n >= out->size - out->length) {
+        out->overflow = true;
+        return;
+    }
+    out->length += n;
+}
+
+static const char* active_mode_state(trolley_operation_mode_t mode) {
+    switch (mode) {
+        case TROLLEY_MODE_WIRE_LEARNING:
+            return wire_learning_state_to_string(wire_learning_mode_get_state());
+        case TROLLEY_MODE_AUTOMATIC:
+            return automatic_mode_state_to_string(automatic_mode_get_state());
+        case TROLLEY_MODE_MANUAL:
+            return manual_mode_state_to_string(manual_mode_get_state());
+        default:
+            return "idle";
+    }
+}
+
+static void sample_telemetry(telemetry_sample_t* sample) {
+    hardware_status_t hw = hardware_get_status();
+    sample->position_cm = (int32_t)lroundf(state_estimator_get_position() * 100.0f);
+    sample->speed_cms = (int32_t)lroundf(state_estimator_get_speed() * 100.0f);
+    sample->target_cms = (int32_t)lroundf(hw.target_speed_ms * 100.0f);
+    sample->mode = mode_coordinator_get_current_mode();
+    sample->mode_state = active_mode_state(sample->mode);
+    sample->esc_armed = hw.esc_armed;
+}
+
+/**
+ * @brief Render fields of now that differ from last (all of them for a keyframe)
+ * @return Frame length, 0 if nothing changed or the frame did not fit
+ */
+static size_t render_frame(char* buffer, size_t size, uint64_t now_us,
+                           const telemetry_sample_t* now, const telemetry_sample_t* last,
+                           bool keyframe, float impact_g) {
+    frame_writer_t out = {buffer, size, 0, false};
+    size_t header_length;
+
+    frame_append(&out, "{\"t\":%llu", (unsigned long long)(now_us / 1000));
+    if (keyframe) frame_append(&out, ",\"k\":1");
+    header_length = out.length;
+
+    if (keyframe || now->position_cm != last->position_cm) {
+        frame_append(&out, ",\"p\":%.2f", now->position_cm / 100.0f);
+    }
+    if (keyframe || now->speed_cms != last->speed_cms) {
+        frame_append(&out, ",\"v\":%.2f", now->speed_cms / 100.0f);
+    }
+    if (keyframe || now->target_cms != last->target_cms) {
+        frame_append(&out, ",\"g\":%.2f", now->target_cms / 100.0f);
+    }
+    if (keyframe || now->mode != last->mode) {
+        frame_append(&out, ",\"m\":\"%s\"", mode_coordinator_mode_to_string(now->mode));
+    }
+    if (keyframe || last->mode_state == NULL || strcmp(now->mode_state, last->mode_state) != 0) {
+        frame_append(&out, ",\"ms\":\"%s\"", now->mode_state);
+    }
+    if (keyframe || now->esc_armed != last->esc_armed) {
+        frame_append(&out, ",\"a\":%s", now->esc_armed ? "true" : "false");
+    }
+    if (impact_g >= 0.0f) {
+        frame_append(&out, ",\"imp\":%.2f", impact_g);
+    }
+
+    if (out.length == header_length) return 0;  // Only the timestamp: skip
+    frame_append(&out, "}");
+    return out.overflow ? 0 : out.length;
+}
+
+/**
+ * @brief Queue every record captured since the previous tick to binary clients
+ */
+static void binary_tick(void) {
+    if (g_binary_reader_reset.exchange(false, std::memory_order_relaxed)) {
+        telemetry_reader_init(&g_binary_reader);
+    }
+
+    ws_frame_slot_t* frame = claim_frame();
+    if (frame == NULL) {
+        g_frames_dropped++;             // Records wait in the capture ring
+        return;
+    }
+
+    static telemetry_frame_t records[WEB_TELEMETRY_MAX_BATCH];     // Telemetry task only
+    size_t count = telemetry_reader_read(&g_binary_reader, records, WEB_TELEMETRY_MAX_BATCH);
+    if (count == 0) {
+        release_frame(frame);
+        return;
+    }
+
+    size_t length = 0;
+    for (size_t i = 0; i < count; i++) {
+        length += telemetry_frame_encode(&records[i], (uint8_t*)frame->text + length,
+                                         sizeof(frame->text) - length);
+    }
+    frame->audience = WS_AUDIENCE_BINARY;
+    frame->length = length;
+
+    if (queue_broadcast(frame) != ESP_OK) {
+        g_frames_dropped++;
+        return;
+    }
+    g_frames_rendered++;
+}
+
+/**
+ * @brief Render and queue one JSON delta frame for JSON clients
+ */
+static void json_tick(void) {
+    uint64_t now_us = esp_timer_get_time();
+
+    telemetry_sample_t sample;
+    sample_telemetry(&sample);
+
+    // Impact is an event: reported once per new impact timestamp
+    float impact_g = -1.0f;
+    sensor_health_t sensors = sensor_health_get_status();
+    if (sensors.last_impact_time != g_last_impact_time) {
+        if (g_impact_primed) impact_g = sensors.last_impact_g;
+        g_last_impact_time = sensors.last_impact_time;
+    }
+    g_impact_primed = true;
+
+    bool keyframe = g_keyframe_pending.exchange(false, std::memory_order_relaxed) ||
+                    (now_us - g_last_keyframe_us) >= (WEB_TELEMETRY_KEYFRAME_MS * 1000ULL);
+
+    ws_frame_slot_t* frame = claim_frame();
+    if (frame == NULL) {
+        // httpd is behind: skip this tick, the next delta still covers it
+        g_frames_dropped++;
+        if (keyframe) g_keyframe_pending.store(true, std::memory_order_relaxed);
+        return;
+    }
+
+    frame->audience = WS_AUDIENCE_JSON;
+    frame->length = render_frame(frame->text, sizeof(frame->text), now_us,
+                                 &sample, &g_last_sent, keyframe, impact_g);
+    if (frame->length == 0) {
+        release_frame(frame);
+        return;
+    }
+
+    if (queue_broadcast(frame) != ESP_OK) {
+        g_frames_dropped++;
+        if (keyframe) g_keyframe_pending.store(true, std::memory_order_relaxed);
+        return;
+    }
+
+    g_last_sent = sample;
+    if (keyframe) g_last_keyframe_us = now_us;
+    g_frames_rendered++;
+}
+
+/**
+ * @brief Push queued command outcomes published since the previous tick
+ */
+static void push_command_results(void) {
+    if (!g_command_cursor_primed) {
+        g_command_cursor = command_queue_get_stats().completions;
+        g_command_cursor_primed = true;
+        return;
+    }
+
+    uint32_t cursor = g_command_cursor;
+    command_result_t result;
+    while (command_queue_get_completed_since(&cursor, &result, 1) == 1) {
+        if (result.status != COMMAND_STATUS_COALESCED) {
+            char json[WEB_COMMAND_RESULT_SIZE];
+            if (web_format_command_result(&result, json, sizeof(json)) > 0 &&
+                web_send_real_time_update("cmd", json) == ESP_ERR_NO_MEM) {
+                break;                  // No free frame slot: retry next tick
+            }
+        }
+        g_command_cursor = cursor;
+    }
+}
+
+static void telemetry_tick(void) {
+    push_command_results();
+
+    uint32_t active = g_active_subscribers.load(std::memory_order_relaxed);
+    uint32_t binary = g_binary_subscribers.load(std::memory_order_relaxed);
+
+    if (binary > 0) binary_tick();
+    if (active > binary) json_tick();
+}
+
+static void telemetry_task(void* parameter) {
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (true) {
+        if (g_active_subscribers.load(std::memory_order_relaxed) == 0 ||
+            !g_enabled.load(std::memory_order_relaxed)) {
+            // Idle until a client subscribes or updates are re-enabled
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            g_command_cursor_primed = false;
+            last_wake = xTaskGetTickCount();
+            continue;
+        }
+
+        // Rate rounds to whole RTOS ticks
+        TickType_t period = pdMS_TO_TICKS(1000 / g_rate_hz.load(std::memory_order_relaxed));
+        if (period == 0) period = 1;
+        vTaskDelayUntil(&last_wake, period);
+
+        telemetry_tick();
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// WEBSOCKET HANDLER
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#if CONFIG_HTTPD_WS_SUPPORT
+
+static esp_err_t ws_send_text(httpd_req_t* req, const char* text, size_t length) {
+    httpd_ws_frame_t reply;
+    memset(&reply, 0, sizeof(reply));
+    reply.final = true;
+    reply.type = HTTPD_WS_TYPE_TEXT;
+    reply.payload = (uint8_t*)text;
+    reply.len = length;
+    return httpd_ws_send_frame(req, &reply);
+}
+
+esp_err_t web_handler_ws(httpd_req_t *req) {
+    PERF_SCOPE(PERF_PROBE_HTTP_WS);
+    int fd = httpd_req_to_sockfd(req);
+
+    if (req->method == HTTP_GET) {
+        // Handshake completed by httpd: this socket now receives telemetry
+        add_subscriber(fd);
+        return ESP_OK;
+    }
+
+    httpd_ws_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    esp_err_t ret = httpd_ws_recv_frame(req, &frame, 0);
+    if (ret != ESP_OK) return ret;
+
+    if (frame.type == HTTPD_WS_TYPE_CLOSE) {
+        remove_subscriber(fd);
+        return ESP_OK;
+    }
+    if (frame.type != HTTPD_WS_TYPE_TEXT || frame.len == 0) {
+        return ESP_OK;
+    }
+    if (frame.len > WEB_WS_MAX_RX_SIZE) {
+        ESP_LOGW(TAG, "Dropping %u byte frame from fd %d", (unsigned)frame.len, fd);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    char text[WEB_WS_MAX_RX_SIZE + 1];
+    frame.payload = (uint8_t*)text;
+    ret = httpd_ws_recv_frame(req, &frame, WEB_WS_MAX_RX_SIZE);
+    if (ret != ESP_OK) return ret;
+    text[frame.len] = '\0';
+
+    g_commands_received++;
+
+    char reply[384];
+    int length;
+    if (strcmp(text, "fmt=bin") == 0 || strcmp(text, "fmt=json") == 0) {
+        bool binary = (text[4] == 'b');
+        set_binary(fd, binary);
+        length = snprintf(reply, sizeof(reply),
+                          "{\"type\":\"fmt\",\"format\":\"%s\",\"version\":%d,\"record_size\":%d}",
+                          binary ? "bin" : "json", TELEMETRY_FRAME_VERSION, TELEMETRY_FRAME_SIZE);
+    } else if (strncmp(text, "rate=", 5) == 0) {
+        web_telemetry_set_rate((uint32_t)atoi(text + 5));
+        length = snprintf(reply, sizeof(reply), "{\"type\":\"rate\",\"rate_hz\":%lu}",
+                          (unsigned long)g_rate_hz.load(std::memory_order_relaxed));
+    } else {
+        char client_ip[16];
+        uint32_t client_addr = web_get_peer_address(fd, client_ip, sizeof(client_ip));
+
+        // Same routing and per-client bucket as POST /api/command; a queued
+        // command's outcome follows as an event
+        char response_message[256];
+        uint32_t command_id = 0;
+        esp_err_t result = ESP_ERR_INVALID_STATE;
+        if (!web_rate_limit_allow_command(client_addr, text[0])) {
+            snprintf(response_message, sizeof(response_message), "⚠️ Rate limit exceeded");
+        } else {
+            result = web_submit_command_text(text, client_ip[0] ? client_ip : "websocket",
+                                             response_message, sizeof(response_message), &command_id);
+        }
+        length = snprintf(reply, sizeof(reply),
+                          "{\"type\":\"cmd\",\"success\":%s,\"id\":%lu,\"message\":\"%s\"}",
+                          result == ESP_OK ? "true" : "false", (unsigned long)command_id, response_message);
+    }
+
+    if (length < 0) return ESP_FAIL;
+    if ((size_t)length >= sizeof(reply)) length = sizeof(reply) - 1;
+    return ws_send_text(req, reply, length);
+}
+
+#else
+
+esp_err_t web_handler_ws(httpd_req_t *req) {
+    httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "WebSocket support not built");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif // CONFIG_HTTPD_WS_SUPPORT
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// LOG EVENTS (log writer task)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Deferred log sink: one {"e":"log"} event per record
+ */
+static void push_log_record(esp_log_level_t level, const char* tag, uint32_t timestamp_ms, const char* text) {
+    if (g_active_subscribers.load(std::memory_order_relaxed) == 0) return;
+
+    static const char LEVEL_LETTERS[] = "NEWIDV";
+    char json[DEFERRED_LOG_LINE_SIZE * 2 + 64];
+    int n = snprintf(json, sizeof(json), "{\"t\":%lu,\"l\":\"%c\",\"tag\":\"%s\",\"m\":\"",
+                     (unsigned long)timestamp_ms, LEVEL_LETTERS[level <= ESP_LOG_VERBOSE ? level : 0], tag);
+    size_t length = (size_t)n;
+
+    // Quotes, backslashes and control characters escaped; worst case still fits
+    for (const char* c = text; *c != '\0' && length < sizeof(json) - 8; c++) {
+        if (*c == '"' || *c == '\\') {
+            json[length++] = '\\';
+            json[length++] = *c;
+        } else if ((unsigned char)*c < 0x20) {
+            length += snprintf(json + length, sizeof(json) - length, "\\u%04x", (unsigned char)*c);
+        } else {
+            json[length++] = *c;
+        }
+    }
+    json[length++] = '"';
+    json[length++] = '}';
+    json[length] = '\0';
+
+    // A full frame pool drops the event: the console copy is already out
+    web_send_real_time_update("log", json);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t web_telemetry_init(void) {
+    if (g_subscriber_mutex == NULL) {
+        g_subscriber_mutex = xSemaphoreCreateMutex();
+        if (g_subscriber_mutex == NULL) {
+            ESP_LOGE(TAG, "Failed to create subscriber mutex");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    for (int i = 0; i < WEB_WS_MAX_CLIENTS; i++) {
+        g_subscribers[i].fd = -1;
+        g_subscribers[i].muted = false;
+        g_subscribers[i].binary = false;
+        g_subscribers[i].ip[0] = '\0';
+    }
+    for (int i = 0; i < WEB_TELEMETRY_FRAME_SLOTS; i++) {
+        g_frames[i].in_flight.store(false, std::memory_order_relaxed);
+        g_frames[i].length = 0;
+    }
+    g_active_subscribers.store(0, std::memory_order_relaxed);
+    g_binary_subscribers.store(0, std::memory_order_relaxed);
+    return ESP_OK;
+}
+
+esp_err_t web_telemetry_start(httpd_handle_t server) {
+    if (server == NULL || g_subscriber_mutex == NULL) return ESP_ERR_INVALID_STATE;
+
+#if CONFIG_HTTPD_WS_SUPPORT
+    httpd_uri_t ws_uri;
+    memset(&ws_uri, 0, sizeof(ws_uri));
+    ws_uri.uri = WEB_WS_URI;
+    ws_uri.method = HTTP_GET;
+    ws_uri.handler = web_handler_ws;
+    ws_uri.user_ctx = NULL;
+    ws_uri.is_websocket = true;
+
+    esp_err_t ret = httpd_register_uri_handler(server, &ws_uri);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register %s: %s", WEB_WS_URI, esp_err_to_name(ret));
+        return ret;
+    }
+    g_server = server;
+
+    if (g_telemetry_task == NULL) {
+        g_telemetry_task = xTaskCreateStaticPinnedToCore(telemetry_task, "web_telemetry",
+                                                         WEB_TELEMETRY_TASK_STACK, NULL,
+                                                         WEB_TELEMETRY_TASK_PRIORITY,
+                                                         g_telemetry_task_stack, &g_telemetry_task_tcb,
+                                                         WEB_TELEMETRY_TASK_CORE);
+        if (g_telemetry_task == NULL) {
+            ESP_LOGE(TAG, "Failed to create telemetry task");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    deferred_log_set_sink(push_log_record);
+
+    ESP_LOGI(TAG, "WebSocket telemetry on %s at %lu Hz", WEB_WS_URI,
+             (unsigned long)g_rate_hz.load(std::memory_order_relaxed));
+    return ESP_OK;
+#else
+    ESP_LOGW(TAG, "CONFIG_HTTPD_WS_SUPPORT disabled - clients fall back to polling");
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t web_telemetry_stop(void) {
+    if (g_subscriber_mutex == NULL) return ESP_OK;
+
+    // Task idles once the list is empty; queued frames die with the server
+    xSemaphoreTake(g_subscriber_mutex, portMAX_DELAY);
+    for (int i = 0; i < WEB_WS_MAX_CLIENTS; i++) {
+        g_subscribers[i].fd = -1;
+    }
+    update_active_count_locked();
+    g_server = NULL;
+    xSemaphoreGive(g_subscriber_mutex);
+    deferred_log_set_sink(NULL);
+    return ESP_OK;
+}
+
+esp_err_t web_telemetry_set_rate(uint32_t rate_hz) {
+    if (rate_hz < WEB_TELEMETRY_MIN_HZ) rate_hz = WEB_TELEMETRY_MIN_HZ;
+    if (rate_hz > WEB_TELEMETRY_MAX_HZ) rate_hz = WEB_TELEMETRY_MAX_HZ;
+    g_rate_hz.store(rate_hz, std::memory_order_relaxed);
+    ESP_LOGI(TAG, "Telemetry rate %lu Hz", (unsigned long)rate_hz);
+    return ESP_OK;
+}
+
+web_telemetry_stats_t web_telemetry_get_stats(void) {
+    web_telemetry_stats_t stats;
+#if CONFIG_HTTPD_WS_SUPPORT
+    stats.supported = true;
+#else
+    stats.supported = false;
+#endif
+    stats.enabled = g_enabled.load(std::memory_order_relaxed);
+    stats.rate_hz = g_rate_hz.load(std::memory_order_relaxed);
+    stats.subscribers = g_active_subscribers.load(std::memory_order_relaxed);
+    stats.frames_rendered = g_frames_rendered;
+    stats.frames_sent = g_frames_sent;
+    stats.frames_dropped = g_frames_dropped;
+    stats.commands_received = g_commands_received;
+    return stats;
+}
+
+esp_err_t web_enable_real_time_updates(bool enable) {
+    g_enabled.store(enable, std::memory_order_relaxed);
+    if (enable) wake_telemetry_task();
+    ESP_LOGI(TAG, "Real-time updates %s", enable ? "enabled" : "disabled");
+    return ESP_OK;
+}
+
+esp_err_t web_send_real_time_update(const char* update_type, const char* data) {
+    if (update_type == NULL) return ESP_ERR_INVALID_ARG;
+    if (g_server == NULL || g_active_subscribers.load(std::memory_order_relaxed) == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    ws_frame_slot_t* frame = claim_frame();
+    if (frame == NULL) return ESP_ERR_NO_MEM;
+
+    int n = snprintf(frame->text, sizeof(frame->text), "{\"e\":\"%s\",\"d\":%s}",
+                     update_type, data != NULL ? data : "null");
+    if (n < 0 || (size_t)n >= sizeof(frame->text)) {
+        release_frame(frame);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    frame->audience = WS_AUDIENCE_ALL;
+    frame->length = n;
+    return queue_broadcast(frame) == ESP_OK ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t web_register_for_updates(const char* client_ip) {
+    return set_muted_by_ip(client_ip, false);
+}
+
+esp_err_t web_unregister_from_updates(const char* client_ip) {
+    return set_muted_by_ip(client_ip, true);
+}
@@ -30,7 +30,8 @@ esp_err_t web_get_default_config(web_interface_config_t* config) {
     config->enable_cors = true;
     config->enable_rate_limiting = true;
     config->enable_command_logging = true;
-    config->enable_real_time_updates = false;
+    config->enable_real_time_updates = true;
+    config->telemetry_rate_hz = WEB_TELEMETRY_DEFAULT_HZ;
     strcpy(config->server_name, "ESP32S3_TROLLEY_3MODE");
     
     return ESP_OK;
@@ -186,6 +187,11 @@ esp_err_t web_generate_api_info_json(char* json_buffer, size_t buffer_size) {
         "\"/js/main.js\","
         "\"/api/status\","
         "\"/api/command\","
+        "\"/api/incidents\","
+        "\"/api/incident?id=N\","
+        "\"/api/perf\","
+        "\"/api/fleet\","
+        "\"/ws\","
         "\"/api/info\","
         "\"/api/stats\""
         "],"
@@ -204,6 +210,7 @@ esp_err_t web_generate_stats_json(char* json_buffer, size_t buffer_size) {
     if (json_buffer == NULL) return ESP_ERR_INVALID_ARG;
     
     web_server_stats_t stats = web_interface_get_stats();
+    web_telemetry_stats_t telemetry = web_telemetry_get_stats();
     size_t free_heap, min_free_heap;
     web_get_memory_usage(&free_heap, &min_free_heap);
     
@@ -215,10 +222,25 @@ esp_err_t web_generate_stats_json(char* json_buffer, size_t buffer_size) {
         "\"failed_requests\": %lu,"
         "\"commands_executed\": %lu,"
         "\"status_requests\": %lu,"
+        "\"status_cache_hits\": %lu,"
+        "\"asset_not_modified\": %lu,"
+        "\"async_requests\": %lu,"
+        "\"async_rejected\": %lu,"
+        "\"rate_limited_commands\": %lu,"
         "\"active_connections\": %lu,"
         "\"max_concurrent_connections\": %lu,"
         "\"uptime_ms\": %llu"
         "},"
+        "\"telemetry\": {"
+        "\"supported\": %s,"
+        "\"enabled\": %s,"
+        "\"rate_hz\": %lu,"
+        "\"subscribers\": %lu,"
+        "\"frames_rendered\": %lu,"
+        "\"frames_sent\": %lu,"
+        "\"frames_dropped\": %lu,"
+        "\"commands_received\": %lu"
+        "},"
         "\"performance\": {"
         "\"free_heap\": %zu,"
         "\"min_free_heap\": %zu,"
@@ -236,10 +258,25 @@ esp_err_t web_generate_stats_json(char* json_buffer, size_t buffer_size) {
         stats.failed_requests,
         stats.commands_executed,
         stats.status_requests,
+        stats.status_cache_hits,
+        stats.asset_not_modified,
+        stats.async_requests,
+        stats.async_rejected,
+        stats.rate_limited_commands,
         stats.active_connections,
         stats.max_concurrent_connections,
         web_get_uptime(),
         
+        // Telemetry stats
+        telemetry.supported ? "true" : "false",
+        telemetry.enabled ? "true" : "false",
+        telemetry.rate_hz,
+        telemetry.subscribers,
+        telemetry.frames_rendered,
+        telemetry.frames_sent,
+        telemetry.frames_dropped,
+        telemetry.commands_received,
+        
         // Performance stats
         free_heap,
         min_free_heap,
@@ -337,28 +374,6 @@ esp_err_t web_restart_server(void) {
 // PLACEHOLDER FUNCTIONS (for future features)
 // ═══════════════════════════════════════════════════════════════════════════════
 
-esp_err_t web_enable_real_time_updates(bool enable) {
-    ESP_LOGI(TAG, "Real-time updates %s (feature not implemented)", 
-            enable ? "enabled" : "disabled");
-    return ESP_OK;
-}
-
-esp_err_t web_send_real_time_update(const char* update_type, const char* data) {
-    ESP_LOGD(TAG, "Real-time update: %s - %s (feature not implemented)", 
-            update_type, data);
-    return ESP_OK;
-}
-
-esp_err_t web_register_for_updates(const char* client_ip) {
-    ESP_LOGD(TAG, "Client %s registered for updates (feature not implemented)", client_ip);
-    return ESP_OK;
-}
-
-esp_err_t web_unregister_from_updates(const char* client_ip) {
-    ESP_LOGD(TAG, "Client %s unregistered from updates (feature not implemented)", client_ip);
-    return ESP_OK;
-}
-
 esp_err_t web_set_theme(const char* theme_name) {
     ESP_LOGI(TAG, "Theme set to: %s (feature not implemented)", theme_name);
     return ESP_OK;
@@ -0,0 +1,71 @@
+# components/web_interface/tools/web_assets.py
+# ═══════════════════════════════════════════════════════════════════════════════
+# WEB_ASSETS.PY - GZIP THE WEB UI FOR EMBEDDING IN FLASH
+# ═══════════════════════════════════════════════════════════════════════════════
+#
+# usage: web_assets.py OUT_DIR www/index.html www/main.js
+#
+# Writes OUT_DIR/<name>.gz for every asset and OUT_DIR/web_assets_gen.h with
+# one strong ETag per asset (hash of the compressed bytes, i.e. of exactly
+# what goes on the wire). "@MAIN_JS_VERSION@" in index.html is replaced by
+# main.js's hash, so the page always names the script it was built with and
+# the script can be cached for a year.
+#
+# Output is reproducible (no timestamp or file name in the gzip header): an
+# unchanged UI keeps its ETags across firmware builds.
+# ═══════════════════════════════════════════════════════════════════════════════
+
+import gzip
+import hashlib
+import os
+import sys
+
+
+def etag_of(data):
+    return hashlib.sha256(data).hexdigest()[:16]
+
+
+def compress(data):
+    return gzip.compress(data, compresslevel=9, mtime=0)
+
+
+def symbol_of(name):
+    return name.upper().replace('.', '_').replace('-', '_')
+
+
+def main(argv):
+    if len(argv) < 3:
+        sys.stderr.write('usage: %s OUT_DIR ASSET...\n' % argv[0])
+        return 2
+
+    out_dir = argv[1]
+    sources = {}
+    for path in argv[2:]:
+        with open(path, 'rb') as source:
+            sources[os.path.basename(path)] = source.read()
+
+    # The script is compressed first: its hash goes into the page
+    versions = {}
+    for name in sorted(sources, key=lambda n: n.endswith('.html')):
+        data = sources[name]
+        for other, version in versions.items():
+            data = data.replace(('@%s_VERSION@' % symbol_of(other)).encode(), version.encode())
+        sources[name] = compress(data)
+        versions[name] = etag_of(sources[name])
+
+    header = ['// web_assets_gen.h - generated by tools/web_assets.py, do not edit',
+              '#ifndef WEB_ASSETS_GEN_H',
+              '#define WEB_ASSETS_GEN_H',
+              '']
+    for name in sorted(sources):
+        with open(os.path.join(out_dir, name + '.gz'), 'wb') as out:
+            out.write(sources[name])
+        header.append('#define WEB_ASSET_%s_ETAG "\\"%s\\""' % (symbol_of(name), versions[name]))
+    header += ['', '#endif // WEB_ASSETS_GEN_H', '']
+    with open(os.path.join(out_dir, 'web_assets_gen.h'), 'w') as out:
+        out.write('\n'.join(header))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
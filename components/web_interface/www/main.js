@@ -0,0 +1,314 @@
+// Main JavaScript for 3-Mode Trolley Interface
+
+function sendCommand(cmd) {
+    console.log('Sending command:', cmd);
+    if (ws && ws.readyState === WebSocket.OPEN) {
+        ws.send(cmd);   // Reply arrives as {"type":"cmd",...}
+        return;
+    }
+    fetch('/api/command', {
+        method: 'POST',
+        body: cmd,
+        headers: {'Content-Type': 'text/plain'}
+    })
+    .then(response => response.json())
+    .then(data => {
+        if (data.success) {
+            showMessage(data.message, 'success');
+            if (data.id) pollCommand(data.id, 20);
+        } else {
+            showMessage('Command failed: ' + data.message, 'error');
+        }
+        updateStatus();
+    })
+    .catch(error => {
+        console.error('Error:', error);
+        showMessage('Communication error: ' + error, 'error');
+    });
+}
+
+// Queued commands finish on the control loop; without the socket, ask for the outcome
+function pollCommand(id, tries) {
+    fetch('/api/command?id=' + id)
+    .then(response => response.ok ? response.json() : null)
+    .then(result => {
+        if (!result) return;
+        if (result.status === 'queued') {
+            if (tries > 1) setTimeout(() => pollCommand(id, tries - 1), 50);
+            return;
+        }
+        showCommandResult(result);
+    })
+    .catch(() => {});
+}
+
+function showCommandResult(result) {
+    if (result.status === 'coalesced') return;   // The merged target reports under a later id
+    showMessage(result.message, result.success ? 'success' : 'error');
+    updateStatus();
+}
+
+function showMessage(msg, type) {
+    const statusDiv = document.getElementById('system-status');
+    const className = type === 'success' ? 'success-msg' : type === 'error' ? 'error-msg' : 'warning-msg';
+    statusDiv.innerHTML = '<div class="' + className + '">' + msg + '</div>';
+}
+
+function updateStatus() {
+    fetch('/api/status')
+    .then(response => response.json())
+    .then(data => {
+        updateSystemStatus(data);
+        updateSensorStatus(data);
+        updateModeStatus(data);
+        updateButtons(data);
+        // Binary records carry state enums only: names come from the status document
+        if (liveBinary) document.getElementById('live-state').textContent = data.current_mode + ' / ' + data.current_mode_status;
+    })
+    .catch(error => {
+        console.error('Status update error:', error);
+        document.getElementById('system-status').innerHTML = '<div class="error-msg">Communication Error</div>';
+    });
+}
+
+function updateSystemStatus(data) {
+    const systemDiv = document.getElementById('system-status');
+    if (data.system_healthy) {
+        systemDiv.innerHTML = '<div class="success-msg">✅ System Healthy - ' + data.current_mode_status + '</div>';
+    } else {
+        systemDiv.innerHTML = '<div class="error-msg">❌ System Error: ' + data.error_message + '</div>';
+    }
+
+    const validationDiv = document.getElementById('sensor-validation');
+    if (data.sensors_validated) {
+        validationDiv.innerHTML = '<div class="success-msg">✅ ' + data.sensor_validation_message + '</div>';
+    } else {
+        validationDiv.innerHTML = '<div class="warning-msg">⚠️ ' + data.sensor_validation_message + '</div>';
+    }
+}
+
+function updateSensorStatus(data) {
+    // Hall sensor
+    const hallCard = document.getElementById('hall-sensor');
+    const hallStatus = data.hall_status || 'unknown';
+    hallCard.className = 'sensor-card ' + (hallStatus === 'healthy' ? 'sensor-healthy' : hallStatus === 'failed' ? 'sensor-error' : 'sensor-warning');
+    document.getElementById('hall-sensor-status').textContent = hallStatus;
+    document.getElementById('hall-pulses').textContent = data.hall_pulses || 0;
+    document.getElementById('wheel-rpm').textContent = (data.wheel_rpm || 0).toFixed(1);
+    document.getElementById('wheel-speed').textContent = (data.wheel_speed || 0).toFixed(2);
+    document.getElementById('hall-real-time').textContent = data.wheel_rotation_detected ? '🟢 ROTATING' : '🔴 STOPPED';
+
+    // Accelerometer
+    const accelCard = document.getElementById('accel-sensor');
+    const accelStatus = data.accel_status || 'unknown';
+    accelCard.className = 'sensor-card ' + (accelStatus === 'healthy' ? 'sensor-healthy' : accelStatus === 'failed' ? 'sensor-error' : 'sensor-warning');
+    document.getElementById('accel-sensor-status').textContent = accelStatus;
+    document.getElementById('accel-total').textContent = (data.accel_total || 0).toFixed(2) + 'g';
+    document.getElementById('last-impact').textContent = (data.last_impact || 0).toFixed(2) + 'g';
+    document.getElementById('impact-threshold').textContent = (data.impact_threshold || 0.5).toFixed(1) + 'g';
+    const impactLevel = data.accel_total || 0;
+    document.getElementById('impact-status').textContent = impactLevel > (data.impact_threshold || 0.5) ? '⚠️ IMPACT' : 'SAFE';
+}
+
+function updateModeStatus(data) {
+    // Wire Learning
+    const wireCard = document.getElementById('wire-learning-card');
+    const wireAvail = data.wire_learning_availability || 'blocked';
+    wireCard.className = 'mode-card ' + (wireAvail === 'available' ? 'mode-available' : wireAvail === 'active' ? 'mode-active' : 'mode-blocked');
+    document.getElementById('wire-learning-status').textContent = wireAvail;
+
+    // Automatic
+    const autoCard = document.getElementById('automatic-card');
+    const autoAvail = data.automatic_availability || 'blocked';
+    autoCard.className = 'mode-card ' + (autoAvail === 'available' ? 'mode-available' : autoAvail === 'active' ? 'mode-active' : 'mode-blocked');
+    document.getElementById('automatic-status').textContent = autoAvail;
+    document.getElementById('cycle-count').textContent = data.auto_cycle_count || 0;
+
+    // Manual
+    const manualCard = document.getElementById('manual-card');
+    const manualAvail = data.manual_availability || 'blocked';
+    manualCard.className = 'mode-card ' + (manualAvail === 'available' ? 'mode-available' : manualAvail === 'active' ? 'mode-active' : 'mode-blocked');
+    document.getElementById('manual-status').textContent = manualAvail;
+    document.getElementById('manual-speed').textContent = (data.manual_speed || 0).toFixed(1) + ' m/s';
+    document.getElementById('manual-direction').textContent = data.manual_direction_forward ? 'Forward' : 'Reverse';
+
+    // Show/hide manual controls
+    const manualControls = document.getElementById('manual-controls');
+    manualControls.style.display = (data.current_mode === 'Manual') ? 'block' : 'none';
+}
+
+function updateButtons(data) {
+    const sensorsValidated = data.sensors_validated || false;
+    const wireComplete = data.wire_learning_complete || false;
+    const currentMode = data.current_mode || 'None';
+
+    // Sensor validation buttons
+    document.getElementById('confirm-hall-btn').disabled = data.sensor_validation_state !== 'hall_pending';
+    document.getElementById('confirm-accel-btn').disabled = data.sensor_validation_state !== 'accel_pending';
+
+    // Mode buttons
+    document.getElementById('wire-learning-btn').disabled = !sensorsValidated || currentMode !== 'None';
+    document.getElementById('automatic-btn').disabled = !sensorsValidated || !wireComplete || currentMode !== 'None';
+    document.getElementById('manual-btn').disabled = !sensorsValidated || currentMode !== 'None';
+    document.getElementById('interrupt-btn').disabled = currentMode !== 'Automatic';
+}
+
+// Live telemetry over WebSocket; /api/status only for the full document
+let ws = null;
+let pollTimer = null;
+let liveBinary = false;
+const live = {};
+
+// Binary telemetry records (telemetry_frame.h, version 1, little-endian)
+const TELEMETRY_VERSION = 1;
+const TELEMETRY_RECORD_SIZE = 26;
+const MODE_NAMES = ['None', 'Wire Learning', 'Automatic', 'Manual'];
+
+function decodeRecord(view, offset) {
+    if (view.getUint8(offset) !== TELEMETRY_VERSION) return null;
+    return {
+        flags: view.getUint8(offset + 1),
+        seq: view.getUint16(offset + 2, true),
+        t: view.getUint32(offset + 4, true) / 1000,
+        p: view.getInt32(offset + 8, true) / 1000,
+        v: view.getInt16(offset + 12, true) / 1000,
+        g: view.getInt16(offset + 14, true) / 1000,
+        duty: view.getUint16(offset + 16, true),
+        accel: view.getInt16(offset + 18, true) / 1000,
+        accelTotal: view.getUint16(offset + 20, true) / 1000,
+        mode: view.getUint8(offset + 22),
+        state: view.getUint8(offset + 23),
+        sensors: view.getUint8(offset + 24),
+        system: view.getUint8(offset + 25)
+    };
+}
+
+function applyRecords(buffer) {
+    const view = new DataView(buffer);
+    let newest = null;
+    for (let offset = 0; offset + TELEMETRY_RECORD_SIZE <= buffer.byteLength; offset += TELEMETRY_RECORD_SIZE) {
+        const record = decodeRecord(view, offset);
+        if (record) newest = record;
+    }
+    if (!newest) return;
+
+    const stateChanged = newest.mode !== live.mode || newest.state !== live.state;
+    live.mode = newest.mode;
+    live.state = newest.state;
+    applyTelemetry({t: newest.t, p: newest.p, v: Math.abs(newest.v), g: Math.abs(newest.g)});
+    if (stateChanged) updateStatus();
+}
+
+function startPolling(intervalMs) {
+    if (pollTimer) clearInterval(pollTimer);
+    pollTimer = setInterval(updateStatus, intervalMs);
+}
+
+function applyTelemetry(frame) {
+    const stateChanged = ('m' in frame && frame.m !== live.m) || ('ms' in frame && frame.ms !== live.ms);
+    Object.assign(live, frame);
+    if ('p' in frame) document.getElementById('live-position').textContent = frame.p.toFixed(2) + ' m';
+    if ('v' in frame) document.getElementById('live-speed').textContent = frame.v.toFixed(2) + ' m/s';
+    if ('g' in frame) document.getElementById('live-target').textContent = frame.g.toFixed(2) + ' m/s';
+    if ('ms' in frame) document.getElementById('live-state').textContent = (live.m || '') + ' / ' + frame.ms;
+    if ('imp' in frame) {
+        document.getElementById('last-impact').textContent = frame.imp.toFixed(2) + 'g';
+        document.getElementById('impact-status').textContent = '⚠️ IMPACT ' + frame.imp.toFixed(2) + 'g';
+    }
+    // Mode or state change: refresh the rest of the page now
+    if (stateChanged && !frame.k) updateStatus();
+}
+
+function connectTelemetry() {
+    if (!('WebSocket' in window)) return;
+    ws = new WebSocket('ws://' + location.host + '/ws');
+    ws.binaryType = 'arraybuffer';
+    ws.onopen = () => {
+        document.getElementById('live-link').textContent = '🟢 LIVE';
+        ws.send('fmt=bin');
+        startPolling(5000);
+    };
+    ws.onmessage = (event) => {
+        if (event.data instanceof ArrayBuffer) {
+            applyRecords(event.data);
+            return;
+        }
+        const msg = JSON.parse(event.data);
+        if (msg.type === 'fmt') {
+            liveBinary = msg.format === 'bin' && msg.version === TELEMETRY_VERSION;
+            if (msg.format === 'bin' && !liveBinary) ws.send('fmt=json');
+            return;
+        }
+        if (msg.type === 'cmd') {
+            showMessage(msg.success ? msg.message : 'Command failed: ' + msg.message, msg.success ? 'success' : 'error');
+            updateStatus();
+        } else if (msg.e === 'cmd') {
+            showCommandResult(msg.d);
+        } else if (msg.e === 'log') {
+            const line = `${msg.d.l} (${msg.d.t}) ${msg.d.tag}: ${msg.d.m}`;
+            if (msg.d.l === 'E') console.error(line);
+            else if (msg.d.l === 'W') console.warn(line);
+            else console.log(line);
+        } else if (msg.e) {
+            console.log('Event:', msg.e, msg.d);
+        } else if ('t' in msg) {
+            applyTelemetry(msg);
+        }
+    };
+    ws.onclose = () => {
+        ws = null;
+        liveBinary = false;
+        document.getElementById('live-link').textContent = 'polling';
+        startPolling(1000);
+        setTimeout(connectTelemetry, 3000);
+    };
+}
+
+// Fleet: the other trolleys this one hears over ESP-NOW (/api/fleet)
+let fleetLeadMs = 400;
+
+function sendFleetCommand(unit, cmd, startMs) {
+    fetch('/api/fleet', {
+        method: 'POST',
+        body: 'unit=' + unit + '&cmd=' + encodeURIComponent(cmd) + '&start_ms=' + startMs,
+        headers: {'Content-Type': 'application/x-www-form-urlencoded'}
+    })
+    .then(response => response.ok ? response.json() : {success: false, error: response.statusText})
+    .then(data => {
+        showMessage(data.success ? 'Relayed to ' + unit : 'Relay failed: ' + data.error, data.success ? 'success' : 'error');
+        setTimeout(updateFleet, 300);
+    })
+    .catch(error => showMessage('Communication error: ' + error, 'error'));
+}
+
+function updateFleet() {
+    fetch('/api/fleet')
+    .then(response => response.ok ? response.json() : null)
+    .then(data => {
+        if (!data || !data.running) return;
+        fleetLeadMs = data.sync_lead_ms;
+        document.getElementById('fleet-panel').style.display = 'block';
+        document.getElementById('fleet-self').textContent = 'this unit ' + data.self.unit;
+        const rows = data.peers.map(peer =>
+            '<tr><td>' + peer.unit + '</td>' +
+            '<td>' + (MODE_NAMES[peer.mode] || peer.mode) + ' / ' + peer.mode_state + '</td>' +
+            '<td>' + (peer.position_mm / 1000).toFixed(2) + ' m</td>' +
+            '<td>' + (Math.abs(peer.velocity_mm_s) / 1000).toFixed(2) + ' m/s</td>' +
+            '<td>' + peer.rssi + ' dBm' + (peer.age_ms > 500 ? ' ⚠️' : '') + '</td>' +
+            '<td><button class="btn btn-secondary" onclick="sendFleetCommand(\'' + peer.unit + '\', \'Q\', 0)">Stop</button>' +
+            '<button class="btn btn-danger" onclick="sendFleetCommand(\'' + peer.unit + '\', \'E\', 0)">E-stop</button></td></tr>');
+        document.getElementById('fleet-peers').innerHTML =
+            rows.length ? rows.join('') : '<tr><td colspan="6">No other trolleys heard</td></tr>';
+        document.getElementById('fleet-relays').innerHTML = data.relays.slice(0, 4).map(relay =>
+            '<div class="' + (relay.success ? 'success-msg' : 'error-msg') + '">' +
+            relay.unit + ' \'' + relay.command + '\': ' + (relay.message || relay.error) +
+            (relay.latency_ms ? ' (' + relay.latency_ms + ' ms)' : '') + '</div>').join('');
+    })
+    .catch(() => {});
+}
+
+updateStatus();
+startPolling(1000);
+connectTelemetry();
+updateFleet();
+setInterval(updateFleet, 2000);
@@ -0,0 +1,154 @@
+// components/wire_end_detector/include/wire_end_detector.h
+#ifndef WIRE_END_DETECTOR_H
+#define WIRE_END_DETECTOR_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// WIRE_END_DETECTOR.H - STREAMING MULTI-SIGNAL END-OF-WIRE DETECTION
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: One answer to "did we just hit the wire end?"
+// - Stepped every control tick after the state estimator; reads every IMU
+//   sample through its own cursor and every Hall batch
+// - Four evidences, each scaled 0..1:
+//     impact energy  ∫(|g| - 1 - noise)² dt over a short leaky window
+//     jerk           peak sample-to-sample change of |g|
+//     prediction     Hall edge overdue against the period of the last edge
+//     mismatch       speed fell away from a command it was already tracking
+// - Weighted into a confidence; an event needs WIRE_END_DET_DEBOUNCE_TICKS
+//   consecutive ticks at WIRE_END_DET_CONFIDENCE (a few ms), so one noisy
+//   sample never ends a run
+// - No Hall edge for WIRE_END_DET_BACKSTOP_MS still ends the run, but is
+//   counted as a false negative: the evidences should have caught it
+// - After an event, further travel in the same direction proves it wrong
+//   (false positive counter)
+//
+// Wire learning and automatic mode both arm it per run and poll the event
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Evidence scaling (value that counts as full evidence)
+#define WIRE_END_DET_NOISE_G            0.15f       // |g| deviation below this is ride vibration
+#define WIRE_END_DET_ENERGY_G2S         0.004f      // Impact energy (≈ 0.6 g excess for 10 ms)
+#define WIRE_END_DET_ENERGY_TAU_MS      20          // Impact energy leak time constant
+#define WIRE_END_DET_JERK_GPS           250.0f      // |g| change per second (0.5 g in one sample)
+#define WIRE_END_DET_JERK_HOLD_MS       10          // Jerk peak hold
+#define WIRE_END_DET_LATE_START         1.5f        // Edge period ratio where lateness starts to count
+#define WIRE_END_DET_LATE_FULL          3.0f        // Edge period ratio of full lateness evidence
+#define WIRE_END_DET_MISMATCH_START     0.25f       // Speed shortfall (fraction of command) that starts to count
+#define WIRE_END_DET_MISMATCH_FULL      0.6f        // Speed shortfall of full mismatch evidence
+#define WIRE_END_DET_TRACK_FRACTION     0.8f        // Speed must reach this fraction of the command first
+
+// Evidence weights (confidence = weighted sum, clamped to 1)
+#define WIRE_END_DET_WEIGHT_IMPACT      0.45f
+#define WIRE_END_DET_WEIGHT_JERK        0.25f
+#define WIRE_END_DET_WEIGHT_LATE        0.35f
+#define WIRE_END_DET_WEIGHT_MISMATCH    0.25f
+
+// Decision
+#define WIRE_END_DET_CONFIDENCE         0.6f        // Confidence that counts as a wire end
+#define WIRE_END_DET_DEBOUNCE_TICKS     3           // Consecutive ticks at WIRE_END_DET_CONFIDENCE
+#define WIRE_END_DET_MIN_EDGES          2           // Hall edges after arming before evidence counts
+#define WIRE_END_DET_MIN_SPEED_MS       0.3f        // Slower ends are left to the backstop
+#define WIRE_END_DET_BACKSTOP_MS        1800        // No Hall edge for this long (just inside HALL_TIMEOUT_MS)
+#define WIRE_END_DET_CONFIRM_MS         1500        // Window after an event that can prove it wrong
+#define WIRE_END_DET_FP_TRAVEL_M        0.5f        // Travel past the event that proves it wrong
+#define WIRE_END_DET_IMU_READ_MAX       16          // Samples drained per tick (ring keeps the rest)
+
+// Evidence that contributed to an event (bit mask)
+#define WIRE_END_SOURCE_IMPACT          (1u << 0)
+#define WIRE_END_SOURCE_JERK            (1u << 1)
+#define WIRE_END_SOURCE_LATE            (1u << 2)
+#define WIRE_END_SOURCE_MISMATCH        (1u << 3)
+#define WIRE_END_SOURCE_BACKSTOP        (1u << 4)   // Hall timeout, no evidence reached confidence
+
+// End-of-wire event
+typedef struct {
+    bool detected;
+    float confidence;                  // 0..1 (0 for backstop events)
+    uint32_t sources;                  // WIRE_END_SOURCE_* with evidence ≥ 0.5
+    float peak_impact_g;               // Largest |g| - 1 since arming
+    float position_m;                  // Estimator position at the event
+    uint64_t timestamp_us;
+    uint32_t latency_ms;               // Event time minus the expected time of the missing edge
+} wire_end_event_t;
+
+// Detector statistics
+typedef struct {
+    bool armed;
+    bool forward;                      // Direction of the armed run
+    float confidence;                  // Latest confidence
+    float impact_evidence;             // Latest evidences (0..1)
+    float jerk_evidence;
+    float late_evidence;
+    float mismatch_evidence;
+    uint32_t runs;                     // Arm calls
+    uint32_t events;                   // Events raised (including backstop)
+    uint32_t false_positives;          // Events followed by WIRE_END_DET_FP_TRAVEL_M more travel
+    uint32_t false_negatives;          // Backstop events while above WIRE_END_DET_MIN_SPEED_MS
+    uint32_t imu_overruns;             // Samples lost by the detector's IMU cursor
+    uint32_t last_latency_ms;
+    uint32_t max_latency_ms;
+    wire_end_event_t last_event;
+} wire_end_detector_stats_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CORE DETECTOR API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Reset the detector (disarmed, counters zero)
+ * @return ESP_OK
+ */
+esp_err_t wire_end_detector_init(void);
+
+/**
+ * @brief Control loop detect stage: fold in new IMU samples and Hall edges
+ * @return ESP_OK (also while disarmed)
+ * @note Call from the control loop task only, after state_estimator_update()
+ */
+esp_err_t wire_end_detector_update(void);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MODE API (control loop)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Start watching a run toward a wire end
+ * @param forward Travel direction of the run
+ * @note Clears any pending event; judges the previous event if still confirming
+ */
+void wire_end_detector_arm(bool forward);
+
+/**
+ * @brief Stop watching (mode stopped or interrupted); a raised event is kept
+ */
+void wire_end_detector_disarm(void);
+
+/**
+ * @brief Take the pending end-of-wire event
+ * @param event Output event (may be NULL)
+ * @return true once per event, false if none pending
+ */
+bool wire_end_detector_poll(wire_end_event_t* event);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DIAGNOSTICS API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Get detector statistics (tear-free snapshot)
+ * @return wire_end_detector_stats_t structure
+ */
+wire_end_detector_stats_t wire_end_detector_get_stats(void);
+
+/**
+ * @brief Describe the evidences of an event
+ * @param sources WIRE_END_SOURCE_* mask
+ * @return Dominant evidence name
+ */
+const char* wire_end_detector_source_to_string(uint32_t sources);
+
+#endif // WIRE_END_DETECTOR_H
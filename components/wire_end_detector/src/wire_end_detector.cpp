@@ -0,0 +1,355 @@
+// components/wire_end_detector/src/wire_end_detector.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// WIRE_END_DETECTOR.CPP - EVIDENCE FUSION FOR THE END OF THE WIRE (DETECT STAGE)
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// Every evidence is a streaming state updated per IMU sample or per tick:
+// - Impact energy leaks with WIRE_END_DET_ENERGY_TAU_MS, so a stop against
+//   the buffer scores and a single spike does not
+// - Jerk peak is held WIRE_END_DET_JERK_HOLD_MS so it overlaps the energy
+// - The edge period expected from the speed at the last Hall edge makes a
+//   stall visible after a fraction of a period instead of HALL_TIMEOUT_MS
+// - Speed shortfall is taken against min(command, peak speed of this run):
+//   a trolley still accelerating toward its command is not a mismatch
+//
+// Arm/disarm may come from any task; they are requests applied by the next
+// update so the detector state has a single writer (the control loop)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "wire_end_detector.h"
+#include "hardware_control.h"
+#include "state_estimator.h"
+#include "imu_acquisition.h"
+#include "status_snapshot.h"
+#include "deferred_log.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+static const char* TAG = "WIRE_END_DET";
+
+#define WIRE_END_DET_MAX_SAMPLE_GAP_US  50000       // Longer IMU gaps restart the jerk/energy state
+
+// The backstop ends a run pushed against the end before the Hall timeout
+// would call the sensor unhealthy and fail the next run's safety check
+static_assert(WIRE_END_DET_BACKSTOP_MS < HALL_TIMEOUT_MS, "Wire end backstop must beat the Hall timeout");
+
+enum {
+    REQUEST_NONE = 0,
+    REQUEST_ARM_FORWARD,
+    REQUEST_ARM_REVERSE,
+    REQUEST_DISARM
+};
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// GLOBAL STATE (control loop task only, published through the snapshot)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static bool g_detector_initialized = false;
+static std::atomic<uint8_t> g_request(REQUEST_NONE);
+
+static bool g_armed = false;
+static bool g_forward = true;
+
+// IMU evidences
+static imu_reader_t g_imu_reader = {};
+static imu_sample_t g_imu_buffer[WIRE_END_DET_IMU_READ_MAX];
+static uint64_t g_last_sample_us = 0;            // 0 = no previous sample for jerk
+static float g_last_total_g = 0.0f;
+static float g_energy_g2s = 0.0f;
+static float g_jerk_peak_gps = 0.0f;
+static uint64_t g_jerk_peak_us = 0;
+static float g_peak_impact_g = 0.0f;
+
+// Hall/speed evidences
+static uint32_t g_edges_seen = 0;
+static uint64_t g_last_edge_us = 0;
+static float g_edge_speed_ms = 0.0f;             // Estimated speed when the last edge arrived
+static float g_peak_speed_ms = 0.0f;             // Peak speed while the motor is commanded
+
+// Decision
+static uint32_t g_above_ticks = 0;
+static bool g_event_pending = false;
+static wire_end_event_t g_event = {};
+
+// Confirmation of the last event
+static bool g_confirming = false;
+static bool g_confirm_forward = true;
+static float g_confirm_position_m = 0.0f;
+static uint64_t g_confirm_deadline = 0;
+static uint32_t g_confirm_position_resets = 0;
+
+static wire_end_detector_stats_t g_stats = {};
+static status_snapshot<wire_end_detector_stats_t> g_stats_snapshot;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// EVIDENCE ACCUMULATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static float ramp01(float value, float start, float full) {
+    if (full <= start) return value >= full ? 1.0f : 0.0f;
+    return fminf(fmaxf((value - start) / (full - start), 0.0f), 1.0f);
+}
+
+static void arm(bool forward) {
+    state_estimate_t estimate = state_estimator_get_state();
+
+    g_armed = true;
+    g_forward = forward;
+    imu_acquisition_reader_init(&g_imu_reader);
+    g_last_sample_us = 0;
+    g_energy_g2s = 0.0f;
+    g_jerk_peak_gps = 0.0f;
+    g_jerk_peak_us = 0;
+    g_peak_impact_g = 0.0f;
+    g_edges_seen = 0;
+    g_last_edge_us = hardware_get_last_hall_batch().newest_edge_us;
+    g_edge_speed_ms = 0.0f;
+    g_peak_speed_ms = estimate.speed_ms;
+    g_above_ticks = 0;
+    g_event_pending = false;
+
+    g_stats.armed = true;
+    g_stats.forward = forward;
+    g_stats.runs++;
+}
+
+static void consume_imu(void) {
+    size_t count;
+    while ((count = imu_acquisition_read(&g_imu_reader, g_imu_buffer, WIRE_END_DET_IMU_READ_MAX)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            const imu_sample_t* sample = &g_imu_buffer[i];
+            float total_g = imu_raw_to_g(sample->total_raw);
+            float excess_g = fabsf(total_g - 1.0f);
+            g_peak_impact_g = fmaxf(g_peak_impact_g, excess_g);
+
+            uint64_t gap_us = sample->timestamp_us - g_last_sample_us;
+            if (g_last_sample_us != 0 && sample->timestamp_us > g_last_sample_us &&
+                gap_us < WIRE_END_DET_MAX_SAMPLE_GAP_US) {
+                float dt = gap_us * 1e-6f;
+
+                float leak = 1.0f - dt / (WIRE_END_DET_ENERGY_TAU_MS * 1e-3f);
+                g_energy_g2s *= fmaxf(leak, 0.0f);
+                float over_g = excess_g - WIRE_END_DET_NOISE_G;
+                if (over_g > 0.0f) {
+                    g_energy_g2s += over_g * over_g * dt;
+                }
+
+                float jerk_gps = fabsf(total_g - g_last_total_g) / dt;
+                if (jerk_gps > g_jerk_peak_gps) {
+                    g_jerk_peak_gps = jerk_gps;
+                    g_jerk_peak_us = sample->timestamp_us;
+                }
+            }
+            g_last_sample_us = sample->timestamp_us;
+            g_last_total_g = total_g;
+        }
+        if (count < WIRE_END_DET_IMU_READ_MAX) break;
+    }
+    g_stats.imu_overruns = g_imu_reader.overruns;
+}
+
+static void raise_event(uint64_t now, const state_estimate_t* estimate, float confidence,
+                        uint32_t sources, uint64_t expected_edge_us) {
+    g_event.detected = true;
+    g_event.confidence = confidence;
+    g_event.sources = sources;
+    g_event.peak_impact_g = g_peak_impact_g;
+    g_event.position_m = estimate->position_m;
+    g_event.timestamp_us = now;
+    g_event.latency_ms = (expected_edge_us != 0 && now > expected_edge_us) ?
+                         (uint32_t)((now - expected_edge_us) / 1000) : 0;
+    g_event_pending = true;
+
+    g_stats.events++;
+    g_stats.last_event = g_event;
+    g_stats.last_latency_ms = g_event.latency_ms;
+    if (g_event.latency_ms > g_stats.max_latency_ms) {
+        g_stats.max_latency_ms = g_event.latency_ms;
+    }
+
+    // Watch for travel that would prove the event wrong
+    g_confirming = true;
+    g_confirm_forward = g_forward;
+    g_confirm_position_m = estimate->position_m;
+    g_confirm_deadline = now + WIRE_END_DET_CONFIRM_MS * 1000ULL;
+    g_confirm_position_resets = hardware_get_last_hall_batch().position_resets;
+
+    // One event per run
+    g_armed = false;
+    g_stats.armed = false;
+
+    deferred_log(DLOG_MSG_WIRE_END_EVENT, wire_end_detector_source_to_string(sources), confidence,
+                 g_peak_impact_g, (uint32_t)g_event.latency_ms);
+}
+
+static void confirm_last_event(uint64_t now, const state_estimate_t* estimate) {
+    if (!g_confirming) return;
+
+    if (hardware_get_last_hall_batch().position_resets != g_confirm_position_resets) {
+        g_confirming = false;
+        return;
+    }
+
+    float travel_m = (estimate->position_m - g_confirm_position_m) * (g_confirm_forward ? 1.0f : -1.0f);
+    if (travel_m > WIRE_END_DET_FP_TRAVEL_M) {
+        g_stats.false_positives++;
+        g_confirming = false;
+        deferred_log(DLOG_MSG_WIRE_END_FALSE, travel_m);
+    } else if (now >= g_confirm_deadline) {
+        g_confirming = false;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t wire_end_detector_init(void) {
+    g_request.store(REQUEST_NONE, std::memory_order_relaxed);
+    g_armed = false;
+    g_event_pending = false;
+    g_confirming = false;
+    memset(&g_event, 0, sizeof(g_event));
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_stats_snapshot.write(g_stats);
+
+    g_detector_initialized = true;
+    ESP_LOGI(TAG, "Wire end detector initialized (confidence %.2f over %d ticks, backstop %d ms)",
+             WIRE_END_DET_CONFIDENCE, WIRE_END_DET_DEBOUNCE_TICKS, WIRE_END_DET_BACKSTOP_MS);
+    return ESP_OK;
+}
+
+esp_err_t wire_end_detector_update(void) {
+    if (!g_detector_initialized) return ESP_ERR_INVALID_STATE;
+
+    uint8_t request = g_request.exchange(REQUEST_NONE, std::memory_order_acquire);
+    if (request == REQUEST_ARM_FORWARD || request == REQUEST_ARM_REVERSE) {
+        arm(request == REQUEST_ARM_FORWARD);
+    } else if (request == REQUEST_DISARM) {
+        g_armed = false;
+        g_stats.armed = false;
+    }
+
+    if (!g_armed && !g_confirming && request == REQUEST_NONE) {
+        return ESP_OK;
+    }
+
+    uint64_t now = esp_timer_get_time();
+    state_estimate_t estimate = state_estimator_get_state();
+    confirm_last_event(now, &estimate);
+
+    if (!g_armed) {
+        g_stats_snapshot.write(g_stats);
+        return ESP_OK;
+    }
+
+    consume_imu();
+    if (g_jerk_peak_us != 0 && now - g_jerk_peak_us > WIRE_END_DET_JERK_HOLD_MS * 1000ULL) {
+        g_jerk_peak_gps = 0.0f;
+        g_jerk_peak_us = 0;
+    }
+
+    hall_batch_t batch = hardware_get_last_hall_batch();
+    if (batch.edge_count > 0 && batch.newest_edge_us != g_last_edge_us) {
+        g_edges_seen += batch.edge_count;
+        g_last_edge_us = batch.newest_edge_us;
+        g_edge_speed_ms = estimate.speed_ms;
+    }
+
+    hardware_status_t hw_status = hardware_get_status();
+    float command_ms = hw_status.target_speed_ms;
+    if (command_ms < WIRE_END_DET_MIN_SPEED_MS) {
+        g_peak_speed_ms = estimate.speed_ms;       // Motor off: nothing to track
+    } else {
+        g_peak_speed_ms = fmaxf(g_peak_speed_ms, estimate.speed_ms);
+    }
+
+    float impact = 0.0f;
+    float jerk = 0.0f;
+    float late = 0.0f;
+    float mismatch = 0.0f;
+    uint64_t expected_edge_us = 0;
+
+    if (g_edges_seen >= WIRE_END_DET_MIN_EDGES) {
+        impact = fminf(g_energy_g2s / WIRE_END_DET_ENERGY_G2S, 1.0f);
+        jerk = fminf(g_jerk_peak_gps / WIRE_END_DET_JERK_GPS, 1.0f);
+
+        if (g_edge_speed_ms >= WIRE_END_DET_MIN_SPEED_MS) {
+            float period_us = HALL_DISTANCE_PER_PULSE_M / g_edge_speed_ms * 1e6f;
+            expected_edge_us = g_last_edge_us + (uint64_t)period_us;
+            late = ramp01((now - g_last_edge_us) / period_us, WIRE_END_DET_LATE_START, WIRE_END_DET_LATE_FULL);
+        }
+
+        float reference_ms = fminf(command_ms, g_peak_speed_ms);
+        if (command_ms >= WIRE_END_DET_MIN_SPEED_MS && reference_ms >= WIRE_END_DET_MIN_SPEED_MS) {
+            float shortfall = (reference_ms - estimate.speed_ms) / reference_ms;
+            mismatch = ramp01(shortfall, WIRE_END_DET_MISMATCH_START, WIRE_END_DET_MISMATCH_FULL);
+        }
+    }
+
+    float confidence = fminf(WIRE_END_DET_WEIGHT_IMPACT * impact + WIRE_END_DET_WEIGHT_JERK * jerk +
+                             WIRE_END_DET_WEIGHT_LATE * late + WIRE_END_DET_WEIGHT_MISMATCH * mismatch,
+                             1.0f);
+
+    g_stats.confidence = confidence;
+    g_stats.impact_evidence = impact;
+    g_stats.jerk_evidence = jerk;
+    g_stats.late_evidence = late;
+    g_stats.mismatch_evidence = mismatch;
+
+    g_above_ticks = (confidence >= WIRE_END_DET_CONFIDENCE) ? g_above_ticks + 1 : 0;
+
+    if (g_above_ticks >= WIRE_END_DET_DEBOUNCE_TICKS) {
+        uint32_t sources = 0;
+        if (impact >= 0.5f) sources |= WIRE_END_SOURCE_IMPACT;
+        if (jerk >= 0.5f) sources |= WIRE_END_SOURCE_JERK;
+        if (late >= 0.5f) sources |= WIRE_END_SOURCE_LATE;
+        if (mismatch >= 0.5f) sources |= WIRE_END_SOURCE_MISMATCH;
+        raise_event(now, &estimate, confidence, sources, expected_edge_us);
+    } else if (g_edges_seen > 0 && now - g_last_edge_us > WIRE_END_DET_BACKSTOP_MS * 1000ULL) {
+        // Stopped without the evidences noticing: a miss unless it was a crawl
+        if (g_edge_speed_ms >= WIRE_END_DET_MIN_SPEED_MS) {
+            g_stats.false_negatives++;
+        }
+        raise_event(now, &estimate, 0.0f, WIRE_END_SOURCE_BACKSTOP, expected_edge_us);
+    }
+
+    g_stats_snapshot.write(g_stats);
+    return ESP_OK;
+}
+
+void wire_end_detector_arm(bool forward) {
+    g_request.store(forward ? REQUEST_ARM_FORWARD : REQUEST_ARM_REVERSE, std::memory_order_release);
+}
+
+void wire_end_detector_disarm(void) {
+    g_request.store(REQUEST_DISARM, std::memory_order_release);
+}
+
+bool wire_end_detector_poll(wire_end_event_t* event) {
+    // An arm not yet applied invalidates whatever is pending
+    uint8_t request = g_request.load(std::memory_order_acquire);
+    if (!g_event_pending || request == REQUEST_ARM_FORWARD || request == REQUEST_ARM_REVERSE) {
+        return false;
+    }
+
+    g_event_pending = false;
+    if (event != NULL) *event = g_event;
+    return true;
+}
+
+wire_end_detector_stats_t wire_end_detector_get_stats(void) {
+    return g_stats_snapshot.read();
+}
+
+const char* wire_end_detector_source_to_string(uint32_t sources) {
+    if (sources & WIRE_END_SOURCE_BACKSTOP) return "Hall timeout";
+    if (sources & WIRE_END_SOURCE_IMPACT) return "Impact";
+    if (sources & WIRE_END_SOURCE_JERK) return "Jerk";
+    if (sources & WIRE_END_SOURCE_MISMATCH) return "Speed mismatch";
+    if (sources & WIRE_END_SOURCE_LATE) return "Overdue Hall edge";
+    return "Combined";
+}
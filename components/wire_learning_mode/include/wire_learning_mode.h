@@ -2,6 +2,7 @@
 #define WIRE_LEARNING_MODE_H
 
 #include "esp_err.h"
+#include "status_text.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -25,25 +26,39 @@
 // ═══════════════════════════════════════════════════════════════════════════════
 
 // Learning speed progression
-#define WIRE_LEARNING_START_SPEED_MS    0.1f      // Starting speed
+#define WIRE_LEARNING_START_SPEED_MS    0.2f      // Starting speed (Hall edge well inside HALL_TIMEOUT_MS)
 #define WIRE_LEARNING_MAX_SPEED_MS      1.0f      // Maximum learning speed
 #define WIRE_LEARNING_SPEED_INCREMENT   0.1f      // Speed increment steps
-#define WIRE_LEARNING_TIMEOUT_S         60        // Total learning timeout
+#define WIRE_LEARNING_TIMEOUT_S         8300      // Homing and both legs of the longest wire, plus the sweeps
 
 // Wire validation parameters
 #define WIRE_LENGTH_TOLERANCE_PERCENT   5.0f      // Acceptable difference between directions
 #define MIN_WIRE_LENGTH_M              2.0f       // Minimum expected wire length
 #define MAX_WIRE_LENGTH_M              2000.0f    // Maximum expected wire length
 
-// Wire end detection thresholds
-#define WIRE_END_IMPACT_THRESHOLD_G    1.0f       // Impact detection threshold
-#define WIRE_END_HALL_TIMEOUT_MS       2000       // Hall timeout for wire end
-#define WIRE_END_SPEED_DROP_PERCENT    70.0f      // Speed drop percentage for detection
+// Position safety (wire end detection thresholds live in wire_end_detector.h)
+#define WIRE_END_IMPACT_THRESHOLD_G    1.0f       // Unsafe above twice this
 
 // Learning validation
 #define LEARNING_MIN_HALL_PULSES       10         // Minimum pulses for valid movement
-#define LEARNING_HALL_TIMEOUT_MS       3000       // Hall timeout during learning
+#define LEARNING_HALL_TIMEOUT_MS       3000       // Shortest speed test window
+#define LEARNING_WINDOW_MARGIN         2.0f       // Speed test window: nominal time for the pulses times this
 #define LEARNING_DIRECTION_PAUSE_MS    2000       // Pause between direction changes
+#define LEARNING_SPEED_STEP_PAUSE_MS   500        // Pause between speed test steps
+#define LEARNING_SPEED_RETRIES         1          // Speed test windows retried before failing
+#define LEARNING_HOMING_SPEED_MS       0.5f       // Drive to the reverse end before the forward leg
+#define LEARNING_HOMING_STALL_MS       1500       // No Hall edge this long while homing: at the end
+
+// Coasting calibration (reverse leg, mid-wire)
+#define LEARNING_COAST_SPEED_MS        5.0f       // Calibration speed when the wire allows it
+#define LEARNING_COAST_MIN_SPEED_MS    1.5f       // Slower coasts are not worth a calibration
+#define LEARNING_COAST_START_FRACTION  0.25f      // Reverse travel (of the forward length) before starting
+#define LEARNING_COAST_END_MARGIN_M    2.0f       // Distance left at the wire end after the coast
+#define LEARNING_COAST_ACCEL_MS2       0.5f       // Assumed acceleration to calibration speed
+#define LEARNING_COAST_DECEL_MS2       0.25f      // Assumed coast deceleration until a model exists
+#define LEARNING_COAST_SPEED_REACHED   0.95f      // Fraction of the target that starts the coast
+#define LEARNING_COAST_ACCEL_TIMEOUT_MS 10000     // Accelerate phase deadline
+#define LEARNING_COAST_TIMEOUT_MS      30000      // Coast phase deadline
 
 // ═══════════════════════════════════════════════════════════════════════════════
 // WIRE LEARNING STATE AND DATA STRUCTURES
@@ -55,6 +70,7 @@
 typedef enum {
     WIRE_LEARNING_IDLE = 0,             // Not active
     WIRE_LEARNING_INITIALIZING,         // Starting up and validating
+    WIRE_LEARNING_HOMING,               // Driving to the reverse wire end
     WIRE_LEARNING_FORWARD_DIRECTION,    // Learning forward direction
     WIRE_LEARNING_DIRECTION_PAUSE,      // Pausing between directions
     WIRE_LEARNING_REVERSE_DIRECTION,    // Learning reverse direction
@@ -109,15 +125,16 @@ typedef struct {
     bool learning_successful;
     
     // Status and error tracking
-    char status_message[128];
-    char error_message[128];
+    status_text_t status_text;
+    status_text_t error_text;
     uint32_t error_count;
 } wire_learning_progress_t;
 
 /**
  * @brief Wire learning results (final output)
+ * @note Tagged: mode_coordinator.h forward-declares struct wire_learning_results_t
  */
-typedef struct {
+typedef struct wire_learning_results_t {
     bool complete;                      // Learning completed successfully
     float wire_length_m;                // Final measured wire length
     float optimal_learning_speed_ms;    // Best speed found during learning
@@ -170,6 +187,12 @@ bool wire_learning_mode_is_active(void);
  */
 bool wire_learning_mode_is_complete(void);
 
+/**
+ * @brief Get current learning state (no progress struct copy)
+ * @return Current wire_learning_state_t
+ */
+wire_learning_state_t wire_learning_mode_get_state(void);
+
 /**
  * @brief Get current learning progress
  * @return Current progress data structure
@@ -187,31 +210,13 @@ wire_learning_results_t wire_learning_mode_get_results(void);
 // ═══════════════════════════════════════════════════════════════════════════════
 
 /**
- * @brief Check for wire end using accelerometer impact
- * @return true if impact detected, false otherwise
- */
-bool wire_learning_detect_impact(void);
-
-/**
- * @brief Check for wire end using Hall sensor timeout
- * @return true if Hall timeout detected, false otherwise
- */
-bool wire_learning_detect_hall_timeout(void);
-
-/**
- * @brief Check for wire end using speed drop detection
- * @return true if speed drop detected, false otherwise
- */
-bool wire_learning_detect_speed_drop(void);
-
-/**
- * @brief Get best wire end detection method for current conditions
- * @return Most reliable detection method
+ * @brief Take the wire end event of the current traverse
+ * @return Strongest evidence of the event, WIRE_END_NONE if no event pending
  */
 wire_end_detection_method_t wire_learning_get_best_detection_method(void);
 
 /**
- * @brief Reset wire end detection algorithms
+ * @brief Re-arm the wire end detector for the current traverse (disarm outside one)
  * @return ESP_OK on success
  */
 esp_err_t wire_learning_reset_detection(void);
@@ -5,17 +5,24 @@
 // 
 // SINGLE RESPONSIBILITY: Wire learning mode implementation
 // - Wire length calculation through forward/reverse runs
-// - Optimal speed finding with gradual progression (0.1→1.0 m/s)
-// - Wire end detection using multiple methods (impact, timeout, speed drop)
+// - Optimal speed finding with gradual progression (0.2→1.0 m/s)
+// - Wire end detection through the shared wire_end_detector
+// - Coasting calibration mid-wire in the reverse leg (capped to the wire left)
 // - Results validation and persistence
 // ═══════════════════════════════════════════════════════════════════════════════
 
 #include "wire_learning_mode.h"
 #include "hardware_control.h"
+#include "hal_clock.h"
+#include "esc_duty_lut.h"
 #include "sensor_health.h"
+#include "state_estimator.h"
+#include "imu_acquisition.h"
 #include "mode_coordinator.h"
+#include "wire_map.h"
+#include "wire_end_detector.h"
+#include "deferred_log.h"
 #include "esp_log.h"
-#include "esp_timer.h"
 #include "nvs_flash.h"
 #include "nvs.h"
 #include <cmath>
@@ -27,8 +34,8 @@ static const char* TAG = "WIRE_LEARNING";
 // GLOBAL WIRE LEARNING STATE
 // ═══════════════════════════════════════════════════════════════════════════════
 
-static wire_learning_progress_t g_learning_progress = {0};
-static wire_learning_results_t g_learning_results = {0};
+static wire_learning_progress_t g_learning_progress = {};
+static wire_learning_results_t g_learning_results = {};
 static bool g_learning_initialized = false;
 
 // Speed progression tracking
@@ -36,34 +43,50 @@ static float g_current_test_speed = WIRE_LEARNING_START_SPEED_MS;
 static uint32_t g_hall_pulses_at_speed_start = 0;
 static uint64_t g_speed_test_start_time = 0;
 static bool g_speed_validated = false;
+static uint32_t g_speed_retries = 0;             // Windows retried at the current speed
 
-// Coasting calibration tracking
+// Pending speed step (0 = none) - waits are deadlines checked once per update
+static uint64_t g_next_speed_deadline = 0;
+static float g_next_test_speed = 0.0f;
+
+// Direction pause deadline (0 = pause not started)
+static uint64_t g_direction_pause_deadline = 0;
+
+// Coasting calibration tracking (once per learning, in the reverse leg)
+static bool g_coasting_calibration_done = false;
 static bool g_coasting_calibration_active = false;
+static bool g_coast_measuring = false;
+static float g_coast_target_speed = 0.0f;
+static uint64_t g_coast_accel_deadline = 0;
+static uint64_t g_coast_deadline = 0;
 static uint32_t g_coasting_start_rotations = 0;
 static uint64_t g_coasting_start_time = 0;
 static float g_coasting_start_speed = 0.0f;
+static coast_fit_t g_coast_fit = {};              // Speed trace of the calibration coast
+
+// The wire map reads every IMU sample through its own cursor
+static imu_reader_t g_map_reader = {};
 
-// Wire end detection state
-static uint32_t g_consecutive_hall_timeouts = 0;
-static float g_speed_history[5] = {0};
-static int g_speed_history_index = 0;
+// Homing run to the reverse end: the forward leg measures from there
+static uint32_t g_homing_rotations = 0;          // Rotation count at the last Hall edge seen
+static uint64_t g_homing_edge_time = 0;
 
 // ═══════════════════════════════════════════════════════════════════════════════
 // SPEED PROGRESSION AND VALIDATION
 // ═══════════════════════════════════════════════════════════════════════════════
 
 static esp_err_t start_speed_test(float speed_ms) {
-    ESP_LOGI(TAG, "Testing speed: %.1f m/s", speed_ms);
+    deferred_log(DLOG_MSG_WL_TESTING_SPEED, speed_ms);
     
     g_current_test_speed = speed_ms;
     g_speed_validated = false;
     g_hall_pulses_at_speed_start = hardware_get_rotation_count();
-    g_speed_test_start_time = esp_timer_get_time();
+    g_speed_test_start_time = hal_clock_now_us();
     
     // Set motor speed using hardware control
     esp_err_t result = hardware_set_motor_speed(speed_ms, g_learning_progress.current_direction_forward);
     if (result != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to set motor speed");
+        deferred_log(DLOG_MSG_WL_SPEED_SET_FAILED);
         return result;
     }
     
@@ -71,32 +94,62 @@ static esp_err_t start_speed_test(float speed_ms) {
     return ESP_OK;
 }
 
+/**
+ * @brief Speed test window, scaled to the time the pulses take at the test speed
+ *
+ * LEARNING_MIN_HALL_PULSES at the start speed is ~10 s of travel.
+ */
+static uint64_t speed_test_window_us(void) {
+    float nominal_s = LEARNING_MIN_HALL_PULSES * HALL_DISTANCE_PER_PULSE_M / g_current_test_speed;
+    float window_ms = fmaxf((float)LEARNING_HALL_TIMEOUT_MS, nominal_s * LEARNING_WINDOW_MARGIN * 1000.0f);
+    return (uint64_t)window_ms * 1000ULL;
+}
+
 static bool validate_current_speed(void) {
-    uint64_t elapsed_time = esp_timer_get_time() - g_speed_test_start_time;
+    uint64_t elapsed_time = hal_clock_now_us() - g_speed_test_start_time;
     uint32_t current_rotations = hardware_get_rotation_count();
     uint32_t hall_pulses = current_rotations - g_hall_pulses_at_speed_start;
     
     // Check if we have minimum Hall pulses for validation
     if (hall_pulses >= LEARNING_MIN_HALL_PULSES) {
         g_speed_validated = true;
-        ESP_LOGI(TAG, "Speed %.1f m/s validated (%lu pulses in %llu ms)", 
-                g_current_test_speed, hall_pulses, elapsed_time / 1000);
+        g_speed_retries = 0;
+        deferred_log(DLOG_MSG_WL_SPEED_VALIDATED, g_current_test_speed, hall_pulses,
+                     (uint32_t)(elapsed_time / 1000));
+        
+        // Each validated step doubles as an ESC calibration point
+        hardware_status_t hw_status = hardware_get_status();
+        esc_lut_calibration_add_point(g_learning_progress.current_direction_forward,
+                                      hw_status.current_esc_duty,
+                                      (uint16_t)(state_estimator_get_speed() * 1000.0f));
         return true;
     }
     
-    // Check for timeout
-    if (elapsed_time > LEARNING_HALL_TIMEOUT_MS * 1000ULL) {
-        ESP_LOGW(TAG, "Speed %.1f m/s failed validation (timeout: %lu pulses in %llu ms)", 
-                g_current_test_speed, hall_pulses, elapsed_time / 1000);
+    if (elapsed_time <= speed_test_window_us()) {
+        return false; // Still testing
+    }
+    
+    // Timed out: give the same speed a fresh window, then give up
+    if (g_speed_retries < LEARNING_SPEED_RETRIES) {
+        deferred_log(DLOG_MSG_WL_SPEED_TIMEOUT, g_current_test_speed, hall_pulses,
+                     (uint32_t)(elapsed_time / 1000));
+        g_speed_retries++;
+        start_speed_test(g_current_test_speed);
         return false;
     }
     
-    return false; // Still testing
+    deferred_log(DLOG_MSG_WL_SPEED_FAILED, g_current_test_speed, hall_pulses,
+                 (uint32_t)(elapsed_time / 1000));
+    hardware_emergency_stop();
+    wire_end_detector_disarm();
+    g_learning_progress.error_text = STATUS_TEXT_LEARN_NO_MOTION;
+    g_learning_progress.state = WIRE_LEARNING_FAILED;
+    return false;
 }
 
 static esp_err_t progress_to_next_speed(void) {
     if (g_current_test_speed >= WIRE_LEARNING_MAX_SPEED_MS) {
-        ESP_LOGI(TAG, "Maximum learning speed reached: %.1f m/s", g_current_test_speed);
+        deferred_log(DLOG_MSG_WL_MAX_SPEED, g_current_test_speed);
         return ESP_OK;
     }
     
@@ -105,89 +158,56 @@ static esp_err_t progress_to_next_speed(void) {
         next_speed = WIRE_LEARNING_MAX_SPEED_MS;
     }
     
-    // Brief pause between speed changes
-    vTaskDelay(pdMS_TO_TICKS(500));
+    // Brief pause between speed changes - started by step_pending_speed_test()
+    g_next_test_speed = next_speed;
+    g_next_speed_deadline = hal_clock_now_us() + LEARNING_SPEED_STEP_PAUSE_MS * 1000ULL;
     
-    return start_speed_test(next_speed);
+    return ESP_OK;
 }
 
-// ═══════════════════════════════════════════════════════════════════════════════
-// WIRE END DETECTION ALGORITHMS
-// ═══════════════════════════════════════════════════════════════════════════════
-
-bool wire_learning_detect_impact(void) {
-    sensor_health_t sensor_status = sensor_health_get_status();
+static bool step_pending_speed_test(void) {
+    // Returns true while a scheduled speed change is still waiting
+    if (g_next_speed_deadline == 0) return false;
     
-    if (sensor_status.total_accel_g > WIRE_END_IMPACT_THRESHOLD_G) {
-        ESP_LOGI(TAG, "Wire end detected by impact: %.2f g", sensor_status.total_accel_g);
+    if ((uint64_t)hal_clock_now_us() < g_next_speed_deadline) {
         return true;
     }
     
-    return false;
+    g_next_speed_deadline = 0;
+    start_speed_test(g_next_test_speed);
+    return true;
 }
 
-bool wire_learning_detect_hall_timeout(void) {
-    uint64_t time_since_last_pulse = hardware_get_time_since_last_hall_pulse();
-    
-    if (time_since_last_pulse > (WIRE_END_HALL_TIMEOUT_MS * 1000ULL)) {
-        g_consecutive_hall_timeouts++;
-        
-        if (g_consecutive_hall_timeouts >= 3) { // Multiple consecutive timeouts
-            ESP_LOGI(TAG, "Wire end detected by Hall timeout: %llu us since last pulse", 
-                    time_since_last_pulse);
-            g_consecutive_hall_timeouts = 0;
-            return true;
-        }
-    } else {
-        g_consecutive_hall_timeouts = 0;
-    }
-    
-    return false;
-}
+// ═══════════════════════════════════════════════════════════════════════════════
+// WIRE END DETECTION ALGORITHMS
+// ═══════════════════════════════════════════════════════════════════════════════
 
-bool wire_learning_detect_speed_drop(void) {
-    float current_speed = hardware_get_current_speed();
-    
-    // Update speed history
-    g_speed_history[g_speed_history_index] = current_speed;
-    g_speed_history_index = (g_speed_history_index + 1) % 5;
-    
-    // Calculate average speed
-    float avg_speed = 0;
-    for (int i = 0; i < 5; i++) {
-        avg_speed += g_speed_history[i];
+wire_end_detection_method_t wire_learning_get_best_detection_method(void) {
+    wire_end_event_t event;
+    if (!wire_end_detector_poll(&event)) {
+        return WIRE_END_NONE;
     }
-    avg_speed /= 5.0f;
-    
-    // Check for significant speed drop
-    float speed_drop_threshold = g_current_test_speed * (WIRE_END_SPEED_DROP_PERCENT / 100.0f);
     
-    if (g_current_test_speed > 0.2f && avg_speed < speed_drop_threshold) {
-        ESP_LOGI(TAG, "Wire end detected by speed drop: target %.1f m/s, actual %.1f m/s", 
-                g_current_test_speed, avg_speed);
-        return true;
-    }
+    deferred_log(DLOG_MSG_WL_WIRE_END, wire_end_detector_source_to_string(event.sources),
+                 event.confidence, event.peak_impact_g);
     
-    return false;
-}
-
-wire_end_detection_method_t wire_learning_get_best_detection_method(void) {
-    // Priority order: Impact > Speed Drop > Hall Timeout
-    if (wire_learning_detect_impact()) {
+    // Report the strongest evidence: Impact > Speed Drop > Hall Timeout
+    if (event.sources & (WIRE_END_SOURCE_IMPACT | WIRE_END_SOURCE_JERK)) {
         return WIRE_END_IMPACT_DETECTED;
-    } else if (wire_learning_detect_speed_drop()) {
+    } else if (event.sources & WIRE_END_SOURCE_MISMATCH) {
         return WIRE_END_SPEED_DROP;
-    } else if (wire_learning_detect_hall_timeout()) {
-        return WIRE_END_HALL_TIMEOUT;
     }
-    
-    return WIRE_END_NONE;
+    return WIRE_END_HALL_TIMEOUT;
 }
 
 esp_err_t wire_learning_reset_detection(void) {
-    g_consecutive_hall_timeouts = 0;
-    g_speed_history_index = 0;
-    memset(g_speed_history, 0, sizeof(g_speed_history));
+    if (g_learning_progress.state == WIRE_LEARNING_HOMING ||
+        g_learning_progress.state == WIRE_LEARNING_FORWARD_DIRECTION ||
+        g_learning_progress.state == WIRE_LEARNING_REVERSE_DIRECTION) {
+        wire_end_detector_arm(g_learning_progress.current_direction_forward);
+    } else {
+        wire_end_detector_disarm();
+    }
     return ESP_OK;
 }
 
@@ -195,165 +215,380 @@ esp_err_t wire_learning_reset_detection(void) {
 // COASTING CALIBRATION FOR AUTOMATIC MODE
 // ═══════════════════════════════════════════════════════════════════════════════
 
+/**
+ * @brief Distance left to the reverse wire end (reverse leg only)
+ */
+static float reverse_distance_to_end(void) {
+    uint32_t rotations = hardware_get_rotation_count() - g_learning_progress.direction_start_rotations;
+    return g_learning_progress.forward_distance_m - hardware_rotations_to_distance(rotations);
+}
+
+/**
+ * @brief Calibrate once per learning, after a share of the reverse leg
+ *
+ * Mid-wire the trolley has room to accelerate and coast out in the travel
+ * direction; from a wire end it would start against the stop.
+ */
+static bool coasting_calibration_due(void) {
+    if (g_coasting_calibration_done || g_learning_progress.current_direction_forward) {
+        return false;
+    }
+    uint32_t rotations = hardware_get_rotation_count() - g_learning_progress.direction_start_rotations;
+    return hardware_rotations_to_distance(rotations) >=
+           g_learning_progress.forward_distance_m * LEARNING_COAST_START_FRACTION;
+}
+
+/**
+ * @brief Highest calibration speed whose acceleration and coast fit the wire left
+ * @param remaining_m Distance to the wire end
+ * @return Speed in m/s (0 when nothing fits)
+ */
+static float coasting_calibration_speed(float remaining_m) {
+    float usable_m = remaining_m - LEARNING_COAST_END_MARGIN_M;
+    if (usable_m <= 0.0f) {
+        return 0.0f;
+    }
+    
+    // Base deceleration of a stored reverse model is the conservative end of a + b·v²
+    float decel_ms2 = LEARNING_COAST_DECEL_MS2;
+    const coasting_data_t* previous = mode_coordinator_get_coasting_data();
+    if (previous != NULL && previous->model_reverse.valid) {
+        decel_ms2 = coast_model_decel(&previous->model_reverse, 0.0f);
+    }
+    
+    // v²/2a to get there plus v²/2d to coast out
+    float distance_per_v2 = 0.5f / LEARNING_COAST_ACCEL_MS2 + 0.5f / decel_ms2;
+    return fminf(LEARNING_COAST_SPEED_MS, sqrtf(usable_m / distance_per_v2));
+}
+
+/**
+ * @brief Back to the speed sweep at the step the calibration interrupted
+ */
+static void resume_speed_sweep(void) {
+    g_coasting_calibration_active = false;
+    g_coast_measuring = false;
+    
+    // The deliberate coast is not a wire end: restart the detector's edge timing
+    wire_end_detector_arm(g_learning_progress.current_direction_forward);
+    if (g_current_test_speed > 0.0f) {
+        start_speed_test(g_current_test_speed);
+    }
+}
+
 static esp_err_t start_coasting_calibration(void) {
-    ESP_LOGI(TAG, "Starting coasting calibration at 5.0 m/s");
+    g_coasting_calibration_done = true;   // One attempt per learning, whatever the outcome
+    
+    float remaining_m = reverse_distance_to_end();
+    float speed_ms = coasting_calibration_speed(remaining_m);
+    if (speed_ms < LEARNING_COAST_MIN_SPEED_MS) {
+        deferred_log(DLOG_MSG_WL_COAST_SKIPPED, remaining_m);
+        return ESP_OK;
+    }
+    
+    deferred_log(DLOG_MSG_WL_COAST_PLANNED, speed_ms, remaining_m);
     
     g_coasting_calibration_active = true;
-    g_coasting_start_rotations = hardware_get_rotation_count();
-    g_coasting_start_time = esp_timer_get_time();
-    g_coasting_start_speed = 5.0f;
+    g_coast_measuring = false;
+    g_coast_target_speed = speed_ms;
+    g_coast_accel_deadline = hal_clock_now_us() + LEARNING_COAST_ACCEL_TIMEOUT_MS * 1000ULL;
+    g_next_speed_deadline = 0;            // Sweep resumes from resume_speed_sweep()
     
-    // Accelerate to 5 m/s gradually
-    return hardware_set_motor_speed(5.0f, g_learning_progress.current_direction_forward);
+    return hardware_set_motor_speed(speed_ms, g_learning_progress.current_direction_forward);
+}
+
+/**
+ * @brief A wire end ended the reverse leg while calibrating: keep no data
+ */
+static void abort_coasting_calibration(void) {
+    if (!g_coasting_calibration_active) return;
+    
+    deferred_log(DLOG_MSG_WL_COAST_ABORTED);
+    coast_fit_abort(&g_coast_fit);
+    g_coasting_calibration_active = false;
+    g_coast_measuring = false;
 }
 
 static esp_err_t process_coasting_calibration(void) {
     if (!g_coasting_calibration_active) return ESP_OK;
     
-    float current_speed = hardware_get_current_speed();
+    bool forward = g_learning_progress.current_direction_forward;
+    float current_speed = state_estimator_get_speed();
+    uint64_t now = hal_clock_now_us();
     
-    // Wait until we reach 5 m/s
-    if (current_speed < 4.8f) {
-        return ESP_OK; // Still accelerating
+    if (!g_coast_measuring) {
+        if (current_speed < g_coast_target_speed * LEARNING_COAST_SPEED_REACHED) {
+            if (now < g_coast_accel_deadline) {
+                return ESP_OK; // Still accelerating
+            }
+            deferred_log(DLOG_MSG_WL_COAST_ACCEL_TIMEOUT, current_speed, g_coast_target_speed);
+            resume_speed_sweep();
+            return ESP_ERR_TIMEOUT;
+        }
+        
+        // Turn off motor and start coasting
+        deferred_log(DLOG_MSG_WL_COAST_START, current_speed);
+        hardware_set_motor_speed(0.0f, forward);
+        
+        g_coasting_start_time = now;
+        g_coasting_start_rotations = hardware_get_rotation_count();
+        g_coasting_start_speed = current_speed;
+        g_coast_deadline = now + LEARNING_COAST_TIMEOUT_MS * 1000ULL;
+        g_coast_measuring = true;
+        coast_fit_begin(&g_coast_fit, current_speed, now);
+        return ESP_OK;
     }
     
-    // Turn off motor and start coasting
-    ESP_LOGI(TAG, "Reached %.1f m/s - starting coast measurement", current_speed);
-    hardware_set_motor_speed(0.0f, true); // Stop motor
-    
-    uint64_t coast_start_time = esp_timer_get_time();
-    uint32_t coast_start_rotations = hardware_get_rotation_count();
-    
     // Wait for trolley to stop (speed < 0.1 m/s)
-    while (hardware_get_current_speed() > 0.1f) {
-        vTaskDelay(pdMS_TO_TICKS(100));
-        
-        // Safety timeout
-        if ((esp_timer_get_time() - coast_start_time) > 30000000ULL) { // 30 seconds
-            ESP_LOGW(TAG, "Coasting calibration timeout");
-            break;
+    if (current_speed > 0.1f) {
+        if (now < g_coast_deadline) {
+            coast_fit_sample(&g_coast_fit, current_speed, now);
+            return ESP_OK; // Still coasting
         }
+        deferred_log(DLOG_MSG_WL_COAST_TIMEOUT);
     }
     
-    uint64_t coast_end_time = esp_timer_get_time();
     uint32_t coast_end_rotations = hardware_get_rotation_count();
     
     // Calculate coasting data
-    coasting_data_t coasting_data = {0};
+    coasting_data_t coasting_data = {};
     coasting_data.calibrated = true;
-    coasting_data.coasting_distance_m = hardware_rotations_to_distance(coast_end_rotations - coast_start_rotations);
-    coasting_data.coast_time_ms = (coast_end_time - coast_start_time) / 1000;
+    coasting_data.coasting_distance_m = hardware_rotations_to_distance(coast_end_rotations - g_coasting_start_rotations);
+    coasting_data.coast_time_ms = (now - g_coasting_start_time) / 1000;
     coasting_data.decel_rate_ms2 = g_coasting_start_speed / (coasting_data.coast_time_ms / 1000.0f);
     coasting_data.coast_start_distance_m = coasting_data.coasting_distance_m + 2.0f; // Safety margin
     
+    // Keep learned models and fold this coast into the reverse one
+    // (automatic mode refits both after every coast)
+    const coasting_data_t* previous = mode_coordinator_get_coasting_data();
+    if (previous != NULL) {
+        coasting_data.model_forward = previous->model_forward;
+        coasting_data.model_reverse = previous->model_reverse;
+    }
+    if (coast_fit_finish(&g_coast_fit, &coasting_data.model_reverse) != ESP_OK &&
+        !coasting_data.model_reverse.valid) {
+        coasting_data.model_reverse = coast_model_constant(coasting_data.decel_rate_ms2);
+    }
+    
     // Save coasting data to mode coordinator
     mode_coordinator_set_coasting_data(&coasting_data);
     
-    ESP_LOGI(TAG, "Coasting calibration complete:");
-    ESP_LOGI(TAG, "  Distance: %.2f m", coasting_data.coasting_distance_m);
-    ESP_LOGI(TAG, "  Time: %lu ms", coasting_data.coast_time_ms);
-    ESP_LOGI(TAG, "  Deceleration: %.2f m/s²", coasting_data.decel_rate_ms2);
-    ESP_LOGI(TAG, "  Coast start distance: %.2f m", coasting_data.coast_start_distance_m);
+    deferred_log(DLOG_MSG_WL_COAST_COMPLETE, coasting_data.coasting_distance_m, coasting_data.coast_time_ms,
+                 coasting_data.decel_rate_ms2, coasting_data.coast_start_distance_m);
     
-    g_coasting_calibration_active = false;
+    resume_speed_sweep();
     return ESP_OK;
 }
 
+// ═══════════════════════════════════════════════════════════════════════════════
+// WIRE MAP RECORDING
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Feed the wire map from the traverse in progress
+ *
+ * Open loop: the grade/friction residual is the commanded duty minus the
+ * LUT duty of the speed actually reached, both as offsets toward the travel
+ * direction. The traverses start at the reverse end, so the estimator
+ * position is the map coordinate.
+ */
+static void record_wire_map(void) {
+    bool forward = g_learning_progress.current_direction_forward;
+    state_estimate_t estimate = state_estimator_get_state();
+    hardware_status_t hw_status = hardware_get_status();
+    uint16_t duty = hw_status.current_esc_duty;
+    
+    float peak_g = imu_acquisition_read_peak_g(&g_map_reader);
+    float impact_g = (peak_g > 1.0f) ? peak_g - 1.0f : 0.0f;
+    
+    uint16_t lut_duty = esc_lut_speed_to_duty((uint16_t)(estimate.speed_ms * 1000.0f), forward);
+    float residual = forward ? (float)duty - lut_duty : (float)lut_duty - duty;
+    bool steady = estimate.speed_ms >= WIRE_MAP_MIN_SPEED_MS &&
+                  fabsf(estimate.acceleration_ms2) < WIRE_MAP_STEADY_ACCEL_MS2 &&
+                  hw_status.target_speed_ms > 0.0f;
+    
+    wire_map_record(estimate.position_m, forward, residual, steady, impact_g);
+}
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // MAIN WIRE LEARNING STATE MACHINE
 // ═══════════════════════════════════════════════════════════════════════════════
 
+/**
+ * @brief Record the forward traverse once its wire end is reached
+ */
+static esp_err_t complete_forward_direction(wire_end_detection_method_t detection) {
+    g_learning_progress.forward_rotations = hardware_get_rotation_count() - g_learning_progress.direction_start_rotations;
+    g_learning_progress.forward_distance_m = hardware_rotations_to_distance(g_learning_progress.forward_rotations);
+    g_learning_progress.forward_time_ms = (hal_clock_now_us() - g_learning_progress.direction_start_time) / 1000;
+    g_learning_progress.forward_end_method = detection;
+    
+    deferred_log(DLOG_MSG_WL_FORWARD_COMPLETE, g_learning_progress.forward_distance_m,
+                 g_learning_progress.forward_rotations);
+    
+    // Validate wire length
+    if (g_learning_progress.forward_distance_m < MIN_WIRE_LENGTH_M || 
+        g_learning_progress.forward_distance_m > MAX_WIRE_LENGTH_M) {
+        g_learning_progress.error_text = STATUS_TEXT_LEARN_LENGTH_RANGE;
+        g_learning_progress.state = WIRE_LEARNING_FAILED;
+        return ESP_ERR_INVALID_SIZE;
+    }
+    
+    // Prepare for reverse direction
+    g_direction_pause_deadline = 0;
+    g_learning_progress.state = WIRE_LEARNING_DIRECTION_PAUSE;
+    g_learning_progress.status_text = STATUS_TEXT_LEARN_PAUSING;
+    
+    return ESP_OK;
+}
+
+/**
+ * @brief Record the reverse traverse once its wire end is reached
+ */
+static esp_err_t complete_reverse_direction(wire_end_detection_method_t detection) {
+    g_learning_progress.reverse_rotations = hardware_get_rotation_count() - g_learning_progress.direction_start_rotations;
+    g_learning_progress.reverse_distance_m = hardware_rotations_to_distance(g_learning_progress.reverse_rotations);
+    g_learning_progress.reverse_time_ms = (hal_clock_now_us() - g_learning_progress.direction_start_time) / 1000;
+    g_learning_progress.reverse_end_method = detection;
+    
+    deferred_log(DLOG_MSG_WL_REVERSE_COMPLETE, g_learning_progress.reverse_distance_m,
+                 g_learning_progress.reverse_rotations);
+    
+    // Calculate final results
+    g_learning_progress.state = WIRE_LEARNING_CALCULATING_RESULTS;
+    
+    return ESP_OK;
+}
+
+static void begin_forward_learning(void);
+
+/**
+ * @brief Drive to the reverse end, pause, then start the forward leg there
+ *
+ * The forward leg measures the wire from where it starts. Pushed against the
+ * reverse end, the trolley shows no Hall edge and counts as there.
+ */
+static esp_err_t handle_homing(void) {
+    uint64_t now = hal_clock_now_us();
+    if (g_direction_pause_deadline != 0) {
+        if (now >= g_direction_pause_deadline) {
+            g_direction_pause_deadline = 0;
+            begin_forward_learning();
+        }
+        return ESP_OK;
+    }
+    
+    const char* found = NULL;
+    uint32_t rotations = hardware_get_rotation_count();
+    wire_end_detection_method_t detection = wire_learning_get_best_detection_method();
+    if (detection != WIRE_END_NONE) {
+        found = wire_learning_detection_method_to_string(detection);
+    } else if (rotations != g_homing_rotations) {
+        g_homing_rotations = rotations;
+        g_homing_edge_time = now;
+    } else if ((now - g_homing_edge_time) >= LEARNING_HOMING_STALL_MS * 1000ULL) {
+        found = "no motion";
+    }
+    if (found == NULL) {
+        return ESP_OK;
+    }
+    
+    deferred_log(DLOG_MSG_WL_HOMING_COMPLETE, found);
+    hardware_emergency_stop();
+    wire_end_detector_disarm();
+    g_direction_pause_deadline = now + LEARNING_DIRECTION_PAUSE_MS * 1000ULL;
+    return ESP_OK;
+}
+
 static esp_err_t handle_forward_direction(void) {
+    record_wire_map();
+    
+    // The detector watches every speed step, including the last one
+    wire_end_detection_method_t detection = wire_learning_get_best_detection_method();
+    if (detection != WIRE_END_NONE) {
+        return complete_forward_direction(detection);
+    }
+    
     // Start with lowest speed if not already testing
     if (!g_speed_validated && g_current_test_speed == 0.0f) {
         start_speed_test(WIRE_LEARNING_START_SPEED_MS);
         return ESP_OK;
     }
     
+    // Pausing before the next speed step
+    if (step_pending_speed_test()) {
+        return ESP_OK;
+    }
+    
     // Validate current speed
-    if (!g_speed_validated) {
-        if (validate_current_speed()) {
-            // Speed validated, progress to next speed
-            progress_to_next_speed();
-        } else {
-            // Still validating or failed - check for wire end
-            wire_end_detection_method_t detection = wire_learning_get_best_detection_method();
-            if (detection != WIRE_END_NONE) {
-                // Wire end detected
-                g_learning_progress.forward_rotations = hardware_get_rotation_count() - g_learning_progress.direction_start_rotations;
-                g_learning_progress.forward_distance_m = hardware_rotations_to_distance(g_learning_progress.forward_rotations);
-                g_learning_progress.forward_time_ms = (esp_timer_get_time() - g_learning_progress.direction_start_time) / 1000;
-                g_learning_progress.forward_end_method = detection;
-                
-                ESP_LOGI(TAG, "Forward direction complete: %.2f m (%lu rotations)", 
-                        g_learning_progress.forward_distance_m, g_learning_progress.forward_rotations);
-                
-                // Validate wire length
-                if (g_learning_progress.forward_distance_m < MIN_WIRE_LENGTH_M || 
-                    g_learning_progress.forward_distance_m > MAX_WIRE_LENGTH_M) {
-                    strcpy(g_learning_progress.error_message, "Wire length out of valid range");
-                    g_learning_progress.state = WIRE_LEARNING_FAILED;
-                    return ESP_ERR_INVALID_SIZE;
-                }
-                
-                // Start coasting calibration if needed
-                if (g_current_test_speed >= 4.0f) {
-                    start_coasting_calibration();
-                    process_coasting_calibration();
-                }
-                
-                // Prepare for reverse direction
-                hardware_emergency_stop();
-                vTaskDelay(pdMS_TO_TICKS(LEARNING_DIRECTION_PAUSE_MS));
-                
-                g_learning_progress.state = WIRE_LEARNING_REVERSE_DIRECTION;
-                g_learning_progress.current_direction_forward = false;
-                g_learning_progress.direction_start_rotations = hardware_get_rotation_count();
-                g_learning_progress.direction_start_time = esp_timer_get_time();
-                g_current_test_speed = 0.0f;
-                g_speed_validated = false;
-                wire_learning_reset_detection();
-            }
-        }
+    if (!g_speed_validated && validate_current_speed()) {
+        // Speed validated, progress to next speed
+        progress_to_next_speed();
+    }
+    
+    return ESP_OK;
+}
+
+static esp_err_t handle_direction_pause(void) {
+    uint64_t now = hal_clock_now_us();
+    if (g_direction_pause_deadline == 0) {
+        hardware_emergency_stop();
+        g_direction_pause_deadline = now + LEARNING_DIRECTION_PAUSE_MS * 1000ULL;
+        return ESP_OK;
+    }
+    
+    if (now < g_direction_pause_deadline) {
+        return ESP_OK;
     }
     
+    g_direction_pause_deadline = 0;
+    g_learning_progress.state = WIRE_LEARNING_REVERSE_DIRECTION;
+    g_learning_progress.current_direction_forward = false;
+    g_learning_progress.direction_start_rotations = hardware_get_rotation_count();
+    g_learning_progress.direction_start_time = now;
+    g_current_test_speed = 0.0f;
+    g_speed_validated = false;
+    g_speed_retries = 0;
+    wire_learning_reset_detection();
+    
+    g_learning_progress.status_text = STATUS_TEXT_LEARN_REVERSE;
     return ESP_OK;
 }
 
 static esp_err_t handle_reverse_direction(void) {
+    record_wire_map();
+    
+    wire_end_detection_method_t detection = wire_learning_get_best_detection_method();
+    if (detection != WIRE_END_NONE) {
+        abort_coasting_calibration();
+        return complete_reverse_direction(detection);
+    }
+    
+    // Coasting calibration takes over the motor until the coast is measured
+    if (g_coasting_calibration_active) {
+        return process_coasting_calibration();
+    }
+    if (coasting_calibration_due()) {
+        return start_coasting_calibration();
+    }
+    
     // Same logic as forward direction but in reverse
     if (!g_speed_validated && g_current_test_speed == 0.0f) {
         start_speed_test(WIRE_LEARNING_START_SPEED_MS);
         return ESP_OK;
     }
     
-    if (!g_speed_validated) {
-        if (validate_current_speed()) {
-            progress_to_next_speed();
-        } else {
-            wire_end_detection_method_t detection = wire_learning_get_best_detection_method();
-            if (detection != WIRE_END_NONE) {
-                // Reverse direction complete
-                g_learning_progress.reverse_rotations = hardware_get_rotation_count() - g_learning_progress.direction_start_rotations;
-                g_learning_progress.reverse_distance_m = hardware_rotations_to_distance(g_learning_progress.reverse_rotations);
-                g_learning_progress.reverse_time_ms = (esp_timer_get_time() - g_learning_progress.direction_start_time) / 1000;
-                g_learning_progress.reverse_end_method = detection;
-                
-                ESP_LOGI(TAG, "Reverse direction complete: %.2f m (%lu rotations)", 
-                        g_learning_progress.reverse_distance_m, g_learning_progress.reverse_rotations);
-                
-                // Calculate final results
-                g_learning_progress.state = WIRE_LEARNING_CALCULATING_RESULTS;
-            }
-        }
+    if (step_pending_speed_test()) {
+        return ESP_OK;
+    }
+    
+    if (!g_speed_validated && validate_current_speed()) {
+        progress_to_next_speed();
     }
     
     return ESP_OK;
 }
 
 static esp_err_t calculate_final_results(void) {
-    ESP_LOGI(TAG, "Calculating wire learning results...");
-    
     // Calculate average wire length
     g_learning_progress.calculated_wire_length_m = 
         (g_learning_progress.forward_distance_m + g_learning_progress.reverse_distance_m) / 2.0f;
@@ -373,35 +608,36 @@ static esp_err_t calculate_final_results(void) {
         g_learning_results.optimal_cruise_speed_ms = fmin(g_current_test_speed * 1.5f, 5.0f);
         g_learning_results.forward_rotations = g_learning_progress.forward_rotations;
         g_learning_results.reverse_rotations = g_learning_progress.reverse_rotations;
-        g_learning_results.total_learning_time_ms = (esp_timer_get_time() - g_learning_progress.learning_start_time) / 1000;
+        g_learning_results.total_learning_time_ms = (hal_clock_now_us() - g_learning_progress.learning_start_time) / 1000;
         g_learning_results.primary_detection_method = g_learning_progress.forward_end_method;
         g_learning_results.learning_accuracy_percent = 100.0f - g_learning_progress.length_difference_percent;
         
         // Save results to mode coordinator
         mode_coordinator_set_wire_learning_results(&g_learning_results);
         
+        // Speed sweep of both directions → per-unit ESC duty table (saved by housekeeping)
+        esc_lut_calibration_commit();
+        
+        // Both traverses → position-indexed wire map (normalized and saved by housekeeping)
+        wire_map_finish_learning(g_learning_results.wire_length_m);
+        
         g_learning_progress.learning_successful = true;
         g_learning_progress.state = WIRE_LEARNING_COMPLETE;
         
-        strcpy(g_learning_progress.status_message, "Wire learning completed successfully");
+        g_learning_progress.status_text = STATUS_TEXT_LEARN_COMPLETE;
         
-        ESP_LOGI(TAG, "=== WIRE LEARNING SUCCESSFUL ===");
-        ESP_LOGI(TAG, "Wire Length: %.2f m", g_learning_results.wire_length_m);
-        ESP_LOGI(TAG, "Optimal Speed: %.1f m/s", g_learning_results.optimal_learning_speed_ms);
-        ESP_LOGI(TAG, "Cruise Speed: %.1f m/s", g_learning_results.optimal_cruise_speed_ms);
-        ESP_LOGI(TAG, "Accuracy: %.1f%%", g_learning_results.learning_accuracy_percent);
+        deferred_log(DLOG_MSG_WL_SUCCESS, g_learning_results.wire_length_m,
+                     g_learning_results.optimal_learning_speed_ms, g_learning_results.optimal_cruise_speed_ms,
+                     g_learning_results.learning_accuracy_percent);
         
     } else {
         g_learning_progress.learning_successful = false;
         g_learning_progress.state = WIRE_LEARNING_FAILED;
         
-        snprintf(g_learning_progress.error_message, sizeof(g_learning_progress.error_message),
-                "Wire learning failed: %.1f%% difference > %.1f%% tolerance",
-                g_learning_progress.length_difference_percent, WIRE_LENGTH_TOLERANCE_PERCENT);
+        g_learning_progress.error_text = STATUS_TEXT_LEARN_MISMATCH;   // length_difference_percent has the number
         
-        ESP_LOGE(TAG, "Wire learning failed: Forward %.2f m, Reverse %.2f m (%.1f%% difference)",
-                g_learning_progress.forward_distance_m, g_learning_progress.reverse_distance_m,
-                g_learning_progress.length_difference_percent);
+        deferred_log(DLOG_MSG_WL_FAILED, g_learning_progress.forward_distance_m,
+                     g_learning_progress.reverse_distance_m, g_learning_progress.length_difference_percent);
     }
     
     // Stop motor
@@ -422,8 +658,8 @@ esp_err_t wire_learning_mode_init(void) {
     memset(&g_learning_results, 0, sizeof(g_learning_results));
     
     g_learning_progress.state = WIRE_LEARNING_IDLE;
-    strcpy(g_learning_progress.status_message, "Wire learning ready");
-    strcpy(g_learning_progress.error_message, "");
+    g_learning_progress.status_text = STATUS_TEXT_LEARN_READY;
+    g_learning_progress.error_text = STATUS_TEXT_NONE;
     
     g_learning_initialized = true;
     
@@ -431,6 +667,8 @@ esp_err_t wire_learning_mode_init(void) {
     return ESP_OK;
 }
 
+static void begin_homing(void);
+
 esp_err_t wire_learning_mode_start(void) {
     if (!g_learning_initialized) {
         return ESP_ERR_INVALID_STATE;
@@ -447,39 +685,81 @@ esp_err_t wire_learning_mode_start(void) {
     // Reset learning state
     memset(&g_learning_progress, 0, sizeof(g_learning_progress));
     g_learning_progress.state = WIRE_LEARNING_INITIALIZING;
-    g_learning_progress.learning_start_time = esp_timer_get_time();
+    g_learning_progress.learning_start_time = hal_clock_now_us();
     g_learning_progress.current_direction_forward = true;
     
-    strcpy(g_learning_progress.status_message, "Initializing wire learning...");
+    g_learning_progress.status_text = STATUS_TEXT_LEARN_INITIALIZING;
     
-    // Auto-arm ESC
+    // Auto-arm ESC (non-blocking: learning begins from update() once armed)
     if (!hardware_esc_is_armed()) {
         ESP_LOGI(TAG, "Auto-arming ESC for wire learning");
         result = hardware_esc_arm();
         if (result != ESP_OK) {
-            strcpy(g_learning_progress.error_message, "Failed to arm ESC");
+            g_learning_progress.error_text = STATUS_TEXT_ARM_FAILED;
             g_learning_progress.state = WIRE_LEARNING_FAILED;
             return result;
         }
+        g_learning_progress.status_text = STATUS_TEXT_ARMING_ESC;
+        return ESP_OK;
     }
     
+    begin_homing();
+    return ESP_OK;
+}
+
+/**
+ * @brief Start the homing run to the reverse end (ESC armed)
+ */
+static void begin_homing(void) {
+    g_learning_progress.state = WIRE_LEARNING_HOMING;
+    g_learning_progress.current_direction_forward = false;
+    g_homing_rotations = hardware_get_rotation_count();
+    g_homing_edge_time = hal_clock_now_us();
+    g_direction_pause_deadline = 0;
+    wire_learning_reset_detection();
+    
+    deferred_log(DLOG_MSG_WL_HOMING, LEARNING_HOMING_SPEED_MS);
+    if (hardware_set_motor_speed(LEARNING_HOMING_SPEED_MS, false) != ESP_OK) {
+        deferred_log(DLOG_MSG_WL_SPEED_SET_FAILED);
+    }
+    g_learning_progress.current_learning_speed = LEARNING_HOMING_SPEED_MS;
+    g_learning_progress.status_text = STATUS_TEXT_LEARN_HOMING;
+}
+
+/**
+ * @brief Start the forward traverse (ESC armed)
+ */
+static void begin_forward_learning(void) {
     // Reset hardware tracking
     hardware_reset_position();
     hardware_reset_rotation_count();
     
+    // Speed progression also collects ESC calibration points
+    esc_lut_calibration_begin();
+    
+    // Both traverses fill a new wire map from the reverse end (position 0)
+    wire_map_begin_learning();
+    imu_acquisition_reader_init(&g_map_reader);
+    
     // Start forward direction learning
     g_learning_progress.state = WIRE_LEARNING_FORWARD_DIRECTION;
-    g_learning_progress.direction_start_time = esp_timer_get_time();
+    g_learning_progress.current_direction_forward = true;
+    g_learning_progress.direction_start_time = hal_clock_now_us();
     g_learning_progress.direction_start_rotations = hardware_get_rotation_count();
     
     g_current_test_speed = 0.0f;
     g_speed_validated = false;
+    g_speed_retries = 0;
+    g_next_speed_deadline = 0;
+    g_direction_pause_deadline = 0;
+    g_coasting_calibration_done = false;
+    g_coasting_calibration_active = false;
+    g_coast_measuring = false;
     wire_learning_reset_detection();
     
-    strcpy(g_learning_progress.status_message, "Learning forward direction...");
+    g_learning_progress.status_text = STATUS_TEXT_LEARN_FORWARD;
     
     ESP_LOGI(TAG, "Wire learning started - forward direction");
-    return ESP_OK;
 }
 
 esp_err_t wire_learning_mode_stop(bool immediate) {
@@ -490,13 +770,17 @@ esp_err_t wire_learning_mode_stop(bool immediate) {
     
     if (immediate) {
         g_learning_progress.state = WIRE_LEARNING_IDLE;
-        strcpy(g_learning_progress.status_message, "Wire learning stopped by user");
+        g_learning_progress.status_text = STATUS_TEXT_LEARN_STOPPED;
     } else {
         g_learning_progress.state = WIRE_LEARNING_STOPPING;
-        strcpy(g_learning_progress.status_message, "Wire learning stopping gracefully...");
+        g_learning_progress.status_text = STATUS_TEXT_LEARN_STOPPING;
     }
     
     g_coasting_calibration_active = false;
+    g_coast_measuring = false;
+    g_next_speed_deadline = 0;
+    g_direction_pause_deadline = 0;
+    wire_end_detector_disarm();
     
     return ESP_OK;
 }
@@ -507,11 +791,12 @@ esp_err_t wire_learning_mode_update(void) {
     // Check for timeout
     if (g_learning_progress.state > WIRE_LEARNING_IDLE && 
         g_learning_progress.state < WIRE_LEARNING_COMPLETE) {
-        uint64_t elapsed_time = esp_timer_get_time() - g_learning_progress.learning_start_time;
+        uint64_t elapsed_time = hal_clock_now_us() - g_learning_progress.learning_start_time;
         if (elapsed_time > WIRE_LEARNING_TIMEOUT_S * 1000000ULL) {
-            strcpy(g_learning_progress.error_message, "Wire learning timeout");
+            g_learning_progress.error_text = STATUS_TEXT_LEARN_TIMEOUT;
             g_learning_progress.state = WIRE_LEARNING_FAILED;
             hardware_emergency_stop();
+            wire_end_detector_disarm();
             return ESP_ERR_TIMEOUT;
         }
     }
@@ -522,8 +807,17 @@ esp_err_t wire_learning_mode_update(void) {
             break;
             
         case WIRE_LEARNING_INITIALIZING:
-            // Transition to forward direction
-            g_learning_progress.state = WIRE_LEARNING_FORWARD_DIRECTION;
+            // Transition to forward direction once the ESC arming sequence completes
+            if (hardware_esc_is_armed()) {
+                begin_homing();
+            } else if (hardware_esc_get_arm_state() == ESC_ARM_DISARMED) {
+                g_learning_progress.error_text = STATUS_TEXT_ARM_CANCELLED;
+                g_learning_progress.state = WIRE_LEARNING_FAILED;
+            }
+            break;
+            
+        case WIRE_LEARNING_HOMING:
+            handle_homing();
             break;
             
         case WIRE_LEARNING_FORWARD_DIRECTION:
@@ -531,7 +825,7 @@ esp_err_t wire_learning_mode_update(void) {
             break;
             
         case WIRE_LEARNING_DIRECTION_PAUSE:
-            // Pause handled in forward direction handler
+            handle_direction_pause();
             break;
             
         case WIRE_LEARNING_REVERSE_DIRECTION:
@@ -557,6 +851,10 @@ bool wire_learning_mode_is_active(void) {
            g_learning_progress.state < WIRE_LEARNING_COMPLETE;
 }
 
+wire_learning_state_t wire_learning_mode_get_state(void) {
+    return g_learning_progress.state;
+}
+
 bool wire_learning_mode_is_complete(void) {
     return g_learning_progress.state == WIRE_LEARNING_COMPLETE && 
            g_learning_progress.learning_successful;
@@ -631,24 +929,28 @@ esp_err_t wire_learning_emergency_stop(void) {
     
     hardware_emergency_stop();
     g_learning_progress.state = WIRE_LEARNING_FAILED;
-    strcpy(g_learning_progress.error_message, "Emergency stop activated");
+    g_learning_progress.error_text = STATUS_TEXT_EMERGENCY_STOP;
     g_coasting_calibration_active = false;
+    g_coast_measuring = false;
+    g_next_speed_deadline = 0;
+    g_direction_pause_deadline = 0;
     
     return ESP_OK;
 }
 
 const char* wire_learning_get_status_message(void) {
-    return g_learning_progress.status_message;
+    return status_text_to_string(g_learning_progress.status_text);
 }
 
 const char* wire_learning_get_error_message(void) {
-    return g_learning_progress.error_message;
+    return status_text_to_string(g_learning_progress.error_text);
 }
 
 const char* wire_learning_state_to_string(wire_learning_state_t state) {
     switch (state) {
         case WIRE_LEARNING_IDLE: return "Idle";
         case WIRE_LEARNING_INITIALIZING: return "Initializing";
+        case WIRE_LEARNING_HOMING: return "Homing";
         case WIRE_LEARNING_FORWARD_DIRECTION: return "Forward Direction";
         case WIRE_LEARNING_DIRECTION_PAUSE: return "Direction Pause";
         case WIRE_LEARNING_REVERSE_DIRECTION: return "Reverse Direction";
@@ -675,6 +977,7 @@ int wire_learning_get_progress_percentage(void) {
     switch (g_learning_progress.state) {
         case WIRE_LEARNING_IDLE: return 0;
         case WIRE_LEARNING_INITIALIZING: return 5;
+        case WIRE_LEARNING_HOMING: return 15;
         case WIRE_LEARNING_FORWARD_DIRECTION: return 35;
         case WIRE_LEARNING_DIRECTION_PAUSE: return 50;
         case WIRE_LEARNING_REVERSE_DIRECTION: return 85;
@@ -692,7 +995,7 @@ uint32_t wire_learning_get_estimated_time_remaining(void) {
         return 0;
     }
     
-    uint64_t elapsed_time = esp_timer_get_time() - g_learning_progress.learning_start_time;
+    uint64_t elapsed_time = hal_clock_now_us() - g_learning_progress.learning_start_time;
     uint32_t elapsed_seconds = elapsed_time / 1000000;
     
     // Rough estimation based on typical learning time
@@ -715,11 +1018,14 @@ esp_err_t wire_learning_mode_reset(void) {
     memset(&g_learning_results, 0, sizeof(g_learning_results));
     
     g_learning_progress.state = WIRE_LEARNING_IDLE;
-    strcpy(g_learning_progress.status_message, "Wire learning reset");
+    g_learning_progress.status_text = STATUS_TEXT_LEARN_RESET;
     
     g_current_test_speed = 0.0f;
     g_speed_validated = false;
     g_coasting_calibration_active = false;
+    g_coast_measuring = false;
+    g_next_speed_deadline = 0;
+    g_direction_pause_deadline = 0;
     wire_learning_reset_detection();
     
     return ESP_OK;
@@ -0,0 +1,201 @@
+// components/wire_map/include/wire_map.h
+#ifndef WIRE_MAP_H
+#define WIRE_MAP_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// WIRE_MAP.H - POSITION-INDEXED MAP OF GRADE, FRICTION AND IMPACT HOTSPOTS
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Know what the wire is like at every position
+// - Flat array of WIRE_MAP_BIN_SIZE_M bins from the reverse wire end (0) to
+//   the forward end (wire length); 4 bytes per bin, 2 km fits in PSRAM
+// - Per bin and direction: duty needed beyond the ESC LUT at steady speed
+//   (grade/friction residual, running mean over runs) and the peak IMU
+//   impact over gravity; bins above WIRE_MAP_HOTSPOT_G are slow zones
+// - Filled by wire learning (open loop: duty vs LUT duty of the measured
+//   speed) and refined by every automatic run (closed loop: bias + PI
+//   correction), one sample per bin pass
+// - wire_map_lookup() is O(1) (Catmull-Rom over four bins) and safe from the
+//   control loop; positions are map coordinates, not estimator positions
+// - Stored delta-encoded in the "wiremap" flash partition for the active
+//   site; flash work is deferred to wire_map_process_flash(), called by
+//   housekeeping between modes while stationary
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Map configuration
+#define WIRE_MAP_PARTITION          "wiremap"   // Data partition label (partitions.csv)
+#define WIRE_MAP_BIN_SIZE_M         0.1f        // Bin length
+#define WIRE_MAP_MAX_BINS           20001       // 2 km wire (PSRAM)
+#define WIRE_MAP_FALLBACK_BINS      2001        // 200 m wire (internal RAM without PSRAM)
+#define WIRE_MAP_DUTY_LSB           2.0f        // Duty counts per residual LSB (±254 counts)
+#define WIRE_MAP_IMPACT_LSB_G       0.02f       // g per impact LSB (5.1 g full scale)
+#define WIRE_MAP_AVERAGE_PASSES     8           // Running-mean window of a bin's residual
+#define WIRE_MAP_WRITE_CHUNK        1024        // Flash bytes per wire_map_process_flash() call
+
+// Recording and zone thresholds
+#define WIRE_MAP_MIN_SPEED_MS       0.3f        // Residuals below this speed are not steady enough
+#define WIRE_MAP_STEADY_ACCEL_MS2   0.2f        // Residuals only while |accel| stays below this
+#define WIRE_MAP_HOTSPOT_G          0.4f        // Impact over gravity that marks a slow zone
+#define WIRE_MAP_ZONE_SPEED_MS      2.0f        // Speed limit through a WIRE_MAP_HOTSPOT_G zone
+#define WIRE_MAP_MIN_ZONE_SPEED_MS  0.8f        // Floor for the limit of harder hotspots
+#define WIRE_MAP_NO_LIMIT_MS        100.0f      // speed_limit_ms outside slow zones
+
+// Flash format (header, then one delta stream per bin field)
+#define WIRE_MAP_MAGIC              0x50414D57  // "WMAP"
+#define WIRE_MAP_VERSION            1
+
+// On-flash map header (little-endian)
+typedef struct __attribute__((packed)) {
+    uint32_t magic;                    // WIRE_MAP_MAGIC once the map is completely written
+    uint8_t version;                   // WIRE_MAP_VERSION
+    uint8_t bin_size_cm;               // WIRE_MAP_BIN_SIZE_M in cm
+    uint16_t reserved;
+    char site_id[16];                  // Calibration site the map belongs to
+    uint32_t bin_count;
+    float wire_length_m;
+    uint32_t encoded_size;             // Bytes after the header
+    uint32_t crc32;                    // CRC-32 of the encoded bins
+} wire_map_header_t;
+
+// One 10 cm bin
+typedef struct {
+    int8_t residual[2];                // [0] forward, [1] reverse, WIRE_MAP_DUTY_LSB units
+    uint8_t impact;                    // Peak impact over gravity, WIRE_MAP_IMPACT_LSB_G units
+    uint8_t passes;                    // Low nibble forward, high nibble reverse residual passes
+} wire_map_bin_t;
+
+// Map at one position
+typedef struct {
+    bool known;                        // Residual measured near here in this direction
+    float residual_duty;               // Duty beyond the LUT (+ uphill/drag, - downhill)
+    float impact_g;                    // Peak impact over gravity of the surrounding bins
+    bool slow_zone;                    // impact_g over WIRE_MAP_HOTSPOT_G
+    float speed_limit_ms;              // Zone limit (WIRE_MAP_NO_LIMIT_MS outside zones)
+} wire_map_point_t;
+
+// Map statistics
+typedef struct {
+    bool valid;                        // Map covers the current wire
+    bool learning;                     // Wire learning is filling a new map
+    bool in_psram;                     // false = WIRE_MAP_FALLBACK_BINS internal RAM
+    bool flash_available;              // Partition found
+    bool save_pending;                 // Changes not yet in flash
+    uint32_t capacity_bins;
+    uint32_t bin_count;
+    float wire_length_m;
+    uint32_t known_bins_forward;       // Bins with a forward residual
+    uint32_t known_bins_reverse;       // Bins with a reverse residual
+    uint32_t slow_zone_bins;
+    uint32_t encoded_bytes;            // Size of the last stored/loaded map
+    uint32_t saves;                    // Maps written since boot
+    uint32_t flash_errors;
+} wire_map_stats_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CORE MAP API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Allocate the bins and find the flash partition
+ * @return ESP_OK (also without partition: the map then lives only in RAM),
+ *         ESP_ERR_NO_MEM if no bin array could be allocated
+ */
+esp_err_t wire_map_init(void);
+
+/**
+ * @brief Load the stored map of a site
+ * @param site_id Calibration site ID
+ * @param wire_length_m Expected wire length (stored map must match)
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if no map for this site,
+ *         ESP_ERR_INVALID_RESPONSE if the stored map is corrupt or for another wire
+ */
+esp_err_t wire_map_load(const char* site_id, float wire_length_m);
+
+/**
+ * @brief Forget the map in RAM (flash copy kept, e.g. on a site change)
+ */
+void wire_map_reset(void);
+
+/**
+ * @brief Drop the map and erase its flash copy (erase deferred to wire_map_process_flash)
+ */
+void wire_map_clear(void);
+
+/**
+ * @brief Whether the map can be looked up
+ * @return true if a map covers the current wire
+ */
+bool wire_map_is_valid(void);
+
+/**
+ * @brief Get the mapped wire length
+ * @return Wire length in meters (0 if no map)
+ */
+float wire_map_get_length(void);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// RECORDING API (control loop)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Start a new map (wire learning); lookups are disabled until finished
+ */
+void wire_map_begin_learning(void);
+
+/**
+ * @brief Finish the new map
+ * @param wire_length_m Learned wire length
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if not learning, ESP_ERR_INVALID_SIZE if
+ *         the wire does not fit the bin array (map covers the first part only)
+ */
+esp_err_t wire_map_finish_learning(float wire_length_m);
+
+/**
+ * @brief Add one control tick to the map
+ * @param position_m Map coordinate (0 = reverse end)
+ * @param forward Travel direction
+ * @param residual_duty Duty beyond the LUT at this tick
+ * @param residual_valid Speed steady enough for residual_duty to count
+ * @param impact_g Peak impact over gravity since the last call
+ * @note One sample per bin pass: ticks are averaged until the bin changes
+ */
+void wire_map_record(float position_m, bool forward, float residual_duty, bool residual_valid,
+                     float impact_g);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// LOOKUP API (control loop)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Look up the map at a position
+ * @param position_m Map coordinate (0 = reverse end)
+ * @param forward Travel direction
+ * @param point Output map values
+ * @return true if the map is valid and position_m is on the wire
+ */
+bool wire_map_lookup(float position_m, bool forward, wire_map_point_t* point);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STORAGE API (housekeeping)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief One bounded flash step: erase a sector or write WIRE_MAP_WRITE_CHUNK bytes
+ * @param site_id Calibration site the map is stored for
+ * @return ESP_OK (also when idle), flash error otherwise (retried next call)
+ * @note Only call between modes while stationary: flash erase/program stalls both cores
+ */
+esp_err_t wire_map_process_flash(const char* site_id);
+
+/**
+ * @brief Get map statistics
+ * @param stats Output statistics
+ */
+void wire_map_get_stats(wire_map_stats_t* stats);
+
+#endif // WIRE_MAP_H
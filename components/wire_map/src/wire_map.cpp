@@ -0,0 +1,645 @@
+// components/wire_map/src/wire_map.cpp
+// ═══════════════════════════════════════════════════════════════════════════════
+// WIRE_MAP.CPP - BIN RECORDING, SPLINE LOOKUP, DELTA-ENCODED FLASH STORAGE
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// Flash encoding: each bin field is stored as its own stream of byte deltas
+// to the previous bin, PackBits style. A control byte c >= 0x80 repeats the
+// previous value (c & 0x7F) + 1 times (zero deltas: long uniform stretches),
+// c < 0x80 is followed by c + 1 literal delta bytes.
+
+#include "wire_map.h"
+#include "status_snapshot.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_crc.h"
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+static const char* TAG = "WIRE_MAP";
+
+#define FLASH_SECTOR_SIZE           4096
+#define BIN_FIELDS                  sizeof(wire_map_bin_t)
+#define FIELD_ENCODED_MAX(bins)     ((bins) + (bins) / 128 + 1)
+#define MAP_ENCODED_MAX(bins)       (BIN_FIELDS * FIELD_ENCODED_MAX(bins))
+#define PASSES_MAX                  15          // Per-direction pass counter (one nibble)
+
+static_assert(sizeof(wire_map_bin_t) == 4, "wire map bin layout changed");
+static_assert(sizeof(wire_map_header_t) == 40, "wire map header layout changed");
+
+// Storage progress (housekeeping only)
+typedef enum {
+    MAP_FLASH_IDLE = 0,
+    MAP_FLASH_ERASING,                  // Erasing the sectors the staged map needs
+    MAP_FLASH_WRITING                   // Encoded bins first, header last marks the map complete
+} map_flash_state_t;
+
+// Ticks within one bin, folded into the bin when the trolley leaves it
+typedef struct {
+    int32_t bin;                       // -1 = no pass in progress
+    bool forward;
+    float residual_sum;
+    uint32_t residual_samples;
+    float impact_peak_g;
+} bin_pass_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// GLOBAL STATE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static bool g_initialized = false;
+static const esp_partition_t* g_partition = NULL;
+
+static wire_map_bin_t* g_bins = NULL;
+static uint32_t g_capacity = 0;
+static uint32_t g_bin_count = 0;
+static float g_wire_length_m = 0.0f;
+
+// Written by the control loop (recording), read by housekeeping
+static std::atomic<bool> g_valid{false};
+static std::atomic<bool> g_finish_pending{false};       // Learned map waits for finalize_learning()
+static std::atomic<bool> g_dirty{false};                // Bins changed since the last save
+static std::atomic<bool> g_erase_pending{false};        // Map cleared, flash copy still there
+static bool g_learning = false;
+static uint32_t g_clear_watermark = 0;                  // Learning: bins from here on not yet zeroed
+static bin_pass_t g_pass = {-1, true, 0.0f, 0, 0.0f};
+
+static uint8_t* g_staging = NULL;                       // Header + encoded bins
+static size_t g_staging_capacity = 0;
+static size_t g_staging_length = 0;
+static size_t g_write_offset = 0;
+static uint32_t g_erase_sector = 0;
+static uint32_t g_erase_sectors = 0;
+static map_flash_state_t g_flash_state = MAP_FLASH_IDLE;
+
+static wire_map_stats_t g_stats;
+static status_snapshot<wire_map_stats_t> g_stats_snapshot;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// BIN HELPERS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static inline int direction_index(bool forward) {
+    return forward ? 0 : 1;
+}
+
+static inline uint8_t bin_passes(const wire_map_bin_t* bin, int dir) {
+    return dir == 0 ? (bin->passes & 0x0F) : (bin->passes >> 4);
+}
+
+static inline void set_bin_passes(wire_map_bin_t* bin, int dir, uint8_t passes) {
+    if (dir == 0) {
+        bin->passes = (uint8_t)((bin->passes & 0xF0) | passes);
+    } else {
+        bin->passes = (uint8_t)((bin->passes & 0x0F) | (passes << 4));
+    }
+}
+
+static inline int8_t quantize_residual(float duty) {
+    float lsb = roundf(duty / WIRE_MAP_DUTY_LSB);
+    if (lsb > 127.0f) lsb = 127.0f;
+    if (lsb < -127.0f) lsb = -127.0f;
+    return (int8_t)lsb;
+}
+
+static inline uint8_t quantize_impact(float impact_g) {
+    float lsb = roundf(impact_g / WIRE_MAP_IMPACT_LSB_G);
+    if (lsb > 255.0f) lsb = 255.0f;
+    if (lsb < 0.0f) lsb = 0.0f;
+    return (uint8_t)lsb;
+}
+
+/**
+ * @brief Zero new bins on first touch while learning
+ *
+ * Clearing the whole array at once would cost a control tick; the forward
+ * traverse reaches bins in order, so each is cleared just before it is used.
+ */
+static void ensure_cleared(uint32_t bin) {
+    if (!g_learning || bin < g_clear_watermark) return;
+    memset(&g_bins[g_clear_watermark], 0, (bin + 1 - g_clear_watermark) * sizeof(wire_map_bin_t));
+    g_clear_watermark = bin + 1;
+}
+
+static void commit_pass(void) {
+    if (g_pass.bin < 0) return;
+
+    uint32_t index = (uint32_t)g_pass.bin;
+    ensure_cleared(index);
+    wire_map_bin_t* bin = &g_bins[index];
+    int dir = direction_index(g_pass.forward);
+
+    if (g_pass.residual_samples > 0) {
+        // Running mean over the last WIRE_MAP_AVERAGE_PASSES passes of this bin
+        float mean = g_pass.residual_sum / g_pass.residual_samples;
+        uint8_t passes = bin_passes(bin, dir);
+        uint32_t window = passes + 1u < WIRE_MAP_AVERAGE_PASSES ? passes + 1u : WIRE_MAP_AVERAGE_PASSES;
+        float residual = bin->residual[dir] * WIRE_MAP_DUTY_LSB;
+        bin->residual[dir] = quantize_residual(residual + (mean - residual) / window);
+        if (passes < PASSES_MAX) set_bin_passes(bin, dir, passes + 1);
+    }
+
+    uint8_t impact = quantize_impact(g_pass.impact_peak_g);
+    if (impact > bin->impact) bin->impact = impact;
+
+    if (!g_learning) g_dirty.store(true, std::memory_order_relaxed);
+    g_pass.bin = -1;
+}
+
+static void count_bins(void) {
+    g_stats.known_bins_forward = 0;
+    g_stats.known_bins_reverse = 0;
+    g_stats.slow_zone_bins = 0;
+    uint8_t hotspot = quantize_impact(WIRE_MAP_HOTSPOT_G);
+
+    for (uint32_t i = 0; i < g_bin_count; i++) {
+        if (bin_passes(&g_bins[i], 0) > 0) g_stats.known_bins_forward++;
+        if (bin_passes(&g_bins[i], 1) > 0) g_stats.known_bins_reverse++;
+        if (g_bins[i].impact > hotspot) g_stats.slow_zone_bins++;
+    }
+}
+
+/**
+ * @brief Complete a learned map (housekeeping, O(bins))
+ *
+ * Learning runs open loop against the previous ESC LUT, which the same speed
+ * sweep then recalibrates. The mean residual of a direction is that LUT
+ * error, not the wire, so it is removed; automatic runs refine the rest.
+ */
+static void finalize_learning(void) {
+    g_finish_pending.store(false, std::memory_order_relaxed);
+
+    if (g_clear_watermark < g_bin_count) {
+        memset(&g_bins[g_clear_watermark], 0, (g_bin_count - g_clear_watermark) * sizeof(wire_map_bin_t));
+        g_clear_watermark = g_bin_count;
+    }
+
+    for (int dir = 0; dir < 2; dir++) {
+        float sum = 0.0f;
+        uint32_t known = 0;
+        for (uint32_t i = 0; i < g_bin_count; i++) {
+            if (bin_passes(&g_bins[i], dir) == 0) continue;
+            sum += g_bins[i].residual[dir] * WIRE_MAP_DUTY_LSB;
+            known++;
+        }
+        if (known == 0) continue;
+        float mean = sum / known;
+        for (uint32_t i = 0; i < g_bin_count; i++) {
+            if (bin_passes(&g_bins[i], dir) == 0) continue;
+            g_bins[i].residual[dir] = quantize_residual(g_bins[i].residual[dir] * WIRE_MAP_DUTY_LSB - mean);
+        }
+    }
+
+    count_bins();
+    g_valid.store(true, std::memory_order_release);
+    g_dirty.store(true, std::memory_order_relaxed);
+
+    ESP_LOGI(TAG, "Wire map learned: %lu bins over %.1f m, %lu/%lu bins with residual, %lu slow-zone bins",
+             (unsigned long)g_bin_count, g_wire_length_m, (unsigned long)g_stats.known_bins_forward,
+             (unsigned long)g_stats.known_bins_reverse, (unsigned long)g_stats.slow_zone_bins);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DELTA ENCODING
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static inline uint8_t field_value(uint32_t bin, size_t field) {
+    return ((const uint8_t*)&g_bins[bin])[field];
+}
+
+static size_t encode_field(size_t field, uint8_t* out) {
+    size_t length = 0;
+    uint8_t previous = 0;
+    uint32_t i = 0;
+
+    while (i < g_bin_count) {
+        if (field_value(i, field) == previous) {
+            uint32_t run = 0;
+            while (i < g_bin_count && run < 128 && field_value(i, field) == previous) {
+                run++;
+                i++;
+            }
+            out[length++] = (uint8_t)(0x80 | (run - 1));
+            continue;
+        }
+
+        // Literal deltas until a repeat of two or more starts
+        size_t control = length++;
+        uint32_t literal = 0;
+        while (i < g_bin_count && literal < 128) {
+            uint8_t value = field_value(i, field);
+            if (value == previous && i + 1 < g_bin_count && field_value(i + 1, field) == value) break;
+            out[length++] = (uint8_t)(value - previous);
+            previous = value;
+            literal++;
+            i++;
+        }
+        out[control] = (uint8_t)(literal - 1);
+    }
+    return length;
+}
+
+static bool decode_field(size_t field, const uint8_t* in, size_t size, size_t* used) {
+    size_t position = 0;
+    uint8_t previous = 0;
+    uint32_t i = 0;
+
+    while (i < g_bin_count) {
+        if (position >= size) return false;
+        uint8_t control = in[position++];
+        uint32_t count = (control & 0x7F) + 1u;
+        if (i + count > g_bin_count) return false;
+
+        if (control & 0x80) {
+            for (uint32_t k = 0; k < count; k++) {
+                ((uint8_t*)&g_bins[i++])[field] = previous;
+            }
+        } else {
+            if (position + count > size) return false;
+            for (uint32_t k = 0; k < count; k++) {
+                previous = (uint8_t)(previous + in[position++]);
+                ((uint8_t*)&g_bins[i++])[field] = previous;
+            }
+        }
+    }
+    *used = position;
+    return true;
+}
+
+static void stage_map(const char* site_id) {
+    uint8_t* payload = g_staging + sizeof(wire_map_header_t);
+    size_t encoded = 0;
+    for (size_t field = 0; field < BIN_FIELDS; field++) {
+        encoded += encode_field(field, payload + encoded);
+    }
+
+    wire_map_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = WIRE_MAP_MAGIC;
+    header.version = WIRE_MAP_VERSION;
+    header.bin_size_cm = (uint8_t)lroundf(WIRE_MAP_BIN_SIZE_M * 100.0f);
+    strncpy(header.site_id, site_id, sizeof(header.site_id) - 1);
+    header.bin_count = g_bin_count;
+    header.wire_length_m = g_wire_length_m;
+    header.encoded_size = (uint32_t)encoded;
+    header.crc32 = esp_rom_crc32_le(0, payload, encoded);
+    memcpy(g_staging, &header, sizeof(header));
+
+    g_staging_length = sizeof(header) + encoded;
+    g_write_offset = sizeof(header);
+    g_erase_sector = 0;
+    g_erase_sectors = (uint32_t)((g_staging_length + FLASH_SECTOR_SIZE - 1) / FLASH_SECTOR_SIZE);
+    g_stats.encoded_bytes = (uint32_t)encoded;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FLASH (HOUSEKEEPING, ONLY BETWEEN MODES WHILE STATIONARY)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief One bounded flash step of the staged map
+ * @return ESP_OK or the failed flash operation (retried next call)
+ */
+static esp_err_t flash_step(void) {
+    esp_err_t result;
+
+    if (g_flash_state == MAP_FLASH_ERASING) {
+        result = esp_partition_erase_range(g_partition, g_erase_sector * FLASH_SECTOR_SIZE, FLASH_SECTOR_SIZE);
+        if (result != ESP_OK) return result;
+        if (++g_erase_sector >= g_erase_sectors) {
+            g_flash_state = MAP_FLASH_WRITING;
+        }
+        return ESP_OK;
+    }
+
+    if (g_write_offset < g_staging_length) {
+        size_t chunk = g_staging_length - g_write_offset;
+        if (chunk > WIRE_MAP_WRITE_CHUNK) chunk = WIRE_MAP_WRITE_CHUNK;
+        result = esp_partition_write(g_partition, g_write_offset, g_staging + g_write_offset, chunk);
+        if (result != ESP_OK) return result;
+        g_write_offset += chunk;
+        return ESP_OK;
+    }
+
+    result = esp_partition_write(g_partition, 0, g_staging, sizeof(wire_map_header_t));
+    if (result != ESP_OK) return result;
+
+    g_flash_state = MAP_FLASH_IDLE;
+    g_stats.saves++;
+    ESP_LOGI(TAG, "Wire map stored: %lu bins in %lu bytes (%.0f%% of raw)",
+             (unsigned long)g_bin_count, (unsigned long)g_stats.encoded_bytes,
+             100.0f * g_stats.encoded_bytes / (g_bin_count * sizeof(wire_map_bin_t)));
+    return ESP_OK;
+}
+
+static void publish_stats(void) {
+    g_stats.valid = g_valid.load(std::memory_order_relaxed);
+    g_stats.learning = g_learning;
+    g_stats.save_pending = g_flash_state != MAP_FLASH_IDLE ||
+                           g_finish_pending.load(std::memory_order_relaxed) ||
+                           (g_partition != NULL && g_dirty.load(std::memory_order_relaxed));
+    g_stats.bin_count = g_bin_count;
+    g_stats.wire_length_m = g_wire_length_m;
+    g_stats_snapshot.write(g_stats);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CORE MAP API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t wire_map_init(void) {
+    if (g_initialized) return ESP_OK;
+
+    memset(&g_stats, 0, sizeof(g_stats));
+
+    // 2 km of bins needs PSRAM; internal RAM fallback only maps a short wire
+    g_bins = (wire_map_bin_t*)heap_caps_malloc(WIRE_MAP_MAX_BINS * sizeof(wire_map_bin_t), MALLOC_CAP_SPIRAM);
+    g_capacity = WIRE_MAP_MAX_BINS;
+    g_stats.in_psram = (g_bins != NULL);
+    if (g_bins == NULL) {
+        g_bins = (wire_map_bin_t*)heap_caps_malloc(WIRE_MAP_FALLBACK_BINS * sizeof(wire_map_bin_t), MALLOC_CAP_8BIT);
+        g_capacity = WIRE_MAP_FALLBACK_BINS;
+    }
+    g_staging_capacity = sizeof(wire_map_header_t) + MAP_ENCODED_MAX(g_capacity);
+    g_staging = (uint8_t*)heap_caps_malloc(g_staging_capacity, g_stats.in_psram ? MALLOC_CAP_SPIRAM : MALLOC_CAP_8BIT);
+    if (g_bins == NULL || g_staging == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate wire map buffers");
+        heap_caps_free(g_bins);
+        heap_caps_free(g_staging);
+        g_bins = NULL;
+        g_staging = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    memset(g_bins, 0, g_capacity * sizeof(wire_map_bin_t));
+
+    g_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                           WIRE_MAP_PARTITION);
+    if (g_partition == NULL) {
+        ESP_LOGW(TAG, "No '%s' partition - wire map will not be stored", WIRE_MAP_PARTITION);
+    }
+
+    g_stats.flash_available = (g_partition != NULL);
+    g_stats.capacity_bins = g_capacity;
+    g_initialized = true;
+    publish_stats();
+
+    ESP_LOGI(TAG, "Wire map: %lu bins (%.0f m) in %s", (unsigned long)g_capacity,
+             (g_capacity - 1) * WIRE_MAP_BIN_SIZE_M, g_stats.in_psram ? "PSRAM" : "internal RAM");
+    return ESP_OK;
+}
+
+esp_err_t wire_map_load(const char* site_id, float wire_length_m) {
+    if (!g_initialized) return ESP_ERR_INVALID_STATE;
+    if (site_id == NULL) return ESP_ERR_INVALID_ARG;
+
+    wire_map_reset();
+    g_bin_count = 0;
+    g_wire_length_m = 0.0f;
+
+    esp_err_t result = ESP_ERR_NOT_FOUND;
+    wire_map_header_t header;
+
+    if (g_partition != NULL &&
+        esp_partition_read(g_partition, 0, &header, sizeof(header)) == ESP_OK &&
+        header.magic == WIRE_MAP_MAGIC && header.version == WIRE_MAP_VERSION &&
+        strncmp(header.site_id, site_id, sizeof(header.site_id)) == 0) {
+        result = ESP_ERR_INVALID_RESPONSE;
+        uint8_t* payload = g_staging + sizeof(header);
+        size_t payload_capacity = g_staging_capacity - sizeof(header);
+        float expected_m = fminf(wire_length_m, (g_capacity - 1) * WIRE_MAP_BIN_SIZE_M);
+
+        bool plausible = header.bin_size_cm == (uint8_t)lroundf(WIRE_MAP_BIN_SIZE_M * 100.0f) &&
+                         header.bin_count > 0 && header.bin_count <= g_capacity &&
+                         header.encoded_size <= payload_capacity &&
+                         sizeof(header) + header.encoded_size <= g_partition->size &&
+                         fabsf(header.wire_length_m - expected_m) <= WIRE_MAP_BIN_SIZE_M;
+
+        if (plausible &&
+            esp_partition_read(g_partition, sizeof(header), payload, header.encoded_size) == ESP_OK &&
+            esp_rom_crc32_le(0, payload, header.encoded_size) == header.crc32) {
+            g_bin_count = header.bin_count;
+            size_t offset = 0;
+            bool decoded = true;
+            for (size_t field = 0; decoded && field < BIN_FIELDS; field++) {
+                size_t used = 0;
+                decoded = decode_field(field, payload + offset, header.encoded_size - offset, &used);
+                offset += used;
+            }
+            if (decoded) {
+                g_wire_length_m = header.wire_length_m;
+                g_stats.encoded_bytes = header.encoded_size;
+                count_bins();
+                g_valid.store(true, std::memory_order_release);
+                result = ESP_OK;
+            } else {
+                g_bin_count = 0;
+            }
+        }
+    }
+
+    publish_stats();
+
+    if (result == ESP_OK) {
+        ESP_LOGI(TAG, "Wire map for site '%s' loaded: %lu bins, %lu slow-zone bins",
+                 site_id, (unsigned long)g_bin_count, (unsigned long)g_stats.slow_zone_bins);
+    } else if (result == ESP_ERR_INVALID_RESPONSE) {
+        ESP_LOGW(TAG, "Stored wire map for site '%s' is corrupt or for another wire", site_id);
+    }
+    return result;
+}
+
+void wire_map_reset(void) {
+    g_valid.store(false, std::memory_order_release);
+    g_finish_pending.store(false, std::memory_order_relaxed);
+    g_dirty.store(false, std::memory_order_relaxed);
+    g_learning = false;
+    g_pass.bin = -1;
+}
+
+void wire_map_clear(void) {
+    wire_map_reset();
+    g_erase_pending.store(true, std::memory_order_release);
+}
+
+bool wire_map_is_valid(void) {
+    return g_valid.load(std::memory_order_acquire);
+}
+
+float wire_map_get_length(void) {
+    return wire_map_is_valid() ? g_wire_length_m : 0.0f;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// RECORDING API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void wire_map_begin_learning(void) {
+    if (g_bins == NULL) return;
+    g_valid.store(false, std::memory_order_release);
+    g_finish_pending.store(false, std::memory_order_relaxed);
+    g_dirty.store(false, std::memory_order_relaxed);
+    g_pass.bin = -1;
+    g_clear_watermark = 0;
+    g_bin_count = 0;
+    g_wire_length_m = 0.0f;
+    g_learning = true;
+}
+
+esp_err_t wire_map_finish_learning(float wire_length_m) {
+    if (!g_learning) return ESP_ERR_INVALID_STATE;
+    commit_pass();
+
+    esp_err_t result = ESP_OK;
+    uint32_t bins = (uint32_t)(wire_length_m / WIRE_MAP_BIN_SIZE_M + 0.5f) + 1;
+    if (bins > g_capacity) {
+        ESP_LOGW(TAG, "%.0f m wire exceeds the %lu-bin map - mapping the first %.0f m",
+                 wire_length_m, (unsigned long)g_capacity, (g_capacity - 1) * WIRE_MAP_BIN_SIZE_M);
+        bins = g_capacity;
+        wire_length_m = (g_capacity - 1) * WIRE_MAP_BIN_SIZE_M;
+        result = ESP_ERR_INVALID_SIZE;
+    }
+
+    g_bin_count = bins;
+    g_wire_length_m = wire_length_m;
+    g_learning = false;
+
+    // Normalizing touches every bin: left to housekeeping
+    g_finish_pending.store(true, std::memory_order_release);
+    return result;
+}
+
+void wire_map_record(float position_m, bool forward, float residual_duty, bool residual_valid,
+                     float impact_g) {
+    if (g_bins == NULL) return;
+    bool learning = g_learning;
+    if (!learning && !g_valid.load(std::memory_order_relaxed)) return;
+
+    // Bin i is centered on i * WIRE_MAP_BIN_SIZE_M
+    uint32_t limit = learning ? g_capacity : g_bin_count;
+    if (!(position_m >= 0.0f) || position_m / WIRE_MAP_BIN_SIZE_M + 0.5f >= (float)limit) {
+        commit_pass();
+        return;
+    }
+    int32_t bin = (int32_t)(position_m / WIRE_MAP_BIN_SIZE_M + 0.5f);
+
+    if (bin != g_pass.bin || forward != g_pass.forward) {
+        commit_pass();
+        g_pass.bin = bin;
+        g_pass.forward = forward;
+        g_pass.residual_sum = 0.0f;
+        g_pass.residual_samples = 0;
+        g_pass.impact_peak_g = 0.0f;
+    }
+
+    if (residual_valid) {
+        g_pass.residual_sum += residual_duty;
+        g_pass.residual_samples++;
+    }
+    if (impact_g > g_pass.impact_peak_g) g_pass.impact_peak_g = impact_g;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// LOOKUP API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+bool wire_map_lookup(float position_m, bool forward, wire_map_point_t* point) {
+    if (point == NULL) return false;
+    memset(point, 0, sizeof(*point));
+    point->speed_limit_ms = WIRE_MAP_NO_LIMIT_MS;
+
+    if (!g_valid.load(std::memory_order_acquire)) return false;
+    if (!(position_m >= 0.0f) || position_m > g_wire_length_m) return false;
+
+    uint32_t last = g_bin_count - 1;
+    float u = position_m / WIRE_MAP_BIN_SIZE_M;
+    uint32_t i = (uint32_t)u;
+    float t = u - (float)i;
+    if (i >= last) {
+        i = last;
+        t = 0.0f;
+    }
+    uint32_t i0 = i > 0 ? i - 1 : 0;
+    uint32_t i2 = i + 1 <= last ? i + 1 : last;
+    uint32_t i3 = i + 2 <= last ? i + 2 : last;
+    int dir = direction_index(forward);
+
+    // Catmull-Rom through the four surrounding bin centers
+    float p0 = g_bins[i0].residual[dir] * WIRE_MAP_DUTY_LSB;
+    float p1 = g_bins[i].residual[dir] * WIRE_MAP_DUTY_LSB;
+    float p2 = g_bins[i2].residual[dir] * WIRE_MAP_DUTY_LSB;
+    float p3 = g_bins[i3].residual[dir] * WIRE_MAP_DUTY_LSB;
+    point->residual_duty = 0.5f * (2.0f * p1 + (p2 - p0) * t +
+                                   (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t * t +
+                                   (3.0f * (p1 - p2) + p3 - p0) * t * t * t);
+    point->known = bin_passes(&g_bins[i], dir) > 0 || bin_passes(&g_bins[i2], dir) > 0;
+
+    // Hotspots are not smoothed away: the larger neighbour counts
+    uint8_t impact = g_bins[i].impact > g_bins[i2].impact ? g_bins[i].impact : g_bins[i2].impact;
+    point->impact_g = impact * WIRE_MAP_IMPACT_LSB_G;
+    if (point->impact_g > WIRE_MAP_HOTSPOT_G) {
+        // Impact energy grows with v²: harder hotspots get proportionally slower
+        float limit = WIRE_MAP_ZONE_SPEED_MS * sqrtf(WIRE_MAP_HOTSPOT_G / point->impact_g);
+        point->slow_zone = true;
+        point->speed_limit_ms = limit > WIRE_MAP_MIN_ZONE_SPEED_MS ? limit : WIRE_MAP_MIN_ZONE_SPEED_MS;
+    }
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STORAGE API IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t wire_map_process_flash(const char* site_id) {
+    if (!g_initialized) return ESP_ERR_INVALID_STATE;
+
+    if (g_finish_pending.load(std::memory_order_acquire)) {
+        finalize_learning();
+    }
+
+    esp_err_t result = ESP_OK;
+    switch (g_flash_state) {
+        case MAP_FLASH_IDLE:
+            if (g_partition == NULL) {
+                // RAM-only map: nothing to store or erase
+                g_erase_pending.store(false, std::memory_order_relaxed);
+                break;
+            }
+            if (g_erase_pending.exchange(false, std::memory_order_acq_rel)) {
+                // Erasing the header sector is enough to invalidate the stored map
+                result = esp_partition_erase_range(g_partition, 0, FLASH_SECTOR_SIZE);
+                if (result != ESP_OK) {
+                    g_erase_pending.store(true, std::memory_order_relaxed);
+                } else {
+                    ESP_LOGI(TAG, "Stored wire map erased");
+                }
+                break;
+            }
+            if (site_id != NULL && g_valid.load(std::memory_order_acquire) &&
+                g_dirty.exchange(false, std::memory_order_acq_rel)) {
+                stage_map(site_id);
+                if (g_staging_length > g_partition->size) {
+                    ESP_LOGE(TAG, "Encoded wire map (%lu bytes) exceeds the '%s' partition",
+                             (unsigned long)g_staging_length, WIRE_MAP_PARTITION);
+                    result = ESP_ERR_INVALID_SIZE;
+                    break;
+                }
+                g_flash_state = MAP_FLASH_ERASING;
+            }
+            break;
+
+        default:
+            result = flash_step();
+            break;
+    }
+
+    if (result != ESP_OK) g_stats.flash_errors++;
+    publish_stats();
+    return result;
+}
+
+void wire_map_get_stats(wire_map_stats_t* stats) {
+    if (stats == NULL) return;
+    *stats = g_stats_snapshot.read();
+}
@@ -2,13 +2,14 @@
 // ═══════════════════════════════════════════════════════════════════════════════
 // 
 // SINGLE RESPONSIBILITY: Application initialization and coordination
-// - System-wide component initialization  
+// - System-wide component initialization (parallel boot dependency graph)
 // - Task creation for background operations
 // - WiFi setup and web interface startup
 // - Error handling and system monitoring
 // 
 // All business logic now handled by dedicated components:
 // - hardware_control: Low-level hardware abstraction
+// - control_loop: Fixed-rate sense → mode → ESC pipeline (core 1)
 // - mode_coordinator: 3-mode system management
 // - wire_learning_mode, automatic_mode, manual_mode: Mode implementations  
 // - web_interface: Complete web UI with real-time updates
@@ -18,19 +19,34 @@
 #include <stdio.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/event_groups.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
 #include "nvs_flash.h"
 #include "driver/uart.h"
 #include "driver/i2c.h"
 
 // New modular component includes
 #include "hardware_control.h"
+#include "control_loop.h"
 #include "mode_coordinator.h"
+#include "calibration_store.h"
 #include "wire_learning_mode.h"
 #include "automatic_mode.h"
 #include "manual_mode.h"
+#include "command_queue.h"
 #include "web_interface.h"
 #include "sensor_health.h"
+#include "imu_acquisition.h"
+#include "state_estimator.h"
+#include "wire_end_detector.h"
+#include "telemetry_frame.h"
+#include "flight_recorder.h"
+#include "perf_monitor.h"
+#include "fleet_link.h"
+#include "power_manager.h"
+#include "deferred_log.h"
 #include "MPU.hpp"
 #include "pin_config.h"
 
@@ -73,47 +89,217 @@ static bool init_mpu6050(void) {
     // Configure MPU6050 settings
     mpu.setAccelFullScale(mpud::ACCEL_FS_8G);
     mpu.setGyroFullScale(mpud::GYRO_FS_500DPS);
-    mpu.setDigitalLowPassFilter(mpud::DLPF_42HZ);
-    mpu.setSampleRate(100);
+    // Sample rate, DLPF, FIFO and INT are configured by imu_acquisition_init()
     
     ESP_LOGI(TAG, "MPU6050 initialized successfully");
     return true;
 }
 
+// ═══════════════════════════════════════════════════════════════════════════════
+// BOOT DEPENDENCY GRAPH
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// Each phase runs in its own short-lived task as soon as the phases it depends
+// on are done, so WiFi/httpd, the MPU6050 probe, GPIO/LEDC setup and the NVS
+// calibration load overlap instead of queueing behind each other. Nothing here
+// sleeps: ESC power settle and arming are stepped by the control loop.
+
+#define BOOT_PHASE_TASK_STACK       4096        // Per-phase task stack
+#define BOOT_NETWORK_TASK_STACK     6144        // WiFi + httpd bring-up
+#define BOOT_PHASE_TASK_PRIORITY    5           // Above app_main, below the control loop
+#define BOOT_TIMEOUT_MS             10000       // Whole graph
+
+typedef enum {
+    BOOT_PHASE_TELEMETRY = 0,           // Telemetry record ring
+    BOOT_PHASE_NETWORK,                 // WiFi AP + web server: UI reachable
+    BOOT_PHASE_IMU_BUS,                 // I2C + MPU6050 probe
+    BOOT_PHASE_HARDWARE,                // GPIO, Hall, LEDC (ESC held at neutral)
+    BOOT_PHASE_CALIBRATION,             // Mode coordinator + stored calibration profile
+    BOOT_PHASE_IMU,                     // IMU acquisition task
+    BOOT_PHASE_ESTIMATION,              // State estimator + sensor health
+    BOOT_PHASE_MODES,                   // Mode components
+    BOOT_PHASE_RECORDER,                // Flight recorder (PSRAM history, flash scan)
+    BOOT_PHASE_FLEET,                   // ESP-NOW link to the other trolleys
+    BOOT_PHASE_COUNT
+} boot_phase_id_t;
+
+#define BOOT_BIT(phase)             (1u << (phase))
+#define BOOT_ALL_BITS               (BOOT_BIT(BOOT_PHASE_COUNT) - 1)
+
+typedef struct {
+    const char* name;
+    esp_err_t (*run)(void);
+    uint32_t depends;                   // BOOT_BIT() mask of phases that must finish first
+    bool required;                      // Failure aborts boot (restart)
+    uint32_t stack_size;
+} boot_phase_t;
+
+typedef struct {
+    uint64_t start_us;
+    uint64_t end_us;
+    esp_err_t result;
+} boot_timing_t;
+
+static EventGroupHandle_t g_boot_events = NULL;
+static boot_timing_t g_boot_timing[BOOT_PHASE_COUNT];
+
+static esp_err_t boot_telemetry(void) {
+    return telemetry_frame_init();
+}
+
+static esp_err_t boot_network(void) {
+    esp_err_t result = web_interface_init(NULL); // Use default config
+    if (result != ESP_OK) return result;
+    result = web_wifi_init_ap("ESP32S3_TROLLEY_3MODE", ""); // Open network
+    if (result != ESP_OK) return result;
+    return web_interface_start();
+}
+
+static esp_err_t boot_imu_bus(void) {
+    return init_mpu6050() ? ESP_OK : ESP_FAIL;
+}
+
+static esp_err_t boot_hardware(void) {
+    return hardware_init();
+}
+
+static esp_err_t boot_calibration(void) {
+    return mode_coordinator_init();
+}
+
+static esp_err_t boot_imu(void) {
+    // Owns the MPU6050 from here on
+    return imu_acquisition_init(&mpu);
+}
+
+static esp_err_t boot_estimation(void) {
+    esp_err_t result = state_estimator_init();
+    if (result != ESP_OK) return result;
+    result = wire_end_detector_init();
+    if (result != ESP_OK) return result;
+    return sensor_health_init();
+}
+
+static esp_err_t boot_modes(void) {
+    esp_err_t result = wire_learning_mode_init();
+    if (result != ESP_OK) return result;
+    result = automatic_mode_init();
+    if (result != ESP_OK) return result;
+    result = manual_mode_init();
+    if (result != ESP_OK) return result;
+    return command_queue_init();
+}
+
+static esp_err_t boot_recorder(void) {
+    return flight_recorder_init();
+}
+
+static esp_err_t boot_fleet(void) {
+    return fleet_link_init();
+}
+
+static const boot_phase_t BOOT_PHASES[BOOT_PHASE_COUNT] = {
+    {"telemetry",   boot_telemetry,   0,                                                  true,  BOOT_PHASE_TASK_STACK},
+    {"network",     boot_network,     BOOT_BIT(BOOT_PHASE_TELEMETRY),                     true,  BOOT_NETWORK_TASK_STACK},
+    {"imu_bus",     boot_imu_bus,     0,                                                  true,  BOOT_PHASE_TASK_STACK},
+    {"hardware",    boot_hardware,    0,                                                  true,  BOOT_PHASE_TASK_STACK},
+    {"calibration", boot_calibration, 0,                                                  true,  BOOT_PHASE_TASK_STACK},
+    // hardware_init() installs the GPIO ISR service the IMU INT pin uses
+    {"imu",         boot_imu,         BOOT_BIT(BOOT_PHASE_IMU_BUS) | BOOT_BIT(BOOT_PHASE_HARDWARE), true, BOOT_PHASE_TASK_STACK},
+    {"estimation",  boot_estimation,  BOOT_BIT(BOOT_PHASE_IMU),                           true,  BOOT_PHASE_TASK_STACK},
+    {"modes",       boot_modes,       BOOT_BIT(BOOT_PHASE_ESTIMATION),                    true,  BOOT_PHASE_TASK_STACK},
+    // Diagnostics only: the trolley runs without it
+    {"recorder",    boot_recorder,    BOOT_BIT(BOOT_PHASE_TELEMETRY),                     false, BOOT_PHASE_TASK_STACK},
+    // Needs the AP up (its channel is the fleet channel); a lone trolley runs without it
+    {"fleet",       boot_fleet,       BOOT_BIT(BOOT_PHASE_NETWORK),                       false, BOOT_PHASE_TASK_STACK},
+};
+
+static void boot_phase_task(void* pvParameter) {
+    int id = (int)(intptr_t)pvParameter;
+    const boot_phase_t* phase = &BOOT_PHASES[id];
+    
+    if (phase->depends != 0) {
+        xEventGroupWaitBits(g_boot_events, phase->depends, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+    
+    // A failed dependency skips the phase but still releases its dependents
+    bool dependencies_ok = true;
+    for (int dep = 0; dep < BOOT_PHASE_COUNT; dep++) {
+        if ((phase->depends & BOOT_BIT(dep)) && g_boot_timing[dep].result != ESP_OK) {
+            dependencies_ok = false;
+        }
+    }
+    
+    g_boot_timing[id].start_us = esp_timer_get_time();
+    esp_err_t result = dependencies_ok ? phase->run() : ESP_ERR_INVALID_STATE;
+    g_boot_timing[id].end_us = esp_timer_get_time();
+    g_boot_timing[id].result = result;
+    
+    if (result != ESP_OK) {
+        if (phase->required) {
+            ESP_LOGE(TAG, "Boot phase '%s' failed: %s", phase->name, esp_err_to_name(result));
+        } else {
+            ESP_LOGW(TAG, "Boot phase '%s' unavailable: %s", phase->name, esp_err_to_name(result));
+        }
+    }
+    
+    xEventGroupSetBits(g_boot_events, BOOT_BIT(id));
+    vTaskDelete(NULL);
+}
+
+static void log_boot_timings(void) {
+    ESP_LOGI(TAG, "Boot phases (ms since start):");
+    for (int id = 0; id < BOOT_PHASE_COUNT; id++) {
+        const boot_timing_t* t = &g_boot_timing[id];
+        if (t->end_us == 0) {
+            ESP_LOGW(TAG, "  %-12s did not finish", BOOT_PHASES[id].name);
+            continue;
+        }
+        ESP_LOGI(TAG, "  %-12s %7.1f -> %7.1f (%6.1f ms) %s", BOOT_PHASES[id].name,
+                 t->start_us / 1000.0f, t->end_us / 1000.0f, (t->end_us - t->start_us) / 1000.0f,
+                 t->result == ESP_OK ? "ok" : esp_err_to_name(t->result));
+    }
+}
+
 /**
- * @brief Initialize all system components in correct order
+ * @brief Initialize all system components along the boot dependency graph
  */
 static esp_err_t init_system_components(void) {
     ESP_LOGI(TAG, "=== INITIALIZING 3-MODE TROLLEY SYSTEM ===");
     
-    // Step 1: Initialize MPU6050 first (required by sensor_health)
-    if (!init_mpu6050()) {
-        ESP_LOGE(TAG, "MPU6050 initialization failed - system cannot proceed");
-        return ESP_FAIL;
+    g_boot_events = xEventGroupCreate();
+    if (g_boot_events == NULL) {
+        return ESP_ERR_NO_MEM;
     }
     
-    // Step 2: Initialize hardware control (ESC, Hall, GPIO)
-    ESP_LOGI(TAG, "Initializing hardware control layer...");
-    ESP_ERROR_CHECK(hardware_init());
-    
-    // Step 3: Initialize sensor health monitoring  
-    ESP_LOGI(TAG, "Initializing sensor health monitoring...");
-    ESP_ERROR_CHECK(sensor_health_init(&mpu));
-    
-    // Step 4: Initialize individual mode components
-    ESP_LOGI(TAG, "Initializing mode components...");
-    ESP_ERROR_CHECK(wire_learning_mode_init());
-    ESP_ERROR_CHECK(automatic_mode_init());
-    ESP_ERROR_CHECK(manual_mode_init());
+    for (int id = 0; id < BOOT_PHASE_COUNT; id++) {
+        g_boot_timing[id].result = ESP_ERR_INVALID_STATE;
+        if (xTaskCreate(boot_phase_task, "boot_phase", BOOT_PHASES[id].stack_size,
+                        (void*)(intptr_t)id, BOOT_PHASE_TASK_PRIORITY, NULL) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create boot task for '%s'", BOOT_PHASES[id].name);
+            xEventGroupSetBits(g_boot_events, BOOT_BIT(id));
+        }
+    }
     
-    // Step 5: Initialize mode coordinator (3-mode system management)
-    ESP_LOGI(TAG, "Initializing 3-mode coordinator...");
-    ESP_ERROR_CHECK(mode_coordinator_init());
+    EventBits_t done = xEventGroupWaitBits(g_boot_events, BOOT_ALL_BITS, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(BOOT_TIMEOUT_MS));
+    log_boot_timings();
+    if ((done & BOOT_ALL_BITS) != BOOT_ALL_BITS) {
+        // Phase tasks may still be running: keep the event group alive
+        ESP_LOGE(TAG, "Boot graph timed out after %d ms", BOOT_TIMEOUT_MS);
+        return ESP_ERR_TIMEOUT;
+    }
+    vEventGroupDelete(g_boot_events);
+    g_boot_events = NULL;
     
-    // Step 6: Initialize web interface
-    ESP_LOGI(TAG, "Initializing web interface...");
-    ESP_ERROR_CHECK(web_interface_init(NULL)); // Use default config
+    for (int id = 0; id < BOOT_PHASE_COUNT; id++) {
+        if (BOOT_PHASES[id].required && g_boot_timing[id].result != ESP_OK) {
+            return ESP_FAIL;
+        }
+    }
     
+    ESP_LOGI(TAG, "Web UI reachable %.0f ms after start",
+             g_boot_timing[BOOT_PHASE_NETWORK].end_us / 1000.0f);
     ESP_LOGI(TAG, "=== ALL COMPONENTS INITIALIZED SUCCESSFULLY ===");
     return ESP_OK;
 }
@@ -122,45 +308,142 @@ static esp_err_t init_system_components(void) {
 // BACKGROUND TASKS
 // ═══════════════════════════════════════════════════════════════════════════════
 
+#define HOUSEKEEPING_PERIOD_MS      50          // While moving
+#define HOUSEKEEPING_IDLE_PERIOD_MS 250         // Power manager idle (nothing time-critical here)
+#define MONITOR_HEARTBEAT_MS        30000       // System heartbeat log
+#define MONITOR_EVENT_HEALTH        (1u << 0)   // System health changed
+#define MONITOR_EVENT_ALLOC_FAILED  (1u << 1)   // A heap allocation failed
+#define SERIAL_LINE_TIMEOUT_MS      5000        // Wait per character of a serial command's argument
+
+// Long-lived tasks are static: stacks and TCBs are .bss, sized at link time
+#define HOUSEKEEPING_TASK_STACK     4096
+#define MONITOR_TASK_STACK          3072
+#define SERIAL_TASK_STACK           3072
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// RAM BUDGET (internal DRAM; PSRAM is on top and optional)
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// Static (.bss, a DRAM overflow fails the link instead of the heap at runtime):
+//   task stacks   control_loop 3K, housekeeping 4K, sys_monitor 3K,
+//                 serial_debug 3K, imu_acq 4K, flight_rec 3K,
+//                 web_telemetry 4K, fleet_link 4K, log_writer 4K       ~32 KB
+//   rings         telemetry 512 x 26 B, IMU samples, hall edges, LUTs,
+//                 deferred log 64 x 60 B                               ~24 KB
+// Heap, internal only (DMA, ISR or driver requirements):
+//   WiFi/lwIP/httpd (12 sockets), web_async workers,
+//   boot phase stacks (freed once boot is done)
+// Heap, PSRAM first (internal fallback on boards without PSRAM):
+//   flight recorder history + staging, wire map bins + staging, status cache
+//
+// Mode and status text is a one-byte status_text_t into a flash table, so the
+// status snapshots copied between tasks are a few hundred bytes, not KBs.
+//
+// Enforced: internal free heap after boot must leave RAM_BUDGET_RUNTIME_BYTES
+// for web bursts above the MONITOR_LOW_HEAP_BYTES floor, and the heartbeat
+// checks the lowest internal free heap seen and every stack's headroom.
+#define MONITOR_LOW_HEAP_BYTES      50000       // Internal heap floor (lowest ever seen)
+#define RAM_BUDGET_RUNTIME_BYTES    30000       // Headroom for sockets and web bursts after boot
+#define MONITOR_STACK_HEADROOM_BYTES 512        // Stack high-water mark warning
+
+static TaskHandle_t g_monitor_task = NULL;
+static StackType_t g_housekeeping_stack[HOUSEKEEPING_TASK_STACK];
+static StaticTask_t g_housekeeping_tcb;
+static StackType_t g_monitor_stack[MONITOR_TASK_STACK];
+static StaticTask_t g_monitor_tcb;
+static StackType_t g_serial_stack[SERIAL_TASK_STACK];
+static StaticTask_t g_serial_tcb;
+static volatile uint32_t g_alloc_failures = 0;
+static volatile size_t g_alloc_failed_size = 0;
+
 /**
- * @brief Main system update task - coordinates all components
+ * @brief Housekeeping task - slow, non-deterministic work
+ * 
+ * Sensing, mode steps, mode supervision and ESC output run in the control
+ * loop (control_loop.h). This task only handles flash writes, power and web maintenance.
  */
-static void system_update_task(void* pvParameter) {
+static void housekeeping_task(void* pvParameter) {
     TickType_t xLastWakeTime = xTaskGetTickCount();
+    bool was_healthy = true;
     
-    ESP_LOGI(TAG, "System update task started");
+    ESP_LOGI(TAG, "Housekeeping task started");
     
     while (1) {
-        // Update all components in correct order
-        hardware_update();                // Update hardware status
-        sensor_health_update();           // Process sensor validation
-        mode_coordinator_update();        // Update mode management
+        {
+            PERF_SCOPE(PERF_PROBE_HARDWARE_UPDATE);
+            hardware_update();            // Hardware periodic checks
+        }
+        mode_coordinator_service_flash(); // Calibration profile and wire map writes
+        web_interface_update();           // Handle web maintenance
         
-        // Update active mode components
-        wire_learning_mode_update();      // Update wire learning if active
-        automatic_mode_update();          // Update automatic mode if active  
-        manual_mode_update();             // Update manual mode if active
+        // Full clock only while moving; speed commands take the lock themselves
+        hardware_status_t hw_status = hardware_get_status();
+        bool moving = hw_status.target_speed_ms > 0.0f ||
+                      hw_status.current_speed_ms >= POWER_IDLE_SPEED_MS ||
+                      hw_status.current_esc_duty != ESC_NEUTRAL_DUTY;
+        power_manager_update(moving, hardware_esc_get_arm_state() != ESC_ARM_DISARMED);
         
-        // Update web interface
-        web_interface_update();           // Handle web maintenance
+        // The monitor sleeps until something changes
+        bool healthy = mode_coordinator_is_system_healthy();
+        if (healthy != was_healthy && g_monitor_task != NULL) {
+            xTaskNotify(g_monitor_task, MONITOR_EVENT_HEALTH, eSetBits);
+        }
+        was_healthy = healthy;
         
-        // Run every 50ms for responsive system operation
-        vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(50));
+        vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(power_manager_is_idle() ? HOUSEKEEPING_IDLE_PERIOD_MS
+                                                                                : HOUSEKEEPING_PERIOD_MS));
+    }
+}
+
+/**
+ * @brief Heap allocation failure hook (allocating task's context)
+ */
+static void heap_alloc_failed(size_t size, uint32_t caps, const char* function_name) {
+    (void)caps;
+    (void)function_name;
+    g_alloc_failures++;
+    g_alloc_failed_size = size;
+    if (g_monitor_task != NULL) {
+        xTaskNotify(g_monitor_task, MONITOR_EVENT_ALLOC_FAILED, eSetBits);
     }
 }
 
 /**
  * @brief System monitoring and health check task
+ * 
+ * Event-driven: blocks until housekeeping reports a health change, an
+ * allocation fails or the next heartbeat is due, so it never wakes the CPU
+ * on its own between heartbeats.
  */
 static void system_monitor_task(void* pvParameter) {
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    uint32_t heartbeat_counter = 0;
+    TickType_t next_heartbeat = xTaskGetTickCount() + pdMS_TO_TICKS(MONITOR_HEARTBEAT_MS);
     
     ESP_LOGI(TAG, "System monitor task started");
     
     while (1) {
-        // Log system status every 30 seconds
-        if (++heartbeat_counter % 600 == 0) { // 600 * 50ms = 30 seconds
+        TickType_t now = xTaskGetTickCount();
+        TickType_t wait = (int32_t)(next_heartbeat - now) > 0 ? next_heartbeat - now : 0;
+        uint32_t events = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &events, wait);
+        
+        if (events & MONITOR_EVENT_HEALTH) {
+            if (mode_coordinator_is_system_healthy()) {
+                ESP_LOGI(TAG, "System health restored");
+            } else {
+                ESP_LOGW(TAG, "System health issue: %s", mode_coordinator_get_error_message());
+            }
+        }
+        if (events & MONITOR_EVENT_ALLOC_FAILED) {
+            ESP_LOGW(TAG, "Allocation of %zu bytes failed (%lu total), %zu bytes free",
+                    (size_t)g_alloc_failed_size, (unsigned long)g_alloc_failures,
+                    heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+        }
+        
+        if ((int32_t)(xTaskGetTickCount() - next_heartbeat) < 0) continue;
+        next_heartbeat += pdMS_TO_TICKS(MONITOR_HEARTBEAT_MS);
+        
+        // Log system status every MONITOR_HEARTBEAT_MS
+        {
             system_mode_status_t mode_status = mode_coordinator_get_status();
             hardware_status_t hw_status = hardware_get_status();
             web_server_stats_t web_stats = web_interface_get_stats();
@@ -170,32 +453,101 @@ static void system_monitor_task(void* pvParameter) {
                     mode_coordinator_mode_to_string(mode_status.current_mode),
                     mode_status.sensors_validated ? "Validated" : "Not Validated",
                     hw_status.esc_armed ? "Armed" : "Disarmed");
-            ESP_LOGI(TAG, "Web: %lu requests, %d clients, %zu KB free", 
+            ESP_LOGI(TAG, "Web: %lu requests, %d clients, %zu KB internal free (%zu KB lowest), %zu KB PSRAM free", 
                     web_stats.total_requests, web_wifi_get_client_count(),
-                    esp_get_free_heap_size() / 1024);
+                    heap_caps_get_free_size(MALLOC_CAP_INTERNAL) / 1024,
+                    heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL) / 1024,
+                    heap_caps_get_free_size(MALLOC_CAP_SPIRAM) / 1024);
+            
+            control_loop_stats_t loop_stats = control_loop_get_stats();
+            ESP_LOGI(TAG, "Control: %lu Hz, jitter avg %.1f/max %ld us, exec avg %.1f/max %lu us, "
+                    "overruns %lu, missed %lu",
+                    loop_stats.rate_hz, loop_stats.avg_jitter_us, loop_stats.max_jitter_us,
+                    loop_stats.avg_exec_us, loop_stats.max_exec_us,
+                    loop_stats.overrun_count, loop_stats.missed_ticks);
+
+            imu_acquisition_stats_t imu_stats = imu_acquisition_get_stats();
+            ESP_LOGI(TAG, "IMU: %lu samples, %s, max burst %lu, FIFO overflows %lu, I2C errors %lu",
+                    imu_stats.samples_total, imu_stats.interrupt_driven ? "INT" : "polled",
+                    imu_stats.max_batch_samples, imu_stats.fifo_overflows, imu_stats.i2c_errors);
+
+            state_estimate_t estimate = state_estimator_get_state();
+            ESP_LOGI(TAG, "Estimate: %.3f m, %.2f m/s (±%.3f), accel bias %.3f m/s², %s",
+                    estimate.position_m, estimate.velocity_ms, estimate.velocity_sigma_ms,
+                    estimate.accel_bias_ms2, estimate.imu_fused ? "IMU fused" : "Hall only");
+            
+            power_manager_stats_t power = power_manager_get_stats();
+            ESP_LOGI(TAG, "Power: %s, %lu-%lu MHz, full clock %.1f%% of uptime, %lu motion starts, light sleep %s",
+                    !power.enabled ? "fixed clock" : power.motion_locked ? "moving" : "idle",
+                    power.min_freq_mhz, power.max_freq_mhz,
+                    power.uptime_ms ? 100.0f * power.full_clock_ms / power.uptime_ms : 100.0f,
+                    power.motion_begins,
+                    !power.light_sleep_enabled ? "off" : power.esc_locked ? "held (ESC live)" : "allowed");
+            
+            deferred_log_stats_t log_stats = deferred_log_get_stats();
+            ESP_LOGI(TAG, "Log: %s, %lu written, %lu printed, %lu dropped, %lu suppressed, depth max %lu/%d",
+                    log_stats.deferred ? "deferred" : "inline",
+                    log_stats.written, log_stats.printed, log_stats.dropped, log_stats.suppressed,
+                    log_stats.max_depth, DEFERRED_LOG_RING_SIZE);
+            
+            // Stage timings and stack marks (no-op without CONFIG_TROLLEY_PERF_MONITOR)
+            perf_monitor_log_summary();
         }
         
-        // Check system health
+        // Still unhealthy: repeat once per heartbeat, not per poll
         if (!mode_coordinator_is_system_healthy()) {
             ESP_LOGW(TAG, "System health issue: %s", mode_coordinator_get_error_message());
         }
         
-        // Monitor memory usage
-        size_t free_heap = esp_get_free_heap_size();
-        if (free_heap < 50000) { // Less than 50KB free
-            ESP_LOGW(TAG, "Low memory warning: %zu bytes free", free_heap);
+        // Monitor memory usage: internal RAM only (PSRAM would hide a shortage),
+        // lowest ever seen so a burst between heartbeats still counts
+        size_t lowest_free = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+        if (lowest_free < MONITOR_LOW_HEAP_BYTES) {
+            ESP_LOGW(TAG, "Low memory warning: internal heap fell to %zu bytes (%zu now)",
+                    lowest_free, heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
         }
         
-        // Run every 50ms
-        vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(50));
+        perf_task_stack_t stacks[PERF_MAX_TASKS];
+        size_t task_count = perf_monitor_get_task_stacks(stacks, PERF_MAX_TASKS);
+        for (size_t i = 0; i < task_count; i++) {
+            if (stacks[i].free_min_bytes < MONITOR_STACK_HEADROOM_BYTES) {
+                ESP_LOGW(TAG, "Stack headroom low: %s %lu bytes never used",
+                        stacks[i].name, (unsigned long)stacks[i].free_min_bytes);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Write telemetry records captured since the last call to the UART
+ * @param reader Serial stream cursor into the telemetry ring
+ */
+static void serial_stream_telemetry(telemetry_reader_t* reader) {
+    telemetry_frame_t frames[16];
+    uint8_t encoded[TELEMETRY_SERIAL_FRAME_SIZE * 16];
+    size_t count;
+    
+    while ((count = telemetry_reader_read(reader, frames, 16)) > 0) {
+        size_t length = 0;
+        for (size_t i = 0; i < count; i++) {
+            length += telemetry_frame_encode_serial(&frames[i], encoded + length, sizeof(encoded) - length);
+        }
+        uart_write_bytes(UART_NUM_0, encoded, length);
     }
 }
 
 /**
  * @brief Serial command interface for debugging (minimal - web is primary interface)
+ * 
+ * 'Z' toggles a binary telemetry stream (sync A5 5A + record + CRC-8, see
+ * telemetry_frame.h) on the same UART; 'Y' saves a flight recorder incident
+ * now; 'L' reads a site ID up to the end of the line and selects that site;
+ * any other key still goes to the command router.
  */
 static void serial_command_task(void* pvParameter) {
     char input_char;
+    bool streaming = false;
+    telemetry_reader_t stream_reader;
     
     ESP_LOGI(TAG, "Serial debug interface started");
     printf("\n╔══════════════════════════════════════════════════════════════╗\n");
@@ -209,19 +561,56 @@ static void serial_command_task(void* pvParameter) {
     printf("║  Safety: Sensor validation required before operation        ║\n");
     printf("║                                                              ║\n");
     printf("║  Debug Commands: T=Status, R=Reset, E=Emergency, H=Help     ║\n");
+    printf("║  Binary Telemetry: Z=Start/stop stream on this port          ║\n");
+    printf("║  Flight Recorder: Y=Save incident now (/api/incidents)       ║\n");
+    printf("║  Calibration Site: L<site id><Enter>=Select site             ║\n");
     printf("║  Full Control: Use web interface at 192.168.4.1             ║\n");
     printf("╚══════════════════════════════════════════════════════════════╝\n\n");
     
     while (1) {
-        // Read single character from UART
-        int chars_read = uart_read_bytes(UART_NUM_0, &input_char, 1, pdMS_TO_TICKS(1000));
+        // Read single character from UART (short timeout while streaming)
+        int chars_read = uart_read_bytes(UART_NUM_0, &input_char, 1,
+                                         pdMS_TO_TICKS(streaming ? 20 : 1000));
+        
+        if (streaming) {
+            serial_stream_telemetry(&stream_reader);
+        }
+        
+        if (chars_read > 0 && (input_char == 'Z' || input_char == 'z')) {
+            streaming = !streaming;
+            if (streaming) {
+                telemetry_reader_init(&stream_reader);
+            } else {
+                printf("\nTelemetry stream stopped (%lu records lost)\n", stream_reader.lost);
+            }
+            continue;
+        }
+        
+        if (chars_read > 0 && (input_char == 'Y' || input_char == 'y')) {
+            flight_recorder_trigger(FLIGHT_TRIGGER_MANUAL);
+            printf("Flight recorder incident requested\n");
+            continue;
+        }
         
         if (chars_read > 0) {
             printf("Debug Command: '%c'\n", input_char);
             
+            // 'L' takes the rest of the line as its argument
+            char line[CALIBRATION_SITE_ID_MAX + 2] = {input_char};
+            if (input_char == 'L' || input_char == 'l') {
+                size_t length = 1;
+                char next = 0;
+                while (length < sizeof(line) - 1 &&
+                       uart_read_bytes(UART_NUM_0, &next, 1, pdMS_TO_TICKS(SERIAL_LINE_TIMEOUT_MS)) > 0 &&
+                       next != '\r' && next != '\n') {
+                    line[length++] = next;
+                }
+                line[length] = '\0';
+            }
+            
             // Process minimal debug commands
             char response[256];
-            esp_err_t result = web_process_command(input_char, "debug_serial", response, sizeof(response));
+            esp_err_t result = web_submit_command_text(line, "debug_serial", response, sizeof(response), NULL);
             
             printf("Response: %s\n", response);
             if (result != ESP_OK) {
@@ -266,6 +655,18 @@ extern "C" void app_main(void) {
     ESP_ERROR_CHECK(uart_param_config(UART_NUM_0, &uart_config));
     ESP_ERROR_CHECK(uart_driver_install(UART_NUM_0, 1024, 0, 0, NULL, 0));
     
+    // Control-path log records are formatted by a low-priority task from here on
+    ret = deferred_log_init();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Deferred logging unavailable: %s (records stay queued)", esp_err_to_name(ret));
+    }
+    
+    // DFS + light sleep locks: full clock through boot, drops once idle
+    ret = power_manager_init();
+    if (ret != ESP_OK && ret != ESP_ERR_NOT_SUPPORTED) {
+        ESP_LOGW(TAG, "Power management unavailable: %s (fixed clock)", esp_err_to_name(ret));
+    }
+    
     // Initialize all system components
     if (init_system_components() != ESP_OK) {
         ESP_LOGE(TAG, "FATAL: System component initialization failed");
@@ -274,19 +675,39 @@ extern "C" void app_main(void) {
         esp_restart();
     }
     
-    // Start WiFi Access Point and web server
-    ESP_LOGI(TAG, "Starting WiFi Access Point and web server...");
-    ESP_ERROR_CHECK(web_wifi_init_ap("ESP32S3_TROLLEY_3MODE", "")); // Open network
-    ESP_ERROR_CHECK(web_interface_start());
+    // Start the deterministic control loop (core 1)
+    ESP_LOGI(TAG, "Starting control loop...");
+    ESP_ERROR_CHECK(control_loop_init(CONTROL_LOOP_DEFAULT_RATE_HZ));
+    ESP_ERROR_CHECK(control_loop_start());
+    
+    // Flight recorder drains the records the control loop captures
+    flight_recorder_start();
     
     // Create system background tasks
     ESP_LOGI(TAG, "Creating system tasks...");
-    xTaskCreatePinnedToCore(system_update_task, "sys_update", 4096, NULL, 8, NULL, 1);
-    xTaskCreatePinnedToCore(system_monitor_task, "sys_monitor", 3072, NULL, 5, NULL, 0);
-    xTaskCreatePinnedToCore(serial_command_task, "serial_debug", 3072, NULL, 3, NULL, 0);
+    xTaskCreateStaticPinnedToCore(housekeeping_task, "housekeeping", HOUSEKEEPING_TASK_STACK, NULL, 6,
+                                  g_housekeeping_stack, &g_housekeeping_tcb, 0);
+    heap_caps_register_failed_alloc_callback(heap_alloc_failed);
+    g_monitor_task = xTaskCreateStaticPinnedToCore(system_monitor_task, "sys_monitor", MONITOR_TASK_STACK, NULL, 5,
+                                                   g_monitor_stack, &g_monitor_tcb, 0);
+    xTaskCreateStaticPinnedToCore(serial_command_task, "serial_debug", SERIAL_TASK_STACK, NULL, 3,
+                                  g_serial_stack, &g_serial_tcb, 0);
     
-    // System initialization complete
+    // Every long-lived allocation is made by now: check the budget
+    size_t internal_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    if (internal_free < MONITOR_LOW_HEAP_BYTES + RAM_BUDGET_RUNTIME_BYTES) {
+        ESP_LOGE(TAG, "RAM budget exceeded: %zu bytes internal free after boot, %d needed",
+                internal_free, MONITOR_LOW_HEAP_BYTES + RAM_BUDGET_RUNTIME_BYTES);
+    } else {
+        ESP_LOGI(TAG, "RAM budget: %zu KB internal free after boot (largest block %zu KB), %zu KB PSRAM free",
+                internal_free / 1024, heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL) / 1024,
+                heap_caps_get_free_size(MALLOC_CAP_SPIRAM) / 1024);
+    }
+    
+    // System initialization complete: the web UI now accepts commands
     system_ready = true;
+    web_set_commands_ready(true);
+    ESP_LOGI(TAG, "Control path ready %.0f ms after start", esp_timer_get_time() / 1000.0f);
     
     ESP_LOGI(TAG, "╔══════════════════════════════════════════════════════════════╗");
     ESP_LOGI(TAG, "║                SYSTEM READY FOR OPERATION                   ║");
@@ -319,8 +740,11 @@ extern "C" void app_main(void) {
             if (!system_ready || !mode_coordinator_is_system_healthy()) {
                 ESP_LOGE(TAG, "System health check failed - attempting recovery");
                 
-                // Attempt graceful recovery
-                mode_coordinator_emergency_stop();
+                // Attempt graceful recovery (the stop runs on the control loop)
+                if (command_queue_submit_emergency_stop("health_check", NULL) != ESP_OK) {
+                    hardware_emergency_stop();
+                }
+                vTaskDelay(pdMS_TO_TICKS(100));
                 
                 // If recovery fails, restart system
                 if (!mode_coordinator_is_system_healthy()) {
@@ -333,8 +757,9 @@ extern "C" void app_main(void) {
         
         // Log periodic status for long-term monitoring
         if (health_check_counter % 180 == 0) { // 180 * 10s = 30 minutes
-            ESP_LOGI(TAG, "Long-term status: Uptime %lu minutes, Free heap: %zu KB", 
-                    (esp_timer_get_time() / 1000000) / 60, esp_get_free_heap_size() / 1024);
+            ESP_LOGI(TAG, "Long-term status: Uptime %lu minutes, Free heap: %zu KB internal (%zu KB lowest)", 
+                    (esp_timer_get_time() / 1000000) / 60, heap_caps_get_free_size(MALLOC_CAP_INTERNAL) / 1024,
+                    heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL) / 1024);
         }
     }
 }
\ No newline at end of file
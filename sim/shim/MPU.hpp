@@ -0,0 +1,8 @@
+// sim/shim/MPU.hpp - imu_acquisition.h only needs the type name on the host
+#ifndef SIM_MPU_HPP
+#define SIM_MPU_HPP
+
+class MPU;
+typedef MPU MPU_t;
+
+#endif // SIM_MPU_HPP
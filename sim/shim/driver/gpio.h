@@ -0,0 +1,7 @@
+// sim/shim/driver/gpio.h - pin numbers only (pin_config.h)
+#ifndef SIM_DRIVER_GPIO_H
+#define SIM_DRIVER_GPIO_H
+
+typedef int gpio_num_t;
+
+#endif // SIM_DRIVER_GPIO_H
@@ -0,0 +1,7 @@
+// sim/shim/driver/i2c.h - I2C port constant referenced by pin_config.h
+#ifndef SIM_DRIVER_I2C_H
+#define SIM_DRIVER_I2C_H
+
+typedef enum { I2C_NUM_0 = 0 } i2c_port_t;
+
+#endif // SIM_DRIVER_I2C_H
@@ -0,0 +1,9 @@
+// sim/shim/driver/ledc.h - LEDC constants referenced by pin_config.h
+#ifndef SIM_DRIVER_LEDC_H
+#define SIM_DRIVER_LEDC_H
+
+typedef enum { LEDC_TIMER_0 = 0 } ledc_timer_t;
+typedef enum { LEDC_CHANNEL_0 = 0 } ledc_channel_t;
+typedef enum { LEDC_TIMER_14_BIT = 14 } ledc_timer_bit_t;
+
+#endif // SIM_DRIVER_LEDC_H
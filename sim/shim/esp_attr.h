@@ -0,0 +1,9 @@
+// sim/shim/esp_attr.h - placement attributes are no-ops on the host
+#ifndef SIM_ESP_ATTR_H
+#define SIM_ESP_ATTR_H
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define EXT_RAM_BSS_ATTR
+
+#endif // SIM_ESP_ATTR_H
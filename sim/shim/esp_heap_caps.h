@@ -0,0 +1,20 @@
+// sim/shim/esp_heap_caps.h - capability allocations are plain malloc on the host
+#ifndef SIM_ESP_HEAP_CAPS_H
+#define SIM_ESP_HEAP_CAPS_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_8BIT             (1u << 2)
+#define MALLOC_CAP_SPIRAM           (1u << 10)
+
+static inline void* heap_caps_malloc(size_t size, uint32_t caps) {
+    (void)caps;
+    return malloc(size);
+}
+
+static inline void heap_caps_free(void* ptr) {
+    free(ptr);
+}
+
+#endif // SIM_ESP_HEAP_CAPS_H
@@ -0,0 +1,9 @@
+// sim/shim/esp_rom_crc.h - ROM CRC32 (little-endian, same convention as the target ROM)
+#ifndef SIM_ESP_ROM_CRC_H
+#define SIM_ESP_ROM_CRC_H
+
+#include <stdint.h>
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len);
+
+#endif // SIM_ESP_ROM_CRC_H
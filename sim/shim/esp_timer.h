@@ -0,0 +1,9 @@
+// sim/shim/esp_timer.h - esp_timer_get_time() reads the simulation clock
+#ifndef SIM_ESP_TIMER_H
+#define SIM_ESP_TIMER_H
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
+
+#endif // SIM_ESP_TIMER_H
@@ -0,0 +1,14 @@
+// sim/shim/freertos/FreeRTOS.h - the simulation is single-threaded
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+
+#define pdPASS                      1
+#define pdFAIL                      0
+#define pdMS_TO_TICKS(ms)           ((TickType_t)(ms))
+
+#endif // SIM_FREERTOS_H
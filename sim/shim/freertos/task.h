@@ -0,0 +1,9 @@
+// sim/shim/freertos/task.h - no tasks: the simulation steps every stage itself
+#ifndef SIM_FREERTOS_TASK_H
+#define SIM_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+
+#endif // SIM_FREERTOS_TASK_H
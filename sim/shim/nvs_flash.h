@@ -0,0 +1,11 @@
+// sim/shim/nvs_flash.h - the in-memory NVS needs no flash init
+#ifndef SIM_NVS_FLASH_H
+#define SIM_NVS_FLASH_H
+
+#include "esp_err.h"
+
+static inline esp_err_t nvs_flash_init(void) {
+    return ESP_OK;
+}
+
+#endif // SIM_NVS_FLASH_H
@@ -0,0 +1,113 @@
+// sim/src/sensor_trace.cpp
+#include "sensor_trace.h"
+#include "hardware_control.h"
+#include "imu_acquisition.h"
+#include <cstring>
+
+static esp_err_t write_record(sensor_trace_t* trace, const sensor_trace_record_t* record) {
+    if (trace == NULL || trace->file == NULL) return ESP_ERR_INVALID_STATE;
+    if (fwrite(record, sizeof(*record), 1, trace->file) != 1) return ESP_FAIL;
+    trace->records++;
+    return ESP_OK;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// WRITER
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t sensor_trace_create(sensor_trace_t* trace, const char* path, const char* source) {
+    memset(trace, 0, sizeof(*trace));
+    trace->file = fopen(path, "wb");
+    if (trace->file == NULL) return ESP_FAIL;
+
+    trace->header.magic = SENSOR_TRACE_MAGIC;
+    trace->header.version = SENSOR_TRACE_VERSION;
+    trace->header.record_size = sizeof(sensor_trace_record_t);
+    trace->header.hall_magnets_per_rev = HALL_MAGNETS_PER_REV;
+    trace->header.imu_sample_rate_hz = IMU_SAMPLE_RATE_HZ;
+    if (source != NULL) {
+        strncpy(trace->header.source, source, sizeof(trace->header.source) - 1);
+    }
+
+    if (fwrite(&trace->header, sizeof(trace->header), 1, trace->file) != 1) {
+        sensor_trace_close(trace);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+void sensor_trace_write_hall_edge(sensor_trace_t* trace, int64_t timestamp_us) {
+    sensor_trace_record_t record = {};
+    record.timestamp_us = (uint64_t)timestamp_us;
+    record.type = TRACE_RECORD_HALL_EDGE;
+    write_record(trace, &record);
+}
+
+void sensor_trace_write_imu_sample(sensor_trace_t* trace, int64_t timestamp_us,
+                                   int16_t x_raw, int16_t y_raw, int16_t z_raw) {
+    sensor_trace_record_t record = {};
+    record.timestamp_us = (uint64_t)timestamp_us;
+    record.type = TRACE_RECORD_IMU_SAMPLE;
+    record.accel[0] = x_raw;
+    record.accel[1] = y_raw;
+    record.accel[2] = z_raw;
+    write_record(trace, &record);
+}
+
+void sensor_trace_write_command(sensor_trace_t* trace, int64_t timestamp_us,
+                                trace_command_t command, int32_t argument) {
+    sensor_trace_record_t record = {};
+    record.timestamp_us = (uint64_t)timestamp_us;
+    record.type = TRACE_RECORD_COMMAND;
+    record.command = (uint8_t)command;
+    record.argument = argument;
+    write_record(trace, &record);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// READER
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t sensor_trace_open(sensor_trace_t* trace, const char* path) {
+    memset(trace, 0, sizeof(*trace));
+    trace->file = fopen(path, "rb");
+    if (trace->file == NULL) return ESP_ERR_NOT_FOUND;
+
+    if (fread(&trace->header, sizeof(trace->header), 1, trace->file) != 1 ||
+        trace->header.magic != SENSOR_TRACE_MAGIC ||
+        trace->header.version != SENSOR_TRACE_VERSION ||
+        trace->header.record_size != sizeof(sensor_trace_record_t)) {
+        sensor_trace_close(trace);
+        return ESP_ERR_INVALID_VERSION;
+    }
+    return ESP_OK;
+}
+
+bool sensor_trace_read(sensor_trace_t* trace, sensor_trace_record_t* record) {
+    if (trace == NULL || trace->file == NULL) return false;
+    if (fread(record, sizeof(*record), 1, trace->file) != 1) return false;
+    trace->records++;
+    return true;
+}
+
+void sensor_trace_close(sensor_trace_t* trace) {
+    if (trace != NULL && trace->file != NULL) {
+        fclose(trace->file);
+        trace->file = NULL;
+    }
+}
+
+const char* sensor_trace_command_to_string(trace_command_t command) {
+    switch (command) {
+        case TRACE_CMD_START_SENSOR_VALIDATION: return "start_sensor_validation";
+        case TRACE_CMD_CONFIRM_HALL:            return "confirm_hall";
+        case TRACE_CMD_CONFIRM_ACCEL:           return "confirm_accel";
+        case TRACE_CMD_ACTIVATE_WIRE_LEARNING:  return "activate_wire_learning";
+        case TRACE_CMD_ACTIVATE_AUTOMATIC:      return "activate_automatic";
+        case TRACE_CMD_ACTIVATE_MANUAL:         return "activate_manual";
+        case TRACE_CMD_STOP:                    return "stop";
+        case TRACE_CMD_EMERGENCY_STOP:          return "emergency_stop";
+        case TRACE_CMD_SET_WIRE_LENGTH:         return "set_wire_length";
+        default:                                return "unknown";
+    }
+}
@@ -0,0 +1,118 @@
+// sim/src/sensor_trace.h
+#ifndef SENSOR_TRACE_H
+#define SENSOR_TRACE_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SENSOR_TRACE.H - RAW SENSOR + COMMAND TRACE FILES
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Everything that enters the control stack from
+// outside, in arrival order, with the time it arrived
+// - Hall edges (what the PCNT/ISR backend timestamps)
+// - IMU samples as raw counts (what the FIFO task pushes into the ring)
+// - User/web commands (what the coordinator API receives)
+//
+// Outputs (ESC duty, mode decisions) are NOT recorded: replaying the inputs
+// through a build is how those are reproduced. The flight recorder's
+// telemetry_frame_t incidents hold estimator outputs at 250 Hz, so they
+// cannot be fed back below hardware_control.h; this format is what a raw
+// recorder writes, and the simulation writes it today (sim_bench --record).
+//
+// File: sensor_trace_header_t, then sensor_trace_record_t until EOF
+// (little-endian, packed, the struct is stored as is)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define SENSOR_TRACE_MAGIC              0x43525454  // "TTRC"
+#define SENSOR_TRACE_VERSION            1
+
+typedef enum {
+    TRACE_RECORD_HALL_EDGE = 1,         // timestamp_us only
+    TRACE_RECORD_IMU_SAMPLE,            // accel[] raw counts (IMU_ACCEL_LSB_PER_G)
+    TRACE_RECORD_COMMAND                // command + argument
+} sensor_trace_record_type_t;
+
+// Coordinator entry points a trace can drive
+typedef enum {
+    TRACE_CMD_START_SENSOR_VALIDATION = 1,
+    TRACE_CMD_CONFIRM_HALL,
+    TRACE_CMD_CONFIRM_ACCEL,
+    TRACE_CMD_ACTIVATE_WIRE_LEARNING,
+    TRACE_CMD_ACTIVATE_AUTOMATIC,
+    TRACE_CMD_ACTIVATE_MANUAL,
+    TRACE_CMD_STOP,                     // argument: 1 = immediate
+    TRACE_CMD_EMERGENCY_STOP,
+    TRACE_CMD_SET_WIRE_LENGTH           // argument: mm; a completed learning result
+} trace_command_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;                    // SENSOR_TRACE_MAGIC
+    uint8_t version;                   // SENSOR_TRACE_VERSION
+    uint8_t record_size;               // sizeof(sensor_trace_record_t)
+    uint16_t hall_magnets_per_rev;     // Recording unit's HALL_MAGNETS_PER_REV
+    uint32_t imu_sample_rate_hz;       // Recording unit's IMU_SAMPLE_RATE_HZ
+    char source[20];                   // Free text (scenario name, site id)
+} sensor_trace_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint64_t timestamp_us;
+    uint8_t type;                      // sensor_trace_record_type_t
+    uint8_t command;                   // trace_command_t (TRACE_RECORD_COMMAND)
+    int16_t accel[3];                  // x, y, z raw counts (TRACE_RECORD_IMU_SAMPLE)
+    int32_t argument;                  // Command argument
+} sensor_trace_record_t;
+
+typedef struct {
+    FILE* file;
+    sensor_trace_header_t header;
+    uint32_t records;                  // Records written or read so far
+} sensor_trace_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// WRITER
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Create a trace file and write its header
+ * @param trace Output handle
+ * @param path File path
+ * @param source Free text stored in the header (may be NULL)
+ * @return ESP_OK, ESP_FAIL if the file cannot be created
+ */
+esp_err_t sensor_trace_create(sensor_trace_t* trace, const char* path, const char* source);
+
+void sensor_trace_write_hall_edge(sensor_trace_t* trace, int64_t timestamp_us);
+void sensor_trace_write_imu_sample(sensor_trace_t* trace, int64_t timestamp_us,
+                                   int16_t x_raw, int16_t y_raw, int16_t z_raw);
+void sensor_trace_write_command(sensor_trace_t* trace, int64_t timestamp_us,
+                                trace_command_t command, int32_t argument);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// READER
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Open a trace file and check its header
+ * @param trace Output handle
+ * @param path File path
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if missing, ESP_ERR_INVALID_VERSION on an
+ *         unknown magic/version/record size
+ */
+esp_err_t sensor_trace_open(sensor_trace_t* trace, const char* path);
+
+/**
+ * @brief Read the next record
+ * @param trace Handle from sensor_trace_open()
+ * @param record Output record
+ * @return true if a record was read, false at end of file
+ */
+bool sensor_trace_read(sensor_trace_t* trace, sensor_trace_record_t* record);
+
+void sensor_trace_close(sensor_trace_t* trace);
+
+const char* sensor_trace_command_to_string(trace_command_t command);
+
+#endif // SENSOR_TRACE_H
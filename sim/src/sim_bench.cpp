@@ -0,0 +1,274 @@
+// sim/src/sim_bench.cpp
+#include "sim_platform.h"
+#include "sim_hardware.h"
+#include "sim_unit.h"
+#include "sim_decisions.h"
+#include "sensor_trace.h"
+#include "trolley_physics.h"
+#include "mode_coordinator.h"
+#include "wire_learning_mode.h"
+#include "automatic_mode.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SIM_BENCH.CPP - MODE LOGIC AGAINST THE TROLLEY MODEL, SCENARIO BY SCENARIO
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// Each scenario boots a factory-fresh unit (own process, so no component
+// static survives into the next one), validates the sensors the way a user
+// would, learns the wire, then runs automatic mode for --hours of simulated
+// time (sim_unit.h runs the pipeline exactly as control_loop.cpp does).
+//
+// Reported per scenario:
+// - cycles/hour and end-of-wire overshoot (model penetration of the stops)
+// - max impact speed and overshoot of the automatic runs, failed against the
+//   scenario's limits (learning hits the stops on purpose and is not counted)
+// - host CPU cost of every *_update() stage: mean / p99 / max in ns. Host
+//   numbers only rank changes against each other; they are not target timings
+//
+// --record DIR also writes DIR/<scenario>.trc (every input and command) and
+// DIR/<scenario>.decisions; sim_replay on that trace with the same build
+// must reproduce the decisions file exactly.
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define BENCH_VALIDATION_TIMEOUT_S  120
+#define BENCH_LEARNING_TIMEOUT_S    1800
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SCENARIOS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Model plus the pass limits of its automatic runs: a seek arrives at
+// AUTO_MODE_WIRE_END_APPROACH_MS, so every wire end contact must stay near it
+typedef struct {
+    trolley_physics_config_t model;
+    float max_impact_speed_ms;         // Fastest allowed wire end contact
+    float max_overshoot_m;             // Deepest allowed end stop penetration
+} bench_scenario_t;
+
+static const bench_scenario_t k_scenarios[] = {
+    //  name           length start  coast_a coast_b grade  tau  accel gain  stiff   zeta  mass vib   seed   impact overshoot
+    { { "short_hard",   12.0f, 1.0f,  0.25f,  0.010f, 0.0f,  0.25f, 3.0f, 1.00f, 2.0e5f, 0.2f, 2.5f, 0.03f, 1 }, 1.20f, 0.005f },
+    { { "long_hard",    80.0f, 1.0f,  0.25f,  0.010f, 0.0f,  0.25f, 3.0f, 1.00f, 2.0e5f, 0.2f, 2.5f, 0.03f, 2 }, 1.20f, 0.005f },
+    { { "soft_buffers", 25.0f, 1.0f,  0.25f,  0.010f, 0.0f,  0.25f, 3.0f, 1.00f, 4.0e3f, 0.5f, 2.5f, 0.03f, 3 }, 1.20f, 0.025f },
+    { { "graded",       30.0f, 1.0f,  0.25f,  0.010f, 2.0f,  0.25f, 3.0f, 1.00f, 2.0e5f, 0.2f, 2.5f, 0.03f, 4 }, 1.30f, 0.005f },
+    { { "weak_esc",     25.0f, 1.0f,  0.25f,  0.010f, 0.0f,  0.25f, 3.0f, 0.85f, 2.0e5f, 0.2f, 2.5f, 0.03f, 5 }, 1.20f, 0.005f },
+};
+#define BENCH_SCENARIO_COUNT (sizeof(k_scenarios) / sizeof(k_scenarios[0]))
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SIMULATED UNIT ON THE MODEL
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Input source: the model moves under the drive the unit commanded last tick
+static void physics_source(int64_t until_us) {
+    trolley_drive_t drive = sim_hardware_get_drive();
+    trolley_physics_advance(until_us, &drive);
+}
+
+static bool hall_pending(void) {
+    return mode_coordinator_get_status().sensor_validation_state == SENSOR_VALIDATION_HALL_PENDING;
+}
+
+static bool accel_pending(void) {
+    return mode_coordinator_get_status().sensor_validation_state == SENSOR_VALIDATION_ACCEL_PENDING;
+}
+
+static bool sensors_validated(void) {
+    return mode_coordinator_get_status().sensors_validated;
+}
+
+static bool learning_finished(void) {
+    wire_learning_state_t state = wire_learning_mode_get_state();
+    return state == WIRE_LEARNING_COMPLETE || state == WIRE_LEARNING_FAILED;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SCENARIO RUN
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// The user's part of sensor validation: spin the wheel, then shake the trolley
+static bool validate_sensors(void) {
+    const int64_t timeout = (int64_t)BENCH_VALIDATION_TIMEOUT_S * 1000000;
+
+    if (sim_unit_command(TRACE_CMD_START_SENSOR_VALIDATION, 0) != ESP_OK) return false;
+    trolley_physics_nudge(0.5f);
+    if (!sim_unit_run_until(hall_pending, timeout)) return false;
+    sim_unit_command(TRACE_CMD_CONFIRM_HALL, 0);
+
+    trolley_physics_shake(1.5f, 1000);
+    if (!sim_unit_run_until(accel_pending, timeout)) return false;
+    sim_unit_command(TRACE_CMD_CONFIRM_ACCEL, 0);
+
+    return sim_unit_run_until(sensors_validated, timeout);
+}
+
+static int run_scenario_steps(const bench_scenario_t* bench, float hours) {
+    const trolley_physics_config_t* scenario = &bench->model;
+    if (!validate_sensors()) {
+        printf("%-14s FAILED sensor validation: %s\n", scenario->name,
+               mode_coordinator_get_sensor_validation_message());
+        return 1;
+    }
+
+    // A learning failure fails the scenario but does not end it: the report
+    // says why, and automatic mode runs on the model's true wire length
+    int64_t learn_start_us = sim_unit_now_us();
+    bool learned = sim_unit_command(TRACE_CMD_ACTIVATE_WIRE_LEARNING, 0) == ESP_OK &&
+                   sim_unit_run_until(learning_finished, (int64_t)BENCH_LEARNING_TIMEOUT_S * 1000000) &&
+                   wire_learning_mode_is_complete();
+    float learn_s = (float)(sim_unit_now_us() - learn_start_us) / 1e6f;
+    if (!learned) {
+        printf("%-14s wire learning failed after %.1f s: %s\n", scenario->name, learn_s,
+               wire_learning_get_error_message());
+        sim_unit_command(TRACE_CMD_STOP, 1);
+        sim_unit_command(TRACE_CMD_SET_WIRE_LENGTH, (int32_t)(scenario->wire_length_m * 1000.0f));
+    }
+
+    // Let the coordinator pick up the learned profile before starting
+    sim_unit_run_until(NULL, 500000);
+    if (sim_unit_command(TRACE_CMD_ACTIVATE_AUTOMATIC, 0) != ESP_OK) {
+        printf("%-14s FAILED automatic start: %s\n", scenario->name, mode_coordinator_get_error_message());
+        return 1;
+    }
+
+    // Overshoot during automatic runs only (learning hits the stops on purpose)
+    trolley_physics_reset_peaks();
+    trolley_physics_stats_t before = trolley_physics_get_stats();
+    sim_unit_reset_stage_stats();
+    uint32_t incidents_before = sim_flight_recorder_trigger_count();
+
+    sim_unit_run_until(NULL, (int64_t)(hours * 3600.0f * 1e6f));
+
+    trolley_physics_stats_t after = trolley_physics_get_stats();
+    automatic_mode_results_t results = automatic_mode_get_results();
+    uint32_t cycles = results.total_cycles_completed;
+    uint32_t contacts = after.end_contacts - before.end_contacts;
+
+    printf("%-14s learn %6.1f s%s  cycles/h %7.1f  runs %6u  end contacts %5u  max impact %.2f m/s  "
+           "max overshoot %6.1f mm  incidents %u\n",
+           scenario->name, learn_s, learned ? "" : " (seeded)", (float)cycles / hours,
+           results.total_runs_completed, contacts,
+           contacts > 0 ? after.max_impact_speed_ms : 0.0f,
+           contacts > 0 ? after.max_overshoot_m * 1000.0f : 0.0f,
+           sim_flight_recorder_trigger_count() - incidents_before);
+    sim_unit_print_stage_table(stdout);
+
+    // A bench that measures nothing is a failure, not a zero
+    if (cycles == 0) {
+        printf("%-14s FAILED: no cycle completed (%s)\n", scenario->name,
+               automatic_mode_state_to_string(automatic_mode_get_state()));
+        return 1;
+    }
+    if (contacts > 0 && after.max_impact_speed_ms > bench->max_impact_speed_ms) {
+        printf("%-14s FAILED: impact %.2f m/s above the %.2f m/s limit\n", scenario->name,
+               after.max_impact_speed_ms, bench->max_impact_speed_ms);
+        return 1;
+    }
+    if (contacts > 0 && after.max_overshoot_m > bench->max_overshoot_m) {
+        printf("%-14s FAILED: overshoot %.1f mm above the %.1f mm limit\n", scenario->name,
+               after.max_overshoot_m * 1000.0f, bench->max_overshoot_m * 1000.0f);
+        return 1;
+    }
+    return learned ? 0 : 1;
+}
+
+static int run_scenario(const bench_scenario_t* bench, float hours, const char* record_dir) {
+    const trolley_physics_config_t* scenario = &bench->model;
+    trolley_physics_init(scenario);
+    trolley_physics_set_sinks(sim_unit_hall_edge, sim_unit_imu_sample_g);
+    sim_unit_boot(physics_source);
+
+    sensor_trace_t trace = {};
+    FILE* decisions = NULL;
+    if (record_dir != NULL) {
+        std::string base = std::string(record_dir) + "/" + scenario->name;
+        if (sensor_trace_create(&trace, (base + ".trc").c_str(), scenario->name) != ESP_OK ||
+            (decisions = fopen((base + ".decisions").c_str(), "w")) == NULL) {
+            printf("%-14s cannot record to %s\n", scenario->name, record_dir);
+            return 1;
+        }
+        sim_unit_record_to(&trace);
+        sim_decisions_begin(decisions);
+    }
+
+    int result = run_scenario_steps(bench, hours);
+
+    if (record_dir != NULL) {
+        sim_unit_record_to(NULL);
+        sim_decisions_begin(NULL);
+        sensor_trace_close(&trace);
+        fclose(decisions);
+    }
+    return result;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MAIN
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void usage(const char* program) {
+    fprintf(stderr, "usage: %s [--hours H] [--scenario NAME] [--record DIR] [--verbose]\n  scenarios:", program);
+    for (size_t i = 0; i < BENCH_SCENARIO_COUNT; i++) fprintf(stderr, " %s", k_scenarios[i].model.name);
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char** argv) {
+    float hours = 1.0f;
+    const char* only = NULL;
+    const char* record_dir = NULL;
+
+    // Mode logic warns every tick in some failure states; keep the report readable
+    sim_log_set_level(ESP_LOG_ERROR);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--hours") == 0 && i + 1 < argc) {
+            hours = strtof(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+            only = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_dir = argv[++i];
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            sim_log_set_level(ESP_LOG_INFO);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (hours <= 0.0f) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    int failures = 0;
+    int ran = 0;
+    for (size_t i = 0; i < BENCH_SCENARIO_COUNT; i++) {
+        if (only != NULL && strcmp(only, k_scenarios[i].model.name) != 0) continue;
+        ran++;
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            return 1;
+        }
+        if (pid == 0) {
+            int result = run_scenario(&k_scenarios[i], hours, record_dir);
+            fflush(stdout);
+            _exit(result);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failures++;
+    }
+
+    if (ran == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    return failures == 0 ? 0 : 1;
+}
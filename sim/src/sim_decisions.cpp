@@ -0,0 +1,220 @@
+// sim/src/sim_decisions.cpp
+#include "sim_decisions.h"
+#include "sim_platform.h"
+#include "mode_coordinator.h"
+#include "wire_learning_mode.h"
+#include "automatic_mode.h"
+#include "manual_mode.h"
+#include "wire_end_detector.h"
+#include "sensor_health.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#define DECISIONS_IMPACT_GAP_US     200000      // Quiet time that ends an impact episode
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// LOGGING
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static FILE* g_out = nullptr;
+
+// Last logged value per state channel (-1 = nothing logged yet)
+static int g_last_mode = -1;
+static int g_last_validation = -1;
+static int g_last_learning = -1;
+static int g_last_automatic = -1;
+static int g_last_manual = -1;
+static uint32_t g_last_wire_end_events = 0;
+static uint64_t g_last_impact_time = 0;
+static uint32_t g_last_incidents = 0;
+
+static void log_line(int64_t time_us, const char* channel, const char* key, const char* detail) {
+    fprintf(g_out, "%" PRId64 "\t%s\t%s\t%s\n", time_us, channel, key, detail ? detail : "");
+}
+
+static void log_state(int64_t now_us, const char* channel, int* last, int value, const char* name) {
+    if (value == *last) return;
+    *last = value;
+    log_line(now_us, channel, name, NULL);
+}
+
+void sim_decisions_begin(FILE* out) {
+    g_out = out;
+    g_last_mode = -1;
+    g_last_validation = -1;
+    g_last_learning = -1;
+    g_last_automatic = -1;
+    g_last_manual = -1;
+    g_last_wire_end_events = 0;
+    g_last_impact_time = 0;
+    g_last_incidents = 0;
+}
+
+void sim_decisions_sample(int64_t now_us) {
+    if (g_out == nullptr) return;
+
+    trolley_operation_mode_t mode = mode_coordinator_get_current_mode();
+    log_state(now_us, "mode", &g_last_mode, (int)mode, mode_coordinator_mode_to_string(mode));
+
+    sensor_validation_state_t validation = mode_coordinator_get_status().sensor_validation_state;
+    log_state(now_us, "validation", &g_last_validation, (int)validation,
+              mode_coordinator_validation_to_string(validation));
+
+    wire_learning_state_t learning = wire_learning_mode_get_state();
+    log_state(now_us, "learning", &g_last_learning, (int)learning, wire_learning_state_to_string(learning));
+
+    automatic_mode_state_t automatic = automatic_mode_get_state();
+    log_state(now_us, "automatic", &g_last_automatic, (int)automatic, automatic_mode_state_to_string(automatic));
+
+    manual_mode_state_t manual = manual_mode_get_state();
+    log_state(now_us, "manual", &g_last_manual, (int)manual, manual_mode_state_to_string(manual));
+
+    char detail[96];
+    wire_end_detector_stats_t detector = wire_end_detector_get_stats();
+    if (detector.events != g_last_wire_end_events) {
+        g_last_wire_end_events = detector.events;
+        const wire_end_event_t* event = &detector.last_event;
+        snprintf(detail, sizeof(detail), "confidence=%.2f position=%.3f peak=%.2fg latency=%ums",
+                 event->confidence, event->position_m, event->peak_impact_g, (unsigned)event->latency_ms);
+        log_line((int64_t)event->timestamp_us, "wire_end", wire_end_detector_source_to_string(event->sources), detail);
+    }
+
+    // Sensor health refreshes last_impact_time on every sample over threshold
+    // (total magnitude, so gravity alone qualifies): log episode onsets only
+    sensor_health_t health = sensor_health_get_status();
+    if (health.last_impact_time != g_last_impact_time) {
+        bool onset = g_last_impact_time == 0 ||
+                     health.last_impact_time - g_last_impact_time > DECISIONS_IMPACT_GAP_US;
+        g_last_impact_time = health.last_impact_time;
+        if (onset) {
+            snprintf(detail, sizeof(detail), "%.2fg", health.last_impact_g);
+            log_line((int64_t)health.last_impact_time, "impact", "onset", detail);
+        }
+    }
+
+    uint32_t incidents = sim_flight_recorder_trigger_count();
+    if (incidents != g_last_incidents) {
+        g_last_incidents = incidents;
+        snprintf(detail, sizeof(detail), "total=%u", (unsigned)incidents);
+        log_line(now_us, "incident", "trigger", detail);
+    }
+}
+
+void sim_decisions_command(int64_t now_us, trace_command_t command, int32_t argument, esp_err_t result) {
+    if (g_out == nullptr) return;
+    char key[64];
+    char detail[32];
+    snprintf(key, sizeof(key), "%s=%s", sensor_trace_command_to_string(command), esp_err_to_name(result));
+    snprintf(detail, sizeof(detail), "argument=%" PRId32, argument);
+    log_line(now_us, "command", key, detail);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// COMPARISON
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    int64_t time_us;
+    std::string key;
+    std::string detail;
+} decision_t;
+
+typedef std::map<std::string, std::vector<decision_t>> decision_log_t;
+
+static bool load_log(const char* path, decision_log_t* log) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) return false;
+
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        char* fields[4] = {line, NULL, NULL, NULL};
+        for (int i = 1; i < 4; i++) {
+            char* tab = fields[i - 1] ? strchr(fields[i - 1], '\t') : NULL;
+            if (tab == NULL) break;
+            *tab = '\0';
+            fields[i] = tab + 1;
+        }
+        if (fields[2] == NULL) continue;
+        decision_t decision = {strtoll(fields[0], NULL, 10), fields[2], fields[3] ? fields[3] : ""};
+        (*log)[fields[1]].push_back(decision);
+    }
+    fclose(file);
+    return true;
+}
+
+int sim_decisions_compare(const char* path_a, const char* path_b, int64_t tolerance_us, FILE* report) {
+    decision_log_t a;
+    decision_log_t b;
+    if (!load_log(path_a, &a) || !load_log(path_b, &b)) {
+        fprintf(report, "cannot read %s or %s\n", path_a, path_b);
+        return 2;
+    }
+
+    std::vector<std::string> channels;
+    for (const auto& entry : a) channels.push_back(entry.first);
+    for (const auto& entry : b) {
+        if (a.find(entry.first) == a.end()) channels.push_back(entry.first);
+    }
+
+    bool diverged = false;
+    int64_t first_divergence_us = INT64_MAX;
+    std::string first_divergence;
+
+    fprintf(report, "%-11s %7s %7s %8s %12s %12s  %s\n",
+            "channel", "A", "B", "matched", "max |dt| ms", "mean dt ms", "first divergence");
+    for (const std::string& channel : channels) {
+        const std::vector<decision_t>& da = a[channel];
+        const std::vector<decision_t>& db = b[channel];
+        size_t common = std::min(da.size(), db.size());
+        size_t matched = 0;
+        int64_t max_abs_dt = 0;
+        int64_t sum_dt = 0;
+        char divergence[160] = "";
+        int64_t divergence_us = INT64_MAX;
+
+        for (size_t i = 0; i < common; i++) {
+            int64_t dt = db[i].time_us - da[i].time_us;
+            if (da[i].key != db[i].key || llabs(dt) > tolerance_us) {
+                divergence_us = std::min(da[i].time_us, db[i].time_us);
+                snprintf(divergence, sizeof(divergence), "#%zu at %.3f s: %s vs %s%s", i,
+                         divergence_us / 1e6, da[i].key.c_str(), db[i].key.c_str(),
+                         da[i].key == db[i].key ? " (late/early)" : "");
+                break;
+            }
+            matched++;
+            sum_dt += dt;
+            max_abs_dt = std::max(max_abs_dt, (int64_t)llabs(dt));
+        }
+        if (divergence_us == INT64_MAX && da.size() != db.size()) {
+            const decision_t& extra = da.size() > db.size() ? da[common] : db[common];
+            divergence_us = extra.time_us;
+            snprintf(divergence, sizeof(divergence), "#%zu at %.3f s: only in %s (%s)", common,
+                     divergence_us / 1e6, da.size() > db.size() ? "A" : "B", extra.key.c_str());
+        }
+
+        fprintf(report, "%-11s %7zu %7zu %8zu %12.3f %12.3f  %s\n", channel.c_str(), da.size(), db.size(),
+                matched, max_abs_dt / 1000.0, matched ? (double)sum_dt / matched / 1000.0 : 0.0,
+                divergence[0] ? divergence : "-");
+
+        if (divergence_us != INT64_MAX) {
+            diverged = true;
+            if (divergence_us < first_divergence_us) {
+                first_divergence_us = divergence_us;
+                first_divergence = channel + " " + divergence;
+            }
+        }
+    }
+
+    if (diverged) {
+        fprintf(report, "DIVERGED first at %s\n", first_divergence.c_str());
+        return 1;
+    }
+    fprintf(report, "SAME decisions (tolerance %.3f ms)\n", tolerance_us / 1000.0);
+    return 0;
+}
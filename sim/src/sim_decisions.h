@@ -0,0 +1,55 @@
+// sim/src/sim_decisions.h
+#ifndef SIM_DECISIONS_H
+#define SIM_DECISIONS_H
+
+#include "esp_err.h"
+#include "sensor_trace.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SIM_DECISIONS.H - DECISION LOG OF A RUN AND A/B COMPARISON OF TWO LOGS
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: What the control stack decided, and when
+// - One line per decision: time_us, channel, key, detail (tab separated)
+// - Channels: mode, validation, learning, automatic, manual (state changes),
+//   wire_end (detector events, at the event time), impact (onset of each
+//   sensor health impact episode), incident (flight recorder triggers),
+//   command (input + its result)
+// - The key is what must match between builds; the detail (confidence,
+//   position, impact g) is reported but not compared
+//
+// Comparing two logs of the same trace pairs the n-th decision of each
+// channel: a key or count mismatch is a divergence, a time difference is
+// drift (divergence only above the tolerance).
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Start logging decisions
+ * @param out Destination, NULL to stop
+ */
+void sim_decisions_begin(FILE* out);
+
+/**
+ * @brief Log whatever changed since the previous call (once per tick)
+ * @param now_us Tick time
+ */
+void sim_decisions_sample(int64_t now_us);
+
+/**
+ * @brief Log a command and its result
+ */
+void sim_decisions_command(int64_t now_us, trace_command_t command, int32_t argument, esp_err_t result);
+
+/**
+ * @brief Compare two decision logs and print a per-channel report
+ * @param path_a Baseline log
+ * @param path_b Candidate log
+ * @param tolerance_us Time difference accepted as the same decision
+ * @param report Destination
+ * @return 0 = same decisions, 1 = diverged, 2 = a log could not be read
+ */
+int sim_decisions_compare(const char* path_a, const char* path_b, int64_t tolerance_us, FILE* report);
+
+#endif // SIM_DECISIONS_H
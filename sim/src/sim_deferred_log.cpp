@@ -0,0 +1,44 @@
+// sim/src/sim_deferred_log.cpp
+#include "sim_platform.h"
+#include "deferred_log.h"
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SIM_DEFERRED_LOG.CPP - RECORDS ARE FORMATTED INLINE
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// Same message table and formatter as the firmware, printed straight through
+// sim_log_write(): a simulated run has no log task, no ring and no rate limit
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static deferred_log_stats_t g_stats = {};
+
+esp_err_t deferred_log_init(void) {
+    return ESP_OK;
+}
+
+void deferred_log_set_sink(deferred_log_sink_t sink) {
+    (void)sink;
+}
+
+void deferred_log_write(dlog_message_t message, const dlog_arg_t* args, uint8_t count) {
+    const dlog_message_info_t* info = deferred_log_message_info(message);
+    if (info == NULL) return;
+
+    if (count > DEFERRED_LOG_MAX_ARGS) count = DEFERRED_LOG_MAX_ARGS;
+    dlog_arg_type_t types[DEFERRED_LOG_MAX_ARGS];
+    dlog_value_t values[DEFERRED_LOG_MAX_ARGS];
+    for (uint8_t i = 0; i < count; i++) {
+        types[i] = args[i].type;
+        values[i] = args[i].value;
+    }
+
+    char text[DEFERRED_LOG_LINE_SIZE];
+    deferred_log_format(message, types, values, count, text, sizeof(text));
+    sim_log_write(info->level, deferred_log_tag_to_string(info->tag), "%s", text);
+    g_stats.written++;
+    g_stats.printed++;
+}
+
+deferred_log_stats_t deferred_log_get_stats(void) {
+    return g_stats;
+}
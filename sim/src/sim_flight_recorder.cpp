@@ -0,0 +1,39 @@
+// sim/src/sim_flight_recorder.cpp
+#include "sim_platform.h"
+#include "flight_recorder.h"
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SIM_FLIGHT_RECORDER.CPP - TRIGGERS ARE COUNTED, NOTHING IS RECORDED
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// The benchmark reports incidents per scenario from these counts; the real
+// recorder needs a background task and the telemetry stream
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static uint32_t g_trigger_counts[FLIGHT_TRIGGER_MANUAL + 1] = {0};
+
+void flight_recorder_trigger(flight_trigger_t reason) {
+    if ((unsigned)reason <= FLIGHT_TRIGGER_MANUAL) g_trigger_counts[reason]++;
+    ESP_LOGW("SIM_FLIGHT_REC", "Incident trigger: %s", flight_recorder_trigger_to_string(reason));
+}
+
+const char* flight_recorder_trigger_to_string(flight_trigger_t reason) {
+    switch (reason) {
+        case FLIGHT_TRIGGER_NONE:       return "none";
+        case FLIGHT_TRIGGER_EMERGENCY:  return "emergency";
+        case FLIGHT_TRIGGER_IMPACT:     return "impact";
+        case FLIGHT_TRIGGER_MODE_ERROR: return "mode_error";
+        case FLIGHT_TRIGGER_MANUAL:     return "manual";
+        default:                        return "unknown";
+    }
+}
+
+uint32_t sim_flight_recorder_trigger_count(void) {
+    uint32_t total = 0;
+    for (uint32_t i = FLIGHT_TRIGGER_EMERGENCY; i <= FLIGHT_TRIGGER_MANUAL; i++) total += g_trigger_counts[i];
+    return total;
+}
+
+void sim_flight_recorder_reset(void) {
+    for (auto& count : g_trigger_counts) count = 0;
+}
@@ -0,0 +1,553 @@
+// sim/src/sim_hardware.cpp
+#include "sim_hardware.h"
+#include "hardware_control.h"
+#include "esc_duty_lut.h"
+#include "pin_config.h"
+#include "deferred_log.h"
+#include "esp_timer.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SIMULATED HARDWARE STATE (single-threaded: no snapshots needed)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static bool g_initialized = false;
+static hardware_error_t g_last_error = HW_ERROR_NONE;
+
+// Command
+static bool g_esc_armed = false;
+static float g_target_speed_ms = 0.0f;
+static uint64_t g_motion_start_us = 0;      // Target last rose from standstill (Hall timeout reference)
+static bool g_direction_forward = true;
+static bool g_closed_loop = false;
+static float g_bias_duty = 0.0f;
+static bool g_direct_duty_active = false;
+static bool g_estop_latched = false;        // Applied by the output stage, as on target
+static bool g_disarm_requested = false;
+static uint16_t g_direct_duty = ESC_NEUTRAL_DUTY;
+
+// Arming sequence (same phases and timings as the target)
+static esc_arm_state_t g_arm_state = ESC_ARM_DISARMED;
+static int64_t g_esc_settle_until = 0;
+static int64_t g_arm_phase_deadline = 0;
+
+// Output stage
+static bool g_rate_limiting_enabled = true;
+static float g_setpoint_ms = 0.0f;
+static bool g_setpoint_forward = true;
+static uint16_t g_current_duty = ESC_NEUTRAL_DUTY;
+static float g_feedback_speed_ms = 0.0f;
+static speed_controller_gains_t g_gains = {
+    .kp = SPEED_CTRL_DEFAULT_KP,
+    .ki = SPEED_CTRL_DEFAULT_KI,
+    .integrator_limit = SPEED_CTRL_DEFAULT_I_LIMIT,
+    .accel_limit_ms2 = ESC_MAX_ACCEL_MS2
+};
+static speed_controller_status_t g_controller_status = {};
+
+// Hall
+static std::vector<int64_t> g_pending_edges;
+static uint32_t g_total_pulses = 0;
+static uint32_t g_rotation_count_offset = 0;
+static int32_t g_position_pulses = 0;
+static uint32_t g_position_resets = 0;
+static float g_hall_speed_ms = 0.0f;
+static uint64_t g_last_hall_time = 0;
+static uint64_t g_batch_last_time = 0;
+static bool g_hall_healthy = false;
+static hall_batch_t g_last_batch = {};
+static uint32_t g_batches_processed = 0;
+static uint32_t g_max_batch_size = 0;
+
+static hall_pulse_callback_t g_hall_callback = nullptr;
+static esc_status_callback_t g_esc_callback = nullptr;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SIMULATION HOOKS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void sim_hardware_hall_edge(int64_t timestamp_us) {
+    g_pending_edges.push_back(timestamp_us);
+}
+
+trolley_drive_t sim_hardware_get_drive(void) {
+    trolley_drive_t drive = {};
+    if (!g_initialized || !g_esc_armed) return drive;
+    if (g_estop_latched || g_disarm_requested) return drive;     // Neutral already written
+
+    if (g_direct_duty_active) {
+        int offset = (int)g_direct_duty - ESC_NEUTRAL_DUTY;
+        if (offset > -ESC_DEADBAND && offset < ESC_DEADBAND) return drive;
+        float span = offset > 0 ? (float)(ESC_MAX_DUTY - ESC_NEUTRAL_DUTY) : (float)(ESC_NEUTRAL_DUTY - ESC_MIN_DUTY);
+        drive.powered = true;
+        drive.forward = offset > 0;
+        drive.speed_ms = fabsf((float)offset) / span * MAX_SPEED_MS;
+        return drive;
+    }
+
+    drive.powered = g_setpoint_ms >= ESC_SPEED_DEADBAND;
+    drive.forward = g_setpoint_forward;
+    drive.speed_ms = drive.powered ? g_setpoint_ms : 0.0f;
+    return drive;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SENSE AND OUTPUT STAGES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void hall_process_batch(void) {
+    uint32_t batch_size = (uint32_t)g_pending_edges.size();
+    g_last_batch.new_pulses = batch_size;
+    g_last_batch.edge_count = batch_size;
+    g_last_batch.newest_edge_us = batch_size ? (uint64_t)g_pending_edges.back() : 0;
+
+    if (batch_size == 0) {
+        uint64_t now = esp_timer_get_time();
+        uint64_t reference = g_last_hall_time > g_motion_start_us ? g_last_hall_time : g_motion_start_us;
+        if (g_last_hall_time > 0 && (now - reference) > (HALL_TIMEOUT_MS * 1000ULL)) {
+            g_hall_speed_ms = 0.0f;
+            g_hall_healthy = g_hall_healthy && g_target_speed_ms < ESC_SPEED_DEADBAND;
+        }
+        return;
+    }
+
+    // Speed from the batch: N periods over the span they cover
+    uint64_t first_time = (uint64_t)g_pending_edges.front();
+    uint64_t newest_time = (uint64_t)g_pending_edges.back();
+    uint64_t span_start = g_batch_last_time;
+    uint32_t periods = batch_size;
+    if (span_start == 0) {
+        span_start = first_time;
+        periods = batch_size - 1;
+    }
+    uint64_t span_us = newest_time - span_start;
+    if (periods > 0 && span_us > 0) {
+        g_hall_speed_ms = (float)((double)periods * HALL_DISTANCE_PER_PULSE_UM / (double)span_us);
+    }
+    g_batch_last_time = newest_time;
+    g_last_hall_time = newest_time;
+
+    // Signed by the commanded direction, like the target (the sensor has no direction)
+    g_position_pulses += g_direction_forward ? (int32_t)batch_size : -(int32_t)batch_size;
+    g_last_batch.position_pulses = g_position_pulses;
+    g_last_batch.position_m = g_position_pulses * HALL_DISTANCE_PER_PULSE_M;
+
+    g_total_pulses += batch_size;
+    g_hall_healthy = true;
+    g_batches_processed++;
+    if (batch_size > g_max_batch_size) g_max_batch_size = batch_size;
+    g_pending_edges.clear();
+
+    if (g_hall_callback) {
+        g_hall_callback(g_total_pulses / HALL_MAGNETS_PER_REV, g_last_hall_time);
+    }
+}
+
+static void esc_arm_step(void) {
+    if (g_arm_state == ESC_ARM_DISARMED || g_arm_state == ESC_ARM_ARMED) return;
+
+    int64_t now = esp_timer_get_time();
+    switch (g_arm_state) {
+        case ESC_ARM_SETTLING:
+            if (now < g_esc_settle_until) return;
+            g_arm_state = ESC_ARM_NEUTRAL;
+            g_arm_phase_deadline = now + ESC_ARM_NEUTRAL_MS * 1000LL;
+            break;
+        case ESC_ARM_NEUTRAL:
+            if (now < g_arm_phase_deadline) return;
+            g_arm_state = ESC_ARM_SIGNAL;
+            g_current_duty = ESC_ARM_DUTY;
+            g_arm_phase_deadline = now + ESC_ARM_TIME_MS * 1000LL;
+            break;
+        default:
+            if (now < g_arm_phase_deadline) return;
+            g_arm_state = ESC_ARM_ARMED;
+            g_current_duty = ESC_NEUTRAL_DUTY;
+            g_esc_armed = true;
+            if (g_esc_callback) g_esc_callback(true, true);
+            deferred_log(DLOG_MSG_HW_ESC_ARMED);
+            break;
+    }
+}
+
+static void ramp_speed_setpoint(uint32_t dt_us) {
+    float target = g_target_speed_ms;
+    if (!g_rate_limiting_enabled) {
+        g_setpoint_ms = target;
+        g_setpoint_forward = g_direction_forward;
+        return;
+    }
+
+    // A direction change ramps the setpoint to zero before it flips
+    if (g_direction_forward != g_setpoint_forward) {
+        if (g_setpoint_ms == 0.0f) {
+            g_setpoint_forward = g_direction_forward;
+        } else {
+            target = 0.0f;
+        }
+    }
+
+    float max_step = g_gains.accel_limit_ms2 * dt_us * 1e-6f;
+    if (target > g_setpoint_ms) {
+        g_setpoint_ms = fminf(target, g_setpoint_ms + max_step);
+    } else {
+        g_setpoint_ms = fmaxf(target, g_setpoint_ms - max_step);
+    }
+}
+
+static void apply_stop_requests(void) {
+    if (!g_estop_latched && !g_disarm_requested) return;
+    bool was_armed = g_esc_armed;
+    if (g_disarm_requested) g_esc_armed = false;
+    g_target_speed_ms = 0.0f;
+    g_bias_duty = 0.0f;
+    g_direct_duty_active = false;
+    g_setpoint_ms = 0.0f;
+    g_current_duty = ESC_NEUTRAL_DUTY;
+    if (g_disarm_requested && was_armed && g_esc_callback) g_esc_callback(false, true);
+    g_estop_latched = false;
+    g_disarm_requested = false;
+}
+
+static void esc_output_step(uint32_t dt_us) {
+    esc_arm_step();
+    apply_stop_requests();
+
+    if (!g_esc_armed) {
+        g_setpoint_ms = 0.0f;
+        g_controller_status = {};
+        return;
+    }
+    if (g_direct_duty_active) {
+        g_current_duty = g_direct_duty;
+        return;
+    }
+
+    ramp_speed_setpoint(dt_us);
+    uint16_t setpoint_mm_s = (uint16_t)(g_setpoint_ms * 1000.0f);
+    uint16_t duty = setpoint_mm_s < ESC_SPEED_DEADBAND_MM_S ? ESC_NEUTRAL_DUTY
+                                                             : esc_lut_speed_to_duty(setpoint_mm_s, g_setpoint_forward);
+
+    // The physics drive is an ideal controller: report feed-forward plus bias
+    bool feedback = g_closed_loop && g_hall_healthy && g_setpoint_ms >= SPEED_CTRL_MIN_FEEDBACK_MS;
+    float bias = feedback ? g_bias_duty : 0.0f;
+    int offset = (int)lroundf(bias);
+    g_current_duty = (uint16_t)(g_setpoint_forward ? duty + offset : duty - offset);
+
+    g_controller_status.closed_loop = feedback;
+    g_controller_status.setpoint_ms = g_setpoint_ms;
+    g_controller_status.measured_ms = g_feedback_speed_ms;
+    g_controller_status.feed_forward_duty = duty;
+    g_controller_status.bias_duty = bias;
+    g_controller_status.correction_duty = 0.0f;
+    g_controller_status.integrator_duty = 0.0f;
+    g_controller_status.saturated = false;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// hardware_control.h
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t hardware_init(void) {
+    g_esc_armed = false;
+    g_target_speed_ms = 0.0f;
+    g_direction_forward = true;
+    g_closed_loop = false;
+    g_bias_duty = 0.0f;
+    g_direct_duty_active = false;
+    g_arm_state = ESC_ARM_DISARMED;
+    g_esc_settle_until = esp_timer_get_time() + ESC_POWER_SETTLE_MS * 1000LL;
+    g_setpoint_ms = 0.0f;
+    g_setpoint_forward = true;
+    g_current_duty = ESC_NEUTRAL_DUTY;
+    g_pending_edges.clear();
+    g_total_pulses = 0;
+    g_rotation_count_offset = 0;
+    g_position_pulses = 0;
+    g_position_resets = 0;
+    g_hall_speed_ms = 0.0f;
+    g_last_hall_time = 0;
+    g_motion_start_us = 0;
+    g_batch_last_time = 0;
+    g_hall_healthy = false;
+    g_last_batch = {};
+    g_batches_processed = 0;
+    g_max_batch_size = 0;
+    g_hall_callback = nullptr;
+    g_esc_callback = nullptr;
+
+    esc_lut_init();
+    g_initialized = true;
+    return ESP_OK;
+}
+
+hardware_status_t hardware_get_status(void) {
+    hardware_status_t status = {
+        .esc_armed = g_esc_armed,
+        .esc_responding = true,
+        .current_esc_duty = g_current_duty,
+        .current_speed_ms = g_hall_speed_ms,
+        .target_speed_ms = g_target_speed_ms,
+        .direction_forward = g_direction_forward,
+        .total_rotations = g_total_pulses / HALL_MAGNETS_PER_REV,
+        .last_hall_time = g_last_hall_time,
+        .hall_sensor_healthy = g_hall_healthy,
+        .system_initialized = g_initialized
+    };
+    return status;
+}
+
+uint32_t hardware_get_status_generation(void) {
+    // Every call may see a change: callers only use it as a change token
+    static uint32_t generation = 0;
+    return ++generation;
+}
+
+hardware_error_t hardware_get_last_error(void) {
+    return g_last_error;
+}
+
+bool hardware_is_ready(void) {
+    return g_initialized && g_hall_healthy;
+}
+
+esp_err_t hardware_esc_arm(void) {
+    if (!g_initialized) {
+        g_last_error = HW_ERROR_SYSTEM_NOT_INITIALIZED;
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (g_arm_state == ESC_ARM_DISARMED) g_arm_state = ESC_ARM_SETTLING;
+    return ESP_OK;
+}
+
+esc_arm_state_t hardware_esc_get_arm_state(void) {
+    return g_arm_state;
+}
+
+const char* hardware_esc_arm_state_to_string(esc_arm_state_t state) {
+    switch (state) {
+        case ESC_ARM_DISARMED: return "Disarmed";
+        case ESC_ARM_SETTLING: return "Power settling";
+        case ESC_ARM_NEUTRAL: return "Neutral hold";
+        case ESC_ARM_SIGNAL: return "Arming signal";
+        case ESC_ARM_ARMED: return "Armed";
+        default: return "Unknown";
+    }
+}
+
+esp_err_t hardware_esc_disarm(void) {
+    g_arm_state = ESC_ARM_DISARMED;
+    g_disarm_requested = true;
+    g_current_duty = ESC_NEUTRAL_DUTY;
+    return ESP_OK;
+}
+
+bool hardware_esc_is_armed(void) {
+    return g_esc_armed && g_arm_state == ESC_ARM_ARMED;
+}
+
+static esp_err_t set_speed_command(float speed_ms, bool forward, bool closed_loop) {
+    if (!g_initialized) {
+        g_last_error = HW_ERROR_SYSTEM_NOT_INITIALIZED;
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!hardware_is_speed_valid(speed_ms)) {
+        g_last_error = HW_ERROR_SPEED_OUT_OF_RANGE;
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!g_esc_armed || g_arm_state != ESC_ARM_ARMED) {
+        g_last_error = HW_ERROR_ESC_NOT_RESPONDING;
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (g_estop_latched || g_disarm_requested) return ESP_ERR_INVALID_STATE;
+    if (g_target_speed_ms < ESC_SPEED_DEADBAND && speed_ms >= ESC_SPEED_DEADBAND) {
+        g_motion_start_us = esp_timer_get_time();
+    }
+    g_target_speed_ms = speed_ms;
+    g_direction_forward = forward;
+    g_closed_loop = closed_loop;
+    g_direct_duty_active = false;
+    return ESP_OK;
+}
+
+esp_err_t hardware_set_motor_speed(float speed_ms, bool forward) {
+    return set_speed_command(speed_ms, forward, false);
+}
+
+esp_err_t hardware_set_speed_closed_loop(float speed_ms, bool forward) {
+    return set_speed_command(speed_ms, forward, true);
+}
+
+esp_err_t hardware_emergency_stop(void) {
+    if (g_arm_state != ESC_ARM_ARMED) g_arm_state = ESC_ARM_DISARMED;
+    g_estop_latched = true;
+    g_current_duty = ESC_NEUTRAL_DUTY;
+    return ESP_OK;
+}
+
+float hardware_get_current_speed(void) {
+    return g_hall_speed_ms;
+}
+
+uint32_t hardware_get_rotation_count(void) {
+    return g_total_pulses / HALL_MAGNETS_PER_REV - g_rotation_count_offset;
+}
+
+esp_err_t hardware_reset_rotation_count(void) {
+    g_rotation_count_offset = g_total_pulses / HALL_MAGNETS_PER_REV;
+    return ESP_OK;
+}
+
+uint64_t hardware_get_time_since_last_hall_pulse(void) {
+    if (g_last_hall_time == 0) return 0;
+    return esp_timer_get_time() - g_last_hall_time;
+}
+
+bool hardware_is_hall_sensor_healthy(void) {
+    return g_hall_healthy;
+}
+
+hall_backend_stats_t hardware_get_hall_stats(void) {
+    hall_backend_stats_t stats = {
+        .pcnt_backend = false,
+        .total_pulses = g_total_pulses,
+        .timestamps_captured = g_total_pulses,
+        .timestamps_dropped = 0,
+        .glitches_rejected = 0,
+        .batches_processed = g_batches_processed,
+        .max_batch_size = g_max_batch_size
+    };
+    return stats;
+}
+
+hall_batch_t hardware_get_last_hall_batch(void) {
+    hall_batch_t batch = g_last_batch;
+    batch.position_resets = g_position_resets;
+    return batch;
+}
+
+float hardware_rotations_to_distance(uint32_t rotations) {
+    return rotations * WHEEL_CIRCUMFERENCE_MM * MM_TO_M;
+}
+
+uint32_t hardware_rotations_to_distance_mm(uint32_t rotations) {
+    return (uint32_t)(((uint64_t)rotations * WHEEL_CIRCUMFERENCE_UM + 500) / 1000);
+}
+
+uint32_t hardware_distance_to_rotations(float distance_m) {
+    return (uint32_t)(distance_m / (WHEEL_CIRCUMFERENCE_MM * MM_TO_M));
+}
+
+esp_err_t hardware_set_status_led(bool on) {
+    (void)on;
+    return ESP_OK;
+}
+
+float hardware_get_current_position(void) {
+    return g_position_pulses * HALL_DISTANCE_PER_PULSE_M;
+}
+
+esp_err_t hardware_reset_position(void) {
+    g_position_pulses = 0;
+    g_last_batch.position_pulses = 0;
+    g_last_batch.position_m = 0.0f;
+    hardware_reset_rotation_count();
+    g_position_resets++;
+    return ESP_OK;
+}
+
+esp_err_t hardware_update(void) {
+    return esc_lut_process_pending_save();
+}
+
+esp_err_t hardware_sense_update(void) {
+    if (!g_initialized) return ESP_ERR_INVALID_STATE;
+    hall_process_batch();
+    return ESP_OK;
+}
+
+esp_err_t hardware_output_update(uint32_t dt_us, float measured_speed_ms) {
+    if (!g_initialized) return ESP_ERR_INVALID_STATE;
+    g_feedback_speed_ms = measured_speed_ms;
+    esc_output_step(dt_us);
+    return ESP_OK;
+}
+
+const char* hardware_error_to_string(hardware_error_t error) {
+    switch (error) {
+        case HW_ERROR_NONE: return "No error";
+        case HW_ERROR_ESC_NOT_RESPONDING: return "ESC not responding";
+        case HW_ERROR_HALL_SENSOR_TIMEOUT: return "Hall sensor timeout";
+        case HW_ERROR_PWM_INIT_FAILED: return "PWM initialization failed";
+        case HW_ERROR_GPIO_INIT_FAILED: return "GPIO initialization failed";
+        case HW_ERROR_SPEED_OUT_OF_RANGE: return "Speed out of range";
+        case HW_ERROR_SYSTEM_NOT_INITIALIZED: return "System not initialized";
+        default: return "Unknown error";
+    }
+}
+
+bool hardware_is_speed_valid(float speed_ms) {
+    return (speed_ms >= 0.0f && speed_ms <= MAX_SPEED_MS);
+}
+
+esp_err_t hardware_get_info(char* info_buffer, size_t buffer_size) {
+    snprintf(info_buffer, buffer_size,
+             "Simulated hardware (%s)\nWheel: %.1fmm circumference\nMax Speed: %.1f m/s",
+             trolley_physics_get_config()->name, WHEEL_CIRCUMFERENCE_MM, MAX_SPEED_MS);
+    return ESP_OK;
+}
+
+esp_err_t hardware_register_hall_callback(hall_pulse_callback_t callback) {
+    g_hall_callback = callback;
+    return ESP_OK;
+}
+
+esp_err_t hardware_register_esc_callback(esc_status_callback_t callback) {
+    g_esc_callback = callback;
+    return ESP_OK;
+}
+
+esp_err_t hardware_set_esc_duty_direct(uint16_t duty_cycle) {
+    if (!g_esc_armed) return ESP_ERR_INVALID_STATE;
+    if (duty_cycle < ESC_MIN_DUTY || duty_cycle > ESC_MAX_DUTY) return ESP_ERR_INVALID_ARG;
+    g_direct_duty_active = true;
+    g_direct_duty = duty_cycle;
+    g_current_duty = duty_cycle;
+    return ESP_OK;
+}
+
+uint16_t hardware_get_esc_duty(void) {
+    return g_current_duty;
+}
+
+esp_err_t hardware_set_esc_rate_limiting(bool enable) {
+    g_rate_limiting_enabled = enable;
+    return ESP_OK;
+}
+
+esp_err_t hardware_set_speed_controller_gains(const speed_controller_gains_t* gains) {
+    if (!gains || gains->kp < 0.0f || gains->ki < 0.0f ||
+        gains->integrator_limit < 0.0f || gains->accel_limit_ms2 <= 0.0f) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    g_gains = *gains;
+    return ESP_OK;
+}
+
+speed_controller_gains_t hardware_get_speed_controller_gains(void) {
+    return g_gains;
+}
+
+speed_controller_status_t hardware_get_speed_controller_status(void) {
+    return g_controller_status;
+}
+
+esp_err_t hardware_set_feed_forward_bias(float bias_duty) {
+    if (!g_initialized) return ESP_ERR_INVALID_STATE;
+    if (bias_duty > SPEED_CTRL_MAX_BIAS_DUTY) bias_duty = SPEED_CTRL_MAX_BIAS_DUTY;
+    if (bias_duty < -SPEED_CTRL_MAX_BIAS_DUTY) bias_duty = -SPEED_CTRL_MAX_BIAS_DUTY;
+    g_bias_duty = bias_duty;
+    return ESP_OK;
+}
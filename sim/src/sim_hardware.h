@@ -0,0 +1,31 @@
+// sim/src/sim_hardware.h
+#ifndef SIM_HARDWARE_H
+#define SIM_HARDWARE_H
+
+#include "trolley_physics.h"
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SIM_HARDWARE.H - SIMULATION SIDE OF THE hardware_control.h SEAM
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// sim_hardware.cpp implements every hardware_control.h function for the host:
+// same arming sequence timings, same command validation, same setpoint
+// ramp and Hall batching as the target. The ESC and PI loop are replaced by
+// the physics drive model (an ideal speed controller); what mode logic sees
+// through the header is unchanged.
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Physics sink: one Hall edge at the given time
+ * @param timestamp_us Edge time
+ */
+void sim_hardware_hall_edge(int64_t timestamp_us);
+
+/**
+ * @brief Drive input for the physics model from the current output state
+ * @return Ramped, armed-gated speed command
+ */
+trolley_drive_t sim_hardware_get_drive(void);
+
+#endif // SIM_HARDWARE_H
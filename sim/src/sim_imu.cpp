@@ -0,0 +1,109 @@
+// sim/src/sim_imu.cpp
+#include "sim_imu.h"
+#include "imu_acquisition.h"
+#include "fixed_point.h"
+#include <cmath>
+#include <cstring>
+
+#define IMU_RING_MASK               (IMU_RING_SIZE - 1)
+
+static imu_sample_t g_sample_ring[IMU_RING_SIZE];
+static uint32_t g_ring_head = 0;
+static imu_acquisition_stats_t g_stats = {};
+
+int16_t sim_imu_g_to_raw(float value_g) {
+    long raw = lroundf(value_g * IMU_ACCEL_LSB_PER_G);
+    if (raw > INT16_MAX) raw = INT16_MAX;                  // ±8 g full scale clips like the sensor
+    if (raw < INT16_MIN) raw = INT16_MIN;
+    return (int16_t)raw;
+}
+
+void sim_imu_push(int64_t timestamp_us, float x_g, float y_g, float z_g) {
+    sim_imu_push_raw(timestamp_us, sim_imu_g_to_raw(x_g), sim_imu_g_to_raw(y_g), sim_imu_g_to_raw(z_g));
+}
+
+void sim_imu_push_raw(int64_t timestamp_us, int16_t x_raw, int16_t y_raw, int16_t z_raw) {
+    imu_sample_t sample;
+    sample.timestamp_us = (uint64_t)timestamp_us;
+    sample.x_raw = x_raw;
+    sample.y_raw = y_raw;
+    sample.z_raw = z_raw;
+    uint32_t total = fx_magnitude3(sample.x_raw, sample.y_raw, sample.z_raw);
+    sample.total_raw = (uint16_t)(total > UINT16_MAX ? UINT16_MAX : total);
+
+    g_sample_ring[g_ring_head & IMU_RING_MASK] = sample;
+    g_ring_head++;
+    g_stats.samples_total++;
+    g_stats.batches_total++;
+}
+
+void sim_imu_reset(void) {
+    memset(g_sample_ring, 0, sizeof(g_sample_ring));
+    g_ring_head = 0;
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_stats.running = true;
+    g_stats.interrupt_driven = true;
+    g_stats.sample_rate_hz = IMU_SAMPLE_RATE_HZ;
+    g_stats.max_batch_samples = 1;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// imu_acquisition.h
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t imu_acquisition_init(MPU_t* mpu_sensor) {
+    (void)mpu_sensor;
+    sim_imu_reset();
+    return ESP_OK;
+}
+
+bool imu_acquisition_is_running(void) {
+    return g_stats.running;
+}
+
+imu_acquisition_stats_t imu_acquisition_get_stats(void) {
+    return g_stats;
+}
+
+void imu_acquisition_reader_init(imu_reader_t* reader) {
+    if (reader == NULL) return;
+    reader->position = g_ring_head;
+    reader->overruns = 0;
+}
+
+size_t imu_acquisition_read(imu_reader_t* reader, imu_sample_t* samples, size_t max_samples) {
+    if (reader == NULL || samples == NULL || max_samples == 0) return 0;
+
+    // Reader fell more than a ring behind - skip to the oldest slot still intact
+    if (g_ring_head - reader->position > IMU_RING_SIZE) {
+        reader->overruns += g_ring_head - reader->position - IMU_RING_SIZE;
+        reader->position = g_ring_head - IMU_RING_SIZE;
+    }
+
+    uint32_t available = g_ring_head - reader->position;
+    size_t count = available < max_samples ? available : max_samples;
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = g_sample_ring[(reader->position + i) & IMU_RING_MASK];
+    }
+    reader->position += count;
+    return count;
+}
+
+float imu_acquisition_read_peak_g(imu_reader_t* reader) {
+    imu_sample_t batch[IMU_BATCH_SAMPLES * 2];
+    size_t count;
+    uint16_t peak_raw = 0;
+
+    while ((count = imu_acquisition_read(reader, batch, sizeof(batch) / sizeof(batch[0]))) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            if (batch[i].total_raw > peak_raw) peak_raw = batch[i].total_raw;
+        }
+    }
+    return imu_raw_to_g(peak_raw);
+}
+
+imu_sample_t imu_acquisition_get_latest(void) {
+    imu_sample_t sample = {};
+    if (g_ring_head == 0) return sample;
+    return g_sample_ring[(g_ring_head - 1) & IMU_RING_MASK];
+}
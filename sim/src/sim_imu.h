@@ -0,0 +1,46 @@
+// sim/src/sim_imu.h
+#ifndef SIM_IMU_H
+#define SIM_IMU_H
+
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SIM_IMU.H - SIMULATION SIDE OF imu_acquisition.h
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// sim_imu.cpp implements the consumer API of imu_acquisition.h over the same
+// broadcast ring (IMU_RING_SIZE, per-reader cursors, overrun accounting),
+// filled by the physics model instead of the MPU6050 FIFO task
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Physics sink: one accelerometer sample
+ * @param timestamp_us Sample time
+ * @param x_g Longitudinal acceleration (g)
+ * @param y_g Lateral acceleration (g)
+ * @param z_g Vertical acceleration including gravity (g)
+ */
+void sim_imu_push(int64_t timestamp_us, float x_g, float y_g, float z_g);
+
+/**
+ * @brief One sample as the MPU6050 FIFO delivers it (trace replay)
+ * @param timestamp_us Sample time
+ * @param x_raw Longitudinal counts (IMU_ACCEL_LSB_PER_G)
+ * @param y_raw Lateral counts
+ * @param z_raw Vertical counts
+ */
+void sim_imu_push_raw(int64_t timestamp_us, int16_t x_raw, int16_t y_raw, int16_t z_raw);
+
+/**
+ * @brief Quantize like the sensor: ±8 g full scale, saturating
+ * @param value_g Acceleration in g
+ * @return Raw counts
+ */
+int16_t sim_imu_g_to_raw(float value_g);
+
+/**
+ * @brief Empty the ring and mark acquisition running
+ */
+void sim_imu_reset(void);
+
+#endif // SIM_IMU_H
@@ -0,0 +1,234 @@
+// sim/src/sim_platform.cpp
+#include "sim_platform.h"
+#include "hal_clock.h"
+#include "esp_timer.h"
+#include "esp_rom_crc.h"
+#include "esp_partition.h"
+#include "nvs.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// VIRTUAL CLOCK
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static int64_t g_now_us = 0;
+
+static const hal_clock_t g_sim_clock = {
+    .now_us = sim_clock_now_us
+};
+
+void sim_clock_init(void) {
+    g_now_us = 0;
+    hal_clock_install(&g_sim_clock);
+}
+
+void sim_clock_set_us(int64_t now_us) {
+    if (now_us > g_now_us) g_now_us = now_us;
+}
+
+int64_t sim_clock_now_us(void) {
+    return g_now_us;
+}
+
+int64_t esp_timer_get_time(void) {
+    return g_now_us;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// LOGGING
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static esp_log_level_t g_log_level = ESP_LOG_WARN;
+
+void sim_log_set_level(esp_log_level_t level) {
+    g_log_level = level;
+}
+
+void sim_log_write(esp_log_level_t level, const char* tag, const char* format, ...) {
+    if (level > g_log_level) return;
+
+    static const char LEVEL_CHAR[] = {'-', 'E', 'W', 'I', 'D', 'V'};
+    fprintf(stderr, "%c (%9.3f s) %s: ", LEVEL_CHAR[level], g_now_us / 1e6, tag);
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+const char* esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_INVALID_RESPONSE: return "ESP_ERR_INVALID_RESPONSE";
+        case ESP_ERR_INVALID_CRC: return "ESP_ERR_INVALID_CRC";
+        case ESP_ERR_INVALID_VERSION: return "ESP_ERR_INVALID_VERSION";
+        case ESP_ERR_NVS_NOT_FOUND: return "ESP_ERR_NVS_NOT_FOUND";
+        case ESP_ERR_NVS_INVALID_LENGTH: return "ESP_ERR_NVS_INVALID_LENGTH";
+        default: return "UNKNOWN_ERROR";
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// ROM CRC32 (reflected 0xEDB88320, pre- and post-inverted like the ROM)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// IN-MEMORY NVS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef std::map<std::string, std::vector<uint8_t>> nvs_namespace_t;
+
+static std::map<std::string, nvs_namespace_t> g_nvs;
+static std::vector<std::string> g_nvs_handles;             // handle - 1 → namespace
+
+esp_err_t nvs_open(const char* name, nvs_open_mode_t open_mode, nvs_handle_t* out_handle) {
+    if (name == NULL || out_handle == NULL) return ESP_ERR_INVALID_ARG;
+    if (open_mode == NVS_READONLY && g_nvs.find(name) == g_nvs.end()) return ESP_ERR_NVS_NOT_FOUND;
+    g_nvs[name];
+    g_nvs_handles.push_back(name);
+    *out_handle = (nvs_handle_t)g_nvs_handles.size();
+    return ESP_OK;
+}
+
+static nvs_namespace_t* nvs_lookup(nvs_handle_t handle) {
+    if (handle == 0 || handle > g_nvs_handles.size()) return NULL;
+    return &g_nvs[g_nvs_handles[handle - 1]];
+}
+
+void nvs_close(nvs_handle_t handle) {
+    (void)handle;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle) {
+    return nvs_lookup(handle) ? ESP_OK : ESP_ERR_NVS_INVALID_HANDLE;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char* key, const void* value, size_t length) {
+    nvs_namespace_t* ns = nvs_lookup(handle);
+    if (ns == NULL) return ESP_ERR_NVS_INVALID_HANDLE;
+    const uint8_t* bytes = (const uint8_t*)value;
+    (*ns)[key].assign(bytes, bytes + length);
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* out_value, size_t* length) {
+    nvs_namespace_t* ns = nvs_lookup(handle);
+    if (ns == NULL) return ESP_ERR_NVS_INVALID_HANDLE;
+    auto entry = ns->find(key);
+    if (entry == ns->end()) return ESP_ERR_NVS_NOT_FOUND;
+    if (out_value == NULL) {
+        *length = entry->second.size();
+        return ESP_OK;
+    }
+    if (*length < entry->second.size()) return ESP_ERR_NVS_INVALID_LENGTH;
+    memcpy(out_value, entry->second.data(), entry->second.size());
+    *length = entry->second.size();
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_str(nvs_handle_t handle, const char* key, const char* value) {
+    return nvs_set_blob(handle, key, value, strlen(value) + 1);
+}
+
+esp_err_t nvs_get_str(nvs_handle_t handle, const char* key, char* out_value, size_t* length) {
+    return nvs_get_blob(handle, key, out_value, length);
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char* key) {
+    nvs_namespace_t* ns = nvs_lookup(handle);
+    if (ns == NULL) return ESP_ERR_NVS_INVALID_HANDLE;
+    return ns->erase(key) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// RAM-BACKED DATA PARTITIONS (partitions.csv sizes; the flight recorder is not simulated)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define SIM_FLASH_SECTOR_SIZE       4096
+
+typedef struct {
+    esp_partition_t info;
+    std::vector<uint8_t> data;
+} sim_partition_t;
+
+static sim_partition_t g_partitions[] = {
+    {{ESP_PARTITION_TYPE_DATA, 0x540000, 0x20000, SIM_FLASH_SECTOR_SIZE, "wiremap"}, {}},
+};
+
+static sim_partition_t* partition_lookup(const esp_partition_t* partition) {
+    for (auto& p : g_partitions) {
+        if (&p.info == partition) {
+            if (p.data.empty()) p.data.assign(p.info.size, 0xFF);   // Erased flash
+            return &p;
+        }
+    }
+    return NULL;
+}
+
+void sim_storage_reset(void) {
+    g_nvs.clear();
+    g_nvs_handles.clear();
+    for (auto& p : g_partitions) p.data.clear();
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label) {
+    (void)subtype;
+    for (auto& p : g_partitions) {
+        if (p.info.type == type && (label == NULL || strcmp(label, p.info.label) == 0)) return &p.info;
+    }
+    return NULL;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t src_offset, void* dst, size_t size) {
+    sim_partition_t* p = partition_lookup(partition);
+    if (p == NULL) return ESP_ERR_INVALID_ARG;
+    if (src_offset + size > p->info.size) return ESP_ERR_INVALID_SIZE;
+    memcpy(dst, p->data.data() + src_offset, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t dst_offset, const void* src, size_t size) {
+    sim_partition_t* p = partition_lookup(partition);
+    if (p == NULL) return ESP_ERR_INVALID_ARG;
+    if (dst_offset + size > p->info.size) return ESP_ERR_INVALID_SIZE;
+    // NOR flash: programming only clears bits
+    const uint8_t* bytes = (const uint8_t*)src;
+    for (size_t i = 0; i < size; i++) p->data[dst_offset + i] &= bytes[i];
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size) {
+    sim_partition_t* p = partition_lookup(partition);
+    if (p == NULL) return ESP_ERR_INVALID_ARG;
+    if (offset % SIM_FLASH_SECTOR_SIZE != 0 || size % SIM_FLASH_SECTOR_SIZE != 0 ||
+        offset + size > p->info.size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(p->data.data() + offset, 0xFF, size);
+    return ESP_OK;
+}
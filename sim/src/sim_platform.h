@@ -0,0 +1,48 @@
+// sim/src/sim_platform.h
+#ifndef SIM_PLATFORM_H
+#define SIM_PLATFORM_H
+
+#include "esp_log.h"
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SIM_PLATFORM.H - VIRTUAL CLOCK, LOG SINK, IN-MEMORY NVS AND PARTITIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: The ESP-IDF services the components use, on the host
+// - One virtual clock: hal_clock.h (mode logic) and the esp_timer shim
+//   (sensing components) both read it, so every stage sees the same time
+// - ESP_LOGx filtered by level and prefixed with simulation time
+// - NVS and the flash data partitions live in memory for one process
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Install the virtual clock into hal_clock and reset it to 0
+ */
+void sim_clock_init(void);
+
+/**
+ * @brief Move the virtual clock (never backwards)
+ * @param now_us New simulation time
+ */
+void sim_clock_set_us(int64_t now_us);
+
+int64_t sim_clock_now_us(void);
+
+/**
+ * @brief Most verbose ESP_LOGx level printed (default ESP_LOG_WARN)
+ */
+void sim_log_set_level(esp_log_level_t level);
+
+/**
+ * @brief Forget all NVS keys and partition contents (a factory-fresh unit)
+ */
+void sim_storage_reset(void);
+
+/**
+ * @brief Incident triggers since the last reset (sim_flight_recorder.cpp)
+ */
+uint32_t sim_flight_recorder_trigger_count(void);
+void sim_flight_recorder_reset(void);
+
+#endif // SIM_PLATFORM_H
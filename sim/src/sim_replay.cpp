@@ -0,0 +1,162 @@
+// sim/src/sim_replay.cpp
+#include "sim_platform.h"
+#include "sim_unit.h"
+#include "sim_decisions.h"
+#include "sensor_trace.h"
+#include "hardware_control.h"
+#include "imu_acquisition.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SIM_REPLAY.CPP - RECORDED INPUTS THROUGH THE CONTROL STACK, DECISIONS OUT
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+//   trolley_replay TRACE [--decisions FILE] [--realtime [--speed X]] [--verbose]
+//   trolley_replay --compare A.decisions B.decisions [--tolerance-ms T]
+//
+// Replay boots a factory-fresh unit and feeds the trace beneath
+// hardware_control.h (Hall edges) and imu_acquisition.h (raw samples);
+// commands are issued at their recorded tick. Nothing is modelled: the trace
+// is the whole world, so the same build always makes the same decisions.
+//
+// A/B: replay one trace with two builds, then --compare the decision logs.
+// Default pacing is as fast as the host allows; --realtime holds simulation
+// time to the wall clock (scaled by --speed).
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static sensor_trace_t g_trace = {};
+static sensor_trace_record_t g_next = {};
+static bool g_have_next = false;
+static uint32_t g_unknown_records = 0;
+
+static void read_next(void) {
+    g_have_next = sensor_trace_read(&g_trace, &g_next);
+}
+
+// Input source: every sensor record up to the tick time; a command record
+// stops delivery until the replay loop has issued it
+static void trace_source(int64_t until_us) {
+    while (g_have_next && g_next.type != TRACE_RECORD_COMMAND && (int64_t)g_next.timestamp_us <= until_us) {
+        switch (g_next.type) {
+            case TRACE_RECORD_HALL_EDGE:
+                sim_unit_hall_edge((int64_t)g_next.timestamp_us);
+                break;
+            case TRACE_RECORD_IMU_SAMPLE:
+                sim_unit_imu_sample_raw((int64_t)g_next.timestamp_us, g_next.accel[0], g_next.accel[1], g_next.accel[2]);
+                break;
+            default:
+                g_unknown_records++;
+                break;
+        }
+        read_next();
+    }
+}
+
+static int replay(const char* trace_path, const char* decisions_path, bool realtime, double speed) {
+    esp_err_t result = sensor_trace_open(&g_trace, trace_path);
+    if (result != ESP_OK) {
+        fprintf(stderr, "%s: %s\n", trace_path, esp_err_to_name(result));
+        return 2;
+    }
+    if (g_trace.header.hall_magnets_per_rev != HALL_MAGNETS_PER_REV ||
+        g_trace.header.imu_sample_rate_hz != IMU_SAMPLE_RATE_HZ) {
+        fprintf(stderr, "%s: recorded with %u magnets / %u Hz IMU, this build has %u / %u\n", trace_path,
+                (unsigned)g_trace.header.hall_magnets_per_rev, (unsigned)g_trace.header.imu_sample_rate_hz,
+                (unsigned)HALL_MAGNETS_PER_REV, (unsigned)IMU_SAMPLE_RATE_HZ);
+        sensor_trace_close(&g_trace);
+        return 2;
+    }
+
+    FILE* decisions = decisions_path != NULL ? fopen(decisions_path, "w") : stdout;
+    if (decisions == NULL) {
+        fprintf(stderr, "cannot create %s\n", decisions_path);
+        sensor_trace_close(&g_trace);
+        return 2;
+    }
+
+    sim_unit_boot(trace_source);
+    sim_decisions_begin(decisions);
+    read_next();
+
+    auto wall_start = std::chrono::steady_clock::now();
+    uint32_t commands = 0;
+    while (g_have_next) {
+        if (g_next.type == TRACE_RECORD_COMMAND && (int64_t)g_next.timestamp_us <= sim_unit_now_us()) {
+            sim_unit_command((trace_command_t)g_next.command, g_next.argument);
+            commands++;
+            read_next();
+            continue;
+        }
+        if (realtime) {
+            auto due = wall_start + std::chrono::microseconds((int64_t)(sim_unit_now_us() / speed));
+            std::this_thread::sleep_until(due);
+        }
+        sim_unit_tick();
+    }
+
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    double sim_s = sim_unit_now_us() / 1e6;
+    fprintf(stderr, "replayed %s (%s): %u records, %u commands, %.1f s in %.2f s wall (%.0fx)%s\n",
+            trace_path, g_trace.header.source, g_trace.records, commands, sim_s, wall_s,
+            wall_s > 0.0 ? sim_s / wall_s : 0.0, g_unknown_records ? ", unknown records skipped" : "");
+    sim_unit_print_stage_table(stderr);
+
+    sim_decisions_begin(NULL);
+    if (decisions != stdout) fclose(decisions);
+    sensor_trace_close(&g_trace);
+    return 0;
+}
+
+static void usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s TRACE [--decisions FILE] [--realtime [--speed X]] [--verbose]\n"
+            "       %s --compare A.decisions B.decisions [--tolerance-ms T]\n",
+            program, program);
+}
+
+int main(int argc, char** argv) {
+    const char* trace_path = NULL;
+    const char* decisions_path = NULL;
+    const char* compare_a = NULL;
+    const char* compare_b = NULL;
+    bool realtime = false;
+    double speed = 1.0;
+    double tolerance_ms = 0.0;
+
+    sim_log_set_level(ESP_LOG_ERROR);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--compare") == 0 && i + 2 < argc) {
+            compare_a = argv[++i];
+            compare_b = argv[++i];
+        } else if (strcmp(argv[i], "--tolerance-ms") == 0 && i + 1 < argc) {
+            tolerance_ms = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--decisions") == 0 && i + 1 < argc) {
+            decisions_path = argv[++i];
+        } else if (strcmp(argv[i], "--realtime") == 0) {
+            realtime = true;
+        } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            speed = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            sim_log_set_level(ESP_LOG_INFO);
+        } else if (argv[i][0] != '-' && trace_path == NULL) {
+            trace_path = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (compare_a != NULL) {
+        return sim_decisions_compare(compare_a, compare_b, (int64_t)(tolerance_ms * 1000.0), stdout);
+    }
+    if (trace_path == NULL || speed <= 0.0) {
+        usage(argv[0]);
+        return 2;
+    }
+    return replay(trace_path, decisions_path, realtime, speed);
+}
@@ -0,0 +1,232 @@
+// sim/src/sim_unit.cpp
+#include "sim_unit.h"
+#include "sim_platform.h"
+#include "sim_hardware.h"
+#include "sim_imu.h"
+#include "sim_decisions.h"
+#include "hardware_control.h"
+#include "imu_acquisition.h"
+#include "sensor_health.h"
+#include "state_estimator.h"
+#include "wire_end_detector.h"
+#include "mode_coordinator.h"
+#include "wire_learning_mode.h"
+#include "automatic_mode.h"
+#include "manual_mode.h"
+#include "command_queue.h"
+#include "control_loop.h"
+#include <chrono>
+#include <cstring>
+
+static_assert(SIM_UNIT_TICK_US == 1000000 / CONTROL_LOOP_DEFAULT_RATE_HZ, "sim tick must match the control loop");
+
+#define STAGE_HIST_BUCKET_NS        100         // p99 histogram resolution
+#define STAGE_HIST_BUCKETS          2000        // 0..200 µs, overflow in the last bucket
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STAGE TIMING
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static const char* k_stage_names[SIM_STAGE_COUNT] = {
+    "hardware_sense_update",
+    "sensor_health_update",
+    "state_estimator_update",
+    "wire_end_detector_update",
+    "command_queue_drain",
+    "wire_learning_mode_update",
+    "automatic_mode_update",
+    "manual_mode_update",
+    "hardware_output_update",
+    "hardware_update",
+    "mode_coordinator_update"
+};
+
+typedef struct {
+    uint64_t count;
+    uint64_t total_ns;
+    uint32_t max_ns;
+    uint32_t histogram[STAGE_HIST_BUCKETS];
+} stage_stats_t;
+
+static stage_stats_t g_stages[SIM_STAGE_COUNT];
+
+static void stage_record(sim_stage_t stage, uint32_t ns) {
+    stage_stats_t* s = &g_stages[stage];
+    s->count++;
+    s->total_ns += ns;
+    if (ns > s->max_ns) s->max_ns = ns;
+    uint32_t bucket = ns / STAGE_HIST_BUCKET_NS;
+    if (bucket >= STAGE_HIST_BUCKETS) bucket = STAGE_HIST_BUCKETS - 1;
+    s->histogram[bucket]++;
+}
+
+static uint32_t stage_p99_ns(const stage_stats_t* s) {
+    uint64_t target = s->count - s->count / 100;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < STAGE_HIST_BUCKETS; i++) {
+        seen += s->histogram[i];
+        if (seen >= target) return (i + 1) * STAGE_HIST_BUCKET_NS;
+    }
+    return s->max_ns;
+}
+
+#define TIMED_STAGE(stage, call) do {                                               \
+        auto t0_ = std::chrono::steady_clock::now();                                \
+        call;                                                                       \
+        auto t1_ = std::chrono::steady_clock::now();                                \
+        stage_record(stage, (uint32_t)std::chrono::duration_cast<                   \
+                     std::chrono::nanoseconds>(t1_ - t0_).count());                 \
+    } while (0)
+
+void sim_unit_reset_stage_stats(void) {
+    memset(g_stages, 0, sizeof(g_stages));
+}
+
+void sim_unit_print_stage_table(FILE* out) {
+    fprintf(out, "  %-28s %10s %10s %10s %10s\n", "stage (host ns)", "calls", "mean", "p99", "max");
+    for (int i = 0; i < SIM_STAGE_COUNT; i++) {
+        const stage_stats_t* s = &g_stages[i];
+        if (s->count == 0) continue;
+        fprintf(out, "  %-28s %10llu %10llu %10u %10u\n", k_stage_names[i],
+                (unsigned long long)s->count,
+                (unsigned long long)(s->total_ns / s->count),
+                stage_p99_ns(s), s->max_ns);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// UNIT STATE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static sim_unit_source_t g_source = nullptr;
+static sensor_trace_t* g_recorder = nullptr;
+static int64_t g_now_us = 0;
+static uint64_t g_tick = 0;
+
+// Upstream wiring gap: nothing on the target forwards Hall edges to sensor
+// health, so validation is wired here the way main.cpp would
+static void unit_hall_callback(uint32_t total_rotations, uint64_t timestamp) {
+    (void)total_rotations;
+    (void)timestamp;
+    sensor_health_hall_pulse_detected();
+}
+
+void sim_unit_boot(sim_unit_source_t source) {
+    sim_storage_reset();
+    sim_flight_recorder_reset();
+    sim_clock_init();
+    sim_unit_reset_stage_stats();
+    g_source = source;
+    g_now_us = 0;
+    g_tick = 0;
+
+    ESP_ERROR_CHECK(imu_acquisition_init(NULL));
+    ESP_ERROR_CHECK(hardware_init());
+    ESP_ERROR_CHECK(hardware_register_hall_callback(unit_hall_callback));
+    ESP_ERROR_CHECK(mode_coordinator_init());
+    ESP_ERROR_CHECK(state_estimator_init());
+    ESP_ERROR_CHECK(wire_end_detector_init());
+    ESP_ERROR_CHECK(sensor_health_init());
+    ESP_ERROR_CHECK(wire_learning_mode_init());
+    ESP_ERROR_CHECK(automatic_mode_init());
+    ESP_ERROR_CHECK(manual_mode_init());
+    ESP_ERROR_CHECK(command_queue_init());
+}
+
+// One control loop tick, same order and decimation as control_pipeline_tick()
+void sim_unit_tick(void) {
+    g_now_us += SIM_UNIT_TICK_US;
+    if (g_source != nullptr) g_source(g_now_us);
+    sim_clock_set_us(g_now_us);
+
+    TIMED_STAGE(SIM_STAGE_SENSE, hardware_sense_update());
+    if (g_tick % (CONTROL_LOOP_DEFAULT_RATE_HZ / CONTROL_LOOP_IMU_RATE_HZ) == 0) {
+        TIMED_STAGE(SIM_STAGE_SENSOR_HEALTH, sensor_health_update());
+    }
+    TIMED_STAGE(SIM_STAGE_ESTIMATOR, state_estimator_update(SIM_UNIT_TICK_US));
+    TIMED_STAGE(SIM_STAGE_WIRE_END, wire_end_detector_update());
+    TIMED_STAGE(SIM_STAGE_COMMANDS, command_queue_drain());
+    TIMED_STAGE(SIM_STAGE_WIRE_LEARNING, wire_learning_mode_update());
+    TIMED_STAGE(SIM_STAGE_AUTOMATIC, automatic_mode_update());
+    TIMED_STAGE(SIM_STAGE_MANUAL, manual_mode_update());
+    if (g_tick % (CONTROL_LOOP_DEFAULT_RATE_HZ / CONTROL_LOOP_COORDINATOR_RATE_HZ) == 0) {
+        TIMED_STAGE(SIM_STAGE_MODE_COORDINATOR, mode_coordinator_update());
+    }
+    TIMED_STAGE(SIM_STAGE_ESC_OUTPUT, hardware_output_update(SIM_UNIT_TICK_US, state_estimator_get_speed()));
+
+    if (g_tick % SIM_UNIT_HOUSEKEEPING_TICKS == 0) {
+        TIMED_STAGE(SIM_STAGE_HARDWARE_HOUSEKEEPING, hardware_update());
+        mode_coordinator_service_flash();
+    }
+    g_tick++;
+
+    sim_decisions_sample(g_now_us);
+}
+
+bool sim_unit_run_until(sim_unit_condition_t done, int64_t timeout_us) {
+    int64_t deadline = g_now_us + timeout_us;
+    while (g_now_us < deadline) {
+        if (done != NULL && done()) return true;
+        sim_unit_tick();
+    }
+    return done != NULL && done();
+}
+
+int64_t sim_unit_now_us(void) {
+    return g_now_us;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// INPUTS AND COMMANDS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void sim_unit_hall_edge(int64_t timestamp_us) {
+    if (g_recorder != nullptr) sensor_trace_write_hall_edge(g_recorder, timestamp_us);
+    sim_hardware_hall_edge(timestamp_us);
+}
+
+void sim_unit_imu_sample_raw(int64_t timestamp_us, int16_t x_raw, int16_t y_raw, int16_t z_raw) {
+    if (g_recorder != nullptr) sensor_trace_write_imu_sample(g_recorder, timestamp_us, x_raw, y_raw, z_raw);
+    sim_imu_push_raw(timestamp_us, x_raw, y_raw, z_raw);
+}
+
+void sim_unit_imu_sample_g(int64_t timestamp_us, float x_g, float y_g, float z_g) {
+    sim_unit_imu_sample_raw(timestamp_us, sim_imu_g_to_raw(x_g), sim_imu_g_to_raw(y_g), sim_imu_g_to_raw(z_g));
+}
+
+// A learning result as the web UI would restore it for a known site
+static esp_err_t set_wire_length(int32_t length_mm) {
+    wire_learning_results_t results = {};
+    results.complete = true;
+    results.wire_length_m = length_mm / 1000.0f;
+    results.optimal_learning_speed_ms = WIRE_LEARNING_MAX_SPEED_MS;
+    results.optimal_cruise_speed_ms = WIRE_LEARNING_MAX_SPEED_MS;
+    results.learning_accuracy_percent = 100.0f;
+    return mode_coordinator_set_wire_learning_results(&results);
+}
+
+static esp_err_t execute_command(trace_command_t command, int32_t argument) {
+    switch (command) {
+        case TRACE_CMD_START_SENSOR_VALIDATION: return mode_coordinator_start_sensor_validation();
+        case TRACE_CMD_CONFIRM_HALL:            return mode_coordinator_confirm_hall_validation();
+        case TRACE_CMD_CONFIRM_ACCEL:           return mode_coordinator_confirm_accel_validation();
+        case TRACE_CMD_ACTIVATE_WIRE_LEARNING:  return mode_coordinator_activate_wire_learning();
+        case TRACE_CMD_ACTIVATE_AUTOMATIC:      return mode_coordinator_activate_automatic();
+        case TRACE_CMD_ACTIVATE_MANUAL:         return mode_coordinator_activate_manual();
+        case TRACE_CMD_STOP:                    return mode_coordinator_stop_current_mode(argument != 0);
+        case TRACE_CMD_EMERGENCY_STOP:          return mode_coordinator_emergency_stop();
+        case TRACE_CMD_SET_WIRE_LENGTH:         return set_wire_length(argument);
+        default:                                return ESP_ERR_NOT_SUPPORTED;
+    }
+}
+
+esp_err_t sim_unit_command(trace_command_t command, int32_t argument) {
+    if (g_recorder != nullptr) sensor_trace_write_command(g_recorder, g_now_us, command, argument);
+    esp_err_t result = execute_command(command, argument);
+    sim_decisions_command(g_now_us, command, argument, result);
+    return result;
+}
+
+void sim_unit_record_to(sensor_trace_t* trace) {
+    g_recorder = trace;
+}
@@ -0,0 +1,110 @@
+// sim/src/sim_unit.h
+#ifndef SIM_UNIT_H
+#define SIM_UNIT_H
+
+#include "esp_err.h"
+#include "sensor_trace.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SIM_UNIT.H - ONE SIMULATED TROLLEY: BOOT, PIPELINE TICK, INPUTS, COMMANDS
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Run the real components the way the target does
+// - Boot order of main.cpp, tick order and decimation of control_loop.cpp,
+//   housekeeping every 50 ms
+// - Inputs enter through sim_unit_hall_edge()/sim_unit_imu_sample_raw()
+//   (below hardware_control.h and imu_acquisition.h) and user actions through
+//   sim_unit_command(); all three can be recorded to a sensor trace
+// - Where inputs come from is the caller's source: the physics model
+//   (sim_bench) or a recorded trace (sim_replay)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define SIM_UNIT_TICK_US            2000        // 500 Hz (CONTROL_LOOP_DEFAULT_RATE_HZ)
+#define SIM_UNIT_HOUSEKEEPING_TICKS 25          // 50 ms, like the main loop
+
+// Timed pipeline stages
+typedef enum {
+    SIM_STAGE_SENSE = 0,
+    SIM_STAGE_SENSOR_HEALTH,
+    SIM_STAGE_ESTIMATOR,
+    SIM_STAGE_WIRE_END,
+    SIM_STAGE_COMMANDS,
+    SIM_STAGE_WIRE_LEARNING,
+    SIM_STAGE_AUTOMATIC,
+    SIM_STAGE_MANUAL,
+    SIM_STAGE_ESC_OUTPUT,
+    SIM_STAGE_HARDWARE_HOUSEKEEPING,
+    SIM_STAGE_MODE_COORDINATOR,
+    SIM_STAGE_COUNT
+} sim_stage_t;
+
+/**
+ * @brief Input source: deliver every input with a timestamp up to until_us
+ */
+typedef void (*sim_unit_source_t)(int64_t until_us);
+
+typedef bool (*sim_unit_condition_t)(void);
+
+/**
+ * @brief Boot a factory-fresh unit (empty NVS/partitions, clock at 0)
+ * @param source Called at the start of every tick (may be NULL)
+ */
+void sim_unit_boot(sim_unit_source_t source);
+
+/**
+ * @brief Advance one control loop tick and run the pipeline
+ */
+void sim_unit_tick(void);
+
+/**
+ * @brief Tick until a condition holds or the timeout expires
+ * @param done Condition, checked before each tick (NULL = run the full timeout)
+ * @param timeout_us Simulation time budget
+ * @return true if the condition held
+ */
+bool sim_unit_run_until(sim_unit_condition_t done, int64_t timeout_us);
+
+int64_t sim_unit_now_us(void);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// INPUTS AND COMMANDS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void sim_unit_hall_edge(int64_t timestamp_us);
+void sim_unit_imu_sample_raw(int64_t timestamp_us, int16_t x_raw, int16_t y_raw, int16_t z_raw);
+
+/**
+ * @brief Physics sink form of sim_unit_imu_sample_raw() (converts like the sensor)
+ */
+void sim_unit_imu_sample_g(int64_t timestamp_us, float x_g, float y_g, float z_g);
+
+/**
+ * @brief Issue a user/web command to the coordinator at the current time
+ * @param command What to do
+ * @param argument Command argument (see trace_command_t)
+ * @return The coordinator's result
+ */
+esp_err_t sim_unit_command(trace_command_t command, int32_t argument);
+
+/**
+ * @brief Record every input and command from now on
+ * @param trace Open trace writer, NULL to stop recording
+ */
+void sim_unit_record_to(sensor_trace_t* trace);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STAGE COST
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void sim_unit_reset_stage_stats(void);
+
+/**
+ * @brief Print calls / mean / p99 / max host ns per stage
+ * @param out Destination
+ */
+void sim_unit_print_stage_table(FILE* out);
+
+#endif // SIM_UNIT_H
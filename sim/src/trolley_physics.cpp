@@ -0,0 +1,239 @@
+// sim/src/trolley_physics.cpp
+#include "trolley_physics.h"
+#include "hardware_control.h"
+#include "imu_acquisition.h"
+#include <cmath>
+#include <cstring>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MODEL STATE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static trolley_physics_config_t g_config = {};
+static trolley_physics_state_t g_state = {};
+static trolley_physics_stats_t g_stats = {};
+
+static physics_hall_edge_cb_t g_hall_sink = nullptr;
+static physics_imu_sample_cb_t g_imu_sink = nullptr;
+
+// Hall: wheel travel since the last edge
+static double g_wheel_travel_m = 0.0;
+
+// IMU: DLPF state and next sample time
+static float g_filtered_accel_ms2 = 0.0f;
+static int64_t g_next_imu_us = 0;
+
+// End stop contact in progress
+static bool g_in_contact = false;
+
+// Hand shake (sensor validation)
+static int64_t g_shake_until_us = 0;
+static float g_shake_peak_g = 0.0f;
+
+// xorshift32: deterministic ride vibration
+static uint32_t g_noise_state = 1;
+
+static float noise_unit(void) {
+    g_noise_state ^= g_noise_state << 13;
+    g_noise_state ^= g_noise_state >> 17;
+    g_noise_state ^= g_noise_state << 5;
+    return (float)(g_noise_state & 0xFFFFFF) / (float)0x800000 - 1.0f;      // -1..1
+}
+
+static float sign_of(float value) {
+    return value > 0.0f ? 1.0f : (value < 0.0f ? -1.0f : 0.0f);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FORCES (as accelerations, + = forward)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static float resistance_ms2(float velocity) {
+    return g_config.coast_a_ms2 + g_config.coast_b_per_m * velocity * velocity;
+}
+
+static float drive_ms2(const trolley_drive_t* drive, float velocity) {
+    if (!drive->powered || drive->speed_ms <= 0.0f) return 0.0f;
+
+    float direction = drive->forward ? 1.0f : -1.0f;
+    float target = direction * drive->speed_ms * g_config.motor_gain;
+
+    // First-order toward the target with the running resistance held off;
+    // the ESC only pushes in the commanded direction (no braking through neutral)
+    float along = direction * (target - velocity) / g_config.motor_tau_s + resistance_ms2(velocity);
+    if (along < 0.0f) along = 0.0f;
+    if (along > g_config.motor_max_accel_ms2) along = g_config.motor_max_accel_ms2;
+    return direction * along;
+}
+
+static float end_stop_ms2(float position, float velocity, float* penetration) {
+    float depth = 0.0f;
+    float outward = 0.0f;
+    if (position < 0.0f) {
+        depth = -position;
+        outward = 1.0f;
+    } else if (position > g_config.wire_length_m) {
+        depth = position - g_config.wire_length_m;
+        outward = -1.0f;
+    }
+    *penetration = depth;
+    if (depth <= 0.0f) return 0.0f;
+
+    float k = g_config.end_stiffness_n_m;
+    float c = 2.0f * g_config.end_damping_ratio * sqrtf(k * g_config.mass_kg);
+    float force = k * depth - c * velocity * outward;      // Damping resists motion into the stop
+    if (force < 0.0f) force = 0.0f;                         // A stop pushes, never pulls
+    return outward * force / g_config.mass_kg;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SENSORS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void emit_hall_edges(double travel_m, int64_t step_start_us) {
+    if (travel_m <= 0.0) return;
+
+    double before = g_wheel_travel_m;
+    g_wheel_travel_m += travel_m;
+    while (g_wheel_travel_m >= HALL_DISTANCE_PER_PULSE_M) {
+        g_wheel_travel_m -= HALL_DISTANCE_PER_PULSE_M;
+        // Place the edge inside the substep where the wheel crossed it
+        double fraction = (HALL_DISTANCE_PER_PULSE_M - before) / travel_m;
+        if (fraction < 0.0) fraction = 0.0;
+        if (fraction > 1.0) fraction = 1.0;
+        before -= HALL_DISTANCE_PER_PULSE_M;
+        if (g_hall_sink) {
+            g_hall_sink(step_start_us + (int64_t)(fraction * PHYSICS_SUBSTEP_US));
+        }
+    }
+}
+
+static void emit_imu_sample(int64_t now_us) {
+    if (now_us < g_next_imu_us) return;
+    g_next_imu_us += 1000000 / IMU_SAMPLE_RATE_HZ;
+    if (!g_imu_sink) return;
+
+    float vibration = 0.01f + g_config.vibration_g * fabsf(g_state.velocity_ms);
+    // Specific force: the slope component of gravity reads as a constant offset
+    float x_g = g_filtered_accel_ms2 / PHYSICS_GRAVITY_MS2 + g_config.grade_percent * 0.01f +
+                vibration * noise_unit();
+    float y_g = vibration * noise_unit();
+    float z_g = 1.0f + vibration * noise_unit();
+
+    if (now_us < g_shake_until_us) {
+        float phase = (float)(now_us % 125000) / 125000.0f;          // 8 Hz hand shake
+        x_g += g_shake_peak_g * sinf(2.0f * (float)M_PI * phase);
+        y_g += 0.5f * g_shake_peak_g * cosf(2.0f * (float)M_PI * phase);
+    }
+
+    g_imu_sink(now_us, x_g, y_g, z_g);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void trolley_physics_init(const trolley_physics_config_t* config) {
+    g_config = *config;
+    memset(&g_state, 0, sizeof(g_state));
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_state.position_m = config->start_position_m;
+    g_wheel_travel_m = 0.0;
+    g_filtered_accel_ms2 = 0.0f;
+    g_next_imu_us = 0;
+    g_in_contact = false;
+    g_shake_until_us = 0;
+    g_noise_state = config->seed != 0 ? config->seed : 1;
+}
+
+void trolley_physics_set_sinks(physics_hall_edge_cb_t hall_edge, physics_imu_sample_cb_t imu_sample) {
+    g_hall_sink = hall_edge;
+    g_imu_sink = imu_sample;
+}
+
+void trolley_physics_advance(int64_t until_us, const trolley_drive_t* drive) {
+    const float dt = PHYSICS_SUBSTEP_US * 1e-6f;
+    const float dlpf_alpha = dt / (dt + 1.0f / (2.0f * (float)M_PI * PHYSICS_DLPF_HZ));
+
+    while (g_state.time_us + PHYSICS_SUBSTEP_US <= until_us) {
+        int64_t step_start = g_state.time_us;
+        float x = g_state.position_m;
+        float v = g_state.velocity_ms;
+
+        float penetration;
+        float a_end = end_stop_ms2(x, v, &penetration);
+        float a_drive = drive_ms2(drive, v);
+        float a_grade = -PHYSICS_GRAVITY_MS2 * g_config.grade_percent * 0.01f;
+        float a_res = resistance_ms2(v);
+
+        float a_free = a_drive + a_grade + a_end;
+        float v_next;
+        if (fabsf(v) < PHYSICS_STATIC_SPEED_MS && fabsf(a_free) <= g_config.coast_a_ms2) {
+            v_next = 0.0f;                                          // Rolling resistance holds it
+        } else {
+            float direction = (v != 0.0f) ? sign_of(v) : sign_of(a_free);
+            v_next = v + (a_free - direction * a_res) * dt;
+            if (a_drive == 0.0f && a_end == 0.0f && sign_of(v_next) != sign_of(v) && v != 0.0f &&
+                fabsf(a_grade) <= g_config.coast_a_ms2) {
+                v_next = 0.0f;                                      // Resistance stops, never reverses
+            }
+        }
+
+        float a = (v_next - v) / dt;
+        g_state.velocity_ms = v_next;
+        g_state.position_m = x + v_next * dt;
+        g_state.accel_ms2 = a;
+        g_state.time_us = step_start + PHYSICS_SUBSTEP_US;
+        g_filtered_accel_ms2 += dlpf_alpha * (a - g_filtered_accel_ms2);
+
+        // End stop contact bookkeeping
+        if (penetration > 0.0f) {
+            if (!g_in_contact) {
+                g_in_contact = true;
+                g_stats.end_contacts++;
+                g_stats.last_impact_speed_ms = fabsf(v);
+                g_stats.last_overshoot_m = 0.0f;
+                if (fabsf(v) > g_stats.max_impact_speed_ms) g_stats.max_impact_speed_ms = fabsf(v);
+            }
+            if (penetration > g_stats.last_overshoot_m) g_stats.last_overshoot_m = penetration;
+            if (penetration > g_stats.max_overshoot_m) g_stats.max_overshoot_m = penetration;
+            float impact_g = fabsf(a_end) / PHYSICS_GRAVITY_MS2;
+            if (impact_g > g_stats.peak_impact_g) g_stats.peak_impact_g = impact_g;
+        } else {
+            g_in_contact = false;
+        }
+        g_state.end_penetration_m = penetration;
+
+        double travel = fabs((double)v_next * dt);
+        g_stats.distance_m += travel;
+        emit_hall_edges(travel, step_start);
+        emit_imu_sample(g_state.time_us);
+    }
+}
+
+void trolley_physics_nudge(float speed_ms) {
+    g_state.velocity_ms = speed_ms;
+}
+
+void trolley_physics_shake(float peak_g, uint32_t duration_ms) {
+    g_shake_peak_g = peak_g;
+    g_shake_until_us = g_state.time_us + (int64_t)duration_ms * 1000;
+}
+
+void trolley_physics_reset_peaks(void) {
+    g_stats.max_impact_speed_ms = 0.0f;
+    g_stats.max_overshoot_m = 0.0f;
+    g_stats.peak_impact_g = 0.0f;
+}
+
+trolley_physics_state_t trolley_physics_get_state(void) {
+    return g_state;
+}
+
+trolley_physics_stats_t trolley_physics_get_stats(void) {
+    return g_stats;
+}
+
+const trolley_physics_config_t* trolley_physics_get_config(void) {
+    return &g_config;
+}
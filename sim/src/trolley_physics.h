@@ -0,0 +1,125 @@
+// sim/src/trolley_physics.h
+#ifndef TROLLEY_PHYSICS_H
+#define TROLLEY_PHYSICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// TROLLEY_PHYSICS.H - ONE TROLLEY ON ONE WIRE BETWEEN TWO END STOPS
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// SINGLE RESPONSIBILITY: Motion and the sensor signals it produces
+// - Drive: the ESC + speed controller as a first-order response toward the
+//   commanded speed, thrust-limited, never braking through neutral
+// - Coast: deceleration a + b·v² (rolling + air), plus the grade component
+// - End stops: spring-damper at 0 and at wire_length_m; penetration is the
+//   overshoot, the spring force is the impact the IMU sees
+// - Hall: one edge per HALL_DISTANCE_PER_PULSE_M of wheel travel, timestamped
+//   inside the integration substep it falls in
+// - IMU: longitudinal acceleration + gravity + ride vibration, low-passed like
+//   the MPU6050 DLPF, sampled at IMU_SAMPLE_RATE_HZ
+//
+// Positions are absolute: 0 = reverse end stop, wire_length_m = forward end stop
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define PHYSICS_SUBSTEP_US          100         // Integration step (end stop spring needs it)
+#define PHYSICS_GRAVITY_MS2         9.81f
+#define PHYSICS_DLPF_HZ             42.0f       // MPU6050 DLPF_42HZ
+#define PHYSICS_STATIC_SPEED_MS     0.005f      // Below this with no drive the trolley rests
+
+// Wire and trolley description (one benchmark scenario)
+typedef struct {
+    const char* name;
+    float wire_length_m;               // Distance between the end stops
+    float start_position_m;            // Where the trolley rests at boot
+    float coast_a_ms2;                 // Rolling resistance deceleration
+    float coast_b_per_m;               // Air drag: deceleration b·v²
+    float grade_percent;               // Positive = forward direction climbs
+    float motor_tau_s;                 // Drive speed response time constant
+    float motor_max_accel_ms2;         // Drive thrust limit
+    float motor_gain;                  // Actual speed per commanded speed (ESC/LUT error)
+    float end_stiffness_n_m;           // End stop spring (hard ≈ 2e5, rubber buffer ≈ 4e3)
+    float end_damping_ratio;           // End stop damping (fraction of critical)
+    float mass_kg;
+    float vibration_g;                 // IMU ride vibration amplitude at 1 m/s
+    uint32_t seed;                     // Vibration noise seed (runs are reproducible)
+} trolley_physics_config_t;
+
+// Drive input for one step
+typedef struct {
+    bool powered;                      // ESC armed and a speed above the deadband commanded
+    bool forward;                      // Commanded direction
+    float speed_ms;                    // Commanded (ramped) speed magnitude
+} trolley_drive_t;
+
+// Observable state
+typedef struct {
+    int64_t time_us;
+    float position_m;                  // Absolute position
+    float velocity_ms;                 // Signed, + = forward
+    float accel_ms2;                   // Signed longitudinal acceleration
+    float end_penetration_m;           // Current compression of an end stop (0 off the stops)
+} trolley_physics_state_t;
+
+// Per-run and lifetime end stop statistics
+typedef struct {
+    uint32_t end_contacts;             // Separate contacts with either end stop
+    float last_impact_speed_ms;        // Speed when the last contact began
+    float max_impact_speed_ms;
+    float last_overshoot_m;            // Deepest penetration of the last contact
+    float max_overshoot_m;
+    float peak_impact_g;               // Largest end stop deceleration
+    double distance_m;                 // Total wheel travel
+} trolley_physics_stats_t;
+
+// Sensor sinks (set by the simulation wiring)
+typedef void (*physics_hall_edge_cb_t)(int64_t timestamp_us);
+typedef void (*physics_imu_sample_cb_t)(int64_t timestamp_us, float x_g, float y_g, float z_g);
+
+/**
+ * @brief Reset the trolley to rest at the scenario start position
+ * @param config Scenario (copied)
+ */
+void trolley_physics_init(const trolley_physics_config_t* config);
+
+/**
+ * @brief Connect sensor outputs
+ * @param hall_edge Called per Hall edge (may be NULL)
+ * @param imu_sample Called per IMU sample (may be NULL)
+ */
+void trolley_physics_set_sinks(physics_hall_edge_cb_t hall_edge, physics_imu_sample_cb_t imu_sample);
+
+/**
+ * @brief Integrate up to a new simulation time
+ * @param until_us Target time (substeps of PHYSICS_SUBSTEP_US)
+ * @param drive Drive input held over the interval
+ */
+void trolley_physics_advance(int64_t until_us, const trolley_drive_t* drive);
+
+/**
+ * @brief Push the trolley by hand (sensor validation "rotate the wheel")
+ * @param speed_ms Signed speed to give it
+ */
+void trolley_physics_nudge(float speed_ms);
+
+/**
+ * @brief Queue a hand shake for the IMU (sensor validation "shake the trolley")
+ * @param peak_g Shake amplitude
+ * @param duration_ms Shake length
+ */
+void trolley_physics_shake(float peak_g, uint32_t duration_ms);
+
+/**
+ * @brief Start a new measurement window for the max/peak statistics
+ *
+ * Counters and distance keep running; a contact in progress is not
+ * counted again.
+ */
+void trolley_physics_reset_peaks(void);
+
+trolley_physics_state_t trolley_physics_get_state(void);
+trolley_physics_stats_t trolley_physics_get_stats(void);
+const trolley_physics_config_t* trolley_physics_get_config(void);
+
+#endif // TROLLEY_PHYSICS_H